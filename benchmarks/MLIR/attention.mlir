@@ -0,0 +1,51 @@
+// Multi-head scaled dot-product attention with the shapes of a single
+// MobileBERT encoder layer: softmax(Q * K^T / sqrt(d)) * V.
+
+func.func @main(%query: tensor<1x4x384x32xf32>, %key: tensor<1x4x384x32xf32>,
+                %value: tensor<1x4x384x32xf32>) -> tensor<1x4x384x32xf32> {
+  %scale = mhlo.constant dense<0.176776695> : tensor<1x4x384x384xf32>
+  %neg_inf = mhlo.constant dense<0xFF800000> : tensor<f32>
+  %zero = mhlo.constant dense<0.000000e+00> : tensor<f32>
+  %0 = "mhlo.dot_general"(%query, %key) {
+    dot_dimension_numbers = #mhlo.dot<
+      lhs_batching_dimensions = [0, 1],
+      lhs_contracting_dimensions = [3],
+      rhs_batching_dimensions = [0, 1],
+      rhs_contracting_dimensions = [3]
+    >
+  } : (tensor<1x4x384x32xf32>, tensor<1x4x384x32xf32>)
+    -> tensor<1x4x384x384xf32>
+  %1 = mhlo.multiply %0, %scale : tensor<1x4x384x384xf32>
+  %2 = "mhlo.reduce"(%1, %neg_inf) ({
+  ^bb0(%lhs: tensor<f32>, %rhs: tensor<f32>):
+    %max = mhlo.maximum %lhs, %rhs : tensor<f32>
+    "mhlo.return"(%max) : (tensor<f32>) -> ()
+  }) {dimensions = dense<3> : tensor<1xi64>}
+    : (tensor<1x4x384x384xf32>, tensor<f32>) -> tensor<1x4x384xf32>
+  %3 = "mhlo.broadcast_in_dim"(%2) {
+    broadcast_dimensions = dense<[0, 1, 2]> : tensor<3xi64>
+  } : (tensor<1x4x384xf32>) -> tensor<1x4x384x384xf32>
+  %4 = mhlo.subtract %1, %3 : tensor<1x4x384x384xf32>
+  %5 = "mhlo.exponential"(%4)
+      : (tensor<1x4x384x384xf32>) -> tensor<1x4x384x384xf32>
+  %6 = "mhlo.reduce"(%5, %zero) ({
+  ^bb0(%lhs: tensor<f32>, %rhs: tensor<f32>):
+    %sum = mhlo.add %lhs, %rhs : tensor<f32>
+    "mhlo.return"(%sum) : (tensor<f32>) -> ()
+  }) {dimensions = dense<3> : tensor<1xi64>}
+    : (tensor<1x4x384x384xf32>, tensor<f32>) -> tensor<1x4x384xf32>
+  %7 = "mhlo.broadcast_in_dim"(%6) {
+    broadcast_dimensions = dense<[0, 1, 2]> : tensor<3xi64>
+  } : (tensor<1x4x384xf32>) -> tensor<1x4x384x384xf32>
+  %8 = mhlo.divide %5, %7 : tensor<1x4x384x384xf32>
+  %9 = "mhlo.dot_general"(%8, %value) {
+    dot_dimension_numbers = #mhlo.dot<
+      lhs_batching_dimensions = [0, 1],
+      lhs_contracting_dimensions = [3],
+      rhs_batching_dimensions = [0, 1],
+      rhs_contracting_dimensions = [2]
+    >
+  } : (tensor<1x4x384x384xf32>, tensor<1x4x384x32xf32>)
+    -> tensor<1x4x384x32xf32>
+  return %9 : tensor<1x4x384x32xf32>
+}
@@ -0,0 +1,25 @@
+// A 3x3 same-padded f32 convolution from a ResNet-style residual block.
+
+func.func @main(%input: tensor<1x56x56x64xf32>, %filter: tensor<3x3x64x64xf32>)
+    -> tensor<1x56x56x64xf32> {
+  %0 = "mhlo.convolution"(%input, %filter) {
+    batch_group_count = 1 : i64,
+    dimension_numbers = #mhlo.conv<raw
+      input_batch_dimension = 0,
+      input_feature_dimension = 3,
+      input_spatial_dimensions = [1, 2],
+      kernel_input_feature_dimension = 2,
+      kernel_output_feature_dimension = 3,
+      kernel_spatial_dimensions = [0, 1],
+      output_batch_dimension = 0,
+      output_feature_dimension = 3,
+      output_spatial_dimensions = [1, 2]
+    >,
+    feature_group_count = 1 : i64,
+    padding = dense<1> : tensor<2x2xi64>,
+    rhs_dilation = dense<1> : tensor<2xi64>,
+    window_strides = dense<1> : tensor<2xi64>
+  } : (tensor<1x56x56x64xf32>, tensor<3x3x64x64xf32>)
+    -> tensor<1x56x56x64xf32>
+  return %0 : tensor<1x56x56x64xf32>
+}
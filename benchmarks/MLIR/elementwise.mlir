@@ -0,0 +1,25 @@
+// A chain of broadcasting elementwise ops that should fuse into a single
+// dispatch: tanh-approximated GELU of (x * y + bias).
+
+func.func @main(%x: tensor<384x2048xf32>, %y: tensor<384x2048xf32>,
+                %bias: tensor<2048xf32>) -> tensor<384x2048xf32> {
+  %half = mhlo.constant dense<5.000000e-01> : tensor<384x2048xf32>
+  %one = mhlo.constant dense<1.000000e+00> : tensor<384x2048xf32>
+  %coeff = mhlo.constant dense<4.471500e-02> : tensor<384x2048xf32>
+  %sqrt_2_over_pi = mhlo.constant dense<0.797884583> : tensor<384x2048xf32>
+  %0 = mhlo.multiply %x, %y : tensor<384x2048xf32>
+  %1 = "mhlo.broadcast_in_dim"(%bias) {
+    broadcast_dimensions = dense<1> : tensor<1xi64>
+  } : (tensor<2048xf32>) -> tensor<384x2048xf32>
+  %2 = mhlo.add %0, %1 : tensor<384x2048xf32>
+  %3 = mhlo.multiply %2, %2 : tensor<384x2048xf32>
+  %4 = mhlo.multiply %3, %2 : tensor<384x2048xf32>
+  %5 = mhlo.multiply %4, %coeff : tensor<384x2048xf32>
+  %6 = mhlo.add %2, %5 : tensor<384x2048xf32>
+  %7 = mhlo.multiply %6, %sqrt_2_over_pi : tensor<384x2048xf32>
+  %8 = "mhlo.tanh"(%7) : (tensor<384x2048xf32>) -> tensor<384x2048xf32>
+  %9 = mhlo.add %8, %one : tensor<384x2048xf32>
+  %10 = mhlo.multiply %2, %half : tensor<384x2048xf32>
+  %11 = mhlo.multiply %10, %9 : tensor<384x2048xf32>
+  return %11 : tensor<384x2048xf32>
+}
@@ -0,0 +1,8 @@
+// A single f32 matmul of a size common to transformer projection layers.
+
+func.func @main(%lhs: tensor<384x512xf32>, %rhs: tensor<512x512xf32>)
+    -> tensor<384x512xf32> {
+  %0 = "mhlo.dot"(%lhs, %rhs)
+      : (tensor<384x512xf32>, tensor<512x512xf32>) -> tensor<384x512xf32>
+  return %0 : tensor<384x512xf32>
+}
@@ -20,6 +20,7 @@ from typing import Any, Dict, Sequence
 # A map from CPU ABI to IREE's benchmark target architecture.
 CPU_ABI_TO_TARGET_ARCH_MAP = {
     "arm64-v8a": "cpu-arm64-v8a",
+    "x86_64": "cpu-x86_64",
 }
 
 # A map from GPU name to IREE's benchmark target architecture.
@@ -150,6 +151,8 @@ class DeviceInfo:
   def get_cpu_arch_revision(self) -> str:
     if self.cpu_abi == "arm64-v8a":
       return self.__get_arm_cpu_arch_revision()
+    if self.cpu_abi == "x86_64":
+      return "x86_64"
     raise ValueError("Unrecognized CPU ABI; need to update the list")
 
   def to_json_object(self) -> Dict[str, Any]:
@@ -96,7 +96,9 @@ class BenchmarkDriver(object):
                   exist_ok=True)
 
     cpu_target_arch = self.device_info.get_iree_cpu_arch_name()
-    gpu_target_arch = self.device_info.get_iree_gpu_arch_name()
+    # Devices without a known GPU (e.g., Linux hosts) only run CPU benchmarks.
+    gpu_target_arch = (None if self.device_info.gpu_name == "Unknown" else
+                       self.device_info.get_iree_gpu_arch_name())
     drivers = self.__get_available_drivers()
 
     for category, _ in self.benchmark_suite.list_categories():
@@ -166,6 +166,36 @@ class BenchmarkDriverTest(unittest.TestCase):
     self.assertEqual(len(driver.get_benchmark_errors()), 1)
     self.assertEqual(len(driver.get_benchmark_result_filenames()), 1)
 
+  def test_run_on_x86_64_device_without_gpu(self):
+    self.config.trace_capture_config = None
+    device_info = DeviceInfo(PlatformType.LINUX, "Unknown", "x86_64",
+                             ["avx2"], "Unknown")
+    case1 = BenchmarkCase(model_name_with_tags="MatMul-fp32",
+                          bench_mode="4-thread,full-inference",
+                          target_arch="CPU-x86_64",
+                          driver="iree-dylib",
+                          benchmark_case_dir="case1",
+                          benchmark_tool_name="tool")
+    case2 = BenchmarkCase(model_name_with_tags="MatMul-fp32",
+                          bench_mode="full-inference",
+                          target_arch="CPU-ARM64-v8A",
+                          driver="iree-dylib",
+                          benchmark_case_dir="case2",
+                          benchmark_tool_name="tool")
+    benchmark_suite = BenchmarkSuite({
+        "suite/MLIR": [case1, case2],
+    })
+    driver = FakeBenchmarkDriver(device_info, self.config, benchmark_suite)
+
+    driver.run()
+
+    self.assertEqual(driver.get_benchmark_result_filenames(), [
+        os.path.join(
+            self.tmp_dir.name, BENCHMARK_RESULTS_REL_PATH,
+            "MatMul [fp32] (MLIR) 4-thread,full-inference with IREE-Dylib @ Unknown (CPU-x86_64).json"
+        )
+    ])
+
 
 if __name__ == "__main__":
   unittest.main()
@@ -139,15 +139,17 @@ def _sort_benchmarks_and_get_table(benchmarks: Dict[str,
                                             size_cut)
 
 
-def categorize_benchmarks_into_tables(benchmarks: Dict[
-    str, AggregateBenchmarkLatency],
-                                      size_cut: Optional[int] = None) -> str:
-  """Splits benchmarks into regressed/improved/similar/raw categories and
-  returns their markdown tables.
+def categorize_benchmarks(
+    benchmarks: Dict[str, AggregateBenchmarkLatency]
+) -> Tuple[Dict[str, AggregateBenchmarkLatency], ...]:
+  """Splits benchmarks into regressed/improved/similar/raw categories
+  according to BENCHMARK_THRESHOLDS.
 
     Args:
     - benchmarks: A dictionary of benchmark names to its aggregate info.
-    - size_cut: If not None, only show the top N results for each table.
+
+    Returns:
+    - A tuple of (regressed, improved, similar, raw) benchmark dictionaries.
     """
   regressed, improved, similar, raw = {}, {}, {}, {}
 
@@ -179,6 +181,21 @@ def categorize_benchmarks_into_tables(benchmarks: Dict[
     else:
       improved[name] = results
 
+  return (regressed, improved, similar, raw)
+
+
+def categorize_benchmarks_into_tables(benchmarks: Dict[
+    str, AggregateBenchmarkLatency],
+                                      size_cut: Optional[int] = None) -> str:
+  """Splits benchmarks into regressed/improved/similar/raw categories and
+  returns their markdown tables.
+
+    Args:
+    - benchmarks: A dictionary of benchmark names to its aggregate info.
+    - size_cut: If not None, only show the top N results for each table.
+    """
+  regressed, improved, similar, raw = categorize_benchmarks(benchmarks)
+
   tables = []
   if regressed:
     tables.append(md.header("Regressed Benchmarks 🚩", 3))
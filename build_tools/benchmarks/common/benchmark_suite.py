@@ -92,7 +92,7 @@ class BenchmarkSuite(object):
       category: str,
       available_drivers: Sequence[str],
       cpu_target_arch_filter: str,
-      gpu_target_arch_filter: str,
+      gpu_target_arch_filter: Optional[str],
       driver_filter: Optional[str] = None,
       mode_filter: Optional[str] = None,
       model_name_filter: Optional[str] = None) -> Sequence[BenchmarkCase]:
@@ -101,7 +101,8 @@ class BenchmarkSuite(object):
         category: the specific benchmark category.
         available_drivers: list of drivers supported by the tools.
         cpu_target_arch_filter: CPU target architecture filter regex.
-        gpu_target_arch_filter: GPU target architecture filter regex.
+        gpu_target_arch_filter: GPU target architecture filter regex, or None
+          to skip all GPU benchmarks.
         driver_filter: driver filter regex.
         mode_filter: benchmark mode regex.
         model_name_filter: model name regex.
@@ -121,7 +122,9 @@ class BenchmarkSuite(object):
       target_arch = benchmark_case.target_arch.lower()
       matched_arch = (re.match(cpu_target_arch_filter,
                                target_arch) is not None or
-                      re.match(gpu_target_arch_filter, target_arch) is not None)
+                      (gpu_target_arch_filter is not None and
+                       re.match(gpu_target_arch_filter, target_arch)
+                       is not None))
       matched_mode = (mode_filter is None or re.match(
           mode_filter, benchmark_case.bench_mode) is not None)
 
@@ -0,0 +1,195 @@
+# Copyright 2022 The IREE Authors
+#
+# Licensed under the Apache License v2.0 with LLVM Exceptions.
+# See https://llvm.org/LICENSE.txt for license information.
+# SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+"""Utilities for LLVMCPU tuning records and tuning databases.
+
+Tuning records are JSON lines emitted by the compiler with
+`--iree-codegen-llvmcpu-tuning-records=<path>`, one per dispatch, describing
+the compilation info chosen by the default heuristics. Tuning databases are
+consumed by the compiler with `--iree-codegen-llvmcpu-tuning-database=<path>`
+to pin the compilation info of matching dispatches. See
+iree/compiler/Codegen/LLVMCPU/TuningDatabase.h for the formats.
+"""
+
+import json
+import re
+
+from dataclasses import dataclass
+from typing import Dict, List, Optional, Sequence, Tuple
+
+TUNING_DATABASE_VERSION = 1
+
+_TILE_SIZES_RE = re.compile(r"tile_sizes = (\[\[.*?\]\])")
+_PIPELINE_RE = re.compile(r"translation_info = <(\w+)")
+_WORKGROUP_SIZE_RE = re.compile(r"workgroup_size = (\[[^\]]*\])")
+
+TileSizes = List[List[int]]
+
+
+@dataclass
+class TuningRecord:
+  """A dispatch configuration as recorded by the compiler."""
+  key: str
+  op: str
+  compilation_info: str
+  loop_ranges: Optional[List[int]] = None
+  iterator_types: Optional[List[str]] = None
+
+  @staticmethod
+  def from_json_object(json_object):
+    return TuningRecord(key=json_object["key"],
+                        op=json_object["op"],
+                        compilation_info=json_object["compilation_info"],
+                        loop_ranges=json_object.get("loop_ranges"),
+                        iterator_types=json_object.get("iterator_types"))
+
+
+def parse_tuning_records(text: str) -> List[TuningRecord]:
+  """Parses JSON lines tuning records, dropping duplicated keys."""
+  records = {}
+  for line in text.splitlines():
+    line = line.strip()
+    if not line:
+      continue
+    record = TuningRecord.from_json_object(json.loads(line))
+    records.setdefault(record.key, record)
+  return list(records.values())
+
+
+def parse_compilation_info(
+    compilation_info: str) -> Tuple[TileSizes, str, List[int]]:
+  """Returns the tile sizes, pipeline and workgroup size of an attribute."""
+  tile_sizes = _TILE_SIZES_RE.search(compilation_info)
+  pipeline = _PIPELINE_RE.search(compilation_info)
+  if not tile_sizes or not pipeline:
+    raise ValueError(f"Unsupported compilation info: {compilation_info}")
+  workgroup_size = _WORKGROUP_SIZE_RE.search(compilation_info)
+  return (json.loads(tile_sizes.group(1)), pipeline.group(1),
+          json.loads(workgroup_size.group(1)) if workgroup_size else [])
+
+
+def format_compilation_info(tile_sizes: TileSizes,
+                            pipeline: str,
+                            workgroup_size: Sequence[int] = ()) -> str:
+  """Returns the textual `#iree_codegen.compilation_info` attribute."""
+  tile_sizes_str = ", ".join(
+      "[" + ", ".join(str(size) for size in level) + "]" for level in tile_sizes)
+  workgroup_size_str = ", ".join(str(size) for size in workgroup_size)
+  return ("#iree_codegen.compilation_info<"
+          f"lowering_config = <tile_sizes = [{tile_sizes_str}]>, "
+          f"translation_info = <{pipeline}>, "
+          f"workgroup_size = [{workgroup_size_str}]>")
+
+
+def _is_valid_tiling(tile_sizes: TileSizes,
+                     loop_ranges: Optional[Sequence[int]]) -> bool:
+  """Checks that the non-zero tile sizes of each loop shrink level by level
+  and that no tile exceeds a static loop range."""
+  num_loops = max(len(level) for level in tile_sizes)
+  for loop in range(num_loops):
+    previous = None
+    for level in tile_sizes:
+      size = level[loop] if loop < len(level) else 0
+      if size == 0:
+        continue
+      if size < 0 or (previous is not None and size > previous):
+        return False
+      if (loop_ranges and loop < len(loop_ranges) and
+          loop_ranges[loop] > 0 and size > loop_ranges[loop]):
+        return False
+      previous = size
+  return True
+
+
+def enumerate_candidates(record: TuningRecord,
+                         max_candidates: int = 32) -> List[str]:
+  """Returns candidate compilation infos around the recorded default.
+
+  Candidates are produced by doubling and halving the whole of each tiling
+  level and then each non-zero tile size on its own, keeping only tilings
+  where the nested levels still fit. The default configuration itself is not
+  included.
+  """
+  tile_sizes, pipeline, workgroup_size = parse_compilation_info(
+      record.compilation_info)
+
+  variants = []
+  for level_index, level in enumerate(tile_sizes):
+    for scale in (2, 0.5):
+      variants.append([
+          [max(1, int(size * scale)) if size else 0
+           for size in level] if index == level_index else list(other)
+          for index, other in enumerate(tile_sizes)
+      ])
+  for level_index, level in enumerate(tile_sizes):
+    for loop, size in enumerate(level):
+      if not size:
+        continue
+      for scaled in (size * 2, size // 2):
+        if scaled < 1:
+          continue
+        variant = [list(other) for other in tile_sizes]
+        variant[level_index][loop] = scaled
+        variants.append(variant)
+
+  candidates = []
+  seen = {format_compilation_info(tile_sizes, pipeline, workgroup_size)}
+  for variant in variants:
+    if not _is_valid_tiling(variant, record.loop_ranges):
+      continue
+    candidate = format_compilation_info(variant, pipeline, workgroup_size)
+    if candidate in seen:
+      continue
+    seen.add(candidate)
+    candidates.append(candidate)
+    if len(candidates) >= max_candidates:
+      break
+  return candidates
+
+
+def load_tuning_database(path: str) -> Dict[str, Dict]:
+  """Returns the entries of the database at `path` keyed by dispatch key."""
+  with open(path, "r") as f:
+    database = json.load(f)
+  if database.get("version") != TUNING_DATABASE_VERSION:
+    raise ValueError(f"Unsupported tuning database version in '{path}'")
+  return {entry["key"]: entry for entry in database["entries"]}
+
+
+def _entry_speedup(entry: Dict) -> float:
+  """Returns how much faster `entry` is than the default configuration."""
+  time_ns = entry.get("time_ns")
+  default_time_ns = entry.get("default_time_ns")
+  if not time_ns or not default_time_ns:
+    return 1.0
+  return default_time_ns / time_ns
+
+
+def add_tuning_entry(entries: Dict[str, Dict], entry: Dict) -> bool:
+  """Adds `entry` to `entries` unless an entry with the same key and a
+  larger speedup over its default configuration is already present.
+
+  The same dispatch may be tuned from several benchmark modules (or merged
+  into an existing database) and the absolute times of different runs are not
+  comparable so entries are ranked by their speedup over the default
+  configuration measured in the same run. Returns True if `entry` was kept.
+  """
+  existing = entries.get(entry["key"])
+  if existing is not None and _entry_speedup(existing) >= _entry_speedup(
+      entry):
+    return False
+  entries[entry["key"]] = entry
+  return True
+
+
+def write_tuning_database(path: str, entries: Dict[str, Dict]):
+  """Writes `entries` sorted by key as a tuning database to `path`."""
+  database = {
+      "version": TUNING_DATABASE_VERSION,
+      "entries": [entries[key] for key in sorted(entries)],
+  }
+  with open(path, "w") as f:
+    json.dump(database, f, indent=2)
+    f.write("\n")
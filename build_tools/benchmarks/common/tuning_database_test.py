@@ -0,0 +1,136 @@
+#!/usr/bin/env python3
+# Copyright 2022 The IREE Authors
+#
+# Licensed under the Apache License v2.0 with LLVM Exceptions.
+# See https://llvm.org/LICENSE.txt for license information.
+# SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+import json
+import os
+import tempfile
+import unittest
+
+from common.tuning_database import TuningRecord, add_tuning_entry, enumerate_candidates, format_compilation_info, load_tuning_database, parse_compilation_info, parse_tuning_records, write_tuning_database
+
+MATMUL_COMPILATION_INFO = (
+    "#iree_codegen.compilation_info<lowering_config = <tile_sizes = "
+    "[[64, 32, 0], [8, 32, 0], [0, 0, 16]]>, translation_info = "
+    "<CPUDoubleTilingExpert workload_per_wg = [64, 64]>, "
+    "workgroup_size = []>")
+
+
+class TuningDatabaseTest(unittest.TestCase):
+
+  def test_parse_tuning_records(self):
+    record = {
+        "compilation_info": MATMUL_COMPILATION_INFO,
+        "iterator_types": ["parallel", "parallel", "reduction"],
+        "key": "x86_64-unknown-linux-gnu||linalg.matmul(...)",
+        "loop_ranges": [128, 512, 256],
+        "op": "linalg.matmul",
+    }
+    text = json.dumps(record) + "\n\n" + json.dumps(record) + "\n"
+    self.assertEqual(parse_tuning_records(text), [
+        TuningRecord(key="x86_64-unknown-linux-gnu||linalg.matmul(...)",
+                     op="linalg.matmul",
+                     compilation_info=MATMUL_COMPILATION_INFO,
+                     loop_ranges=[128, 512, 256],
+                     iterator_types=["parallel", "parallel", "reduction"])
+    ])
+
+  def test_parse_compilation_info(self):
+    self.assertEqual(parse_compilation_info(MATMUL_COMPILATION_INFO),
+                     ([[64, 32, 0], [8, 32, 0], [0, 0, 16]],
+                      "CPUDoubleTilingExpert", []))
+
+  def test_parse_invalid_compilation_info(self):
+    with self.assertRaises(ValueError):
+      parse_compilation_info("#iree_codegen.translation_info<CPUDefault>")
+
+  def test_format_compilation_info_round_trips(self):
+    formatted = format_compilation_info([[64, 64, 0], [8, 32, 0]],
+                                        "CPUDoubleTilingExpert", [4, 1, 1])
+    self.assertEqual(parse_compilation_info(formatted),
+                     ([[64, 64, 0], [8, 32, 0]], "CPUDoubleTilingExpert",
+                      [4, 1, 1]))
+
+  def test_enumerate_candidates(self):
+    record = TuningRecord(key="k",
+                          op="linalg.matmul",
+                          compilation_info=MATMUL_COMPILATION_INFO,
+                          loop_ranges=[64, 64, 256])
+    candidates = enumerate_candidates(record)
+    tilings = [parse_compilation_info(c)[0] for c in candidates]
+    self.assertNotIn([[64, 32, 0], [8, 32, 0], [0, 0, 16]], tilings)
+    # Doubling the workgroup level exceeds the range of loop 0.
+    self.assertNotIn([[128, 64, 0], [8, 32, 0], [0, 0, 16]], tilings)
+    self.assertIn([[64, 64, 0], [8, 32, 0], [0, 0, 16]], tilings)
+    # Halving the workgroup level makes it smaller than the next level.
+    self.assertNotIn([[32, 16, 0], [8, 32, 0], [0, 0, 16]], tilings)
+    self.assertIn([[64, 32, 0], [4, 16, 0], [0, 0, 16]], tilings)
+    self.assertIn([[64, 32, 0], [8, 32, 0], [0, 0, 32]], tilings)
+    self.assertEqual(len(tilings), len(set(map(str, tilings))))
+    for candidate in candidates:
+      self.assertIn("translation_info = <CPUDoubleTilingExpert>", candidate)
+
+  def test_enumerate_candidates_limit(self):
+    record = TuningRecord(key="k",
+                          op="linalg.matmul",
+                          compilation_info=MATMUL_COMPILATION_INFO)
+    self.assertEqual(len(enumerate_candidates(record, max_candidates=3)), 3)
+
+  def test_add_tuning_entry_keeps_best_speedup(self):
+    entries = {}
+    self.assertTrue(
+        add_tuning_entry(
+            entries, {
+                "key": "k",
+                "compilation_info": "first",
+                "time_ns": 50,
+                "default_time_ns": 100
+            }))
+    # A faster absolute time with a smaller speedup does not replace it.
+    self.assertFalse(
+        add_tuning_entry(
+            entries, {
+                "key": "k",
+                "compilation_info": "second",
+                "time_ns": 40,
+                "default_time_ns": 60
+            }))
+    self.assertEqual(entries["k"]["compilation_info"], "first")
+    self.assertTrue(
+        add_tuning_entry(
+            entries, {
+                "key": "k",
+                "compilation_info": "third",
+                "time_ns": 20,
+                "default_time_ns": 100
+            }))
+    self.assertEqual(entries["k"]["compilation_info"], "third")
+
+  def test_database_round_trips(self):
+    entries = {
+        "b": {
+            "key": "b",
+            "compilation_info": MATMUL_COMPILATION_INFO
+        },
+        "a": {
+            "key": "a",
+            "compilation_info": MATMUL_COMPILATION_INFO,
+            "time_ns": 10
+        },
+    }
+    with tempfile.TemporaryDirectory() as tmp_dir:
+      path = os.path.join(tmp_dir, "db.json")
+      write_tuning_database(path, entries)
+      with open(path, "r") as f:
+        database = json.load(f)
+      self.assertEqual(database["version"], 1)
+      self.assertEqual([entry["key"] for entry in database["entries"]],
+                       ["a", "b"])
+      self.assertEqual(load_tuning_database(path), entries)
+
+
+if __name__ == "__main__":
+  unittest.main()
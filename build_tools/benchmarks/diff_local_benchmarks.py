@@ -9,20 +9,27 @@
 Example usage:
   python3 diff_local_benchmarks.py --base=/path/to/base_benchmarks.json
                                    --target=/path/to/target_benchmarks.json
+
+With --fail_on_regression, the script exits with a non-zero status if any
+target benchmark regressed beyond its threshold in benchmark_thresholds.py,
+which makes it usable as a regression gate between two commits.
 """
 
 import argparse
 import json
 import os
 import requests
+import sys
+
+from typing import Dict
 
 from common.benchmark_presentation import *
 
 
-def get_benchmark_result_markdown(base_benchmark_file: str,
-                                  target_benchmark_file: str,
-                                  verbose: bool = False) -> str:
-  """Gets the full markdown summary of all benchmarks in files."""
+def get_compared_benchmarks(
+    base_benchmark_file: str,
+    target_benchmark_file: str) -> Dict[str, AggregateBenchmarkLatency]:
+  """Gets the target benchmarks annotated with their base numbers."""
   base_benchmarks = aggregate_all_benchmarks([base_benchmark_file])
   target_benchmarks = aggregate_all_benchmarks([target_benchmark_file])
 
@@ -31,6 +38,16 @@ def get_benchmark_result_markdown(base_benchmark_file: str,
     if bench in target_benchmarks:
       target_benchmarks[bench].base_mean_time = base_benchmarks[bench].mean_time
 
+  return target_benchmarks
+
+
+def get_benchmark_result_markdown(base_benchmark_file: str,
+                                  target_benchmark_file: str,
+                                  verbose: bool = False) -> str:
+  """Gets the full markdown summary of all benchmarks in files."""
+  target_benchmarks = get_compared_benchmarks(base_benchmark_file,
+                                              target_benchmark_file)
+
   # Compose the full benchmark tables.
   full_table = [md.header("Full Benchmark Summary", 2)]
   full_table.append(categorize_benchmarks_into_tables(target_benchmarks))
@@ -56,6 +73,11 @@ def parse_arguments():
                       type=check_file_path,
                       required=True,
                       help="Target benchmark results")
+  parser.add_argument(
+      "--fail_on_regression",
+      "--fail-on-regression",
+      action="store_true",
+      help="Exit with a non-zero status if any benchmark regressed")
   parser.add_argument("--verbose",
                       action="store_true",
                       help="Print internal information during execution")
@@ -70,3 +92,9 @@ if __name__ == "__main__":
       get_benchmark_result_markdown(args.base,
                                     args.target,
                                     verbose=args.verbose))
+  if args.fail_on_regression:
+    regressed, _, _, _ = categorize_benchmarks(
+        get_compared_benchmarks(args.base, args.target))
+    if regressed:
+      print(f"{len(regressed)} benchmark(s) regressed", file=sys.stderr)
+      sys.exit(1)
@@ -4,18 +4,194 @@
 # Licensed under the Apache License v2.0 with LLVM Exceptions.
 # See https://llvm.org/LICENSE.txt for license information.
 # SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
-"""Runs all matched benchmark suites on a Linux device."""
+"""Runs all matched benchmark suites on a Linux device.
 
+The benchmarks are run directly on the host with the iree tools built for it,
+so this script expects that the benchmark suites and the tools come from the
+same (host) build directory.
+
+Example usages:
+
+  # Without trace generation
+  python3 run_benchmarks_on_linux.py \
+    --normal_benchmark_tool_dir=/path/to/build/iree/tools \
+    --output=/path/to/results.json \
+    /path/to/build
+
+  # With trace generation
+  python3 run_benchmarks_on_linux.py \
+    --normal_benchmark_tool_dir=/path/to/build/iree/tools \
+    --traced_benchmark_tool_dir=/path/to/tracy/build/iree/tools \
+    --trace_capture_tool=/path/to/tracy/build/tracy/capture \
+    --capture_tarball=/path/to/captures.tar.gz \
+    /path/to/build
+
+Two result files produced by this script (e.g., for two commits) can be
+compared with `diff_local_benchmarks.py`.
+"""
+
+import atexit
+import os
+import re
+import shutil
+import subprocess
+import sys
+import tarfile
+
+from typing import Optional
+
+from common.benchmark_config import BenchmarkConfig
+from common.benchmark_definition import (execute_cmd,
+                                         execute_cmd_and_get_output)
+from common.benchmark_driver import BenchmarkDriver
+from common.benchmark_suite import BenchmarkCase, BenchmarkSuite
 from common.common_arguments import build_common_argument_parser
 from common.linux_device_utils import get_linux_device_info
 
+# The flagfile's filename for compiled benchmark artifacts.
+MODEL_FLAGFILE_NAME = "flagfile"
+
+
+def get_benchmark_repetition_count(runner: str) -> int:
+  """Returns the benchmark repetition count for the given runner."""
+  if runner == "iree-vmvx":
+    # VMVX is very unoptimized for now and can take a long time to run.
+    # Decrease the repetition for it until it's reasonably fast.
+    return 3
+  return 10
+
+
+def get_git_commit_hash(commit: str) -> str:
+  return execute_cmd_and_get_output(['git', 'rev-parse', commit],
+                                    cwd=os.path.dirname(
+                                        os.path.realpath(__file__)))
+
+
+class LinuxBenchmarkDriver(BenchmarkDriver):
+  """Linux benchmark driver."""
+
+  def run_benchmark_case(self, benchmark_case: BenchmarkCase,
+                         benchmark_results_filename: Optional[str],
+                         capture_filename: Optional[str]) -> None:
+    if benchmark_results_filename:
+      self.__run_benchmark(benchmark_case, benchmark_results_filename)
+
+    if capture_filename:
+      self.__run_capture(benchmark_case, capture_filename)
+
+  def __run_benchmark(self, benchmark_case: BenchmarkCase,
+                      results_filename: str):
+    tool = benchmark_case.benchmark_tool_name
+    cmd = [
+        os.path.join(self.config.normal_benchmark_tool_dir, tool),
+        f"--flagfile={MODEL_FLAGFILE_NAME}"
+    ]
+    if tool == "iree-benchmark-module":
+      cmd.extend([
+          "--benchmark_format=json",
+          "--benchmark_out_format=json",
+          f"--benchmark_out={results_filename}",
+      ])
+      if self.config.benchmark_min_time:
+        cmd.extend([
+            f"--benchmark_min_time={self.config.benchmark_min_time}",
+        ])
+      else:
+        repetitions = get_benchmark_repetition_count(benchmark_case.driver)
+        cmd.extend([
+            f"--benchmark_repetitions={repetitions}",
+        ])
+
+    result_json = execute_cmd_and_get_output(
+        cmd, cwd=benchmark_case.benchmark_case_dir, verbose=self.verbose)
+    if self.verbose:
+      print(result_json)
+
+  def __run_capture(self, benchmark_case: BenchmarkCase, capture_filename: str):
+    capture_config = self.config.trace_capture_config
+    tool_path = os.path.join(capture_config.traced_benchmark_tool_dir,
+                             benchmark_case.benchmark_tool_name)
+    cmd = [tool_path, f"--flagfile={MODEL_FLAGFILE_NAME}"]
+    if self.verbose:
+      print(f"cmd: {' '.join(cmd)}")
+
+    # Launch the traced benchmark tool with TRACY_NO_EXIT=1 so that it waits
+    # for the capture tool to collect the trace before exiting.
+    env = dict(os.environ, TRACY_NO_EXIT="1")
+    process = subprocess.Popen(cmd,
+                               env=env,
+                               cwd=benchmark_case.benchmark_case_dir,
+                               stdout=subprocess.PIPE,
+                               universal_newlines=True)
+    # Wait for the benchmark result to be available before connecting the
+    # capture tool; otherwise the connection may fail.
+    while True:
+      line = process.stdout.readline()  # pytype: disable=attribute-error
+      if line == "" and process.poll() is not None:  # Process completed
+        raise ValueError("Cannot find benchmark result line in the log!")
+      if self.verbose:
+        print(line.strip())
+      # Result available
+      if re.match(r"^BM_.+/real_time", line) is not None:
+        break
+
+    # Now it's okay to collect the trace via the capture tool. This will send
+    # the signal to let the previously waiting benchmark tool to complete.
+    capture_cmd = [
+        capture_config.trace_capture_tool, "-f", "-o", capture_filename
+    ]
+    stdout_redirect = None if self.verbose else subprocess.DEVNULL
+    execute_cmd(capture_cmd, verbose=self.verbose, stdout=stdout_redirect)
+    process.wait()
+
 
 def main(args):
   device_info = get_linux_device_info(args.device_model, args.verbose)
   if args.verbose:
     print(device_info)
 
-  raise NotImplementedError()
+  commit = get_git_commit_hash("HEAD")
+  benchmark_config = BenchmarkConfig.build_from_args(args, commit)
+  benchmark_suite = BenchmarkSuite.load_from_benchmark_suite_dir(
+      benchmark_config.root_benchmark_dir)
+  benchmark_driver = LinuxBenchmarkDriver(device_info=device_info,
+                                          config=benchmark_config,
+                                          benchmark_suite=benchmark_suite,
+                                          verbose=args.verbose)
+
+  if args.continue_from_directory:
+    # Merge in previous benchmarks and captures.
+    benchmark_driver.add_previous_benchmarks_and_captures(
+        args.continue_from_directory)
+
+  if not args.no_clean:
+    # Clear the per-commit temporary directory once done.
+    atexit.register(shutil.rmtree,
+                    os.path.dirname(benchmark_config.benchmark_results_dir),
+                    ignore_errors=True)
+
+  benchmark_driver.run()
+
+  benchmark_results = benchmark_driver.get_benchmark_results()
+  if args.output is not None:
+    with open(args.output, "w") as f:
+      f.write(benchmark_results.to_json_str())
+
+  if args.verbose:
+    print(benchmark_results.commit)
+    print(benchmark_results.benchmarks)
+
+  trace_capture_config = benchmark_config.trace_capture_config
+  if trace_capture_config:
+    # Put all captures in a tarball and remove the original files.
+    with tarfile.open(trace_capture_config.capture_tarball, "w:gz") as tar:
+      for capture_filename in benchmark_driver.get_capture_filenames():
+        tar.add(capture_filename)
+
+  benchmark_errors = benchmark_driver.get_benchmark_errors()
+  if benchmark_errors:
+    print("Benchmarking completed with errors", file=sys.stderr)
+    raise RuntimeError(benchmark_errors)
 
 
 def parse_argument():
@@ -0,0 +1,214 @@
+#!/usr/bin/env python3
+# Copyright 2022 The IREE Authors
+#
+# Licensed under the Apache License v2.0 with LLVM Exceptions.
+# See https://llvm.org/LICENSE.txt for license information.
+# SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+"""Tunes the LLVMCPU tile sizes of the dispatches in a program on the host.
+
+The program is compiled once with `--iree-hal-dump-executable-benchmarks-to`
+to get a standalone benchmark module per executable. Each benchmark module is
+then compiled with the default heuristics while recording the chosen
+configurations, and again for every candidate configuration around them, and
+timed with iree-benchmark-module. The fastest configuration of each dispatch
+that beats the default is written to a tuning database that later compiles
+pick up with `--iree-codegen-llvmcpu-tuning-database=<path>`.
+
+Example usage:
+  tune_llvmcpu_dispatches.py model.mlir \\
+      --tools_dir=../iree-build/iree/tools \\
+      --output=model_tuning.json \\
+      --compile_flag=--iree-input-type=mhlo \\
+      --compile_flag=--iree-llvm-target-cpu-features=host
+"""
+
+import argparse
+import glob
+import json
+import os
+import subprocess
+import tempfile
+
+from typing import List, Optional
+
+from common.tuning_database import add_tuning_entry, enumerate_candidates, load_tuning_database, parse_tuning_records, write_tuning_database
+
+_TIME_UNIT_TO_NS = {"ns": 1, "us": 1e3, "ms": 1e6, "s": 1e9}
+
+
+def compile_module(args, input_path: str, output_path: str,
+                   extra_flags: List[str]) -> bool:
+  """Compiles `input_path` for the host CPU. Returns false on failure."""
+  cmd = [
+      os.path.join(args.tools_dir, "iree-compile"),
+      input_path,
+      "--iree-mlir-to-vm-bytecode-module",
+      "--iree-hal-target-backends=dylib-llvm-aot",
+      f"-o={output_path}",
+  ] + args.compile_flag + extra_flags
+  if args.verbose:
+    print(" ".join(cmd))
+  result = subprocess.run(cmd, capture_output=not args.verbose)
+  return result.returncode == 0
+
+
+def benchmark_module(args, module_path: str) -> Optional[float]:
+  """Returns the total median time in nanoseconds of all of the benchmark
+  functions in `module_path` or None if the benchmark failed."""
+  cmd = [
+      os.path.join(args.tools_dir, "iree-benchmark-module"),
+      f"--module_file={module_path}",
+      f"--driver={args.driver}",
+      "--benchmark_format=json",
+      f"--benchmark_repetitions={args.benchmark_repetitions}",
+      "--benchmark_report_aggregates_only=true",
+  ]
+  if args.verbose:
+    print(" ".join(cmd))
+  result = subprocess.run(cmd, capture_output=True, text=True)
+  if result.returncode != 0:
+    return None
+  total_ns = 0.0
+  for benchmark in json.loads(result.stdout)["benchmarks"]:
+    if benchmark.get("aggregate_name", "median") != "median":
+      continue
+    total_ns += benchmark["real_time"] * _TIME_UNIT_TO_NS[
+        benchmark["time_unit"]]
+  return total_ns
+
+
+def tune_benchmark_module(args, benchmark_path: str, work_dir: str,
+                          entries: dict):
+  """Tunes every dispatch of the benchmark module at `benchmark_path` and
+  adds the configurations that beat the default ones to `entries`."""
+  name = os.path.splitext(os.path.basename(benchmark_path))[0]
+  records_path = os.path.join(work_dir, f"{name}_records.jsonl")
+  baseline_path = os.path.join(work_dir, f"{name}.vmfb")
+  if os.path.exists(records_path):
+    os.remove(records_path)
+  if not compile_module(
+      args, benchmark_path, baseline_path,
+      [f"--iree-codegen-llvmcpu-tuning-records={records_path}"]):
+    print(f"Skipping {name}: failed to compile")
+    return
+  baseline_ns = benchmark_module(args, baseline_path)
+  if baseline_ns is None or not os.path.exists(records_path):
+    print(f"Skipping {name}: failed to benchmark")
+    return
+  with open(records_path, "r") as f:
+    records = parse_tuning_records(f.read())
+
+  # Tune one dispatch at a time with the other dispatches in the module left
+  # on their defaults.
+  for record in records:
+    best_ns = baseline_ns
+    best_compilation_info = None
+    candidates = enumerate_candidates(record, args.max_candidates)
+    for index, candidate in enumerate(candidates):
+      database_path = os.path.join(work_dir, f"{name}_candidate.json")
+      write_tuning_database(database_path, {
+          record.key: {
+              "key": record.key,
+              "compilation_info": candidate
+          }
+      })
+      candidate_path = os.path.join(work_dir, f"{name}_candidate.vmfb")
+      if not compile_module(
+          args, benchmark_path, candidate_path,
+          [f"--iree-codegen-llvmcpu-tuning-database={database_path}"]):
+        continue
+      candidate_ns = benchmark_module(args, candidate_path)
+      if args.verbose:
+        print(f"{name} [{index + 1}/{len(candidates)}] {candidate}: "
+              f"{candidate_ns} ns (baseline {baseline_ns} ns)")
+      if candidate_ns is not None and candidate_ns < best_ns:
+        best_ns = candidate_ns
+        best_compilation_info = candidate
+
+    if (best_compilation_info and
+        best_ns < baseline_ns * (1.0 - args.min_improvement)):
+      print(f"{record.key}: {baseline_ns:.0f} ns -> {best_ns:.0f} ns")
+      if not add_tuning_entry(
+          entries, {
+              "key": record.key,
+              "compilation_info": best_compilation_info,
+              "time_ns": int(best_ns),
+              "default_time_ns": int(baseline_ns),
+          }):
+        print(f"{record.key}: keeping existing entry with a larger speedup")
+    else:
+      print(f"{record.key}: keeping default ({baseline_ns:.0f} ns)")
+
+
+def main(args):
+  entries = {}
+  if args.merge and os.path.exists(args.output):
+    entries = load_tuning_database(args.output)
+
+  with tempfile.TemporaryDirectory() as tmp_dir:
+    work_dir = args.work_dir or tmp_dir
+    benchmarks_dir = os.path.join(work_dir, "benchmarks")
+    os.makedirs(benchmarks_dir, exist_ok=True)
+    if not compile_module(
+        args, args.input, os.path.join(work_dir, "program.vmfb"),
+        [f"--iree-hal-dump-executable-benchmarks-to={benchmarks_dir}"]):
+      raise RuntimeError(f"Failed to compile '{args.input}'")
+
+    for benchmark_path in sorted(
+        glob.glob(os.path.join(benchmarks_dir, "*.mlir"))):
+      tune_benchmark_module(args, benchmark_path, work_dir, entries)
+
+  write_tuning_database(args.output, entries)
+  print(f"Wrote {len(entries)} entries to {args.output}")
+
+
+def parse_arguments():
+  parser = argparse.ArgumentParser(description=__doc__.splitlines()[0])
+  parser.add_argument("input",
+                      help="Path to the program to tune (any input accepted "
+                      "by iree-compile)")
+  parser.add_argument("--output",
+                      required=True,
+                      help="Path to write the tuning database to")
+  parser.add_argument("--tools_dir",
+                      required=True,
+                      help="Directory containing iree-compile and "
+                      "iree-benchmark-module")
+  parser.add_argument("--compile_flag",
+                      action="append",
+                      default=[],
+                      help="Extra flag passed to every iree-compile "
+                      "invocation; may be repeated")
+  parser.add_argument("--driver",
+                      default="dylib",
+                      help="Runtime driver used for benchmarking")
+  parser.add_argument("--max_candidates",
+                      type=int,
+                      default=32,
+                      help="Maximum number of candidates tried per dispatch")
+  parser.add_argument("--benchmark_repetitions",
+                      type=int,
+                      default=5,
+                      help="Number of benchmark repetitions to take the "
+                      "median of")
+  parser.add_argument("--min_improvement",
+                      type=float,
+                      default=0.02,
+                      help="Minimum relative speedup over the default "
+                      "configuration for a candidate to be recorded")
+  parser.add_argument("--merge",
+                      action="store_true",
+                      help="Merge into an existing database at --output "
+                      "instead of replacing it")
+  parser.add_argument("--work_dir",
+                      default=None,
+                      help="Directory to keep intermediate files in "
+                      "(defaults to a temporary directory)")
+  parser.add_argument("--verbose",
+                      action="store_true",
+                      help="Print commands and candidate timings")
+  return parser.parse_args()
+
+
+if __name__ == "__main__":
+  main(parse_arguments())
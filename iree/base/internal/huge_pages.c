@@ -0,0 +1,93 @@
+// Copyright 2022 The IREE Authors
+//
+// Licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+#include "iree/base/internal/huge_pages.h"
+
+#include "iree/base/target_platform.h"
+
+#if defined(IREE_PLATFORM_ANDROID) || defined(IREE_PLATFORM_LINUX)
+
+#include <errno.h>
+#include <stdio.h>
+#include <sys/mman.h>
+#include <unistd.h>
+
+#include "iree/base/internal/call_once.h"
+
+static iree_host_size_t iree_huge_page_size_ = 0;
+static iree_once_flag iree_huge_page_size_flag_ = IREE_ONCE_FLAG_INIT;
+static void iree_huge_page_size_initialize(void) {
+  FILE* file = fopen("/sys/kernel/mm/transparent_hugepage/hpage_pmd_size", "r");
+  if (!file) return;
+  unsigned long long hpage_pmd_size = 0;
+  if (fscanf(file, "%llu", &hpage_pmd_size) == 1 &&
+      hpage_pmd_size > (unsigned long long)sysconf(_SC_PAGESIZE)) {
+    iree_huge_page_size_ = (iree_host_size_t)hpage_pmd_size;
+  }
+  fclose(file);
+}
+
+iree_host_size_t iree_huge_page_size(void) {
+  iree_call_once(&iree_huge_page_size_flag_, iree_huge_page_size_initialize);
+  return iree_huge_page_size_;
+}
+
+void* iree_huge_page_map(iree_host_size_t length, iree_host_size_t alignment,
+                         iree_huge_page_map_flags_t flags) {
+  int prot = PROT_READ | PROT_WRITE;
+  int map_flags = MAP_PRIVATE | MAP_ANONYMOUS;
+  if (flags & IREE_HUGE_PAGE_MAP_FLAG_RESERVE_ONLY) {
+    prot = PROT_NONE;
+    map_flags |= MAP_NORESERVE;
+  }
+
+  // Over-reserve so that an aligned range is guaranteed to fit and then trim
+  // the unaligned head and tail.
+  iree_host_size_t reserved_length = length + alignment;
+  uint8_t* reserved_ptr =
+      (uint8_t*)mmap(NULL, reserved_length, prot, map_flags, -1, 0);
+  if (reserved_ptr == MAP_FAILED) return NULL;
+  uint8_t* aligned_ptr =
+      (uint8_t*)iree_host_align((uintptr_t)reserved_ptr, alignment);
+  iree_host_size_t head_length = aligned_ptr - reserved_ptr;
+  iree_host_size_t tail_length = alignment - head_length;
+  if (head_length > 0) munmap(reserved_ptr, head_length);
+  if (tail_length > 0) munmap(aligned_ptr + length, tail_length);
+
+  if (flags & IREE_HUGE_PAGE_MAP_FLAG_ADVISE_HUGE) {
+    iree_huge_page_advise(aligned_ptr, length);
+  }
+  return aligned_ptr;
+}
+
+void iree_huge_page_unmap(void* ptr, iree_host_size_t length) {
+  if (ptr) munmap(ptr, length);
+}
+
+void iree_huge_page_advise(void* ptr, iree_host_size_t length) {
+#if defined(MADV_HUGEPAGE)
+  // NOTE: return value ignored as this is only a hint; THP may be disabled.
+  madvise(ptr, length, MADV_HUGEPAGE);
+#endif  // MADV_HUGEPAGE
+}
+
+#else
+
+#include <errno.h>
+
+iree_host_size_t iree_huge_page_size(void) { return 0; }
+
+void* iree_huge_page_map(iree_host_size_t length, iree_host_size_t alignment,
+                         iree_huge_page_map_flags_t flags) {
+  errno = ENOSYS;
+  return NULL;
+}
+
+void iree_huge_page_unmap(void* ptr, iree_host_size_t length) {}
+
+void iree_huge_page_advise(void* ptr, iree_host_size_t length) {}
+
+#endif  // IREE_PLATFORM_*
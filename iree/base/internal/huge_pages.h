@@ -0,0 +1,62 @@
+// Copyright 2022 The IREE Authors
+//
+// Licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+#ifndef IREE_BASE_INTERNAL_HUGE_PAGES_H_
+#define IREE_BASE_INTERNAL_HUGE_PAGES_H_
+
+#include <stddef.h>
+
+#include "iree/base/api.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif  // __cplusplus
+
+//===----------------------------------------------------------------------===//
+// iree_huge_page_*
+//===----------------------------------------------------------------------===//
+// Anonymous memory mappings aligned for and backed by transparent huge pages
+// (THP). Only Linux/Android are supported today; on other platforms the huge
+// page size is reported as 0 and mapping fails.
+// https://www.kernel.org/doc/html/latest/admin-guide/mm/transhuge.html
+
+// Returns the size of a transparent huge page (hpage_pmd_size, 2MB on most
+// configurations) or 0 if the platform does not support them.
+// The size is queried on first use and cached for the lifetime of the process.
+iree_host_size_t iree_huge_page_size(void);
+
+enum iree_huge_page_map_flag_bits_t {
+  IREE_HUGE_PAGE_MAP_FLAG_NONE = 0u,
+  // Only reserves address space: the pages are inaccessible and not backed by
+  // swap until the caller commits them (for example with mmap(MAP_FIXED)).
+  IREE_HUGE_PAGE_MAP_FLAG_RESERVE_ONLY = 1u << 0,
+  // Hints that the mapping should be backed by huge pages. This is
+  // best-effort as THP may be disabled system-wide in which case the mapping
+  // is still usable with normal pages.
+  IREE_HUGE_PAGE_MAP_FLAG_ADVISE_HUGE = 1u << 1,
+};
+typedef uint32_t iree_huge_page_map_flags_t;
+
+// Maps |length| bytes of zero-filled anonymous read/write memory aligned to
+// |alignment|, which must be a power of two multiple of the normal page size.
+// Returns NULL with errno set if the mapping could not be made or mappings are
+// unsupported on the platform. Release with iree_huge_page_unmap.
+void* iree_huge_page_map(iree_host_size_t length, iree_host_size_t alignment,
+                         iree_huge_page_map_flags_t flags);
+
+// Unmaps |length| bytes at |ptr| as returned by iree_huge_page_map.
+void iree_huge_page_unmap(void* ptr, iree_host_size_t length);
+
+// Hints that the pages overlapping the |length| bytes at |ptr| should be backed
+// by huge pages. Only the huge-page-aligned portions of the range are eligible.
+// |ptr| must be page aligned. No-op if unsupported.
+void iree_huge_page_advise(void* ptr, iree_host_size_t length);
+
+#ifdef __cplusplus
+}  // extern "C"
+#endif  // __cplusplus
+
+#endif  // IREE_BASE_INTERNAL_HUGE_PAGES_H_
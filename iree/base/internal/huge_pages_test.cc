@@ -0,0 +1,49 @@
+// Copyright 2022 The IREE Authors
+//
+// Licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+#include "iree/base/internal/huge_pages.h"
+
+#include <cstdint>
+#include <cstring>
+
+#include "iree/testing/gtest.h"
+
+namespace {
+
+TEST(HugePagesTest, SizeIsCached) {
+  iree_host_size_t huge_page_size = iree_huge_page_size();
+  EXPECT_EQ(huge_page_size, iree_huge_page_size());
+  if (huge_page_size) {
+    EXPECT_EQ(huge_page_size & (huge_page_size - 1), 0);
+  }
+}
+
+TEST(HugePagesTest, MapAligned) {
+  iree_host_size_t alignment = iree_huge_page_size();
+  if (!alignment) GTEST_SKIP() << "huge pages unsupported";
+  iree_host_size_t length = 2 * alignment;
+  uint8_t* ptr = (uint8_t*)iree_huge_page_map(
+      length, alignment, IREE_HUGE_PAGE_MAP_FLAG_ADVISE_HUGE);
+  ASSERT_NE(ptr, nullptr);
+  EXPECT_EQ((uintptr_t)ptr % alignment, 0);
+  // Anonymous mappings are zero-filled and the whole range is usable.
+  EXPECT_EQ(ptr[0], 0);
+  EXPECT_EQ(ptr[length - 1], 0);
+  std::memset(ptr, 0xCD, length);
+  iree_huge_page_unmap(ptr, length);
+}
+
+TEST(HugePagesTest, ReserveOnly) {
+  iree_host_size_t alignment = iree_huge_page_size();
+  if (!alignment) GTEST_SKIP() << "huge pages unsupported";
+  void* ptr = iree_huge_page_map(alignment, alignment,
+                                 IREE_HUGE_PAGE_MAP_FLAG_RESERVE_ONLY);
+  ASSERT_NE(ptr, nullptr);
+  EXPECT_EQ((uintptr_t)ptr % alignment, 0);
+  iree_huge_page_unmap(ptr, alignment);
+}
+
+}  // namespace
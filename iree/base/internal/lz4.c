@@ -0,0 +1,98 @@
+// Copyright 2022 The IREE Authors
+//
+// Licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+#include "iree/base/internal/lz4.h"
+
+#include <string.h>
+
+// Minimum length of a match; encoded match lengths are biased by this.
+#define IREE_LZ4_MIN_MATCH 4
+
+// Reads a variable-length length extension starting at |*ip| and adds it to
+// |*length|. Each 255 byte continues the extension.
+static bool iree_lz4_read_length(const uint8_t** ip, const uint8_t* ip_end,
+                                 iree_host_size_t* length) {
+  uint8_t value = 0;
+  do {
+    if (*ip >= ip_end) return false;
+    value = *(*ip)++;
+    *length += value;
+  } while (value == 255);
+  return true;
+}
+
+iree_status_t iree_lz4_decompress_block(iree_const_byte_span_t source,
+                                        iree_byte_span_t target) {
+  const uint8_t* ip = source.data;
+  const uint8_t* ip_end = ip + source.data_length;
+  uint8_t* op = target.data;
+  uint8_t* op_end = op + target.data_length;
+
+  while (ip < ip_end) {
+    // Each sequence starts with a token containing the literal length in the
+    // high nibble and the match length in the low nibble.
+    const uint8_t token = *ip++;
+
+    // Copy literals.
+    iree_host_size_t literal_length = token >> 4;
+    if (literal_length == 15 &&
+        !iree_lz4_read_length(&ip, ip_end, &literal_length)) {
+      return iree_make_status(IREE_STATUS_DATA_LOSS,
+                              "truncated LZ4 literal length");
+    }
+    if (literal_length > (iree_host_size_t)(ip_end - ip) ||
+        literal_length > (iree_host_size_t)(op_end - op)) {
+      return iree_make_status(IREE_STATUS_DATA_LOSS,
+                              "LZ4 literal run out of bounds");
+    }
+    memcpy(op, ip, literal_length);
+    ip += literal_length;
+    op += literal_length;
+
+    // The last sequence contains only literals.
+    if (ip == ip_end) break;
+
+    // Copy the match from earlier in the output.
+    if (ip_end - ip < 2) {
+      return iree_make_status(IREE_STATUS_DATA_LOSS, "truncated LZ4 offset");
+    }
+    const iree_host_size_t offset = (iree_host_size_t)ip[0] |
+                                    ((iree_host_size_t)ip[1] << 8);
+    ip += 2;
+    if (offset == 0 || offset > (iree_host_size_t)(op - target.data)) {
+      return iree_make_status(IREE_STATUS_DATA_LOSS,
+                              "LZ4 match offset %zu out of bounds", offset);
+    }
+    iree_host_size_t match_length = token & 15;
+    if (match_length == 15 &&
+        !iree_lz4_read_length(&ip, ip_end, &match_length)) {
+      return iree_make_status(IREE_STATUS_DATA_LOSS,
+                              "truncated LZ4 match length");
+    }
+    match_length += IREE_LZ4_MIN_MATCH;
+    if (match_length > (iree_host_size_t)(op_end - op)) {
+      return iree_make_status(IREE_STATUS_DATA_LOSS,
+                              "LZ4 match run out of bounds");
+    }
+    const uint8_t* match = op - offset;
+    if (offset >= match_length) {
+      memcpy(op, match, match_length);
+      op += match_length;
+    } else {
+      // Overlapping matches repeat the last |offset| bytes.
+      for (iree_host_size_t i = 0; i < match_length; ++i) *op++ = *match++;
+    }
+  }
+
+  if (op != op_end) {
+    return iree_make_status(IREE_STATUS_DATA_LOSS,
+                            "LZ4 block decompressed to %zu bytes but %zu "
+                            "were expected",
+                            (iree_host_size_t)(op - target.data),
+                            target.data_length);
+  }
+  return iree_ok_status();
+}
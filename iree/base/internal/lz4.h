@@ -0,0 +1,31 @@
+// Copyright 2022 The IREE Authors
+//
+// Licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+#ifndef IREE_BASE_INTERNAL_LZ4_H_
+#define IREE_BASE_INTERNAL_LZ4_H_
+
+#include "iree/base/api.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif  // __cplusplus
+
+// Decompresses a single LZ4 block from |source| into |target|.
+// |target| must be exactly the decompressed length of the block; if the block
+// decodes to fewer or more bytes an error is returned. The decoder never reads
+// or writes outside of the provided spans and is safe to use on untrusted
+// input.
+//
+// Only the raw block format is supported (no frame headers or checksums):
+// https://github.com/lz4/lz4/blob/dev/doc/lz4_Block_format.md
+iree_status_t iree_lz4_decompress_block(iree_const_byte_span_t source,
+                                        iree_byte_span_t target);
+
+#ifdef __cplusplus
+}  // extern "C"
+#endif  // __cplusplus
+
+#endif  // IREE_BASE_INTERNAL_LZ4_H_
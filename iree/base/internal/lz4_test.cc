@@ -0,0 +1,104 @@
+// Copyright 2022 The IREE Authors
+//
+// Licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+#include "iree/base/internal/lz4.h"
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "iree/base/status_cc.h"
+#include "iree/testing/gtest.h"
+#include "iree/testing/status_matchers.h"
+
+namespace {
+
+using iree::Status;
+using iree::StatusCode;
+using iree::testing::status::StatusIs;
+
+// Decompresses |block| into a buffer of |decompressed_length| bytes.
+static Status Decompress(const std::vector<uint8_t>& block,
+                         iree_host_size_t decompressed_length,
+                         std::string* out_data) {
+  out_data->resize(decompressed_length);
+  return iree_lz4_decompress_block(
+      iree_make_const_byte_span(block.data(), block.size()),
+      iree_make_byte_span((uint8_t*)out_data->data(), out_data->size()));
+}
+
+TEST(LZ4Test, Empty) {
+  std::string data;
+  IREE_EXPECT_OK(Decompress({0x00}, 0, &data));
+  IREE_EXPECT_OK(Decompress({}, 0, &data));
+}
+
+TEST(LZ4Test, LiteralsOnly) {
+  std::string data;
+  IREE_ASSERT_OK(Decompress({0x50, 'h', 'e', 'l', 'l', 'o'}, 5, &data));
+  EXPECT_EQ(data, "hello");
+}
+
+TEST(LZ4Test, LongLiteralLength) {
+  // 300 literals: 15 in the token + 255 + 30 in the extension bytes.
+  std::vector<uint8_t> block = {0xF0, 0xFF, 0x1E};
+  for (int i = 0; i < 300; ++i) block.push_back('a' + i % 26);
+  std::string data;
+  IREE_ASSERT_OK(Decompress(block, 300, &data));
+  for (int i = 0; i < 300; ++i) EXPECT_EQ(data[i], 'a' + i % 26);
+}
+
+TEST(LZ4Test, Match) {
+  // "abcd" + match(offset=4, length=8) + "xyz".
+  std::vector<uint8_t> block = {0x44, 'a', 'b', 'c',  'd', 0x04,
+                                0x00, 0x30, 'x', 'y', 'z'};
+  std::string data;
+  IREE_ASSERT_OK(Decompress(block, 15, &data));
+  EXPECT_EQ(data, "abcdabcdabcdxyz");
+}
+
+TEST(LZ4Test, OverlappingMatch) {
+  // "a" + match(offset=1, length=10+4+255+1) + "b".
+  std::vector<uint8_t> block = {0x1F, 'a', 0x01, 0x00, 0xFF,
+                                0x01, 0x10, 'b'};
+  std::string data;
+  IREE_ASSERT_OK(Decompress(block, 1 + 275 + 1, &data));
+  EXPECT_EQ(data, std::string(276, 'a') + "b");
+}
+
+TEST(LZ4Test, LengthMismatch) {
+  std::vector<uint8_t> block = {0x50, 'h', 'e', 'l', 'l', 'o'};
+  std::string data;
+  EXPECT_THAT(Decompress(block, 4, &data), StatusIs(StatusCode::kDataLoss));
+  EXPECT_THAT(Decompress(block, 6, &data), StatusIs(StatusCode::kDataLoss));
+}
+
+TEST(LZ4Test, InvalidOffset) {
+  std::string data;
+  // Offset of zero.
+  EXPECT_THAT(Decompress({0x10, 'a', 0x00, 0x00}, 5, &data),
+              StatusIs(StatusCode::kDataLoss));
+  // Offset before the start of the output.
+  EXPECT_THAT(Decompress({0x10, 'a', 0x02, 0x00}, 5, &data),
+              StatusIs(StatusCode::kDataLoss));
+}
+
+TEST(LZ4Test, Truncated) {
+  std::string data;
+  // Literal length extension missing.
+  EXPECT_THAT(Decompress({0xF0}, 15, &data), StatusIs(StatusCode::kDataLoss));
+  // Fewer literals than declared.
+  EXPECT_THAT(Decompress({0x30, 'a'}, 3, &data),
+              StatusIs(StatusCode::kDataLoss));
+  // Offset cut short.
+  EXPECT_THAT(Decompress({0x10, 'a', 0x01}, 5, &data),
+              StatusIs(StatusCode::kDataLoss));
+  // Match length extension missing.
+  EXPECT_THAT(Decompress({0x1F, 'a', 0x01, 0x00}, 20, &data),
+              StatusIs(StatusCode::kDataLoss));
+}
+
+}  // namespace
@@ -498,13 +498,37 @@ class HALDispatchABI {
     return castValueToType(loc, constantValue, resultType, builder);
   }
 
+  // Loads the ordinal of the import with the given |symbolName|.
+  // Ordinals are assigned when the linked executable is serialized so this
+  // loads from a placeholder global (see kImportOrdinalGlobalPrefix) that is
+  // declared on first use.
+  Value loadImportOrdinal(Location loc, StringRef symbolName,
+                          OpBuilder &builder) {
+    auto moduleOp = funcOp->getParentOfType<ModuleOp>();
+    std::string globalName = (kImportOrdinalGlobalPrefix + symbolName).str();
+    auto globalOp = moduleOp.lookupSymbol<LLVM::GlobalOp>(globalName);
+    if (!globalOp) {
+      OpBuilder::InsertionGuard guard(builder);
+      builder.setInsertionPointToStart(moduleOp.getBody());
+      globalOp = builder.create<LLVM::GlobalOp>(
+          loc, builder.getI32Type(), /*isConstant=*/true,
+          LLVM::Linkage::Internal, globalName, builder.getI32IntegerAttr(0));
+    }
+    Value globalPtrValue = builder.create<LLVM::AddressOfOp>(loc, globalOp);
+    return builder.create<LLVM::LoadOp>(loc, globalPtrValue);
+  }
+
   // Loads the import function pointer of the import |ordinal|.
   // Equivalent to:
   //   iree_hal_executable_import_v0_t func_ptr = state->imports[ordinal];
   Value loadImportFuncPtr(Location loc, int64_t ordinal, OpBuilder &builder) {
+    return loadImportFuncPtr(loc, getIndexValue(loc, ordinal, builder),
+                             builder);
+  }
+  Value loadImportFuncPtr(Location loc, Value ordinalValue,
+                          OpBuilder &builder) {
     auto importsPtrValue =
         loadFieldValue(loc, EnvironmentField::imports, builder);
-    auto ordinalValue = getIndexValue(loc, ordinal, builder);
     auto elementPtrValue = builder.createOrFold<LLVM::GEPOp>(
         loc, importsPtrValue.getType(), importsPtrValue, ordinalValue);
     return builder.createOrFold<LLVM::LoadOp>(loc, elementPtrValue);
@@ -515,7 +539,11 @@ class HALDispatchABI {
   //   state->imports[ordinal] != NULL
   Value isImportFuncAvailable(Location loc, int64_t ordinal,
                               OpBuilder &builder) {
-    auto importPtrValue = loadImportFuncPtr(loc, ordinal, builder);
+    return isImportFuncAvailable(loc, loadImportFuncPtr(loc, ordinal, builder),
+                                 builder);
+  }
+  Value isImportFuncAvailable(Location loc, Value importPtrValue,
+                              OpBuilder &builder) {
     auto nullPtrValue =
         builder.create<LLVM::NullOp>(loc, importPtrValue.getType()).getResult();
     return builder.create<LLVM::ICmpOp>(loc, builder.getI1Type(),
@@ -529,9 +557,22 @@ class HALDispatchABI {
   // Returns 0 on success and non-zero otherwise.
   Value callImport(Location loc, unsigned importOrdinal, Value params,
                    OpBuilder &builder) {
+    return callImport(loc, getIndexValue(loc, importOrdinal, builder), params,
+                      builder);
+  }
+  Value callImport(Location loc, Value importOrdinalValue, Value params,
+                   OpBuilder &builder) {
+    return callImportFuncPtr(
+        loc, loadImportFuncPtr(loc, importOrdinalValue, builder), params,
+        builder);
+  }
+
+  // Emits a call to the import function pointer |importPtrValue| as loaded by
+  // loadImportFuncPtr.
+  Value callImportFuncPtr(Location loc, Value importPtrValue, Value params,
+                          OpBuilder &builder) {
     auto thunkPtrValue =
         loadFieldValue(loc, EnvironmentField::import_thunk, builder);
-    auto importPtrValue = loadImportFuncPtr(loc, importOrdinal, builder);
     auto callOp =
         builder.create<LLVM::CallOp>(loc, TypeRange{builder.getI32Type()},
                                      ValueRange{
@@ -848,6 +889,139 @@ class ConvertHALInterfaceBindingSubspanOp : public ConvertToLLVMPattern {
   }
 };
 
+/// Rewrites func.call ops targeting declarations tagged with `hal.import` to
+/// calls through the executable import table.
+///
+/// Imports are declared weak and may not be provided by the runtime. Calls
+/// return an i1 that is true if the import was available and called so that
+/// the caller can branch to a fallback implementation otherwise.
+///
+/// All call operands are packed into a struct that is passed as the import
+/// parameters: memrefs are passed as a pointer to their first element followed
+/// by the stride of their outermost dimension and all other operands are
+/// passed as-is. The struct must match the layout expected by the runtime
+/// implementation of the import (see iree/hal/local/microkernels/).
+///
+/// The parent LLVMFuncOp must be compatible with HALDispatchABI.
+class ConvertHALImportCallOp : public ConvertToLLVMPattern {
+ public:
+  explicit ConvertHALImportCallOp(MLIRContext *context,
+                                  LLVMTypeConverter &converter)
+      : ConvertToLLVMPattern(func::CallOp::getOperationName(), context,
+                             converter, 100) {}
+
+  LogicalResult matchAndRewrite(
+      Operation *op, ArrayRef<Value> operands,
+      ConversionPatternRewriter &rewriter) const override {
+    auto callOp = cast<func::CallOp>(op);
+    auto calleeOp = SymbolTable::lookupNearestSymbolFrom<func::FuncOp>(
+        op, callOp.getCalleeAttr());
+    if (!calleeOp || !calleeOp->hasAttr("hal.import")) return failure();
+    if (callOp.getNumResults() != 1 ||
+        !callOp.getResult(0).getType().isInteger(1)) {
+      return rewriter.notifyMatchFailure(
+          op, "imports must return only whether they were called");
+    }
+    auto llvmFuncOp = op->getParentOfType<LLVM::LLVMFuncOp>();
+    if (!llvmFuncOp) return failure();
+    HALDispatchABI abi(llvmFuncOp, getTypeConverter());
+    Location loc = op->getLoc();
+
+    // Flatten the operands into the parameter struct fields.
+    SmallVector<Value> fieldValues;
+    for (auto it : llvm::zip(callOp.getOperands(), operands)) {
+      Value operand = std::get<0>(it);
+      Value convertedOperand = std::get<1>(it);
+      auto memRefType = operand.getType().dyn_cast<MemRefType>();
+      if (!memRefType) {
+        fieldValues.push_back(convertedOperand);
+        continue;
+      }
+      if (memRefType.getRank() == 0) {
+        return rewriter.notifyMatchFailure(op, "unsupported rank-0 memref");
+      }
+      MemRefDescriptor descriptor(convertedOperand);
+      Value alignedPtr = descriptor.alignedPtr(rewriter, loc);
+      fieldValues.push_back(rewriter.create<LLVM::GEPOp>(
+          loc, alignedPtr.getType(), alignedPtr,
+          ValueRange{descriptor.offset(rewriter, loc)}));
+      fieldValues.push_back(descriptor.stride(rewriter, loc, 0));
+    }
+    SmallVector<Type> fieldTypes;
+    for (auto value : fieldValues) fieldTypes.push_back(value.getType());
+    auto paramsType =
+        LLVM::LLVMStructType::getLiteral(rewriter.getContext(), fieldTypes);
+    auto paramsPtrType = LLVM::LLVMPointerType::get(paramsType);
+
+    // Reserve the parameter storage in the entry block so that calls within
+    // loops reuse the same stack slot.
+    Value paramsPtr;
+    {
+      OpBuilder::InsertionGuard guard(rewriter);
+      rewriter.setInsertionPointToStart(&llvmFuncOp.getBody().front());
+      Value one = rewriter.create<LLVM::ConstantOp>(
+          loc, rewriter.getI64Type(), rewriter.getI64IntegerAttr(1));
+      paramsPtr = rewriter.create<LLVM::AllocaOp>(loc, paramsPtrType, one,
+                                                  /*alignment=*/0);
+    }
+
+    // Only call the import if the runtime provided it:
+    //   if (state->imports[ordinal] != NULL) {
+    //     import_thunk(state->imports[ordinal], &params);
+    //   }
+    Value ordinalValue =
+        abi.loadImportOrdinal(loc, calleeOp.getName(), rewriter);
+    Value importPtrValue = abi.loadImportFuncPtr(loc, ordinalValue, rewriter);
+    Value isAvailable =
+        abi.isImportFuncAvailable(loc, importPtrValue, rewriter);
+    Block *currentBlock = rewriter.getInsertionBlock();
+    Block *remainingOpsBlock =
+        rewriter.splitBlock(currentBlock, rewriter.getInsertionPoint());
+    Block *callBlock = rewriter.createBlock(remainingOpsBlock);
+    rewriter.setInsertionPointToEnd(currentBlock);
+    rewriter.create<LLVM::CondBrOp>(loc, isAvailable, callBlock,
+                                    remainingOpsBlock);
+    rewriter.setInsertionPointToEnd(callBlock);
+
+    Value paramsValue = rewriter.create<LLVM::UndefOp>(loc, paramsType);
+    for (auto fieldValue : llvm::enumerate(fieldValues)) {
+      paramsValue = rewriter.create<LLVM::InsertValueOp>(
+          loc, paramsValue, fieldValue.value(),
+          rewriter.getI64ArrayAttr(fieldValue.index()));
+    }
+    rewriter.create<LLVM::StoreOp>(loc, paramsValue, paramsPtr);
+    Value paramsI8Ptr = rewriter.create<LLVM::BitcastOp>(
+        loc, LLVM::LLVMPointerType::get(rewriter.getI8Type()), paramsPtr);
+
+    // NOTE: imports are expected to clamp instead of failing and we have no
+    // way of propagating a failure out of the middle of the dispatch today so
+    // the result is dropped.
+    abi.callImportFuncPtr(loc, importPtrValue, paramsI8Ptr, rewriter);
+    rewriter.create<LLVM::BrOp>(loc, ValueRange{}, remainingOpsBlock);
+
+    rewriter.replaceOp(op, isAvailable);
+    return success();
+  }
+};
+
+/// Drops the declarations of `hal.import` functions. All calls to them are
+/// routed through the import table by ConvertHALImportCallOp.
+class ConvertHALImportFuncOp : public ConvertToLLVMPattern {
+ public:
+  explicit ConvertHALImportFuncOp(MLIRContext *context,
+                                  LLVMTypeConverter &converter)
+      : ConvertToLLVMPattern(func::FuncOp::getOperationName(), context,
+                             converter, 100) {}
+
+  LogicalResult matchAndRewrite(
+      Operation *op, ArrayRef<Value> operands,
+      ConversionPatternRewriter &rewriter) const override {
+    if (!op->hasAttr("hal.import")) return failure();
+    rewriter.eraseOp(op);
+    return success();
+  }
+};
+
 class ConvertToLLVMPass : public ConvertToLLVMBase<ConvertToLLVMPass> {
  public:
   ConvertToLLVMPass() = default;
@@ -967,7 +1141,9 @@ void ConvertToLLVMPass::runOnOperation() {
     ConvertHALInterfaceWorkgroupSizeOp,
     ConvertHALInterfaceWorkgroupCountOp,
     ConvertHALInterfaceLoadConstant,
-    ConvertHALInterfaceBindingSubspanOp
+    ConvertHALInterfaceBindingSubspanOp,
+    ConvertHALImportCallOp,
+    ConvertHALImportFuncOp
   >(&getContext(), converter);
   // clang-format on
 
@@ -981,6 +1157,7 @@ void ConvertToLLVMPass::runOnOperation() {
   // Don't apply patterns to private function (e.g num_workgroups func).
   target.addDynamicallyLegalOp<func::FuncOp>([&](func::FuncOp funcOp) {
     if (isEntryPoint(funcOp)) return false;
+    if (funcOp->hasAttr("hal.import")) return false;
     return true;
   });
   target.addDynamicallyLegalDialect<func::FuncDialect, mlir::math::MathDialect,
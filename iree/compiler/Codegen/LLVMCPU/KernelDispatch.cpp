@@ -7,6 +7,7 @@
 #include "iree/compiler/Codegen/LLVMCPU/KernelDispatch.h"
 
 #include "iree-dialects/Dialect/LinalgExt/IR/LinalgExtOps.h"
+#include "iree/compiler/Codegen/LLVMCPU/TuningDatabase.h"
 #include "iree/compiler/Codegen/Transforms/Transforms.h"
 #include "iree/compiler/Codegen/Utils/MarkerUtils.h"
 #include "iree/compiler/Codegen/Utils/Utils.h"
@@ -22,6 +23,7 @@
 #include "mlir/Dialect/MemRef/Transforms/Passes.h"
 #include "mlir/Dialect/Utils/StaticValueUtils.h"
 #include "mlir/IR/Matchers.h"
+#include "mlir/IR/TypeUtilities.h"
 #include "mlir/Transforms/GreedyPatternRewriteDriver.h"
 
 namespace mlir {
@@ -54,6 +56,13 @@ static llvm::cl::list<int> mmt4dVectorSizes(
     "iree-codegen-llvm-mmt4d-vector-size",
     llvm::cl::desc("linalg.mmt4d vector tile size"), llvm::cl::ZeroOrMore);
 
+static llvm::cl::opt<bool> clUseMicrokernels(
+    "iree-codegen-llvm-use-microkernels",
+    llvm::cl::desc("call runtime-provided microkernels through the executable "
+                   "import table for ops that have them (linalg.mmt4d) "
+                   "instead of generating their inner loops"),
+    llvm::cl::init(false));
+
 static llvm::cl::opt<int> defaultWorkgroupTileSize(
     "iree-codegen-llvm-generic-ops-workgroup-size",
     llvm::cl::desc(
@@ -66,6 +75,24 @@ static llvm::cl::opt<bool> useLinalgTransformInterp(
         "experimental path to use the linalg transform dialect interpreter"),
     llvm::cl::init(false));
 
+static llvm::cl::opt<std::string> clTuningDatabase(
+    "iree-codegen-llvmcpu-tuning-database",
+    llvm::cl::desc("path to a tuning database pinning the compilation info of "
+                   "dispatches by root op signature (see TuningDatabase.h)"),
+    llvm::cl::init(""));
+
+static llvm::cl::opt<std::string> clTuningRecords(
+    "iree-codegen-llvmcpu-tuning-records",
+    llvm::cl::desc("path to a file to append the compilation info chosen for "
+                   "each dispatch to, as JSON lines for tuning tools"),
+    llvm::cl::init(""));
+
+static llvm::cl::opt<std::string> clMatmulTileOrder(
+    "iree-codegen-llvmcpu-matmul-tile-order",
+    llvm::cl::desc("workgroup execution order hinted to the runtime for "
+                   "matmul-like dispatches: linear, morton, or super_tile"),
+    llvm::cl::init("linear"));
+
 using IREE::Codegen::DispatchLoweringPassPipeline;
 
 /// Looks for the `native_vector_size` attribute in the hal.executable.variant
@@ -511,6 +538,17 @@ static LogicalResult setRootConfig(
   }
 }
 
+/// Returns true if the runtime provides a microkernel for the element types of
+/// |mmt4dOp|. Must be kept in sync with LLVMCPULowerToMicrokernels.cpp.
+static bool hasMmt4dMicrokernel(linalg::Mmt4DOp mmt4dOp) {
+  Type lhsType = getElementTypeOrSelf(mmt4dOp.inputs()[0].getType());
+  Type rhsType = getElementTypeOrSelf(mmt4dOp.inputs()[1].getType());
+  Type outType = getElementTypeOrSelf(mmt4dOp.outputs()[0].getType());
+  if (lhsType.isF32() && rhsType.isF32() && outType.isF32()) return true;
+  return lhsType.isSignlessInteger(8) && rhsType.isSignlessInteger(8) &&
+         outType.isSignlessInteger(32);
+}
+
 /// Sets the lowering configuration for dispatch region for linalg.mmt4d root
 /// op
 static LogicalResult setRootConfig(
@@ -553,6 +591,14 @@ static LogicalResult setRootConfig(
     return {1, 1, 1, M0, N0, K0};
   };
 
+  if (clUseMicrokernels && hasMmt4dMicrokernel(mmt4dOp)) {
+    // The microkernel handles everything below the workgroup tile.
+    TileSizesListType tileSizes = {getWorkgroupTileSizes()};
+    return setOpConfigAndEntryPointFnTranslation(
+        entryPointFn, mmt4dOp, tileSizes,
+        DispatchLoweringPassPipeline::CPUMicrokernels);
+  }
+
   SmallVector<int64_t> nativeVectorSize = getVectorSizes();
 
   TileSizesListType tileSizes = {getWorkgroupTileSizes(), getL1TileSizes(),
@@ -926,8 +972,56 @@ static LogicalResult setTranslationInfoAndRootConfig(
     }
   }
 
+  // Then pin the configuration of the root operation from the tuning database
+  // unless one was preset.
+  FailureOr<Operation *> rootOp = getRootOperation(computeOps);
+  if (failed(rootOp)) return failure();
+  if (!clTuningDatabase.empty() && rootOp.getValue() &&
+      !getTranslationInfo(entryPointFn)) {
+    FailureOr<IREE::Codegen::CompilationInfoAttr> compilationInfo =
+        lookupTuningDatabase(clTuningDatabase, entryPointFn,
+                             rootOp.getValue());
+    if (failed(compilationInfo)) return failure();
+    if (compilationInfo.getValue()) {
+      setTranslationInfo(entryPointFn,
+                         compilationInfo->getTranslationInfo(),
+                         compilationInfo->getWorkgroupSizeVals());
+      setLoweringConfig(rootOp.getValue(),
+                        compilationInfo->getLoweringConfig());
+    }
+  }
+
   // Next set the configuration of the operations.
-  return setRootConfig(entryPointFn, computeOps, tiledLoops);
+  if (failed(setRootConfig(entryPointFn, computeOps, tiledLoops))) {
+    return failure();
+  }
+
+  // Finally record the configuration for tuning tools to start from.
+  if (!clTuningRecords.empty() && rootOp.getValue()) {
+    return appendTuningRecord(clTuningRecords, entryPointFn,
+                              rootOp.getValue());
+  }
+  return success();
+}
+
+/// Hints the preferred workgroup execution order of the dispatch to the
+/// runtime. Matmul-like root ops read the same LHS panel in every workgroup
+/// along x and the same RHS panel in every workgroup along y; walking the grid
+/// in blocks instead of row-major keeps both panels in the shared caches while
+/// they are reused. Other dispatches keep the default linear order that plays
+/// best with hardware prefetchers on streaming accesses.
+static void setTileOrderHint(IREE::HAL::ExecutableEntryPointOp entryPointOp,
+                             ArrayRef<Operation *> computeOps) {
+  if (clMatmulTileOrder.empty() || clMatmulTileOrder == "linear") return;
+  FailureOr<Operation *> rootOp = getRootOperation(computeOps);
+  if (failed(rootOp) || !rootOp.getValue()) return;
+  if (!isa<linalg::ContractionOpInterface, linalg::Mmt4DOp>(
+          rootOp.getValue())) {
+    return;
+  }
+  entryPointOp->setAttr(
+      kTileOrderAttrName,
+      StringAttr::get(entryPointOp.getContext(), clMatmulTileOrder));
 }
 
 LogicalResult initCPULaunchConfig(ModuleOp moduleOp) {
@@ -960,6 +1054,7 @@ LogicalResult initCPULaunchConfig(ModuleOp moduleOp) {
             setTranslationInfoAndRootConfig(funcOp, computeOps, tiledLoops))) {
       return failure();
     }
+    if (!isVMVXBackend(funcOp)) setTileOrderHint(entryPointOp, computeOps);
   }
 
   // The root confguration setting introduces `tensor.dim` operations. Resolve
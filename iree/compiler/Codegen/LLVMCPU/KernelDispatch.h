@@ -33,6 +33,12 @@ enum class StrategyTilingLevel : unsigned {
   NumStrategyTileLevels = 3
 };
 
+// Name of the string attribute on hal.executable.entry_point ops holding the
+// preferred order in which the runtime should execute workgroups: `linear`,
+// `morton`, or `super_tile`. Serialized into the tile_order field of
+// iree_hal_executable_dispatch_attrs_v0_t.
+constexpr StringLiteral kTileOrderAttrName = "iree.tile_order";
+
 LogicalResult initCPULaunchConfig(ModuleOp moduleOp);
 
 }  // namespace iree_compiler
@@ -200,6 +200,9 @@ void LLVMCPULowerExecutableTargetPass::runOnOperation() {
               CPUBufferOpsTileAndVectorize:
             addCPUBufferOpsTileAndVectorizePipeline(nestedModulePM);
             break;
+          case IREE::Codegen::DispatchLoweringPassPipeline::CPUMicrokernels:
+            addCPUMicrokernelsPassPipeline(nestedModulePM);
+            break;
           case IREE::Codegen::DispatchLoweringPassPipeline::
               CPUSingleTilingExpert:
             addSingleTilingExpertPassPipeline(nestedModulePM);
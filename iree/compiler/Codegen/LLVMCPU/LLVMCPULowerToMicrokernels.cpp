@@ -0,0 +1,166 @@
+// Copyright 2022 The IREE Authors
+//
+// Licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+#include "iree/compiler/Codegen/PassDetail.h"
+#include "iree/compiler/Codegen/Passes.h"
+#include "llvm/ADT/StringRef.h"
+#include "mlir/Dialect/Arithmetic/IR/Arithmetic.h"
+#include "mlir/Dialect/Func/IR/FuncOps.h"
+#include "mlir/Dialect/Linalg/IR/Linalg.h"
+#include "mlir/Dialect/MemRef/IR/MemRef.h"
+#include "mlir/Dialect/SCF/SCF.h"
+#include "mlir/IR/BuiltinAttributes.h"
+#include "mlir/IR/BuiltinTypes.h"
+#include "mlir/IR/SymbolTable.h"
+#include "mlir/Pass/Pass.h"
+
+namespace mlir {
+namespace iree_compiler {
+
+namespace {
+
+// Returns the name of the runtime microkernel implementing mmt4d for the given
+// element types or an empty string if there is none.
+// Must be kept in sync with iree/hal/local/microkernels/microkernels.h.
+static StringRef getMmt4dMicrokernelName(Type lhsType, Type rhsType,
+                                         Type outType) {
+  if (lhsType.isF32() && rhsType.isF32() && outType.isF32()) {
+    return "iree_microkernel_mmt4d_f32f32f32";
+  }
+  if (lhsType.isSignlessInteger(8) && rhsType.isSignlessInteger(8) &&
+      outType.isSignlessInteger(32)) {
+    return "iree_microkernel_mmt4d_i8i8i32";
+  }
+  return "";
+}
+
+// Returns true if the inner three dimensions of the rank-4 |type| are
+// contiguous so that only the outermost stride needs to be passed to the
+// microkernel.
+static bool hasContiguousInnerDims(MemRefType type) {
+  if (type.getRank() != 4) return false;
+  SmallVector<int64_t> strides;
+  int64_t offset;
+  if (failed(getStridesAndOffset(type, strides, offset))) return false;
+  ArrayRef<int64_t> shape = type.getShape();
+  int64_t expectedStride = 1;
+  for (int i = 3; i >= 2; --i) {
+    if (strides[i] != expectedStride) return false;
+    if (ShapedType::isDynamic(shape[i])) return false;
+    expectedStride *= shape[i];
+  }
+  return strides[1] == expectedStride;
+}
+
+// Casts |value| to a memref of the same rank and element type with a fully
+// dynamic shape and strided layout so that all call sites of an import share
+// a single function type.
+static Value castToDynamicStridedMemRef(OpBuilder &builder, Location loc,
+                                        Value value) {
+  auto type = value.getType().cast<MemRefType>();
+  SmallVector<int64_t> dynamicShape(type.getRank(), ShapedType::kDynamicSize);
+  SmallVector<int64_t> dynamicStrides(type.getRank(),
+                                      ShapedType::kDynamicStrideOrOffset);
+  auto layout = makeStridedLinearLayoutMap(
+      dynamicStrides, ShapedType::kDynamicStrideOrOffset,
+      builder.getContext());
+  auto dynamicType =
+      MemRefType::get(dynamicShape, type.getElementType(), layout,
+                      type.getMemorySpace());
+  if (dynamicType == type) return value;
+  return builder.create<memref::CastOp>(loc, dynamicType, value);
+}
+
+// Returns the import declaration named |name| with |type|, inserting it at the
+// start of |moduleOp| if needed.
+static func::FuncOp getOrInsertImport(ModuleOp moduleOp, StringRef name,
+                                      FunctionType type) {
+  if (auto funcOp = moduleOp.lookupSymbol<func::FuncOp>(name)) return funcOp;
+  auto builder = OpBuilder::atBlockBegin(moduleOp.getBody());
+  auto funcOp = builder.create<func::FuncOp>(moduleOp.getLoc(), name, type);
+  funcOp.setPrivate();
+  funcOp->setAttr("hal.import", builder.getUnitAttr());
+  return funcOp;
+}
+
+// Replaces |mmt4dOp| with a call to the mmt4d microkernel. The call arguments
+// are ordered to match iree_microkernel_mmt4d_params_t.
+//
+// Microkernels are weak imports: runtimes that do not provide them (such as
+// loaders created with iree_hal_executable_import_provider_null) leave the
+// import unresolved and the call returns false. The original op is kept in
+// the else branch as the inline fallback for that case.
+static LogicalResult lowerMmt4dToMicrokernel(ModuleOp moduleOp,
+                                             linalg::Mmt4DOp mmt4dOp) {
+  if (!mmt4dOp.hasBufferSemantics()) return failure();
+  Value lhs = mmt4dOp.inputs()[0];
+  Value rhs = mmt4dOp.inputs()[1];
+  Value out = mmt4dOp.outputs()[0];
+  auto lhsType = lhs.getType().cast<MemRefType>();
+  auto rhsType = rhs.getType().cast<MemRefType>();
+  auto outType = out.getType().cast<MemRefType>();
+  StringRef importName =
+      getMmt4dMicrokernelName(lhsType.getElementType(),
+                              rhsType.getElementType(),
+                              outType.getElementType());
+  if (importName.empty()) return failure();
+  if (!hasContiguousInnerDims(lhsType) || !hasContiguousInnerDims(rhsType) ||
+      !hasContiguousInnerDims(outType)) {
+    return failure();
+  }
+
+  OpBuilder builder(mmt4dOp);
+  Location loc = mmt4dOp.getLoc();
+  SmallVector<Value> operands = {
+      castToDynamicStridedMemRef(builder, loc, lhs),
+      castToDynamicStridedMemRef(builder, loc, rhs),
+      castToDynamicStridedMemRef(builder, loc, out),
+      builder.create<memref::DimOp>(loc, lhs, 0),
+      builder.create<memref::DimOp>(loc, rhs, 0),
+      builder.create<memref::DimOp>(loc, lhs, 1),
+      builder.create<arith::ConstantIndexOp>(loc, lhsType.getDimSize(2)),
+      builder.create<arith::ConstantIndexOp>(loc, rhsType.getDimSize(2)),
+      builder.create<arith::ConstantIndexOp>(loc, lhsType.getDimSize(3)),
+  };
+  auto importType = builder.getFunctionType(ValueRange{operands}.getTypes(),
+                                            builder.getI1Type());
+  auto importOp = getOrInsertImport(moduleOp, importName, importType);
+  if (importOp.getFunctionType() != importType) return failure();
+  auto callOp = builder.create<func::CallOp>(loc, importOp, operands);
+  auto ifOp = builder.create<scf::IfOp>(loc, callOp.getResult(0),
+                                        /*withElseRegion=*/true);
+  mmt4dOp->moveBefore(ifOp.elseBlock()->getTerminator());
+  return success();
+}
+
+struct LLVMCPULowerToMicrokernelsPass
+    : public LLVMCPULowerToMicrokernelsBase<LLVMCPULowerToMicrokernelsPass> {
+  void getDependentDialects(DialectRegistry &registry) const override {
+    registry.insert<arith::ArithmeticDialect, func::FuncDialect,
+                    memref::MemRefDialect, scf::SCFDialect>();
+  }
+
+  void runOnOperation() override {
+    ModuleOp moduleOp = getOperation();
+    SmallVector<linalg::Mmt4DOp> mmt4dOps;
+    moduleOp.walk([&](linalg::Mmt4DOp op) { mmt4dOps.push_back(op); });
+    for (auto mmt4dOp : mmt4dOps) {
+      // Ops that have no matching microkernel are left for the default
+      // lowering to loops.
+      (void)lowerMmt4dToMicrokernel(moduleOp, mmt4dOp);
+    }
+  }
+};
+
+}  // namespace
+
+std::unique_ptr<OperationPass<ModuleOp>>
+createLLVMCPULowerToMicrokernelsPass() {
+  return std::make_unique<LLVMCPULowerToMicrokernelsPass>();
+}
+
+}  // namespace iree_compiler
+}  // namespace mlir
@@ -441,6 +441,22 @@ void addCPUDefaultPassPipeline(OpPassManager &passManager) {
   addLinalgBufferizePasses(passManager, cpuAllocationFunction);
 }
 
+void addCPUMicrokernelsPassPipeline(OpPassManager &passManager) {
+  // Do first level of tile and distribute to workgroups.
+  passManager.addNestedPass<func::FuncOp>(createInsertDistributionInfoPass());
+  passManager.addNestedPass<func::FuncOp>(
+      createTileAndDistributeToWorkgroupsPass());
+  passManager.addPass(createCanonicalizerPass());
+  passManager.addPass(createCSEPass());
+  // Use stack allocation on CPU side.
+  addLinalgBufferizePasses(passManager, cpuAllocationFunction);
+
+  // Hand the workgroup tiles to the runtime microkernels. Anything without a
+  // microkernel falls through to the default lowering to loops.
+  passManager.addPass(createLLVMCPULowerToMicrokernelsPass());
+  passManager.addPass(createCanonicalizerPass());
+}
+
 void addLinalgTransformInterpPasses(OpPassManager &passManager) {
   // Give control to the linalg_transform dialect.
   passManager.addPass(createLinalgTransformInterpreterPass());
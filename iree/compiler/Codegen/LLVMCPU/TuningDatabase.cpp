@@ -0,0 +1,213 @@
+// Copyright 2022 The IREE Authors
+//
+// Licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+#include "iree/compiler/Codegen/LLVMCPU/TuningDatabase.h"
+
+#include <mutex>
+
+#include "iree/compiler/Codegen/Utils/Utils.h"
+#include "iree/compiler/Dialect/HAL/IR/HALOps.h"
+#include "llvm/ADT/StringMap.h"
+#include "llvm/Support/FileSystem.h"
+#include "llvm/Support/JSON.h"
+#include "llvm/Support/ManagedStatic.h"
+#include "llvm/Support/MemoryBuffer.h"
+#include "llvm/Support/raw_ostream.h"
+#include "mlir/Dialect/Linalg/IR/Linalg.h"
+#include "mlir/Parser/Parser.h"
+
+namespace mlir {
+namespace iree_compiler {
+
+namespace {
+
+// Map of tuning key to the textual compilation info attribute.
+using TuningEntries = llvm::StringMap<std::string>;
+
+// Process-wide cache of loaded databases keyed by path. Executables are
+// translated in parallel so all access goes through the mutex.
+struct TuningDatabaseCache {
+  std::mutex mutex;
+  llvm::StringMap<TuningEntries> databases;
+};
+
+}  // namespace
+
+static llvm::ManagedStatic<TuningDatabaseCache> databaseCache;
+static llvm::ManagedStatic<std::mutex> recordMutex;
+
+/// Returns the string named `name` in the target configuration of the variant
+/// containing `entryPointFn` or an empty string if not present.
+static StringRef getTargetConfigString(func::FuncOp entryPointFn,
+                                       StringRef name) {
+  auto variantOp =
+      entryPointFn->getParentOfType<IREE::HAL::ExecutableVariantOp>();
+  if (!variantOp) return "";
+  IREE::HAL::ExecutableTargetAttr targetAttr = variantOp.target();
+  if (!targetAttr) return "";
+  auto config = targetAttr.getConfiguration();
+  if (!config) return "";
+  auto attr = config.getAs<StringAttr>(name);
+  return attr ? attr.getValue() : "";
+}
+
+std::string getTuningKey(func::FuncOp entryPointFn, Operation *rootOp) {
+  std::string key;
+  llvm::raw_string_ostream os(key);
+  os << getTargetConfigString(entryPointFn, "target_triple") << "|"
+     << getTargetConfigString(entryPointFn, "cpu_features") << "|"
+     << rootOp->getName() << "(";
+  llvm::interleaveComma(rootOp->getOperandTypes(), os);
+  os << ")";
+  // Generic ops with the same operand types can compute entirely different
+  // things and dynamic operands can hide different static loop ranges so the
+  // iteration space is part of the key.
+  if (auto linalgOp = dyn_cast<linalg::LinalgOp>(rootOp)) {
+    os << "|maps[";
+    llvm::interleaveComma(linalgOp.getIndexingMaps(), os);
+    os << "]|iterators[";
+    llvm::interleaveComma(linalgOp.iterator_types(), os, [&](Attribute attr) {
+      os << attr.cast<StringAttr>().getValue();
+    });
+    os << "]|ranges[";
+    if (Optional<SmallVector<int64_t, 4>> ranges =
+            linalgOp.getStaticLoopRanges()) {
+      llvm::interleaveComma(*ranges, os, [&](int64_t range) {
+        if (ShapedType::isDynamic(range)) {
+          os << "?";
+        } else {
+          os << range;
+        }
+      });
+    }
+    os << "]";
+  }
+  return os.str();
+}
+
+/// Parses the database in `buffer` into `entries`.
+static LogicalResult parseTuningDatabase(StringRef buffer,
+                                         TuningEntries &entries,
+                                         std::string &error) {
+  llvm::Expected<llvm::json::Value> value = llvm::json::parse(buffer);
+  if (!value) {
+    error = llvm::toString(value.takeError());
+    return failure();
+  }
+  const llvm::json::Object *root = value->getAsObject();
+  if (!root) {
+    error = "expected a top-level object";
+    return failure();
+  }
+  Optional<int64_t> version = root->getInteger("version");
+  if (!version || *version != 1) {
+    error = "unsupported database version";
+    return failure();
+  }
+  const llvm::json::Array *entryArray = root->getArray("entries");
+  if (!entryArray) {
+    error = "expected an 'entries' array";
+    return failure();
+  }
+  for (const llvm::json::Value &entryValue : *entryArray) {
+    const llvm::json::Object *entry = entryValue.getAsObject();
+    Optional<StringRef> key = entry ? entry->getString("key") : llvm::None;
+    Optional<StringRef> compilationInfo =
+        entry ? entry->getString("compilation_info") : llvm::None;
+    if (!key || !compilationInfo) {
+      error = "entries must have 'key' and 'compilation_info' strings";
+      return failure();
+    }
+    entries[*key] = compilationInfo->str();
+  }
+  return success();
+}
+
+/// Returns the entries of the database at `path`, loading it if needed.
+static FailureOr<const TuningEntries *> getTuningDatabase(StringRef path,
+                                                          Operation *op) {
+  TuningDatabaseCache &cache = *databaseCache;
+  std::lock_guard<std::mutex> lock(cache.mutex);
+  auto it = cache.databases.find(path);
+  if (it != cache.databases.end()) return &it->second;
+
+  auto fileOrErr = llvm::MemoryBuffer::getFile(path);
+  if (std::error_code ec = fileOrErr.getError()) {
+    op->emitError("failed to open tuning database '")
+        << path << "': " << ec.message();
+    return failure();
+  }
+  TuningEntries entries;
+  std::string error;
+  if (failed(parseTuningDatabase((*fileOrErr)->getBuffer(), entries, error))) {
+    op->emitError("malformed tuning database '") << path << "': " << error;
+    return failure();
+  }
+  return &cache.databases.try_emplace(path, std::move(entries))
+              .first->second;
+}
+
+FailureOr<IREE::Codegen::CompilationInfoAttr> lookupTuningDatabase(
+    StringRef path, func::FuncOp entryPointFn, Operation *rootOp) {
+  FailureOr<const TuningEntries *> entries = getTuningDatabase(path, rootOp);
+  if (failed(entries)) return failure();
+  auto it = (*entries)->find(getTuningKey(entryPointFn, rootOp));
+  if (it == (*entries)->end()) return IREE::Codegen::CompilationInfoAttr();
+
+  auto compilationInfo =
+      parseAttribute(it->second, rootOp->getContext())
+          .dyn_cast_or_null<IREE::Codegen::CompilationInfoAttr>();
+  if (!compilationInfo) {
+    rootOp->emitError("invalid compilation info in tuning database: ")
+        << it->second;
+    return failure();
+  }
+  return compilationInfo;
+}
+
+LogicalResult appendTuningRecord(StringRef path, func::FuncOp entryPointFn,
+                                 Operation *rootOp) {
+  IREE::Codegen::LoweringConfigAttr loweringConfig = getLoweringConfig(rootOp);
+  IREE::Codegen::TranslationInfoAttr translationInfo =
+      getTranslationInfo(entryPointFn);
+  if (!loweringConfig || !translationInfo) return success();
+  auto compilationInfo = IREE::Codegen::CompilationInfoAttr::get(
+      rootOp->getContext(), loweringConfig, translationInfo,
+      getWorkgroupSize(getEntryPoint(entryPointFn)));
+
+  llvm::json::Object record;
+  record["key"] = getTuningKey(entryPointFn, rootOp);
+  record["op"] = rootOp->getName().getStringRef().str();
+  if (auto linalgOp = dyn_cast<linalg::LinalgOp>(rootOp)) {
+    llvm::json::Array loopRanges, iteratorTypes;
+    if (Optional<SmallVector<int64_t, 4>> ranges =
+            linalgOp.getStaticLoopRanges()) {
+      for (int64_t range : *ranges) loopRanges.push_back(range);
+    }
+    for (Attribute iteratorType : linalgOp.iterator_types()) {
+      iteratorTypes.push_back(iteratorType.cast<StringAttr>().getValue().str());
+    }
+    record["loop_ranges"] = std::move(loopRanges);
+    record["iterator_types"] = std::move(iteratorTypes);
+  }
+  std::string compilationInfoStr;
+  llvm::raw_string_ostream compilationInfoOs(compilationInfoStr);
+  compilationInfo.print(compilationInfoOs);
+  record["compilation_info"] = compilationInfoOs.str();
+
+  std::lock_guard<std::mutex> lock(*recordMutex);
+  std::error_code ec;
+  llvm::raw_fd_ostream os(path, ec, llvm::sys::fs::OF_Append);
+  if (ec) {
+    return rootOp->emitError("failed to open tuning record file '")
+           << path << "': " << ec.message();
+  }
+  os << llvm::json::Value(std::move(record)) << "\n";
+  return success();
+}
+
+}  // namespace iree_compiler
+}  // namespace mlir
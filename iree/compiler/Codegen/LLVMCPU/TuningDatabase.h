@@ -0,0 +1,60 @@
+// Copyright 2022 The IREE Authors
+//
+// Licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+#ifndef IREE_COMPILER_CODEGEN_LLVMCPU_TUNINGDATABASE_H_
+#define IREE_COMPILER_CODEGEN_LLVMCPU_TUNINGDATABASE_H_
+
+#include <string>
+
+#include "iree/compiler/Codegen/Dialect/LoweringConfig.h"
+#include "mlir/Dialect/Func/IR/FuncOps.h"
+
+namespace mlir {
+namespace iree_compiler {
+
+// Tuning databases pin the `#iree_codegen.compilation_info` used for
+// dispatches whose root operation matches a key. They are JSON files of the
+// form:
+//
+//   {
+//     "version": 1,
+//     "entries": [
+//       {
+//         "key": "<see getTuningKey>",
+//         "compilation_info": "#iree_codegen.compilation_info<...>"
+//       },
+//       ...
+//     ]
+//   }
+//
+// Additional fields on entries (such as measured times) are ignored.
+// Databases are produced by build_tools/benchmarks/tune_llvmcpu_dispatches.py
+// from the tuning records emitted by appendTuningRecord.
+
+/// Returns the key identifying the dispatch with root operation `rootOp` in
+/// tuning databases. It is composed of the target triple and CPU features of
+/// the executable variant followed by the name and operand types of `rootOp`
+/// and, for Linalg ops, its indexing maps, iterator types and static loop
+/// ranges.
+std::string getTuningKey(func::FuncOp entryPointFn, Operation *rootOp);
+
+/// Looks up the compilation info for `rootOp` in the tuning database at
+/// `path`. Returns a null attribute if the database has no entry for the
+/// dispatch and failure if the database or the entry are malformed.
+/// Databases are loaded once per process and cached.
+FailureOr<IREE::Codegen::CompilationInfoAttr> lookupTuningDatabase(
+    StringRef path, func::FuncOp entryPointFn, Operation *rootOp);
+
+/// Appends a JSON line describing the configuration chosen for `rootOp` to
+/// the file at `path`. Tuning tools use the record to enumerate candidate
+/// configurations around the default one.
+LogicalResult appendTuningRecord(StringRef path, func::FuncOp entryPointFn,
+                                 Operation *rootOp);
+
+}  // namespace iree_compiler
+}  // namespace mlir
+
+#endif  // IREE_COMPILER_CODEGEN_LLVMCPU_TUNINGDATABASE_H_
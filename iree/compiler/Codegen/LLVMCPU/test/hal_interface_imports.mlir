@@ -0,0 +1,42 @@
+// RUN: iree-opt -iree-convert-to-llvm %s | FileCheck %s
+
+#strided = affine_map<(d0, d1)[s0, s1, s2] -> (d0 * s1 + s0 + d1 * s2)>
+func.func private @some_import(memref<?x?xf32, #strided>, index) -> i1 attributes {hal.import}
+
+// CHECK-NOT: @some_import(
+// CHECK: llvm.mlir.global internal constant @__iree_import_ordinal_some_import(0 : i32) : i32
+// CHECK-LABEL: llvm.func internal @call_import
+func.func @call_import() {
+  // CHECK: %[[PARAMS_PTR:.+]] = llvm.alloca %{{.+}} x !llvm.struct<(ptr<f32>, i64, i64)>
+  %c0 = arith.constant 0 : index
+  %c4 = arith.constant 4 : index
+  %cst = arith.constant 0.0 : f32
+  %0 = hal.interface.binding.subspan set(0) binding(0) type(storage_buffer) offset(%c0) : memref<4x4xf32>
+  %1 = memref.cast %0 : memref<4x4xf32> to memref<?x?xf32, #strided>
+  // CHECK: %[[BASE_PTR:.+]] = llvm.getelementptr %{{.+}}[%{{.+}}] : (!llvm.ptr<f32>, i64) -> !llvm.ptr<f32>
+  // CHECK: %[[ORDINAL_PTR:.+]] = llvm.mlir.addressof @__iree_import_ordinal_some_import
+  // CHECK: %[[ORDINAL:.+]] = llvm.load %[[ORDINAL_PTR]] : !llvm.ptr<i32>
+  // CHECK: %[[IMPORT_PTR:.+]] = llvm.getelementptr %{{.+}}[%[[ORDINAL]]]
+  // CHECK: %[[IMPORT:.+]] = llvm.load %[[IMPORT_PTR]]
+  // CHECK: %[[NULL:.+]] = llvm.mlir.null
+  // CHECK: %[[AVAILABLE:.+]] = llvm.icmp "ne" %[[IMPORT]], %[[NULL]]
+  // CHECK: llvm.cond_br %[[AVAILABLE]], ^[[CALL:.+]], ^[[CONTINUE:.+]]
+  // CHECK: ^[[CALL]]:
+  // CHECK: %[[PARAMS_0:.+]] = llvm.insertvalue %[[BASE_PTR]], %{{.+}}[0]
+  // CHECK: %[[PARAMS_1:.+]] = llvm.insertvalue %{{.+}}, %[[PARAMS_0]][1]
+  // CHECK: %[[PARAMS:.+]] = llvm.insertvalue %{{.+}}, %[[PARAMS_1]][2]
+  // CHECK: llvm.store %[[PARAMS]], %[[PARAMS_PTR]]
+  // CHECK: %[[PARAMS_I8:.+]] = llvm.bitcast %[[PARAMS_PTR]] : !llvm.ptr<struct<(ptr<f32>, i64, i64)>> to !llvm.ptr<i8>
+  // CHECK: llvm.call %{{.+}}(%[[IMPORT]], %[[PARAMS_I8]])
+  // CHECK: llvm.br ^[[CONTINUE]]
+  // CHECK: ^[[CONTINUE]]:
+  // CHECK: llvm.cond_br %[[AVAILABLE]]
+  %called = call @some_import(%1, %c4) : (memref<?x?xf32, #strided>, index) -> i1
+  cf.cond_br %called, ^bb1, ^bb2
+^bb1:
+  return
+^bb2:
+  // Fallback when the import is not available.
+  memref.store %cst, %0[%c0, %c0] : memref<4x4xf32>
+  return
+}
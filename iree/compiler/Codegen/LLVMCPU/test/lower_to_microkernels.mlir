@@ -0,0 +1,65 @@
+// RUN: iree-opt -iree-llvmcpu-lower-to-microkernels -split-input-file %s | FileCheck %s
+
+//      CHECK: func.func private @iree_microkernel_mmt4d_f32f32f32(
+// CHECK-SAME:     memref<?x?x?x?xf32, #{{.+}}>, memref<?x?x?x?xf32, #{{.+}}>, memref<?x?x?x?xf32, #{{.+}}>,
+// CHECK-SAME:     index, index, index, index, index, index) -> i1
+// CHECK-SAME:     attributes {hal.import}
+// CHECK-LABEL: func.func @mmt4d_f32
+// CHECK-SAME:    %[[LHS:[a-zA-Z0-9]+]]: memref<4x16x8x1xf32>
+// CHECK-SAME:    %[[RHS:[a-zA-Z0-9]+]]: memref<2x16x8x1xf32>
+// CHECK-SAME:    %[[OUT:[a-zA-Z0-9]+]]: memref<4x2x8x8xf32>
+func.func @mmt4d_f32(%lhs: memref<4x16x8x1xf32>, %rhs: memref<2x16x8x1xf32>, %out: memref<4x2x8x8xf32>) {
+  //      CHECK: %[[LHS_CAST:.+]] = memref.cast %[[LHS]]
+  //      CHECK: %[[RHS_CAST:.+]] = memref.cast %[[RHS]]
+  //      CHECK: %[[OUT_CAST:.+]] = memref.cast %[[OUT]]
+  //      CHECK: %[[M:.+]] = memref.dim %[[LHS]], %{{.+}}
+  //      CHECK: %[[N:.+]] = memref.dim %[[RHS]], %{{.+}}
+  //      CHECK: %[[K:.+]] = memref.dim %[[LHS]], %{{.+}}
+  //      CHECK: %[[M0:.+]] = arith.constant 8 : index
+  //      CHECK: %[[N0:.+]] = arith.constant 8 : index
+  //      CHECK: %[[K0:.+]] = arith.constant 1 : index
+  //      CHECK: %[[CALLED:.+]] = call @iree_microkernel_mmt4d_f32f32f32(%[[LHS_CAST]], %[[RHS_CAST]], %[[OUT_CAST]], %[[M]], %[[N]], %[[K]], %[[M0]], %[[N0]], %[[K0]])
+  // The original op remains as the fallback when the import is unavailable.
+  //      CHECK: scf.if %[[CALLED]] {
+  // CHECK-NEXT: } else {
+  // CHECK-NEXT:   linalg.mmt4d ins(%[[LHS]], %[[RHS]] : memref<4x16x8x1xf32>, memref<2x16x8x1xf32>)
+  // CHECK-SAME:                outs(%[[OUT]] : memref<4x2x8x8xf32>)
+  // CHECK-NEXT: }
+  linalg.mmt4d ins(%lhs, %rhs : memref<4x16x8x1xf32>, memref<2x16x8x1xf32>)
+               outs(%out : memref<4x2x8x8xf32>)
+  return
+}
+
+// -----
+
+// Dynamic outer dimensions only need the outermost stride.
+
+// CHECK-LABEL: func.func @mmt4d_i8_dynamic
+func.func @mmt4d_i8_dynamic(%lhs: memref<?x?x8x4xi8>, %rhs: memref<?x?x8x4xi8>, %out: memref<?x?x8x8xi32>) {
+  // CHECK: %[[CALLED:.+]] = call @iree_microkernel_mmt4d_i8i8i32(
+  // CHECK: scf.if %[[CALLED]] {
+  // CHECK: } else {
+  // CHECK:   linalg.mmt4d
+  linalg.mmt4d ins(%lhs, %rhs : memref<?x?x8x4xi8>, memref<?x?x8x4xi8>)
+               outs(%out : memref<?x?x8x8xi32>)
+  return
+}
+
+// -----
+
+// Ops without a microkernel or with non-contiguous tiles are left untouched.
+
+#strided = affine_map<(d0, d1, d2, d3)[s0] -> (d0 * 1024 + s0 + d1 * 64 + d2 * 2 + d3)>
+// CHECK-LABEL: func.func @mmt4d_unsupported
+func.func @mmt4d_unsupported(%lhs: memref<4x16x8x1xf16>, %rhs: memref<2x16x8x1xf16>, %out: memref<4x2x8x8xf16>,
+                             %strided_lhs: memref<4x16x8x1xf32, #strided>, %rhs_f32: memref<2x16x8x1xf32>, %out_f32: memref<4x2x8x8xf32>) {
+  // CHECK-NOT: call
+  // CHECK: linalg.mmt4d
+  linalg.mmt4d ins(%lhs, %rhs : memref<4x16x8x1xf16>, memref<2x16x8x1xf16>)
+               outs(%out : memref<4x2x8x8xf16>)
+  // CHECK-NOT: call
+  // CHECK: linalg.mmt4d
+  linalg.mmt4d ins(%strided_lhs, %rhs_f32 : memref<4x16x8x1xf32, #strided>, memref<2x16x8x1xf32>)
+               outs(%out_f32 : memref<4x2x8x8xf32>)
+  return
+}
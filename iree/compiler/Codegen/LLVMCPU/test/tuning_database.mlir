@@ -0,0 +1,103 @@
+// RUN: iree-opt -pass-pipeline='hal.executable(hal.executable.variant(iree-llvmcpu-lower-executable-target{test-lowering-configuration=true}))' --iree-codegen-llvmcpu-tuning-database=%p/tuning_database.json -split-input-file %s | FileCheck %s
+// RUN: rm -f %t && iree-opt -pass-pipeline='hal.executable(hal.executable.variant(iree-llvmcpu-lower-executable-target{test-lowering-configuration=true}))' --iree-codegen-llvmcpu-tuning-records=%t -split-input-file %s && FileCheck %s --check-prefix=RECORD < %t
+
+#executable_layout = #hal.executable.layout<push_constants = 0, sets = [
+  #hal.descriptor_set.layout<0, bindings = [
+    #hal.descriptor_set.binding<0, storage_buffer>,
+    #hal.descriptor_set.binding<1, storage_buffer>,
+    #hal.descriptor_set.binding<2, storage_buffer>
+  ]>
+]>
+hal.executable private @tuned_matmul {
+  hal.executable.variant @system_elf_x86_64, target = <"llvm", "system-elf-x86_64", {
+    cpu_features = "+avx2",
+    data_layout = "e-m:e-p270:32:32-p271:32:32-p272:64:64-i64:64-f80:128-n8:16:32:64-S128",
+    native_vector_size = 32 : index,
+    target_triple = "x86_64-unknown-linux-gnu"
+  }> {
+    hal.executable.entry_point @tuned_matmul layout(#executable_layout)
+    builtin.module {
+      func.func @tuned_matmul() {
+        %cst = arith.constant 0.000000e+00 : f32
+        %lhs_binding = hal.interface.binding.subspan set(0) binding(0) type(storage_buffer)
+            : !flow.dispatch.tensor<readonly:128x256xf32>
+        %rhs_binding = hal.interface.binding.subspan set(0) binding(1) type(storage_buffer)
+            : !flow.dispatch.tensor<readonly:256x512xf32>
+        %result_binding = hal.interface.binding.subspan set(0) binding(2) type(storage_buffer)
+            : !flow.dispatch.tensor<writeonly:128x512xf32>
+        %lhs = flow.dispatch.tensor.load %lhs_binding, offsets = [0, 0], sizes = [128, 256], strides = [1, 1]
+            : !flow.dispatch.tensor<readonly:128x256xf32> -> tensor<128x256xf32>
+        %rhs = flow.dispatch.tensor.load %rhs_binding, offsets = [0, 0], sizes = [256, 512], strides = [1, 1]
+            : !flow.dispatch.tensor<readonly:256x512xf32> -> tensor<256x512xf32>
+        %init = linalg.init_tensor [128, 512] : tensor<128x512xf32>
+        %fill = linalg.fill ins(%cst : f32) outs(%init : tensor<128x512xf32>) -> tensor<128x512xf32>
+        %gemm = linalg.matmul
+            ins(%lhs, %rhs : tensor<128x256xf32>, tensor<256x512xf32>)
+            outs(%fill : tensor<128x512xf32>) -> tensor<128x512xf32>
+        flow.dispatch.tensor.store %gemm, %result_binding, offsets = [0, 0], sizes = [128, 512], strides = [1, 1]
+            : tensor<128x512xf32> -> !flow.dispatch.tensor<writeonly:128x512xf32>
+        return
+      }
+    }
+  }
+}
+//  CHECK-DAG: #[[CONFIG:.+]] = #iree_codegen.lowering_config<tile_sizes = {{\[}}[32, 128, 0], [8, 32, 0], [0, 0, 16]{{\]}}>
+//  CHECK-DAG: #[[TRANSLATION:.+]] = #iree_codegen.translation_info<CPUDoubleTilingExpert>
+//      CHECK: hal.executable.entry_point public @tuned_matmul
+// CHECK-SAME:     translation_info = #[[TRANSLATION]]
+//      CHECK: linalg.matmul
+// CHECK-SAME:     lowering_config = #[[CONFIG]]
+
+//      RECORD: "compilation_info":"#iree_codegen.compilation_info<lowering_config = <tile_sizes = {{.+}}>, translation_info = <CPUDoubleTilingExpert>{{.*}}>"
+// RECORD-SAME: "iterator_types":["parallel","parallel","reduction"]
+// RECORD-SAME: "key":"x86_64-unknown-linux-gnu|+avx2|linalg.matmul(tensor<128x256xf32>, tensor<256x512xf32>, tensor<128x512xf32>)|maps[(d0, d1, d2) -> (d0, d2), (d0, d1, d2) -> (d2, d1), (d0, d1, d2) -> (d0, d1)]|iterators[parallel, parallel, reduction]|ranges[128, 512, 256]"
+// RECORD-SAME: "loop_ranges":[128,512,256]
+// RECORD-SAME: "op":"linalg.matmul"
+
+// -----
+
+#executable_layout = #hal.executable.layout<push_constants = 0, sets = [
+  #hal.descriptor_set.layout<0, bindings = [
+    #hal.descriptor_set.binding<0, storage_buffer>,
+    #hal.descriptor_set.binding<1, storage_buffer>,
+    #hal.descriptor_set.binding<2, storage_buffer>
+  ]>
+]>
+hal.executable private @untuned_matmul {
+  hal.executable.variant @system_elf_x86_64, target = <"llvm", "system-elf-x86_64", {
+    cpu_features = "+avx2",
+    data_layout = "e-m:e-p270:32:32-p271:32:32-p272:64:64-i64:64-f80:128-n8:16:32:64-S128",
+    native_vector_size = 32 : index,
+    target_triple = "x86_64-unknown-linux-gnu"
+  }> {
+    hal.executable.entry_point @untuned_matmul layout(#executable_layout)
+    builtin.module {
+      func.func @untuned_matmul() {
+        %cst = arith.constant 0.000000e+00 : f32
+        %lhs_binding = hal.interface.binding.subspan set(0) binding(0) type(storage_buffer)
+            : !flow.dispatch.tensor<readonly:64x256xf32>
+        %rhs_binding = hal.interface.binding.subspan set(0) binding(1) type(storage_buffer)
+            : !flow.dispatch.tensor<readonly:256x512xf32>
+        %result_binding = hal.interface.binding.subspan set(0) binding(2) type(storage_buffer)
+            : !flow.dispatch.tensor<writeonly:64x512xf32>
+        %lhs = flow.dispatch.tensor.load %lhs_binding, offsets = [0, 0], sizes = [64, 256], strides = [1, 1]
+            : !flow.dispatch.tensor<readonly:64x256xf32> -> tensor<64x256xf32>
+        %rhs = flow.dispatch.tensor.load %rhs_binding, offsets = [0, 0], sizes = [256, 512], strides = [1, 1]
+            : !flow.dispatch.tensor<readonly:256x512xf32> -> tensor<256x512xf32>
+        %init = linalg.init_tensor [64, 512] : tensor<64x512xf32>
+        %fill = linalg.fill ins(%cst : f32) outs(%init : tensor<64x512xf32>) -> tensor<64x512xf32>
+        %gemm = linalg.matmul
+            ins(%lhs, %rhs : tensor<64x256xf32>, tensor<256x512xf32>)
+            outs(%fill : tensor<64x512xf32>) -> tensor<64x512xf32>
+        flow.dispatch.tensor.store %gemm, %result_binding, offsets = [0, 0], sizes = [64, 512], strides = [1, 1]
+            : tensor<64x512xf32> -> !flow.dispatch.tensor<writeonly:64x512xf32>
+        return
+      }
+    }
+  }
+}
+// Dispatches without an entry in the database keep the default heuristics.
+//  CHECK-NOT: tile_sizes = {{\[}}[32, 128, 0]
+//      CHECK: hal.executable.entry_point public @untuned_matmul
+
+// RECORD: "key":"x86_64-unknown-linux-gnu|+avx2|linalg.matmul(tensor<64x256xf32>, tensor<256x512xf32>, tensor<64x512xf32>)|maps[(d0, d1, d2) -> (d0, d2), (d0, d1, d2) -> (d2, d1), (d0, d1, d2) -> (d0, d1)]|iterators[parallel, parallel, reduction]|ranges[64, 512, 256]"
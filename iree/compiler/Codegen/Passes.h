@@ -200,6 +200,13 @@ createVerifyLinalgTransformLegalityPass();
 /// Performs the final conversion to LLVM dialect.
 std::unique_ptr<OperationPass<ModuleOp>> createConvertToLLVMPass();
 
+/// Prefix of the placeholder globals that the LLVM conversion loads executable
+/// import ordinals from. Ordinals are only known once executables have been
+/// linked and the serializer assigns the ordinal of the import named
+/// `<prefix><symbol>` as the initial value of the matching global.
+static constexpr llvm::StringLiteral kImportOrdinalGlobalPrefix =
+    "__iree_import_ordinal_";
+
 /// Checks CPU backend specific IR constraints (like no stack allocations)
 std::unique_ptr<OperationPass<ModuleOp>>
 createLLVMCPUCheckIRBeforeLLVMConversionPass();
@@ -210,6 +217,12 @@ createLLVMCPUCheckIRBeforeLLVMConversionPass();
 std::unique_ptr<OperationPass<IREE::HAL::ExecutableVariantOp>>
 createLLVMCPULowerExecutableTargetPass();
 
+/// Replaces linalg ops on buffers that have a runtime microkernel (such as
+/// linalg.mmt4d) with calls to the microkernel through the executable import
+/// table. See iree/hal/local/microkernels/microkernels.h for the runtime side.
+std::unique_ptr<OperationPass<ModuleOp>>
+createLLVMCPULowerToMicrokernelsPass();
+
 /// Synchronizes LLVM linkage with MLIR symbol visibility.
 std::unique_ptr<OperationPass<ModuleOp>>
 createLLVMCPUSynchronizeSymbolVisibilityPass();
@@ -246,6 +259,11 @@ void populateUnfusedFMAOpsPassPatterns(MLIRContext *context,
 /// to memrefs
 void addCPUDefaultPassPipeline(OpPassManager &passManager);
 
+/// Populates the passes to lower dispatches whose root op is implemented by a
+/// runtime microkernel. Workgroup tiles are bufferized and handed to the
+/// microkernel instead of being tiled further and vectorized.
+void addCPUMicrokernelsPassPipeline(OpPassManager &passManager);
+
 /// Populates the passes to lower linalg ops on buffers. Currenly this pipeline
 /// is only used for dispatches that just copy data from input interfaces to
 /// output interface.
@@ -4,13 +4,20 @@
 // See https://llvm.org/LICENSE.txt for license information.
 // SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
 
+#include <chrono>
+
 #include "iree/compiler/ConstEval/PassDetail.h"
 #include "iree/compiler/ConstEval/Passes.h"
 #include "iree/compiler/ConstEval/Runtime.h"
+#include "iree/compiler/Dialect/Util/Analysis/Constant/OpOracle.h"
+#include "iree/compiler/Dialect/Util/IR/UtilOps.h"
 #include "iree/compiler/Pipelines/Pipelines.h"
 #include "iree/compiler/Utils/PassUtils.h"
+#include "llvm/ADT/DenseMap.h"
 #include "llvm/ADT/DenseSet.h"
+#include "llvm/Support/CommandLine.h"
 #include "llvm/Support/Debug.h"
+#include "llvm/Support/Format.h"
 #include "llvm/Support/raw_ostream.h"
 #include "mlir/Dialect/Func/IR/FuncOps.h"
 #include "mlir/IR/BlockAndValueMapping.h"
@@ -25,6 +32,13 @@ namespace mlir {
 namespace iree_compiler {
 namespace ConstEval {
 
+static llvm::cl::opt<bool> clJitStatistics(
+    "iree-consteval-jit-statistics",
+    llvm::cl::desc("Emits a remark with the number and size of the globals "
+                   "evaluated at compile time (including pre-packed layout "
+                   "transforms) and the time spent evaluating them."),
+    llvm::cl::init(false));
+
 namespace {
 
 struct ProgramExtractor {
@@ -145,15 +159,28 @@ struct JitGlobalsPass : public JitGlobalsBase<JitGlobalsPass> {
   void runOnOperation() override {
     auto outerModule = getOperation();
     SymbolTable outerSymbolTable(outerModule);
+    Statistics statistics;
+    auto startTime = std::chrono::steady_clock::now();
+
+    // Only initializers that can be evaluated in isolation are imported; the
+    // rest (and the globals they store) are left to run at runtime.
+    DenseMap<StringAttr, bool> evaluatedGlobals;
+    SmallVector<IREE::Util::InitializerOp> initializerOps =
+        selectInitializers(outerModule, outerSymbolTable, evaluatedGlobals,
+                           statistics);
+    if (initializerOps.empty()) {
+      LLVM_DEBUG(dbgs() << "Not JIT'ing globals: no initializers to eval\n");
+      emitStatistics(outerModule, statistics);
+      return;
+    }
+
     OpBuilder builder = OpBuilder::atBlockEnd(outerModule.getBody());
     auto innerModule = builder.create<ModuleOp>(outerModule.getLoc());
     ProgramExtractor extractor(outerModule, innerModule);
-    SmallVector<Operation *> pruneOps;
 
     // Import initializers.
-    for (auto childOp : outerModule.getOps<IREE::Util::InitializerOp>()) {
-      extractor.importOperation(childOp);
-      pruneOps.push_back(childOp);
+    for (auto initializerOp : initializerOps) {
+      extractor.importOperation(initializerOp);
     }
 
     // Transitively import any dependencies.
@@ -161,23 +188,13 @@ struct JitGlobalsPass : public JitGlobalsBase<JitGlobalsPass> {
       signalPassFailure();
     }
 
-    // Find any globals that we pulled in which lack an initializer. These
-    // are the ones we will try to eval. Stash {func_symbol, global_symbol}
-    // pairs for later.
+    // Find the globals stored by the imported initializers. These are the
+    // ones we will eval. Stash {func_symbol, global_symbol} pairs for later.
     SmallVector<std::pair<StringAttr, StringAttr>> uninitializedGlobals;
     for (Operation &childOp : *innerModule.getBody()) {
       auto globalOp = llvm::dyn_cast<IREE::Util::GlobalOp>(childOp);
       if (!globalOp) continue;
-      if (globalOp.getInitialValueAttr()) continue;
-
-      // Only generate an accessor for types our runtime bridge knows how to
-      // handle.
-      Type type = globalOp.type();
-      if (!CompiledBinary::isSupportedResultType(type)) {
-        LLVM_DEBUG(dbgs() << "JitGlobals: unsupported global type " << type);
-        continue;
-      }
-
+      if (!evaluatedGlobals.count(globalOp.sym_nameAttr())) continue;
       StringAttr funcSymbol = extractor.createAccessor(globalOp);
       uninitializedGlobals.emplace_back(funcSymbol, globalOp.sym_nameAttr());
     }
@@ -187,6 +204,7 @@ struct JitGlobalsPass : public JitGlobalsBase<JitGlobalsPass> {
     if (uninitializedGlobals.empty()) {
       LLVM_DEBUG(dbgs() << "Not JIT'ing globals: no undefined globals found\n");
       innerModule.erase();
+      emitStatistics(outerModule, statistics);
       return;
     }
 
@@ -222,13 +240,26 @@ struct JitGlobalsPass : public JitGlobalsBase<JitGlobalsPass> {
 
       modified = true;
       targetGlobal.setInitialValue(value);
+
+      int64_t byteLength = getStorageByteLength(targetGlobal.type());
+      ++statistics.evaluatedGlobals;
+      statistics.evaluatedBytes += byteLength;
+      if (evaluatedGlobals.lookup(globalSymbol)) {
+        ++statistics.packedGlobals;
+        statistics.packedBytes += byteLength;
+      }
     }
 
-    // Delete any ops noted for pruning.
-    for (Operation *op : pruneOps) {
-      op->erase();
+    // Delete the initializers we evaluated.
+    for (auto initializerOp : initializerOps) {
+      initializerOp.erase();
     }
 
+    statistics.durationMs = std::chrono::duration<double, std::milli>(
+                                std::chrono::steady_clock::now() - startTime)
+                                .count();
+    emitStatistics(outerModule, statistics);
+
     // Signal any outer fixed point iterator that we have modified
     // globals and need another pass.
     if (modified) {
@@ -236,6 +267,119 @@ struct JitGlobalsPass : public JitGlobalsBase<JitGlobalsPass> {
     }
   }
 
+ private:
+  struct Statistics {
+    unsigned evaluatedGlobals = 0;
+    int64_t evaluatedBytes = 0;
+    // Globals holding constants rearranged by layout transforms (such as
+    // matmul weights packed into mmt4d tiles) that would otherwise be
+    // transformed at runtime.
+    unsigned packedGlobals = 0;
+    int64_t packedBytes = 0;
+    unsigned skippedInitializers = 0;
+    double durationMs = 0.0;
+  };
+
+  // Returns whether |initializerOp| can be evaluated in isolation: it may only
+  // store into uninitialized globals of types the runtime bridge can return
+  // and may not call functions as the extractor does not import them.
+  static bool isEvaluatableInitializer(IREE::Util::InitializerOp initializerOp,
+                                       SymbolTable &symbolTable) {
+    auto walkResult = initializerOp.walk([&](Operation *op) {
+      if (isa<CallOpInterface, IREE::Util::GlobalStoreIndirectOp>(op)) {
+        return WalkResult::interrupt();
+      }
+      auto storeOp = dyn_cast<IREE::Util::GlobalStoreOp>(op);
+      if (!storeOp) return WalkResult::advance();
+      auto globalOp =
+          symbolTable.lookup<IREE::Util::GlobalOp>(storeOp.global());
+      if (!globalOp || globalOp.getInitialValueAttr() ||
+          !CompiledBinary::isSupportedResultType(globalOp.type())) {
+        LLVM_DEBUG(dbgs() << "JitGlobals: cannot eval initializer storing "
+                          << storeOp.global() << "\n");
+        return WalkResult::interrupt();
+      }
+      return WalkResult::advance();
+    });
+    return !walkResult.wasInterrupted();
+  }
+
+  // Selects the initializers to evaluate and populates |evaluatedGlobals|
+  // with the globals they store, mapped to whether the stored value is a
+  // layout transform. Initializers loading globals stored by any skipped
+  // initializer are skipped as well as they depend on runtime state.
+  SmallVector<IREE::Util::InitializerOp> selectInitializers(
+      ModuleOp moduleOp, SymbolTable &symbolTable,
+      DenseMap<StringAttr, bool> &evaluatedGlobals, Statistics &statistics) {
+    SmallVector<IREE::Util::InitializerOp> candidateOps;
+    DenseSet<StringAttr> deferredGlobals;
+    auto deferInitializer = [&](IREE::Util::InitializerOp initializerOp) {
+      ++statistics.skippedInitializers;
+      initializerOp.walk([&](IREE::Util::GlobalStoreOp storeOp) {
+        deferredGlobals.insert(storeOp.globalAttr().getAttr());
+      });
+    };
+    for (auto initializerOp : moduleOp.getOps<IREE::Util::InitializerOp>()) {
+      if (isEvaluatableInitializer(initializerOp, symbolTable)) {
+        candidateOps.push_back(initializerOp);
+      } else {
+        deferInitializer(initializerOp);
+      }
+    }
+
+    // Iterate to a fixed point as deferring an initializer may defer others.
+    bool changed = true;
+    while (changed) {
+      changed = false;
+      for (auto *it = candidateOps.begin(); it != candidateOps.end();) {
+        auto walkResult = it->walk([&](IREE::Util::GlobalLoadOp loadOp) {
+          return deferredGlobals.contains(loadOp.globalAttr().getAttr())
+                     ? WalkResult::interrupt()
+                     : WalkResult::advance();
+        });
+        if (walkResult.wasInterrupted()) {
+          deferInitializer(*it);
+          it = candidateOps.erase(it);
+          changed = true;
+        } else {
+          ++it;
+        }
+      }
+    }
+
+    for (auto initializerOp : candidateOps) {
+      initializerOp.walk([&](IREE::Util::GlobalStoreOp storeOp) {
+        Operation *producerOp = storeOp.value().getDefiningOp();
+        evaluatedGlobals[storeOp.globalAttr().getAttr()] =
+            producerOp && IREE::Util::isConstExprLayoutTransform(producerOp);
+      });
+    }
+    return candidateOps;
+  }
+
+  // Returns the number of bytes used to store a value of |type| in rodata.
+  static int64_t getStorageByteLength(Type type) {
+    auto shapedType = type.dyn_cast<ShapedType>();
+    Type elementType = shapedType ? shapedType.getElementType() : type;
+    if (!elementType.isIntOrFloat()) return 0;
+    int64_t elementByteLength = (elementType.getIntOrFloatBitWidth() + 7) / 8;
+    if (!shapedType) return elementByteLength;
+    if (!shapedType.hasStaticShape()) return 0;
+    return shapedType.getNumElements() * elementByteLength;
+  }
+
+  static void emitStatistics(ModuleOp moduleOp, const Statistics &statistics) {
+    if (!clJitStatistics) return;
+    moduleOp.emitRemark()
+        << "evaluated " << statistics.evaluatedGlobals << " globals ("
+        << statistics.evaluatedBytes << " bytes) at compile time in "
+        << llvm::format("%.2f", statistics.durationMs) << "ms; "
+        << statistics.packedGlobals << " pre-packed layout transforms ("
+        << statistics.packedBytes << " bytes) no longer run at runtime; "
+        << statistics.skippedInitializers
+        << " initializers left to run at runtime";
+  }
+
   std::shared_ptr<CompileOptions> options;
   OpPassManager compilePipeline;
 };
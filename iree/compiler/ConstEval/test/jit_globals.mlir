@@ -222,3 +222,68 @@ module @eval_i64_tensor {
     util.initializer.return
   }
 }
+
+// -----
+// Initializers that cannot be evaluated are left to run at runtime along with
+// any initializers that depend on the globals they store.
+// CHECK-LABEL: @eval_skips_unsupported_initializers
+// CHECK: util.global private @deferred : tensor<2xf16>
+// CHECK: util.global private @dependent : tensor<2xf32>
+// CHECK: util.global private @evaluated = dense<[2, 3]> : tensor<2xi32>
+module @eval_skips_unsupported_initializers {
+  util.global private @deferred : tensor<2xf16>
+  util.global private @dependent : tensor<2xf32>
+  util.global private @evaluated : tensor<2xi32>
+  func.func @main() -> (tensor<2xf32>, tensor<2xi32>) {
+    %dependent = util.global.load @dependent : tensor<2xf32>
+    %evaluated = util.global.load @evaluated : tensor<2xi32>
+    return %dependent, %evaluated : tensor<2xf32>, tensor<2xi32>
+  }
+  // CHECK: util.initializer
+  // CHECK:   util.global.store %{{.+}}, @deferred
+  util.initializer {
+    %cst = arith.constant dense<[2.0e+2, 3.2e+3]> : tensor<2xf16>
+    util.global.store %cst, @deferred : tensor<2xf16>
+    util.initializer.return
+  }
+  // CHECK: util.initializer
+  // CHECK:   util.global.store %{{.+}}, @dependent
+  util.initializer {
+    %deferred = util.global.load @deferred : tensor<2xf16>
+    %0 = arith.extf %deferred : tensor<2xf16> to tensor<2xf32>
+    util.global.store %0, @dependent : tensor<2xf32>
+    util.initializer.return
+  }
+  // CHECK-NOT: util.initializer
+  util.initializer {
+    %cst = arith.constant dense<[2, 3]> : tensor<2xi32>
+    util.global.store %cst, @evaluated : tensor<2xi32>
+    util.initializer.return
+  }
+}
+
+// -----
+// Layout transforms of constants (here a transpose as used when packing matmul
+// weights) are stored pre-transformed.
+// CHECK-LABEL: @eval_layout_transform
+// CHECK: util.global private @{{.*}} = dense<{{\[}}[1, 3], [2, 4]]> : tensor<2x2xi32>
+#map0 = affine_map<(d0, d1) -> (d1, d0)>
+#map1 = affine_map<(d0, d1) -> (d0, d1)>
+module @eval_layout_transform {
+  util.global private @hoisted : tensor<2x2xi32>
+  func.func @main() -> tensor<2x2xi32> {
+    %hoisted = util.global.load @hoisted : tensor<2x2xi32>
+    return %hoisted : tensor<2x2xi32>
+  }
+  // CHECK-NOT: util.initializer
+  util.initializer {
+    %cst = arith.constant dense<[[1, 2], [3, 4]]> : tensor<2x2xi32>
+    %0 = linalg.init_tensor [2, 2] : tensor<2x2xi32>
+    %1 = linalg.generic {indexing_maps = [#map0, #map1], iterator_types = ["parallel", "parallel"]} ins(%cst : tensor<2x2xi32>) outs(%0 : tensor<2x2xi32>) {
+    ^bb0(%arg0: i32, %arg1: i32):
+      linalg.yield %arg0 : i32
+    } -> tensor<2x2xi32>
+    util.global.store %1, @hoisted : tensor<2x2xi32>
+    util.initializer.return
+  }
+}
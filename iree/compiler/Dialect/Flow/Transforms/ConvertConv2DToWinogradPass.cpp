@@ -0,0 +1,399 @@
+// Copyright 2022 The IREE Authors
+//
+// Licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+#include "iree/compiler/Dialect/Flow/Transforms/PassDetail.h"
+#include "iree/compiler/Dialect/Flow/Transforms/Passes.h"
+#include "mlir/Dialect/Arithmetic/IR/Arithmetic.h"
+#include "mlir/Dialect/Linalg/IR/Linalg.h"
+#include "mlir/Dialect/Tensor/IR/Tensor.h"
+#include "mlir/Dialect/Tensor/Utils/Utils.h"
+#include "mlir/Dialect/Utils/ReshapeOpsUtils.h"
+#include "mlir/IR/Builders.h"
+#include "mlir/IR/BuiltinAttributes.h"
+#include "mlir/IR/Matchers.h"
+#include "mlir/Pass/Pass.h"
+#include "mlir/Transforms/GreedyPatternRewriteDriver.h"
+
+namespace mlir {
+namespace iree_compiler {
+namespace IREE {
+namespace Flow {
+
+namespace {
+
+// clang-format off
+//
+// Winograd transform matrices for F(m x m, 3 x 3) from "Fast Algorithms for
+// Convolutional Neural Networks" (Lavin & Gray, 2015). With alpha = m + 2 the
+// output tile Y (m x m) of input tile d (alpha x alpha) and filter g (3 x 3)
+// is:
+//   Y = AT * [(G * g * GT) . (BT * d * B)] * A
+// where . is the elementwise product. Summed over input channels the
+// elementwise product becomes alpha * alpha independent matmuls.
+//
+// clang-format on
+
+// F(2x2, 3x3): alpha = 4.
+static const float kBT2x2[] = {
+    1.0f, 0.0f,  -1.0f, 0.0f,   //
+    0.0f, 1.0f,  1.0f,  0.0f,   //
+    0.0f, -1.0f, 1.0f,  0.0f,   //
+    0.0f, 1.0f,  0.0f,  -1.0f,  //
+};
+static const float kG2x2[] = {
+    1.0f, 0.0f,  0.0f,  //
+    0.5f, 0.5f,  0.5f,  //
+    0.5f, -0.5f, 0.5f,  //
+    0.0f, 0.0f,  1.0f,  //
+};
+static const float kAT2x2[] = {
+    1.0f, 1.0f, 1.0f,  0.0f,   //
+    0.0f, 1.0f, -1.0f, -1.0f,  //
+};
+
+// F(4x4, 3x3): alpha = 6.
+static const float kBT4x4[] = {
+    4.0f, 0.0f,  -5.0f, 0.0f,  1.0f, 0.0f,  //
+    0.0f, -4.0f, -4.0f, 1.0f,  1.0f, 0.0f,  //
+    0.0f, 4.0f,  -4.0f, -1.0f, 1.0f, 0.0f,  //
+    0.0f, -2.0f, -1.0f, 2.0f,  1.0f, 0.0f,  //
+    0.0f, 2.0f,  -1.0f, -2.0f, 1.0f, 0.0f,  //
+    0.0f, 4.0f,  0.0f,  -5.0f, 0.0f, 1.0f,  //
+};
+static const float kG4x4[] = {
+    1.0f / 4.0f,   0.0f,          0.0f,          //
+    -1.0f / 6.0f,  -1.0f / 6.0f,  -1.0f / 6.0f,  //
+    -1.0f / 6.0f,  1.0f / 6.0f,   -1.0f / 6.0f,  //
+    1.0f / 24.0f,  1.0f / 12.0f,  1.0f / 6.0f,   //
+    1.0f / 24.0f,  -1.0f / 12.0f, 1.0f / 6.0f,   //
+    0.0f,          0.0f,          1.0f,          //
+};
+static const float kAT4x4[] = {
+    1.0f, 1.0f, 1.0f,  1.0f, 1.0f,  0.0f,  //
+    0.0f, 1.0f, -1.0f, 2.0f, -2.0f, 0.0f,  //
+    0.0f, 1.0f, 1.0f,  4.0f, 4.0f,  0.0f,  //
+    0.0f, 1.0f, -1.0f, 8.0f, -8.0f, 1.0f,  //
+};
+
+// Returns an f32 constant tensor of |rows| x |cols| with the given |values|.
+static Value createConstantMatrix(OpBuilder &builder, Location loc,
+                                  ArrayRef<float> values, int64_t rows,
+                                  int64_t cols) {
+  auto type = RankedTensorType::get({rows, cols}, builder.getF32Type());
+  return builder.create<arith::ConstantOp>(
+      loc, DenseElementsAttr::get(type, values));
+}
+
+// Returns a zero-filled tensor of the given |type|.
+static Value createZeroTensor(OpBuilder &builder, Location loc,
+                              RankedTensorType type) {
+  Value init = builder.create<linalg::InitTensorOp>(loc, type.getShape(),
+                                                    type.getElementType());
+  Value zero = builder.create<arith::ConstantOp>(
+      loc, builder.getZeroAttr(type.getElementType()));
+  return builder.create<linalg::FillOp>(loc, zero, init).getResult(0);
+}
+
+// Creates the one-sided contraction
+//   result = sum(matrix * data)
+// reducing over the innermost loop. The indexing maps are given in
+// (matrix, data, result) order. Two-sided transforms are split into two of
+// these so each dispatch performs a plain contraction over a single dimension
+// instead of an alpha x alpha reduction per output element.
+static Value createContraction(OpBuilder &builder, Location loc, Value matrix,
+                               Value data, RankedTensorType resultType,
+                               ArrayRef<AffineMap> indexingMaps) {
+  SmallVector<StringRef> iteratorTypes(indexingMaps.back().getNumDims() - 1,
+                                       getParallelIteratorTypeName());
+  iteratorTypes.push_back(getReductionIteratorTypeName());
+  auto genericOp = builder.create<linalg::GenericOp>(
+      loc, resultType, ValueRange{matrix, data},
+      ValueRange{createZeroTensor(builder, loc, resultType)}, indexingMaps,
+      iteratorTypes,
+      [](OpBuilder &nestedBuilder, Location nestedLoc, ValueRange args) {
+        Value product =
+            nestedBuilder.create<arith::MulFOp>(nestedLoc, args[0], args[1]);
+        Value sum =
+            nestedBuilder.create<arith::AddFOp>(nestedLoc, args[2], product);
+        nestedBuilder.create<linalg::YieldOp>(nestedLoc, sum);
+      });
+  return genericOp.getResult(0);
+}
+
+// Returns true if |value| is known to be all zeros.
+static bool isZeroFilled(Value value) {
+  auto fillOp = value.getDefiningOp<linalg::FillOp>();
+  return fillOp && matchPattern(fillOp.value(), m_AnyZeroFloat());
+}
+
+// Converts 3x3 stride-1 linalg.conv_2d_nhwc_hwcf ops into the Winograd form:
+//   U = filter transform  [alpha, alpha, C, F]        (constant-foldable)
+//   V = input transform   [alpha, alpha, N, tH, tW, C]
+//   M = batch_matmul(V, U) over alpha * alpha batches
+//   Y = output transform  [N, tH, m, tW, m, F]
+// The filter transform only depends on the filter so when the filter is a
+// constant it is hoisted and evaluated at compile time by const-eval.
+class Conv2DWinogradConversion
+    : public OpRewritePattern<linalg::Conv2DNhwcHwcfOp> {
+ public:
+  Conv2DWinogradConversion(MLIRContext *context, int64_t outputTileSize)
+      : OpRewritePattern<linalg::Conv2DNhwcHwcfOp>(context),
+        outputTileSize(outputTileSize) {}
+
+  LogicalResult matchAndRewrite(linalg::Conv2DNhwcHwcfOp convOp,
+                                PatternRewriter &rewriter) const override {
+    Value input = convOp.getInputOperand(0)->get();
+    Value filter = convOp.getInputOperand(1)->get();
+    Value output = convOp.getOutputOperand(0)->get();
+    auto inputType = input.getType().dyn_cast<RankedTensorType>();
+    auto filterType = filter.getType().dyn_cast<RankedTensorType>();
+    auto outputType = output.getType().dyn_cast<RankedTensorType>();
+    if (!inputType || !filterType || !outputType) return failure();
+    if (!inputType.hasStaticShape() || !filterType.hasStaticShape() ||
+        !outputType.hasStaticShape()) {
+      return failure();
+    }
+
+    // The F(4x4, 3x3) transform constants are not exact in narrower types.
+    auto f32Type = rewriter.getF32Type();
+    if (inputType.getElementType() != f32Type ||
+        filterType.getElementType() != f32Type ||
+        outputType.getElementType() != f32Type) {
+      return failure();
+    }
+
+    auto filterShape = filterType.getShape();
+    if (filterShape[0] != 3 || filterShape[1] != 3) return failure();
+
+    // The tiling below pads the input up to the window read by the output
+    // tiles and can't handle inputs that extend past it.
+    auto inputShape = inputType.getShape();
+    auto outputShape = outputType.getShape();
+    if (outputShape[1] != inputShape[1] - 2 ||
+        outputShape[2] != inputShape[2] - 2) {
+      return failure();
+    }
+
+    auto isOne = [](APInt element) { return element.getSExtValue() == 1; };
+    if (!llvm::all_of(convOp.strides(), isOne) ||
+        !llvm::all_of(convOp.dilations(), isOne)) {
+      return failure();
+    }
+
+    const int64_t m = outputTileSize;
+    const int64_t alpha = m + 2;
+    ArrayRef<float> bt, g, at;
+    if (m == 2) {
+      bt = kBT2x2;
+      g = kG2x2;
+      at = kAT2x2;
+    } else if (m == 4) {
+      bt = kBT4x4;
+      g = kG4x4;
+      at = kAT4x4;
+    } else {
+      return failure();
+    }
+
+    auto loc = convOp.getLoc();
+    const int64_t n = inputShape[0];
+    const int64_t c = inputShape[3];
+    const int64_t f = filterShape[3];
+    const int64_t tileCountH = llvm::divideCeil(outputShape[1], m);
+    const int64_t tileCountW = llvm::divideCeil(outputShape[2], m);
+    const int64_t tileCount = n * tileCountH * tileCountW;
+
+    // Pad the input so that every tile reads a full alpha x alpha window.
+    const int64_t paddedH = tileCountH * m + 2;
+    const int64_t paddedW = tileCountW * m + 2;
+    if (paddedH != inputShape[1] || paddedW != inputShape[2]) {
+      auto paddedType =
+          RankedTensorType::get({n, paddedH, paddedW, c}, f32Type);
+      Value padValue = rewriter.create<arith::ConstantOp>(
+          loc, f32Type, rewriter.getZeroAttr(f32Type));
+      SmallVector<OpFoldResult> lowPadding(4, rewriter.getIndexAttr(0));
+      SmallVector<OpFoldResult> highPadding = {
+          rewriter.getIndexAttr(0),
+          rewriter.getIndexAttr(paddedH - inputShape[1]),
+          rewriter.getIndexAttr(paddedW - inputShape[2]),
+          rewriter.getIndexAttr(0)};
+      input = tensor::createPadScalarOp(paddedType, input, padValue,
+                                        lowPadding, highPadding,
+                                        /*nofold=*/false, loc, rewriter);
+    }
+
+    Value btMatrix = createConstantMatrix(rewriter, loc, bt, alpha, alpha);
+    Value gMatrix = createConstantMatrix(rewriter, loc, g, alpha, 3);
+    Value atMatrix = createConstantMatrix(rewriter, loc, at, m, alpha);
+    auto d = [&](unsigned i) { return rewriter.getAffineDimExpr(i); };
+    auto map = [&](unsigned numDims, ArrayRef<AffineExpr> exprs) {
+      return AffineMap::get(numDims, 0, exprs, rewriter.getContext());
+    };
+
+    // Filter transform:
+    //   U[a, b, c, f] = sum_{i, j} G[a, i] * g[i, j, c, f] * G[b, j]
+    // as
+    //   T[a, j, c, f] = sum_i G[a, i] * g[i, j, c, f]
+    //   U[a, b, c, f] = sum_j G[b, j] * T[a, j, c, f]
+    auto filterHalfType = RankedTensorType::get({alpha, 3, c, f}, f32Type);
+    Value filterHalf = createContraction(
+        rewriter, loc, gMatrix, filter, filterHalfType,
+        {map(5, {d(0), d(4)}), map(5, {d(4), d(1), d(2), d(3)}),
+         map(5, {d(0), d(1), d(2), d(3)})});
+    auto filterTransformType =
+        RankedTensorType::get({alpha, alpha, c, f}, f32Type);
+    Value filterTransform = createContraction(
+        rewriter, loc, gMatrix, filterHalf, filterTransformType,
+        {map(5, {d(1), d(4)}), map(5, {d(0), d(4), d(2), d(3)}),
+         map(5, {d(0), d(1), d(2), d(3)})});
+
+    // Input transform:
+    //   V[a, b, n, th, tw, c] =
+    //       sum_{i, j} BT[a, i] * d[n, th * m + i, tw * m + j, c] * BT[b, j]
+    // as
+    //   T[a, n, th, tw, j, c] =
+    //       sum_i BT[a, i] * d[n, th * m + i, tw * m + j, c]
+    //   V[a, b, n, th, tw, c] = sum_j BT[b, j] * T[a, n, th, tw, j, c]
+    auto inputHalfType = RankedTensorType::get(
+        {alpha, n, tileCountH, tileCountW, alpha, c}, f32Type);
+    Value inputHalf = createContraction(
+        rewriter, loc, btMatrix, input, inputHalfType,
+        {map(7, {d(0), d(6)}),
+         map(7, {d(1), d(2) * m + d(6), d(3) * m + d(4), d(5)}),
+         map(7, {d(0), d(1), d(2), d(3), d(4), d(5)})});
+    auto inputTransformType = RankedTensorType::get(
+        {alpha, alpha, n, tileCountH, tileCountW, c}, f32Type);
+    Value inputTransform = createContraction(
+        rewriter, loc, btMatrix, inputHalf, inputTransformType,
+        {map(7, {d(1), d(6)}), map(7, {d(0), d(2), d(3), d(4), d(6), d(5)}),
+         map(7, {d(0), d(1), d(2), d(3), d(4), d(5)})});
+
+    // Elementwise product summed over channels: one matmul per (a, b).
+    auto batchInputType =
+        RankedTensorType::get({alpha * alpha, tileCount, c}, f32Type);
+    Value batchInput = rewriter.create<tensor::CollapseShapeOp>(
+        loc, batchInputType, inputTransform,
+        ArrayRef<ReassociationIndices>{{0, 1}, {2, 3, 4}, {5}});
+    auto batchFilterType =
+        RankedTensorType::get({alpha * alpha, c, f}, f32Type);
+    Value batchFilter = rewriter.create<tensor::CollapseShapeOp>(
+        loc, batchFilterType, filterTransform,
+        ArrayRef<ReassociationIndices>{{0, 1}, {2}, {3}});
+    auto batchResultType =
+        RankedTensorType::get({alpha * alpha, tileCount, f}, f32Type);
+    Value batchResult =
+        rewriter
+            .create<linalg::BatchMatmulOp>(
+                loc, TypeRange{batchResultType},
+                ValueRange{batchInput, batchFilter},
+                ValueRange{createZeroTensor(rewriter, loc, batchResultType)})
+            .getResult(0);
+    auto productType = RankedTensorType::get(
+        {alpha, alpha, n, tileCountH, tileCountW, f}, f32Type);
+    Value product = rewriter.create<tensor::ExpandShapeOp>(
+        loc, productType, batchResult,
+        ArrayRef<ReassociationIndices>{{0, 1}, {2, 3, 4}, {5}});
+
+    // Output transform:
+    //   Y[n, th, x, tw, y, f] =
+    //       sum_{a, b} AT[x, a] * M[a, b, n, th, tw, f] * AT[y, b]
+    // as
+    //   T[x, b, n, th, tw, f] = sum_a AT[x, a] * M[a, b, n, th, tw, f]
+    //   Y[n, th, x, tw, y, f] = sum_b AT[y, b] * T[x, b, n, th, tw, f]
+    auto outputHalfType = RankedTensorType::get(
+        {m, alpha, n, tileCountH, tileCountW, f}, f32Type);
+    Value outputHalf = createContraction(
+        rewriter, loc, atMatrix, product, outputHalfType,
+        {map(7, {d(0), d(6)}), map(7, {d(6), d(1), d(2), d(3), d(4), d(5)}),
+         map(7, {d(0), d(1), d(2), d(3), d(4), d(5)})});
+    auto outputTilesType = RankedTensorType::get(
+        {n, tileCountH, m, tileCountW, m, f}, f32Type);
+    Value outputTiles = createContraction(
+        rewriter, loc, atMatrix, outputHalf, outputTilesType,
+        {map(7, {d(4), d(6)}), map(7, {d(2), d(6), d(0), d(1), d(3), d(5)}),
+         map(7, {d(0), d(1), d(2), d(3), d(4), d(5)})});
+    auto paddedOutputType = RankedTensorType::get(
+        {n, tileCountH * m, tileCountW * m, f}, f32Type);
+    Value result = rewriter.create<tensor::CollapseShapeOp>(
+        loc, paddedOutputType, outputTiles,
+        ArrayRef<ReassociationIndices>{{0}, {1, 2}, {3, 4}, {5}});
+    if (paddedOutputType != outputType) {
+      SmallVector<OpFoldResult> offsets(4, rewriter.getIndexAttr(0));
+      SmallVector<OpFoldResult> strides(4, rewriter.getIndexAttr(1));
+      SmallVector<OpFoldResult> sizes;
+      for (int64_t size : outputShape) {
+        sizes.push_back(rewriter.getIndexAttr(size));
+      }
+      result = rewriter.create<tensor::ExtractSliceOp>(
+          loc, outputType, result, offsets, sizes, strides);
+    }
+
+    // Convolutions accumulate into their output; most are zero-filled and
+    // don't need the extra add.
+    if (!isZeroFilled(output)) {
+      auto identityMap =
+          AffineMap::getMultiDimIdentityMap(4, rewriter.getContext());
+      result = rewriter
+                   .create<linalg::GenericOp>(
+                       loc, outputType, ValueRange{result}, ValueRange{output},
+                       ArrayRef<AffineMap>{identityMap, identityMap},
+                       SmallVector<StringRef>(4, getParallelIteratorTypeName()),
+                       [](OpBuilder &nestedBuilder, Location nestedLoc,
+                          ValueRange args) {
+                         Value sum = nestedBuilder.create<arith::AddFOp>(
+                             nestedLoc, args[0], args[1]);
+                         nestedBuilder.create<linalg::YieldOp>(nestedLoc, sum);
+                       })
+                   .getResult(0);
+    }
+
+    rewriter.replaceOp(convOp, result);
+    return success();
+  }
+
+ private:
+  int64_t outputTileSize;
+};
+
+struct ConvertConv2DToWinogradPass
+    : ConvertConv2DToWinogradBase<ConvertConv2DToWinogradPass> {
+  ConvertConv2DToWinogradPass() = default;
+  ConvertConv2DToWinogradPass(int64_t outputTileSize) {
+    this->outputTileSize = outputTileSize;
+  }
+
+  void getDependentDialects(DialectRegistry &registry) const override {
+    registry.insert<arith::ArithmeticDialect, linalg::LinalgDialect,
+                    tensor::TensorDialect>();
+  }
+  void runOnOperation() override {
+    if (outputTileSize != 2 && outputTileSize != 4) {
+      getOperation()->emitError()
+          << "unsupported Winograd output tile size " << outputTileSize
+          << "; expected 2 or 4";
+      return signalPassFailure();
+    }
+    MLIRContext *context = &getContext();
+    RewritePatternSet patterns(&getContext());
+    patterns.insert<Conv2DWinogradConversion>(context, outputTileSize);
+    if (failed(applyPatternsAndFoldGreedily(getOperation(),
+                                            std::move(patterns)))) {
+      return signalPassFailure();
+    }
+  }
+};
+
+}  // namespace
+
+std::unique_ptr<Pass> createConvertConv2DToWinogradPass(
+    int64_t outputTileSize) {
+  return std::make_unique<ConvertConv2DToWinogradPass>(outputTileSize);
+}
+
+}  // namespace Flow
+}  // namespace IREE
+}  // namespace iree_compiler
+}  // namespace mlir
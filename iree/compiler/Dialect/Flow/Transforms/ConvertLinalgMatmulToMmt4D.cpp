@@ -364,6 +364,18 @@ LinalgMatmulOpToLinalgMmt4DOpPattern::chooseTileParams(Value lhs, Value rhs,
                                   "f32*f32->f32, aarch64");
     }
   }
+  if (targetInfo.is(CustomKernelTargetArch::X86_64)) {
+    if (lhsElemType.isSignlessInteger(8) && rhsElemType.isSignlessInteger(8) &&
+        accElemType.isSignlessInteger(32) &&
+        targetInfo.has(CustomKernelTargetFeature::X86_64Avx512Vnni)) {
+      // There is no custom VNNI kernel yet: vpdpbusd multiplies unsigned by
+      // signed bytes and these operands are both signed. The tiles are sized
+      // for the generic vectorized mmt4d lowering, N0 = 16 filling a 512-bit
+      // i32 accumulator register.
+      return chooseMatMulOrMatVec({8, 4, 16}, {8, 4, 1},
+                                  "i8*i8->i32, x86_64 +avx512vnni");
+    }
+  }
   // enableGenericSlow is meant for tests only. It's just a way to get some
   // test coverage for Mmt4d where we do not currently have kernels.
   if (enableGenericSlow) {
@@ -58,6 +58,17 @@ static llvm::cl::opt<bool> clEnableConvToImg2Col(
     llvm::cl::desc("Enable converting convolution ops to img2col form."),
     llvm::cl::init(false));
 
+static llvm::cl::opt<bool> clEnableConvToWinograd(
+    "iree-flow-enable-conv-winograd-transform",
+    llvm::cl::desc("Enable converting 3x3 convolution ops to Winograd form."),
+    llvm::cl::init(false));
+
+static llvm::cl::opt<int> clConvWinogradOutputTileSize(
+    "iree-flow-conv-winograd-output-tile-size",
+    llvm::cl::desc("Output tile size of the Winograd F(m x m, 3 x 3) "
+                   "transform; either 2 or 4."),
+    llvm::cl::init(4));
+
 static llvm::cl::opt<bool> clEnablePaddingLinalgOps(
     "iree-flow-enable-padding-linalg-ops",
     llvm::cl::desc("Enable padding linalg ops to an integer multiple of "
@@ -116,6 +127,12 @@ void buildGlobalOptimizationPassPipeline(
 
   if (transformOptions.constExprHoisting) {
     pipeline.addPass(IREE::Util::createHoistIntoGlobalsPass());
+  } else if (!clMmt4dTargetOptions.empty()) {
+    // Even without general hoisting the packing of constant matmul operands
+    // into mmt4d layouts is hoisted so that it happens once (or at compile
+    // time with const-eval) instead of on every invocation.
+    pipeline.addPass(IREE::Util::createHoistIntoGlobalsPass(
+        /*layoutTransformsOnly=*/true));
   }
 
   if (transformOptions.buildConstEvalPassPipeline) {
@@ -162,7 +179,16 @@ void buildFlowTransformPassPipeline(OpPassManager &passManager,
 
   // Special case peephole optimizations.
   FunctionLikeNest(passManager)
+      // Quantize before the convolution rewrites and mmt4d so that they see
+      // the i8*i8->i32 ops.
+      .addPredicatedPass(transformOptions.int8Quantization,
+                         IREE::Flow::createQuantizeNumericsPass)
       .addPass(IREE::Flow::createConvertConv2D1x1ToMatmulPass)
+      .addPredicatedPass(clEnableConvToWinograd,
+                         []() {
+                           return IREE::Flow::createConvertConv2DToWinogradPass(
+                               clConvWinogradOutputTileSize);
+                         })
       .addPredicatedPass(clEnableConvToImg2Col,
                          IREE::Flow::createConvertConv2DToImg2ColPass)
       // Input should now be legal.
@@ -34,6 +34,10 @@ struct TransformOptions : public PassPipelineOptions<TransformOptions> {
   // Enables passes to perform numeric precision reduction.
   bool numericPrecisionReduction = false;
 
+  // Enables quantization of f32 matmuls and convolutions with constant weights
+  // to int8 ops accumulating in int32.
+  bool int8Quantization = false;
+
   // Hook to populate a constant evaluation pass pipeline. If nullptr, then
   // no passes are added for constant evaluation. This must be injected in
   // because constant-evaluators can depend on the whole compiler, of which
@@ -79,6 +83,11 @@ std::unique_ptr<Pass> createConvertConv2D1x1ToMatmulPass();
 // using im2col tranformation.
 std::unique_ptr<Pass> createConvertConv2DToImg2ColPass();
 
+// Creates a pass to convert 3x3 stride-1 linalg convolution ops into Winograd
+// F(m x m, 3 x 3) input/filter/output transforms around a batch matmul.
+std::unique_ptr<Pass> createConvertConv2DToWinogradPass(
+    int64_t outputTileSize = 4);
+
 // Pass to convert a linalg.pad_tensor operation into a linalg.fill +
 // subtensor_insert. This allows lowering the operation into a single kernel.
 std::unique_ptr<Pass> createPadTensorToSubTensorInsertPass();
@@ -114,6 +123,10 @@ std::unique_ptr<Pass> createConvertToFlowPass();
 // iree-flow-infer-numeric-narrowing.
 std::unique_ptr<Pass> createOptimizeNumericsPass();
 
+// Quantizes f32 matmul and convolution ops with constant weights to
+// i8*i8->i32 ops using per-tensor activation and per-channel weight scales.
+std::unique_ptr<Pass> createQuantizeNumericsPass();
+
 // Strips the signed/unsigned portion off of tensors.
 std::unique_ptr<InterfacePass<mlir::FunctionOpInterface>>
 createStripSignednessPass();
@@ -0,0 +1,365 @@
+// Copyright 2022 The IREE Authors
+//
+// Licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+#include <cfloat>
+#include <cmath>
+
+#include "iree/compiler/Dialect/Flow/Transforms/PassDetail.h"
+#include "iree/compiler/Dialect/Flow/Transforms/Passes.h"
+#include "iree/compiler/Dialect/Util/Analysis/Attributes/Range.h"
+#include "iree/compiler/Dialect/Util/Analysis/DFX/Solver.h"
+#include "iree/compiler/Dialect/Util/Analysis/DFX/State.h"
+#include "iree/compiler/Dialect/Util/Analysis/Explorer.h"
+#include "llvm/ADT/DenseMap.h"
+#include "llvm/Support/Debug.h"
+#include "mlir/Dialect/Arithmetic/IR/Arithmetic.h"
+#include "mlir/Dialect/Linalg/IR/Linalg.h"
+#include "mlir/Dialect/Tensor/IR/Tensor.h"
+#include "mlir/IR/Builders.h"
+#include "mlir/IR/BuiltinAttributes.h"
+#include "mlir/IR/Matchers.h"
+
+#define DEBUG_TYPE "iree-flow-quantize-numerics"
+
+namespace mlir {
+namespace iree_compiler {
+namespace IREE {
+namespace Flow {
+
+namespace {
+
+// Quantized values use the symmetric range [-127, 127]: dropping -128 keeps a
+// single scale valid for both signs and keeps i8*i8 products small enough for
+// the pairwise i16 intermediates used by some dot-product instructions.
+static constexpr int64_t kQuantizedMax = 127;
+
+// Scale model used for the quantized ops:
+//   activations: per-tensor symmetric, s_a = max|a| / 127. max|a| is taken
+//                from the inferred float range when it is finite and is
+//                otherwise computed at runtime with a max-abs reduction.
+//   weights:     per-output-channel symmetric, s_w[c] = max|w[..., c]| / 127,
+//                quantized at compile time. Weights must be constants.
+// The integer op accumulates in i32 and the result is dequantized with
+//   y[..., c] = init[..., c] + float(acc[..., c]) * s_a * s_w[c]
+struct QuantizedWeights {
+  DenseElementsAttr values;
+  SmallVector<float> scales;
+};
+
+// Quantizes |weights| with one scale per element of the innermost (output
+// channel) dimension.
+static QuantizedWeights quantizeWeights(DenseFPElementsAttr weights) {
+  auto weightsType = weights.getType().cast<RankedTensorType>();
+  int64_t channelCount = weightsType.getShape().back();
+
+  SmallVector<float> maxAbs(channelCount, 0.0f);
+  int64_t index = 0;
+  for (APFloat value : weights.getValues<APFloat>()) {
+    float &channelMax = maxAbs[index++ % channelCount];
+    channelMax = std::max(channelMax, std::fabs(value.convertToFloat()));
+  }
+
+  QuantizedWeights result;
+  for (float channelMax : maxAbs) {
+    result.scales.push_back(channelMax > 0.0f ? channelMax / kQuantizedMax
+                                              : 1.0f);
+  }
+  SmallVector<int8_t> quantizedValues;
+  quantizedValues.reserve(weightsType.getNumElements());
+  index = 0;
+  for (APFloat value : weights.getValues<APFloat>()) {
+    float scaled =
+        value.convertToFloat() / result.scales[index++ % channelCount];
+    float clamped = std::min(std::max(scaled, -float(kQuantizedMax)),
+                             float(kQuantizedMax));
+    quantizedValues.push_back(static_cast<int8_t>(std::round(clamped)));
+  }
+  auto quantizedType = RankedTensorType::get(
+      weightsType.getShape(), IntegerType::get(weights.getContext(), 8));
+  result.values = DenseElementsAttr::get(quantizedType,
+                                         llvm::makeArrayRef(quantizedValues));
+  return result;
+}
+
+// Returns an init tensor with the shape of |like| and the given element type.
+static Value createInitTensorLike(OpBuilder &builder, Location loc, Value like,
+                                  Type elementType) {
+  auto likeType = like.getType().cast<RankedTensorType>();
+  SmallVector<Value> dynamicSizes;
+  for (auto dim : llvm::enumerate(likeType.getShape())) {
+    if (ShapedType::isDynamic(dim.value())) {
+      dynamicSizes.push_back(
+          builder.create<tensor::DimOp>(loc, like, dim.index()));
+    }
+  }
+  return builder.create<linalg::InitTensorOp>(loc, dynamicSizes,
+                                              likeType.getShape(), elementType);
+}
+
+// Returns a 0-d tensor holding the per-tensor activation scale derived from
+// the maximum absolute value of |activations|.
+static Value computeDynamicScale(OpBuilder &builder, Location loc,
+                                 Value activations) {
+  auto context = builder.getContext();
+  auto f32Type = builder.getF32Type();
+  auto scalarType = RankedTensorType::get({}, f32Type);
+  int64_t rank = activations.getType().cast<RankedTensorType>().getRank();
+
+  Value zero = builder.create<arith::ConstantOp>(loc, f32Type,
+                                                 builder.getZeroAttr(f32Type));
+  Value maxAbsInit =
+      builder
+          .create<linalg::FillOp>(
+              loc, zero,
+              builder.create<linalg::InitTensorOp>(loc, ArrayRef<int64_t>{},
+                                                   f32Type))
+          .getResult(0);
+  SmallVector<StringRef> reductionIterators(rank,
+                                            getReductionIteratorTypeName());
+  Value maxAbs =
+      builder
+          .create<linalg::GenericOp>(
+              loc, scalarType, ValueRange{activations}, ValueRange{maxAbsInit},
+              ArrayRef<AffineMap>{
+                  AffineMap::getMultiDimIdentityMap(rank, context),
+                  AffineMap::get(rank, 0, context)},
+              reductionIterators,
+              [](OpBuilder &b, Location nestedLoc, ValueRange args) {
+                Value negated = b.create<arith::NegFOp>(nestedLoc, args[0]);
+                Value abs =
+                    b.create<arith::MaxFOp>(nestedLoc, args[0], negated);
+                Value max = b.create<arith::MaxFOp>(nestedLoc, args[1], abs);
+                b.create<linalg::YieldOp>(nestedLoc, max);
+              })
+          .getResult(0);
+
+  // Guard against all-zero activations producing a zero scale.
+  AffineMap scalarMap = AffineMap::get(0, 0, context);
+  return builder
+      .create<linalg::GenericOp>(
+          loc, scalarType, ValueRange{maxAbs},
+          ValueRange{builder.create<linalg::InitTensorOp>(
+              loc, ArrayRef<int64_t>{}, f32Type)},
+          ArrayRef<AffineMap>{scalarMap, scalarMap}, ArrayRef<StringRef>{},
+          [](OpBuilder &b, Location nestedLoc, ValueRange args) {
+            Value inverseMax = b.create<arith::ConstantOp>(
+                nestedLoc, b.getF32FloatAttr(1.0f / kQuantizedMax));
+            Value minScale = b.create<arith::ConstantOp>(
+                nestedLoc, b.getF32FloatAttr(FLT_MIN));
+            Value scale = b.create<arith::MulFOp>(nestedLoc, args[0],
+                                                  inverseMax);
+            scale = b.create<arith::MaxFOp>(nestedLoc, scale, minScale);
+            b.create<linalg::YieldOp>(nestedLoc, scale);
+          })
+      .getResult(0);
+}
+
+// Returns |activations| quantized to i8 with the per-tensor 0-d |scale|.
+static Value quantizeActivations(OpBuilder &builder, Location loc,
+                                 Value activations, Value scale) {
+  auto context = builder.getContext();
+  auto i8Type = builder.getIntegerType(8);
+  int64_t rank = activations.getType().cast<RankedTensorType>().getRank();
+  Value init = createInitTensorLike(builder, loc, activations, i8Type);
+  auto identityMap = AffineMap::getMultiDimIdentityMap(rank, context);
+  return builder
+      .create<linalg::GenericOp>(
+          loc, init.getType(), ValueRange{activations, scale}, ValueRange{init},
+          ArrayRef<AffineMap>{identityMap, AffineMap::get(rank, 0, context),
+                              identityMap},
+          SmallVector<StringRef>(rank, getParallelIteratorTypeName()),
+          [&](OpBuilder &b, Location nestedLoc, ValueRange args) {
+            auto cst = [&](float value) -> Value {
+              return b.create<arith::ConstantOp>(nestedLoc,
+                                                 b.getF32FloatAttr(value));
+            };
+            Value scaled = b.create<arith::DivFOp>(nestedLoc, args[0], args[1]);
+            scaled = b.create<arith::MaxFOp>(nestedLoc, scaled,
+                                             cst(-float(kQuantizedMax)));
+            scaled = b.create<arith::MinFOp>(nestedLoc, scaled,
+                                             cst(float(kQuantizedMax)));
+            // Round half away from zero; fptosi truncates toward zero.
+            Value isNegative = b.create<arith::CmpFOp>(
+                nestedLoc, arith::CmpFPredicate::OLT, scaled, cst(0.0f));
+            Value half = b.create<arith::SelectOp>(nestedLoc, isNegative,
+                                                   cst(-0.5f), cst(0.5f));
+            Value rounded = b.create<arith::AddFOp>(nestedLoc, scaled, half);
+            Value quantized =
+                b.create<arith::FPToSIOp>(nestedLoc, i8Type, rounded);
+            b.create<linalg::YieldOp>(nestedLoc, quantized);
+          })
+      .getResult(0);
+}
+
+// Dequantizes the i32 |accumulator| into |init| using the per-tensor 0-d
+// |activationScale| and the per-channel |weightScales| along the innermost
+// dimension.
+static Value dequantizeResult(OpBuilder &builder, Location loc,
+                              Value accumulator, Value activationScale,
+                              Value weightScales, Value init) {
+  auto context = builder.getContext();
+  int64_t rank = init.getType().cast<RankedTensorType>().getRank();
+  auto identityMap = AffineMap::getMultiDimIdentityMap(rank, context);
+  return builder
+      .create<linalg::GenericOp>(
+          loc, init.getType(),
+          ValueRange{accumulator, activationScale, weightScales},
+          ValueRange{init},
+          ArrayRef<AffineMap>{
+              identityMap, AffineMap::get(rank, 0, context),
+              AffineMap::get(rank, 0, builder.getAffineDimExpr(rank - 1)),
+              identityMap},
+          SmallVector<StringRef>(rank, getParallelIteratorTypeName()),
+          [](OpBuilder &b, Location nestedLoc, ValueRange args) {
+            Value value = b.create<arith::SIToFPOp>(
+                nestedLoc, args[3].getType(), args[0]);
+            Value scale = b.create<arith::MulFOp>(nestedLoc, args[1], args[2]);
+            value = b.create<arith::MulFOp>(nestedLoc, value, scale);
+            value = b.create<arith::AddFOp>(nestedLoc, args[3], value);
+            b.create<linalg::YieldOp>(nestedLoc, value);
+          })
+      .getResult(0);
+}
+
+// Returns true if |op| is an f32 matmul or convolution whose weights are
+// constants that can be quantized at compile time.
+static bool isQuantizationCandidate(linalg::LinalgOp op) {
+  if (!isa<linalg::MatmulOp, linalg::Conv2DNhwcHwcfOp>(op.getOperation())) {
+    return false;
+  }
+  if (op.getNumInputs() != 2 || op.getNumOutputs() != 1) return false;
+  for (OpOperand *operand : op.getInputAndOutputOperands()) {
+    auto type = operand->get().getType().dyn_cast<RankedTensorType>();
+    if (!type || !type.getElementType().isF32()) return false;
+  }
+  DenseFPElementsAttr weightsAttr;
+  return matchPattern(op.getInputOperand(1)->get(), m_Constant(&weightsAttr));
+}
+
+class QuantizeNumericsPass
+    : public QuantizeNumericsBase<QuantizeNumericsPass> {
+  void getDependentDialects(DialectRegistry &registry) const override {
+    registry.insert<arith::ArithmeticDialect, linalg::LinalgDialect,
+                    tensor::TensorDialect>();
+  }
+
+  void runOnOperation() override {
+    SmallVector<linalg::LinalgOp> candidateOps;
+    getOperation()->walk([&](linalg::LinalgOp op) {
+      if (isQuantizationCandidate(op)) candidateOps.push_back(op);
+    });
+    if (candidateOps.empty()) return;
+
+    // Infer the ranges of all activations so that those with known bounds
+    // (constants, clamps, etc) can use a static scale.
+    Explorer explorer(getOperation(), TraversalAction::SHALLOW);
+    llvm::BumpPtrAllocator allocator;
+    DFX::Solver solver(explorer, allocator);
+    for (auto op : candidateOps) {
+      solver.getOrCreateElementFor<IREE::Util::FloatRangeValueElement>(
+          Position::forValue(op.getInputOperand(0)->get()));
+    }
+    if (failed(solver.run())) {
+      return signalPassFailure();
+    }
+    llvm::DenseMap<Value, double> knownMaxAbs;
+    for (auto op : candidateOps) {
+      Value activations = op.getInputOperand(0)->get();
+      auto *element =
+          solver.lookupElementFor<IREE::Util::FloatRangeValueElement>(
+              Position::forValue(activations));
+      if (!element) continue;
+      auto stats = element->getKnown();
+      if (!stats.valid || !stats.isFinite()) continue;
+      knownMaxAbs[activations] =
+          std::max(std::fabs(stats.minValue), std::fabs(stats.maxValue));
+    }
+
+    for (auto op : candidateOps) {
+      auto it = knownMaxAbs.find(op.getInputOperand(0)->get());
+      quantizeOp(op, it == knownMaxAbs.end() ? llvm::None
+                                             : Optional<double>(it->second));
+    }
+  }
+
+  void quantizeOp(linalg::LinalgOp op, Optional<double> knownMaxAbs) {
+    auto loc = op.getLoc();
+    OpBuilder builder(op);
+    auto f32Type = builder.getF32Type();
+    Value activations = op.getInputOperand(0)->get();
+    Value init = op.getOutputOperand(0)->get();
+
+    DenseFPElementsAttr weightsAttr;
+    matchPattern(op.getInputOperand(1)->get(), m_Constant(&weightsAttr));
+    auto quantizedWeights = quantizeWeights(weightsAttr);
+    Value weights =
+        builder.create<arith::ConstantOp>(loc, quantizedWeights.values);
+    Value weightScales = builder.create<arith::ConstantOp>(
+        loc, DenseElementsAttr::get(
+                 RankedTensorType::get(
+                     {static_cast<int64_t>(quantizedWeights.scales.size())},
+                     f32Type),
+                 llvm::makeArrayRef(quantizedWeights.scales)));
+
+    Value activationScale;
+    if (knownMaxAbs) {
+      float scale = *knownMaxAbs > 0.0 ? *knownMaxAbs / kQuantizedMax : 1.0f;
+      activationScale = builder.create<arith::ConstantOp>(
+          loc, DenseElementsAttr::get(RankedTensorType::get({}, f32Type),
+                                      llvm::makeArrayRef(scale)));
+    } else {
+      activationScale = computeDynamicScale(builder, loc, activations);
+    }
+    Value quantizedActivations =
+        quantizeActivations(builder, loc, activations, activationScale);
+
+    auto i32Type = builder.getIntegerType(32);
+    Value accumulator = builder
+                            .create<linalg::FillOp>(
+                                loc,
+                                builder.create<arith::ConstantOp>(
+                                    loc, i32Type, builder.getZeroAttr(i32Type)),
+                                createInitTensorLike(builder, loc, init,
+                                                     i32Type))
+                            .getResult(0);
+    SmallVector<Value> inputs = {quantizedActivations, weights};
+    SmallVector<Value> outputs = {accumulator};
+    if (auto convOp = dyn_cast<linalg::Conv2DNhwcHwcfOp>(op.getOperation())) {
+      accumulator = builder
+                        .create<linalg::Conv2DNhwcHwcfOp>(
+                            loc, TypeRange{accumulator.getType()}, inputs,
+                            outputs,
+                            ArrayRef<NamedAttribute>{
+                                builder.getNamedAttr("strides",
+                                                     convOp.strides()),
+                                builder.getNamedAttr("dilations",
+                                                     convOp.dilations())})
+                        .getResult(0);
+    } else {
+      accumulator =
+          builder.create<linalg::MatmulOp>(loc, inputs, outputs).getResult(0);
+    }
+
+    Value result = dequantizeResult(builder, loc, accumulator, activationScale,
+                                    weightScales, init);
+    LLVM_DEBUG(llvm::dbgs() << "quantized " << op->getName() << " with "
+                            << (knownMaxAbs ? "static" : "dynamic")
+                            << " activation scale\n");
+    op->getResult(0).replaceAllUsesWith(result);
+    op->erase();
+  }
+};
+
+}  // namespace
+
+std::unique_ptr<Pass> createQuantizeNumericsPass() {
+  return std::make_unique<QuantizeNumericsPass>();
+}
+
+}  // namespace Flow
+}  // namespace IREE
+}  // namespace iree_compiler
+}  // namespace mlir
@@ -12,9 +12,12 @@
 
 #include "iree/compiler/Dialect/Flow/Transforms/PassDetail.h"
 #include "iree/compiler/Dialect/Flow/Transforms/Passes.h"
+#include "llvm/Support/CommandLine.h"
+#include "llvm/Support/MathExtras.h"
 #include "mlir/Dialect/Affine/IR/AffineOps.h"
 #include "mlir/Dialect/Linalg/IR/Linalg.h"
 #include "mlir/Dialect/Linalg/Transforms/Transforms.h"
+#include "mlir/IR/BuiltinTypes.h"
 #include "mlir/Transforms/GreedyPatternRewriteDriver.h"
 
 namespace mlir {
@@ -27,6 +30,55 @@ static llvm::cl::opt<int64_t> splitReductionRatio(
     "iree-flow-split-matmul-reduction", llvm::cl::desc("split ratio"),
     llvm::cl::init(1));
 
+static llvm::cl::opt<int64_t> splitReductionWorkerCount(
+    "iree-flow-split-matmul-reduction-worker-count",
+    llvm::cl::desc(
+        "Number of workers the target device executes dispatches with. When "
+        "non-zero, matmuls with fewer parallel workgroup tiles than workers "
+        "are split along K so that the partial products occupy all workers. "
+        "Ignored if -iree-flow-split-matmul-reduction is set."),
+    llvm::cl::init(0));
+
+static llvm::cl::opt<int64_t> splitReductionTileSize(
+    "iree-flow-split-matmul-reduction-tile-size",
+    llvm::cl::desc("Workgroup tile size along M and N used to estimate the "
+                   "number of parallel workgroups of a matmul; should match "
+                   "the codegen distribution tile size."),
+    llvm::cl::init(64));
+
+// Smallest K each split of an automatically split matmul is allowed to have.
+// Below this the extra reduction dispatch costs more than the parallelism
+// gained.
+static constexpr int64_t kMinSplitReductionSize = 128;
+
+// Returns the ratio to split the K dimension of |matmulOp| by so that the
+// partial products provide at least |workerCount| parallel workgroups, or 0
+// if the matmul already has enough parallelism or can't be evenly split.
+static int64_t getAutomaticSplitRatio(linalg::MatmulOp matmulOp,
+                                      int64_t workerCount, int64_t tileSize) {
+  auto lhsType =
+      matmulOp.getInputOperand(0)->get().getType().dyn_cast<ShapedType>();
+  auto rhsType =
+      matmulOp.getInputOperand(1)->get().getType().dyn_cast<ShapedType>();
+  if (workerCount <= 0 || tileSize <= 0 || !lhsType || !rhsType ||
+      !lhsType.hasStaticShape() || !rhsType.hasStaticShape()) {
+    return 0;
+  }
+  int64_t m = lhsType.getDimSize(0);
+  int64_t k = lhsType.getDimSize(1);
+  int64_t n = rhsType.getDimSize(1);
+  int64_t parallelTileCount =
+      llvm::divideCeil(m, tileSize) * llvm::divideCeil(n, tileSize);
+  if (parallelTileCount == 0 || parallelTileCount >= workerCount) return 0;
+  // Pick the largest even split of K up to what is needed to cover all
+  // workers while keeping each split large enough to be worth it.
+  for (int64_t ratio = llvm::divideCeil(workerCount, parallelTileCount);
+       ratio > 1; --ratio) {
+    if (k % ratio == 0 && k / ratio >= kMinSplitReductionSize) return ratio;
+  }
+  return 0;
+}
+
 namespace {
 /// Pattern to wrap splitReduction transformation. This also propagates
 /// attributes to allow compilation info attribute to not be lost.
@@ -75,7 +127,7 @@ struct SplitReductionPass : public SplitReductionBase<SplitReductionPass> {
   }
 
   void runOnOperation() override {
-    if (splitReductionRatio <= 1) return;
+    if (splitReductionRatio <= 1 && splitReductionWorkerCount <= 0) return;
 
     RewritePatternSet patterns(&getContext());
     patterns.add<LinalgSplitReduction>(
@@ -83,8 +135,15 @@ struct SplitReductionPass : public SplitReductionBase<SplitReductionPass> {
         [&](linalg::LinalgOp op) {
           // For matmul make the new parallel dimension first so that it looks
           // like a batch_matmul and can follow the same codegen.
-          if (isa<linalg::MatmulOp>(op))
-            return std::make_pair(int64_t(splitReductionRatio), 0);
+          if (auto matmulOp = dyn_cast<linalg::MatmulOp>(op.getOperation())) {
+            if (splitReductionRatio > 1) {
+              return std::make_pair(int64_t(splitReductionRatio), 0);
+            }
+            return std::make_pair(
+                getAutomaticSplitRatio(matmulOp, splitReductionWorkerCount,
+                                       splitReductionTileSize),
+                0);
+          }
           // Currently disable spliting reduction for non-matmul op. This will
           // get enabled after once tests are ready.
           return std::make_pair(int64_t(0), 0);
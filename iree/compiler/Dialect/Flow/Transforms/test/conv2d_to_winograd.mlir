@@ -0,0 +1,118 @@
+// RUN: iree-opt -split-input-file -iree-flow-convert-conv2d-to-winograd %s | FileCheck %s
+// RUN: iree-opt -split-input-file -iree-flow-convert-conv2d-to-winograd='output-tile-size=2' %s | FileCheck %s --check-prefix=TILE2
+
+func.func @conv_winograd_aligned(%arg0: tensor<1x10x10x4xf32>, %arg1: tensor<3x3x4x8xf32>) -> tensor<1x8x8x8xf32> {
+  %cst = arith.constant 0.000000e+00 : f32
+  %0 = linalg.init_tensor [1, 8, 8, 8] : tensor<1x8x8x8xf32>
+  %1 = linalg.fill ins(%cst : f32) outs(%0 : tensor<1x8x8x8xf32>) -> tensor<1x8x8x8xf32>
+  %2 = linalg.conv_2d_nhwc_hwcf
+    {dilations = dense<1> : tensor<2xi64>, strides = dense<1> : tensor<2xi64>}
+     ins(%arg0, %arg1 : tensor<1x10x10x4xf32>, tensor<3x3x4x8xf32>)
+    outs(%1 : tensor<1x8x8x8xf32>) -> tensor<1x8x8x8xf32>
+  return %2 : tensor<1x8x8x8xf32>
+}
+//  CHECK-DAG: #[[FILTER_MAP:.+]] = affine_map<(d0, d1, d2, d3, d4) -> (d4, d1, d2, d3)>
+//  CHECK-DAG: #[[INPUT_MAP:.+]] = affine_map<(d0, d1, d2, d3, d4, d5, d6) -> (d1, d2 * 4 + d6, d3 * 4 + d4, d5)>
+//      CHECK: func.func @conv_winograd_aligned
+// CHECK-SAME:   %[[INPUT:[a-zA-Z0-9]+]]: tensor<1x10x10x4xf32>
+// CHECK-SAME:   %[[FILTER:[a-zA-Z0-9]+]]: tensor<3x3x4x8xf32>
+//  CHECK-NOT:   tensor.pad
+//      CHECK:   %[[U_HALF:.+]] = linalg.generic
+// CHECK-SAME:     #[[FILTER_MAP]]
+// CHECK-SAME:     iterator_types = ["parallel", "parallel", "parallel", "parallel", "reduction"]
+// CHECK-SAME:     ins(%{{.+}}, %[[FILTER]] : tensor<6x3xf32>, tensor<3x3x4x8xf32>)
+// CHECK-SAME:     -> tensor<6x3x4x8xf32>
+//      CHECK:   %[[U:.+]] = linalg.generic
+// CHECK-SAME:     ins(%{{.+}}, %[[U_HALF]] : tensor<6x3xf32>, tensor<6x3x4x8xf32>)
+// CHECK-SAME:     -> tensor<6x6x4x8xf32>
+//      CHECK:   %[[V_HALF:.+]] = linalg.generic
+// CHECK-SAME:     #[[INPUT_MAP]]
+// CHECK-SAME:     iterator_types = ["parallel", "parallel", "parallel", "parallel", "parallel", "parallel", "reduction"]
+// CHECK-SAME:     ins(%{{.+}}, %[[INPUT]] : tensor<6x6xf32>, tensor<1x10x10x4xf32>)
+// CHECK-SAME:     -> tensor<6x1x2x2x6x4xf32>
+//      CHECK:   %[[V:.+]] = linalg.generic
+// CHECK-SAME:     ins(%{{.+}}, %[[V_HALF]] : tensor<6x6xf32>, tensor<6x1x2x2x6x4xf32>)
+// CHECK-SAME:     -> tensor<6x6x1x2x2x4xf32>
+//  CHECK-DAG:   %[[BATCH_V:.+]] = tensor.collapse_shape %[[V]] {{\[}}[0, 1], [2, 3, 4], [5]] : tensor<6x6x1x2x2x4xf32> into tensor<36x4x4xf32>
+//  CHECK-DAG:   %[[BATCH_U:.+]] = tensor.collapse_shape %[[U]] {{\[}}[0, 1], [2], [3]] : tensor<6x6x4x8xf32> into tensor<36x4x8xf32>
+//      CHECK:   %[[M:.+]] = linalg.batch_matmul
+// CHECK-SAME:     ins(%[[BATCH_V]], %[[BATCH_U]] : tensor<36x4x4xf32>, tensor<36x4x8xf32>)
+//      CHECK:   %[[PRODUCT:.+]] = tensor.expand_shape %[[M]] {{\[}}[0, 1], [2, 3, 4], [5]] : tensor<36x4x8xf32> into tensor<6x6x1x2x2x8xf32>
+//      CHECK:   %[[Y_HALF:.+]] = linalg.generic
+// CHECK-SAME:     ins(%{{.+}}, %[[PRODUCT]] : tensor<4x6xf32>, tensor<6x6x1x2x2x8xf32>)
+// CHECK-SAME:     -> tensor<4x6x1x2x2x8xf32>
+//      CHECK:   %[[Y:.+]] = linalg.generic
+// CHECK-SAME:     ins(%{{.+}}, %[[Y_HALF]] : tensor<4x6xf32>, tensor<4x6x1x2x2x8xf32>)
+// CHECK-SAME:     -> tensor<1x2x4x2x4x8xf32>
+//      CHECK:   %[[RESULT:.+]] = tensor.collapse_shape %[[Y]] {{\[}}[0], [1, 2], [3, 4], [5]] : tensor<1x2x4x2x4x8xf32> into tensor<1x8x8x8xf32>
+//  CHECK-NOT:   linalg.generic
+//      CHECK:   return %[[RESULT]]
+
+// TILE2-LABEL: func.func @conv_winograd_aligned
+//       TILE2:   linalg.generic
+//  TILE2-SAME:     -> tensor<4x3x4x8xf32>
+//       TILE2:   linalg.generic
+//  TILE2-SAME:     -> tensor<4x4x4x8xf32>
+//       TILE2:   linalg.generic
+//  TILE2-SAME:     -> tensor<4x1x4x4x4x4xf32>
+//       TILE2:   linalg.generic
+//  TILE2-SAME:     -> tensor<4x4x1x4x4x4xf32>
+//       TILE2:   linalg.batch_matmul
+//  TILE2-SAME:     ins(%{{.+}}, %{{.+}} : tensor<16x16x4xf32>, tensor<16x4x8xf32>)
+//       TILE2:   linalg.generic
+//  TILE2-SAME:     -> tensor<2x4x1x4x4x8xf32>
+//       TILE2:   linalg.generic
+//  TILE2-SAME:     -> tensor<1x4x2x4x2x8xf32>
+
+// -----
+
+func.func @conv_winograd_unaligned(%arg0: tensor<1x9x9x4xf32>, %arg1: tensor<3x3x4x8xf32>, %arg2: tensor<1x7x7x8xf32>) -> tensor<1x7x7x8xf32> {
+  %0 = linalg.conv_2d_nhwc_hwcf
+    {dilations = dense<1> : tensor<2xi64>, strides = dense<1> : tensor<2xi64>}
+     ins(%arg0, %arg1 : tensor<1x9x9x4xf32>, tensor<3x3x4x8xf32>)
+    outs(%arg2 : tensor<1x7x7x8xf32>) -> tensor<1x7x7x8xf32>
+  return %0 : tensor<1x7x7x8xf32>
+}
+//      CHECK: func.func @conv_winograd_unaligned
+// CHECK-SAME:   %[[INPUT:[a-zA-Z0-9]+]]: tensor<1x9x9x4xf32>
+// CHECK-SAME:   %[[FILTER:[a-zA-Z0-9]+]]: tensor<3x3x4x8xf32>
+// CHECK-SAME:   %[[OUTPUT:[a-zA-Z0-9]+]]: tensor<1x7x7x8xf32>
+//      CHECK:   %[[PADDED:.+]] = tensor.pad %[[INPUT]] low[0, 0, 0, 0] high[0, 1, 1, 0]
+//      CHECK:     tensor<1x9x9x4xf32> to tensor<1x10x10x4xf32>
+//      CHECK:   linalg.generic
+// CHECK-SAME:     ins(%{{.+}}, %[[PADDED]] : tensor<6x6xf32>, tensor<1x10x10x4xf32>)
+//      CHECK:   linalg.batch_matmul
+//      CHECK:   %[[TILES:.+]] = tensor.collapse_shape
+// CHECK-SAME:     into tensor<1x8x8x8xf32>
+//      CHECK:   %[[SLICE:.+]] = tensor.extract_slice %[[TILES]][0, 0, 0, 0] [1, 7, 7, 8] [1, 1, 1, 1]
+//      CHECK:   %[[RESULT:.+]] = linalg.generic
+// CHECK-SAME:     ins(%[[SLICE]] : tensor<1x7x7x8xf32>)
+// CHECK-SAME:     outs(%[[OUTPUT]] : tensor<1x7x7x8xf32>)
+//      CHECK:     arith.addf
+//      CHECK:   return %[[RESULT]]
+
+// -----
+
+func.func @conv_strided_not_converted(%arg0: tensor<1x17x17x4xf32>, %arg1: tensor<3x3x4x8xf32>, %arg2: tensor<1x8x8x8xf32>) -> tensor<1x8x8x8xf32> {
+  %0 = linalg.conv_2d_nhwc_hwcf
+    {dilations = dense<1> : tensor<2xi64>, strides = dense<2> : tensor<2xi64>}
+     ins(%arg0, %arg1 : tensor<1x17x17x4xf32>, tensor<3x3x4x8xf32>)
+    outs(%arg2 : tensor<1x8x8x8xf32>) -> tensor<1x8x8x8xf32>
+  return %0 : tensor<1x8x8x8xf32>
+}
+//      CHECK: func.func @conv_strided_not_converted
+//  CHECK-NOT:   linalg.batch_matmul
+//      CHECK:   linalg.conv_2d_nhwc_hwcf
+
+// -----
+
+func.func @conv_larger_input_not_converted(%arg0: tensor<1x12x12x4xf32>, %arg1: tensor<3x3x4x8xf32>, %arg2: tensor<1x8x8x8xf32>) -> tensor<1x8x8x8xf32> {
+  %0 = linalg.conv_2d_nhwc_hwcf
+    {dilations = dense<1> : tensor<2xi64>, strides = dense<1> : tensor<2xi64>}
+     ins(%arg0, %arg1 : tensor<1x12x12x4xf32>, tensor<3x3x4x8xf32>)
+    outs(%arg2 : tensor<1x8x8x8xf32>) -> tensor<1x8x8x8xf32>
+  return %0 : tensor<1x8x8x8xf32>
+}
+//      CHECK: func.func @conv_larger_input_not_converted
+//  CHECK-NOT:   linalg.batch_matmul
+//      CHECK:   linalg.conv_2d_nhwc_hwcf
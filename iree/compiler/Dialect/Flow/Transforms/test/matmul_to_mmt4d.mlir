@@ -2,6 +2,7 @@
 // RUN: iree-opt -split-input-file --iree-flow-convert-linalg-matmul-to-mmt4d='arch=aarch64' %s | FileCheck %s -check-prefix=AARCH64-BASELINE
 // RUN: iree-opt -split-input-file --iree-flow-convert-linalg-matmul-to-mmt4d='arch=aarch64 features=+dotprod' %s | FileCheck %s -check-prefix=AARCH64-DOTPROD
 // RUN: iree-opt -split-input-file --iree-flow-convert-linalg-matmul-to-mmt4d='arch=aarch64 features=+i8mm' %s | FileCheck %s -check-prefix=AARCH64-I8MM
+// RUN: iree-opt -split-input-file --iree-flow-convert-linalg-matmul-to-mmt4d='arch=x86_64 features=+avx2,+fma,+avx512vnni' %s | FileCheck %s -check-prefix=X86_64-VNNI
 
 // There are two parts to this test: the "deep" part and the "wide part".
 
@@ -200,6 +201,11 @@ func.func @check_target_specific_mmt4d_i8_dynamic(%arg0: tensor<?x?xi8>, %arg1:
 // AARCH64-I8MM-SAME:     {comment = "i8*i8->i32, aarch64 +i8mm"}
 // AARCH64-I8MM-SAME:     ins({{.*}} : tensor<?x?x8x8xi8>, tensor<?x?x8x8xi8>) outs({{.*}} : tensor<?x?x8x8xi32>) -> tensor<?x?x8x8xi32>
 
+// X86_64-VNNI-LABEL:  @check_target_specific_mmt4d_i8_dynamic(
+// X86_64-VNNI:        linalg.mmt4d
+// X86_64-VNNI-SAME:     {comment = "i8*i8->i32, x86_64 +avx512vnni"}
+// X86_64-VNNI-SAME:     ins({{.*}} : tensor<?x?x8x4xi8>, tensor<?x?x16x4xi8>) outs({{.*}} : tensor<?x?x8x16xi32>) -> tensor<?x?x8x16xi32>
+
 // -----
 func.func @check_target_specific_mmt4d_i8_dynamic_matvec(%arg0: tensor<?x?xi8>, %arg1: tensor<?x1xi8>, %arg2: tensor<?x1xi32>) -> tensor<?x1xi32> {
     %0 = linalg.matmul ins(%arg0, %arg1 : tensor<?x?xi8>, tensor<?x1xi8>) outs(%arg2 : tensor<?x1xi32>) -> tensor<?x1xi32>
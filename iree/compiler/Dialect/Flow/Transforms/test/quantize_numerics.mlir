@@ -0,0 +1,95 @@
+// RUN: iree-opt -split-input-file -iree-flow-quantize-numerics %s | FileCheck %s
+
+// Tests that constant weights are quantized per output channel at compile time
+// and that activations without a known range get a runtime max-abs scale.
+
+//  CHECK-DAG: #[[IDENTITY:.+]] = affine_map<(d0, d1) -> (d0, d1)>
+//  CHECK-DAG: #[[SCALAR:.+]] = affine_map<(d0, d1) -> ()>
+//  CHECK-DAG: #[[CHANNEL:.+]] = affine_map<(d0, d1) -> (d1)>
+//      CHECK: func.func @matmul_dynamic_scale
+// CHECK-SAME:   %[[LHS:[a-zA-Z0-9]+]]: tensor<?x2xf32>
+// CHECK-SAME:   %[[INIT:[a-zA-Z0-9]+]]: tensor<?x2xf32>
+func.func @matmul_dynamic_scale(%lhs: tensor<?x2xf32>, %init: tensor<?x2xf32>) -> tensor<?x2xf32> {
+  //  CHECK-DAG:   %[[WEIGHTS:.+]] = arith.constant dense<{{\[}}[127, -32], [64, 127]]> : tensor<2x2xi8>
+  //  CHECK-DAG:   %[[WEIGHT_SCALES:.+]] = arith.constant dense<[{{.+}}]> : tensor<2xf32>
+  //      CHECK:   %[[MAX_ABS:.+]] = linalg.generic
+  // CHECK-SAME:     iterator_types = ["reduction", "reduction"]
+  // CHECK-SAME:     ins(%[[LHS]] : tensor<?x2xf32>)
+  //      CHECK:     arith.negf
+  //      CHECK:     arith.maxf
+  //      CHECK:     arith.maxf
+  //      CHECK:   %[[SCALE:.+]] = linalg.generic
+  // CHECK-SAME:     ins(%[[MAX_ABS]] : tensor<f32>)
+  //      CHECK:   %[[QLHS:.+]] = linalg.generic
+  // CHECK-SAME:     ins(%[[LHS]], %[[SCALE]] : tensor<?x2xf32>, tensor<f32>)
+  //      CHECK:     arith.divf
+  //      CHECK:     arith.fptosi %{{.+}} : f32 to i8
+  //      CHECK:   %[[ACC:.+]] = linalg.fill
+  // CHECK-SAME:     -> tensor<?x2xi32>
+  //      CHECK:   %[[MATMUL:.+]] = linalg.matmul
+  // CHECK-SAME:     ins(%[[QLHS]], %[[WEIGHTS]] : tensor<?x2xi8>, tensor<2x2xi8>)
+  // CHECK-SAME:     outs(%[[ACC]] : tensor<?x2xi32>)
+  //      CHECK:   %[[RESULT:.+]] = linalg.generic
+  // CHECK-SAME:     indexing_maps = [#[[IDENTITY]], #[[SCALAR]], #[[CHANNEL]], #[[IDENTITY]]]
+  // CHECK-SAME:     ins(%[[MATMUL]], %[[SCALE]], %[[WEIGHT_SCALES]] : tensor<?x2xi32>, tensor<f32>, tensor<2xf32>)
+  // CHECK-SAME:     outs(%[[INIT]] : tensor<?x2xf32>)
+  //      CHECK:     arith.sitofp %{{.+}} : i32 to f32
+  //      CHECK:   return %[[RESULT]]
+  %weights = arith.constant dense<[[1.0, -0.5], [0.5, 2.0]]> : tensor<2x2xf32>
+  %0 = linalg.matmul ins(%lhs, %weights : tensor<?x2xf32>, tensor<2x2xf32>) outs(%init : tensor<?x2xf32>) -> tensor<?x2xf32>
+  return %0 : tensor<?x2xf32>
+}
+
+// -----
+
+// Tests that activations with an inferred range use a static scale.
+
+//      CHECK: func.func @matmul_static_scale
+func.func @matmul_static_scale(%init: tensor<1x2xf32>) -> tensor<1x2xf32> {
+  //      CHECK:   %[[SCALE:.+]] = arith.constant dense<{{.+}}> : tensor<f32>
+  //  CHECK-NOT:   "reduction"
+  //      CHECK:   linalg.generic
+  // CHECK-SAME:     ins(%{{.+}}, %[[SCALE]] : tensor<1x2xf32>, tensor<f32>)
+  //      CHECK:   linalg.matmul
+  // CHECK-SAME:     tensor<1x2xi8>, tensor<2x2xi8>
+  %lhs = arith.constant dense<[[1.0, -3.0]]> : tensor<1x2xf32>
+  %weights = arith.constant dense<[[1.0, -0.5], [0.5, 2.0]]> : tensor<2x2xf32>
+  %0 = linalg.matmul ins(%lhs, %weights : tensor<1x2xf32>, tensor<2x2xf32>) outs(%init : tensor<1x2xf32>) -> tensor<1x2xf32>
+  return %0 : tensor<1x2xf32>
+}
+
+// -----
+
+// Tests that convolution filters are quantized per output channel and that
+// the convolution attributes are preserved.
+
+//      CHECK: func.func @conv_dynamic_scale
+func.func @conv_dynamic_scale(%input: tensor<1x4x4x2xf32>, %init: tensor<1x2x2x3xf32>) -> tensor<1x2x2x3xf32> {
+  //      CHECK:   %[[FILTER:.+]] = arith.constant dense<{{.+}}> : tensor<2x2x2x3xi8>
+  //      CHECK:   %[[CONV:.+]] = linalg.conv_2d_nhwc_hwcf
+  // CHECK-SAME:     dilations = dense<1> : tensor<2xi64>
+  // CHECK-SAME:     strides = dense<2> : tensor<2xi64>
+  // CHECK-SAME:     ins(%{{.+}}, %[[FILTER]] : tensor<1x4x4x2xi8>, tensor<2x2x2x3xi8>)
+  // CHECK-SAME:     -> tensor<1x2x2x3xi32>
+  //      CHECK:   linalg.generic
+  // CHECK-SAME:     ins(%[[CONV]], %{{.+}}, %{{.+}} : tensor<1x2x2x3xi32>, tensor<f32>, tensor<3xf32>)
+  %filter = arith.constant dense<0.25> : tensor<2x2x2x3xf32>
+  %0 = linalg.conv_2d_nhwc_hwcf
+    {dilations = dense<1> : tensor<2xi64>, strides = dense<2> : tensor<2xi64>}
+     ins(%input, %filter : tensor<1x4x4x2xf32>, tensor<2x2x2x3xf32>)
+    outs(%init : tensor<1x2x2x3xf32>) -> tensor<1x2x2x3xf32>
+  return %0 : tensor<1x2x2x3xf32>
+}
+
+// -----
+
+// Tests that ops with non-constant weights are left in floating point.
+
+//      CHECK: func.func @matmul_dynamic_weights
+func.func @matmul_dynamic_weights(%lhs: tensor<4x8xf32>, %rhs: tensor<8x4xf32>, %init: tensor<4x4xf32>) -> tensor<4x4xf32> {
+  //  CHECK-NOT:   i8
+  //      CHECK:   linalg.matmul
+  // CHECK-SAME:     tensor<4x8xf32>, tensor<8x4xf32>
+  %0 = linalg.matmul ins(%lhs, %rhs : tensor<4x8xf32>, tensor<8x4xf32>) outs(%init : tensor<4x4xf32>) -> tensor<4x4xf32>
+  return %0 : tensor<4x4xf32>
+}
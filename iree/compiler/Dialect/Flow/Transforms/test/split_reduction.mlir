@@ -0,0 +1,54 @@
+// RUN: iree-opt -split-input-file -iree-flow-split-reduction-ops -iree-flow-split-matmul-reduction-worker-count=32 %s | FileCheck %s
+
+// Tests that a skinny matmul with too few parallel tiles to occupy all workers
+// is split along K into partial products and a follow-up reduction.
+
+func.func @split_skinny_matmul(%lhs: tensor<1x1024xf32>, %rhs: tensor<1024x1024xf32>, %acc: tensor<1x1024xf32>) -> tensor<1x1024xf32> {
+  %0 = linalg.matmul ins(%lhs, %rhs : tensor<1x1024xf32>, tensor<1024x1024xf32>) outs(%acc : tensor<1x1024xf32>) -> tensor<1x1024xf32>
+  return %0 : tensor<1x1024xf32>
+}
+// CHECK-LABEL: @split_skinny_matmul
+//   CHECK-NOT: linalg.matmul
+//       CHECK: tensor.expand_shape {{.+}} : tensor<1x1024xf32> into tensor<1x2x512xf32>
+//       CHECK: tensor.expand_shape {{.+}} : tensor<1024x1024xf32> into tensor<2x512x1024xf32>
+//       CHECK: linalg.generic
+//  CHECK-SAME:   iterator_types = ["parallel", "parallel", "parallel", "reduction"]
+//       CHECK: linalg.generic
+//  CHECK-SAME:   iterator_types = ["parallel", "parallel", "reduction"]
+
+// -----
+
+// Tests that matmuls with enough parallel tiles are left alone.
+
+func.func @no_split_wide_matmul(%lhs: tensor<512x1024xf32>, %rhs: tensor<1024x512xf32>, %acc: tensor<512x512xf32>) -> tensor<512x512xf32> {
+  %0 = linalg.matmul ins(%lhs, %rhs : tensor<512x1024xf32>, tensor<1024x512xf32>) outs(%acc : tensor<512x512xf32>) -> tensor<512x512xf32>
+  return %0 : tensor<512x512xf32>
+}
+// CHECK-LABEL: @no_split_wide_matmul
+//   CHECK-NOT: tensor.expand_shape
+//       CHECK: linalg.matmul
+
+// -----
+
+// Tests that K is not split into chunks too small to be worth the extra
+// reduction dispatch.
+
+func.func @no_split_short_k(%lhs: tensor<1x200xf32>, %rhs: tensor<200x1024xf32>, %acc: tensor<1x1024xf32>) -> tensor<1x1024xf32> {
+  %0 = linalg.matmul ins(%lhs, %rhs : tensor<1x200xf32>, tensor<200x1024xf32>) outs(%acc : tensor<1x1024xf32>) -> tensor<1x1024xf32>
+  return %0 : tensor<1x1024xf32>
+}
+// CHECK-LABEL: @no_split_short_k
+//   CHECK-NOT: tensor.expand_shape
+//       CHECK: linalg.matmul
+
+// -----
+
+// Tests that dynamically shaped matmuls are not split automatically.
+
+func.func @no_split_dynamic(%lhs: tensor<?x?xf32>, %rhs: tensor<?x?xf32>, %acc: tensor<?x?xf32>) -> tensor<?x?xf32> {
+  %0 = linalg.matmul ins(%lhs, %rhs : tensor<?x?xf32>, tensor<?x?xf32>) outs(%acc : tensor<?x?xf32>) -> tensor<?x?xf32>
+  return %0 : tensor<?x?xf32>
+}
+// CHECK-LABEL: @no_split_dynamic
+//   CHECK-NOT: tensor.expand_shape
+//       CHECK: linalg.matmul
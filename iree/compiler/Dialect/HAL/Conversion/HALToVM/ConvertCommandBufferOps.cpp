@@ -116,6 +116,97 @@ class CommandBufferPushDescriptorSetOpConversion
   mutable IREE::VM::ImportOp importOp;
 };
 
+class CommandBufferDispatchBatchOpConversion
+    : public OpConversionPattern<IREE::HAL::CommandBufferDispatchBatchOp> {
+ public:
+  CommandBufferDispatchBatchOpConversion(MLIRContext *context,
+                                         SymbolTable &importSymbols,
+                                         TypeConverter &typeConverter,
+                                         StringRef importName)
+      : OpConversionPattern(context) {
+    importOp = importSymbols.lookup<IREE::VM::ImportOp>(importName);
+    assert(importOp);
+  }
+
+  LogicalResult matchAndRewrite(
+      IREE::HAL::CommandBufferDispatchBatchOp op, OpAdaptor adaptor,
+      ConversionPatternRewriter &rewriter) const override {
+    auto importType = importOp.getFunctionType();
+    auto loc = op.getLoc();
+
+    // See hal.imports.mlir for the record encoding. Each record is flattened
+    // into 5-element <ref, i32, i32, i32, i32> tuples.
+    auto i32Constant = [&](int64_t value) -> Value {
+      return rewriter.createOrFold<mlir::arith::ConstantIntOp>(loc, value, 32);
+    };
+    Value zero = i32Constant(0);
+    Value nullRef = rewriter.create<IREE::VM::ConstRefZeroOp>(
+        loc, IREE::VM::RefType::get(
+                 IREE::VM::OpaqueType::get(rewriter.getContext())));
+
+    SmallVector<Value, 32> callOperands = {
+        adaptor.command_buffer(),
+    };
+    int64_t tupleCount = 0;
+    auto appendTuple = [&](Value ref, Value i0, Value i1, Value i2,
+                           Value i3) {
+      callOperands.append({ref, i0, i1, i2, i3});
+      ++tupleCount;
+    };
+
+    auto constants = adaptor.constants();
+    auto bindingOrdinals = adaptor.binding_ordinals();
+    auto bindingBuffers = adaptor.binding_buffers();
+    auto bindingOffsets = adaptor.binding_offsets();
+    auto bindingLengths = adaptor.binding_lengths();
+    auto workgroupCounts = adaptor.workgroup_counts();
+    size_t constantBase = 0;
+    size_t bindingBase = 0;
+    for (size_t i = 0; i < op.getRecordCount(); ++i) {
+      int64_t constantCount =
+          op.constant_counts()[i].cast<IntegerAttr>().getInt();
+      int64_t bindingCount =
+          op.binding_counts()[i].cast<IntegerAttr>().getInt();
+      int64_t entryPoint = op.entry_points()[i].cast<IntegerAttr>().getInt();
+      Value layout = constantCount || bindingCount
+                         ? adaptor.executable_layouts()[i]
+                         : nullRef;
+      appendTuple(layout, adaptor.sets()[i], i32Constant(constantCount),
+                  i32Constant(bindingCount), i32Constant(entryPoint));
+      appendTuple(adaptor.executables()[i], workgroupCounts[i * 3 + 0],
+                  workgroupCounts[i * 3 + 1], workgroupCounts[i * 3 + 2],
+                  zero);
+      for (int64_t j = 0; j < constantCount; j += 4) {
+        Value values[4] = {zero, zero, zero, zero};
+        for (int64_t k = 0; k < 4 && j + k < constantCount; ++k) {
+          values[k] = constants[constantBase + j + k];
+        }
+        appendTuple(nullRef, values[0], values[1], values[2], values[3]);
+      }
+      constantBase += constantCount;
+      for (int64_t j = 0; j < bindingCount; ++j) {
+        size_t b = bindingBase + j;
+        appendTuple(bindingBuffers[b], bindingOrdinals[b], bindingOffsets[b],
+                    bindingLengths[b], zero);
+      }
+      bindingBase += bindingCount;
+    }
+
+    SmallVector<int16_t, 2> segmentSizes = {
+        /*command_buffer=*/-1,
+        /*records=*/static_cast<int16_t>(tupleCount),
+    };
+    auto callOp = rewriter.replaceOpWithNewOp<IREE::VM::CallVariadicOp>(
+        op, SymbolRefAttr::get(importOp), importType.getResults(), segmentSizes,
+        importType.getInputs(), callOperands);
+    copyImportAttrs(importOp, callOp);
+    return success();
+  }
+
+ private:
+  mutable IREE::VM::ImportOp importOp;
+};
+
 }  // namespace
 
 void populateHALCommandBufferToVMPatterns(MLIRContext *context,
@@ -157,6 +248,9 @@ void populateHALCommandBufferToVMPatterns(MLIRContext *context,
       "hal.command_buffer.bind_descriptor_set");
   patterns.insert<VMImportOpConversion<IREE::HAL::CommandBufferDispatchOp>>(
       context, importSymbols, typeConverter, "hal.command_buffer.dispatch");
+  patterns.insert<CommandBufferDispatchBatchOpConversion>(
+      context, importSymbols, typeConverter,
+      "hal.command_buffer.dispatch.batch");
   patterns
       .insert<VMImportOpConversion<IREE::HAL::CommandBufferDispatchIndirectOp>>(
           context, importSymbols, typeConverter,
@@ -148,6 +148,39 @@ func.func @command_buffer_dispatch(
 
 // -----
 
+// CHECK-LABEL: @command_buffer_dispatch_batch
+func.func @command_buffer_dispatch_batch(
+  %arg0: !hal.command_buffer,
+  %arg1: !hal.executable_layout,
+  %arg2: !hal.executable,
+  %arg3: !hal.buffer
+) {
+  %c0 = arith.constant 0 : index
+  %c1 = arith.constant 1 : index
+  %c100 = arith.constant 100 : index
+  %c200 = arith.constant 200 : index
+  %c42_i32 = arith.constant 42 : i32
+  // CHECK-DAG: %[[NULL:.+]] = vm.const.ref.zero : !vm.ref<?>
+  // CHECK: vm.call.variadic @hal.command_buffer.dispatch.batch(%arg0, [
+  // CHECK-SAME: (%arg1, %zero, %c1, %c1, %zero),
+  // CHECK-SAME: (%arg2, %c100, %c1, %c1, %zero),
+  // CHECK-SAME: (%[[NULL]], %c42, %zero, %zero, %zero),
+  // CHECK-SAME: (%arg3, %zero, %zero, %c200, %zero),
+  // CHECK-SAME: (%[[NULL]], %zero, %zero, %zero, %c1),
+  // CHECK-SAME: (%arg2, %c1, %c100, %c1, %zero)
+  // CHECK-SAME: ]) : (!vm.ref<!hal.command_buffer>, tuple<!vm.ref<?>, i32, i32, i32, i32> ...)
+  hal.command_buffer.dispatch.batch<%arg0 : !hal.command_buffer>
+      layouts([%arg1, %arg1] : !hal.executable_layout, !hal.executable_layout)
+      targets([%arg2, %arg2] : !hal.executable, !hal.executable)[0 : index, 1 : index]
+      workgroups([%c100, %c1, %c1, %c1, %c100, %c1])
+      sets([%c0, %c0])
+      constants [1 : index, 0 : index]([%c42_i32] : i32)
+      bindings [1 : index, 0 : index]([%c0], [%arg3 : !hal.buffer], [%c0], [%c200])
+  return
+}
+
+// -----
+
 // CHECK-LABEL: @command_buffer_dispatch_indirect
 func.func @command_buffer_dispatch_indirect(
   %arg0: !hal.command_buffer,
@@ -14,7 +14,9 @@
 #include "iree/compiler/Dialect/Stream/IR/StreamOps.h"
 #include "iree/compiler/Dialect/Stream/IR/StreamTypes.h"
 #include "iree/compiler/Dialect/Util/IR/UtilOps.h"
+#include "mlir/Dialect/Arithmetic/IR/Arithmetic.h"
 #include "mlir/Dialect/Func/IR/FuncOps.h"
+#include "mlir/Dialect/SCF/SCF.h"
 #include "mlir/Transforms/DialectConversion.h"
 
 namespace mlir {
@@ -690,20 +692,28 @@ struct CmdDispatchOpPattern
       auto caseBuilder = OpBuilder::atBlockBegin(&entryBlock);
 
       // Record push constants and buffer bindings.
+      // Specializations share the layout of their base entry point so this is
+      // done once regardless of which one ends up being dispatched.
       recordParameters(loc, device, commandBuffer, dispatchOp, adaptor,
                        entryPointOp.layout(), caseBuilder);
 
-      // Dispatch with a target-specific workgroup count.
-      auto entryPointSymRef =
-          SymbolRefAttr::get(caseBuilder.getContext(), executableOp.getName(),
-                             {SymbolRefAttr::get(entryPointOp->getParentOp()),
-                              SymbolRefAttr::get(entryPointOp)});
-      auto caseWorkgroupCount = entryPointOp.calculateWorkgroupCount(
-          loc, adaptor.workgroup_count(), caseBuilder);
-      caseBuilder.create<IREE::HAL::CommandBufferDispatchSymbolOp>(
-          loc, commandBuffer, entryPointSymRef, caseWorkgroupCount[0],
-          caseWorkgroupCount[1], caseWorkgroupCount[2]);
+      // Try each specialization of the entry point in order and fall back to
+      // the generic entry point if none of their conditions hold.
+      for (auto specializationOp :
+           getSpecializations(variantOp, entryPointOp)) {
+        auto condition = buildSpecializationCondition(loc, specializationOp,
+                                                      adaptor, caseBuilder);
+        auto ifOp = caseBuilder.create<scf::IfOp>(loc, TypeRange{}, condition,
+                                                  /*withElseRegion=*/true);
+        OpBuilder thenBuilder(ifOp.thenBlock()->getTerminator());
+        recordDispatch(loc, commandBuffer, executableOp, specializationOp,
+                       adaptor, thenBuilder);
+        caseBuilder.setInsertionPoint(ifOp.elseBlock()->getTerminator());
+      }
+      recordDispatch(loc, commandBuffer, executableOp, entryPointOp, adaptor,
+                     caseBuilder);
 
+      caseBuilder.setInsertionPointToEnd(&entryBlock);
       caseBuilder.create<IREE::HAL::ReturnOp>(loc);
     }
     switchRewriter.build();
@@ -712,6 +722,83 @@ struct CmdDispatchOpPattern
     return success();
   }
 
+  // Returns all entry points in |variantOp| specialized from |entryPointOp|
+  // with the most constrained ones first.
+  SmallVector<IREE::HAL::ExecutableEntryPointOp> getSpecializations(
+      IREE::HAL::ExecutableVariantOp variantOp,
+      IREE::HAL::ExecutableEntryPointOp entryPointOp) const {
+    SmallVector<IREE::HAL::ExecutableEntryPointOp> specializationOps;
+    for (auto op : variantOp.getOps<IREE::HAL::ExecutableEntryPointOp>()) {
+      auto specializationOfAttr =
+          op->getAttrOfType<FlatSymbolRefAttr>("hal.specialization_of");
+      if (specializationOfAttr &&
+          specializationOfAttr.getAttr() == entryPointOp.getNameAttr()) {
+        specializationOps.push_back(op);
+      }
+    }
+    auto getTotalAlignment = [](IREE::HAL::ExecutableEntryPointOp op) {
+      int64_t totalAlignment = 0;
+      for (auto alignmentAttr :
+           op->getAttrOfType<ArrayAttr>("hal.specialization_alignments")
+               .getAsRange<IntegerAttr>()) {
+        totalAlignment += alignmentAttr.getInt();
+      }
+      return totalAlignment;
+    };
+    llvm::stable_sort(specializationOps, [&](auto lhs, auto rhs) {
+      return getTotalAlignment(lhs) > getTotalAlignment(rhs);
+    });
+    return specializationOps;
+  }
+
+  // Builds an i1 value that is true when all of the push constant operands
+  // that |specializationOp| was specialized for have the required alignment.
+  Value buildSpecializationCondition(
+      Location loc, IREE::HAL::ExecutableEntryPointOp specializationOp,
+      OpAdaptor adaptor, OpBuilder &builder) const {
+    auto ordinalsAttr = specializationOp->getAttrOfType<ArrayAttr>(
+        "hal.specialization_operands");
+    auto alignmentsAttr = specializationOp->getAttrOfType<ArrayAttr>(
+        "hal.specialization_alignments");
+    Value condition;
+    for (auto it : llvm::zip(ordinalsAttr.getAsRange<IntegerAttr>(),
+                             alignmentsAttr.getAsRange<IntegerAttr>())) {
+      auto operand = adaptor.operands()[std::get<0>(it).getInt()];
+      int64_t alignment = std::get<1>(it).getInt();
+      // (operand & (alignment - 1)) == 0
+      auto maskedValue = builder.createOrFold<arith::AndIOp>(
+          loc, operand,
+          builder.create<arith::ConstantIntOp>(loc, alignment - 1, 32));
+      Value isAligned = builder.createOrFold<arith::CmpIOp>(
+          loc, arith::CmpIPredicate::eq, maskedValue,
+          builder.create<arith::ConstantIntOp>(loc, 0, 32));
+      condition = condition ? builder.createOrFold<arith::AndIOp>(
+                                  loc, condition, isAligned)
+                            : isAligned;
+    }
+    if (!condition) {
+      // No dynamic operands to check; the specialization always applies.
+      condition = builder.create<arith::ConstantIntOp>(loc, 1, 1);
+    }
+    return condition;
+  }
+
+  // Dispatches |entryPointOp| with its target-specific workgroup count.
+  void recordDispatch(Location loc, Value commandBuffer,
+                      IREE::HAL::ExecutableOp executableOp,
+                      IREE::HAL::ExecutableEntryPointOp entryPointOp,
+                      OpAdaptor adaptor, OpBuilder &builder) const {
+    auto entryPointSymRef =
+        SymbolRefAttr::get(builder.getContext(), executableOp.getName(),
+                           {SymbolRefAttr::get(entryPointOp->getParentOp()),
+                            SymbolRefAttr::get(entryPointOp)});
+    auto workgroupCount = entryPointOp.calculateWorkgroupCount(
+        loc, adaptor.workgroup_count(), builder);
+    builder.create<IREE::HAL::CommandBufferDispatchSymbolOp>(
+        loc, commandBuffer, entryPointSymRef, workgroupCount[0],
+        workgroupCount[1], workgroupCount[2]);
+  }
+
   void recordParameters(Location loc, Value device, Value commandBuffer,
                         IREE::Stream::CmdDispatchOp dispatchOp,
                         OpAdaptor adaptor,
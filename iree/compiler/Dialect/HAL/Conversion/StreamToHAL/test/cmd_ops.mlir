@@ -5,3 +5,98 @@
 func.func @todo() {
   return
 }
+
+// -----
+
+// Tests that dispatches to entry points with specializations select the most
+// aligned specialization whose push constant conditions hold and fall back to
+// the generic entry point otherwise.
+
+#executable_target_embedded_elf_x86_64 = #hal.executable.target<"llvm", "embedded-elf-x86_64">
+#device_target_cpu = #hal.device.target<"cpu", {
+  executable_targets = [#executable_target_embedded_elf_x86_64]
+}>
+#executable_layout = #hal.executable.layout<push_constants = 2, sets = [
+  #hal.descriptor_set.layout<0, bindings = [
+    #hal.descriptor_set.binding<0, storage_buffer>
+  ]>
+]>
+
+module attributes {hal.device.targets = [#device_target_cpu]} {
+
+hal.executable private @ex {
+  hal.executable.variant public @embedded_elf_x86_64, target = #executable_target_embedded_elf_x86_64 {
+    hal.executable.entry_point public @dispatch ordinal(0) layout(#executable_layout)
+    hal.executable.entry_point public @dispatch_aligned16 ordinal(1) layout(#executable_layout) {
+      hal.specialization_alignments = [16 : index, 16 : index],
+      hal.specialization_of = @dispatch,
+      hal.specialization_operands = [0 : index, 1 : index]
+    }
+    hal.executable.entry_point public @dispatch_aligned64 ordinal(2) layout(#executable_layout) {
+      hal.specialization_alignments = [64 : index],
+      hal.specialization_of = @dispatch,
+      hal.specialization_operands = [0 : index]
+    }
+    builtin.module {
+      // Opaque at this point (in some target-specific dialects).
+    }
+  }
+}
+
+// CHECK-LABEL: func @cmdDispatchSpecializations
+// CHECK-SAME: (%[[DIM0:.+]]: i32, %[[DIM1:.+]]: i32)
+func.func @cmdDispatchSpecializations(%arg0: i32, %arg1: i32) -> !stream.timepoint {
+  %c0 = arith.constant 0 : index
+  %c1 = arith.constant 1 : index
+  %c128 = arith.constant 128 : index
+  %0 = stream.resource.alloc uninitialized : !stream.resource<transient>{%c128}
+  // CHECK: %[[CMD:.+]] = hal.command_buffer.create
+  %1 = stream.cmd.execute with(%0 as %arg2: !stream.resource<transient>{%c128}) {
+    // Parameters are recorded once regardless of the entry point chosen.
+    // CHECK: hal.device.switch
+    // CHECK: #hal.device.match.executable.format<"embedded-elf-x86_64"> {
+    // CHECK: hal.command_buffer.push_constants<%[[CMD]] : !hal.command_buffer>
+    // CHECK-SAME: values([%[[DIM0]], %[[DIM1]]])
+    // CHECK: hal.command_buffer.push_descriptor_set<%[[CMD]] : !hal.command_buffer>
+    // CHECK-NOT: hal.command_buffer.push
+
+    // The most aligned specialization is tried first.
+    // CHECK: %[[MASK64:.+]] = arith.constant 63 : i32
+    // CHECK: %[[DIM0_MASKED64:.+]] = arith.andi %[[DIM0]], %[[MASK64]] : i32
+    // CHECK: %[[ZERO64:.+]] = arith.constant 0 : i32
+    // CHECK: %[[IS_ALIGNED64:.+]] = arith.cmpi eq, %[[DIM0_MASKED64]], %[[ZERO64]] : i32
+    // CHECK: scf.if %[[IS_ALIGNED64]] {
+    // CHECK: hal.command_buffer.dispatch.symbol<%[[CMD]] : !hal.command_buffer>
+    // CHECK-SAME: target(@ex::@embedded_elf_x86_64::@dispatch_aligned64)
+    // CHECK: } else {
+
+    // All operand conditions of a specialization must hold.
+    // CHECK: %[[MASK16:.+]] = arith.constant 15 : i32
+    // CHECK: %[[DIM0_MASKED16:.+]] = arith.andi %[[DIM0]], %[[MASK16]] : i32
+    // CHECK: %[[DIM0_ALIGNED16:.+]] = arith.cmpi eq, %[[DIM0_MASKED16]]
+    // CHECK: %[[DIM1_MASKED16:.+]] = arith.andi %[[DIM1]], %{{.+}} : i32
+    // CHECK: %[[DIM1_ALIGNED16:.+]] = arith.cmpi eq, %[[DIM1_MASKED16]]
+    // CHECK: %[[IS_ALIGNED16:.+]] = arith.andi %[[DIM0_ALIGNED16]], %[[DIM1_ALIGNED16]] : i1
+    // CHECK: scf.if %[[IS_ALIGNED16]] {
+    // CHECK: hal.command_buffer.dispatch.symbol<%[[CMD]] : !hal.command_buffer>
+    // CHECK-SAME: target(@ex::@embedded_elf_x86_64::@dispatch_aligned16)
+    // CHECK: } else {
+
+    // The generic entry point is dispatched when no specialization applies.
+    // CHECK: hal.command_buffer.dispatch.symbol<%[[CMD]] : !hal.command_buffer>
+    // CHECK-SAME: target(@ex::@embedded_elf_x86_64::@dispatch)
+    // CHECK: }
+    // CHECK: }
+    // CHECK: hal.return
+    stream.cmd.dispatch @ex::@dispatch[%c1, %c1, %c1](%arg0, %arg1 : i32, i32) {
+      wo %arg2[%c0 for %c128] : !stream.resource<transient>{%c128}
+    } attributes {
+      hal.interface.bindings = [
+        #hal.interface.binding<0, 0>
+      ]
+    }
+  } => !stream.timepoint
+  return %1 : !stream.timepoint
+}
+
+}
@@ -460,6 +460,45 @@ void CommandBufferPushDescriptorSetOp::build(
   state.addOperands(bindingLengths);
 }
 
+//===----------------------------------------------------------------------===//
+// hal.command_buffer.dispatch.batch
+//===----------------------------------------------------------------------===//
+
+LogicalResult CommandBufferDispatchBatchOp::verify() {
+  CommandBufferDispatchBatchOp op = *this;
+  size_t recordCount = op.getRecordCount();
+  if (op.executable_layouts().size() != recordCount ||
+      op.entry_points().size() != recordCount ||
+      op.workgroup_counts().size() != recordCount * 3 ||
+      op.constant_counts().size() != recordCount ||
+      op.sets().size() != recordCount ||
+      op.binding_counts().size() != recordCount) {
+    return op.emitOpError() << "per-record operand and attribute counts must "
+                               "match the record count of "
+                            << recordCount;
+  }
+  size_t totalConstantCount = 0;
+  for (auto count : op.constant_counts().getAsValueRange<IntegerAttr>()) {
+    totalConstantCount += count.getZExtValue();
+  }
+  if (op.constants().size() != totalConstantCount) {
+    return op.emitOpError() << "expected " << totalConstantCount
+                            << " constants but got " << op.constants().size();
+  }
+  size_t totalBindingCount = 0;
+  for (auto count : op.binding_counts().getAsValueRange<IntegerAttr>()) {
+    totalBindingCount += count.getZExtValue();
+  }
+  if (op.binding_ordinals().size() != totalBindingCount ||
+      op.binding_buffers().size() != totalBindingCount ||
+      op.binding_offsets().size() != totalBindingCount ||
+      op.binding_lengths().size() != totalBindingCount) {
+    return op.emitOpError() << "expected " << totalBindingCount
+                            << " bindings in each binding operand group";
+  }
+  return success();
+}
+
 //===----------------------------------------------------------------------===//
 // hal.descriptor_set.create
 //===----------------------------------------------------------------------===//
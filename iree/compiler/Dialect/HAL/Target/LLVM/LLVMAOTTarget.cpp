@@ -6,19 +6,24 @@
 
 #include "iree/compiler/Dialect/HAL/Target/LLVM/LLVMAOTTarget.h"
 
+#include <algorithm>
 #include <cstdlib>
 
 #include "iree-dialects/Dialect/LinalgExt/IR/LinalgExtDialect.h"
 #include "iree-dialects/Dialect/LinalgTransform/LinalgTransformOps.h"
 #include "iree/compiler/Codegen/Dialect/IREECodegenDialect.h"
+#include "iree/compiler/Codegen/LLVMCPU/KernelDispatch.h"
 #include "iree/compiler/Codegen/Passes.h"
 #include "iree/compiler/Dialect/HAL/Target/LLVM/Builtins/Device.h"
 #include "iree/compiler/Dialect/HAL/Target/LLVM/Builtins/Musl.h"
 #include "iree/compiler/Dialect/HAL/Target/LLVM/LLVMIRPasses.h"
 #include "iree/compiler/Dialect/HAL/Target/LLVM/LibraryBuilder.h"
 #include "iree/compiler/Dialect/HAL/Target/LLVM/LinkerTool.h"
+#include "iree/compiler/Dialect/HAL/Target/LLVM/ObjectCache.h"
 #include "iree/compiler/Dialect/HAL/Target/LLVM/StaticLibraryGenerator.h"
 #include "iree/compiler/Dialect/HAL/Target/TargetRegistry.h"
+#include "llvm/ADT/Sequence.h"
+#include "llvm/ADT/StringSwitch.h"
 #include "llvm/Analysis/TargetTransformInfo.h"
 #include "llvm/Bitcode/BitcodeReader.h"
 #include "llvm/Bitcode/BitcodeWriter.h"
@@ -26,11 +31,16 @@
 #include "llvm/IR/Module.h"
 #include "llvm/Linker/Linker.h"
 #include "llvm/Support/FormatVariadic.h"
+#include "llvm/Support/MemoryBuffer.h"
 #include "llvm/Support/TargetSelect.h"
+#include "llvm/Support/raw_ostream.h"
+#include "llvm/Transforms/Utils/Cloning.h"
+#include "llvm/Transforms/Utils/SplitModule.h"
 #include "mlir/Dialect/ArmNeon/ArmNeonDialect.h"
 #include "mlir/Dialect/LLVMIR/LLVMDialect.h"
 #include "mlir/Dialect/PDL/IR/PDL.h"
 #include "mlir/Dialect/PDLInterp/IR/PDLInterp.h"
+#include "mlir/IR/Threading.h"
 #include "mlir/Target/LLVMIR/Dialect/LLVMIR/LLVMToLLVMIRTranslation.h"
 #include "mlir/Target/LLVMIR/Export.h"
 
@@ -136,6 +146,125 @@ static LogicalResult linkBuiltinLibrary(
   return success();
 }
 
+// Returns the iree_hal_processor_v0_t::data[0] bits the runtime must report for
+// code compiled with the additional LLVM |features| to be safe to execute.
+// Fails if any enabled feature cannot be detected by the runtime on the target
+// architecture as we would otherwise risk illegal instructions.
+static FailureOr<uint64_t> getProcessorData0ForFeatures(
+    Location loc, const llvm::Triple &targetTriple, StringRef features) {
+  using X86_64 = LibraryBuilder::ProcessorDataX86_64;
+  using ARM_64 = LibraryBuilder::ProcessorDataARM_64;
+  uint64_t processorData0 = 0;
+  SmallVector<StringRef> featureList;
+  features.split(featureList, ',', /*MaxSplit=*/-1, /*KeepEmpty=*/false);
+  for (auto feature : featureList) {
+    feature = feature.trim();
+    // Disabling features is always safe.
+    if (feature.consume_front("-")) continue;
+    feature.consume_front("+");
+    uint64_t bits = 0;
+    switch (targetTriple.getArch()) {
+      case llvm::Triple::ArchType::x86_64:
+        bits = static_cast<uint64_t>(
+            llvm::StringSwitch<X86_64>(feature)
+                .Case("avx", X86_64::AVX)
+                .Case("avx2", X86_64::AVX2)
+                .Case("fma", X86_64::FMA)
+                .Case("f16c", X86_64::F16C)
+                .Case("avx512f", X86_64::AVX512F)
+                .Case("avx512cd", X86_64::AVX512CD)
+                .Case("avx512vl", X86_64::AVX512VL)
+                .Case("avx512dq", X86_64::AVX512DQ)
+                .Case("avx512bw", X86_64::AVX512BW)
+                .Case("avx512vnni", X86_64::AVX512VNNI)
+                .Case("avx512bf16", X86_64::AVX512BF16)
+                .Case("avxvnni", X86_64::AVXVNNI)
+                .Default(static_cast<X86_64>(0)));
+        break;
+      case llvm::Triple::ArchType::aarch64:
+        bits = static_cast<uint64_t>(
+            llvm::StringSwitch<ARM_64>(feature)
+                .Case("fullfp16", ARM_64::FP16)
+                .Case("dotprod", ARM_64::DOTPROD)
+                .Case("i8mm", ARM_64::I8MM)
+                .Case("bf16", ARM_64::BF16)
+                .Case("sve", ARM_64::SVE)
+                .Case("sve2", ARM_64::SVE2)
+                .Default(static_cast<ARM_64>(0)));
+        break;
+      default:
+        break;
+    }
+    if (!bits) {
+      mlir::emitError(loc) << "CPU feature '" << feature
+                           << "' cannot be detected at runtime on "
+                           << targetTriple.getArchName()
+                           << " and cannot be used in a feature variant";
+      return failure();
+    }
+    processorData0 |= bits;
+  }
+  return processorData0;
+}
+
+// Emits object files for |llvmModule| split into up to |partitionCount|
+// partitions. Each partition is round-tripped through bitcode so that it can
+// be compiled in its own llvm::LLVMContext on the MLIR context thread pool.
+// Objects are returned in partition order so that the output is deterministic
+// regardless of how the work was scheduled. If |objectCache| is provided then
+// partitions identical to ones previously compiled reuse the cached objects.
+//
+// This is the only level at which serialization is parallelized: variants are
+// serialized one at a time and each partition is compiled on a single thread.
+static LogicalResult emitPartitionedObjectFiles(
+    MLIRContext *context, const LLVMTargetOptions &options,
+    const ObjectCache *objectCache, llvm::Module &llvmModule,
+    unsigned partitionCount, SmallVectorImpl<std::string> &objectData) {
+  // Locals are externalized (with hidden visibility) so that partitions can
+  // reference each other; the linker resolves them within the library.
+  SmallVector<SmallString<0>> partitionBitcode;
+  llvm::SplitModule(
+      llvmModule, partitionCount,
+      [&](std::unique_ptr<llvm::Module> partitionModule) {
+        auto &bitcode = partitionBitcode.emplace_back();
+        llvm::raw_svector_ostream os(bitcode);
+        llvm::WriteBitcodeToFile(*partitionModule, os);
+      },
+      /*PreserveLocals=*/false);
+
+  objectData.resize(partitionBitcode.size());
+  auto partitionOrdinals =
+      llvm::to_vector(llvm::seq<size_t>(0, partitionBitcode.size()));
+  return failableParallelForEach(
+      context, partitionOrdinals, [&](size_t ordinal) -> LogicalResult {
+        std::string cacheKey;
+        if (objectCache) {
+          cacheKey = objectCache->getKey(partitionBitcode[ordinal]);
+          if (auto cachedData = objectCache->lookup(cacheKey)) {
+            objectData[ordinal] = std::move(*cachedData);
+            return success();
+          }
+        }
+        llvm::LLVMContext partitionContext;
+        auto partitionModule = llvm::parseBitcodeFile(
+            llvm::MemoryBufferRef(partitionBitcode[ordinal], "partition"),
+            partitionContext);
+        if (!partitionModule) {
+          llvm::consumeError(partitionModule.takeError());
+          return failure();
+        }
+        auto targetMachine = createTargetMachine(options);
+        if (!targetMachine) return failure();
+        if (failed(runEmitObjFilePasses(
+                targetMachine.get(), partitionModule->get(),
+                llvm::CGFT_ObjectFile, &objectData[ordinal]))) {
+          return failure();
+        }
+        if (objectCache) objectCache->insert(cacheKey, objectData[ordinal]);
+        return success();
+      });
+}
+
 class LLVMAOTTargetBackend final : public TargetBackend {
  public:
   explicit LLVMAOTTargetBackend(LLVMTargetOptions options)
@@ -291,6 +420,46 @@ class LLVMAOTTargetBackend final : public TargetBackend {
         }
       } break;
     }
+
+    // Declare the imports used by the executable and resolve the placeholder
+    // ordinals that the conversion to LLVM emitted for them. The import table
+    // must be sorted so ordinals are assigned in symbol name order. Imports
+    // are weak as every call site carries an inline fallback for runtimes
+    // that do not provide them.
+    SmallVector<llvm::GlobalVariable *> importOrdinalGlobals;
+    for (auto &global : llvmModule->globals()) {
+      if (global.getName().startswith(kImportOrdinalGlobalPrefix)) {
+        importOrdinalGlobals.push_back(&global);
+      }
+    }
+    llvm::sort(importOrdinalGlobals,
+               [](llvm::GlobalVariable *lhs, llvm::GlobalVariable *rhs) {
+                 return lhs->getName() < rhs->getName();
+               });
+    for (auto *global : importOrdinalGlobals) {
+      unsigned ordinal = libraryBuilder.addImport(
+          global->getName().drop_front(kImportOrdinalGlobalPrefix.size()),
+          /*weak=*/true);
+      global->setInitializer(llvm::ConstantInt::get(
+          llvm::Type::getInt32Ty(context), static_cast<uint64_t>(ordinal)));
+      global->setConstant(true);
+    }
+
+    // Register each processor variant with the runtime feature bits it
+    // requires. Entry points are cloned per variant below with the additional
+    // features enabled while anything they call stays on the baseline features.
+    SmallVector<std::string> variantFeatures;
+    for (auto &featureVariant : options_.targetCPUFeatureVariants) {
+      auto processorData0 = getProcessorData0ForFeatures(
+          variantOp.getLoc(), targetTriple, featureVariant);
+      if (failed(processorData0)) return failure();
+      libraryBuilder.addProcessorVariant(*processorData0);
+      std::string features = options_.targetCPUFeatures;
+      if (!features.empty()) features += ",";
+      features += featureVariant;
+      variantFeatures.push_back(std::move(features));
+    }
+
     auto align16 = llvm::Attribute::getWithAlignment(context, llvm::Align(16));
     for (auto entryPointOp :
          variantOp.getBlock().getOps<ExecutableEntryPointOp>()) {
@@ -319,9 +488,41 @@ class LLVMAOTTargetBackend final : public TargetBackend {
                                     .getValueOr(APInt(64, 0))
                                     .getSExtValue();
 
+      // Codegen may hint at the order in which workgroups should be executed
+      // to improve cache reuse across concurrently running workgroups.
+      LibraryBuilder::DispatchAttrs dispatchAttrs;
+      dispatchAttrs.localMemorySize = localMemorySize;
+      if (auto tileOrderAttr =
+              entryPointOp->getAttrOfType<StringAttr>(kTileOrderAttrName)) {
+        auto tileOrder =
+            llvm::StringSwitch<Optional<LibraryBuilder::TileOrder>>(
+                tileOrderAttr.getValue())
+                .Case("linear", LibraryBuilder::TileOrder::LINEAR)
+                .Case("morton", LibraryBuilder::TileOrder::MORTON)
+                .Case("super_tile", LibraryBuilder::TileOrder::SUPER_TILE)
+                .Default(llvm::None);
+        if (!tileOrder) {
+          return entryPointOp.emitError()
+                 << "unknown " << kTileOrderAttrName << " '"
+                 << tileOrderAttr.getValue()
+                 << "'; expected linear, morton, or super_tile";
+        }
+        dispatchAttrs.tileOrder = *tileOrder;
+      }
+
+      SmallVector<llvm::Function *> variantFuncs;
+      for (auto features : llvm::enumerate(variantFeatures)) {
+        llvm::ValueToValueMapTy valueMap;
+        auto *variantFunc = llvm::CloneFunction(llvmFunc, valueMap);
+        variantFunc->setName(llvmFunc->getName() + "_variant" +
+                             std::to_string(features.index()));
+        variantFunc->addFnAttr("target-features", features.value());
+        variantFuncs.push_back(variantFunc);
+      }
+
       libraryBuilder.addExport(entryPointOp.getName(), "",
-                               LibraryBuilder::DispatchAttrs{localMemorySize},
-                               llvmFunc);
+                               dispatchAttrs,
+                               llvmFunc, variantFuncs);
     }
 
     auto queryFunctionName = std::string(kQueryFunctionName);
@@ -339,6 +540,10 @@ class LLVMAOTTargetBackend final : public TargetBackend {
         llvm::GlobalValue::LinkageTypes::ExternalLinkage);
     queryLibraryFunc->setDSOLocal(false);
 
+    if (options_.printLibraryIR) {
+      llvmModule->print(llvm::errs(), /*AAW=*/nullptr);
+    }
+
     // If linking dynamically, find a suitable linker tool and configure the
     // module with any options that tool requires.
     std::unique_ptr<LinkerTool> linkerTool;
@@ -398,56 +603,43 @@ class LLVMAOTTargetBackend final : public TargetBackend {
     auto *llvmIdent = llvmModule->getNamedMetadata("llvm.ident");
     if (llvmIdent) llvmIdent->clearOperands();
 
-    // LLVM opt passes that perform code generation optimizations/transformation
-    // similar to what a frontend would do.
-    if (failed(
-            runLLVMIRPasses(options_, targetMachine.get(), llvmModule.get()))) {
-      return variantOp.emitError()
-             << "failed to run LLVM-IR opt passes for IREE::HAL::ExecutableOp "
-                "targeting '"
-             << options_.targetTriple << "'";
-    }
-
-    // Fixup visibility from any symbols we may link in - we want to hide all
-    // but the query entry point.
-    for (auto &func : *llvmModule) {
-      if (&func == queryLibraryFunc) {
-        // Leave our library query function as public/external so that it is
-        // exported from shared objects and available for linking in static
-        // objects.
-        continue;
-      } else if (func.isDeclaration()) {
-        // Declarations must have their original visibility/linkage; they most
-        // often come from declared llvm builtin ops (llvm.memcpy/etc).
-        continue;
+    // Reuse the object files produced by a previous compilation of an
+    // identical module if available. This skips both optimization and code
+    // generation. Artifacts require the optimized module and bypass this.
+    std::unique_ptr<ObjectCache> objectCache;
+    if (!options_.objectCachePath.empty()) {
+      objectCache = ObjectCache::open(options_.objectCachePath, options_);
+      if (!objectCache) {
+        mlir::emitWarning(variantOp.getLoc())
+            << "unable to open object cache at '" << options_.objectCachePath
+            << "'; compiling without it";
       }
-      func.setDSOLocal(true);
-      func.setLinkage(llvm::GlobalValue::LinkageTypes::InternalLinkage);
     }
-    for (auto &global : llvmModule->getGlobalList()) {
-      global.setDSOLocal(true);
-      global.setLinkage(llvm::GlobalValue::LinkageTypes::InternalLinkage);
+    std::string moduleCacheKey;
+    SmallVector<std::string> objectData;
+    if (objectCache && !options_.keepLinkerArtifacts) {
+      moduleCacheKey = objectCache->getKey(*llvmModule);
+      objectCache->lookupAll(moduleCacheKey, objectData);
+    }
+    if (objectData.empty()) {
+      if (failed(emitObjectFiles(variantOp, targetMachine.get(),
+                                 objectCache.get(), queryLibraryFunc,
+                                 *llvmModule, objectData))) {
+        return failure();
+      }
+      if (!moduleCacheKey.empty()) {
+        objectCache->insertAll(moduleCacheKey, objectData);
+      }
     }
 
+    // Emit the object files containing the bulk of our code.
+    // These must come first such that we have the proper library linking
+    // order.
     SmallVector<Artifact> objectFiles;
-
-    // Emit the base object file containing the bulk of our code.
-    // This must come first such that we have the proper library linking order.
-    {
-      // NOTE: today we just use a single object file, however if we wanted to
-      // scale code generation and linking we'd want to generate one per
-      // function (or something like that). A single object file is also
-      // instrumental to static library generation (which only supports one
-      // object file per library).
-      std::string objectData;
-      if (failed(runEmitObjFilePasses(targetMachine.get(), llvmModule.get(),
-                                      llvm::CGFT_ObjectFile, &objectData))) {
-        return variantOp.emitError()
-               << "failed to compile LLVM-IR module to an object file";
-      }
+    for (auto &partitionData : objectData) {
       auto objectFile = Artifact::createTemporary(libraryName, "o");
       auto &os = objectFile.outputFile->os();
-      os << objectData;
+      os << partitionData;
       os.flush();
       os.close();
       objectFiles.push_back(std::move(objectFile));
@@ -491,6 +683,83 @@ class LLVMAOTTargetBackend final : public TargetBackend {
     }
   }
 
+  // Optimizes |llvmModule| and generates the object files for it.
+  LogicalResult emitObjectFiles(IREE::HAL::ExecutableVariantOp variantOp,
+                                llvm::TargetMachine *targetMachine,
+                                const ObjectCache *objectCache,
+                                llvm::Function *queryLibraryFunc,
+                                llvm::Module &llvmModule,
+                                SmallVectorImpl<std::string> &objectData) {
+    // LLVM opt passes that perform code generation optimizations/transformation
+    // similar to what a frontend would do.
+    if (failed(runLLVMIRPasses(options_, targetMachine, &llvmModule))) {
+      return variantOp.emitError()
+             << "failed to run LLVM-IR opt passes for IREE::HAL::ExecutableOp "
+                "targeting '"
+             << options_.targetTriple << "'";
+    }
+
+    // Fixup visibility from any symbols we may link in - we want to hide all
+    // but the query entry point.
+    for (auto &func : llvmModule) {
+      if (&func == queryLibraryFunc) {
+        // Leave our library query function as public/external so that it is
+        // exported from shared objects and available for linking in static
+        // objects.
+        continue;
+      } else if (func.isDeclaration()) {
+        // Declarations must have their original visibility/linkage; they most
+        // often come from declared llvm builtin ops (llvm.memcpy/etc).
+        continue;
+      }
+      func.setDSOLocal(true);
+      func.setLinkage(llvm::GlobalValue::LinkageTypes::InternalLinkage);
+    }
+    for (auto &global : llvmModule.getGlobalList()) {
+      global.setDSOLocal(true);
+      global.setLinkage(llvm::GlobalValue::LinkageTypes::InternalLinkage);
+    }
+
+    // Code generation dominates compilation time once all executables have
+    // been linked into a single library and so we split the module and
+    // generate the partitions in parallel. Static library generation only
+    // supports one object file per library and must use a single partition.
+    unsigned partitionCount =
+        options_.linkStatic ? 1 : options_.codegenPartitionCount;
+    unsigned definedFunctionCount =
+        llvm::count_if(llvmModule, [](llvm::Function &func) {
+          return !func.isDeclaration();
+        });
+    partitionCount = std::min(partitionCount, definedFunctionCount);
+    if (partitionCount > 1) {
+      if (failed(emitPartitionedObjectFiles(variantOp.getContext(), options_,
+                                            objectCache, llvmModule,
+                                            partitionCount, objectData))) {
+        return variantOp.emitError()
+               << "failed to compile LLVM-IR module partitions to object "
+                  "files";
+      }
+      return success();
+    }
+
+    std::string cacheKey;
+    if (objectCache) {
+      cacheKey = objectCache->getKey(llvmModule);
+      if (auto cachedData = objectCache->lookup(cacheKey)) {
+        objectData.push_back(std::move(*cachedData));
+        return success();
+      }
+    }
+    auto &singleData = objectData.emplace_back();
+    if (failed(runEmitObjFilePasses(targetMachine, &llvmModule,
+                                    llvm::CGFT_ObjectFile, &singleData))) {
+      return variantOp.emitError()
+             << "failed to compile LLVM-IR module to an object file";
+    }
+    if (objectCache) objectCache->insert(cacheKey, singleData);
+    return success();
+  }
+
   LogicalResult serializeStaticLibraryExecutable(
       IREE::HAL::ExecutableVariantOp variantOp, OpBuilder &executableBuilder,
       const std::string &libraryName, const std::string &queryFunctionName,
@@ -6,9 +6,12 @@
 
 #include "iree/compiler/Dialect/HAL/Target/LLVM/LLVMTargetOptions.h"
 
+#include <algorithm>
 #include <mutex>
 
 #include "llvm/ADT/APFloat.h"
+#include "llvm/ADT/SmallVector.h"
+#include "llvm/ADT/StringRef.h"
 #include "llvm/ADT/Triple.h"
 #include "llvm/MC/SubtargetFeature.h"
 #include "llvm/MC/TargetRegistry.h"
@@ -76,6 +79,14 @@ LLVMTargetOptions getLLVMTargetOptionsFromFlags() {
       llvm::cl::desc("LLVM target machine CPU features; use 'host' for your "
                      "host native CPU"),
       llvm::cl::init(""));
+  static llvm::cl::opt<std::string> clTargetCPUFeatureVariants(
+      "iree-llvm-target-cpu-feature-variants",
+      llvm::cl::desc(
+          "Semicolon-separated list of LLVM CPU feature sets to produce "
+          "additional entry point variants for; the best variant supported by "
+          "the processor is selected at load time "
+          "(e.g. '+avx512f,+avx512vnni;+avx2,+fma')"),
+      llvm::cl::init(""));
 
   static llvm::cl::opt<bool> llvmLoopInterleaving(
       "iree-llvm-loop-interleaving", llvm::cl::init(false),
@@ -98,6 +109,13 @@ LLVMTargetOptions getLLVMTargetOptionsFromFlags() {
   if (clTargetCPUFeatures != "host") {
     targetOptions.targetCPUFeatures = clTargetCPUFeatures;
   }
+  llvm::SmallVector<llvm::StringRef> featureVariants;
+  llvm::StringRef(clTargetCPUFeatureVariants)
+      .split(featureVariants, ';', /*MaxSplit=*/-1, /*KeepEmpty=*/false);
+  for (auto featureVariant : featureVariants) {
+    targetOptions.targetCPUFeatureVariants.push_back(
+        featureVariant.trim().str());
+  }
 
   // LLVM opt options.
   targetOptions.pipelineTuningOptions.LoopInterleaving = llvmLoopInterleaving;
@@ -193,6 +211,29 @@ LLVMTargetOptions getLLVMTargetOptionsFromFlags() {
       llvm::cl::init(targetOptions.keepLinkerArtifacts));
   targetOptions.keepLinkerArtifacts = clKeepLinkerArtifacts;
 
+  static llvm::cl::opt<bool> clPrintLibraryIR(
+      "iree-llvm-print-library-ir",
+      llvm::cl::desc("Prints the LLVM IR of each executable library to stderr "
+                     "before it is optimized"),
+      llvm::cl::init(targetOptions.printLibraryIR));
+  targetOptions.printLibraryIR = clPrintLibraryIR;
+
+  static llvm::cl::opt<unsigned> clCodegenPartitions(
+      "iree-llvm-codegen-partitions",
+      llvm::cl::desc("Splits each executable library into up to this many "
+                     "partitions that are compiled to object files in "
+                     "parallel. 1 compiles the library as a single object."),
+      llvm::cl::init(targetOptions.codegenPartitionCount));
+  targetOptions.codegenPartitionCount =
+      std::max(1u, clCodegenPartitions.getValue());
+
+  static llvm::cl::opt<std::string> clObjectCacheDir(
+      "iree-llvm-object-cache-dir",
+      llvm::cl::desc("Directory used to cache generated object files across "
+                     "compilations. Disabled if empty."),
+      llvm::cl::init(""));
+  targetOptions.objectCachePath = clObjectCacheDir;
+
   static llvm::cl::opt<std::string> clStaticLibraryOutputPath(
       "iree-llvm-static-library-output-path",
       llvm::cl::desc(
@@ -7,6 +7,9 @@
 #ifndef IREE_COMPILER_DIALECT_HAL_TARGET_LLVM_LLVMTARGETOPTIONS_H_
 #define IREE_COMPILER_DIALECT_HAL_TARGET_LLVM_LLVMTARGETOPTIONS_H_
 
+#include <string>
+#include <vector>
+
 #include "llvm/Passes/PassBuilder.h"
 #include "llvm/Target/TargetOptions.h"
 
@@ -29,6 +32,13 @@ struct LLVMTargetOptions {
   std::string targetCPU;
   std::string targetCPUFeatures;
 
+  // Additional CPU feature sets to produce multi-versioned entry points for.
+  // Each entry is an LLVM feature string (`+avx512f,+avx512vnni`) added on top
+  // of |targetCPUFeatures|. At runtime the library selects the first variant
+  // whose features are all reported by the processor and otherwise falls back
+  // to the baseline entry points.
+  std::vector<std::string> targetCPUFeatureVariants;
+
   llvm::PipelineTuningOptions pipelineTuningOptions;
   llvm::OptimizationLevel optLevel;
   llvm::TargetOptions options;
@@ -66,6 +76,20 @@ struct LLVMTargetOptions {
   // True to keep linker artifacts for debugging.
   bool keepLinkerArtifacts = false;
 
+  // True to print the LLVM IR of each library to stderr once its tables and
+  // query function have been built and before it is optimized.
+  bool printLibraryIR = false;
+
+  // Maximum number of partitions each library module is split into for code
+  // generation. Partitions are compiled in parallel and linked together. The
+  // output depends only on this value and not on the number of threads used.
+  unsigned codegenPartitionCount = 16;
+
+  // Directory used to cache object files across compiler invocations. Object
+  // files are keyed by the LLVM module they are generated from and reused when
+  // identical modules are compiled again. Disabled if empty.
+  std::string objectCachePath;
+
   // Build for IREE static library loading using this output path for
   // a "{staticLibraryOutput}.o" object file and "{staticLibraryOutput}.h"
   // header file.
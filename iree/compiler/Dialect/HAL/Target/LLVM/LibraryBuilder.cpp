@@ -105,19 +105,22 @@ static llvm::FunctionType *makeDispatchFunctionType(
 
 // %struct.iree_hal_executable_dispatch_attrs_v0_t = type {
 //   i16,
-//   i16
+//   i8,
+//   i8
 // }
 static llvm::StructType *makeDispatchAttrsType(llvm::LLVMContext &context) {
   if (auto *existingType = llvm::StructType::getTypeByName(
           context, "iree_hal_executable_dispatch_attrs_v0_t")) {
     return existingType;
   }
+  auto *i8Type = llvm::IntegerType::getInt8Ty(context);
   auto *i16Type = llvm::IntegerType::getInt16Ty(context);
   auto *type =
       llvm::StructType::create(context,
                                {
                                    i16Type,
-                                   i16Type,
+                                   i8Type,
+                                   i8Type,
                                },
                                "iree_hal_executable_dispatch_attrs_v0_t",
                                /*isPacked=*/false);
@@ -278,13 +281,45 @@ llvm::Function *LibraryBuilder::build(StringRef queryFuncName) {
   // Build out the header for each version and select it at runtime.
   // NOTE: today there is just one version so this is rather simple:
   //   return max_version == 0 ? &library : NULL;
-  auto *v0 = buildLibraryV0((queryFuncName + "_v0").str());
+  auto v0Libraries = buildLibraryV0((queryFuncName + "_v0").str());
+  llvm::Value *v0 =
+      builder.CreatePointerCast(v0Libraries.front(),
+                                libraryHeaderType->getPointerTo());
+  if (!variants.empty()) {
+    // Select the first processor variant whose required features are all
+    // available in environment->processor.data[0], falling back to the
+    // baseline library:
+    //   data0 = environment->processor.data[0];
+    //   library = (data0 & mask0) == mask0 ? &library_0 :
+    //             (data0 & mask1) == mask1 ? &library_1 : ... : &library;
+    auto *i64Type = llvm::IntegerType::getInt64Ty(context);
+    auto *data0Ptr = builder.CreateInBoundsGEP(
+        makeEnvironmentType(context), func->getArg(1),
+        {
+            llvm::ConstantInt::get(i32Type, 0),
+            // iree_hal_executable_environment_v0_t::processor
+            llvm::ConstantInt::get(i32Type, 3),
+            // iree_hal_processor_v0_t::data
+            llvm::ConstantInt::get(i32Type, 0),
+            llvm::ConstantInt::get(i32Type, 0),
+        },
+        "processor_data0_ptr");
+    auto *data0 = builder.CreateAlignedLoad(i64Type, data0Ptr, llvm::Align(8),
+                                            "processor_data0");
+    for (int i = static_cast<int>(variants.size()) - 1; i >= 0; --i) {
+      auto *mask = llvm::ConstantInt::get(i64Type, variants[i].processorData0);
+      v0 = builder.CreateSelect(
+          builder.CreateICmpEQ(builder.CreateAnd(data0, mask), mask),
+          builder.CreatePointerCast(v0Libraries[i + 1],
+                                    libraryHeaderType->getPointerTo()),
+          v0);
+    }
+  }
   builder.CreateRet(builder.CreateSelect(
       builder.CreateICmpEQ(func->getArg(0),
                            llvm::ConstantInt::get(
                                i32Type, static_cast<int64_t>(Version::V_0_1))),
-      builder.CreatePointerCast(v0, libraryHeaderType->getPointerTo()),
-      llvm::ConstantPointerNull::get(libraryHeaderType->getPointerTo())));
+      v0, llvm::ConstantPointerNull::get(libraryHeaderType->getPointerTo())));
 
   return func;
 }
@@ -328,7 +363,7 @@ llvm::Constant *LibraryBuilder::buildLibraryV0ImportTable(
                        });
 }
 
-llvm::Constant *LibraryBuilder::buildLibraryV0ExportTable(
+SmallVector<llvm::Constant *> LibraryBuilder::buildLibraryV0ExportTables(
     std::string libraryName) {
   auto &context = module->getContext();
   auto *exportTableType = makeExportTableType(context);
@@ -340,29 +375,40 @@ llvm::Constant *LibraryBuilder::buildLibraryV0ExportTable(
   llvm::Constant *zero = llvm::ConstantInt::get(i32Type, 0);
 
   // iree_hal_executable_export_table_v0_t::ptrs
-  SmallVector<llvm::Constant *, 4> exportPtrValues;
-  for (auto dispatch : exports) {
-    exportPtrValues.push_back(dispatch.func);
+  // The baseline functions come first followed by one table per variant.
+  SmallVector<llvm::Constant *> exportPtrsList;
+  for (int variantOrdinal = -1;
+       variantOrdinal < static_cast<int>(variants.size()); ++variantOrdinal) {
+    SmallVector<llvm::Constant *, 4> exportPtrValues;
+    for (auto dispatch : exports) {
+      exportPtrValues.push_back(variantOrdinal < 0
+                                    ? dispatch.func
+                                    : dispatch.variantFuncs[variantOrdinal]);
+    }
+    auto *exportPtrsType = llvm::ArrayType::get(
+        dispatchFunctionType->getPointerTo(), exportPtrValues.size());
+    std::string exportPtrsName = libraryName + "_funcs";
+    if (variantOrdinal >= 0) {
+      exportPtrsName += "_variant" + std::to_string(variantOrdinal);
+    }
+    llvm::Constant *exportPtrs = new llvm::GlobalVariable(
+        *module, exportPtrsType, /*isConstant=*/true,
+        llvm::GlobalVariable::PrivateLinkage,
+        llvm::ConstantArray::get(exportPtrsType, exportPtrValues),
+        /*Name=*/exportPtrsName);
+    // TODO(benvanik): force alignment (16? natural pointer width *2?)
+    exportPtrsList.push_back(llvm::ConstantExpr::getInBoundsGetElementPtr(
+        exportPtrsType, exportPtrs, ArrayRef<llvm::Constant *>{zero, zero}));
   }
-  auto *exportPtrsType = llvm::ArrayType::get(
-      dispatchFunctionType->getPointerTo(), exportPtrValues.size());
-  llvm::Constant *exportPtrs = new llvm::GlobalVariable(
-      *module, exportPtrsType, /*isConstant=*/true,
-      llvm::GlobalVariable::PrivateLinkage,
-      llvm::ConstantArray::get(exportPtrsType, exportPtrValues),
-      /*Name=*/libraryName + "_funcs");
-  // TODO(benvanik): force alignment (16? natural pointer width *2?)
-  exportPtrs = llvm::ConstantExpr::getInBoundsGetElementPtr(
-      exportPtrsType, exportPtrs, ArrayRef<llvm::Constant *>{zero, zero});
 
   // iree_hal_executable_export_table_v0_t::attrs
   llvm::Constant *exportAttrs =
-      llvm::Constant::getNullValue(i32Type->getPointerTo());
+      llvm::Constant::getNullValue(dispatchAttrsType->getPointerTo());
   bool hasNonDefaultAttrs =
       llvm::find_if(exports, [](const Dispatch &dispatch) {
         return !dispatch.attrs.isDefault();
       }) != exports.end();
-  if (!hasNonDefaultAttrs) {
+  if (hasNonDefaultAttrs) {
     SmallVector<llvm::Constant *, 4> exportAttrValues;
     for (auto dispatch : exports) {
       exportAttrValues.push_back(llvm::ConstantStruct::get(
@@ -373,8 +419,11 @@ llvm::Constant *LibraryBuilder::buildLibraryV0ExportTable(
                   i16Type, RoundUpToAlignment(dispatch.attrs.localMemorySize,
                                               kWorkgroupLocalMemoryPageSize) /
                                kWorkgroupLocalMemoryPageSize),
+              // tile_order=
+              llvm::ConstantInt::get(
+                  i8Type, static_cast<uint8_t>(dispatch.attrs.tileOrder)),
               // reserved=
-              llvm::ConstantInt::get(i16Type, 0),
+              llvm::ConstantInt::get(i8Type, 0),
           }));
     }
     auto *exportAttrsType =
@@ -429,19 +478,23 @@ llvm::Constant *LibraryBuilder::buildLibraryV0ExportTable(
         exportTagsType, global, ArrayRef<llvm::Constant *>{zero, zero});
   }
 
-  return llvm::ConstantStruct::get(
-      exportTableType, {
-                           // count=
-                           llvm::ConstantInt::get(i32Type, exports.size()),
-                           // ptrs=
-                           exportPtrs,
-                           // attrs=
-                           exportAttrs,
-                           // names=
-                           exportNames,
-                           // tags=
-                           exportTags,
-                       });
+  SmallVector<llvm::Constant *> exportTables;
+  for (auto *exportPtrs : exportPtrsList) {
+    exportTables.push_back(llvm::ConstantStruct::get(
+        exportTableType, {
+                             // count=
+                             llvm::ConstantInt::get(i32Type, exports.size()),
+                             // ptrs=
+                             exportPtrs,
+                             // attrs=
+                             exportAttrs,
+                             // names=
+                             exportNames,
+                             // tags=
+                             exportTags,
+                         }));
+  }
+  return exportTables;
 }
 
 llvm::Constant *LibraryBuilder::buildLibraryV0ConstantTable(
@@ -457,7 +510,8 @@ llvm::Constant *LibraryBuilder::buildLibraryV0ConstantTable(
                          });
 }
 
-llvm::Constant *LibraryBuilder::buildLibraryV0(std::string libraryName) {
+SmallVector<llvm::Constant *> LibraryBuilder::buildLibraryV0(
+    std::string libraryName) {
   auto &context = module->getContext();
   auto *libraryHeaderType = makeLibraryHeaderType(context);
   auto *libraryType = makeLibraryType(libraryHeaderType);
@@ -487,24 +541,36 @@ llvm::Constant *LibraryBuilder::buildLibraryV0(std::string libraryName) {
 
   // ----- Library -----
 
-  auto *library = new llvm::GlobalVariable(
-      *module, libraryType, /*isConstant=*/true,
-      llvm::GlobalVariable::PrivateLinkage,
-      llvm::ConstantStruct::get(libraryType,
-                                {
-                                    // header=
-                                    libraryHeader,
-                                    // imports=
-                                    buildLibraryV0ImportTable(libraryName),
-                                    // exports=
-                                    buildLibraryV0ExportTable(libraryName),
-                                    // constants=
-                                    buildLibraryV0ConstantTable(libraryName),
-                                }),
-      /*Name=*/libraryName);
-  // TODO(benvanik): force alignment (8? natural pointer width?)
-
-  return library;
+  // Processor variants only differ in their export function pointers and
+  // share all other tables with the baseline library.
+  auto *importTable = buildLibraryV0ImportTable(libraryName);
+  auto *constantTable = buildLibraryV0ConstantTable(libraryName);
+  SmallVector<llvm::Constant *> libraries;
+  for (auto exportTable : llvm::enumerate(
+           buildLibraryV0ExportTables(libraryName))) {
+    std::string variantName = libraryName;
+    if (exportTable.index() > 0) {
+      variantName += "_variant" + std::to_string(exportTable.index() - 1);
+    }
+    auto *library = new llvm::GlobalVariable(
+        *module, libraryType, /*isConstant=*/true,
+        llvm::GlobalVariable::PrivateLinkage,
+        llvm::ConstantStruct::get(libraryType,
+                                  {
+                                      // header=
+                                      libraryHeader,
+                                      // imports=
+                                      importTable,
+                                      // exports=
+                                      exportTable.value(),
+                                      // constants=
+                                      constantTable,
+                                  }),
+        /*Name=*/variantName);
+    // TODO(benvanik): force alignment (8? natural pointer width?)
+    libraries.push_back(library);
+  }
+  return libraries;
 }
 
 }  // namespace HAL
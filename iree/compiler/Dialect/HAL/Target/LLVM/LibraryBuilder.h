@@ -74,16 +74,54 @@ class LibraryBuilder {
     UNDEFINED = 4u,
   };
 
+  // IREE_HAL_PROCESSOR_DATA0_X86_64_* bits in iree_hal_processor_v0_t.
+  enum class ProcessorDataX86_64 : uint64_t {
+    AVX = 1ull << 0,
+    AVX2 = 1ull << 1,
+    FMA = 1ull << 2,
+    F16C = 1ull << 3,
+    AVX512F = 1ull << 4,
+    AVX512CD = 1ull << 5,
+    AVX512VL = 1ull << 6,
+    AVX512DQ = 1ull << 7,
+    AVX512BW = 1ull << 8,
+    AVX512VNNI = 1ull << 9,
+    AVX512BF16 = 1ull << 10,
+    AVXVNNI = 1ull << 11,
+  };
+
+  // IREE_HAL_PROCESSOR_DATA0_ARM_64_* bits in iree_hal_processor_v0_t.
+  enum class ProcessorDataARM_64 : uint64_t {
+    FP16 = 1ull << 0,
+    DOTPROD = 1ull << 1,
+    I8MM = 1ull << 2,
+    BF16 = 1ull << 3,
+    SVE = 1ull << 4,
+    SVE2 = 1ull << 5,
+  };
+
   // IREE_HAL_WORKGROUP_LOCAL_MEMORY_PAGE_SIZE
   static const int64_t kWorkgroupLocalMemoryPageSize = 4096;
 
+  // iree_hal_executable_tile_order_t
+  enum class TileOrder : uint8_t {
+    LINEAR = 0,
+    MORTON = 1,
+    SUPER_TILE = 2,
+  };
+
   // iree_hal_executable_dispatch_attrs_v0_t
   struct DispatchAttrs {
     // Required workgroup local memory size, in bytes.
     int64_t localMemorySize = 0;
 
+    // Preferred order in which the runtime executes workgroups.
+    TileOrder tileOrder = TileOrder::LINEAR;
+
     // True if all values are default and the attributes may be omitted.
-    constexpr bool isDefault() const { return localMemorySize == 0; }
+    constexpr bool isDefault() const {
+      return localMemorySize == 0 && tileOrder == TileOrder::LINEAR;
+    }
   };
 
   LibraryBuilder(llvm::Module *module, Mode mode,
@@ -109,12 +147,28 @@ class LibraryBuilder {
     return imports.size() - 1;
   }
 
+  // Defines a processor-specific variant of the export table that is selected
+  // at runtime when all bits in |processorData0| are set in the
+  // iree_hal_processor_v0_t::data[0] field of the executable environment.
+  // Variants are checked in the order they are added and the first matching
+  // one is used; if none match then the baseline export functions are used.
+  // Returns the variant ordinal used to index the |variantFuncs| of exports.
+  unsigned addProcessorVariant(uint64_t processorData0) {
+    variants.push_back({processorData0});
+    return variants.size() - 1;
+  }
+
   // Defines a new entry point on the library implemented by |func|.
   // |name| will be used as the library export and an optional |tag| will be
-  // attached.
+  // attached. If processor variants have been added then |variantFuncs| must
+  // contain one implementation of the entry point per variant.
   void addExport(StringRef name, StringRef tag, DispatchAttrs attrs,
-                 llvm::Function *func) {
-    exports.push_back({name.str(), tag.str(), attrs, func});
+                 llvm::Function *func,
+                 ArrayRef<llvm::Function *> variantFuncs = {}) {
+    assert(variantFuncs.size() == variants.size() &&
+           "one function required per processor variant");
+    exports.push_back({name.str(), tag.str(), attrs, func,
+                       llvm::to_vector<2>(variantFuncs)});
   }
 
   // TODO(benvanik): addConstant for registering constant values.
@@ -130,10 +184,14 @@ class LibraryBuilder {
   llvm::Function *build(StringRef queryFuncName);
 
  private:
-  // Builds and returns an iree_hal_executable_library_v0_t global constant.
-  llvm::Constant *buildLibraryV0(std::string libraryName);
+  // Builds and returns iree_hal_executable_library_v0_t global constants.
+  // The first is the baseline library followed by one per processor variant.
+  SmallVector<llvm::Constant *> buildLibraryV0(std::string libraryName);
   llvm::Constant *buildLibraryV0ImportTable(std::string libraryName);
-  llvm::Constant *buildLibraryV0ExportTable(std::string libraryName);
+  // Builds the export tables for the baseline functions followed by one per
+  // processor variant. All tables share the same attrs/names/tags.
+  SmallVector<llvm::Constant *> buildLibraryV0ExportTables(
+      std::string libraryName);
   llvm::Constant *buildLibraryV0ConstantTable(std::string libraryName);
 
   llvm::Module *module = nullptr;
@@ -153,9 +211,17 @@ class LibraryBuilder {
     std::string tag;
     DispatchAttrs attrs;
     llvm::Function *func;
+    // One function per processor variant, 1:1 with |variants|.
+    SmallVector<llvm::Function *, 2> variantFuncs;
   };
   SmallVector<Dispatch> exports;
 
+  struct ProcessorVariant {
+    // Required iree_hal_processor_v0_t::data[0] bits.
+    uint64_t processorData0 = 0;
+  };
+  SmallVector<ProcessorVariant> variants;
+
   size_t constantCount = 0;
 };
 
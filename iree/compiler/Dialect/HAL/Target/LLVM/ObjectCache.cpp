@@ -0,0 +1,163 @@
+// Copyright 2022 The IREE Authors
+//
+// Licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+#include "iree/compiler/Dialect/HAL/Target/LLVM/ObjectCache.h"
+
+#include "llvm/ADT/SmallString.h"
+#include "llvm/ADT/StringExtras.h"
+#include "llvm/Bitcode/BitcodeWriter.h"
+#include "llvm/Config/llvm-config.h"
+#include "llvm/Support/FileSystem.h"
+#include "llvm/Support/MemoryBuffer.h"
+#include "llvm/Support/Path.h"
+#include "llvm/Support/SHA1.h"
+#include "llvm/Support/VCSRevision.h"
+#include "llvm/Support/raw_ostream.h"
+
+namespace mlir {
+namespace iree_compiler {
+namespace IREE {
+namespace HAL {
+
+// Bump when the entry format or the contents of the fingerprint change.
+static constexpr char kCacheVersion[] = "iree-llvm-object-cache-v2";
+
+// Returns a string uniquely identifying all configuration that is not already
+// captured in the module bitcode. Whole-library keys are computed before the
+// LLVM IR optimization pipeline runs so this must include everything that
+// influences it in addition to the target machine configuration.
+static std::string getOptionsFingerprint(const LLVMTargetOptions &options) {
+  std::string fingerprint;
+  llvm::raw_string_ostream os(fingerprint);
+  os << kCacheVersion << "\n";
+  // The version string doesn't change across integrates of LLVM at head so the
+  // revision (when known) is included as well.
+  os << "llvm:" << LLVM_VERSION_STRING << "\n";
+#if defined(LLVM_REPOSITORY) && defined(LLVM_REVISION)
+  os << "llvm-revision:" << LLVM_REPOSITORY << "@" << LLVM_REVISION << "\n";
+#elif defined(LLVM_REVISION)
+  os << "llvm-revision:" << LLVM_REVISION << "\n";
+#endif  // LLVM_REVISION
+  os << "triple:" << options.targetTriple << "\n";
+  os << "cpu:" << options.targetCPU << "\n";
+  os << "features:" << options.targetCPUFeatures << "\n";
+  for (auto &featureVariant : options.targetCPUFeatureVariants) {
+    os << "variant:" << featureVariant << "\n";
+  }
+  os << "opt:" << options.optLevel.getSpeedupLevel() << ","
+     << options.optLevel.getSizeLevel() << "\n";
+  const auto &pto = options.pipelineTuningOptions;
+  os << "pipeline:" << pto.LoopInterleaving << pto.LoopVectorization
+     << pto.SLPVectorization << pto.LoopUnrolling
+     << pto.ForgetAllSCEVInLoopUnroll << pto.CallGraphProfile
+     << pto.MergeFunctions << "," << pto.LicmMssaOptCap << ","
+     << pto.LicmMssaNoAccForPromotionCap << "\n";
+  const auto &to = options.options;
+  os << "fp-math:" << to.UnsafeFPMath << to.NoInfsFPMath << to.NoNaNsFPMath
+     << to.NoTrappingFPMath << to.NoSignedZerosFPMath << to.ApproxFuncFPMath
+     << to.HonorSignDependentRoundingFPMathOption << ","
+     << static_cast<int>(to.AllowFPOpFusion) << "\n";
+  os << "float-abi:" << static_cast<int>(to.FloatABIType) << "\n";
+  os << "abi:" << to.MCOptions.ABIName << "\n";
+  os << "debug:" << options.debugSymbols << "\n";
+  os << "sanitizer:" << static_cast<int>(options.sanitizerKind) << "\n";
+  os << "embedded:" << options.linkEmbedded << "\n";
+  os << "static:" << options.linkStatic << "\n";
+  return os.str();
+}
+
+// static
+std::unique_ptr<ObjectCache> ObjectCache::open(
+    llvm::StringRef path, const LLVMTargetOptions &options) {
+  if (llvm::sys::fs::create_directories(path)) return nullptr;
+  return std::unique_ptr<ObjectCache>(
+      new ObjectCache(path.str(), getOptionsFingerprint(options)));
+}
+
+std::string ObjectCache::getKey(llvm::StringRef bitcode) const {
+  std::string keyData = optionsFingerprint;
+  keyData.append(bitcode.begin(), bitcode.end());
+  auto hash = llvm::SHA1::hash(llvm::arrayRefFromStringRef(keyData));
+  return llvm::toHex(hash, /*LowerCase=*/true);
+}
+
+std::string ObjectCache::getKey(const llvm::Module &module) const {
+  llvm::SmallString<0> bitcode;
+  llvm::raw_svector_ostream os(bitcode);
+  llvm::WriteBitcodeToFile(module, os);
+  return getKey(bitcode);
+}
+
+std::string ObjectCache::getEntryPath(llvm::StringRef key) const {
+  llvm::SmallString<256> entryPath(path);
+  llvm::sys::path::append(entryPath, key + ".o");
+  return entryPath.str().str();
+}
+
+llvm::Optional<std::string> ObjectCache::lookup(llvm::StringRef key) const {
+  auto fileOr = llvm::MemoryBuffer::getFile(getEntryPath(key),
+                                            /*IsText=*/false,
+                                            /*RequiresNullTerminator=*/false);
+  if (!fileOr) return llvm::None;
+  return fileOr.get()->getBuffer().str();
+}
+
+void ObjectCache::insert(llvm::StringRef key,
+                         llvm::StringRef objectData) const {
+  // Write to a unique temporary file and rename it into place so that readers
+  // (including other compiler processes) never observe partial entries.
+  int fd = -1;
+  llvm::SmallString<256> tempPath;
+  if (llvm::sys::fs::createUniqueFile(getEntryPath(key) + ".%%%%%%%%.tmp", fd,
+                                      tempPath)) {
+    return;
+  }
+  {
+    llvm::raw_fd_ostream os(fd, /*shouldClose=*/true);
+    os << objectData;
+    os.close();
+    if (os.has_error()) {
+      os.clear_error();
+      llvm::sys::fs::remove(tempPath);
+      return;
+    }
+  }
+  if (llvm::sys::fs::rename(tempPath, getEntryPath(key))) {
+    llvm::sys::fs::remove(tempPath);
+  }
+}
+
+bool ObjectCache::lookupAll(llvm::StringRef key,
+                            llvm::SmallVectorImpl<std::string> &objects) const {
+  // The manifest is only written once all of the objects have been so its
+  // presence indicates the set is complete.
+  auto manifest = lookup(key);
+  unsigned count = 0;
+  if (!manifest || llvm::StringRef(*manifest).getAsInteger(10, count)) {
+    return false;
+  }
+  llvm::SmallVector<std::string> foundObjects;
+  for (unsigned i = 0; i < count; ++i) {
+    auto object = lookup((key + "-" + std::to_string(i)).str());
+    if (!object) return false;
+    foundObjects.push_back(std::move(*object));
+  }
+  objects.assign(foundObjects.begin(), foundObjects.end());
+  return !objects.empty();
+}
+
+void ObjectCache::insertAll(llvm::StringRef key,
+                            llvm::ArrayRef<std::string> objects) const {
+  for (auto object : llvm::enumerate(objects)) {
+    insert((key + "-" + std::to_string(object.index())).str(), object.value());
+  }
+  insert(key, std::to_string(objects.size()));
+}
+
+}  // namespace HAL
+}  // namespace IREE
+}  // namespace iree_compiler
+}  // namespace mlir
@@ -0,0 +1,79 @@
+// Copyright 2022 The IREE Authors
+//
+// Licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+#ifndef IREE_COMPILER_DIALECT_HAL_TARGET_LLVM_OBJECTCACHE_H_
+#define IREE_COMPILER_DIALECT_HAL_TARGET_LLVM_OBJECTCACHE_H_
+
+#include <memory>
+#include <string>
+
+#include "iree/compiler/Dialect/HAL/Target/LLVM/LLVMTargetOptions.h"
+#include "llvm/ADT/ArrayRef.h"
+#include "llvm/ADT/Optional.h"
+#include "llvm/ADT/SmallVector.h"
+#include "llvm/ADT/StringRef.h"
+#include "llvm/IR/Module.h"
+
+namespace mlir {
+namespace iree_compiler {
+namespace IREE {
+namespace HAL {
+
+// An on-disk cache of object files keyed by the bitcode of the LLVM module
+// they were generated from and the target machine and LLVM IR optimization
+// pipeline configuration used.
+//
+// Object files are a pure function of those inputs so a hit can be used in
+// place of running code generation. Entries are written atomically and the
+// cache may be shared by concurrent compiler invocations. Nothing is ever
+// evicted; the directory can be deleted at any time to reset it.
+class ObjectCache {
+ public:
+  // Returns a cache rooted at |path| for objects compiled with |options|.
+  // Returns nullptr if the cache directory cannot be created.
+  static std::unique_ptr<ObjectCache> open(llvm::StringRef path,
+                                           const LLVMTargetOptions &options);
+
+  // Returns the cache key for the object file produced from |bitcode|.
+  std::string getKey(llvm::StringRef bitcode) const;
+  // Returns the cache key for the object file produced from |module|.
+  std::string getKey(const llvm::Module &module) const;
+
+  // Returns the object file data for |key| if present in the cache.
+  llvm::Optional<std::string> lookup(llvm::StringRef key) const;
+
+  // Stores |objectData| under |key|. Failures are ignored as the cache is
+  // only an optimization.
+  void insert(llvm::StringRef key, llvm::StringRef objectData) const;
+
+  // Returns true and populates |objects| if the full set of object files
+  // stored under |key| with insertAll is present in the cache.
+  bool lookupAll(llvm::StringRef key,
+                 llvm::SmallVectorImpl<std::string> &objects) const;
+
+  // Stores the set of |objects| under |key|.
+  void insertAll(llvm::StringRef key,
+                 llvm::ArrayRef<std::string> objects) const;
+
+ private:
+  ObjectCache(std::string path, std::string optionsFingerprint)
+      : path(std::move(path)),
+        optionsFingerprint(std::move(optionsFingerprint)) {}
+
+  std::string getEntryPath(llvm::StringRef key) const;
+
+  // Root directory of the cache entries.
+  std::string path;
+  // Serialized target machine configuration mixed into each key.
+  std::string optionsFingerprint;
+};
+
+}  // namespace HAL
+}  // namespace IREE
+}  // namespace iree_compiler
+}  // namespace mlir
+
+#endif  // IREE_COMPILER_DIALECT_HAL_TARGET_LLVM_OBJECTCACHE_H_
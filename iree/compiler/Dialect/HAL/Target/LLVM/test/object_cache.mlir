@@ -0,0 +1,56 @@
+// Tests that the object cache is reused by identical compilations and that
+// changing an option influencing the LLVM IR pipeline produces new entries.
+
+// RUN: rm -rf %t && mkdir -p %t
+// RUN: iree-opt -iree-stream-transformation-pipeline -iree-hal-transformation-pipeline -iree-llvm-object-cache-dir=%t/cache %s | FileCheck %s
+// RUN: ls %t/cache > %t/first.txt
+// RUN: test -s %t/first.txt
+
+// A second identical compilation hits and adds no entries.
+// RUN: iree-opt -iree-stream-transformation-pipeline -iree-hal-transformation-pipeline -iree-llvm-object-cache-dir=%t/cache %s | FileCheck %s
+// RUN: ls %t/cache | diff %t/first.txt -
+
+// Changing a pipeline tuning option misses and adds entries.
+// RUN: iree-opt -iree-stream-transformation-pipeline -iree-hal-transformation-pipeline -iree-llvm-object-cache-dir=%t/cache -iree-llvm-loop-unrolling=false %s | FileCheck %s
+// RUN: ls %t/cache > %t/second.txt
+// RUN: test $(wc -l < %t/second.txt) -gt $(wc -l < %t/first.txt)
+
+#map = affine_map<(d0) -> (d0)>
+
+module attributes {
+  hal.device.targets = [
+    #hal.device.target<"dylib", {
+      executable_targets = [
+        #hal.executable.target<"llvm", "embedded-elf-x86_64">
+      ]
+    }>
+  ]
+} {
+
+stream.executable public @add_dispatch_0 {
+  stream.executable.export @add_dispatch_0
+  builtin.module  {
+    func.func @add_dispatch_0(%arg0_binding: !stream.binding, %arg1_binding: !stream.binding, %arg2_binding: !stream.binding) {
+      %c0 = arith.constant 0 : index
+      %arg0 = stream.binding.subspan %arg0_binding[%c0] : !stream.binding -> !flow.dispatch.tensor<readonly:16xf32>
+      %arg1 = stream.binding.subspan %arg1_binding[%c0] : !stream.binding -> !flow.dispatch.tensor<readonly:16xf32>
+      %arg2 = stream.binding.subspan %arg2_binding[%c0] : !stream.binding -> !flow.dispatch.tensor<writeonly:16xf32>
+      %0 = linalg.init_tensor [16] : tensor<16xf32>
+      %1 = flow.dispatch.tensor.load %arg0, offsets=[0], sizes=[16], strides=[1] : !flow.dispatch.tensor<readonly:16xf32> -> tensor<16xf32>
+      %2 = flow.dispatch.tensor.load %arg1, offsets=[0], sizes=[16], strides=[1] : !flow.dispatch.tensor<readonly:16xf32> -> tensor<16xf32>
+      %3 = linalg.generic {indexing_maps = [affine_map<(d0) -> (d0)>, affine_map<(d0) -> (d0)>, affine_map<(d0) -> (d0)>], iterator_types = ["parallel"]} ins(%1, %2 : tensor<16xf32>, tensor<16xf32>) outs(%0 : tensor<16xf32>) {
+      ^bb0(%arg3: f32, %arg4: f32, %arg5: f32):  // no predecessors
+        %4 = arith.addf %arg3, %arg4 : f32
+        linalg.yield %4 : f32
+      } -> tensor<16xf32>
+      flow.dispatch.tensor.store %3, %arg2, offsets=[0], sizes=[16], strides=[1] : tensor<16xf32> -> !flow.dispatch.tensor<writeonly:16xf32>
+      return
+    }
+  }
+}
+
+}
+
+// CHECK:       hal.executable.binary public @embedded_elf_x86_64
+// CHECK-SAME:     data = dense
+// CHECK-SAME:     format = "embedded-elf-x86_64"
@@ -1,5 +1,7 @@
 // RUN: iree-opt -split-input-file -iree-stream-transformation-pipeline -iree-hal-transformation-pipeline %s | FileCheck %s
 // RUN: iree-opt -split-input-file -iree-stream-transformation-pipeline -iree-hal-transformation-pipeline -iree-llvm-link-embedded=false %s | FileCheck %s
+// RUN: iree-opt -split-input-file -iree-stream-transformation-pipeline -iree-hal-transformation-pipeline -iree-llvm-target-triple=x86_64-pc-linux-elf -iree-llvm-target-cpu-feature-variants='+avx512f,+avx512vnni;+avx2,+fma' %s | FileCheck %s
+// RUN: iree-opt -split-input-file -iree-stream-transformation-pipeline -iree-hal-transformation-pipeline -iree-llvm-target-triple=x86_64-pc-linux-elf -iree-llvm-target-cpu-feature-variants='+avx512f,+avx512vnni;+avx2,+fma' -iree-llvm-print-library-ir %s -o /dev/null 2>&1 | FileCheck %s --check-prefix=VARIANTS
 
 #map = affine_map<(d0) -> (d0)>
 
@@ -40,3 +42,31 @@ stream.executable public @add_dispatch_0 {
 // CHECK:       hal.executable.binary public @embedded_elf_x86_64
 // CHECK-SAME:     data = dense
 // CHECK-SAME:     format = "embedded-elf-x86_64"
+
+// Each feature variant gets its own export table pointing at entry points
+// cloned with the variant target features. The baseline library and the
+// variant libraries share everything but their export tables.
+// VARIANTS-DAG: @iree_hal_executable_library_query_v0_funcs = private constant {{.+}}@add_dispatch_0{{[^_]}}
+// VARIANTS-DAG: @iree_hal_executable_library_query_v0_funcs_variant0 = private constant {{.+}}@add_dispatch_0_variant0
+// VARIANTS-DAG: @iree_hal_executable_library_query_v0_funcs_variant1 = private constant {{.+}}@add_dispatch_0_variant1
+// VARIANTS-DAG: @iree_hal_executable_library_query_v0 = private constant {{.+}}@iree_hal_executable_library_query_v0_funcs{{[^_]}}
+// VARIANTS-DAG: @iree_hal_executable_library_query_v0_variant0 = private constant {{.+}}@iree_hal_executable_library_query_v0_funcs_variant0
+// VARIANTS-DAG: @iree_hal_executable_library_query_v0_variant1 = private constant {{.+}}@iree_hal_executable_library_query_v0_funcs_variant1
+// VARIANTS-DAG: define internal {{.+}}@add_dispatch_0_variant0({{.*}}) #[[AVX512_ATTRS:[0-9]+]]
+// VARIANTS-DAG: define internal {{.+}}@add_dispatch_0_variant1({{.*}}) #[[AVX2_ATTRS:[0-9]+]]
+
+// The query function selects the first variant whose feature bits are all
+// present in processor data[0]: avx512f|avx512vnni = 528 and avx2|fma = 6.
+// VARIANTS-LABEL: define {{.*}}@iree_hal_executable_library_query(
+// VARIANTS:         %[[DATA0_PTR:.+]] = getelementptr inbounds {{.+}}, i32 0, i32 3, i32 0, i32 0
+// VARIANTS-NEXT:    %[[DATA0:.+]] = load i64, {{.+}}%[[DATA0_PTR]]
+// VARIANTS-NEXT:    %[[MASKED1:.+]] = and i64 %[[DATA0]], 6
+// VARIANTS-NEXT:    %[[HAS1:.+]] = icmp eq i64 %[[MASKED1]], 6
+// VARIANTS-NEXT:    %[[SELECT1:.+]] = select i1 %[[HAS1]], {{.+}}@iree_hal_executable_library_query_v0_variant1{{.+}}@iree_hal_executable_library_query_v0{{[^_]}}
+// VARIANTS-NEXT:    %[[MASKED0:.+]] = and i64 %[[DATA0]], 528
+// VARIANTS-NEXT:    %[[HAS0:.+]] = icmp eq i64 %[[MASKED0]], 528
+// VARIANTS-NEXT:    %[[SELECT0:.+]] = select i1 %[[HAS0]], {{.+}}@iree_hal_executable_library_query_v0_variant0{{.+}}, {{.+}}%[[SELECT1]]
+// VARIANTS:         select i1 {{.+}}, {{.+}}%[[SELECT0]], {{.+}}null
+
+// VARIANTS-DAG: attributes #[[AVX512_ATTRS]] = { {{.*}}"target-features"="+avx512f,+avx512vnni"
+// VARIANTS-DAG: attributes #[[AVX2_ATTRS]] = { {{.*}}"target-features"="+avx2,+fma"
@@ -0,0 +1,235 @@
+// Copyright 2022 The IREE Authors
+//
+// Licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+#include <utility>
+
+#include "iree/compiler/Dialect/HAL/IR/HALDialect.h"
+#include "iree/compiler/Dialect/HAL/IR/HALOps.h"
+#include "iree/compiler/Dialect/HAL/Transforms/Passes.h"
+#include "llvm/ADT/MapVector.h"
+#include "mlir/Dialect/Arithmetic/IR/Arithmetic.h"
+#include "mlir/IR/Builders.h"
+#include "mlir/IR/BuiltinTypes.h"
+#include "mlir/Pass/Pass.h"
+
+namespace mlir {
+namespace iree_compiler {
+namespace IREE {
+namespace HAL {
+namespace {
+
+// A dispatch and the state pushed immediately prior to it that can be recorded
+// as a single hal.command_buffer.dispatch.batch record.
+struct DispatchRecord {
+  IREE::HAL::CommandBufferPushConstantsOp pushConstantsOp;
+  IREE::HAL::CommandBufferPushDescriptorSetOp pushDescriptorSetOp;
+  IREE::HAL::CommandBufferDispatchOp dispatchOp;
+
+  bool hasPushes() const { return pushConstantsOp || pushDescriptorSetOp; }
+
+  Value getExecutableLayout() {
+    if (pushConstantsOp) return pushConstantsOp.executable_layout();
+    if (pushDescriptorSetOp) return pushDescriptorSetOp.executable_layout();
+    return {};
+  }
+};
+
+// A run of dispatch records on a single command buffer with no other command
+// buffer operations interleaved.
+struct DispatchRun {
+  SmallVector<DispatchRecord, 8> records;
+  // Pushes seen since the last dispatch in the run.
+  DispatchRecord pending;
+};
+
+}  // namespace
+
+// Replaces the ops of all |records| with a single batch op recorded at the
+// position of the last dispatch.
+static void emitBatch(Value commandBuffer, ArrayRef<DispatchRecord> records) {
+  // Records without pushes don't use their layout but the op still needs one.
+  Value defaultLayout;
+  for (auto record : records) {
+    if (record.hasPushes()) {
+      defaultLayout = record.getExecutableLayout();
+      break;
+    }
+  }
+  if (!defaultLayout) return;
+
+  auto lastDispatchOp = records.back().dispatchOp;
+  OpBuilder builder(lastDispatchOp);
+  SmallVector<Location> locs;
+  SmallVector<Value> executableLayouts;
+  SmallVector<Value> executables;
+  SmallVector<int64_t> entryPoints;
+  SmallVector<Value> workgroupCounts;
+  SmallVector<int64_t> constantCounts;
+  SmallVector<Value> constants;
+  SmallVector<Value> sets;
+  SmallVector<int64_t> bindingCounts;
+  SmallVector<Value> bindingOrdinals;
+  SmallVector<Value> bindingBuffers;
+  SmallVector<Value> bindingOffsets;
+  SmallVector<Value> bindingLengths;
+  Value zeroSet;
+  for (auto record : records) {
+    auto dispatchOp = record.dispatchOp;
+    locs.push_back(dispatchOp.getLoc());
+    executableLayouts.push_back(record.hasPushes()
+                                    ? record.getExecutableLayout()
+                                    : defaultLayout);
+    executables.push_back(dispatchOp.executable());
+    entryPoints.push_back(dispatchOp.entry_point().getSExtValue());
+    workgroupCounts.append({dispatchOp.workgroup_x(), dispatchOp.workgroup_y(),
+                            dispatchOp.workgroup_z()});
+    if (auto pushConstantsOp = record.pushConstantsOp) {
+      constantCounts.push_back(pushConstantsOp.values().size());
+      llvm::append_range(constants, pushConstantsOp.values());
+    } else {
+      constantCounts.push_back(0);
+    }
+    if (auto pushDescriptorSetOp = record.pushDescriptorSetOp) {
+      sets.push_back(pushDescriptorSetOp.set());
+      bindingCounts.push_back(pushDescriptorSetOp.binding_ordinals().size());
+      llvm::append_range(bindingOrdinals,
+                         pushDescriptorSetOp.binding_ordinals());
+      llvm::append_range(bindingBuffers, pushDescriptorSetOp.binding_buffers());
+      llvm::append_range(bindingOffsets, pushDescriptorSetOp.binding_offsets());
+      llvm::append_range(bindingLengths, pushDescriptorSetOp.binding_lengths());
+    } else {
+      if (!zeroSet) {
+        zeroSet = builder.create<arith::ConstantIndexOp>(
+            lastDispatchOp.getLoc(), 0);
+      }
+      sets.push_back(zeroSet);
+      bindingCounts.push_back(0);
+    }
+  }
+
+  builder.create<IREE::HAL::CommandBufferDispatchBatchOp>(
+      builder.getFusedLoc(locs), commandBuffer, executableLayouts, executables,
+      builder.getIndexArrayAttr(entryPoints), workgroupCounts,
+      builder.getIndexArrayAttr(constantCounts), constants, sets,
+      builder.getIndexArrayAttr(bindingCounts), bindingOrdinals, bindingBuffers,
+      bindingOffsets, bindingLengths);
+
+  for (auto record : records) {
+    if (record.pushConstantsOp) record.pushConstantsOp.erase();
+    if (record.pushDescriptorSetOp) record.pushDescriptorSetOp.erase();
+    record.dispatchOp.erase();
+  }
+}
+
+class BatchDispatchRecordingPass
+    : public PassWrapper<BatchDispatchRecordingPass, OperationPass<void>> {
+ public:
+  void getDependentDialects(DialectRegistry &registry) const override {
+    registry.insert<arith::ArithmeticDialect>();
+    registry.insert<IREE::HAL::HALDialect>();
+  }
+
+  StringRef getArgument() const override {
+    return "iree-hal-batch-dispatch-recording";
+  }
+
+  StringRef getDescription() const override {
+    return "Combines sequences of dispatches on the same command buffer into "
+           "hal.command_buffer.dispatch.batch ops.";
+  }
+
+  void runOnOperation() override {
+    auto parentOp = getOperation();
+    for (auto &region : parentOp->getRegions()) {
+      for (auto &block : region.getBlocks()) {
+        processBlock(block);
+      }
+    }
+  }
+
+ private:
+  void processBlock(Block &block) {
+    llvm::MapVector<Value, DispatchRun> runs;
+
+    // Emits the batch for all complete records in |run| and resets it.
+    // Pending pushes are left in place and will be recorded individually.
+    auto endRun = [&](Value commandBuffer, DispatchRun &run) {
+      if (run.records.size() >= 2) emitBatch(commandBuffer, run.records);
+      run.records.clear();
+      run.pending = {};
+    };
+    auto endAllRuns = [&]() {
+      for (auto &it : runs) endRun(it.first, it.second);
+      runs.clear();
+    };
+
+    // Adds a push to the pending record of |run|. Only one push of each kind
+    // with a shared layout can be folded into a record; anything else ends the
+    // run and starts a new one with |op|.
+    auto addPush = [&](Value commandBuffer, DispatchRun &run, auto op,
+                       auto &pendingOp) {
+      Value pendingLayout = run.pending.getExecutableLayout();
+      if (pendingOp ||
+          (pendingLayout && pendingLayout != op.executable_layout())) {
+        endRun(commandBuffer, run);
+      }
+      pendingOp = op;
+    };
+
+    for (auto &op : llvm::make_early_inc_range(block.getOperations())) {
+      if (auto pushConstantsOp =
+              dyn_cast<IREE::HAL::CommandBufferPushConstantsOp>(op)) {
+        auto commandBuffer = pushConstantsOp.command_buffer();
+        auto &run = runs[commandBuffer];
+        if (!pushConstantsOp.offset().isZero()) {
+          // Batches always push constants at offset 0.
+          endRun(commandBuffer, run);
+          continue;
+        }
+        addPush(commandBuffer, run, pushConstantsOp,
+                run.pending.pushConstantsOp);
+      } else if (auto pushDescriptorSetOp =
+                     dyn_cast<IREE::HAL::CommandBufferPushDescriptorSetOp>(
+                         op)) {
+        auto commandBuffer = pushDescriptorSetOp.command_buffer();
+        auto &run = runs[commandBuffer];
+        addPush(commandBuffer, run, pushDescriptorSetOp,
+                run.pending.pushDescriptorSetOp);
+      } else if (auto dispatchOp =
+                     dyn_cast<IREE::HAL::CommandBufferDispatchOp>(op)) {
+        auto &run = runs[dispatchOp.command_buffer()];
+        run.pending.dispatchOp = dispatchOp;
+        run.records.push_back(run.pending);
+        run.pending = {};
+      } else if (op.getNumRegions() > 0) {
+        // Region ops may record into any command buffer; we don't look inside.
+        endAllRuns();
+      } else {
+        // Any other use of a command buffer (barriers, transfers, submission,
+        // calls, branches, etc) ends its run.
+        for (auto operand : op.getOperands()) {
+          if (!operand.getType().isa<IREE::HAL::CommandBufferType>()) continue;
+          auto it = runs.find(operand);
+          if (it == runs.end()) continue;
+          endRun(it->first, it->second);
+          runs.erase(it);
+        }
+      }
+    }
+    endAllRuns();
+  }
+};
+
+std::unique_ptr<OperationPass<void>> createBatchDispatchRecordingPass() {
+  return std::make_unique<BatchDispatchRecordingPass>();
+}
+
+static PassRegistration<BatchDispatchRecordingPass> pass;
+
+}  // namespace HAL
+}  // namespace IREE
+}  // namespace iree_compiler
+}  // namespace mlir
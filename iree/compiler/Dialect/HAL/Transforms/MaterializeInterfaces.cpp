@@ -217,6 +217,33 @@ static void annotateDispatchSite(IREE::Stream::CmdDispatchOp dispatchOp,
                       ArrayAttr::get(dispatchOp.getContext(), bindingAttrs));
 }
 
+// Annotates |entryPointOp| with the runtime conditions under which it may be
+// dispatched in place of the |baseAttr| entry point it was specialized from.
+// Each condition is a push constant ordinal and the alignment its value must
+// have; dispatch sites check them on the host during conversion.
+static void annotateSpecialization(
+    IREE::HAL::ExecutableEntryPointOp entryPointOp, FlatSymbolRefAttr baseAttr,
+    mlir::func::FuncOp sourceFuncOp) {
+  Builder builder(entryPointOp.getContext());
+  SmallVector<int64_t> operandOrdinals;
+  SmallVector<int64_t> operandAlignments;
+  unsigned operandIdx = 0;
+  for (auto arg : sourceFuncOp.getArguments()) {
+    if (arg.getType().isa<IREE::Stream::BindingType>()) continue;
+    unsigned pushConstantIdx = operandIdx++;
+    auto alignmentAttr = sourceFuncOp.getArgAttrOfType<IntegerAttr>(
+        arg.getArgNumber(), "stream.specialization_alignment");
+    if (!alignmentAttr) continue;
+    operandOrdinals.push_back(pushConstantIdx);
+    operandAlignments.push_back(alignmentAttr.getInt());
+  }
+  entryPointOp->setAttr("hal.specialization_of", baseAttr);
+  entryPointOp->setAttr("hal.specialization_operands",
+                        builder.getIndexArrayAttr(operandOrdinals));
+  entryPointOp->setAttr("hal.specialization_alignments",
+                        builder.getIndexArrayAttr(operandAlignments));
+}
+
 // Adds the entry point ops with assigned ordinals for each entry function.
 // The entry points will all use the provided |interfaceOp|.
 static LogicalResult declareEntryPointOps(
@@ -237,7 +264,24 @@ static LogicalResult declareEntryPointOps(
             exportOp.function_ref());
     if (failed(verifyEntryPointTypes(sourceFuncOp))) return failure();
 
-    const auto &executableLayout = layoutAnalysis.getExecutableLayout(exportOp);
+    // Specialized exports have no dispatch sites of their own and are
+    // dispatched in place of their base export so they must share its layout.
+    auto baseExportOp = exportOp;
+    auto specializationOfAttr =
+        exportOp->getAttrOfType<FlatSymbolRefAttr>("stream.specialization_of");
+    if (specializationOfAttr) {
+      baseExportOp =
+          sourceExecutableOp.lookupSymbol<IREE::Stream::ExecutableExportOp>(
+              specializationOfAttr.getAttr());
+      if (!baseExportOp) {
+        return exportOp.emitError()
+               << "specialized export references missing base export "
+               << specializationOfAttr;
+      }
+    }
+
+    const auto &executableLayout =
+        layoutAnalysis.getExecutableLayout(baseExportOp);
 
     // Create the interface for this entry point based on the analysis of its
     // usage within the program.
@@ -252,11 +296,16 @@ static LogicalResult declareEntryPointOps(
     for (auto variantOp : variantOps) {
       // Declare the entry point on the target.
       OpBuilder targetBuilder(&variantOp.getBlock().front());
-      targetBuilder.create<IREE::HAL::ExecutableEntryPointOp>(
-          exportOp.getLoc(),
-          targetBuilder.getStringAttr(exportOp.function_ref()),
-          targetBuilder.getIndexAttr(ordinal), layoutAttr, ArrayAttr{},
-          IntegerAttr{});
+      auto entryPointOp =
+          targetBuilder.create<IREE::HAL::ExecutableEntryPointOp>(
+              exportOp.getLoc(),
+              targetBuilder.getStringAttr(exportOp.function_ref()),
+              targetBuilder.getIndexAttr(ordinal), layoutAttr, ArrayAttr{},
+              IntegerAttr{});
+      if (specializationOfAttr) {
+        annotateSpecialization(entryPointOp, baseExportOp.function_refAttr(),
+                               sourceFuncOp);
+      }
 
       // Clone the updated interface-based function into the target.
       auto targetFuncOp = baseFuncOp.clone();
@@ -47,6 +47,18 @@ static llvm::cl::opt<unsigned> benchmarkDispatchRepeatCount{
         "meant for command buffers having linear dispatch structures."),
     llvm::cl::init(1)};
 
+static llvm::cl::opt<bool> clBatchDispatchRecording{
+    "iree-hal-enable-dispatch-batching",
+    llvm::cl::desc("Records sequences of dispatches with a single "
+                   "hal.command_buffer.dispatch.batch op (experimental)."),
+    llvm::cl::init(false)};
+
+static llvm::cl::opt<bool> clExecutableCompileStatistics{
+    "iree-hal-executable-compile-statistics",
+    llvm::cl::desc("Emits remarks with the time spent translating and "
+                   "serializing each executable."),
+    llvm::cl::init(false)};
+
 }  // namespace
 
 static void addCleanupPatterns(OpPassManager &passManager) {
@@ -144,7 +156,7 @@ void buildHALTransformPassPipeline(OpPassManager &passManager,
   // After this point the executables are opaque blobs and we cannot change
   // their interfaces.
   passManager.addNestedPass<IREE::HAL::ExecutableOp>(
-      createTranslateExecutablesPass());
+      createTranslateExecutablesPass(clExecutableCompileStatistics));
 
   //----------------------------------------------------------------------------
   // Host program conversion
@@ -207,6 +219,15 @@ void buildHALTransformPassPipeline(OpPassManager &passManager,
   passManager.addNestedPass<mlir::func::FuncOp>(
       createElideRedundantCommandsPass());
 
+  // Combine the remaining dispatches and their state into batches such that
+  // they are recorded with a single call.
+  if (clBatchDispatchRecording) {
+    passManager.addNestedPass<IREE::Util::InitializerOp>(
+        createBatchDispatchRecordingPass());
+    passManager.addNestedPass<mlir::func::FuncOp>(
+        createBatchDispatchRecordingPass());
+  }
+
   // Fixup workgroup count calculations that may have used the affine dialect.
   // Kind of random here but can happen if the benchmarking code does things.
   passManager.addPass(createLowerAffinePass());
@@ -223,7 +244,7 @@ void buildHALTransformPassPipeline(OpPassManager &passManager,
   // contents not turned into a big base64 string.
   if (transformOptions.serializeExecutables) {
     passManager.addNestedPass<IREE::HAL::ExecutableOp>(
-        createSerializeExecutablesPass());
+        createSerializeExecutablesPass(clExecutableCompileStatistics));
 
     // NOTE: symbol DCE will destroy executable target contents, so only run it
     // if we serialized things.
@@ -89,8 +89,10 @@ std::unique_ptr<OperationPass<mlir::ModuleOp>>
 createDumpExecutableBenchmarksPass(StringRef path);
 
 // Translates hal.executable.variant ops via a nested translation pipeline.
+// If |emitStatistics| is set a remark with the time spent is emitted for each
+// executable.
 std::unique_ptr<OperationPass<IREE::HAL::ExecutableOp>>
-createTranslateExecutablesPass();
+createTranslateExecutablesPass(bool emitStatistics = false);
 
 // Translates hal.executable.variant ops for the specified |target| backend.
 std::unique_ptr<OperationPass<IREE::HAL::ExecutableVariantOp>>
@@ -111,8 +113,10 @@ std::unique_ptr<OperationPass<mlir::ModuleOp>>
 createResolveEntryPointOrdinalsPass();
 
 // Converts hal.executable.variants to one or more hal.executable.binary ops.
+// Variants are serialized concurrently. If |emitStatistics| is set a remark
+// with the time spent is emitted for each variant.
 std::unique_ptr<OperationPass<IREE::HAL::ExecutableOp>>
-createSerializeExecutablesPass();
+createSerializeExecutablesPass(bool emitStatistics = false);
 
 // Serializes executables for the specified |target| backend.
 std::unique_ptr<OperationPass<IREE::HAL::ExecutableOp>>
@@ -138,6 +142,10 @@ std::unique_ptr<OperationPass<func::FuncOp>> createCSEVariableLoadsPass();
 // Elides stateful command buffer ops that set redundant state.
 std::unique_ptr<OperationPass<void>> createElideRedundantCommandsPass();
 
+// Combines sequences of push constants/push descriptor set/dispatch ops on the
+// same command buffer into hal.command_buffer.dispatch.batch ops.
+std::unique_ptr<OperationPass<void>> createBatchDispatchRecordingPass();
+
 // Repeats dispatches `iree-hal-repeat-dispatch-num` times, which is 1 by
 // default.
 std::unique_ptr<OperationPass<func::FuncOp>> createBenchmarkBatchDispatchesPass(
@@ -151,6 +159,7 @@ inline void registerHALPasses() {
   registerHALTransformPassPipeline();
   auto targetOptions = TargetOptions::FromFlags::get();
   createAssignTargetDevicesPass({});
+  createBatchDispatchRecordingPass();
   createBenchmarkBatchDispatchesPass(/*repeatCount=*/1);
   createConvertToHALPass();
   createDumpExecutableSourcesPass("");
@@ -4,6 +4,7 @@
 // See https://llvm.org/LICENSE.txt for license information.
 // SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
 
+#include <chrono>
 #include <memory>
 #include <utility>
 
@@ -12,6 +13,7 @@
 #include "iree/compiler/Dialect/HAL/Target/TargetBackend.h"
 #include "iree/compiler/Dialect/HAL/Target/TargetRegistry.h"
 #include "llvm/ADT/StringSet.h"
+#include "llvm/Support/Format.h"
 #include "mlir/IR/Attributes.h"
 #include "mlir/IR/Builders.h"
 #include "mlir/IR/Diagnostics.h"
@@ -98,6 +100,10 @@ class SerializeExecutablesPass
                          OperationPass<IREE::HAL::ExecutableOp>> {
  public:
   SerializeExecutablesPass() = default;
+  SerializeExecutablesPass(const SerializeExecutablesPass &pass) {}
+  SerializeExecutablesPass(bool emitStatistics) {
+    this->emitStatistics = emitStatistics;
+  }
 
   StringRef getArgument() const override {
     return "iree-hal-serialize-executables";
@@ -107,22 +113,90 @@ class SerializeExecutablesPass
     return "Serializes hal.executable.variant ops to hal.executable.binary ops";
   }
 
+  void getDependentDialects(DialectRegistry &registry) const override {
+    registry.insert<IREE::HAL::HALDialect>();
+    auto targetBackends = getTargetBackends(getRegisteredTargetBackends());
+    for (auto &targetBackend : targetBackends) {
+      targetBackend->getDependentDialects(registry);
+    }
+  }
+
   void runOnOperation() override {
     auto executableOp = getOperation();
-    OpPassManager passManager(executableOp.getOperationName());
-    for (const auto &targetName : gatherExecutableTargetNames(executableOp)) {
-      passManager.addPass(createSerializeTargetExecutablesPass(targetName));
+
+    // Gather the variants and their backends up-front. Each variant is
+    // serialized into its own scratch block so that the variants being walked
+    // are not mutated during serialization. Variants are serialized one at a
+    // time: backends parallelize their own code generation (such as the LLVM
+    // AOT backend compiling partitions of the library) and nesting another
+    // level of parallelism here only oversubscribes the thread pool.
+    struct Serialization {
+      IREE::HAL::ExecutableVariantOp variantOp;
+      std::shared_ptr<TargetBackend> targetBackend;
+      std::unique_ptr<Block> binaryBlock;
+      double durationMs = 0.0;
+    };
+    SmallVector<Serialization> serializations;
+    for (auto variantOp :
+         executableOp.getBlock().getOps<IREE::HAL::ExecutableVariantOp>()) {
+      auto targetName = variantOp.target().getBackend().getValue();
+      auto targetBackend = getTargetBackend(targetName);
+      if (!targetBackend) {
+        variantOp.emitError()
+            << "unregistered target backend '" << targetName << "'";
+        return signalPassFailure();
+      }
+      serializations.push_back(
+          {variantOp, std::move(targetBackend), std::make_unique<Block>()});
     }
-    if (failed(runPipeline(passManager, executableOp))) {
-      executableOp.emitError() << "failed to serialize executables";
-      return signalPassFailure();
+
+    for (auto &serialization : serializations) {
+      auto variantOp = serialization.variantOp;
+      auto startTime = std::chrono::steady_clock::now();
+      // Ask the target backend to serialize the executable. Note that it may
+      // create one or more hal.executable.binary ops in the case of
+      // multi-architecture binaries.
+      auto binaryBuilder =
+          OpBuilder::atBlockEnd(serialization.binaryBlock.get());
+      if (failed(serialization.targetBackend->serializeExecutable(
+              variantOp, binaryBuilder))) {
+        variantOp.emitError()
+            << "failed to serialize executable for target backend "
+            << variantOp.target().getBackend().getValue();
+        return signalPassFailure();
+      }
+      std::chrono::duration<double, std::milli> duration =
+          std::chrono::steady_clock::now() - startTime;
+      serialization.durationMs = duration.count();
+    }
+
+    // Replace each variant with its binaries, preserving the variant order.
+    for (auto &serialization : serializations) {
+      auto variantOp = serialization.variantOp;
+      if (emitStatistics) {
+        variantOp.emitRemark()
+            << "serialized variant @" << variantOp.getName() << " for "
+            << variantOp.target().getBackend().getValue() << " in "
+            << llvm::format("%.3f", serialization.durationMs) << "ms";
+      }
+      executableOp.getBlock().getOperations().splice(
+          Block::iterator(variantOp),
+          serialization.binaryBlock->getOperations());
+      variantOp.erase();
     }
   }
+
+ private:
+  Option<bool> emitStatistics{
+      *this, "statistics",
+      llvm::cl::desc("Emits a remark with the time spent serializing each "
+                     "variant."),
+      llvm::cl::init(false)};
 };
 
 std::unique_ptr<OperationPass<IREE::HAL::ExecutableOp>>
-createSerializeExecutablesPass() {
-  return std::make_unique<SerializeExecutablesPass>();
+createSerializeExecutablesPass(bool emitStatistics) {
+  return std::make_unique<SerializeExecutablesPass>(emitStatistics);
 }
 
 static PassRegistration<SerializeExecutablesPass> linkPass([] {
@@ -4,6 +4,7 @@
 // See https://llvm.org/LICENSE.txt for license information.
 // SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
 
+#include <chrono>
 #include <memory>
 #include <utility>
 
@@ -12,6 +13,7 @@
 #include "iree/compiler/Dialect/HAL/Target/TargetBackend.h"
 #include "iree/compiler/Dialect/HAL/Target/TargetRegistry.h"
 #include "llvm/ADT/StringSet.h"
+#include "llvm/Support/Format.h"
 #include "mlir/Dialect/Bufferization/IR/Bufferization.h"
 #include "mlir/IR/Attributes.h"
 #include "mlir/IR/Builders.h"
@@ -93,6 +95,10 @@ class TranslateExecutablesPass
                          OperationPass<IREE::HAL::ExecutableOp>> {
  public:
   TranslateExecutablesPass() = default;
+  TranslateExecutablesPass(const TranslateExecutablesPass &pass) {}
+  TranslateExecutablesPass(bool emitStatistics) {
+    this->emitStatistics = emitStatistics;
+  }
 
   StringRef getArgument() const override {
     return "iree-hal-translate-executables";
@@ -113,6 +119,10 @@ class TranslateExecutablesPass
 
   void runOnOperation() override {
     auto executableOp = getOperation();
+    auto startTime = std::chrono::steady_clock::now();
+
+    // The nested pipeline translates all variants of the executable in
+    // parallel (in addition to the parallelism across executables).
     OpPassManager passManager(executableOp.getOperationName());
     for (const auto &targetName : gatherExecutableTargetNames(executableOp)) {
       passManager.addNestedPass<IREE::HAL::ExecutableVariantOp>(
@@ -122,12 +132,27 @@ class TranslateExecutablesPass
       executableOp.emitError() << "failed to serialize executables";
       return signalPassFailure();
     }
+
+    if (emitStatistics) {
+      std::chrono::duration<double, std::milli> duration =
+          std::chrono::steady_clock::now() - startTime;
+      executableOp.emitRemark()
+          << "translated executable in "
+          << llvm::format("%.3f", duration.count()) << "ms";
+    }
   }
+
+ private:
+  Option<bool> emitStatistics{
+      *this, "statistics",
+      llvm::cl::desc("Emits a remark with the time spent translating the "
+                     "executable."),
+      llvm::cl::init(false)};
 };
 
 std::unique_ptr<OperationPass<IREE::HAL::ExecutableOp>>
-createTranslateExecutablesPass() {
-  return std::make_unique<TranslateExecutablesPass>();
+createTranslateExecutablesPass(bool emitStatistics) {
+  return std::make_unique<TranslateExecutablesPass>(emitStatistics);
 }
 
 static PassRegistration<TranslateExecutablesPass> translatePass([] {
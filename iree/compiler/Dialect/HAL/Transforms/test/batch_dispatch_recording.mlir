@@ -0,0 +1,80 @@
+// RUN: iree-opt -split-input-file -pass-pipeline='func.func(iree-hal-batch-dispatch-recording)' %s | FileCheck %s
+
+// Tests that a sequence of dispatches and their pushed state are combined.
+
+// CHECK-LABEL: @batchDispatches
+// CHECK-SAME: (%[[CMD:.+]]: !hal.command_buffer, %[[LAYOUT:.+]]: !hal.executable_layout, %[[EXECUTABLE:.+]]: !hal.executable, %[[BUFFER0:.+]]: !hal.buffer, %[[BUFFER1:.+]]: !hal.buffer)
+func.func @batchDispatches(%cmd: !hal.command_buffer, %executable_layout: !hal.executable_layout, %executable: !hal.executable, %buffer0: !hal.buffer, %buffer1: !hal.buffer) {
+  %c0 = arith.constant 0 : index
+  %c1 = arith.constant 1 : index
+  %c4 = arith.constant 4 : index
+  %c128 = arith.constant 128 : index
+  %c42_i32 = arith.constant 42 : i32
+  %c43_i32 = arith.constant 43 : i32
+  // CHECK-NOT: hal.command_buffer.push_constants
+  hal.command_buffer.push_constants<%cmd : !hal.command_buffer> layout(%executable_layout : !hal.executable_layout) offset(0) values([%c42_i32]) : i32
+  // CHECK-NOT: hal.command_buffer.push_descriptor_set
+  hal.command_buffer.push_descriptor_set<%cmd : !hal.command_buffer> layout(%executable_layout : !hal.executable_layout)[%c0] bindings([
+    %c0 = (%buffer0 : !hal.buffer)[%c0, %c128],
+    %c1 = (%buffer1 : !hal.buffer)[%c0, %c128]
+  ])
+  // CHECK-NOT: hal.command_buffer.dispatch<
+  hal.command_buffer.dispatch<%cmd : !hal.command_buffer> target(%executable : !hal.executable)[0] workgroups([%c4, %c1, %c1])
+  hal.command_buffer.push_constants<%cmd : !hal.command_buffer> layout(%executable_layout : !hal.executable_layout) offset(0) values([%c43_i32]) : i32
+  hal.command_buffer.dispatch<%cmd : !hal.command_buffer> target(%executable : !hal.executable)[1] workgroups([%c1, %c4, %c1])
+  hal.command_buffer.dispatch<%cmd : !hal.command_buffer> target(%executable : !hal.executable)[2] workgroups([%c1, %c1, %c4])
+  //      CHECK: hal.command_buffer.dispatch.batch<%[[CMD]] : !hal.command_buffer>
+  // CHECK-SAME:   layouts([%[[LAYOUT]], %[[LAYOUT]], %[[LAYOUT]]] :
+  // CHECK-SAME:   targets([%[[EXECUTABLE]], %[[EXECUTABLE]], %[[EXECUTABLE]]] :
+  // CHECK-SAME:   [0 : index, 1 : index, 2 : index]
+  // CHECK-SAME:   workgroups([%c4, %c1, %c1, %c1, %c4, %c1, %c1, %c1, %c4])
+  // CHECK-SAME:   constants [1 : index, 1 : index, 0 : index]([%c42_i32, %c43_i32] : i32, i32)
+  // CHECK-SAME:   bindings [2 : index, 0 : index, 0 : index]
+  // CHECK-SAME:   ([%c0, %c1], [%[[BUFFER0]], %[[BUFFER1]] : !hal.buffer, !hal.buffer], [%c0, %c0], [%c128, %c128])
+  // CHECK-NEXT: return
+  return
+}
+
+// -----
+
+// Tests that barriers split batches and that single dispatches are untouched.
+
+// CHECK-LABEL: @batchSplitByBarriers
+func.func @batchSplitByBarriers(%cmd: !hal.command_buffer, %executable_layout: !hal.executable_layout, %executable: !hal.executable) {
+  %c1 = arith.constant 1 : index
+  %c42_i32 = arith.constant 42 : i32
+  // CHECK: hal.command_buffer.dispatch.batch<
+  // CHECK-SAME: [0 : index, 1 : index]
+  hal.command_buffer.push_constants<%cmd : !hal.command_buffer> layout(%executable_layout : !hal.executable_layout) offset(0) values([%c42_i32]) : i32
+  hal.command_buffer.dispatch<%cmd : !hal.command_buffer> target(%executable : !hal.executable)[0] workgroups([%c1, %c1, %c1])
+  hal.command_buffer.dispatch<%cmd : !hal.command_buffer> target(%executable : !hal.executable)[1] workgroups([%c1, %c1, %c1])
+  // CHECK-NEXT: hal.command_buffer.execution_barrier
+  hal.command_buffer.execution_barrier<%cmd : !hal.command_buffer> source("Dispatch|Transfer|CommandRetire") target("CommandIssue|Dispatch|Transfer") flags("None")
+  // CHECK-NEXT: hal.command_buffer.push_constants
+  hal.command_buffer.push_constants<%cmd : !hal.command_buffer> layout(%executable_layout : !hal.executable_layout) offset(0) values([%c42_i32]) : i32
+  // CHECK-NEXT: hal.command_buffer.dispatch<%{{.+}} : !hal.command_buffer> target(%{{.+}} : !hal.executable)[2]
+  hal.command_buffer.dispatch<%cmd : !hal.command_buffer> target(%executable : !hal.executable)[2] workgroups([%c1, %c1, %c1])
+  // CHECK-NEXT: return
+  return
+}
+
+// -----
+
+// Tests that pushes at non-zero offsets are left in place.
+
+// CHECK-LABEL: @batchSplitByConstantOffset
+func.func @batchSplitByConstantOffset(%cmd: !hal.command_buffer, %executable_layout: !hal.executable_layout, %executable: !hal.executable) {
+  %c1 = arith.constant 1 : index
+  %c42_i32 = arith.constant 42 : i32
+  // CHECK: hal.command_buffer.push_constants<%{{.+}} : !hal.command_buffer> layout(%{{.+}} : !hal.executable_layout) offset(0)
+  hal.command_buffer.push_constants<%cmd : !hal.command_buffer> layout(%executable_layout : !hal.executable_layout) offset(0) values([%c42_i32]) : i32
+  // CHECK-NEXT: hal.command_buffer.push_constants<%{{.+}} : !hal.command_buffer> layout(%{{.+}} : !hal.executable_layout) offset(1)
+  hal.command_buffer.push_constants<%cmd : !hal.command_buffer> layout(%executable_layout : !hal.executable_layout) offset(1) values([%c42_i32]) : i32
+  // CHECK: hal.command_buffer.dispatch.batch<
+  // CHECK-SAME: [0 : index, 1 : index]
+  hal.command_buffer.dispatch<%cmd : !hal.command_buffer> target(%executable : !hal.executable)[0] workgroups([%c1, %c1, %c1])
+  hal.command_buffer.push_constants<%cmd : !hal.command_buffer> layout(%executable_layout : !hal.executable_layout) offset(0) values([%c42_i32]) : i32
+  hal.command_buffer.dispatch<%cmd : !hal.command_buffer> target(%executable : !hal.executable)[1] workgroups([%c1, %c1, %c1])
+  // CHECK-NEXT: return
+  return
+}
@@ -53,3 +53,74 @@ hal.executable.source public @ex {
 // layout bindings are implemented.
 
 }
+
+// -----
+
+// Tests that specialized exports are given the layout of the export they were
+// specialized from and are annotated with the push constants that select them.
+
+#executable_target_embedded_elf_x86_64 = #hal.executable.target<"llvm", "embedded-elf-x86_64">
+module attributes {hal.device.targets = [
+  #hal.device.target<"cpu", {executable_targets = [#executable_target_embedded_elf_x86_64]}>
+]} {
+
+// CHECK-LABEL: hal.executable private @specializedEx
+stream.executable private @specializedEx {
+  stream.executable.export public @dispatch
+  stream.executable.export public @dispatch_aligned64 attributes {stream.specialization_of = @dispatch}
+  stream.executable.export public @dispatch_aligned16 attributes {stream.specialization_of = @dispatch}
+  builtin.module {
+    func.func @dispatch(%arg0: !stream.binding, %arg1: i32, %arg2: i32) {
+      %c0 = arith.constant 0 : index
+      %dim = arith.index_cast %arg1 : i32 to index
+      %0 = stream.binding.subspan %arg0[%c0] : !stream.binding -> !flow.dispatch.tensor<writeonly:?xf32>{%dim}
+      return
+    }
+    func.func @dispatch_aligned64(%arg0: !stream.binding, %arg1: i32 {stream.specialization_alignment = 64 : index}, %arg2: i32) {
+      %c0 = arith.constant 0 : index
+      %dim = arith.index_cast %arg1 : i32 to index
+      %0 = stream.binding.subspan %arg0[%c0] : !stream.binding -> !flow.dispatch.tensor<writeonly:?xf32>{%dim}
+      return
+    }
+    func.func @dispatch_aligned16(%arg0: !stream.binding, %arg1: i32 {stream.specialization_alignment = 16 : index}, %arg2: i32 {stream.specialization_alignment = 16 : index}) {
+      %c0 = arith.constant 0 : index
+      %dim = arith.index_cast %arg1 : i32 to index
+      %0 = stream.binding.subspan %arg0[%c0] : !stream.binding -> !flow.dispatch.tensor<writeonly:?xf32>{%dim}
+      return
+    }
+  }
+}
+
+// CHECK: hal.executable.variant public @embedded_elf_x86_64
+// CHECK: hal.executable.entry_point public @dispatch ordinal(0) layout(#[[LAYOUT:[a-z_0-9]+]])
+// CHECK-NOT: hal.specialization_of
+// CHECK: hal.executable.entry_point public @dispatch_aligned64 ordinal(1) layout(#[[LAYOUT]])
+// CHECK-SAME: hal.specialization_alignments = [64 : index]
+// CHECK-SAME: hal.specialization_of = @dispatch
+// CHECK-SAME: hal.specialization_operands = [0 : index]
+// CHECK: hal.executable.entry_point public @dispatch_aligned16 ordinal(2) layout(#[[LAYOUT]])
+// CHECK-SAME: hal.specialization_alignments = [16 : index, 16 : index]
+// CHECK-SAME: hal.specialization_of = @dispatch
+// CHECK-SAME: hal.specialization_operands = [0 : index, 1 : index]
+// CHECK: builtin.module
+// CHECK: func @dispatch()
+// CHECK: func @dispatch_aligned64()
+// CHECK: func @dispatch_aligned16()
+
+// CHECK-LABEL: func @specializedDispatch
+func.func @specializedDispatch(%arg0: i32, %arg1: i32) -> !stream.timepoint {
+  %c0 = arith.constant 0 : index
+  %c1 = arith.constant 1 : index
+  %c128 = arith.constant 128 : index
+  %0 = stream.resource.alloc uninitialized : !stream.resource<external>{%c128}
+  %1 = stream.cmd.execute with(%0 as %arg2: !stream.resource<external>{%c128}) {
+    // CHECK: stream.cmd.dispatch @specializedEx::@dispatch
+    // CHECK: hal.interface.bindings = [#hal.interface.binding<0, 0>]
+    stream.cmd.dispatch @specializedEx::@dispatch[%c1, %c1, %c1](%arg0, %arg1 : i32, i32) {
+      wo %arg2[%c0 for %c128] : !stream.resource<external>{%c128}
+    }
+  } => !stream.timepoint
+  return %1 : !stream.timepoint
+}
+
+}
@@ -260,6 +260,17 @@ vm.import @command_buffer.dispatch(
   %workgroup_z : i32
 )
 
+// Dispatches a batch of execution requests along with the push constants and
+// descriptor set bindings of each. Records are encoded as a flat list of:
+//   <executable_layout or null, set, constant_count, binding_count, entry_point>
+//   <executable, workgroup_x, workgroup_y, workgroup_z, 0>
+//   ceil(constant_count / 4) x <null, constant, constant, constant, constant>
+//   binding_count x <buffer, binding, offset, length, 0>
+vm.import @command_buffer.dispatch.batch(
+  %command_buffer : !vm.ref<!hal.command_buffer>,
+  %records : tuple<!vm.ref<?>, i32, i32, i32, i32>...
+)
+
 // Dispatches an execution request with the dispatch parameters loaded from the
 // given buffer.
 vm.import @command_buffer.dispatch.indirect(
@@ -0,0 +1,741 @@
+// Copyright 2022 The IREE Authors
+//
+// Licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+#include "iree/compiler/Dialect/Modules/VMVX/Conversion/LinalgToVMVX/ConvertLinalgToVMVX.h"
+
+#include "iree/compiler/Dialect/HAL/IR/HALOps.h"
+#include "iree/compiler/Dialect/Modules/VMVX/IR/VMVXOps.h"
+#include "llvm/ADT/STLExtras.h"
+#include "llvm/ADT/SmallBitVector.h"
+#include "llvm/ADT/TypeSwitch.h"
+#include "mlir/Dialect/Arithmetic/IR/Arithmetic.h"
+#include "mlir/Dialect/Arithmetic/Utils/Utils.h"
+#include "mlir/Dialect/Linalg/IR/Linalg.h"
+#include "mlir/Dialect/Math/IR/Math.h"
+#include "mlir/Dialect/MemRef/IR/MemRef.h"
+#include "mlir/Dialect/SCF/SCF.h"
+#include "mlir/IR/Builders.h"
+#include "mlir/IR/BuiltinTypes.h"
+#include "mlir/IR/Matchers.h"
+#include "mlir/IR/PatternMatch.h"
+
+namespace mlir {
+namespace iree_compiler {
+namespace {
+
+//===----------------------------------------------------------------------===//
+// Buffer views
+//===----------------------------------------------------------------------===//
+
+// A strided view into a flat VMVX buffer. The buffer is a rank-1 memref and
+// the offset and strides are in elements.
+struct BufferView {
+  Value buffer;
+  Value offset;
+  SmallVector<Value> sizes;
+  SmallVector<Value> strides;
+};
+
+// Returns true if the byte offset of |subspanOp| is known to be an exact
+// multiple of |elementBytes| and can be converted to an element offset.
+// Dynamic offsets are only accepted for byte-sized elements as anything else
+// would need a runtime check to avoid silently truncating the offset.
+static bool isElementAlignedByteOffset(
+    IREE::HAL::InterfaceBindingSubspanOp subspanOp, int64_t elementBytes) {
+  Value byteOffset = subspanOp.byte_offset();
+  if (!byteOffset || elementBytes == 1) return true;
+  APInt constantOffset;
+  if (!matchPattern(byteOffset, m_ConstantInt(&constantOffset))) return false;
+  return constantOffset.getZExtValue() % elementBytes == 0;
+}
+
+// Returns the binding subspan that |memref| is a (possibly subviewed) view of
+// or nullptr if the view cannot be expressed as a flat strided buffer.
+static IREE::HAL::InterfaceBindingSubspanOp getRootSubspan(Value memref) {
+  while (auto subviewOp = memref.getDefiningOp<memref::SubViewOp>()) {
+    memref = subviewOp.source();
+  }
+  auto subspanOp = memref.getDefiningOp<IREE::HAL::InterfaceBindingSubspanOp>();
+  if (!subspanOp) return {};
+  // IREE subspan ops only use memref types with the default identity layout
+  // but we verify here as we compute the row-major strides ourselves.
+  auto memrefType = subspanOp.getType().dyn_cast<MemRefType>();
+  if (!memrefType || !memrefType.getLayout().isIdentity()) return {};
+  Type elementType = memrefType.getElementType();
+  if (!elementType.isIntOrFloat() ||
+      elementType.getIntOrFloatBitWidth() % 8 != 0) {
+    return {};
+  }
+  if (!isElementAlignedByteOffset(subspanOp,
+                                  elementType.getIntOrFloatBitWidth() / 8)) {
+    return {};
+  }
+  return subspanOp;
+}
+
+// Returns true if all |memrefs| can be lowered to VMVX buffer views.
+static bool areBufferViews(ValueRange memrefs) {
+  return llvm::all_of(memrefs, [](Value memref) {
+    return static_cast<bool>(getRootSubspan(memref));
+  });
+}
+
+// Returns a flat view of the entire binding |subspanOp| is a view of.
+//
+// A new rank-1 subspan with a zero byte offset is inserted after the original
+// so that the byte offset can be expressed as an element offset and the
+// flattened buffer can be passed directly to VMVX ops.
+static BufferView getSubspanView(IREE::HAL::InterfaceBindingSubspanOp subspanOp,
+                                 OpBuilder &builder) {
+  OpBuilder::InsertionGuard guard(builder);
+  builder.setInsertionPointAfter(subspanOp);
+  Location loc = subspanOp.getLoc();
+  auto memrefType = subspanOp.getType().cast<MemRefType>();
+  Type elementType = memrefType.getElementType();
+
+  BufferView view;
+  unsigned dynamicDimIndex = 0;
+  for (int64_t dim : memrefType.getShape()) {
+    view.sizes.push_back(
+        ShapedType::isDynamic(dim)
+            ? subspanOp.dynamic_dims()[dynamicDimIndex++]
+            : builder.createOrFold<arith::ConstantIndexOp>(loc, dim));
+  }
+  view.strides.resize(view.sizes.size());
+  Value elementCount = builder.createOrFold<arith::ConstantIndexOp>(loc, 1);
+  for (int i = static_cast<int>(view.sizes.size()) - 1; i >= 0; --i) {
+    view.strides[i] = elementCount;
+    elementCount =
+        builder.createOrFold<arith::MulIOp>(loc, elementCount, view.sizes[i]);
+  }
+
+  Value zero = builder.createOrFold<arith::ConstantIndexOp>(loc, 0);
+  view.offset = zero;
+  // getRootSubspan has verified the division is exact.
+  if (subspanOp.byte_offset() &&
+      !matchPattern(subspanOp.byte_offset(), m_Zero())) {
+    view.offset = builder.createOrFold<arith::DivUIOp>(
+        loc, subspanOp.byte_offset(),
+        builder.createOrFold<arith::ConstantIndexOp>(
+            loc, elementType.getIntOrFloatBitWidth() / 8));
+  }
+  Value bufferLength =
+      builder.createOrFold<arith::AddIOp>(loc, view.offset, elementCount);
+  view.buffer = builder.create<IREE::HAL::InterfaceBindingSubspanOp>(
+      loc, MemRefType::get({ShapedType::kDynamicSize}, elementType),
+      subspanOp.set(), subspanOp.binding(), subspanOp.type(), zero,
+      ValueRange{bufferLength}, subspanOp.alignmentAttr());
+  return view;
+}
+
+// Returns the flat strided view of |memref|, which must satisfy
+// getRootSubspan. Subviews are folded into the view offset and strides.
+static BufferView getBufferView(Value memref, OpBuilder &builder,
+                                Location loc) {
+  auto subviewOp = memref.getDefiningOp<memref::SubViewOp>();
+  if (!subviewOp) {
+    return getSubspanView(
+        memref.getDefiningOp<IREE::HAL::InterfaceBindingSubspanOp>(),
+        builder);
+  }
+  BufferView sourceView = getBufferView(subviewOp.source(), builder, loc);
+  BufferView view;
+  view.buffer = sourceView.buffer;
+  view.offset = sourceView.offset;
+  llvm::SmallBitVector droppedDims = subviewOp.getDroppedDims();
+  for (auto it : llvm::enumerate(llvm::zip(subviewOp.getMixedOffsets(),
+                                           subviewOp.getMixedSizes(),
+                                           subviewOp.getMixedStrides()))) {
+    Value sourceStride = sourceView.strides[it.index()];
+    Value offset =
+        getValueOrCreateConstantIndexOp(builder, loc, std::get<0>(it.value()));
+    view.offset = builder.createOrFold<arith::AddIOp>(
+        loc, view.offset,
+        builder.createOrFold<arith::MulIOp>(loc, offset, sourceStride));
+    if (droppedDims.test(it.index())) continue;
+    view.sizes.push_back(
+        getValueOrCreateConstantIndexOp(builder, loc, std::get<1>(it.value())));
+    view.strides.push_back(builder.createOrFold<arith::MulIOp>(
+        loc, sourceStride,
+        getValueOrCreateConstantIndexOp(builder, loc,
+                                        std::get<2>(it.value()))));
+  }
+  return view;
+}
+
+// A buffer view expressed in terms of the loops of a linalg op.
+// Loops that do not index into the view have a stride of 0.
+struct LoopView {
+  Value buffer;
+  Value offset;
+  SmallVector<Value> strides;
+};
+
+// Returns true if |map| can be expressed with per-loop strides.
+static bool isStridedIndexingMap(AffineMap map) {
+  return map.isProjectedPermutation();
+}
+
+// Returns |view| indexed by the loops of |map|.
+static LoopView getLoopView(const BufferView &view, AffineMap map,
+                            OpBuilder &builder, Location loc) {
+  Value zero = builder.createOrFold<arith::ConstantIndexOp>(loc, 0);
+  LoopView loopView{view.buffer, view.offset,
+                    SmallVector<Value>(map.getNumDims(), zero)};
+  for (unsigned i = 0; i < map.getNumResults(); ++i) {
+    loopView.strides[map.getDimPosition(i)] = view.strides[i];
+  }
+  return loopView;
+}
+
+// Returns the buffer views of all operands of |linalgOp| indexed by its loops
+// and populates |loopSizes| with the loop trip counts.
+static SmallVector<LoopView> getLoopViews(linalg::LinalgOp linalgOp,
+                                          OpBuilder &builder,
+                                          SmallVectorImpl<Value> &loopSizes) {
+  Location loc = linalgOp.getLoc();
+  loopSizes.assign(linalgOp.getNumLoops(), Value());
+  SmallVector<LoopView> loopViews;
+  for (OpOperand *operand : linalgOp.getInputAndOutputOperands()) {
+    BufferView view = getBufferView(operand->get(), builder, loc);
+    AffineMap map = linalgOp.getTiedIndexingMap(operand);
+    for (unsigned i = 0; i < map.getNumResults(); ++i) {
+      Value &loopSize = loopSizes[map.getDimPosition(i)];
+      if (!loopSize) loopSize = view.sizes[i];
+    }
+    loopViews.push_back(getLoopView(view, map, builder, loc));
+  }
+  return loopViews;
+}
+
+// Builds a scf.for nest over |outerLoops| and calls |bodyBuilder| with the
+// offsets of each of |views| advanced to the current iteration.
+static void buildOuterLoops(
+    OpBuilder &builder, Location loc, ArrayRef<unsigned> outerLoops,
+    ArrayRef<Value> loopSizes, ArrayRef<LoopView> views,
+    function_ref<void(OpBuilder &, Location, ArrayRef<Value>)> bodyBuilder) {
+  Value zero = builder.createOrFold<arith::ConstantIndexOp>(loc, 0);
+  Value one = builder.createOrFold<arith::ConstantIndexOp>(loc, 1);
+  SmallVector<Value> lbs(outerLoops.size(), zero);
+  SmallVector<Value> steps(outerLoops.size(), one);
+  SmallVector<Value> ubs;
+  for (unsigned loop : outerLoops) ubs.push_back(loopSizes[loop]);
+  scf::buildLoopNest(
+      builder, loc, lbs, ubs, steps,
+      [&](OpBuilder &nestedBuilder, Location nestedLoc, ValueRange ivs) {
+        SmallVector<Value> offsets;
+        for (const LoopView &view : views) {
+          Value offset = view.offset;
+          for (auto it : llvm::zip(outerLoops, ivs)) {
+            offset = nestedBuilder.createOrFold<arith::AddIOp>(
+                nestedLoc, offset,
+                nestedBuilder.createOrFold<arith::MulIOp>(
+                    nestedLoc, std::get<1>(it),
+                    view.strides[std::get<0>(it)]));
+          }
+          offsets.push_back(offset);
+        }
+        bodyBuilder(nestedBuilder, nestedLoc, offsets);
+      });
+}
+
+// Returns all loops in [0, numLoops) not in |innerLoops|.
+static SmallVector<unsigned> getOuterLoops(unsigned numLoops,
+                                           ArrayRef<unsigned> innerLoops) {
+  SmallVector<unsigned> outerLoops;
+  for (unsigned i = 0; i < numLoops; ++i) {
+    if (!llvm::is_contained(innerLoops, i)) outerLoops.push_back(i);
+  }
+  return outerLoops;
+}
+
+static bool isElementType(Value memref, Type type) {
+  return memref.getType().cast<MemRefType>().getElementType() == type;
+}
+
+// Returns true if the operands are f32 x f32 -> f32 or i8 x i8 -> i32.
+static bool isSupportedContraction(Value lhs, Value rhs, Value out) {
+  Builder builder(lhs.getContext());
+  Type f32 = builder.getF32Type();
+  Type i8 = builder.getIntegerType(8);
+  Type i32 = builder.getIntegerType(32);
+  return (isElementType(lhs, f32) && isElementType(rhs, f32) &&
+          isElementType(out, f32)) ||
+         (isElementType(lhs, i8) && isElementType(rhs, i8) &&
+          isElementType(out, i32));
+}
+
+//===----------------------------------------------------------------------===//
+// Elementwise ops
+//===----------------------------------------------------------------------===//
+
+// Returns the VMVX opcode for a scalar |op| computing |elementType| values or
+// an empty string if there is no matching VMVX op.
+static StringRef getElementwiseOpcode(Operation *op, Type elementType) {
+  if (elementType.isF32()) {
+    return TypeSwitch<Operation *, StringRef>(op)
+        .Case<arith::AddFOp>([](auto) { return "add"; })
+        .Case<arith::DivFOp>([](auto) { return "div"; })
+        .Case<arith::MaxFOp>([](auto) { return "max"; })
+        .Case<arith::MinFOp>([](auto) { return "min"; })
+        .Case<arith::MulFOp>([](auto) { return "mul"; })
+        .Case<arith::NegFOp>([](auto) { return "neg"; })
+        .Case<arith::SubFOp>([](auto) { return "sub"; })
+        .Case<math::AbsOp>([](auto) { return "abs"; })
+        .Case<math::CeilOp>([](auto) { return "ceil"; })
+        .Case<math::ExpOp>([](auto) { return "exp"; })
+        .Case<math::FloorOp>([](auto) { return "floor"; })
+        .Case<math::LogOp>([](auto) { return "log"; })
+        .Case<math::RsqrtOp>([](auto) { return "rsqrt"; })
+        .Case<math::SqrtOp>([](auto) { return "sqrt"; })
+        .Case<math::TanhOp>([](auto) { return "tanh"; })
+        .Default([](Operation *) { return ""; });
+  } else if (elementType.isInteger(32)) {
+    return TypeSwitch<Operation *, StringRef>(op)
+        .Case<arith::AddIOp>([](auto) { return "add"; })
+        .Case<arith::AndIOp>([](auto) { return "and"; })
+        .Case<arith::MulIOp>([](auto) { return "mul"; })
+        .Case<arith::OrIOp>([](auto) { return "or"; })
+        .Case<arith::SubIOp>([](auto) { return "sub"; })
+        .Case<arith::XOrIOp>([](auto) { return "xor"; })
+        .Default([](Operation *) { return ""; });
+  }
+  return "";
+}
+
+// Returns true if vmvx.copy supports elements of |elementType|.
+static bool isCopyElementType(Type elementType) {
+  if (!elementType.isIntOrFloat()) return false;
+  unsigned bitWidth = elementType.getIntOrFloatBitWidth();
+  return bitWidth == 8 || bitWidth == 16 || bitWidth == 32 || bitWidth == 64;
+}
+
+// Rewrites all-parallel linalg.generic ops whose body is a single supported
+// unary or binary op (or a plain copy) to vmvx.unary/vmvx.binary/vmvx.copy.
+//
+// The two innermost loops map to the 2-D view of the VMVX op and any outer
+// loops are emitted as scf.for loops. Broadcasts and transposes are expressed
+// with strides.
+struct LinalgGenericElementwiseToVMVX
+    : public OpRewritePattern<linalg::GenericOp> {
+  using OpRewritePattern::OpRewritePattern;
+
+  LogicalResult matchAndRewrite(linalg::GenericOp op,
+                                PatternRewriter &rewriter) const override {
+    if (!op.hasBufferSemantics() || op.getNumOutputs() != 1 ||
+        op.getNumParallelLoops() != op.getNumLoops()) {
+      return failure();
+    }
+    OpOperand *output = op.getOutputOperand(0);
+    if (!op.getTiedIndexingMap(output).isPermutation()) return failure();
+    for (OpOperand *operand : op.getInputAndOutputOperands()) {
+      if (!isStridedIndexingMap(op.getTiedIndexingMap(operand))) {
+        return failure();
+      }
+    }
+    if (!areBufferViews(op->getOperands())) return failure();
+
+    // Match the body to a single op reading the operands directly.
+    Block *block = op.getBlock();
+    Type elementType =
+        output->get().getType().cast<MemRefType>().getElementType();
+    Value yieldedValue = block->getTerminator()->getOperand(0);
+    StringRef opcode;
+    SmallVector<unsigned> sourceOperands;
+    if (auto arg = yieldedValue.dyn_cast<BlockArgument>()) {
+      if (arg.getOwner() != block ||
+          arg.getArgNumber() >= op.getNumInputs() ||
+          !isCopyElementType(elementType)) {
+        return failure();
+      }
+      sourceOperands.push_back(arg.getArgNumber());
+    } else {
+      Operation *scalarOp = yieldedValue.getDefiningOp();
+      if (!scalarOp || scalarOp->getBlock() != block ||
+          block->getOperations().size() != 2 ||
+          scalarOp->getNumOperands() > 2) {
+        return failure();
+      }
+      opcode = getElementwiseOpcode(scalarOp, elementType);
+      if (opcode.empty()) return failure();
+      for (Value scalarOperand : scalarOp->getOperands()) {
+        auto arg = scalarOperand.dyn_cast<BlockArgument>();
+        if (!arg || arg.getOwner() != block) return failure();
+        sourceOperands.push_back(arg.getArgNumber());
+      }
+    }
+
+    Location loc = op.getLoc();
+    SmallVector<Value> loopSizes;
+    SmallVector<LoopView> loopViews = getLoopViews(op, rewriter, loopSizes);
+    SmallVector<LoopView> views;
+    for (unsigned operand : sourceOperands) {
+      views.push_back(loopViews[operand]);
+    }
+    views.push_back(loopViews.back());
+
+    // Rank 0 and 1 iteration spaces use a single row.
+    unsigned numLoops = op.getNumLoops();
+    SmallVector<unsigned> innerLoops;
+    for (unsigned i = numLoops > 2 ? numLoops - 2 : 0; i < numLoops; ++i) {
+      innerLoops.push_back(i);
+    }
+    Value zero = rewriter.createOrFold<arith::ConstantIndexOp>(loc, 0);
+    Value one = rewriter.createOrFold<arith::ConstantIndexOp>(loc, 1);
+    auto getTileValue = [&](ArrayRef<Value> values, int dim, Value fallback) {
+      int loop = static_cast<int>(innerLoops.size()) - 2 + dim;
+      return loop < 0 ? fallback : values[innerLoops[loop]];
+    };
+    Value size0 = getTileValue(loopSizes, 0, one);
+    Value size1 = getTileValue(loopSizes, 1, one);
+
+    buildOuterLoops(
+        rewriter, loc, getOuterLoops(numLoops, innerLoops), loopSizes, views,
+        [&](OpBuilder &builder, Location nestedLoc, ArrayRef<Value> offsets) {
+          SmallVector<Value> operands;
+          for (auto it : llvm::zip(views, offsets)) {
+            const LoopView &view = std::get<0>(it);
+            operands.push_back(view.buffer);
+            operands.push_back(std::get<1>(it));
+            operands.push_back(getTileValue(view.strides, 0, zero));
+            operands.push_back(getTileValue(view.strides, 1, zero));
+          }
+          operands.push_back(size0);
+          operands.push_back(size1);
+          if (opcode.empty()) {
+            builder.create<IREE::VMVX::CopyOp>(nestedLoc, TypeRange{},
+                                               operands);
+          } else if (views.size() == 2) {
+            builder.create<IREE::VMVX::UnaryOp>(
+                nestedLoc, TypeRange{}, operands,
+                builder.getNamedAttr("opcode",
+                                     builder.getStringAttr(opcode)));
+          } else {
+            builder.create<IREE::VMVX::BinaryOp>(
+                nestedLoc, TypeRange{}, operands,
+                builder.getNamedAttr("opcode",
+                                     builder.getStringAttr(opcode)));
+          }
+        });
+    rewriter.eraseOp(op);
+    return success();
+  }
+};
+
+// Rewrites linalg.fill of 32-bit values to vmvx.fill2d.
+struct LinalgFillToVMVX : public OpRewritePattern<linalg::FillOp> {
+  using OpRewritePattern::OpRewritePattern;
+
+  LogicalResult matchAndRewrite(linalg::FillOp op,
+                                PatternRewriter &rewriter) const override {
+    if (!op.hasBufferSemantics()) return failure();
+    Type valueType = op.value().getType();
+    if (!valueType.isF32() && !valueType.isInteger(32)) return failure();
+    if (!areBufferViews(op.output())) return failure();
+
+    Location loc = op.getLoc();
+    Value value = op.value();
+    if (valueType.isF32()) {
+      value = rewriter.createOrFold<arith::BitcastOp>(
+          loc, rewriter.getI32Type(), value);
+    }
+    BufferView view = getBufferView(op.output(), rewriter, loc);
+    unsigned rank = view.sizes.size();
+    Value zero = rewriter.createOrFold<arith::ConstantIndexOp>(loc, 0);
+    Value one = rewriter.createOrFold<arith::ConstantIndexOp>(loc, 1);
+    LoopView loopView{view.buffer, view.offset, view.strides};
+    SmallVector<unsigned> innerLoops;
+    for (unsigned i = rank > 2 ? rank - 2 : 0; i < rank; ++i) {
+      innerLoops.push_back(i);
+    }
+    Value stride0 = rank >= 2 ? view.strides[rank - 2] : zero;
+    Value stride1 = rank >= 1 ? view.strides[rank - 1] : zero;
+    Value size0 = rank >= 2 ? view.sizes[rank - 2] : one;
+    Value size1 = rank >= 1 ? view.sizes[rank - 1] : one;
+    buildOuterLoops(
+        rewriter, loc, getOuterLoops(rank, innerLoops), view.sizes, loopView,
+        [&](OpBuilder &builder, Location nestedLoc, ArrayRef<Value> offsets) {
+          builder.create<IREE::VMVX::Fill2DOp>(nestedLoc, value, view.buffer,
+                                               offsets.front(), stride0,
+                                               stride1, size0, size1);
+        });
+    rewriter.eraseOp(op);
+    return success();
+  }
+};
+
+//===----------------------------------------------------------------------===//
+// Reductions
+//===----------------------------------------------------------------------===//
+
+// Returns the VMVX reduction opcode for a scalar |op| combining |elementType|
+// values or an empty string if there is no matching VMVX op.
+static StringRef getReductionOpcode(Operation *op, Type elementType) {
+  if (elementType.isF32()) {
+    if (isa<arith::AddFOp>(op)) return "sum";
+    if (isa<arith::MaxFOp>(op)) return "max";
+  } else if (elementType.isInteger(32)) {
+    if (isa<arith::AddIOp>(op)) return "sum";
+  }
+  return "";
+}
+
+// Rewrites linalg.generic ops reducing a single loop with a supported
+// combiner to vmvx.reduce. The innermost parallel loop (if any) becomes the
+// rows of the VMVX op and any other parallel loops are emitted as scf.for.
+struct LinalgGenericReductionToVMVX
+    : public OpRewritePattern<linalg::GenericOp> {
+  using OpRewritePattern::OpRewritePattern;
+
+  LogicalResult matchAndRewrite(linalg::GenericOp op,
+                                PatternRewriter &rewriter) const override {
+    if (!op.hasBufferSemantics() || op.getNumInputs() != 1 ||
+        op.getNumOutputs() != 1 || op.getNumReductionLoops() != 1) {
+      return failure();
+    }
+    // The input must cover all loops so that their trip counts are known.
+    if (!op.getTiedIndexingMap(op.getInputOperand(0)).isPermutation() ||
+        !isStridedIndexingMap(op.getTiedIndexingMap(op.getOutputOperand(0))) ||
+        !areBufferViews(op->getOperands())) {
+      return failure();
+    }
+
+    // The body must combine the input and the accumulator with a single op.
+    Block *block = op.getBlock();
+    Value yieldedValue = block->getTerminator()->getOperand(0);
+    Operation *combinerOp = yieldedValue.getDefiningOp();
+    if (!combinerOp || combinerOp->getBlock() != block ||
+        block->getOperations().size() != 2 ||
+        combinerOp->getNumOperands() != 2) {
+      return failure();
+    }
+    auto isArg = [&](Value value, unsigned argNumber) {
+      return value == block->getArgument(argNumber);
+    };
+    Value lhs = combinerOp->getOperand(0);
+    Value rhs = combinerOp->getOperand(1);
+    if (!(isArg(lhs, 0) && isArg(rhs, 1)) &&
+        !(isArg(lhs, 1) && isArg(rhs, 0))) {
+      return failure();
+    }
+    Type elementType = yieldedValue.getType();
+    StringRef opcode = getReductionOpcode(combinerOp, elementType);
+    if (opcode.empty()) return failure();
+
+    SmallVector<unsigned> innerLoops;
+    Optional<unsigned> reductionLoop;
+    for (auto it : llvm::enumerate(op.iterator_types())) {
+      if (isReductionIterator(it.value())) {
+        reductionLoop = it.index();
+      } else {
+        innerLoops.assign({static_cast<unsigned>(it.index())});
+      }
+    }
+    innerLoops.push_back(*reductionLoop);
+    AffineMap outputMap = op.getTiedIndexingMap(op.getOutputOperand(0));
+    if (outputMap.isFunctionOfDim(*reductionLoop)) return failure();
+
+    Location loc = op.getLoc();
+    SmallVector<Value> loopSizes;
+    SmallVector<LoopView> views = getLoopViews(op, rewriter, loopSizes);
+    Value zero = rewriter.createOrFold<arith::ConstantIndexOp>(loc, 0);
+    Value one = rewriter.createOrFold<arith::ConstantIndexOp>(loc, 1);
+    bool hasRows = innerLoops.size() == 2;
+    Value size0 = hasRows ? loopSizes[innerLoops[0]] : one;
+    Value size1 = loopSizes[*reductionLoop];
+    buildOuterLoops(
+        rewriter, loc, getOuterLoops(op.getNumLoops(), innerLoops), loopSizes,
+        views,
+        [&](OpBuilder &builder, Location nestedLoc, ArrayRef<Value> offsets) {
+          const LoopView &in = views[0];
+          const LoopView &out = views[1];
+          builder.create<IREE::VMVX::ReduceOp>(
+              nestedLoc, builder.getStringAttr(opcode), in.buffer, offsets[0],
+              hasRows ? in.strides[innerLoops[0]] : zero,
+              in.strides[*reductionLoop], out.buffer, offsets[1],
+              hasRows ? out.strides[innerLoops[0]] : zero, size0, size1);
+        });
+    rewriter.eraseOp(op);
+    return success();
+  }
+};
+
+//===----------------------------------------------------------------------===//
+// Contractions
+//===----------------------------------------------------------------------===//
+
+// Emits a vmvx.matmul for loops (m, n, k) of |views| (lhs, rhs, out) at the
+// given |offsets|.
+static void buildMatmul(OpBuilder &builder, Location loc,
+                        ArrayRef<LoopView> views, ArrayRef<Value> offsets,
+                        ArrayRef<Value> loopSizes, unsigned m, unsigned n,
+                        unsigned k) {
+  const LoopView &lhs = views[0];
+  const LoopView &rhs = views[1];
+  const LoopView &out = views[2];
+  builder.create<IREE::VMVX::MatmulOp>(
+      loc, lhs.buffer, offsets[0], lhs.strides[m], lhs.strides[k], rhs.buffer,
+      offsets[1], rhs.strides[k], rhs.strides[n], out.buffer, offsets[2],
+      out.strides[m], out.strides[n], loopSizes[m], loopSizes[n],
+      loopSizes[k]);
+}
+
+// Rewrites linalg.matmul and linalg.batch_matmul to vmvx.matmul. The batch
+// loop of batch matmuls is emitted as a scf.for.
+template <typename OpTy>
+struct LinalgMatmulToVMVX : public OpRewritePattern<OpTy> {
+  using OpRewritePattern<OpTy>::OpRewritePattern;
+
+  LogicalResult matchAndRewrite(OpTy op,
+                                PatternRewriter &rewriter) const override {
+    if (!op.hasBufferSemantics()) return failure();
+    if (!isSupportedContraction(op.inputs()[0], op.inputs()[1],
+                                op.outputs()[0]) ||
+        !areBufferViews(op->getOperands())) {
+      return failure();
+    }
+    auto linalgOp = cast<linalg::LinalgOp>(op.getOperation());
+    SmallVector<Value> loopSizes;
+    SmallVector<LoopView> views =
+        getLoopViews(linalgOp, rewriter, loopSizes);
+    // The (m, n, k) loops are always the innermost.
+    unsigned numLoops = linalgOp.getNumLoops();
+    unsigned m = numLoops - 3, n = numLoops - 2, k = numLoops - 1;
+    buildOuterLoops(
+        rewriter, op.getLoc(), getOuterLoops(numLoops, {m, n, k}), loopSizes,
+        views,
+        [&](OpBuilder &builder, Location nestedLoc, ArrayRef<Value> offsets) {
+          buildMatmul(builder, nestedLoc, views, offsets, loopSizes, m, n,
+                      k);
+        });
+    rewriter.eraseOp(op);
+    return success();
+  }
+};
+
+// Returns true if the inner three dimensions of the rank-4 |memref| form a
+// contiguous row-major tile.
+static bool hasContiguousInnerTile(Value memref) {
+  auto memrefType = memref.getType().cast<MemRefType>();
+  SmallVector<int64_t> strides;
+  int64_t offset = 0;
+  if (memrefType.getRank() != 4 ||
+      failed(getStridesAndOffset(memrefType, strides, offset))) {
+    return false;
+  }
+  ArrayRef<int64_t> shape = memrefType.getShape();
+  if (llvm::any_of(shape.drop_front(), ShapedType::isDynamic)) return false;
+  return strides[3] == 1 && strides[2] == shape[3] &&
+         strides[1] == shape[2] * shape[3];
+}
+
+// Rewrites linalg.mmt4d to vmvx.mmt4d. Only the outermost dimension of each
+// operand may be strided.
+struct LinalgMmt4dToVMVX : public OpRewritePattern<linalg::Mmt4DOp> {
+  using OpRewritePattern::OpRewritePattern;
+
+  LogicalResult matchAndRewrite(linalg::Mmt4DOp op,
+                                PatternRewriter &rewriter) const override {
+    if (!op.hasBufferSemantics()) return failure();
+    Value lhs = op.inputs()[0];
+    Value rhs = op.inputs()[1];
+    Value out = op.outputs()[0];
+    if (!isSupportedContraction(lhs, rhs, out) ||
+        !hasContiguousInnerTile(lhs) || !hasContiguousInnerTile(rhs) ||
+        !hasContiguousInnerTile(out) || !areBufferViews(op->getOperands())) {
+      return failure();
+    }
+    Location loc = op.getLoc();
+    BufferView lhsView = getBufferView(lhs, rewriter, loc);
+    BufferView rhsView = getBufferView(rhs, rewriter, loc);
+    BufferView outView = getBufferView(out, rewriter, loc);
+    rewriter.replaceOpWithNewOp<IREE::VMVX::Mmt4dOp>(
+        op, lhsView.buffer, lhsView.offset, lhsView.strides[0],
+        rhsView.buffer, rhsView.offset, rhsView.strides[0], outView.buffer,
+        outView.offset, outView.strides[0], lhsView.sizes[0],
+        rhsView.sizes[0], lhsView.sizes[1], lhsView.sizes[2],
+        rhsView.sizes[2], lhsView.sizes[3]);
+    return success();
+  }
+};
+
+// Rewrites linalg.conv_2d_nhwc_hwcf to a sequence of vmvx.matmul ops.
+//
+// For each (n, oh, kh, kw) the contribution of one filter tap to an output row
+// is a [OW, C] x [C, F] matmul where the input rows are strided by the
+// convolution stride.
+struct LinalgConv2DNhwcHwcfToVMVX
+    : public OpRewritePattern<linalg::Conv2DNhwcHwcfOp> {
+  using OpRewritePattern::OpRewritePattern;
+
+  LogicalResult matchAndRewrite(linalg::Conv2DNhwcHwcfOp op,
+                                PatternRewriter &rewriter) const override {
+    if (!op.hasBufferSemantics()) return failure();
+    Value input = op.inputs()[0];
+    Value filter = op.inputs()[1];
+    Value output = op.outputs()[0];
+    if (!isSupportedContraction(input, filter, output) ||
+        !areBufferViews(op->getOperands())) {
+      return failure();
+    }
+    auto convStrides = llvm::to_vector<2>(op.strides().getValues<int64_t>());
+    auto dilations = llvm::to_vector<2>(op.dilations().getValues<int64_t>());
+
+    Location loc = op.getLoc();
+    BufferView in = getBufferView(input, rewriter, loc);
+    BufferView fil = getBufferView(filter, rewriter, loc);
+    BufferView out = getBufferView(output, rewriter, loc);
+    auto scale = [&](Value value, int64_t factor) {
+      return rewriter.createOrFold<arith::MulIOp>(
+          loc, value,
+          rewriter.createOrFold<arith::ConstantIndexOp>(loc, factor));
+    };
+
+    // Loops are (n, oh, ow, f, kh, kw, c) as in the linalg op.
+    enum { N, OH, OW, F, KH, KW, C };
+    Value zero = rewriter.createOrFold<arith::ConstantIndexOp>(loc, 0);
+    LoopView inView{in.buffer,
+                    in.offset,
+                    {in.strides[0], scale(in.strides[1], convStrides[0]),
+                     scale(in.strides[2], convStrides[1]), zero,
+                     scale(in.strides[1], dilations[0]),
+                     scale(in.strides[2], dilations[1]), in.strides[3]}};
+    LoopView filView{fil.buffer,
+                     fil.offset,
+                     {zero, zero, zero, fil.strides[3], fil.strides[0],
+                      fil.strides[1], fil.strides[2]}};
+    LoopView outView{out.buffer,
+                     out.offset,
+                     {out.strides[0], out.strides[1], out.strides[2],
+                      out.strides[3], zero, zero, zero}};
+    SmallVector<LoopView> views = {inView, filView, outView};
+    SmallVector<Value> loopSizes = {out.sizes[0], out.sizes[1], out.sizes[2],
+                                    out.sizes[3], fil.sizes[0], fil.sizes[1],
+                                    fil.sizes[2]};
+    buildOuterLoops(
+        rewriter, loc, {N, OH, KH, KW}, loopSizes, views,
+        [&](OpBuilder &builder, Location nestedLoc, ArrayRef<Value> offsets) {
+          buildMatmul(builder, nestedLoc, views, offsets, loopSizes, OW, F,
+                      C);
+        });
+    rewriter.eraseOp(op);
+    return success();
+  }
+};
+
+}  // namespace
+
+void populateLinalgToVMVXPatterns(MLIRContext *context,
+                                  RewritePatternSet &patterns) {
+  patterns.insert<LinalgConv2DNhwcHwcfToVMVX, LinalgFillToVMVX,
+                  LinalgGenericElementwiseToVMVX, LinalgGenericReductionToVMVX,
+                  LinalgMatmulToVMVX<linalg::BatchMatmulOp>,
+                  LinalgMatmulToVMVX<linalg::MatmulOp>, LinalgMmt4dToVMVX>(
+      context);
+}
+
+}  // namespace iree_compiler
+}  // namespace mlir
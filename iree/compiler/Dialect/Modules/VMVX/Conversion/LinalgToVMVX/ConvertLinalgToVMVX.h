@@ -0,0 +1,24 @@
+// Copyright 2022 The IREE Authors
+//
+// Licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+#ifndef IREE_COMPILER_DIALECT_VMVX_CONVERSION_LINALGTOVMVX_CONVERTLINALGTOVMVX_H_
+#define IREE_COMPILER_DIALECT_VMVX_CONVERSION_LINALGTOVMVX_CONVERTLINALGTOVMVX_H_
+
+#include "mlir/IR/PatternMatch.h"
+
+namespace mlir {
+namespace iree_compiler {
+
+// Populates patterns that rewrite linalg ops on views of HAL bindings to VMVX
+// microkernel ops. Ops that cannot be expressed as strided VMVX ops are left
+// untouched so that they can be lowered to loops.
+void populateLinalgToVMVXPatterns(MLIRContext *context,
+                                  RewritePatternSet &patterns);
+
+}  // namespace iree_compiler
+}  // namespace mlir
+
+#endif  // IREE_COMPILER_DIALECT_VMVX_CONVERSION_LINALGTOVMVX_CONVERTLINALGTOVMVX_H_
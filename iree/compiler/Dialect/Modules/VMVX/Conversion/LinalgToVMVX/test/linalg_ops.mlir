@@ -0,0 +1,198 @@
+// RUN: iree-opt -split-input-file -iree-vmvx-lower-linalg -canonicalize -cse %s | FileCheck %s
+
+// CHECK-LABEL: func @matmul_f32
+func.func @matmul_f32() {
+  %c0 = arith.constant 0 : index
+  %c64 = arith.constant 64 : index
+  //  CHECK-DAG: %[[C0:.+]] = arith.constant 0 : index
+  //  CHECK-DAG: %[[C1:.+]] = arith.constant 1 : index
+  //  CHECK-DAG: %[[C4:.+]] = arith.constant 4 : index
+  //  CHECK-DAG: %[[C16:.+]] = arith.constant 16 : index
+  //  CHECK-DAG: %[[LHS:.+]] = hal.interface.binding.subspan set(0) binding(0) type(storage_buffer) offset(%[[C0]]) : memref<?xf32>{%[[C16]]}
+  //  CHECK-DAG: %[[RHS:.+]] = hal.interface.binding.subspan set(0) binding(1) type(storage_buffer) offset(%[[C0]]) : memref<?xf32>{%[[C16]]}
+  //  CHECK-DAG: %[[OUT:.+]] = hal.interface.binding.subspan set(0) binding(2) type(storage_buffer) offset(%[[C0]]) : memref<?xf32>
+  %lhs = hal.interface.binding.subspan set(0) binding(0) type(storage_buffer) offset(%c0) : memref<4x4xf32>
+  %rhs = hal.interface.binding.subspan set(0) binding(1) type(storage_buffer) offset(%c0) : memref<4x4xf32>
+  %out = hal.interface.binding.subspan set(0) binding(2) type(storage_buffer) offset(%c64) : memref<4x4xf32>
+  //      CHECK: vmvx.matmul
+  // CHECK-SAME:   lhs(%[[LHS]] offset %[[C0]] strides[%[[C4]], %[[C1]]] : memref<?xf32>)
+  // CHECK-SAME:   rhs(%[[RHS]] offset %[[C0]] strides[%[[C4]], %[[C1]]] : memref<?xf32>)
+  // CHECK-SAME:   out(%[[OUT]] offset %[[C16]] strides[%[[C4]], %[[C1]]] : memref<?xf32>)
+  // CHECK-SAME:   mnk(%[[C4]], %[[C4]], %[[C4]])
+  linalg.matmul ins(%lhs, %rhs : memref<4x4xf32>, memref<4x4xf32>) outs(%out : memref<4x4xf32>)
+  return
+}
+
+// -----
+
+// CHECK-LABEL: func @fill_subview
+func.func @fill_subview(%offset: index) {
+  %c0 = arith.constant 0 : index
+  %cst = arith.constant 1.0 : f32
+  //  CHECK-DAG: %[[C1:.+]] = arith.constant 1 : index
+  //  CHECK-DAG: %[[C2:.+]] = arith.constant 2 : index
+  //  CHECK-DAG: %[[C8:.+]] = arith.constant 8 : index
+  //  CHECK-DAG: %[[VALUE:.+]] = arith.constant 1065353216 : i32
+  //  CHECK-DAG: %[[BUFFER:.+]] = hal.interface.binding.subspan set(0) binding(0) {{.+}} : memref<?xf32>
+  //      CHECK: %[[OFFSET:.+]] = arith.muli %{{.+}}, %[[C8]]
+  //      CHECK: vmvx.fill2d value(%[[VALUE]])
+  // CHECK-SAME:   out(%[[BUFFER]] offset %[[OFFSET]] strides[%[[C8]], %[[C1]]] : memref<?xf32>)
+  // CHECK-SAME:   sizes(%[[C2]], %[[C8]])
+  %0 = hal.interface.binding.subspan set(0) binding(0) type(storage_buffer) offset(%c0) : memref<8x8xf32>
+  %1 = memref.subview %0[%offset, 0] [2, 8] [1, 1] : memref<8x8xf32> to memref<2x8xf32, affine_map<(d0, d1)[s0] -> (d0 * 8 + s0 + d1)>>
+  linalg.fill ins(%cst : f32) outs(%1 : memref<2x8xf32, affine_map<(d0, d1)[s0] -> (d0 * 8 + s0 + d1)>>)
+  return
+}
+
+// -----
+
+// CHECK-LABEL: func @add_broadcast
+func.func @add_broadcast() {
+  %c0 = arith.constant 0 : index
+  //  CHECK-DAG: %[[C0:.+]] = arith.constant 0 : index
+  //  CHECK-DAG: %[[C1:.+]] = arith.constant 1 : index
+  //  CHECK-DAG: %[[C4:.+]] = arith.constant 4 : index
+  //  CHECK-DAG: %[[C8:.+]] = arith.constant 8 : index
+  //  CHECK-DAG: %[[LHS:.+]] = hal.interface.binding.subspan set(0) binding(0) {{.+}} : memref<?xf32>
+  //  CHECK-DAG: %[[RHS:.+]] = hal.interface.binding.subspan set(0) binding(1) {{.+}} : memref<?xf32>
+  //  CHECK-DAG: %[[OUT:.+]] = hal.interface.binding.subspan set(0) binding(2) {{.+}} : memref<?xf32>
+  //      CHECK: vmvx.binary op("add")
+  // CHECK-SAME:   lhs(%[[LHS]] offset %[[C0]] strides[%[[C8]], %[[C1]]] : memref<?xf32>)
+  // CHECK-SAME:   rhs(%[[RHS]] offset %[[C0]] strides[%[[C0]], %[[C1]]] : memref<?xf32>)
+  // CHECK-SAME:   out(%[[OUT]] offset %[[C0]] strides[%[[C8]], %[[C1]]] : memref<?xf32>)
+  // CHECK-SAME:   sizes(%[[C4]], %[[C8]])
+  %lhs = hal.interface.binding.subspan set(0) binding(0) type(storage_buffer) offset(%c0) : memref<4x8xf32>
+  %rhs = hal.interface.binding.subspan set(0) binding(1) type(storage_buffer) offset(%c0) : memref<8xf32>
+  %out = hal.interface.binding.subspan set(0) binding(2) type(storage_buffer) offset(%c0) : memref<4x8xf32>
+  linalg.generic {
+    indexing_maps = [affine_map<(d0, d1) -> (d0, d1)>,
+                     affine_map<(d0, d1) -> (d1)>,
+                     affine_map<(d0, d1) -> (d0, d1)>],
+    iterator_types = ["parallel", "parallel"]}
+    ins(%lhs, %rhs : memref<4x8xf32>, memref<8xf32>) outs(%out : memref<4x8xf32>) {
+  ^bb0(%a: f32, %b: f32, %c: f32):
+    %sum = arith.addf %a, %b : f32
+    linalg.yield %sum : f32
+  }
+  return
+}
+
+// -----
+
+// CHECK-LABEL: func @transpose_copy_3d
+func.func @transpose_copy_3d() {
+  %c0 = arith.constant 0 : index
+  //  CHECK-DAG: %[[C0:.+]] = arith.constant 0 : index
+  //  CHECK-DAG: %[[C1:.+]] = arith.constant 1 : index
+  //  CHECK-DAG: %[[C2:.+]] = arith.constant 2 : index
+  //  CHECK-DAG: %[[C3:.+]] = arith.constant 3 : index
+  //  CHECK-DAG: %[[C4:.+]] = arith.constant 4 : index
+  //      CHECK: scf.for %[[I:.+]] = %[[C0]] to %[[C2]] step %[[C1]]
+  //      CHECK:   vmvx.copy
+  // CHECK-SAME:     strides[%[[C1]], %[[C3]]] : memref<?xi32>)
+  // CHECK-SAME:     strides[%[[C4]], %[[C1]]] : memref<?xi32>)
+  // CHECK-SAME:     sizes(%[[C3]], %[[C4]])
+  %in = hal.interface.binding.subspan set(0) binding(0) type(storage_buffer) offset(%c0) : memref<2x4x3xi32>
+  %out = hal.interface.binding.subspan set(0) binding(1) type(storage_buffer) offset(%c0) : memref<2x3x4xi32>
+  linalg.generic {
+    indexing_maps = [affine_map<(d0, d1, d2) -> (d0, d2, d1)>,
+                     affine_map<(d0, d1, d2) -> (d0, d1, d2)>],
+    iterator_types = ["parallel", "parallel", "parallel"]}
+    ins(%in : memref<2x4x3xi32>) outs(%out : memref<2x3x4xi32>) {
+  ^bb0(%a: i32, %b: i32):
+    linalg.yield %a : i32
+  }
+  return
+}
+
+// -----
+
+// CHECK-LABEL: func @reduce_rows
+func.func @reduce_rows() {
+  %c0 = arith.constant 0 : index
+  //  CHECK-DAG: %[[C1:.+]] = arith.constant 1 : index
+  //  CHECK-DAG: %[[C4:.+]] = arith.constant 4 : index
+  //  CHECK-DAG: %[[C16:.+]] = arith.constant 16 : index
+  //      CHECK: vmvx.reduce op("sum")
+  // CHECK-SAME:   strides[%[[C16]], %[[C1]]] : memref<?xf32>)
+  // CHECK-SAME:   strides[%[[C1]]] : memref<?xf32>)
+  // CHECK-SAME:   sizes(%[[C4]], %[[C16]])
+  %in = hal.interface.binding.subspan set(0) binding(0) type(storage_buffer) offset(%c0) : memref<4x16xf32>
+  %out = hal.interface.binding.subspan set(0) binding(1) type(storage_buffer) offset(%c0) : memref<4xf32>
+  linalg.generic {
+    indexing_maps = [affine_map<(d0, d1) -> (d0, d1)>,
+                     affine_map<(d0, d1) -> (d0)>],
+    iterator_types = ["parallel", "reduction"]}
+    ins(%in : memref<4x16xf32>) outs(%out : memref<4xf32>) {
+  ^bb0(%a: f32, %b: f32):
+    %sum = arith.addf %a, %b : f32
+    linalg.yield %sum : f32
+  }
+  return
+}
+
+// -----
+
+// CHECK-LABEL: func @conv_2d_nhwc_hwcf
+func.func @conv_2d_nhwc_hwcf() {
+  %c0 = arith.constant 0 : index
+  %in = hal.interface.binding.subspan set(0) binding(0) type(storage_buffer) offset(%c0) : memref<1x5x5x2xf32>
+  %filter = hal.interface.binding.subspan set(0) binding(1) type(storage_buffer) offset(%c0) : memref<3x3x2x4xf32>
+  %out = hal.interface.binding.subspan set(0) binding(2) type(storage_buffer) offset(%c0) : memref<1x2x2x4xf32>
+  // The unit batch loop folds away leaving the (oh, kh, kw) loops.
+  //      CHECK: scf.for
+  //      CHECK:   scf.for
+  //      CHECK:     scf.for
+  //      CHECK:       vmvx.matmul
+  //  CHECK-NOT: linalg.conv_2d_nhwc_hwcf
+  linalg.conv_2d_nhwc_hwcf {dilations = dense<1> : tensor<2xi64>, strides = dense<2> : tensor<2xi64>}
+    ins(%in, %filter : memref<1x5x5x2xf32>, memref<3x3x2x4xf32>) outs(%out : memref<1x2x2x4xf32>)
+  return
+}
+
+// -----
+
+// CHECK-LABEL: func @unsupported_generic
+func.func @unsupported_generic() {
+  %c0 = arith.constant 0 : index
+  %in = hal.interface.binding.subspan set(0) binding(0) type(storage_buffer) offset(%c0) : memref<4xf32>
+  %out = hal.interface.binding.subspan set(0) binding(1) type(storage_buffer) offset(%c0) : memref<4xi32>
+  // CHECK: linalg.generic
+  linalg.generic {
+    indexing_maps = [affine_map<(d0) -> (d0)>, affine_map<(d0) -> (d0)>],
+    iterator_types = ["parallel"]}
+    ins(%in : memref<4xf32>) outs(%out : memref<4xi32>) {
+  ^bb0(%a: f32, %b: i32):
+    %cast = arith.fptosi %a : f32 to i32
+    linalg.yield %cast : i32
+  }
+  return
+}
+
+// -----
+
+// Byte offsets that are not a multiple of the element size cannot be expressed
+// as element offsets and must be left to the generic lowering.
+
+// CHECK-LABEL: func @fill_unaligned_offset
+func.func @fill_unaligned_offset() {
+  %c2 = arith.constant 2 : index
+  %cst = arith.constant 1.0 : f32
+  //  CHECK-NOT: vmvx.fill2d
+  //      CHECK: linalg.fill
+  %0 = hal.interface.binding.subspan set(0) binding(0) type(storage_buffer) offset(%c2) : memref<8x8xf32>
+  linalg.fill ins(%cst : f32) outs(%0 : memref<8x8xf32>)
+  return
+}
+
+// -----
+
+// CHECK-LABEL: func @fill_dynamic_offset
+func.func @fill_dynamic_offset(%offset: index) {
+  %cst = arith.constant 1.0 : f32
+  //  CHECK-NOT: vmvx.fill2d
+  //      CHECK: linalg.fill
+  %0 = hal.interface.binding.subspan set(0) binding(0) type(storage_buffer) offset(%offset) : memref<8x8xf32>
+  linalg.fill ins(%cst : f32) outs(%0 : memref<8x8xf32>)
+  return
+}
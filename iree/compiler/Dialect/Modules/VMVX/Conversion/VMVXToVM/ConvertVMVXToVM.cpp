@@ -49,13 +49,13 @@ class VMVXImportOpConversion : public OpConversionPattern<T> {
  public:
   VMVXImportOpConversion(MLIRContext *context, SymbolTable &importSymbols,
                          TypeConverter &typeConverter, StringRef importName)
-      : OpConversionPattern<T>(context),
+      : OpConversionPattern<T>(typeConverter, context),
         importSymbols(importSymbols),
         typeConverter(typeConverter),
         importName(importName) {}
 
   LogicalResult matchAndRewrite(
-      T op, llvm::ArrayRef<Value> operands,
+      T op, Adaptor adaptor,
       ConversionPatternRewriter &rewriter) const override {
     std::string importFqName = importName + getImportSuffix(op);
     auto importOp =
@@ -66,7 +66,7 @@ class VMVXImportOpConversion : public OpConversionPattern<T> {
       return failure();
     }
     auto results =
-        rewriteToCall(op, Adaptor{operands}, importOp, typeConverter, rewriter);
+        rewriteToCall(op, adaptor, importOp, typeConverter, rewriter);
     if (!results.hasValue()) return failure();
     rewriter.replaceOp(op, results.getValue());
     return success();
@@ -115,12 +115,94 @@ class VMVXImportOpConversion : public OpConversionPattern<T> {
   patterns.insert<VMVXImportOpConversion<op_type>>( \
       context, importSymbols, typeConverter, op_mnemonic);
 
+// Returns the element type of the memref |buffer|.
+static Type getBufferElementType(Value buffer) {
+  return buffer.getType().cast<ShapedType>().getElementType();
+}
+
+// vmvx.binary -> vmvx.<opcode>.2d.<type>
+class BinaryOpConversion
+    : public VMVXImportOpConversion<IREE::VMVX::BinaryOp> {
+ public:
+  using VMVXImportOpConversion::VMVXImportOpConversion;
+
+ protected:
+  std::string getImportSuffix(IREE::VMVX::BinaryOp op) const override {
+    return op.opcode().str() + ".2d." +
+           getTypedTypeStr(getBufferElementType(op.out_buffer()));
+  }
+};
+
+// vmvx.unary -> vmvx.<opcode>.2d.<type>
+class UnaryOpConversion : public VMVXImportOpConversion<IREE::VMVX::UnaryOp> {
+ public:
+  using VMVXImportOpConversion::VMVXImportOpConversion;
+
+ protected:
+  std::string getImportSuffix(IREE::VMVX::UnaryOp op) const override {
+    return op.opcode().str() + ".2d." +
+           getTypedTypeStr(getBufferElementType(op.out_buffer()));
+  }
+};
+
+// vmvx.copy -> vmvx.copy.2d.x<bits>
+class CopyOpConversion : public VMVXImportOpConversion<IREE::VMVX::CopyOp> {
+ public:
+  using VMVXImportOpConversion::VMVXImportOpConversion;
+
+ protected:
+  std::string getImportSuffix(IREE::VMVX::CopyOp op) const override {
+    return ".2d." + getSizedTypeStr(getBufferElementType(op.out_buffer()));
+  }
+};
+
+// vmvx.reduce -> vmvx.reduce.<opcode>.2d.<type>
+class ReduceOpConversion
+    : public VMVXImportOpConversion<IREE::VMVX::ReduceOp> {
+ public:
+  using VMVXImportOpConversion::VMVXImportOpConversion;
+
+ protected:
+  std::string getImportSuffix(IREE::VMVX::ReduceOp op) const override {
+    return "." + op.opcode().str() + ".2d." +
+           getTypedTypeStr(getBufferElementType(op.out_buffer()));
+  }
+};
+
+// vmvx.matmul/vmvx.mmt4d -> vmvx.<name>.<lhs type><rhs type><out type>
+template <typename T>
+class ContractionOpConversion : public VMVXImportOpConversion<T> {
+ public:
+  using VMVXImportOpConversion<T>::VMVXImportOpConversion;
+
+ protected:
+  std::string getImportSuffix(T op) const override {
+    return "." + this->getTypedTypeStr(getBufferElementType(op.lhs_buffer())) +
+           this->getTypedTypeStr(getBufferElementType(op.rhs_buffer())) +
+           this->getTypedTypeStr(getBufferElementType(op.out_buffer()));
+  }
+};
+
 }  // namespace
 
 void populateVMVXToVMPatterns(MLIRContext *context,
                               TypeConverter &typeConverter,
                               SymbolTable &importSymbols,
-                              RewritePatternSet &patterns) {}
+                              RewritePatternSet &patterns) {
+  patterns.insert<BinaryOpConversion>(context, importSymbols, typeConverter,
+                                      "vmvx.");
+  patterns.insert<UnaryOpConversion>(context, importSymbols, typeConverter,
+                                     "vmvx.");
+  patterns.insert<CopyOpConversion>(context, importSymbols, typeConverter,
+                                    "vmvx.copy");
+  VMVX_IMPORT_OP(IREE::VMVX::Fill2DOp, "vmvx.fill.2d.x32");
+  patterns.insert<ReduceOpConversion>(context, importSymbols, typeConverter,
+                                      "vmvx.reduce");
+  patterns.insert<ContractionOpConversion<IREE::VMVX::MatmulOp>>(
+      context, importSymbols, typeConverter, "vmvx.matmul");
+  patterns.insert<ContractionOpConversion<IREE::VMVX::Mmt4dOp>>(
+      context, importSymbols, typeConverter, "vmvx.mmt4d");
+}
 
 }  // namespace iree_compiler
 }  // namespace mlir
@@ -0,0 +1,54 @@
+// RUN: iree-opt -split-input-file %s | iree-opt -split-input-file | FileCheck %s
+
+// CHECK-LABEL: @binary
+func.func @binary(%lhs: memref<?xf32>, %rhs: memref<?xf32>, %out: memref<?xf32>, %offset: index, %size: index) {
+  %c0 = arith.constant 0 : index
+  %c1 = arith.constant 1 : index
+  //      CHECK: vmvx.binary op("add")
+  // CHECK-SAME:   lhs(%arg0 offset %arg3 strides[%c1, %c0] : memref<?xf32>)
+  // CHECK-SAME:   rhs(%arg1 offset %c0 strides[%c0, %c1] : memref<?xf32>)
+  // CHECK-SAME:   out(%arg2 offset %c0 strides[%arg4, %c1] : memref<?xf32>)
+  // CHECK-SAME:   sizes(%arg4, %arg4)
+  vmvx.binary op("add")
+      lhs(%lhs offset %offset strides[%c1, %c0] : memref<?xf32>)
+      rhs(%rhs offset %c0 strides[%c0, %c1] : memref<?xf32>)
+      out(%out offset %c0 strides[%size, %c1] : memref<?xf32>)
+      sizes(%size, %size)
+  return
+}
+
+// -----
+
+// CHECK-LABEL: @fill2d
+func.func @fill2d(%out: memref<?xi32>, %value: i32, %size: index) {
+  %c0 = arith.constant 0 : index
+  %c1 = arith.constant 1 : index
+  //      CHECK: vmvx.fill2d value(%arg1)
+  // CHECK-SAME:   out(%arg0 offset %c0 strides[%arg2, %c1] : memref<?xi32>)
+  // CHECK-SAME:   sizes(%arg2, %arg2)
+  vmvx.fill2d value(%value)
+      out(%out offset %c0 strides[%size, %c1] : memref<?xi32>)
+      sizes(%size, %size)
+  return
+}
+
+// -----
+
+// CHECK-LABEL: @mmt4d
+func.func @mmt4d(%lhs: memref<?xi8>, %rhs: memref<?xi8>, %out: memref<?xi32>, %m: index, %n: index, %k: index) {
+  %c0 = arith.constant 0 : index
+  %c4 = arith.constant 4 : index
+  //      CHECK: vmvx.mmt4d
+  // CHECK-SAME:   lhs(%arg0 offset %c0 strides[%arg5] : memref<?xi8>)
+  // CHECK-SAME:   rhs(%arg1 offset %c0 strides[%arg5] : memref<?xi8>)
+  // CHECK-SAME:   out(%arg2 offset %c0 strides[%arg4] : memref<?xi32>)
+  // CHECK-SAME:   mnk(%arg3, %arg4, %arg5)
+  // CHECK-SAME:   tile(%c4, %c4, %c4)
+  vmvx.mmt4d
+      lhs(%lhs offset %c0 strides[%k] : memref<?xi8>)
+      rhs(%rhs offset %c0 strides[%k] : memref<?xi8>)
+      out(%out offset %c0 strides[%n] : memref<?xi32>)
+      mnk(%m, %n, %k)
+      tile(%c4, %c4, %c4)
+  return
+}
@@ -6,6 +6,7 @@
 
 #include "iree/compiler/Dialect/HAL/IR/HALDialect.h"
 #include "iree/compiler/Dialect/Modules/VMVX/Conversion/HALToVMVX/ConvertHALToVMVX.h"
+#include "iree/compiler/Dialect/Modules/VMVX/Conversion/LinalgToVMVX/ConvertLinalgToVMVX.h"
 #include "iree/compiler/Dialect/Modules/VMVX/Conversion/StandardToVMVX/ConvertStandardToVMVX.h"
 #include "iree/compiler/Dialect/Modules/VMVX/IR/VMVXDialect.h"
 #include "iree/compiler/Dialect/Modules/VMVX/IR/VMVXTypes.h"
@@ -17,12 +18,14 @@
 #include "mlir/Dialect/Affine/IR/AffineOps.h"
 #include "mlir/Dialect/Func/IR/FuncOps.h"
 #include "mlir/Dialect/MemRef/IR/MemRef.h"
+#include "mlir/Dialect/SCF/SCF.h"
 #include "mlir/Dialect/Tensor/IR/Tensor.h"
 #include "mlir/IR/BuiltinOps.h"
 #include "mlir/IR/PatternMatch.h"
 #include "mlir/Pass/Pass.h"
 #include "mlir/Pass/PassRegistry.h"
 #include "mlir/Transforms/DialectConversion.h"
+#include "mlir/Transforms/GreedyPatternRewriteDriver.h"
 
 namespace mlir {
 namespace iree_compiler {
@@ -101,6 +104,39 @@ std::unique_ptr<OperationPass<mlir::ModuleOp>> createConversionPass() {
 
 static PassRegistration<ConversionPass> pass;
 
+// Rewrites linalg ops to VMVX microkernel ops ahead of loop lowering.
+class LowerLinalgToVMVXPass
+    : public PassWrapper<LowerLinalgToVMVXPass,
+                         OperationPass<func::FuncOp>> {
+ public:
+  void getDependentDialects(DialectRegistry &registry) const override {
+    registry.insert<IREE::HAL::HALDialect, IREE::VMVX::VMVXDialect,
+                    arith::ArithmeticDialect, memref::MemRefDialect,
+                    scf::SCFDialect>();
+  }
+
+  StringRef getArgument() const override { return "iree-vmvx-lower-linalg"; }
+
+  StringRef getDescription() const override {
+    return "Lowers linalg ops to VMVX microkernel ops";
+  }
+
+  void runOnOperation() override {
+    RewritePatternSet patterns(&getContext());
+    populateLinalgToVMVXPatterns(&getContext(), patterns);
+    if (failed(applyPatternsAndFoldGreedily(getOperation(),
+                                            std::move(patterns)))) {
+      return signalPassFailure();
+    }
+  }
+};
+
+std::unique_ptr<OperationPass<func::FuncOp>> createLowerLinalgToVMVXPass() {
+  return std::make_unique<LowerLinalgToVMVXPass>();
+}
+
+static PassRegistration<LowerLinalgToVMVXPass> lowerLinalgPass;
+
 }  // namespace VMVX
 }  // namespace IREE
 }  // namespace iree_compiler
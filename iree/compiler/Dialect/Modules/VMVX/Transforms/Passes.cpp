@@ -49,6 +49,8 @@ static void buildVectorVMVXTransformPassPipeline(OpPassManager &passManager) {
   nestedModulePM.addNestedPass<func::FuncOp>(
       IREE::LinalgExt::createLinalgExtToLoopsPass());
   nestedModulePM.addNestedPass<func::FuncOp>(createMemrefCopyToLinalgPass());
+  // Ops with a matching VMVX microkernel skip loop lowering entirely.
+  nestedModulePM.addNestedPass<func::FuncOp>(createLowerLinalgToVMVXPass());
   nestedModulePM.addNestedPass<func::FuncOp>(createConvertLinalgToLoopsPass());
   nestedModulePM.addNestedPass<func::FuncOp>(createCanonicalizerPass());
   nestedModulePM.addNestedPass<func::FuncOp>(createCSEPass());
@@ -9,6 +9,7 @@
 
 #include "iree/compiler/Dialect/Modules/VMVX/IR/VMVXOps.h"
 #include "llvm/ADT/StringMap.h"
+#include "mlir/Dialect/Func/IR/FuncOps.h"
 #include "mlir/IR/BuiltinOps.h"
 #include "mlir/Pass/Pass.h"
 #include "mlir/Pass/PassManager.h"
@@ -44,6 +45,10 @@ void createVMVXTransformPassPipeline();
 // Converts from various dialects (HAL, standard, etc) to the VMVX dialect.
 std::unique_ptr<OperationPass<mlir::ModuleOp>> createConversionPass();
 
+// Rewrites linalg ops on HAL bindings to VMVX microkernel ops where possible.
+// Must run on buffers before linalg ops are lowered to loops.
+std::unique_ptr<OperationPass<func::FuncOp>> createLowerLinalgToVMVXPass();
+
 //===----------------------------------------------------------------------===//
 // Register all Passes
 //===----------------------------------------------------------------------===//
@@ -26,7 +26,523 @@
 vm.module @vmvx {
 
 //===----------------------------------------------------------------------===//
-// VMVX Ops: TODO
+// VMVX Ops: elementwise
 //===----------------------------------------------------------------------===//
 
+// All elementwise ops operate on strided 2-D views with element offsets and
+// strides. 1-D views use a size0 of 1 and higher ranks are looped over by the
+// compiler. Broadcasts are expressed with a stride of 0.
+
+// out[i, j] = lhs[i, j] <op> rhs[i, j]
+vm.import @add.2d.f32(
+  %lhs_buffer : !vm.buffer,
+  %lhs_offset : i32,
+  %lhs_stride0 : i32,
+  %lhs_stride1 : i32,
+  %rhs_buffer : !vm.buffer,
+  %rhs_offset : i32,
+  %rhs_stride0 : i32,
+  %rhs_stride1 : i32,
+  %out_buffer : !vm.buffer,
+  %out_offset : i32,
+  %out_stride0 : i32,
+  %out_stride1 : i32,
+  %size0 : i32,
+  %size1 : i32
+)
+
+vm.import @add.2d.i32(
+  %lhs_buffer : !vm.buffer,
+  %lhs_offset : i32,
+  %lhs_stride0 : i32,
+  %lhs_stride1 : i32,
+  %rhs_buffer : !vm.buffer,
+  %rhs_offset : i32,
+  %rhs_stride0 : i32,
+  %rhs_stride1 : i32,
+  %out_buffer : !vm.buffer,
+  %out_offset : i32,
+  %out_stride0 : i32,
+  %out_stride1 : i32,
+  %size0 : i32,
+  %size1 : i32
+)
+
+vm.import @and.2d.i32(
+  %lhs_buffer : !vm.buffer,
+  %lhs_offset : i32,
+  %lhs_stride0 : i32,
+  %lhs_stride1 : i32,
+  %rhs_buffer : !vm.buffer,
+  %rhs_offset : i32,
+  %rhs_stride0 : i32,
+  %rhs_stride1 : i32,
+  %out_buffer : !vm.buffer,
+  %out_offset : i32,
+  %out_stride0 : i32,
+  %out_stride1 : i32,
+  %size0 : i32,
+  %size1 : i32
+)
+
+vm.import @div.2d.f32(
+  %lhs_buffer : !vm.buffer,
+  %lhs_offset : i32,
+  %lhs_stride0 : i32,
+  %lhs_stride1 : i32,
+  %rhs_buffer : !vm.buffer,
+  %rhs_offset : i32,
+  %rhs_stride0 : i32,
+  %rhs_stride1 : i32,
+  %out_buffer : !vm.buffer,
+  %out_offset : i32,
+  %out_stride0 : i32,
+  %out_stride1 : i32,
+  %size0 : i32,
+  %size1 : i32
+)
+
+vm.import @max.2d.f32(
+  %lhs_buffer : !vm.buffer,
+  %lhs_offset : i32,
+  %lhs_stride0 : i32,
+  %lhs_stride1 : i32,
+  %rhs_buffer : !vm.buffer,
+  %rhs_offset : i32,
+  %rhs_stride0 : i32,
+  %rhs_stride1 : i32,
+  %out_buffer : !vm.buffer,
+  %out_offset : i32,
+  %out_stride0 : i32,
+  %out_stride1 : i32,
+  %size0 : i32,
+  %size1 : i32
+)
+
+vm.import @min.2d.f32(
+  %lhs_buffer : !vm.buffer,
+  %lhs_offset : i32,
+  %lhs_stride0 : i32,
+  %lhs_stride1 : i32,
+  %rhs_buffer : !vm.buffer,
+  %rhs_offset : i32,
+  %rhs_stride0 : i32,
+  %rhs_stride1 : i32,
+  %out_buffer : !vm.buffer,
+  %out_offset : i32,
+  %out_stride0 : i32,
+  %out_stride1 : i32,
+  %size0 : i32,
+  %size1 : i32
+)
+
+vm.import @mul.2d.f32(
+  %lhs_buffer : !vm.buffer,
+  %lhs_offset : i32,
+  %lhs_stride0 : i32,
+  %lhs_stride1 : i32,
+  %rhs_buffer : !vm.buffer,
+  %rhs_offset : i32,
+  %rhs_stride0 : i32,
+  %rhs_stride1 : i32,
+  %out_buffer : !vm.buffer,
+  %out_offset : i32,
+  %out_stride0 : i32,
+  %out_stride1 : i32,
+  %size0 : i32,
+  %size1 : i32
+)
+
+vm.import @mul.2d.i32(
+  %lhs_buffer : !vm.buffer,
+  %lhs_offset : i32,
+  %lhs_stride0 : i32,
+  %lhs_stride1 : i32,
+  %rhs_buffer : !vm.buffer,
+  %rhs_offset : i32,
+  %rhs_stride0 : i32,
+  %rhs_stride1 : i32,
+  %out_buffer : !vm.buffer,
+  %out_offset : i32,
+  %out_stride0 : i32,
+  %out_stride1 : i32,
+  %size0 : i32,
+  %size1 : i32
+)
+
+vm.import @or.2d.i32(
+  %lhs_buffer : !vm.buffer,
+  %lhs_offset : i32,
+  %lhs_stride0 : i32,
+  %lhs_stride1 : i32,
+  %rhs_buffer : !vm.buffer,
+  %rhs_offset : i32,
+  %rhs_stride0 : i32,
+  %rhs_stride1 : i32,
+  %out_buffer : !vm.buffer,
+  %out_offset : i32,
+  %out_stride0 : i32,
+  %out_stride1 : i32,
+  %size0 : i32,
+  %size1 : i32
+)
+
+vm.import @sub.2d.f32(
+  %lhs_buffer : !vm.buffer,
+  %lhs_offset : i32,
+  %lhs_stride0 : i32,
+  %lhs_stride1 : i32,
+  %rhs_buffer : !vm.buffer,
+  %rhs_offset : i32,
+  %rhs_stride0 : i32,
+  %rhs_stride1 : i32,
+  %out_buffer : !vm.buffer,
+  %out_offset : i32,
+  %out_stride0 : i32,
+  %out_stride1 : i32,
+  %size0 : i32,
+  %size1 : i32
+)
+
+vm.import @sub.2d.i32(
+  %lhs_buffer : !vm.buffer,
+  %lhs_offset : i32,
+  %lhs_stride0 : i32,
+  %lhs_stride1 : i32,
+  %rhs_buffer : !vm.buffer,
+  %rhs_offset : i32,
+  %rhs_stride0 : i32,
+  %rhs_stride1 : i32,
+  %out_buffer : !vm.buffer,
+  %out_offset : i32,
+  %out_stride0 : i32,
+  %out_stride1 : i32,
+  %size0 : i32,
+  %size1 : i32
+)
+
+vm.import @xor.2d.i32(
+  %lhs_buffer : !vm.buffer,
+  %lhs_offset : i32,
+  %lhs_stride0 : i32,
+  %lhs_stride1 : i32,
+  %rhs_buffer : !vm.buffer,
+  %rhs_offset : i32,
+  %rhs_stride0 : i32,
+  %rhs_stride1 : i32,
+  %out_buffer : !vm.buffer,
+  %out_offset : i32,
+  %out_stride0 : i32,
+  %out_stride1 : i32,
+  %size0 : i32,
+  %size1 : i32
+)
+
+// out[i, j] = <op>(in[i, j])
+vm.import @abs.2d.f32(
+  %in_buffer : !vm.buffer,
+  %in_offset : i32,
+  %in_stride0 : i32,
+  %in_stride1 : i32,
+  %out_buffer : !vm.buffer,
+  %out_offset : i32,
+  %out_stride0 : i32,
+  %out_stride1 : i32,
+  %size0 : i32,
+  %size1 : i32
+)
+
+vm.import @ceil.2d.f32(
+  %in_buffer : !vm.buffer,
+  %in_offset : i32,
+  %in_stride0 : i32,
+  %in_stride1 : i32,
+  %out_buffer : !vm.buffer,
+  %out_offset : i32,
+  %out_stride0 : i32,
+  %out_stride1 : i32,
+  %size0 : i32,
+  %size1 : i32
+)
+
+vm.import @exp.2d.f32(
+  %in_buffer : !vm.buffer,
+  %in_offset : i32,
+  %in_stride0 : i32,
+  %in_stride1 : i32,
+  %out_buffer : !vm.buffer,
+  %out_offset : i32,
+  %out_stride0 : i32,
+  %out_stride1 : i32,
+  %size0 : i32,
+  %size1 : i32
+)
+
+vm.import @floor.2d.f32(
+  %in_buffer : !vm.buffer,
+  %in_offset : i32,
+  %in_stride0 : i32,
+  %in_stride1 : i32,
+  %out_buffer : !vm.buffer,
+  %out_offset : i32,
+  %out_stride0 : i32,
+  %out_stride1 : i32,
+  %size0 : i32,
+  %size1 : i32
+)
+
+vm.import @log.2d.f32(
+  %in_buffer : !vm.buffer,
+  %in_offset : i32,
+  %in_stride0 : i32,
+  %in_stride1 : i32,
+  %out_buffer : !vm.buffer,
+  %out_offset : i32,
+  %out_stride0 : i32,
+  %out_stride1 : i32,
+  %size0 : i32,
+  %size1 : i32
+)
+
+vm.import @neg.2d.f32(
+  %in_buffer : !vm.buffer,
+  %in_offset : i32,
+  %in_stride0 : i32,
+  %in_stride1 : i32,
+  %out_buffer : !vm.buffer,
+  %out_offset : i32,
+  %out_stride0 : i32,
+  %out_stride1 : i32,
+  %size0 : i32,
+  %size1 : i32
+)
+
+vm.import @rsqrt.2d.f32(
+  %in_buffer : !vm.buffer,
+  %in_offset : i32,
+  %in_stride0 : i32,
+  %in_stride1 : i32,
+  %out_buffer : !vm.buffer,
+  %out_offset : i32,
+  %out_stride0 : i32,
+  %out_stride1 : i32,
+  %size0 : i32,
+  %size1 : i32
+)
+
+vm.import @sqrt.2d.f32(
+  %in_buffer : !vm.buffer,
+  %in_offset : i32,
+  %in_stride0 : i32,
+  %in_stride1 : i32,
+  %out_buffer : !vm.buffer,
+  %out_offset : i32,
+  %out_stride0 : i32,
+  %out_stride1 : i32,
+  %size0 : i32,
+  %size1 : i32
+)
+
+vm.import @tanh.2d.f32(
+  %in_buffer : !vm.buffer,
+  %in_offset : i32,
+  %in_stride0 : i32,
+  %in_stride1 : i32,
+  %out_buffer : !vm.buffer,
+  %out_offset : i32,
+  %out_stride0 : i32,
+  %out_stride1 : i32,
+  %size0 : i32,
+  %size1 : i32
+)
+
+//===----------------------------------------------------------------------===//
+// VMVX Ops: copy and fill
+//===----------------------------------------------------------------------===//
+
+// out[i, j] = in[i, j]
+vm.import @copy.2d.x8(
+  %in_buffer : !vm.buffer,
+  %in_offset : i32,
+  %in_stride0 : i32,
+  %in_stride1 : i32,
+  %out_buffer : !vm.buffer,
+  %out_offset : i32,
+  %out_stride0 : i32,
+  %out_stride1 : i32,
+  %size0 : i32,
+  %size1 : i32
+)
+
+vm.import @copy.2d.x16(
+  %in_buffer : !vm.buffer,
+  %in_offset : i32,
+  %in_stride0 : i32,
+  %in_stride1 : i32,
+  %out_buffer : !vm.buffer,
+  %out_offset : i32,
+  %out_stride0 : i32,
+  %out_stride1 : i32,
+  %size0 : i32,
+  %size1 : i32
+)
+
+vm.import @copy.2d.x32(
+  %in_buffer : !vm.buffer,
+  %in_offset : i32,
+  %in_stride0 : i32,
+  %in_stride1 : i32,
+  %out_buffer : !vm.buffer,
+  %out_offset : i32,
+  %out_stride0 : i32,
+  %out_stride1 : i32,
+  %size0 : i32,
+  %size1 : i32
+)
+
+vm.import @copy.2d.x64(
+  %in_buffer : !vm.buffer,
+  %in_offset : i32,
+  %in_stride0 : i32,
+  %in_stride1 : i32,
+  %out_buffer : !vm.buffer,
+  %out_offset : i32,
+  %out_stride0 : i32,
+  %out_stride1 : i32,
+  %size0 : i32,
+  %size1 : i32
+)
+
+// out[i, j] = value
+vm.import @fill.2d.x32(
+  %value : i32,
+  %out_buffer : !vm.buffer,
+  %out_offset : i32,
+  %out_stride0 : i32,
+  %out_stride1 : i32,
+  %size0 : i32,
+  %size1 : i32
+)
+
+//===----------------------------------------------------------------------===//
+// VMVX Ops: reductions
+//===----------------------------------------------------------------------===//
+
+// out[i] = <op>(out[i], in[i, 0], ..., in[i, size1 - 1])
+vm.import @reduce.max.2d.f32(
+  %in_buffer : !vm.buffer,
+  %in_offset : i32,
+  %in_stride0 : i32,
+  %in_stride1 : i32,
+  %out_buffer : !vm.buffer,
+  %out_offset : i32,
+  %out_stride : i32,
+  %size0 : i32,
+  %size1 : i32
+)
+
+vm.import @reduce.sum.2d.f32(
+  %in_buffer : !vm.buffer,
+  %in_offset : i32,
+  %in_stride0 : i32,
+  %in_stride1 : i32,
+  %out_buffer : !vm.buffer,
+  %out_offset : i32,
+  %out_stride : i32,
+  %size0 : i32,
+  %size1 : i32
+)
+
+vm.import @reduce.sum.2d.i32(
+  %in_buffer : !vm.buffer,
+  %in_offset : i32,
+  %in_stride0 : i32,
+  %in_stride1 : i32,
+  %out_buffer : !vm.buffer,
+  %out_offset : i32,
+  %out_stride : i32,
+  %size0 : i32,
+  %size1 : i32
+)
+
+//===----------------------------------------------------------------------===//
+// VMVX Ops: matrix multiplication
+//===----------------------------------------------------------------------===//
+
+// out[i, j] += sum(lhs[i, p] * rhs[p, j]) over strided 2-D views.
+vm.import @matmul.f32f32f32(
+  %lhs_buffer : !vm.buffer,
+  %lhs_offset : i32,
+  %lhs_stride0 : i32,
+  %lhs_stride1 : i32,
+  %rhs_buffer : !vm.buffer,
+  %rhs_offset : i32,
+  %rhs_stride0 : i32,
+  %rhs_stride1 : i32,
+  %out_buffer : !vm.buffer,
+  %out_offset : i32,
+  %out_stride0 : i32,
+  %out_stride1 : i32,
+  %m : i32,
+  %n : i32,
+  %k : i32
+)
+
+vm.import @matmul.i8i8i32(
+  %lhs_buffer : !vm.buffer,
+  %lhs_offset : i32,
+  %lhs_stride0 : i32,
+  %lhs_stride1 : i32,
+  %rhs_buffer : !vm.buffer,
+  %rhs_offset : i32,
+  %rhs_stride0 : i32,
+  %rhs_stride1 : i32,
+  %out_buffer : !vm.buffer,
+  %out_offset : i32,
+  %out_stride0 : i32,
+  %out_stride1 : i32,
+  %m : i32,
+  %n : i32,
+  %k : i32
+)
+
+// Matmul over linalg.mmt4d tiles: lhs[m, k, m0, k0] * rhs[n, k, n0, k0] is
+// accumulated into out[m, n, m0, n0]. Only the outer dimension of each operand
+// is strided and the inner tile dimensions must be contiguous.
+vm.import @mmt4d.f32f32f32(
+  %lhs_buffer : !vm.buffer,
+  %lhs_offset : i32,
+  %lhs_stride : i32,
+  %rhs_buffer : !vm.buffer,
+  %rhs_offset : i32,
+  %rhs_stride : i32,
+  %out_buffer : !vm.buffer,
+  %out_offset : i32,
+  %out_stride : i32,
+  %m : i32,
+  %n : i32,
+  %k : i32,
+  %m0 : i32,
+  %n0 : i32,
+  %k0 : i32
+)
+
+vm.import @mmt4d.i8i8i32(
+  %lhs_buffer : !vm.buffer,
+  %lhs_offset : i32,
+  %lhs_stride : i32,
+  %rhs_buffer : !vm.buffer,
+  %rhs_offset : i32,
+  %rhs_stride : i32,
+  %out_buffer : !vm.buffer,
+  %out_offset : i32,
+  %out_stride : i32,
+  %m : i32,
+  %n : i32,
+  %k : i32,
+  %m0 : i32,
+  %n0 : i32,
+  %k0 : i32
+)
+
 }  // module
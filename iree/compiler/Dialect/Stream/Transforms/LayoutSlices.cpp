@@ -4,6 +4,7 @@
 // See https://llvm.org/LICENSE.txt for license information.
 // SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
 
+#include <algorithm>
 #include <list>
 
 #include "iree/compiler/Dialect/Stream/IR/StreamDialect.h"
@@ -15,6 +16,7 @@
 #include "iree/compiler/Dialect/Util/IR/UtilOps.h"
 #include "iree/compiler/Dialect/Util/IR/UtilTypes.h"
 #include "iree/compiler/Utils/IndexSet.h"
+#include "llvm/ADT/Sequence.h"
 #include "llvm/Support/Debug.h"
 #include "mlir/Dialect/Arithmetic/IR/Arithmetic.h"
 #include "mlir/Dialect/Func/IR/FuncOps.h"
@@ -63,31 +65,22 @@ static Value packSlicesWithNoAliasing(
   return builder.createOrFold<IREE::Util::AlignOp>(loc, offset, rangeAlignment);
 }
 
-// Packs a set of statically-sized slices by greedy strip packing.
+// Places statically-sized |slices| one at a time in the given |order| using
+// greedy strip packing and stores the resulting offsets in |staticOffsets|.
+// Each slice is placed in the smallest gap between the reservations it
+// overlaps in lifetime with that can hold it (best-fit) or above all of them if
+// no such gap exists.
 //
 // This is the same algorithm used in tflite here:
 // https://github.com/tensorflow/tensorflow/blob/master/tensorflow/lite/simple_memory_arena.cc
-// It's not fantastic and can end up with a significant amount of wastage.
-// They do the packing at runtime and as such care more about performance than
-// we do while doing the packing here offline. For this initial version I
-// wanted to ensure we matched apples/apples their implementation.
-//
-// We should use a set of heuristics and pick the smallest one. There are also
-// some really great papers that have approximations (as all of these are -
-// 2D strip packing is NP-hard) such as
-// https://www.sciencedirect.com/science/article/pii/S0925772113001016 that
-// someone with a brain able to parse mathy papers can try implementing.
+// It's not fantastic and can end up with a significant amount of wastage
+// depending on the order the slices are placed in.
 //
-// Slice packed offset SSA values will be updated and start at the given
-// |baseOffset|. Returns |baseOffset| + the total size of the allocation
-// aligned to the requirements of |resourceConfig|.
-static Value packStaticSlicesGreedily(
-    IREE::Stream::ResourcePackOp packOp, Value baseOffset,
-    ArrayRef<Slice> slices, IREE::Stream::ResourceConfigAttr resourceConfig,
-    IndexSet &indexSet, OpBuilder &builder) {
-  int64_t offsetAlignment = resourceConfig.getMinBufferOffsetAlignment();
-  int64_t rangeAlignment = resourceConfig.getMinBufferRangeAlignment();
-
+// Returns the highwater mark of the packed slices (unaligned).
+static int64_t computeGreedyStaticLayout(
+    ArrayRef<Slice> slices, ArrayRef<int64_t> alignedSizes,
+    ArrayRef<size_t> order, int64_t offsetAlignment,
+    SmallVectorImpl<int64_t> &staticOffsets) {
   struct Reservation {
     const Slice *slice = nullptr;
     int64_t staticOffset = 0;
@@ -95,14 +88,14 @@ static Value packStaticSlicesGreedily(
   };
   static constexpr int64_t UNASSIGNED = INT64_MAX;
 
+  staticOffsets.assign(slices.size(), 0);
   std::list<Reservation> reservations;
   int64_t highwaterMark = 0;
-  for (auto &slice : slices) {
+  for (size_t sliceIndex : order) {
+    auto &slice = slices[sliceIndex];
+    int64_t alignedSize = alignedSizes[sliceIndex];
     int64_t bestOffset = UNASSIGNED;
     int64_t bestOffsetFit = UNASSIGNED;
-    int64_t staticSize =
-        cast<arith::ConstantIndexOp>(slice.dynamicSize.getDefiningOp()).value();
-    int64_t alignedSize = IREE::Util::align(staticSize, rangeAlignment);
 
     // Iterate through reservations (sorted by ascending offset) and identify
     // gaps in which the slice will fit. To reduce wastage we want to find the
@@ -141,13 +134,71 @@ static Value packStaticSlicesGreedily(
       ++insertionIt;
     }
     reservations.insert(insertionIt, reservation);
-    slice.packedOffset.replaceAllUsesWith(builder.createOrFold<arith::AddIOp>(
-        packOp.getLoc(), baseOffset, indexSet.get(bestOffset)));
+    staticOffsets[sliceIndex] = bestOffset;
 
     // Update highwater mark indicating how much memory needs to be allocated
     // for the entire slab.
     highwaterMark = std::max(highwaterMark, bestOffset + alignedSize);
   }
+  return highwaterMark;
+}
+
+// Packs a set of statically-sized slices by greedy strip packing.
+//
+// The result of greedy packing is highly dependent on placement order so we
+// try both the original program order (matching tflite) and decreasing size
+// order (placing the largest slices first such that smaller ones can fill the
+// gaps left between them) and keep whichever produces the smaller slab. There
+// are some really great papers that have better approximations (as all of
+// these are - 2D strip packing is NP-hard) such as
+// https://www.sciencedirect.com/science/article/pii/S0925772113001016 that
+// someone with a brain able to parse mathy papers can try implementing.
+//
+// Slice packed offset SSA values will be updated and start at the given
+// |baseOffset|. Returns |baseOffset| + the total size of the allocation
+// aligned to the requirements of |resourceConfig|.
+static Value packStaticSlicesGreedily(
+    IREE::Stream::ResourcePackOp packOp, Value baseOffset,
+    ArrayRef<Slice> slices, IREE::Stream::ResourceConfigAttr resourceConfig,
+    IndexSet &indexSet, OpBuilder &builder) {
+  int64_t offsetAlignment = resourceConfig.getMinBufferOffsetAlignment();
+  int64_t rangeAlignment = resourceConfig.getMinBufferRangeAlignment();
+
+  SmallVector<int64_t> alignedSizes;
+  alignedSizes.reserve(slices.size());
+  for (auto &slice : slices) {
+    int64_t staticSize =
+        cast<arith::ConstantIndexOp>(slice.dynamicSize.getDefiningOp()).value();
+    alignedSizes.push_back(IREE::Util::align(staticSize, rangeAlignment));
+  }
+
+  // Program order.
+  SmallVector<size_t> order =
+      llvm::to_vector(llvm::seq<size_t>(0, slices.size()));
+  SmallVector<int64_t> staticOffsets;
+  int64_t highwaterMark = computeGreedyStaticLayout(
+      slices, alignedSizes, order, offsetAlignment, staticOffsets);
+
+  // Decreasing size order; ties are broken by lifetime start.
+  std::stable_sort(order.begin(), order.end(), [&](size_t lhs, size_t rhs) {
+    if (alignedSizes[lhs] != alignedSizes[rhs]) {
+      return alignedSizes[lhs] > alignedSizes[rhs];
+    }
+    return slices[lhs].lifetimeStart < slices[rhs].lifetimeStart;
+  });
+  SmallVector<int64_t> sortedStaticOffsets;
+  int64_t sortedHighwaterMark = computeGreedyStaticLayout(
+      slices, alignedSizes, order, offsetAlignment, sortedStaticOffsets);
+  if (sortedHighwaterMark < highwaterMark) {
+    highwaterMark = sortedHighwaterMark;
+    staticOffsets = std::move(sortedStaticOffsets);
+  }
+
+  for (auto it : llvm::zip(slices, staticOffsets)) {
+    std::get<0>(it).packedOffset.replaceAllUsesWith(
+        builder.createOrFold<arith::AddIOp>(packOp.getLoc(), baseOffset,
+                                            indexSet.get(std::get<1>(it))));
+  }
 
   highwaterMark = IREE::Util::align(highwaterMark, rangeAlignment);
   return builder.createOrFold<arith::AddIOp>(packOp.getLoc(), baseOffset,
@@ -44,6 +44,8 @@ struct ConstantSlice {
   Value resultSize;
   // Constant value being encoded.
   Attribute value;
+  // Results of other slices with an identical value that share this storage.
+  SmallVector<Value> aliasedResults;
 
   // Returns the length, in bytes, of the constant value prior to alignment or
   // padding.
@@ -80,6 +82,8 @@ struct StorageResource {
   Location loc;
   // Total size in bytes (including padding).
   uint64_t totalSize = 0;
+  // Required alignment of the storage in bytes.
+  uint64_t alignment = 0;
   // Constant spans packed into this resource.
   SmallVector<PackedSpan, 8> spans;
   // Packed byte data that must be embedded in the final module.
@@ -88,31 +92,55 @@ struct StorageResource {
 };
 
 // Buckets |slices| into 1+ storage resources based on |resourceConfig|.
+// Each slice is appended to the resource with the least space remaining that
+// can still hold it (best-fit) such that smaller values fill the space left
+// behind when larger ones spill. Slices retain their relative order within a
+// resource to preserve any locality established by prior passes.
+//
+// Slices of at least |pageAlignmentThreshold| bytes (if non-zero) are placed
+// at |pageSize|-aligned offsets in resources that are themselves page-aligned
+// so that the runtime can map them directly from a memory-mapped module.
 static SmallVector<StorageResource, 8> bucketValuesIntoStorageResources(
     ArrayRef<ConstantSlice> slices,
-    IREE::Stream::ResourceConfigAttr resourceConfig) {
-  // TODO(benvanik): replace with a better strategy (best-fit, etc).
+    IREE::Stream::ResourceConfigAttr resourceConfig,
+    uint64_t pageAlignmentThreshold, uint64_t pageSize) {
   SmallVector<StorageResource, 8> storageBuffers;
-  storageBuffers.push_back({UnknownLoc::get(resourceConfig.getContext())});
-  StorageResource *currentBuffer = &storageBuffers.back();
+  uint64_t maxAllocationSize = resourceConfig.getMaxAllocationSize();
   for (auto slice : slices) {
-    uint64_t offset = IREE::Util::align(
-        currentBuffer->totalSize, resourceConfig.getMinBufferOffsetAlignment());
     uint64_t unpaddedLength = slice.getRawLength();
     uint64_t paddedLength = IREE::Util::align(
         unpaddedLength, resourceConfig.getMinBufferRangeAlignment());
-    if (offset + unpaddedLength > resourceConfig.getMaxAllocationSize()) {
-      // Spilling buffer; make a new one.
+    uint64_t offsetAlignment = resourceConfig.getMinBufferOffsetAlignment();
+    if (pageAlignmentThreshold && unpaddedLength >= pageAlignmentThreshold) {
+      offsetAlignment = std::max(offsetAlignment, pageSize);
+    }
+
+    // Find the resource that would have the least space remaining.
+    StorageResource *bestBuffer = nullptr;
+    uint64_t bestOffset = 0;
+    uint64_t bestRemaining = UINT64_MAX;
+    for (auto &storageBuffer : storageBuffers) {
+      uint64_t offset =
+          IREE::Util::align(storageBuffer.totalSize, offsetAlignment);
+      if (offset + unpaddedLength > maxAllocationSize) continue;
+      uint64_t remaining = maxAllocationSize - (offset + unpaddedLength);
+      if (remaining < bestRemaining) {
+        bestBuffer = &storageBuffer;
+        bestOffset = offset;
+        bestRemaining = remaining;
+      }
+    }
+    if (!bestBuffer) {
+      // Spilling all buffers; make a new one.
       storageBuffers.push_back({UnknownLoc::get(resourceConfig.getContext())});
-      currentBuffer = &storageBuffers.back();
-      offset = 0;
+      bestBuffer = &storageBuffers.back();
+      bestBuffer->alignment = resourceConfig.getMinBufferOffsetAlignment();
     }
-    currentBuffer->spans.push_back({slice, offset, unpaddedLength});
-    currentBuffer->totalSize =
-        std::max(currentBuffer->totalSize, offset + paddedLength);
-  }
-  if (storageBuffers.back().spans.empty()) {
-    storageBuffers.pop_back();
+
+    bestBuffer->spans.push_back({slice, bestOffset, unpaddedLength});
+    bestBuffer->totalSize =
+        std::max(bestBuffer->totalSize, bestOffset + paddedLength);
+    bestBuffer->alignment = std::max(bestBuffer->alignment, offsetAlignment);
   }
   return storageBuffers;
 }
@@ -190,7 +218,8 @@ static void packStorageResourceData(StorageResource &storageBuffer,
 // locality/lifetime/etc).
 static SmallVector<StorageResource, 8> computePackingMap(
     ArrayRef<ConstantSlice> slices,
-    IREE::Stream::ResourceConfigAttr resourceConfig, MLIRContext *context) {
+    IREE::Stream::ResourceConfigAttr resourceConfig,
+    uint64_t pageAlignmentThreshold, uint64_t pageSize, MLIRContext *context) {
   // This is literally all my brain has brain for right now. The ideal here is
   // that we have a basic static (and ideally profile-guided) sorting pass
   // that keeps constant values that are accessed sorted together.
@@ -219,12 +248,13 @@ static SmallVector<StorageResource, 8> computePackingMap(
   //
   // Here it's all descriptor sets and mapped pages but same thing pretty
   // much, and passes earlier on may duplicate constants in the pool if it
-  // means they can improve locality at runtime. This pass doesn't dedupe and
-  // just sticks to packing for that reason.
+  // means they can improve locality at runtime. Only exact duplicates within a
+  // single pool are deduplicated (by the caller) as those gain nothing from
+  // being stored twice.
 
-  // Build a list of resources and spans (append to current or spill to new).
-  auto storageBuffers =
-      bucketValuesIntoStorageResources(slices, resourceConfig);
+  // Build a list of resources and spans (best-fit or spill to new).
+  auto storageBuffers = bucketValuesIntoStorageResources(
+      slices, resourceConfig, pageAlignmentThreshold, pageSize);
 
   // Pack each storage resource bucket into a single data blob.
   for (auto &storageBuffer : storageBuffers) {
@@ -444,6 +474,11 @@ static UploadResult buildTryMapConstantResources(
 
 class PackConstantsPass : public PackConstantsBase<PackConstantsPass> {
  public:
+  PackConstantsPass() = default;
+  PackConstantsPass(unsigned pageAlignmentThreshold) {
+    this->pageAlignmentThreshold = pageAlignmentThreshold;
+  }
+
   void getDependentDialects(DialectRegistry &registry) const override {
     registry.insert<mlir::func::FuncDialect>();
     registry.insert<mlir::arith::ArithmeticDialect>();
@@ -464,15 +499,35 @@ class PackConstantsPass : public PackConstantsBase<PackConstantsPass> {
       auto resourceConfig =
           IREE::Stream::ResourceConfigAttr::lookup(constantsOp);
 
-      // Gather the slices produced by this constant pooling op.
+      // If this is producing constants (vs variables) we can try to go on a
+      // fast-path where we directly map the constant memory. If producing
+      // variables then we always need to stage and clone.
+      auto anyResult = constantsOp.results().front();
+      auto resourceType =
+          anyResult.getType().cast<IREE::Stream::ResourceType>();
+      bool isConstant =
+          resourceType.getLifetime() == IREE::Stream::Lifetime::Constant;
+
+      // Gather the slices produced by this constant pooling op. Constants are
+      // immutable and attributes are uniqued so any slices with the same
+      // value attribute can share storage. Variables must remain distinct.
       SmallVector<ConstantSlice> slices;
       slices.reserve(constantsOp.results().size());
+      DenseMap<Attribute, unsigned> uniqueSliceOrdinals;
       for (auto it :
            llvm::zip(constantsOp.results(), constantsOp.result_sizes(),
                      constantsOp.values())) {
         auto result = std::get<0>(it);
         auto resultSize = std::get<1>(it);
         auto value = std::get<2>(it);
+        if (isConstant) {
+          auto insertion =
+              uniqueSliceOrdinals.try_emplace(value, slices.size());
+          if (!insertion.second) {
+            slices[insertion.first->second].aliasedResults.push_back(result);
+            continue;
+          }
+        }
         slices.push_back(ConstantSlice{
             result,
             resultSize,
@@ -483,7 +538,8 @@ class PackConstantsPass : public PackConstantsBase<PackConstantsPass> {
       // Perform the packing of dense values to compute the storage resources we
       // will need and where each value will be placed.
       auto storageResources =
-          computePackingMap(slices, resourceConfig, constantsOp.getContext());
+          computePackingMap(slices, resourceConfig, pageAlignmentThreshold,
+                            pageSize, constantsOp.getContext());
       if (storageResources.empty()) return;
 
       OpBuilder builder(constantsOp);
@@ -498,19 +554,12 @@ class PackConstantsPass : public PackConstantsBase<PackConstantsPass> {
         auto rodataOp = builder.create<IREE::Util::ByteBufferConstantOp>(
             storageResource.loc, builder.getType<IREE::Util::ByteBufferType>(),
             storageResource.data,
-            builder.getI64IntegerAttr(
-                resourceConfig.getMinBufferOffsetAlignment()));
+            builder.getI64IntegerAttr(storageResource.alignment));
         storageBuffers.push_back(rodataOp);
       }
 
-      // If this is producing constants (vs variables) we can try to go on a
-      // fast-path where we directly map the constant memory. If producing
-      // variables then we always need to stage and clone.
-      auto anyResult = constantsOp.results().front();
-      auto resourceType =
-          anyResult.getType().cast<IREE::Stream::ResourceType>();
       UploadResult uploadResult;
-      if (resourceType.getLifetime() == IREE::Stream::Lifetime::Constant) {
+      if (isConstant) {
         uploadResult = buildTryMapConstantResources(
             constantsOp, resourceType, storageResources, storageBuffers,
             indexSet, builder);
@@ -530,6 +579,9 @@ class PackConstantsPass : public PackConstantsBase<PackConstantsPass> {
               loc, allocatedStorage.resource, allocatedStorage.resourceSize,
               indexSet.get(span.offset), span.slice.resultSize);
           span.slice.result.replaceAllUsesWith(subviewOp.result());
+          for (auto aliasedResult : span.slice.aliasedResults) {
+            aliasedResult.replaceAllUsesWith(subviewOp.result());
+          }
         }
       }
 
@@ -543,8 +595,9 @@ class PackConstantsPass : public PackConstantsBase<PackConstantsPass> {
 
 }  // namespace
 
-std::unique_ptr<InterfacePass<CallableOpInterface>> createPackConstantsPass() {
-  return std::make_unique<PackConstantsPass>();
+std::unique_ptr<InterfacePass<CallableOpInterface>> createPackConstantsPass(
+    unsigned pageAlignmentThreshold) {
+  return std::make_unique<PackConstantsPass>(pageAlignmentThreshold);
 }
 
 }  // namespace Stream
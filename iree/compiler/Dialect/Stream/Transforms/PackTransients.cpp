@@ -0,0 +1,309 @@
+// Copyright 2022 The IREE Authors
+//
+// Licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+#include "iree/compiler/Dialect/Stream/IR/StreamDialect.h"
+#include "iree/compiler/Dialect/Stream/IR/StreamOps.h"
+#include "iree/compiler/Dialect/Stream/IR/StreamTypes.h"
+#include "iree/compiler/Dialect/Stream/Transforms/PassDetail.h"
+#include "iree/compiler/Dialect/Stream/Transforms/Passes.h"
+#include "iree/compiler/Dialect/Util/IR/UtilDialect.h"
+#include "llvm/ADT/DenseMap.h"
+#include "llvm/ADT/MapVector.h"
+#include "llvm/Support/Debug.h"
+#include "mlir/Dialect/Func/IR/FuncOps.h"
+#include "mlir/IR/AsmState.h"
+#include "mlir/IR/Builders.h"
+#include "mlir/Interfaces/SideEffectInterfaces.h"
+#include "mlir/Pass/Pass.h"
+
+#define DEBUG_TYPE "iree-stream-pack-transients"
+
+namespace mlir {
+namespace iree_compiler {
+namespace IREE {
+namespace Stream {
+namespace {
+
+//===----------------------------------------------------------------------===//
+// Timeline analysis
+//===----------------------------------------------------------------------===//
+
+// Answers whether one timepoint is known to be reached only after another.
+// Only the ops produced by allocation scheduling are followed: anything else
+// (function arguments, imports, region results) is treated as unordered.
+class TimelineOrder {
+ public:
+  // Returns true if |timepoint| can only be reached after |target|.
+  bool isAfter(Value timepoint, Value target) {
+    if (!timepoint || !target) return false;
+    if (timepoint == target) return true;
+    auto key = std::make_pair(timepoint, target);
+    auto it = cache.find(key);
+    if (it != cache.end()) return it->second;
+    cache[key] = false;  // cycle guard
+    bool result = false;
+    auto *definingOp = timepoint.getDefiningOp();
+    if (auto joinOp =
+            dyn_cast_or_null<IREE::Stream::TimepointJoinOp>(definingOp)) {
+      result = llvm::any_of(joinOp.await_timepoints(), [&](Value operand) {
+        return isAfter(operand, target);
+      });
+    } else if (auto executeOp =
+                   dyn_cast_or_null<IREE::Stream::CmdExecuteOp>(definingOp)) {
+      result = isAfter(executeOp.await_timepoint(), target);
+    } else if (auto allocaOp =
+                   dyn_cast_or_null<IREE::Stream::ResourceAllocaOp>(
+                       definingOp)) {
+      result = isAfter(allocaOp.await_timepoint(), target);
+    } else if (auto deallocaOp =
+                   dyn_cast_or_null<IREE::Stream::ResourceDeallocaOp>(
+                       definingOp)) {
+      result = isAfter(deallocaOp.await_timepoint(), target);
+    }
+    cache[key] = result;
+    return result;
+  }
+
+ private:
+  DenseMap<std::pair<Value, Value>, bool> cache;
+};
+
+//===----------------------------------------------------------------------===//
+// Hoisting
+//===----------------------------------------------------------------------===//
+
+// Returns true if |value| is available at |insertionPoint| or can be made so by
+// moving the side-effect free ops computing it up.
+static bool isHoistableTo(Value value, Operation *insertionPoint) {
+  // Values are only ever queried from within the block of |insertionPoint| so
+  // anything defined outside of it (or a block argument) already dominates.
+  auto *definingOp = value.getDefiningOp();
+  if (!definingOp || definingOp->getBlock() != insertionPoint->getBlock()) {
+    return true;
+  }
+  if (definingOp->isBeforeInBlock(insertionPoint)) return true;
+  if (definingOp->getNumRegions() != 0 ||
+      !MemoryEffectOpInterface::hasNoEffect(definingOp)) {
+    return false;
+  }
+  return llvm::all_of(definingOp->getOperands(), [&](Value operand) {
+    return isHoistableTo(operand, insertionPoint);
+  });
+}
+
+// Moves the ops computing |value| before |insertionPoint|.
+// Requires that isHoistableTo returned true.
+static void hoistTo(Value value, Operation *insertionPoint) {
+  auto *definingOp = value.getDefiningOp();
+  if (!definingOp || definingOp->getBlock() != insertionPoint->getBlock() ||
+      definingOp->isBeforeInBlock(insertionPoint)) {
+    return;
+  }
+  for (auto operand : definingOp->getOperands()) {
+    hoistTo(operand, insertionPoint);
+  }
+  definingOp->moveBefore(insertionPoint);
+}
+
+//===----------------------------------------------------------------------===//
+// Transient arena packing
+//===----------------------------------------------------------------------===//
+
+// A stream-ordered transient allocation and its matching deallocation.
+struct Transient {
+  IREE::Stream::ResourceAllocaOp allocaOp;
+  IREE::Stream::ResourceDeallocaOp deallocaOp;
+};
+
+// Returns the deallocation of |allocaOp| if it is the only one and in the same
+// block as the allocation.
+static IREE::Stream::ResourceDeallocaOp findDealloca(
+    IREE::Stream::ResourceAllocaOp allocaOp) {
+  IREE::Stream::ResourceDeallocaOp deallocaOp;
+  for (auto *user : allocaOp.result().getUsers()) {
+    auto userDeallocaOp = dyn_cast<IREE::Stream::ResourceDeallocaOp>(user);
+    if (!userDeallocaOp) continue;
+    if (deallocaOp) return {};
+    deallocaOp = userDeallocaOp;
+  }
+  if (!deallocaOp || deallocaOp->getBlock() != allocaOp->getBlock()) return {};
+  return deallocaOp;
+}
+
+// Packs all |transients| into a single arena allocated before the first and
+// deallocated after the last. Each transient is assigned a lifetime interval
+// in the arena that spans from its own allocation through the last transient
+// that may execute concurrently with it on the timeline; stream.resource.pack
+// then allows transients with disjoint intervals to alias.
+static void packTransients(ArrayRef<Transient> transients,
+                           TimelineOrder &timelineOrder) {
+  auto firstAllocaOp = transients.front().allocaOp;
+  auto lastDeallocaOp = transients.back().deallocaOp;
+  for (auto &transient : transients) {
+    if (lastDeallocaOp->isBeforeInBlock(transient.deallocaOp)) {
+      lastDeallocaOp = transient.deallocaOp;
+    }
+  }
+
+  // A transient is in use from when its allocation is available until its
+  // deallocation is requested. Transient j can only reuse the memory of
+  // transient i if its use is ordered after the use of i completes.
+  SmallVector<int64_t> lifetimeIntervals;
+  SmallVector<Value> sizes;
+  SmallVector<Location> locs;
+  for (size_t i = 0; i < transients.size(); ++i) {
+    int64_t end = i;
+    auto completion = transients[i].deallocaOp.await_timepoint();
+    for (size_t j = i + 1; j < transients.size(); ++j) {
+      auto start = transients[j].allocaOp.await_timepoint();
+      if (!timelineOrder.isAfter(start, completion)) end = j;
+    }
+    lifetimeIntervals.push_back(i);
+    lifetimeIntervals.push_back(end);
+    sizes.push_back(transients[i].allocaOp.storage_size());
+    locs.push_back(transients[i].allocaOp.getLoc());
+    hoistTo(sizes.back(), firstAllocaOp);
+  }
+
+  // Allocate the arena up-front. We don't wait on anything as the transients
+  // each still wait on their original timepoints.
+  OpBuilder builder(firstAllocaOp);
+  auto fusedLoc = builder.getFusedLoc(locs);
+  auto indexType = builder.getIndexType();
+  SmallVector<Type> packedOffsetTypes(sizes.size(), indexType);
+  auto packOp = builder.create<IREE::Stream::ResourcePackOp>(
+      fusedLoc, indexType, packedOffsetTypes, /*offset=*/nullptr,
+      builder.getIndexArrayAttr(lifetimeIntervals), sizes,
+      firstAllocaOp.affinityAttr());
+  auto arenaOp = builder.create<IREE::Stream::ResourceAllocaOp>(
+      fusedLoc, firstAllocaOp.result().getType(),
+      firstAllocaOp.result_timepoint().getType(), packOp.total_length(),
+      /*await_timepoint=*/nullptr, firstAllocaOp.affinityAttr());
+  auto arena = arenaOp.result();
+  auto arenaSize = packOp.total_length();
+
+  // Replace each transient with a subview of the arena.
+  SmallVector<Value> completionTimepoints;
+  for (auto it : llvm::enumerate(transients)) {
+    auto allocaOp = it.value().allocaOp;
+    auto deallocaOp = it.value().deallocaOp;
+    builder.setInsertionPoint(allocaOp);
+    Value availableTimepoint = arenaOp.result_timepoint();
+    if (allocaOp.await_timepoint()) {
+      availableTimepoint = builder.create<IREE::Stream::TimepointJoinOp>(
+          allocaOp.getLoc(), availableTimepoint.getType(),
+          ValueRange{allocaOp.await_timepoint(), availableTimepoint});
+    }
+    auto subviewOp = builder.create<IREE::Stream::ResourceSubviewOp>(
+        allocaOp.getLoc(), arena, arenaSize,
+        packOp.packed_offsets()[it.index()], allocaOp.storage_size());
+    allocaOp.result_timepoint().replaceAllUsesWith(availableTimepoint);
+    allocaOp.result().replaceUsesWithIf(
+        subviewOp.result(),
+        [&](OpOperand &operand) { return operand.getOwner() != deallocaOp; });
+
+    // The transient memory is released when the arena is so the deallocation
+    // completes as soon as the transient is no longer in use.
+    if (auto completionTimepoint = deallocaOp.await_timepoint()) {
+      completionTimepoints.push_back(completionTimepoint);
+      deallocaOp.result_timepoint().replaceAllUsesWith(completionTimepoint);
+    } else {
+      deallocaOp.result_timepoint().replaceAllUsesWith(
+          arenaOp.result_timepoint());
+    }
+  }
+
+  // Release the arena after all transients are no longer in use.
+  builder.setInsertionPointAfter(lastDeallocaOp);
+  Value completionTimepoint;
+  if (completionTimepoints.size() == 1) {
+    completionTimepoint = completionTimepoints.front();
+  } else if (!completionTimepoints.empty()) {
+    completionTimepoint = builder.create<IREE::Stream::TimepointJoinOp>(
+        fusedLoc, completionTimepoints.front().getType(), completionTimepoints);
+  }
+  builder.create<IREE::Stream::ResourceDeallocaOp>(
+      fusedLoc, arena, arenaSize, completionTimepoint,
+      firstAllocaOp.affinityAttr());
+
+  for (auto &transient : transients) {
+    transient.deallocaOp.erase();
+    transient.allocaOp.erase();
+  }
+}
+
+// Packs the stream-ordered transient allocations in |block| into one arena per
+// affinity.
+static void packBlockTransients(Block &block) {
+  // Gather candidate transients in program order grouped by affinity.
+  // Allocations with sizes that can't be computed ahead of the first
+  // allocation in the group are left as-is.
+  llvm::MapVector<Attribute, SmallVector<Transient>> transientsByAffinity;
+  for (auto allocaOp : block.getOps<IREE::Stream::ResourceAllocaOp>()) {
+    auto resourceType =
+        allocaOp.result().getType().cast<IREE::Stream::ResourceType>();
+    if (resourceType.getLifetime() != IREE::Stream::Lifetime::Transient) {
+      continue;
+    }
+    auto deallocaOp = findDealloca(allocaOp);
+    if (!deallocaOp) continue;
+    auto &transients = transientsByAffinity[allocaOp.affinityAttr()];
+    if (!transients.empty() &&
+        !isHoistableTo(allocaOp.storage_size(),
+                       transients.front().allocaOp)) {
+      continue;
+    }
+    transients.push_back({allocaOp, deallocaOp});
+  }
+
+  TimelineOrder timelineOrder;
+  for (auto &it : transientsByAffinity) {
+    auto &transients = it.second;
+    if (transients.size() < 2) continue;  // nothing to share
+    LLVM_DEBUG(llvm::dbgs() << "packing " << transients.size()
+                            << " transient allocations into one arena\n");
+    packTransients(transients, timelineOrder);
+  }
+}
+
+//===----------------------------------------------------------------------===//
+// -iree-stream-pack-transients
+//===----------------------------------------------------------------------===//
+
+class PackTransientsPass : public PackTransientsBase<PackTransientsPass> {
+ public:
+  void getDependentDialects(DialectRegistry &registry) const override {
+    registry.insert<mlir::func::FuncDialect>();
+    registry.insert<IREE::Stream::StreamDialect>();
+    registry.insert<IREE::Util::UtilDialect>();
+  }
+
+  void runOnOperation() override {
+    auto parentOp = getOperation();
+    if (!parentOp.getCallableRegion() ||
+        parentOp.getCallableRegion()->empty()) {
+      return;
+    }
+
+    // Transients are only packed within a block; allocations in other blocks
+    // or nested regions are on different control paths and keep their own
+    // storage.
+    for (auto &block : *parentOp.getCallableRegion()) {
+      packBlockTransients(block);
+    }
+  }
+};
+
+}  // namespace
+
+std::unique_ptr<InterfacePass<CallableOpInterface>> createPackTransientsPass() {
+  return std::make_unique<PackTransientsPass>();
+}
+
+}  // namespace Stream
+}  // namespace IREE
+}  // namespace iree_compiler
+}  // namespace mlir
@@ -182,13 +182,23 @@ void buildStreamCmdPassPipeline(OpPassManager &passManager,
   // streams. Ideally all transient allocs become stream-ordered allocas.
   // createPropagateTransientsPass()
 
+  // Pack the stream-ordered transient allocations of all execution regions in
+  // a block into a single arena so that regions that cannot be in flight at
+  // the same time share memory.
+  passManager.addNestedPass<IREE::Util::InitializerOp>(
+      IREE::Stream::createPackTransientsPass());
+  passManager.addNestedPass<mlir::func::FuncOp>(
+      IREE::Stream::createPackTransientsPass());
+
   // Allocate backing storage for fused constant resources.
   // This expands packed constants into explicit forms with partitioned storage
   // buffers and upload logic.
   passManager.addNestedPass<IREE::Util::InitializerOp>(
-      IREE::Stream::createPackConstantsPass());
+      IREE::Stream::createPackConstantsPass(
+          transformOptions.constantPageAlignmentThreshold));
   passManager.addNestedPass<mlir::func::FuncOp>(
-      IREE::Stream::createPackConstantsPass());
+      IREE::Stream::createPackConstantsPass(
+          transformOptions.constantPageAlignmentThreshold));
 
   // Pack fused allocations based on lifetime.
   passManager.addNestedPass<IREE::Util::InitializerOp>(
@@ -262,6 +272,15 @@ void buildStreamOptimizationPassPipeline(
   // sites. This allows codegen to see the potential values for the operands
   // when operating locally on executables.
   passManager.addPass(IREE::Stream::createAnnotateDispatchArgumentsPass());
+
+  // Clone dispatches with dynamic shapes into variants specialized for shape
+  // buckets (dimensions aligned to the requested values). This runs after the
+  // annotation so that buckets already guaranteed by all dispatch sites are
+  // skipped; the variants are selected at dispatch sites during HAL conversion.
+  if (!transformOptions.dispatchShapeBuckets.empty()) {
+    passManager.addPass(IREE::Stream::createSpecializeDispatchShapesPass(
+        llvm::to_vector(transformOptions.dispatchShapeBuckets)));
+  }
 }
 
 //===----------------------------------------------------------------------===//
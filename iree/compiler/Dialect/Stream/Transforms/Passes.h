@@ -35,6 +35,25 @@ struct TransformOptions : public PassPipelineOptions<TransformOptions> {
       llvm::cl::init(true),
   };
 
+  Option<unsigned> constantPageAlignmentThreshold{
+      *this,
+      "constant-page-alignment-threshold",
+      llvm::cl::desc("Places constants of at least this many bytes at "
+                     "page-aligned offsets so they can be mapped zero-copy "
+                     "from memory-mapped modules; 0 disables."),
+      llvm::cl::init(0),
+  };
+
+  ListOption<unsigned> dispatchShapeBuckets{
+      *this,
+      "dispatch-shape-buckets",
+      llvm::cl::desc("Power-of-two alignments of dynamic dispatch dimensions "
+                     "to emit specialized dispatch variants for. Dispatch "
+                     "sites select the most aligned variant at runtime and "
+                     "fall back to the generic one."),
+      llvm::cl::ZeroOrMore,
+  };
+
   Option<DumpOutputFormat> dumpStatisticsFormat{
       *this,
       "dump-statistics-format",
@@ -132,7 +151,9 @@ std::unique_ptr<OperationPass<mlir::ModuleOp>> createPropagateTimepointsPass();
 std::unique_ptr<InterfacePass<CallableOpInterface>>
 createScheduleAllocationPass();
 
-std::unique_ptr<InterfacePass<CallableOpInterface>> createPackConstantsPass();
+std::unique_ptr<InterfacePass<CallableOpInterface>> createPackTransientsPass();
+std::unique_ptr<InterfacePass<CallableOpInterface>> createPackConstantsPass(
+    unsigned pageAlignmentThreshold = 0);
 std::unique_ptr<InterfacePass<CallableOpInterface>> createPackAllocationsPass();
 std::unique_ptr<InterfacePass<CallableOpInterface>> createLayoutSlicesPass();
 
@@ -155,6 +176,8 @@ std::unique_ptr<OperationPass<mlir::ModuleOp>> createSpecializeDispatchesPass();
 
 std::unique_ptr<OperationPass<mlir::ModuleOp>>
 createAnnotateDispatchArgumentsPass();
+std::unique_ptr<OperationPass<mlir::ModuleOp>>
+createSpecializeDispatchShapesPass(ArrayRef<unsigned> bucketAlignments = {});
 
 //===----------------------------------------------------------------------===//
 // Diagnostics
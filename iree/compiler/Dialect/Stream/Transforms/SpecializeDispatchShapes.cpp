@@ -0,0 +1,174 @@
+// Copyright 2022 The IREE Authors
+//
+// Licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+#include <algorithm>
+#include <functional>
+#include <memory>
+#include <utility>
+
+#include "iree/compiler/Dialect/Stream/IR/StreamOps.h"
+#include "iree/compiler/Dialect/Stream/Transforms/PassDetail.h"
+#include "iree/compiler/Dialect/Stream/Transforms/Passes.h"
+#include "llvm/ADT/STLExtras.h"
+#include "llvm/Support/Debug.h"
+#include "llvm/Support/MathExtras.h"
+#include "mlir/Dialect/Func/IR/FuncOps.h"
+#include "mlir/IR/Attributes.h"
+#include "mlir/IR/Builders.h"
+#include "mlir/IR/BuiltinTypes.h"
+#include "mlir/IR/SymbolTable.h"
+#include "mlir/Pass/Pass.h"
+
+#define DEBUG_TYPE "iree-stream-specialize-dispatch-shapes"
+
+namespace mlir {
+namespace iree_compiler {
+namespace IREE {
+namespace Stream {
+namespace {
+
+//===----------------------------------------------------------------------===//
+// Per-dispatchable export specialization
+//===----------------------------------------------------------------------===//
+
+// Returns the indices of all index arguments of |funcOp| that are used as
+// dynamic dimensions of binding subspans. These are the shape operands the
+// buckets are keyed on.
+static SmallVector<unsigned> findShapeArgs(mlir::func::FuncOp funcOp) {
+  SmallVector<unsigned> argIndices;
+  for (auto arg : funcOp.getArguments()) {
+    if (!arg.getType().isIndex()) continue;
+    bool isShapeArg = llvm::any_of(arg.getUsers(), [&](Operation *user) {
+      auto subspanOp = dyn_cast<IREE::Stream::BindingSubspanOp>(user);
+      return subspanOp && llvm::is_contained(subspanOp.dynamic_dims(), arg);
+    });
+    if (isShapeArg) argIndices.push_back(arg.getArgNumber());
+  }
+  return argIndices;
+}
+
+// Returns the alignment of argument |argIndex| already known from the dispatch
+// sites, or 1 if not known.
+static uint64_t getKnownAlignment(mlir::func::FuncOp funcOp,
+                                  unsigned argIndex) {
+  auto alignmentAttr =
+      funcOp.getArgAttrOfType<IntegerAttr>(argIndex, "stream.alignment");
+  return alignmentAttr ? alignmentAttr.getValue().getZExtValue() : 1;
+}
+
+// Clones |exportOp| and its function once per alignment in |bucketAlignments|.
+// Each clone has all shape arguments annotated as being aligned to the bucket
+// alignment and is linked back to |exportOp| so that dispatch sites can select
+// the most specialized variant at runtime. The original export remains as the
+// generic fallback.
+static void specializeExport(IREE::Stream::ExecutableOp executableOp,
+                             IREE::Stream::ExecutableExportOp exportOp,
+                             ArrayRef<uint64_t> bucketAlignments) {
+  auto funcOp = exportOp.getFunctionRef();
+  if (!funcOp) return;
+  auto shapeArgs = findShapeArgs(funcOp);
+  if (shapeArgs.empty()) return;
+
+  auto indexType = IndexType::get(exportOp.getContext());
+  SymbolTable executableSymbolTable(executableOp);
+  SymbolTable moduleSymbolTable(executableOp.getInnerModule());
+  OpBuilder exportBuilder(exportOp);
+  exportBuilder.setInsertionPointAfter(exportOp);
+  for (auto alignment : bucketAlignments) {
+    // Skip buckets that are already guaranteed by every dispatch site; the
+    // generic variant will get the same codegen.
+    bool isRedundant = llvm::all_of(shapeArgs, [&](unsigned argIndex) {
+      return getKnownAlignment(funcOp, argIndex) >= alignment;
+    });
+    if (isRedundant) continue;
+
+    std::string suffix = "_aligned" + std::to_string(alignment);
+    auto specializedFuncOp = funcOp.clone();
+    specializedFuncOp.setName((funcOp.getName() + suffix).str());
+    moduleSymbolTable.insert(specializedFuncOp, ++Block::iterator(funcOp));
+    for (auto argIndex : shapeArgs) {
+      uint64_t argAlignment =
+          std::max(getKnownAlignment(funcOp, argIndex), alignment);
+      specializedFuncOp.setArgAttr(argIndex, "stream.alignment",
+                                   IntegerAttr::get(indexType, argAlignment));
+      specializedFuncOp.setArgAttr(argIndex, "stream.specialization_alignment",
+                                   IntegerAttr::get(indexType, alignment));
+    }
+
+    auto specializedExportOp =
+        exportBuilder.create<IREE::Stream::ExecutableExportOp>(
+            exportOp.getLoc(), (exportOp.sym_name() + suffix).str(),
+            FlatSymbolRefAttr::get(specializedFuncOp));
+    executableSymbolTable.insert(specializedExportOp);
+    specializedExportOp->setAttr(
+        "stream.specialization_of",
+        FlatSymbolRefAttr::get(exportOp.sym_nameAttr()));
+    exportBuilder.setInsertionPointAfter(specializedExportOp);
+
+    LLVM_DEBUG(llvm::dbgs() << "specialized @" << executableOp.sym_name()
+                            << "::@" << exportOp.sym_name() << " as @"
+                            << specializedExportOp.sym_name() << "\n");
+  }
+}
+
+//===----------------------------------------------------------------------===//
+// -iree-stream-specialize-dispatch-shapes
+//===----------------------------------------------------------------------===//
+
+class SpecializeDispatchShapesPass
+    : public SpecializeDispatchShapesBase<SpecializeDispatchShapesPass> {
+ public:
+  SpecializeDispatchShapesPass() = default;
+  SpecializeDispatchShapesPass(ArrayRef<unsigned> bucketAlignments) {
+    this->bucketAlignments = bucketAlignments;
+  }
+
+  void getDependentDialects(DialectRegistry &registry) const override {
+    registry.insert<IREE::Stream::StreamDialect>();
+  }
+
+  void runOnOperation() override {
+    // Most specialized buckets go first so that dispatch sites try them first.
+    SmallVector<uint64_t> alignments;
+    for (unsigned alignment : bucketAlignments) {
+      if (alignment <= 1 || !llvm::isPowerOf2_32(alignment)) {
+        getOperation().emitError()
+            << "dispatch shape bucket alignments must be powers of two greater "
+               "than 1; got "
+            << alignment;
+        return signalPassFailure();
+      }
+      alignments.push_back(alignment);
+    }
+    llvm::sort(alignments, std::greater<uint64_t>());
+    alignments.erase(std::unique(alignments.begin(), alignments.end()),
+                     alignments.end());
+    if (alignments.empty()) return;
+
+    for (auto executableOp :
+         getOperation().getBodyRegion().getOps<IREE::Stream::ExecutableOp>()) {
+      // Snapshot the exports as we insert new ones as we go.
+      auto exportOps = llvm::to_vector<4>(
+          executableOp.getOps<IREE::Stream::ExecutableExportOp>());
+      for (auto exportOp : exportOps) {
+        if (exportOp->hasAttr("stream.specialization_of")) continue;
+        specializeExport(executableOp, exportOp, alignments);
+      }
+    }
+  }
+};
+
+}  // namespace
+
+std::unique_ptr<OperationPass<mlir::ModuleOp>>
+createSpecializeDispatchShapesPass(ArrayRef<unsigned> bucketAlignments) {
+  return std::make_unique<SpecializeDispatchShapesPass>(bucketAlignments);
+}
+
+}  // namespace Stream
+}  // namespace IREE
+}  // namespace iree_compiler
+}  // namespace mlir
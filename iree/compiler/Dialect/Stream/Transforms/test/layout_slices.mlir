@@ -28,6 +28,35 @@ func.func @layoutStatic() -> (index, index, index, index, index, index, index)
 
 // -----
 
+#layoutStaticSortedConfig = #stream.resource_config<{
+  max_allocation_size = 1073741824,
+  min_buffer_offset_alignment = 16,
+  max_buffer_range = 1073741824,
+  min_buffer_range_alignment = 16
+}>
+
+// Tests that larger slices are placed first when doing so produces a smaller
+// slab than placing them in program order (which would require 112 bytes).
+
+// CHECK-LABEL: @layoutStaticSorted
+func.func @layoutStaticSorted() -> (index, index, index, index, index)
+    attributes {stream.resources = #layoutStaticSortedConfig} {
+  %c16 = arith.constant 16 : index
+  %c32 = arith.constant 32 : index
+  %c48 = arith.constant 48 : index
+  %t:5 = stream.resource.pack slices({
+    [3, 4] = %c16,  // +16
+    [2, 3] = %c16,  // +0
+    [1, 3] = %c32,  // +48 (after [1, 1])
+    [1, 1] = %c48,  // +0 (placed first)
+  }) : index
+  // CHECK: return %c80
+  // CHECK-SAME: %c16, %c0, %c48, %c0
+  return %t#0, %t#1, %t#2, %t#3, %t#4 : index, index, index, index, index
+}
+
+// -----
+
 #layoutDynamicConfig = #stream.resource_config<{
   max_allocation_size = 1073741824,
   min_buffer_offset_alignment = 16,
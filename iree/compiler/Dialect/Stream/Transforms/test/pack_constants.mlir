@@ -1,4 +1,5 @@
 // RUN: iree-opt -split-input-file -pass-pipeline='func.func(iree-stream-pack-constants)' %s | FileCheck %s
+// RUN: iree-opt -split-input-file -pass-pipeline='func.func(iree-stream-pack-constants{page-alignment-threshold=32 page-size=256})' %s | FileCheck %s --check-prefix=PAGE
 
 // This is a high level test of the structure emitted by the pass.
 // Subsequent tests focus on individual components.
@@ -109,3 +110,87 @@ func.func @splitResourceConstants() -> (!stream.resource<constant>, !stream.reso
   // CHECK: return %[[RES0]], %[[RES1]], %[[IF]]#2
   return %0#0, %0#1, %0#2 : !stream.resource<constant>, !stream.resource<constant>, !stream.timepoint
 }
+
+// -----
+
+// Tests that constants are placed into the storage resource that they best
+// fit instead of only the most recently created one.
+
+#bestFitResourceConstantsConfig = #stream.resource_config<{
+  max_allocation_size = 64,
+  min_buffer_offset_alignment = 16,
+  max_buffer_range = 1073741824,
+  min_buffer_range_alignment = 16
+}>
+
+// CHECK-LABEL: @bestFitResourceConstants
+func.func @bestFitResourceConstants() -> (!stream.resource<constant>, !stream.resource<constant>, !stream.resource<constant>, !stream.timepoint)
+    attributes {stream.resources = #bestFitResourceConstantsConfig} {
+  %c16 = arith.constant 16 : index
+  %c32 = arith.constant 32 : index
+  %c48 = arith.constant 48 : index
+
+  %0:4 = stream.resource.constants :
+    !stream.resource<constant>{%c48} = dense<[0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11]> : tensor<12xi32>,
+    !stream.resource<constant>{%c32} = dense<[0, 1, 2, 3, 4, 5, 6, 7]> : tensor<8xi32>,
+    !stream.resource<constant>{%c16} = dense<[0, 1, 2, 3]> : tensor<4xi32>
+    => !stream.timepoint
+
+  // CHECK: %[[IF:.+]]:3 = scf.if
+  // CHECK: %[[RES0:.+]] = stream.resource.subview %[[IF]]#0[%c0] : !stream.resource<constant>{%c64} -> !stream.resource<constant>{%c48}
+  // CHECK: %[[RES2:.+]] = stream.resource.subview %[[IF]]#0[%c48] : !stream.resource<constant>{%c64} -> !stream.resource<constant>{%c16}
+  // CHECK: %[[RES1:.+]] = stream.resource.subview %[[IF]]#1[%c0] : !stream.resource<constant>{%c32} -> !stream.resource<constant>{%c32}
+
+  // CHECK: return %[[RES0]], %[[RES1]], %[[RES2]], %[[IF]]#2
+  return %0#0, %0#1, %0#2, %0#3 : !stream.resource<constant>, !stream.resource<constant>, !stream.resource<constant>, !stream.timepoint
+}
+
+// -----
+
+// Tests that identical constant values share storage.
+
+//      CHECK: #composite_of_64b = #util.composite<64xi8, [
+// CHECK-NEXT:   dense<[101, 102]> : tensor<2xi32>,
+// CHECK-NEXT:   dense<0> : vector<56xi8>,
+// CHECK-NEXT: ]>
+
+// CHECK-LABEL: @deduplicateResourceConstants
+func.func @deduplicateResourceConstants() -> (!stream.resource<constant>, !stream.resource<constant>, !stream.timepoint) {
+  %c8 = arith.constant 8 : index
+
+  %0:3 = stream.resource.constants :
+    !stream.resource<constant>{%c8} = dense<[101, 102]> : tensor<2xi32>,
+    !stream.resource<constant>{%c8} = dense<[101, 102]> : tensor<2xi32>
+    => !stream.timepoint
+
+  // CHECK: %[[IF:.+]]:2 = scf.if
+  // CHECK: %[[RES:.+]] = stream.resource.subview %[[IF]]#0[%c0] : !stream.resource<constant>{%c64} -> !stream.resource<constant>{%c8}
+  // CHECK-NOT: stream.resource.subview
+
+  // CHECK: return %[[RES]], %[[RES]], %[[IF]]#1
+  return %0#0, %0#1, %0#2 : !stream.resource<constant>, !stream.resource<constant>, !stream.timepoint
+}
+
+// -----
+
+// Tests that large constants are placed at page-aligned offsets within
+// page-aligned storage when requested.
+
+// PAGE-LABEL: @pageAlignResourceConstants
+func.func @pageAlignResourceConstants() -> (!stream.resource<constant>, !stream.resource<constant>, !stream.timepoint) {
+  %c4 = arith.constant 4 : index
+  %c32 = arith.constant 32 : index
+
+  // PAGE: util.byte_buffer.constant {alignment = 256 : i64}
+  %0:3 = stream.resource.constants :
+    !stream.resource<constant>{%c4} = dense<100> : tensor<1xi32>,
+    !stream.resource<constant>{%c32} = dense<[0, 1, 2, 3, 4, 5, 6, 7]> : tensor<8xi32>
+    => !stream.timepoint
+
+  // PAGE: %[[IF:.+]]:2 = scf.if
+  // PAGE: %[[RES0:.+]] = stream.resource.subview %[[IF]]#0[%c0] : !stream.resource<constant>{%c320} -> !stream.resource<constant>{%c4}
+  // PAGE: %[[RES1:.+]] = stream.resource.subview %[[IF]]#0[%c256] : !stream.resource<constant>{%c320} -> !stream.resource<constant>{%c32}
+
+  // PAGE: return %[[RES0]], %[[RES1]], %[[IF]]#1
+  return %0#0, %0#1, %0#2 : !stream.resource<constant>, !stream.resource<constant>, !stream.timepoint
+}
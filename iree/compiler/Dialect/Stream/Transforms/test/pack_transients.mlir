@@ -0,0 +1,102 @@
+// RUN: iree-opt -split-input-file -pass-pipeline='func.func(iree-stream-pack-transients)' %s | FileCheck %s
+
+// Tests that execution regions ordered on the timeline share one arena and
+// that their transients are allowed to alias.
+
+// CHECK-LABEL: @packSequential
+// CHECK-SAME: (%[[SIZE0:.+]]: index, %[[SIZE1:.+]]: index, %[[AWAIT_TIMEPOINT:.+]]: !stream.timepoint)
+func.func @packSequential(%size0: index, %size1: index, %await_timepoint: !stream.timepoint) -> !stream.timepoint {
+  %c0 = arith.constant 0 : index
+  %c255_i32 = arith.constant 255 : i32
+
+  //      CHECK: %[[SLICES:.+]]:3 = stream.resource.pack slices({
+  // CHECK-NEXT:   [0, 0] = %[[SIZE0]],
+  // CHECK-NEXT:   [1, 1] = %[[SIZE1]]
+  // CHECK-NEXT: }) : index
+  // CHECK-NEXT: %[[ARENA:.+]], %[[ARENA_TIMEPOINT:.+]] = stream.resource.alloca uninitialized : !stream.resource<transient>{%[[SLICES]]#0} => !stream.timepoint
+
+  // CHECK-NEXT: %[[AVAILABLE0:.+]] = stream.timepoint.join max(%[[AWAIT_TIMEPOINT]], %[[ARENA_TIMEPOINT]])
+  // CHECK-NEXT: %[[SLICE0:.+]] = stream.resource.subview %[[ARENA]][%[[SLICES]]#1] : !stream.resource<transient>{%[[SLICES]]#0} -> !stream.resource<transient>{%[[SIZE0]]}
+  %alloca0, %alloca0_timepoint = stream.resource.alloca uninitialized await(%await_timepoint) => !stream.resource<transient>{%size0} => !stream.timepoint
+  // CHECK-NEXT: %[[AWAIT0:.+]] = stream.timepoint.join max(%[[AWAIT_TIMEPOINT]], %[[AVAILABLE0]])
+  %await0 = stream.timepoint.join max(%await_timepoint, %alloca0_timepoint) => !stream.timepoint
+  // CHECK: %[[EXEC0:.+]] = stream.cmd.execute await(%[[AWAIT0]]) => with(%[[SLICE0]] as
+  %exec0 = stream.cmd.execute await(%await0) => with(%alloca0 as %capture0: !stream.resource<transient>{%size0}) {
+    stream.cmd.fill %c255_i32, %capture0[%c0 for %size0] : i32 -> !stream.resource<transient>{%size0}
+  } => !stream.timepoint
+  // CHECK-NOT: stream.resource.dealloca
+  %dealloca0 = stream.resource.dealloca await(%exec0) => %alloca0 : !stream.resource<transient>{%size0} => !stream.timepoint
+  // CHECK: %[[DONE0:.+]] = stream.timepoint.join max(%[[EXEC0]], %[[EXEC0]])
+  %done0 = stream.timepoint.join max(%dealloca0, %exec0) => !stream.timepoint
+
+  // CHECK: %[[AVAILABLE1:.+]] = stream.timepoint.join max(%[[DONE0]], %[[ARENA_TIMEPOINT]])
+  // CHECK-NEXT: %[[SLICE1:.+]] = stream.resource.subview %[[ARENA]][%[[SLICES]]#2] : !stream.resource<transient>{%[[SLICES]]#0} -> !stream.resource<transient>{%[[SIZE1]]}
+  %alloca1, %alloca1_timepoint = stream.resource.alloca uninitialized await(%done0) => !stream.resource<transient>{%size1} => !stream.timepoint
+  %await1 = stream.timepoint.join max(%done0, %alloca1_timepoint) => !stream.timepoint
+  // CHECK: %[[EXEC1:.+]] = stream.cmd.execute await(%{{.+}}) => with(%[[SLICE1]] as
+  %exec1 = stream.cmd.execute await(%await1) => with(%alloca1 as %capture1: !stream.resource<transient>{%size1}) {
+    stream.cmd.fill %c255_i32, %capture1[%c0 for %size1] : i32 -> !stream.resource<transient>{%size1}
+  } => !stream.timepoint
+  %dealloca1 = stream.resource.dealloca await(%exec1) => %alloca1 : !stream.resource<transient>{%size1} => !stream.timepoint
+
+  // CHECK: %[[COMPLETE:.+]] = stream.timepoint.join max(%[[EXEC0]], %[[EXEC1]])
+  // CHECK-NEXT: %[[DEALLOCA:.+]] = stream.resource.dealloca await(%[[COMPLETE]]) => %[[ARENA]] : !stream.resource<transient>{%[[SLICES]]#0} => !stream.timepoint
+  // CHECK-NEXT: %[[DONE1:.+]] = stream.timepoint.join max(%[[EXEC1]], %[[EXEC1]])
+  %done1 = stream.timepoint.join max(%dealloca1, %exec1) => !stream.timepoint
+  // CHECK-NEXT: return %[[DONE1]]
+  return %done1 : !stream.timepoint
+}
+
+// -----
+
+// Tests that execution regions that may be in flight concurrently get
+// overlapping lifetimes so their transients are not aliased.
+
+// CHECK-LABEL: @packConcurrent
+// CHECK-SAME: (%[[SIZE0:.+]]: index, %[[SIZE1:.+]]: index, %[[AWAIT_TIMEPOINT:.+]]: !stream.timepoint)
+func.func @packConcurrent(%size0: index, %size1: index, %await_timepoint: !stream.timepoint) -> !stream.timepoint {
+  %c0 = arith.constant 0 : index
+  %c255_i32 = arith.constant 255 : i32
+
+  //      CHECK: %[[SLICES:.+]]:3 = stream.resource.pack slices({
+  // CHECK-NEXT:   [0, 1] = %[[SIZE0]],
+  // CHECK-NEXT:   [1, 1] = %[[SIZE1]]
+  // CHECK-NEXT: }) : index
+  %alloca0, %alloca0_timepoint = stream.resource.alloca uninitialized await(%await_timepoint) => !stream.resource<transient>{%size0} => !stream.timepoint
+  %await0 = stream.timepoint.join max(%await_timepoint, %alloca0_timepoint) => !stream.timepoint
+  %exec0 = stream.cmd.execute await(%await0) => with(%alloca0 as %capture0: !stream.resource<transient>{%size0}) {
+    stream.cmd.fill %c255_i32, %capture0[%c0 for %size0] : i32 -> !stream.resource<transient>{%size0}
+  } => !stream.timepoint
+  %dealloca0 = stream.resource.dealloca await(%exec0) => %alloca0 : !stream.resource<transient>{%size0} => !stream.timepoint
+
+  %alloca1, %alloca1_timepoint = stream.resource.alloca uninitialized await(%await_timepoint) => !stream.resource<transient>{%size1} => !stream.timepoint
+  %await1 = stream.timepoint.join max(%await_timepoint, %alloca1_timepoint) => !stream.timepoint
+  %exec1 = stream.cmd.execute await(%await1) => with(%alloca1 as %capture1: !stream.resource<transient>{%size1}) {
+    stream.cmd.fill %c255_i32, %capture1[%c0 for %size1] : i32 -> !stream.resource<transient>{%size1}
+  } => !stream.timepoint
+  %dealloca1 = stream.resource.dealloca await(%exec1) => %alloca1 : !stream.resource<transient>{%size1} => !stream.timepoint
+
+  // CHECK: stream.resource.dealloca
+  // CHECK-NOT: stream.resource.dealloca
+  %done = stream.timepoint.join max(%dealloca0, %dealloca1) => !stream.timepoint
+  return %done : !stream.timepoint
+}
+
+// -----
+
+// Tests that a single transient is left as-is.
+
+// CHECK-LABEL: @packSingle
+func.func @packSingle(%size: index, %await_timepoint: !stream.timepoint) -> !stream.timepoint {
+  %c0 = arith.constant 0 : index
+  %c255_i32 = arith.constant 255 : i32
+  // CHECK-NOT: stream.resource.pack
+  // CHECK: stream.resource.alloca uninitialized await
+  %alloca, %alloca_timepoint = stream.resource.alloca uninitialized await(%await_timepoint) => !stream.resource<transient>{%size} => !stream.timepoint
+  %exec = stream.cmd.execute await(%alloca_timepoint) => with(%alloca as %capture: !stream.resource<transient>{%size}) {
+    stream.cmd.fill %c255_i32, %capture[%c0 for %size] : i32 -> !stream.resource<transient>{%size}
+  } => !stream.timepoint
+  // CHECK: stream.resource.dealloca await
+  %dealloca = stream.resource.dealloca await(%exec) => %alloca : !stream.resource<transient>{%size} => !stream.timepoint
+  return %dealloca : !stream.timepoint
+}
@@ -0,0 +1,68 @@
+// RUN: iree-opt -split-input-file -iree-stream-specialize-dispatch-shapes='bucket-alignments=16,64' %s | FileCheck %s
+
+// Tests that exports with dynamic shapes get one aligned variant per bucket
+// (most aligned first) linked back to the generic export.
+
+// CHECK-LABEL: @specializeDynamicEx
+stream.executable private @specializeDynamicEx {
+  // CHECK: stream.executable.export public @dispatch
+  // CHECK-NEXT: stream.executable.export {{.*}}@dispatch_aligned64 attributes {stream.specialization_of = @dispatch}
+  // CHECK-NEXT: stream.executable.export {{.*}}@dispatch_aligned16 attributes {stream.specialization_of = @dispatch}
+  stream.executable.export public @dispatch
+  builtin.module  {
+    // CHECK: func @dispatch(%arg0: !stream.binding, %arg1: index {stream.alignment = 4 : index}, %arg2: index, %arg3: index)
+    // CHECK: func @dispatch_aligned16(
+    // CHECK-SAME: %arg1: index {stream.alignment = 16 : index, stream.specialization_alignment = 16 : index}
+    // CHECK-SAME: %arg2: index {stream.alignment = 16 : index, stream.specialization_alignment = 16 : index}
+    // CHECK-SAME: %arg3: index)
+    // CHECK: func @dispatch_aligned64(
+    // CHECK-SAME: %arg1: index {stream.alignment = 64 : index, stream.specialization_alignment = 64 : index}
+    // CHECK-SAME: %arg2: index {stream.alignment = 64 : index, stream.specialization_alignment = 64 : index}
+    // CHECK-SAME: %arg3: index)
+    func.func @dispatch(%arg0: !stream.binding, %arg1: index {stream.alignment = 4 : index}, %arg2: index, %arg3: index) {
+      %0 = stream.binding.subspan %arg0[%arg3] : !stream.binding -> !flow.dispatch.tensor<readwrite:?x?xf32>{%arg1, %arg2}
+      return
+    }
+  }
+}
+
+// -----
+
+// Tests that buckets already guaranteed by all dispatch sites are skipped.
+
+// CHECK-LABEL: @skipKnownAlignmentEx
+stream.executable private @skipKnownAlignmentEx {
+  // CHECK: stream.executable.export public @dispatch
+  // CHECK-NEXT: stream.executable.export {{.*}}@dispatch_aligned64
+  // CHECK-NOT: stream.executable.export
+  stream.executable.export public @dispatch
+  builtin.module  {
+    // CHECK: func @dispatch(
+    // CHECK: func @dispatch_aligned64(
+    // CHECK-SAME: %arg1: index {stream.alignment = 64 : index, stream.specialization_alignment = 64 : index}
+    // CHECK-NOT: func @dispatch_aligned16
+    func.func @dispatch(%arg0: !stream.binding, %arg1: index {stream.alignment = 16 : index}) {
+      %c0 = arith.constant 0 : index
+      %0 = stream.binding.subspan %arg0[%c0] : !stream.binding -> !flow.dispatch.tensor<readwrite:?xf32>{%arg1}
+      return
+    }
+  }
+}
+
+// -----
+
+// Tests that exports without dynamic shapes are not specialized.
+
+// CHECK-LABEL: @staticShapeEx
+stream.executable private @staticShapeEx {
+  // CHECK: stream.executable.export public @dispatch
+  // CHECK-NOT: stream.executable.export
+  stream.executable.export public @dispatch
+  builtin.module  {
+    // CHECK-NOT: func @dispatch_aligned
+    func.func @dispatch(%arg0: !stream.binding, %arg1: index) {
+      %0 = stream.binding.subspan %arg0[%arg1] : !stream.binding -> !flow.dispatch.tensor<readwrite:4xf32>
+      return
+    }
+  }
+}
@@ -22,7 +22,7 @@ namespace {
 void populateEscapingProducers(Operation *parentOp, ConstExprOpInfo &info) {
   SmallPtrSet<Operation *, 8> containedOps;
   parentOp->walk<WalkOrder::PreOrder>([&](Operation *itOp) {
-    containedOps.insert(parentOp);
+    containedOps.insert(itOp);
     // For the outer-most op, consider that all operands escape.
     if (itOp == parentOp) {
       info.producers.insert(itOp->getOperands().begin(),
@@ -158,6 +158,33 @@ bool isHoistableConstExprConsumingOperand(OpOperand *operand) {
   return true;
 }
 
+bool isConstExprLayoutTransform(Operation *op) {
+  if (isa<tensor::PadOp, tensor::ExpandShapeOp, tensor::CollapseShapeOp,
+          tensor::ExtractSliceOp, tensor::InsertSliceOp>(op)) {
+    return true;
+  }
+
+  // Copies and transposes: all-parallel generics that yield their only input
+  // through a permutation. Broadcasts are excluded as they grow the value.
+  if (auto genericOp = dyn_cast<linalg::GenericOp>(op)) {
+    if (genericOp.getNumParallelLoops() != genericOp.getNumLoops() ||
+        genericOp.getNumInputs() != 1 || genericOp.getNumOutputs() != 1) {
+      return false;
+    }
+    Block *body = genericOp.getBody();
+    auto yieldOp = dyn_cast<linalg::YieldOp>(body->front());
+    if (!yieldOp || yieldOp->getNumOperands() != 1 ||
+        yieldOp->getOperand(0) != body->getArgument(0)) {
+      return false;
+    }
+    AffineMap indexingMap =
+        genericOp.getTiedIndexingMap(genericOp.getInputOperand(0));
+    return indexingMap.isPermutation();
+  }
+
+  return false;
+}
+
 }  // namespace Util
 }  // namespace IREE
 }  // namespace iree_compiler
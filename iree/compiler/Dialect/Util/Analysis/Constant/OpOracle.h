@@ -54,6 +54,13 @@ bool isHoistableConstExprLeaf(const ConstExprAnalysis::ConstValueInfo *info);
 // This is used to exclude certain operands that we never want in globals.
 bool isHoistableConstExprConsumingOperand(OpOperand *operand);
 
+// Whether |op| only rearranges the elements of its operands (pads, reshapes,
+// slices, copies and transposes) without computing new values. When applied
+// to constants these are cheaper to store already transformed than to
+// recompute at runtime, such as the packing of matmul weights into tiled
+// layouts.
+bool isConstExprLayoutTransform(Operation *op);
+
 }  // namespace Util
 }  // namespace IREE
 }  // namespace iree_compiler
@@ -38,6 +38,13 @@ class HoistIntoGlobalsPass
  public:
   MLIR_DEFINE_EXPLICIT_INTERNAL_INLINE_TYPE_ID(HoistIntoGlobalsPass)
 
+  HoistIntoGlobalsPass() = default;
+  HoistIntoGlobalsPass(const HoistIntoGlobalsPass &other)
+      : PassWrapper(other) {}
+  explicit HoistIntoGlobalsPass(bool layoutTransformsOnly) {
+    this->layoutTransformsOnly = layoutTransformsOnly;
+  }
+
   StringRef getArgument() const override {
     return "iree-util-hoist-into-globals";
   }
@@ -83,6 +90,13 @@ class HoistIntoGlobalsPass
           continue;
         }
 
+        // When restricted to layout transforms (such as the packing of
+        // constant matmul operands into tiled layouts) only those escapes are
+        // hoisted; the transform chain producing them is cloned as usual.
+        if (layoutTransformsOnly && !isConstExprLayoutTransform(iterOp)) {
+          continue;
+        }
+
         hoistConstExpr(constExprResult, hoistedMap, moduleSymbols, constExprs);
       }
       return WalkResult::advance();
@@ -234,12 +248,19 @@ class HoistIntoGlobalsPass
     Block *block = getOperation().getBody();
     return OpBuilder::atBlockEnd(block);
   }
+
+  Option<bool> layoutTransformsOnly{
+      *this, "layout-transforms-only",
+      llvm::cl::desc("Only hoists const-expr layout transforms (pads, "
+                     "reshapes, copies and transposes of constants)."),
+      llvm::cl::init(false)};
 };
 
 }  // namespace
 
-std::unique_ptr<OperationPass<mlir::ModuleOp>> createHoistIntoGlobalsPass() {
-  return std::make_unique<HoistIntoGlobalsPass>();
+std::unique_ptr<OperationPass<mlir::ModuleOp>> createHoistIntoGlobalsPass(
+    bool layoutTransformsOnly) {
+  return std::make_unique<HoistIntoGlobalsPass>(layoutTransformsOnly);
 }
 
 static PassRegistration<HoistIntoGlobalsPass> pass;
@@ -1,4 +1,5 @@
 // RUN: iree-opt -split-input-file -iree-util-hoist-into-globals -allow-unregistered-dialect %s | FileCheck %s
+// RUN: iree-opt -split-input-file -iree-util-hoist-into-globals="layout-transforms-only=true" -allow-unregistered-dialect %s | FileCheck %s --check-prefix=LAYOUT
 // Spot verification that policies for linalg ops is respected.
 
 // CHECK-LABEL: @compute_hoisted
@@ -57,3 +58,44 @@ module @broadcast_treated_as_leaf {
   }
   // CHECK-NOT: util.initializer
 }
+
+// -----
+// Verifies that only layout transforms are hoisted when restricted to them.
+// CHECK-LABEL: @layout_transform_hoisted
+// LAYOUT-LABEL: @layout_transform_hoisted
+#map0 = affine_map<(d0, d1) -> (d1, d0)>
+#map1 = affine_map<(d0, d1) -> (d0, d1)>
+module @layout_transform_hoisted {
+  // CHECK: util.global private @{{.+}} : tensor
+  // CHECK: util.global private @{{.+}} : tensor
+  // LAYOUT: util.global private @[[PACKED:.+]] : tensor<8x4xf32>
+  // LAYOUT-NOT: util.global
+  // CHECK: func @main
+  // LAYOUT: func @main
+  func.func @main(%lhs: tensor<2x8xf32>, %acc: tensor<2x4xf32>) -> (tensor<2x4xf32>, tensor<4x8xf32>) {
+    %cst = arith.constant dense<2.0> : tensor<4x8xf32>
+
+    // A transpose of a constant matmul operand.
+    // CHECK-NOT: linalg.generic
+    // LAYOUT: %[[RHS:.+]] = util.global.load @[[PACKED]] : tensor<8x4xf32>
+    %0 = linalg.init_tensor [8, 4] : tensor<8x4xf32>
+    %1 = linalg.generic {indexing_maps = [#map0, #map1], iterator_types = ["parallel", "parallel"]} ins(%cst : tensor<4x8xf32>) outs(%0 : tensor<8x4xf32>) {
+    ^bb0(%arg0: f32, %arg1: f32):  // no predecessors
+      linalg.yield %arg0 : f32
+    } -> tensor<8x4xf32>
+    // CHECK: linalg.matmul
+    // LAYOUT: linalg.matmul ins(%{{.+}}, %[[RHS]] :
+    %2 = linalg.matmul ins(%lhs, %1 : tensor<2x8xf32>, tensor<8x4xf32>) outs(%acc : tensor<2x4xf32>) -> tensor<2x4xf32>
+
+    // A leaf-compute that is not a layout transform.
+    // LAYOUT: linalg.generic
+    // LAYOUT-SAME: ins(%[[CST:.+]], %[[CST]] :
+    %3 = linalg.init_tensor [4, 8] : tensor<4x8xf32>
+    %4 = linalg.generic {indexing_maps = [#map1, #map1, #map1], iterator_types = ["parallel", "parallel"]} ins(%cst, %cst : tensor<4x8xf32>, tensor<4x8xf32>) outs(%3 : tensor<4x8xf32>) {
+    ^bb0(%arg0: f32, %arg1: f32, %arg2: f32):  // no predecessors
+      %5 = arith.mulf %arg0, %arg1 : f32
+      linalg.yield %5 : f32
+    } -> tensor<4x8xf32>
+    return %2, %4 : tensor<2x4xf32>, tensor<4x8xf32>
+  }
+}
@@ -3206,6 +3206,225 @@ class CompareRefNotZeroOpConversion
   }
 };
 
+// util.do_not_optimize survives the conversion and is dropped afterwards by
+// DropCompilerHintsPass, which forwards the operands to the users. Ref results
+// have locals of their own though, so the operand refs are retained into them
+// here and the op is rebuilt on the result refs.
+class DoNotOptimizeRefOpConversion
+    : public OpConversionPattern<IREE::Util::DoNotOptimizeOp> {
+  using OpConversionPattern<IREE::Util::DoNotOptimizeOp>::OpConversionPattern;
+
+ private:
+  LogicalResult matchAndRewrite(
+      IREE::Util::DoNotOptimizeOp op, OpAdaptor adaptor,
+      ConversionPatternRewriter &rewriter) const override {
+    auto ctx = op.getContext();
+    auto loc = op.getLoc();
+
+    auto isRefOperand = [](Value operand) {
+      return operand.getType().isa<IREE::VM::RefType>();
+    };
+    if (llvm::none_of(op.getOperands(), isRefOperand)) {
+      return failure();
+    }
+
+    IREE::VM::EmitCTypeConverter *typeConverter =
+        this->template getTypeConverter<IREE::VM::EmitCTypeConverter>();
+
+    SmallVector<Value> newOperands;
+    for (auto it : llvm::zip(op.getOperands(), adaptor.getOperands(),
+                             op.getResults())) {
+      Value operand = std::get<0>(it);
+      if (!isRefOperand(operand)) {
+        newOperands.push_back(std::get<1>(it));
+        continue;
+      }
+
+      Optional<Value> operandRef = typeConverter->materializeRef(operand);
+      Optional<Value> resultRef =
+          typeConverter->materializeRef(std::get<2>(it));
+      if (!operandRef.hasValue() || !resultRef.hasValue()) {
+        return op.emitError() << "local ref not found";
+      }
+
+      rewriter.create<emitc::CallOp>(
+          /*location=*/loc,
+          /*type=*/TypeRange{},
+          /*callee=*/StringAttr::get(ctx, "iree_vm_ref_retain"),
+          /*args=*/ArrayAttr{},
+          /*templateArgs=*/ArrayAttr{},
+          /*operands=*/
+          ArrayRef<Value>{operandRef.getValue(), resultRef.getValue()});
+      newOperands.push_back(resultRef.getValue());
+    }
+
+    rewriter.replaceOpWithNewOp<IREE::Util::DoNotOptimizeOp>(op, newOperands);
+
+    return success();
+  }
+};
+
+class SelectRefOpConversion
+    : public OpConversionPattern<IREE::VM::SelectRefOp> {
+  using OpConversionPattern<IREE::VM::SelectRefOp>::OpConversionPattern;
+
+ private:
+  LogicalResult matchAndRewrite(
+      IREE::VM::SelectRefOp selectOp, OpAdaptor adaptor,
+      ConversionPatternRewriter &rewriter) const override {
+    auto ctx = selectOp.getContext();
+    auto loc = selectOp.getLoc();
+
+    IREE::VM::EmitCTypeConverter *typeConverter =
+        this->template getTypeConverter<IREE::VM::EmitCTypeConverter>();
+
+    Optional<Value> trueRef =
+        typeConverter->materializeRef(selectOp.true_value());
+    Optional<Value> falseRef =
+        typeConverter->materializeRef(selectOp.false_value());
+    Optional<Value> resultRef =
+        typeConverter->materializeRef(selectOp.result());
+
+    if (!trueRef.hasValue() || !falseRef.hasValue() ||
+        !resultRef.hasValue()) {
+      return selectOp.emitError() << "local ref not found";
+    }
+
+    rewriter.create<emitc::CallOp>(
+        /*location=*/loc,
+        /*type=*/TypeRange{},
+        /*callee=*/StringAttr::get(ctx, "vm_select_ref"),
+        /*args=*/ArrayAttr{},
+        /*templateArgs=*/ArrayAttr{},
+        /*operands=*/
+        ArrayRef<Value>{adaptor.condition(), trueRef.getValue(),
+                        falseRef.getValue(), resultRef.getValue()});
+
+    rewriter.replaceOp(selectOp, resultRef.getValue());
+
+    return success();
+  }
+};
+
+// Lowers the primitive vm.switch.* ops to a chain of selects, one per case,
+// starting from the default value.
+template <typename SwitchOpTy, typename Adaptor = typename SwitchOpTy::Adaptor>
+class SwitchOpConversion : public OpConversionPattern<SwitchOpTy> {
+  using OpConversionPattern<SwitchOpTy>::OpConversionPattern;
+
+ public:
+  SwitchOpConversion(TypeConverter &typeConverter, MLIRContext *context,
+                     StringRef selectFuncName)
+      : OpConversionPattern<SwitchOpTy>(typeConverter, context),
+        selectFuncName(selectFuncName) {}
+
+ private:
+  LogicalResult matchAndRewrite(
+      SwitchOpTy switchOp, Adaptor adaptor,
+      ConversionPatternRewriter &rewriter) const override {
+    auto ctx = switchOp.getContext();
+    auto loc = switchOp.getLoc();
+
+    Value result = adaptor.default_value();
+    for (auto value : llvm::enumerate(adaptor.values())) {
+      auto isCase = rewriter.create<emitc::CallOp>(
+          /*location=*/loc,
+          /*type=*/rewriter.getI32Type(),
+          /*callee=*/StringAttr::get(ctx, "vm_cmp_eq_i32"),
+          /*args=*/
+          ArrayAttr::get(ctx, {rewriter.getIndexAttr(0),
+                               rewriter.getI32IntegerAttr(value.index())}),
+          /*templateArgs=*/ArrayAttr{},
+          /*operands=*/ArrayRef<Value>{adaptor.index()});
+
+      result = rewriter
+                   .create<emitc::CallOp>(
+                       /*location=*/loc,
+                       /*type=*/switchOp.getType(),
+                       /*callee=*/StringAttr::get(ctx, selectFuncName),
+                       /*args=*/ArrayAttr{},
+                       /*templateArgs=*/ArrayAttr{},
+                       /*operands=*/
+                       ArrayRef<Value>{isCase.getResult(0), value.value(),
+                                       result})
+                   .getResult(0);
+    }
+
+    rewriter.replaceOp(switchOp, result);
+
+    return success();
+  }
+
+  StringRef selectFuncName;
+};
+
+class SwitchRefOpConversion
+    : public OpConversionPattern<IREE::VM::SwitchRefOp> {
+  using OpConversionPattern<IREE::VM::SwitchRefOp>::OpConversionPattern;
+
+ private:
+  LogicalResult matchAndRewrite(
+      IREE::VM::SwitchRefOp switchOp, OpAdaptor adaptor,
+      ConversionPatternRewriter &rewriter) const override {
+    auto ctx = switchOp.getContext();
+    auto loc = switchOp.getLoc();
+
+    IREE::VM::EmitCTypeConverter *typeConverter =
+        this->template getTypeConverter<IREE::VM::EmitCTypeConverter>();
+
+    Optional<Value> defaultRef =
+        typeConverter->materializeRef(switchOp.default_value());
+    Optional<Value> resultRef =
+        typeConverter->materializeRef(switchOp.result());
+
+    if (!defaultRef.hasValue() || !resultRef.hasValue()) {
+      return switchOp.emitError() << "local ref not found";
+    }
+
+    // Pick the ref pointer first and retain it once at the end; the result
+    // may share a local with one of the case values.
+    Value chosenRef = defaultRef.getValue();
+    for (auto value : llvm::enumerate(switchOp.values())) {
+      Optional<Value> caseRef = typeConverter->materializeRef(value.value());
+      if (!caseRef.hasValue()) {
+        return switchOp.emitError() << "local ref not found";
+      }
+
+      chosenRef = rewriter
+                      .create<emitc::CallOp>(
+                          /*location=*/loc,
+                          /*type=*/
+                          emitc::PointerType::get(
+                              emitc::OpaqueType::get(ctx, "iree_vm_ref_t")),
+                          /*callee=*/
+                          StringAttr::get(ctx, "vm_switch_ref_case"),
+                          /*args=*/
+                          ArrayAttr::get(
+                              ctx, {rewriter.getIndexAttr(0),
+                                    rewriter.getI32IntegerAttr(value.index()),
+                                    rewriter.getIndexAttr(1),
+                                    rewriter.getIndexAttr(2)}),
+                          /*templateArgs=*/ArrayAttr{},
+                          /*operands=*/
+                          ArrayRef<Value>{adaptor.index(), caseRef.getValue(),
+                                          chosenRef})
+                      .getResult(0);
+    }
+
+    rewriter.create<emitc::CallOp>(
+        /*location=*/loc,
+        /*type=*/TypeRange{},
+        /*callee=*/StringAttr::get(ctx, "iree_vm_ref_retain"),
+        /*args=*/ArrayAttr{},
+        /*templateArgs=*/ArrayAttr{},
+        /*operands=*/ArrayRef<Value>{chosenRef, resultRef.getValue()});
+
+    rewriter.replaceOp(switchOp, resultRef.getValue());
+
+    return success();
+  }
+};
+
 template <typename ConstOpTy>
 class ConstOpConversion : public OpConversionPattern<ConstOpTy> {
  public:
@@ -3363,6 +3582,22 @@ class ConstRefRodataOpConversion
   }
 };
 
+// The C target has no fiber scheduler, so a yield resumes immediately: it is
+// rewritten into a vm.br to the resume block, which then takes the regular
+// branch lowering including the ref block argument handling.
+class YieldOpConversion : public OpConversionPattern<IREE::VM::YieldOp> {
+  using OpConversionPattern<IREE::VM::YieldOp>::OpConversionPattern;
+
+ private:
+  LogicalResult matchAndRewrite(
+      IREE::VM::YieldOp op, OpAdaptor adaptor,
+      ConversionPatternRewriter &rewriter) const override {
+    rewriter.replaceOpWithNewOp<IREE::VM::BranchOp>(op, op.dest(),
+                                                    op.destOperands());
+    return success();
+  }
+};
+
 class BranchOpConversion : public OpConversionPattern<IREE::VM::BranchOp> {
   using OpConversionPattern<IREE::VM::BranchOp>::OpConversionPattern;
 
@@ -3935,29 +4170,41 @@ class GlobalLoadStoreRefOpConversion
       LoadStoreOpTy op, Adaptor adaptor,
       ConversionPatternRewriter &rewriter) const override {
     if (isa<IREE::VM::GlobalLoadRefOp>(op)) {
-      return rewriteOp(op.getOperation(), adaptor, rewriter, true);
+      return rewriteOp(op.getOperation(), adaptor, rewriter, true, None);
     } else if (isa<IREE::VM::GlobalStoreRefOp>(op)) {
-      return rewriteOp(op.getOperation(), adaptor, rewriter, false);
+      return rewriteOp(op.getOperation(), adaptor, rewriter, false, None);
+    } else if (isa<IREE::VM::GlobalLoadIndirectRefOp>(op)) {
+      // (global)
+      return rewriteOp(op.getOperation(), adaptor, rewriter, true,
+                       adaptor.getOperands()[0]);
+    } else if (isa<IREE::VM::GlobalStoreIndirectRefOp>(op)) {
+      // (value, global)
+      return rewriteOp(op.getOperation(), adaptor, rewriter, false,
+                       adaptor.getOperands()[1]);
     }
 
-    return op.emitError() << "op must be one of `vm.global.load.ref` or "
-                             "`vm.global.store.ref`";
+    return op.emitError() << "op must be one of `vm.global.load.ref`, "
+                             "`vm.global.store.ref` or their indirect forms";
   }
 
+  // |ordinalOperand| holds the runtime ordinal of indirect ops; direct ops
+  // take the ordinal from the referenced vm.global.ref.
   LogicalResult rewriteOp(Operation *op, Adaptor adaptor,
-                          ConversionPatternRewriter &rewriter,
-                          bool isLoad) const {
+                          ConversionPatternRewriter &rewriter, bool isLoad,
+                          Optional<Value> ordinalOperand) const {
     auto ctx = op->getContext();
     auto loc = op->getLoc();
 
-    IREE::VM::GlobalRefOp globalOp =
-        lookupSymbolRef<IREE::VM::GlobalRefOp>(op, "global");
-    if (!globalOp) {
-      return op->emitError() << "Unable to find GlobalOp";
+    uint64_t globalOrdinal = 0;
+    if (!ordinalOperand.hasValue()) {
+      IREE::VM::GlobalRefOp globalOp =
+          lookupSymbolRef<IREE::VM::GlobalRefOp>(op, "global");
+      if (!globalOp) {
+        return op->emitError() << "Unable to find GlobalOp";
+      }
+      globalOrdinal = globalOp.ordinal().getValue().getZExtValue();
     }
 
-    auto globalOrdinal = globalOp.ordinal().getValue().getZExtValue();
-
     auto funcOp = op->getParentOfType<mlir::func::FuncOp>();
     IREE::VM::EmitCTypeConverter *typeConverter =
         this->template getTypeConverter<IREE::VM::EmitCTypeConverter>();
@@ -3987,16 +4234,21 @@ class GlobalLoadStoreRefOpConversion
         /*templateArgs=*/ArrayAttr{},
         /*operands=*/ArrayRef<Value>{stateArg});
 
+    SmallVector<Value, 2> stateRefOperands{refs.getResult(0)};
+    Attribute ordinalArg = rewriter.getUI32IntegerAttr(globalOrdinal);
+    if (ordinalOperand.hasValue()) {
+      stateRefOperands.push_back(ordinalOperand.getValue());
+      ordinalArg = rewriter.getIndexAttr(1);
+    }
     auto stateRef = rewriter.create<emitc::CallOp>(
         /*location=*/loc,
         /*type=*/
         emitc::PointerType::get(emitc::OpaqueType::get(ctx, "iree_vm_ref_t")),
         /*callee=*/StringAttr::get(ctx, "EMITC_ARRAY_ELEMENT_ADDRESS"),
         /*args=*/
-        ArrayAttr::get(ctx, {rewriter.getIndexAttr(0),
-                             rewriter.getUI32IntegerAttr(globalOrdinal)}),
+        ArrayAttr::get(ctx, {rewriter.getIndexAttr(0), ordinalArg}),
         /*templateArgs=*/ArrayAttr{},
-        /*operands=*/ArrayRef<Value>{refs.getResult(0)});
+        /*operands=*/stateRefOperands);
 
     Type elementType = localValue.getType();
 
@@ -4105,6 +4357,102 @@ class GlobalStoreOpConversion : public OpConversionPattern<StoreOpTy> {
   StringRef funcName;
 };
 
+// Indirect variants of the primitive global accessors. The global operand
+// holds the byte offset assigned during ordinal allocation and is passed to
+// the same C helpers the direct ops use.
+template <typename LoadOpTy, typename Adaptor = typename LoadOpTy::Adaptor>
+class GlobalLoadIndirectOpConversion : public OpConversionPattern<LoadOpTy> {
+  using OpConversionPattern<LoadOpTy>::OpConversionPattern;
+
+ public:
+  GlobalLoadIndirectOpConversion(TypeConverter &typeConverter,
+                                 MLIRContext *context, StringRef funcName)
+      : OpConversionPattern<LoadOpTy>(typeConverter, context),
+        funcName(funcName) {}
+
+ private:
+  LogicalResult matchAndRewrite(
+      LoadOpTy loadOp, Adaptor adaptor,
+      ConversionPatternRewriter &rewriter) const override {
+    auto ctx = loadOp.getContext();
+    auto loc = loadOp.getLoc();
+
+    auto funcOp =
+        loadOp.getOperation()->template getParentOfType<mlir::func::FuncOp>();
+
+    BlockArgument stateArg = funcOp.getArgument(2);
+    auto rwDataPtr = rewriter.create<emitc::CallOp>(
+        /*location=*/loc,
+        /*type=*/emitc::PointerType::get(rewriter.getIntegerType(8, false)),
+        /*callee=*/StringAttr::get(ctx, "EMITC_STRUCT_PTR_MEMBER"),
+        /*args=*/
+        ArrayAttr::get(ctx, {rewriter.getIndexAttr(0),
+                             emitc::OpaqueAttr::get(ctx, "rwdata")}),
+        /*templateArgs=*/ArrayAttr{},
+        /*operands=*/ArrayRef<Value>{stateArg});
+
+    rewriter.replaceOpWithNewOp<emitc::CallOp>(
+        /*op=*/loadOp,
+        /*type=*/loadOp.getOperation()->getResultTypes(),
+        /*callee=*/StringAttr::get(ctx, funcName),
+        /*args=*/ArrayAttr{},
+        /*templateArgs=*/ArrayAttr{},
+        /*operands=*/
+        ArrayRef<Value>{rwDataPtr.getResult(0), adaptor.global()});
+
+    return success();
+  }
+
+  StringRef funcName;
+};
+
+template <typename StoreOpTy, typename Adaptor = typename StoreOpTy::Adaptor>
+class GlobalStoreIndirectOpConversion : public OpConversionPattern<StoreOpTy> {
+  using OpConversionPattern<StoreOpTy>::OpConversionPattern;
+
+ public:
+  GlobalStoreIndirectOpConversion(TypeConverter &typeConverter,
+                                  MLIRContext *context, StringRef funcName)
+      : OpConversionPattern<StoreOpTy>(typeConverter, context),
+        funcName(funcName) {}
+
+ private:
+  LogicalResult matchAndRewrite(
+      StoreOpTy storeOp, Adaptor adaptor,
+      ConversionPatternRewriter &rewriter) const override {
+    auto ctx = storeOp.getContext();
+    auto loc = storeOp.getLoc();
+
+    auto funcOp =
+        storeOp.getOperation()->template getParentOfType<mlir::func::FuncOp>();
+
+    BlockArgument stateArg = funcOp.getArgument(2);
+    auto rwDataPtr = rewriter.create<emitc::CallOp>(
+        /*location=*/loc,
+        /*type=*/emitc::PointerType::get(rewriter.getIntegerType(8, false)),
+        /*callee=*/StringAttr::get(ctx, "EMITC_STRUCT_PTR_MEMBER"),
+        /*args=*/
+        ArrayAttr::get(ctx, {rewriter.getIndexAttr(0),
+                             emitc::OpaqueAttr::get(ctx, "rwdata")}),
+        /*templateArgs=*/ArrayAttr{},
+        /*operands=*/ArrayRef<Value>{stateArg});
+
+    rewriter.replaceOpWithNewOp<emitc::CallOp>(
+        /*op=*/storeOp,
+        /*type=*/storeOp.getOperation()->getResultTypes(),
+        /*callee=*/StringAttr::get(ctx, funcName),
+        /*args=*/ArrayAttr{},
+        /*templateArgs=*/ArrayAttr{},
+        /*operands=*/
+        ArrayRef<Value>{rwDataPtr.getResult(0), adaptor.global(),
+                        adaptor.value()});
+
+    return success();
+  }
+
+  StringRef funcName;
+};
+
 // Convert vm list operations to two emitc calls. The wrapping ref pointer
 // is first dereferenced and the result is used as the argument of the
 // specified function name.
@@ -4198,6 +4546,105 @@ class ListOpConversion : public OpConversionPattern<SrcOpTy> {
   bool failable;
 };
 
+// Convert vm buffer operations to a failable call of the matching helper in
+// iree/vm/ops.h. Buffer operands are passed as ref pointers and the helpers
+// handle dereferencing and null checks. Results are returned through out
+// parameters: value results via a local variable and ref results directly
+// into the local ref. Ops allocating new buffers additionally get passed the
+// module state allocator.
+template <typename SrcOpTy, typename Adaptor = typename SrcOpTy::Adaptor>
+class BufferOpConversion : public OpConversionPattern<SrcOpTy> {
+  using OpConversionPattern<SrcOpTy>::OpConversionPattern;
+
+ public:
+  BufferOpConversion(TypeConverter &typeConverter, MLIRContext *context,
+                     StringRef funcName, bool needsAllocator = false)
+      : OpConversionPattern<SrcOpTy>(typeConverter, context),
+        funcName(funcName),
+        needsAllocator(needsAllocator) {}
+
+ private:
+  LogicalResult matchAndRewrite(
+      SrcOpTy op, Adaptor adaptor,
+      ConversionPatternRewriter &rewriter) const override {
+    auto ctx = op.getContext();
+    auto loc = op.getLoc();
+
+    IREE::VM::EmitCTypeConverter *typeConverter =
+        this->template getTypeConverter<IREE::VM::EmitCTypeConverter>();
+
+    SmallVector<Value, 8> updatedOperands(adaptor.getOperands().begin(),
+                                          adaptor.getOperands().end());
+
+    if (needsAllocator) {
+      auto funcOp =
+          op.getOperation()->template getParentOfType<mlir::func::FuncOp>();
+      BlockArgument stateArg = funcOp.getArgument(2);
+      auto allocatorOp = rewriter.create<emitc::CallOp>(
+          /*location=*/loc,
+          /*type=*/emitc::OpaqueType::get(ctx, "iree_allocator_t"),
+          /*callee=*/StringAttr::get(ctx, "EMITC_STRUCT_PTR_MEMBER"),
+          /*args=*/
+          ArrayAttr::get(ctx, {rewriter.getIndexAttr(0),
+                               emitc::OpaqueAttr::get(ctx, "allocator")}),
+          /*templateArgs=*/ArrayAttr{},
+          /*operands=*/ArrayRef<Value>{stateArg});
+      updatedOperands.push_back(allocatorOp.getResult(0));
+    }
+
+    SmallVector<Value, 1> resultOperands;
+    for (OpResult result : op.getOperation()->getResults()) {
+      if (result.getType().isa<IREE::VM::RefType>()) {
+        Optional<Value> ref = typeConverter->materializeRef(result);
+        if (!ref.hasValue()) {
+          return op.emitError() << "local ref not found";
+        }
+        resultOperands.push_back(ref.getValue());
+        updatedOperands.push_back(ref.getValue());
+      } else {
+        auto resultOp = rewriter.create<emitc::VariableOp>(
+            /*location=*/loc,
+            /*resultType=*/result.getType(),
+            /*value=*/emitc::OpaqueAttr::get(ctx, ""));
+
+        Optional<std::string> cType = getCType(resultOp.getType());
+        if (!cType.hasValue()) {
+          return op.emitError() << "unable to emit C type";
+        }
+
+        auto resultPtrOp = rewriter.create<emitc::ApplyOp>(
+            /*location=*/loc,
+            /*type=*/
+            emitc::PointerType::get(
+                emitc::OpaqueType::get(ctx, cType.getValue())),
+            /*applicableOperator=*/StringAttr::get(ctx, "&"),
+            /*operand=*/resultOp.getResult());
+
+        resultOperands.push_back(resultOp.getResult());
+        updatedOperands.push_back(resultPtrOp.getResult());
+      }
+    }
+
+    returnIfError(
+        /*rewriter=*/rewriter,
+        /*location=*/loc,
+        /*callee=*/StringAttr::get(ctx, funcName),
+        /*args=*/ArrayAttr{},
+        /*templateArgs=*/ArrayAttr{},
+        /*operands=*/ArrayRef<Value>(updatedOperands),
+        /*typeConverter=*/*typeConverter);
+
+    rewriter.replaceOp(op, resultOperands);
+
+    return success();
+  }
+
+  StringRef funcName;
+
+  // Whether the module state allocator is passed after the op operands.
+  bool needsAllocator;
+};
+
 class ListAllocOpConversion
     : public OpConversionPattern<IREE::VM::ListAllocOp> {
  public:
@@ -4327,6 +4774,14 @@ class ListGetOpConversion : public OpConversionPattern<GetOpTy> {
               return std::make_pair(StringRef("IREE_VM_VALUE_TYPE_I64"),
                                     StringRef("iree_vm_value_get_i64"));
             })
+            .template Case<IREE::VM::ListGetF32Op>([&](auto op) {
+              return std::make_pair(StringRef("IREE_VM_VALUE_TYPE_F32"),
+                                    StringRef("iree_vm_value_get_f32"));
+            })
+            .template Case<IREE::VM::ListGetF64Op>([&](auto op) {
+              return std::make_pair(StringRef("IREE_VM_VALUE_TYPE_F64"),
+                                    StringRef("iree_vm_value_get_f64"));
+            })
             .Default([](Operation *) { return std::make_pair(None, None); });
 
     if (!valueTypeEnum.hasValue() || !valueExtractor.hasValue()) {
@@ -4585,6 +5040,10 @@ class ListSetOpConversion : public OpConversionPattern<SetOpTy> {
                 [&](auto op) { return StringRef("iree_vm_value_make_i32"); })
             .template Case<IREE::VM::ListSetI64Op>(
                 [&](auto op) { return StringRef("iree_vm_value_make_i64"); })
+            .template Case<IREE::VM::ListSetF32Op>(
+                [&](auto op) { return StringRef("iree_vm_value_make_f32"); })
+            .template Case<IREE::VM::ListSetF64Op>(
+                [&](auto op) { return StringRef("iree_vm_value_make_f64"); })
             .Default([](Operation *) { return None; });
 
     if (!valueConstructor.hasValue()) {
@@ -4713,6 +5172,8 @@ void populateVMToEmitCPatterns(ConversionTarget &conversionTarget,
   auto context = patterns.getContext();
   populateUtilConversionPatterns(context, conversionTarget, typeConverter,
                                  patterns);
+  patterns.add<DoNotOptimizeRefOpConversion>(typeConverter, context,
+                                             /*benefit=*/2);
 
   // CFG
   patterns.add<BranchOpConversion>(typeConverter, context);
@@ -4725,6 +5186,7 @@ void populateVMToEmitCPatterns(ConversionTarget &conversionTarget,
   patterns.add<ExportOpConversion>(typeConverter, context, visitedExports);
   patterns.add<ImportOpConversion>(typeConverter, context, importShims);
   patterns.add<ReturnOpConversion>(typeConverter, context);
+  patterns.add<YieldOpConversion>(typeConverter, context);
 
   // Globals
   patterns.add<
@@ -4738,6 +5200,18 @@ void populateVMToEmitCPatterns(ConversionTarget &conversionTarget,
       typeConverter, context);
   patterns.add<GlobalLoadStoreRefOpConversion<IREE::VM::GlobalStoreRefOp>>(
       typeConverter, context);
+  patterns.add<
+      GlobalLoadStoreRefOpConversion<IREE::VM::GlobalLoadIndirectRefOp>>(
+      typeConverter, context);
+  patterns.add<
+      GlobalLoadStoreRefOpConversion<IREE::VM::GlobalStoreIndirectRefOp>>(
+      typeConverter, context);
+  patterns.add<
+      GlobalLoadIndirectOpConversion<IREE::VM::GlobalLoadIndirectI32Op>>(
+      typeConverter, context, "vm_global_load_i32");
+  patterns.add<
+      GlobalStoreIndirectOpConversion<IREE::VM::GlobalStoreIndirectI32Op>>(
+      typeConverter, context, "vm_global_store_i32");
 
   // Constants
   patterns.add<ConstOpConversion<IREE::VM::ConstI32Op>>(typeConverter, context);
@@ -4746,6 +5220,40 @@ void populateVMToEmitCPatterns(ConversionTarget &conversionTarget,
   patterns.add<ConstRefZeroOpConversion>(typeConverter, context);
   patterns.add<ConstRefRodataOpConversion>(typeConverter, context);
 
+  // Buffer ops
+  patterns.add<BufferOpConversion<IREE::VM::BufferAllocOp>>(
+      typeConverter, context, "vm_buffer_alloc", /*needsAllocator=*/true);
+  patterns.add<BufferOpConversion<IREE::VM::BufferCloneOp>>(
+      typeConverter, context, "vm_buffer_clone", /*needsAllocator=*/true);
+  patterns.add<BufferOpConversion<IREE::VM::BufferLengthOp>>(
+      typeConverter, context, "vm_buffer_length");
+  patterns.add<BufferOpConversion<IREE::VM::BufferCopyOp>>(
+      typeConverter, context, "vm_buffer_copy");
+  patterns.add<BufferOpConversion<IREE::VM::BufferCompareOp>>(
+      typeConverter, context, "vm_buffer_compare");
+  patterns.add<BufferOpConversion<IREE::VM::BufferFillI8Op>>(
+      typeConverter, context, "vm_buffer_fill_i8");
+  patterns.add<BufferOpConversion<IREE::VM::BufferFillI16Op>>(
+      typeConverter, context, "vm_buffer_fill_i16");
+  patterns.add<BufferOpConversion<IREE::VM::BufferFillI32Op>>(
+      typeConverter, context, "vm_buffer_fill_i32");
+  patterns.add<BufferOpConversion<IREE::VM::BufferLoadI8UOp>>(
+      typeConverter, context, "vm_buffer_load_i8u");
+  patterns.add<BufferOpConversion<IREE::VM::BufferLoadI8SOp>>(
+      typeConverter, context, "vm_buffer_load_i8s");
+  patterns.add<BufferOpConversion<IREE::VM::BufferLoadI16UOp>>(
+      typeConverter, context, "vm_buffer_load_i16u");
+  patterns.add<BufferOpConversion<IREE::VM::BufferLoadI16SOp>>(
+      typeConverter, context, "vm_buffer_load_i16s");
+  patterns.add<BufferOpConversion<IREE::VM::BufferLoadI32Op>>(
+      typeConverter, context, "vm_buffer_load_i32");
+  patterns.add<BufferOpConversion<IREE::VM::BufferStoreI8Op>>(
+      typeConverter, context, "vm_buffer_store_i8");
+  patterns.add<BufferOpConversion<IREE::VM::BufferStoreI16Op>>(
+      typeConverter, context, "vm_buffer_store_i16");
+  patterns.add<BufferOpConversion<IREE::VM::BufferStoreI32Op>>(
+      typeConverter, context, "vm_buffer_store_i32");
+
   // List ops
   patterns.add<ListAllocOpConversion>(typeConverter, context);
   patterns.add<ListOpConversion<IREE::VM::ListReserveOp>>(
@@ -4756,14 +5264,22 @@ void populateVMToEmitCPatterns(ConversionTarget &conversionTarget,
       typeConverter, context, "iree_vm_list_size", 0, false);
   patterns.add<ListGetOpConversion<IREE::VM::ListGetI32Op>>(typeConverter,
                                                             context);
+  patterns.add<ListGetOpConversion<IREE::VM::ListGetF32Op>>(typeConverter,
+                                                            context);
   patterns.add<ListGetRefOpConversion>(typeConverter, context);
   patterns.add<ListSetOpConversion<IREE::VM::ListSetI32Op>>(typeConverter,
                                                             context);
+  patterns.add<ListSetOpConversion<IREE::VM::ListSetF32Op>>(typeConverter,
+                                                            context);
   patterns.add<ListSetRefOpConversion>(typeConverter, context);
 
   // Conditional assignment ops
   patterns.add<GenericOpConversion<IREE::VM::SelectI32Op>>(
       typeConverter, context, "vm_select_i32");
+  patterns.add<SelectRefOpConversion>(typeConverter, context);
+  patterns.add<SwitchOpConversion<IREE::VM::SwitchI32Op>>(
+      typeConverter, context, "vm_select_i32");
+  patterns.add<SwitchRefOpConversion>(typeConverter, context);
 
   // Native integer arithmetic ops
   patterns.add<GenericOpConversion<IREE::VM::AddI32Op>>(typeConverter, context,
@@ -4837,6 +5353,20 @@ void populateVMToEmitCPatterns(ConversionTarget &conversionTarget,
   patterns.add<GlobalStoreOpConversion<IREE::VM::GlobalStoreF32Op,
                                        IREE::VM::GlobalF32Op>>(
       typeConverter, context, "vm_global_store_f32");
+  patterns.add<
+      GlobalLoadIndirectOpConversion<IREE::VM::GlobalLoadIndirectF32Op>>(
+      typeConverter, context, "vm_global_load_f32");
+  patterns.add<
+      GlobalStoreIndirectOpConversion<IREE::VM::GlobalStoreIndirectF32Op>>(
+      typeConverter, context, "vm_global_store_f32");
+
+  // ExtF32: Buffer ops
+  patterns.add<BufferOpConversion<IREE::VM::BufferFillF32Op>>(
+      typeConverter, context, "vm_buffer_fill_f32");
+  patterns.add<BufferOpConversion<IREE::VM::BufferLoadF32Op>>(
+      typeConverter, context, "vm_buffer_load_f32");
+  patterns.add<BufferOpConversion<IREE::VM::BufferStoreF32Op>>(
+      typeConverter, context, "vm_buffer_store_f32");
 
   // ExtF32: Native floating-point constants
   patterns.add<ConstOpConversion<IREE::VM::ConstF32Op>>(typeConverter, context);
@@ -4846,6 +5376,8 @@ void populateVMToEmitCPatterns(ConversionTarget &conversionTarget,
   // ExtF32: Conditional assignment
   patterns.add<GenericOpConversion<IREE::VM::SelectF32Op>>(
       typeConverter, context, "vm_select_f32");
+  patterns.add<SwitchOpConversion<IREE::VM::SwitchF32Op>>(
+      typeConverter, context, "vm_select_f32");
 
   // ExtF32: Native floating-point arithmetic
   patterns.add<GenericOpConversion<IREE::VM::AddF32Op>>(typeConverter, context,
@@ -4943,12 +5475,26 @@ void populateVMToEmitCPatterns(ConversionTarget &conversionTarget,
   patterns.add<GlobalStoreOpConversion<IREE::VM::GlobalStoreI64Op,
                                        IREE::VM::GlobalI64Op>>(
       typeConverter, context, "vm_global_store_i64");
+  patterns.add<
+      GlobalLoadIndirectOpConversion<IREE::VM::GlobalLoadIndirectI64Op>>(
+      typeConverter, context, "vm_global_load_i64");
+  patterns.add<
+      GlobalStoreIndirectOpConversion<IREE::VM::GlobalStoreIndirectI64Op>>(
+      typeConverter, context, "vm_global_store_i64");
 
   // ExtI64: Constants
   patterns.add<ConstOpConversion<IREE::VM::ConstI64Op>>(typeConverter, context);
   patterns.add<ConstZeroOpConversion<IREE::VM::ConstI64ZeroOp>>(typeConverter,
                                                                 context);
 
+  // ExtI64: Buffer ops
+  patterns.add<BufferOpConversion<IREE::VM::BufferFillI64Op>>(
+      typeConverter, context, "vm_buffer_fill_i64");
+  patterns.add<BufferOpConversion<IREE::VM::BufferLoadI64Op>>(
+      typeConverter, context, "vm_buffer_load_i64");
+  patterns.add<BufferOpConversion<IREE::VM::BufferStoreI64Op>>(
+      typeConverter, context, "vm_buffer_store_i64");
+
   // ExtI64: List ops
   patterns.add<ListGetOpConversion<IREE::VM::ListGetI64Op>>(typeConverter,
                                                             context);
@@ -4958,6 +5504,8 @@ void populateVMToEmitCPatterns(ConversionTarget &conversionTarget,
   // ExtI64: Conditional assignment ops
   patterns.add<GenericOpConversion<IREE::VM::SelectI64Op>>(
       typeConverter, context, "vm_select_i64");
+  patterns.add<SwitchOpConversion<IREE::VM::SwitchI64Op>>(
+      typeConverter, context, "vm_select_i64");
   // ExtI64: Native integer arithmetic ops
   patterns.add<GenericOpConversion<IREE::VM::AddI64Op>>(typeConverter, context,
                                                         "vm_add_i64");
@@ -4985,8 +5533,20 @@ void populateVMToEmitCPatterns(ConversionTarget &conversionTarget,
                                                         "vm_xor_i64");
 
   // ExtI64: Casting and type conversion/emulation ops
+  patterns.add<GenericOpConversion<IREE::VM::TruncI64I8Op>>(
+      typeConverter, context, "vm_trunc_i64i8");
+  patterns.add<GenericOpConversion<IREE::VM::TruncI64I16Op>>(
+      typeConverter, context, "vm_trunc_i64i16");
   patterns.add<GenericOpConversion<IREE::VM::TruncI64I32Op>>(
       typeConverter, context, "vm_trunc_i64i32");
+  patterns.add<GenericOpConversion<IREE::VM::ExtI8I64SOp>>(
+      typeConverter, context, "vm_ext_i8i64s");
+  patterns.add<GenericOpConversion<IREE::VM::ExtI8I64UOp>>(
+      typeConverter, context, "vm_ext_i8i64u");
+  patterns.add<GenericOpConversion<IREE::VM::ExtI16I64SOp>>(
+      typeConverter, context, "vm_ext_i16i64s");
+  patterns.add<GenericOpConversion<IREE::VM::ExtI16I64UOp>>(
+      typeConverter, context, "vm_ext_i16i64u");
   patterns.add<GenericOpConversion<IREE::VM::ExtI32I64SOp>>(
       typeConverter, context, "vm_ext_i32i64s");
   patterns.add<GenericOpConversion<IREE::VM::ExtI32I64UOp>>(
@@ -5011,6 +5571,130 @@ void populateVMToEmitCPatterns(ConversionTarget &conversionTarget,
       typeConverter, context, "vm_cmp_lt_i64u");
   patterns.add<GenericOpConversion<IREE::VM::CmpNZI64Op>>(
       typeConverter, context, "vm_cmp_nz_i64");
+
+  // ExtF64: Globals
+  patterns.add<
+      GlobalLoadOpConversion<IREE::VM::GlobalLoadF64Op, IREE::VM::GlobalF64Op>>(
+      typeConverter, context, "vm_global_load_f64");
+  patterns.add<GlobalStoreOpConversion<IREE::VM::GlobalStoreF64Op,
+                                       IREE::VM::GlobalF64Op>>(
+      typeConverter, context, "vm_global_store_f64");
+  patterns.add<
+      GlobalLoadIndirectOpConversion<IREE::VM::GlobalLoadIndirectF64Op>>(
+      typeConverter, context, "vm_global_load_f64");
+  patterns.add<
+      GlobalStoreIndirectOpConversion<IREE::VM::GlobalStoreIndirectF64Op>>(
+      typeConverter, context, "vm_global_store_f64");
+
+  // ExtF64: Buffer ops
+  patterns.add<BufferOpConversion<IREE::VM::BufferFillF64Op>>(
+      typeConverter, context, "vm_buffer_fill_f64");
+  patterns.add<BufferOpConversion<IREE::VM::BufferLoadF64Op>>(
+      typeConverter, context, "vm_buffer_load_f64");
+  patterns.add<BufferOpConversion<IREE::VM::BufferStoreF64Op>>(
+      typeConverter, context, "vm_buffer_store_f64");
+
+  // ExtF64: List ops
+  patterns.add<ListGetOpConversion<IREE::VM::ListGetF64Op>>(typeConverter,
+                                                            context);
+  patterns.add<ListSetOpConversion<IREE::VM::ListSetF64Op>>(typeConverter,
+                                                            context);
+
+  // ExtF64: Native floating-point constants
+  patterns.add<ConstOpConversion<IREE::VM::ConstF64Op>>(typeConverter, context);
+  patterns.add<ConstZeroOpConversion<IREE::VM::ConstF64ZeroOp>>(typeConverter,
+                                                                context);
+
+  // ExtF64: Conditional assignment
+  patterns.add<GenericOpConversion<IREE::VM::SelectF64Op>>(
+      typeConverter, context, "vm_select_f64");
+  patterns.add<SwitchOpConversion<IREE::VM::SwitchF64Op>>(
+      typeConverter, context, "vm_select_f64");
+
+  // ExtF64: Native floating-point arithmetic
+  patterns.add<GenericOpConversion<IREE::VM::AddF64Op>>(typeConverter, context,
+                                                        "vm_add_f64");
+  patterns.add<GenericOpConversion<IREE::VM::SubF64Op>>(typeConverter, context,
+                                                        "vm_sub_f64");
+  patterns.add<GenericOpConversion<IREE::VM::MulF64Op>>(typeConverter, context,
+                                                        "vm_mul_f64");
+  patterns.add<GenericOpConversion<IREE::VM::DivF64Op>>(typeConverter, context,
+                                                        "vm_div_f64");
+  patterns.add<GenericOpConversion<IREE::VM::RemF64Op>>(typeConverter, context,
+                                                        "vm_rem_f64");
+  patterns.add<GenericOpConversion<IREE::VM::FMAF64Op>>(typeConverter, context,
+                                                        "vm_fma_f64");
+  patterns.add<GenericOpConversion<IREE::VM::AbsF64Op>>(typeConverter, context,
+                                                        "vm_abs_f64");
+  patterns.add<GenericOpConversion<IREE::VM::NegF64Op>>(typeConverter, context,
+                                                        "vm_neg_f64");
+  patterns.add<GenericOpConversion<IREE::VM::CeilF64Op>>(typeConverter, context,
+                                                         "vm_ceil_f64");
+  patterns.add<GenericOpConversion<IREE::VM::FloorF64Op>>(
+      typeConverter, context, "vm_floor_f64");
+
+  patterns.add<GenericOpConversion<IREE::VM::AtanF64Op>>(typeConverter, context,
+                                                         "vm_atan_f64");
+  patterns.add<GenericOpConversion<IREE::VM::Atan2F64Op>>(
+      typeConverter, context, "vm_atan2_f64");
+  patterns.add<GenericOpConversion<IREE::VM::CosF64Op>>(typeConverter, context,
+                                                        "vm_cos_f64");
+  patterns.add<GenericOpConversion<IREE::VM::SinF64Op>>(typeConverter, context,
+                                                        "vm_sin_f64");
+  patterns.add<GenericOpConversion<IREE::VM::ExpF64Op>>(typeConverter, context,
+                                                        "vm_exp_f64");
+  patterns.add<GenericOpConversion<IREE::VM::Exp2F64Op>>(typeConverter, context,
+                                                         "vm_exp2_f64");
+  patterns.add<GenericOpConversion<IREE::VM::ExpM1F64Op>>(
+      typeConverter, context, "vm_expm1_f64");
+  patterns.add<GenericOpConversion<IREE::VM::LogF64Op>>(typeConverter, context,
+                                                        "vm_log_f64");
+  patterns.add<GenericOpConversion<IREE::VM::Log10F64Op>>(
+      typeConverter, context, "vm_log10_f64");
+  patterns.add<GenericOpConversion<IREE::VM::Log1pF64Op>>(
+      typeConverter, context, "vm_log1p_f64");
+  patterns.add<GenericOpConversion<IREE::VM::Log2F64Op>>(typeConverter, context,
+                                                         "vm_log2_f64");
+  patterns.add<GenericOpConversion<IREE::VM::PowF64Op>>(typeConverter, context,
+                                                        "vm_pow_f64");
+  patterns.add<GenericOpConversion<IREE::VM::RsqrtF64Op>>(
+      typeConverter, context, "vm_rsqrt_f64");
+  patterns.add<GenericOpConversion<IREE::VM::SqrtF64Op>>(typeConverter, context,
+                                                         "vm_sqrt_f64");
+  patterns.add<GenericOpConversion<IREE::VM::TanhF64Op>>(typeConverter, context,
+                                                         "vm_tanh_f64");
+  patterns.add<GenericOpConversion<IREE::VM::ErfF64Op>>(typeConverter, context,
+                                                        "vm_erf_f64");
+
+  // ExtF64: Casting and type conversion/emulation
+  patterns.add<GenericOpConversion<IREE::VM::TruncF64F32Op>>(
+      typeConverter, context, "vm_trunc_f64f32");
+  patterns.add<GenericOpConversion<IREE::VM::ExtF32F64Op>>(
+      typeConverter, context, "vm_ext_f32f64");
+  patterns.add<GenericOpConversion<IREE::VM::BitcastI64F64Op>>(
+      typeConverter, context, "vm_bitcast_i64f64");
+  patterns.add<GenericOpConversion<IREE::VM::BitcastF64I64Op>>(
+      typeConverter, context, "vm_bitcast_f64i64");
+
+  // ExtF64: Comparison ops
+  patterns.add<GenericOpConversion<IREE::VM::CmpEQF64OOp>>(
+      typeConverter, context, "vm_cmp_eq_f64o");
+  patterns.add<GenericOpConversion<IREE::VM::CmpEQF64UOp>>(
+      typeConverter, context, "vm_cmp_eq_f64u");
+  patterns.add<GenericOpConversion<IREE::VM::CmpNEF64OOp>>(
+      typeConverter, context, "vm_cmp_ne_f64o");
+  patterns.add<GenericOpConversion<IREE::VM::CmpNEF64UOp>>(
+      typeConverter, context, "vm_cmp_ne_f64u");
+  patterns.add<GenericOpConversion<IREE::VM::CmpLTF64OOp>>(
+      typeConverter, context, "vm_cmp_lt_f64o");
+  patterns.add<GenericOpConversion<IREE::VM::CmpLTF64UOp>>(
+      typeConverter, context, "vm_cmp_lt_f64u");
+  patterns.add<GenericOpConversion<IREE::VM::CmpLTEF64OOp>>(
+      typeConverter, context, "vm_cmp_lte_f64o");
+  patterns.add<GenericOpConversion<IREE::VM::CmpLTEF64UOp>>(
+      typeConverter, context, "vm_cmp_lte_f64u");
+  patterns.add<GenericOpConversion<IREE::VM::CmpNaNF64Op>>(
+      typeConverter, context, "vm_cmp_nan_f64");
 }
 
 namespace IREE {
@@ -5131,6 +5815,7 @@ class ConvertVMToEmitCPass
     target.addLegalOp<IREE::VM::GlobalI32Op>();
     target.addLegalOp<IREE::VM::GlobalI64Op>();
     target.addLegalOp<IREE::VM::GlobalF32Op>();
+    target.addLegalOp<IREE::VM::GlobalF64Op>();
     target.addLegalOp<IREE::VM::GlobalRefOp>();
 
     // This op is needed in the printer to emit an array holding the data.
@@ -5151,7 +5836,8 @@ class ConvertVMToEmitCPass
     module.walk([&materializations](Operation *op) {
       // Global ops are dead now
       if (isa<IREE::VM::GlobalI32Op, IREE::VM::GlobalI64Op,
-              IREE::VM::GlobalF32Op, IREE::VM::GlobalRefOp>(op)) {
+              IREE::VM::GlobalF32Op, IREE::VM::GlobalF64Op,
+              IREE::VM::GlobalRefOp>(op)) {
         op->erase();
         return;
       }
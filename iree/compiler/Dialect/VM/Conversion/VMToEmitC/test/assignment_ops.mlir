@@ -8,3 +8,28 @@ vm.module @my_module {
     vm.return %0 : i32
   }
 }
+
+// -----
+
+// CHECK-LABEL: @my_module_switch_i32
+vm.module @my_module {
+  vm.func @switch_i32(%arg0 : i32, %arg1 : i32, %arg2 : i32, %arg3 : i32) -> i32 {
+    // CHECK: %0 = emitc.call "vm_cmp_eq_i32"(%arg3) {args = [0 : index, 0 : i32]} : (i32) -> i32
+    // CHECK-NEXT: %1 = emitc.call "vm_select_i32"(%0, %arg5, %arg4) : (i32, i32, i32) -> i32
+    // CHECK-NEXT: %2 = emitc.call "vm_cmp_eq_i32"(%arg3) {args = [0 : index, 1 : i32]} : (i32) -> i32
+    // CHECK-NEXT: %3 = emitc.call "vm_select_i32"(%2, %arg6, %1) : (i32, i32, i32) -> i32
+    %0 = vm.switch.i32 %arg0[%arg2, %arg3] else %arg1 : i32
+    vm.return %0 : i32
+  }
+}
+
+// -----
+
+// CHECK-LABEL: @my_module_select_ref
+vm.module @my_module {
+  vm.func @select_ref(%arg0 : i32, %arg1 : !vm.buffer, %arg2 : !vm.buffer) -> !vm.buffer {
+    // CHECK: emitc.call "vm_select_ref"(%arg3, %arg4, %arg5, %{{.+}}) : (i32, !emitc.ptr<!emitc.opaque<"iree_vm_ref_t">>, !emitc.ptr<!emitc.opaque<"iree_vm_ref_t">>, !emitc.ptr<!emitc.opaque<"iree_vm_ref_t">>) -> ()
+    %0 = vm.select.ref %arg0, %arg1, %arg2 : !vm.buffer
+    vm.return %0 : !vm.buffer
+  }
+}
@@ -0,0 +1,22 @@
+// RUN: iree-opt -split-input-file -pass-pipeline="vm.module(iree-vm-ordinal-allocation),vm.module(iree-convert-vm-to-emitc)" %s | FileCheck %s
+
+// CHECK-LABEL: @my_module_select_f64
+vm.module @my_module {
+  vm.func @select_f64(%arg0 : i32, %arg1 : f64, %arg2 : f64) -> f64 {
+    // CHECK: %0 = emitc.call "vm_select_f64"(%arg3, %arg4, %arg5) : (i32, f64, f64) -> f64
+    %0 = vm.select.f64 %arg0, %arg1, %arg2 : f64
+    vm.return %0 : f64
+  }
+}
+
+// -----
+
+// CHECK-LABEL: @my_module_switch_f64
+vm.module @my_module {
+  vm.func @switch_f64(%arg0 : i32, %arg1 : f64, %arg2 : f64) -> f64 {
+    // CHECK: %0 = emitc.call "vm_cmp_eq_i32"(%arg3) {args = [0 : index, 0 : i32]} : (i32) -> i32
+    // CHECK-NEXT: %1 = emitc.call "vm_select_f64"(%0, %arg5, %arg4) : (i32, f64, f64) -> f64
+    %0 = vm.switch.f64 %arg0[%arg2] else %arg1 : f64
+    vm.return %0 : f64
+  }
+}
@@ -0,0 +1,34 @@
+// RUN: iree-opt -split-input-file -pass-pipeline="vm.module(iree-vm-ordinal-allocation),vm.module(iree-convert-vm-to-emitc)" %s | FileCheck %s
+
+// CHECK-LABEL: @my_module_trunc_f64
+vm.module @my_module {
+  vm.func @trunc_f64(%arg0 : f64) -> f32 {
+    // CHECK-NEXT: %0 = emitc.call "vm_trunc_f64f32"(%arg3) : (f64) -> f32
+    %0 = vm.trunc.f64.f32 %arg0 : f64 -> f32
+    vm.return %0 : f32
+  }
+}
+
+// -----
+
+// CHECK-LABEL: @my_module_ext_f32
+vm.module @my_module {
+  vm.func @ext_f32(%arg0 : f32) -> f64 {
+    // CHECK-NEXT: %0 = emitc.call "vm_ext_f32f64"(%arg3) : (f32) -> f64
+    %0 = vm.ext.f32.f64 %arg0 : f32 -> f64
+    vm.return %0 : f64
+  }
+}
+
+// -----
+
+// CHECK-LABEL: @my_module_bitcast
+vm.module @my_module {
+  vm.func @bitcast(%arg0 : i64) -> i64 {
+    // CHECK-NEXT: %0 = emitc.call "vm_bitcast_i64f64"(%arg3) : (i64) -> f64
+    %0 = vm.bitcast.i64.f64 %arg0 : i64 -> f64
+    // CHECK-NEXT: %1 = emitc.call "vm_bitcast_f64i64"(%0) : (f64) -> i64
+    %1 = vm.bitcast.f64.i64 %0 : f64 -> i64
+    vm.return %1 : i64
+  }
+}
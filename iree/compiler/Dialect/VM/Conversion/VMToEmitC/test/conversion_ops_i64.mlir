@@ -21,3 +21,33 @@ vm.module @my_module {
     vm.return %1 : i64
   }
 }
+
+// -----
+
+// CHECK-LABEL: @my_module_trunc_i64_narrow
+vm.module @my_module {
+  vm.func @trunc_i64_narrow(%arg0 : i64) -> i32 {
+    // CHECK-NEXT: %0 = emitc.call "vm_trunc_i64i8"(%arg3) : (i64) -> i32
+    %0 = vm.trunc.i64.i8 %arg0 : i64 -> i32
+    // CHECK-NEXT: %1 = emitc.call "vm_trunc_i64i16"(%arg3) : (i64) -> i32
+    %1 = vm.trunc.i64.i16 %arg0 : i64 -> i32
+    vm.return %1 : i32
+  }
+}
+
+// -----
+
+// CHECK-LABEL: @my_module_ext_narrow_i64
+vm.module @my_module {
+  vm.func @ext_narrow_i64(%arg0 : i32) -> i64 {
+    // CHECK-NEXT: %0 = emitc.call "vm_ext_i8i64s"(%arg3) : (i32) -> i64
+    %0 = vm.ext.i8.i64.s %arg0 : i32 -> i64
+    // CHECK-NEXT: %1 = emitc.call "vm_ext_i8i64u"(%arg3) : (i32) -> i64
+    %1 = vm.ext.i8.i64.u %arg0 : i32 -> i64
+    // CHECK-NEXT: %2 = emitc.call "vm_ext_i16i64s"(%arg3) : (i32) -> i64
+    %2 = vm.ext.i16.i64.s %arg0 : i32 -> i64
+    // CHECK-NEXT: %3 = emitc.call "vm_ext_i16i64u"(%arg3) : (i32) -> i64
+    %3 = vm.ext.i16.i64.u %arg0 : i32 -> i64
+    vm.return %3 : i64
+  }
+}
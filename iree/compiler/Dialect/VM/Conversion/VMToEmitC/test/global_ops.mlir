@@ -63,3 +63,19 @@ vm.module @my_module {
     vm.return
   }
 }
+
+// -----
+
+vm.module @my_module {
+  vm.global.i32 private mutable @c107_mut = 107 : i32
+
+  // CHECK-LABEL: @my_module_global_load_indirect_i32
+  vm.func @global_load_indirect_i32() -> i32 {
+    // CHECK: %[[ADDR:.+]] = "emitc.constant"() {value = 0 : i32} : () -> i32
+    // CHECK: %[[RWDATA:.+]] = emitc.call "EMITC_STRUCT_PTR_MEMBER"(%arg2) {args = [0 : index, #emitc.opaque<"rwdata">]} : (!emitc.ptr<!emitc.opaque<"my_module_state_t">>) -> !emitc.ptr<ui8>
+    // CHECK-NEXT: %{{.+}} = emitc.call "vm_global_load_i32"(%[[RWDATA]], %[[ADDR]]) : (!emitc.ptr<ui8>, i32) -> i32
+    %0 = vm.global.address @c107_mut : !util.ptr<i32>
+    %1 = vm.global.load.indirect.i32 %0 : !util.ptr<i32> -> i32
+    vm.return %1 : i32
+  }
+}
@@ -17,6 +17,7 @@
 #include "iree/compiler/Dialect/VM/IR/VMDialect.h"
 #include "iree/compiler/Dialect/VM/IR/VMOps.h"
 #include "iree/compiler/Dialect/VM/Target/Bytecode/BytecodeEncoder.h"
+#include "iree/compiler/Dialect/VM/Target/Bytecode/ConstantEncoder.h"
 #include "iree/compiler/Dialect/VM/Transforms/Passes.h"
 #include "iree/compiler/Dialect/VM/Utils/CallingConvention.h"
 #include "iree/compiler/Utils/FlatbufferUtils.h"
@@ -24,7 +25,6 @@
 #include "iree/schemas/bytecode_module_def_builder.h"
 #include "iree/schemas/bytecode_module_def_json_printer.h"
 #include "llvm/ADT/StringSwitch.h"
-#include "llvm/Support/CRC.h"
 #include "llvm/Support/Endian.h"
 #include "llvm/Support/ErrorHandling.h"
 #include "mlir/IR/Attributes.h"
@@ -53,61 +53,6 @@ struct TypeDef {
   std::string full_name;
 };
 
-struct SerializedConstantRef {
-  flatbuffers_uint8_vec_ref_t ref = 0;
-  int64_t totalSize = 0;
-  uint32_t crc32 = 0;
-};
-
-// Serializes a constant attribute to the FlatBuffer as a binary blob.
-// Returns the size in bytes of the serialized value and the flatbuffers offset
-// to the uint8 vec containing the data. If |calculateCRC32| is provided then a
-// CRC32 of the data will be computed and returned as well.
-SerializedConstantRef serializeConstant(Location loc, Attribute valueAttr,
-                                        size_t alignment, bool calculateCRC32,
-                                        FlatbufferBuilder &fbb) {
-  flatcc_builder_start_vector(fbb, 1, alignment, FLATBUFFERS_COUNT_MAX(1));
-
-  auto value = valueAttr.dyn_cast<IREE::Util::SerializableAttrInterface>();
-  assert(value && "expected a serializable rodata value");
-
-  // TODO(benvanik): use fbb.streamUint8Vec + value.serializeToStream.
-  // Right now this will allocate a single slab of the entire storage size and
-  // write the contents into it. streamUint8Vec also does the same thing but
-  // we could extend it with custom fbb storage such that we could reserve the
-  // size in the file and then fix it up after we write it. The complication is
-  // that we need the CRC below and thus have to have the bytes in memory at
-  // some point. An interface member for computeCRC() could be useful as even
-  // though slow it would avoid the need to malloc everything. We could also
-  // switch implementations based on calculateCRC32 - models with GB of params
-  // are probably fine not to have nice hackability :)
-  uint64_t actualSize = value.getStorageSize();
-  if (actualSize > SIZE_MAX) {
-    mlir::emitError(loc) << "constant size " << actualSize
-                         << " exceeds native size_t; unable to serialize";
-    return {};
-  }
-  size_t size = static_cast<size_t>(value.getStorageSize());
-  uint8_t *bytePtr = flatbuffers_uint8_vec_extend(fbb, size);
-  if (failed(value.serializeToBuffer(llvm::support::endianness::little,
-                                     ArrayRef<char>((char *)bytePtr, size)))) {
-    return {};
-  }
-
-  uint8_t *dataPtr =
-      reinterpret_cast<uint8_t *>(flatcc_builder_vector_edit(fbb));
-  size_t totalSize = flatcc_builder_vector_count(fbb);
-  uint32_t crc32Value = 0;
-  if (calculateCRC32) {
-    crc32Value = llvm::crc32(0u, ArrayRef<uint8_t>(dataPtr, totalSize));
-  }
-  return SerializedConstantRef{
-      flatbuffers_uint8_vec_end(fbb),
-      static_cast<int64_t>(totalSize),
-      crc32Value,
-  };
-}
-
 LLVM_PACKED_START
 struct ZIPEndOfCentralDirectoryRecord {
   ulittle32_t signature;  // 0x06054B50
@@ -593,7 +538,7 @@ static LogicalResult buildFlatBufferModule(BytecodeTargetOptions targetOptions,
   // were to serialize all rodata we'd have it in the opposite order as we do
   // in the IR. Though this it isn't required for correctness, enabling file
   // layout planning by preserving the order in the IR is useful.
-  SmallVector<flatbuffers_uint8_vec_ref_t, 8> rodataContentRefs;
+  SmallVector<SerializedConstantRef, 8> rodataContentRefs;
   rodataContentRefs.reserve(rodataOps.size());
 
   // All constants are defaulted to 16-byte aligned as that is the maximum
@@ -612,13 +557,13 @@ static LogicalResult buildFlatBufferModule(BytecodeTargetOptions targetOptions,
             ? static_cast<size_t>(rodataOp.alignment().getValue())
             : 0;
     if (alignment == 0) alignment = kDefaultRodataAlignment;
-    auto constantRef =
-        serializeConstant(rodataOp.getLoc(), rodataOp.value(), alignment,
-                          /*calculateCRC32=*/includeInZIP, fbb);
+    auto constantRef = serializeConstant(
+        rodataOp.getLoc(), rodataOp.value(), alignment,
+        /*calculateCRC32=*/includeInZIP, targetOptions.rodataCompression, fbb);
     if (!constantRef.ref) {
       return rodataOp.emitOpError() << "failed to encode";
     }
-    rodataContentRefs.push_back(constantRef.ref);
+    rodataContentRefs.push_back(constantRef);
 
     // Add the ZIP per-file header.
     if (includeInZIP) {
@@ -687,7 +632,12 @@ static LogicalResult buildFlatBufferModule(BytecodeTargetOptions targetOptions,
   auto rodataSegmentRefs = llvm::to_vector<8>(
       llvm::map_range(rodataContentRefs, [&](auto rodataContentRef) {
         iree_vm_RodataSegmentDef_start(fbb);
-        iree_vm_RodataSegmentDef_data_add(fbb, rodataContentRef);
+        if (rodataContentRef.compressionType.type !=
+            iree_vm_CompressionTypeDef_NONE) {
+          iree_vm_RodataSegmentDef_compression_type_add(
+              fbb, rodataContentRef.compressionType);
+        }
+        iree_vm_RodataSegmentDef_data_add(fbb, rodataContentRef.ref);
         return iree_vm_RodataSegmentDef_end(fbb);
       }));
   SmallVector<iree_vm_RwdataSegmentDef_ref_t, 8> rwdataSegmentRefs;
@@ -912,6 +862,19 @@ void BytecodeTargetOptions::bindOptions(OptionsBinder &binder) {
   binder.opt<bool>("iree-vm-bytecode-module-strip-debug-ops", stripDebugOps,
                    llvm::cl::cat(vmBytecodeOptionsCategory),
                    llvm::cl::desc("Strips debug-only ops from the module"));
+  binder.opt<RodataCompression>(
+      "iree-vm-bytecode-module-rodata-compression", rodataCompression,
+      llvm::cl::cat(vmBytecodeOptionsCategory),
+      llvm::cl::desc("Compression applied to rodata segments that shrink "
+                     "enough to be worth decompressing on load"),
+      llvm::cl::values(
+          clEnumValN(RodataCompression::kNone, "none",
+                     "Store all rodata uncompressed"),
+          clEnumValN(RodataCompression::kSplat, "splat",
+                     "Store repeated byte patterns once"),
+          clEnumValN(RodataCompression::kLZ4, "lz4",
+                     "Splat or LZ4 block compression with optional delta "
+                     "encoding of integer data")));
   binder.opt<bool>(
       "iree-vm-emit-polyglot-zip", emitPolyglotZip,
       llvm::cl::cat(vmBytecodeOptionsCategory),
@@ -32,6 +32,16 @@ enum class BytecodeOutputFormat {
   kAnnotatedMlirText,
 };
 
+// Defines the compression applied to rodata segments.
+enum class RodataCompression {
+  // All rodata is stored uncompressed and mapped directly from the module.
+  kNone,
+  // Rodata consisting of a repeated byte pattern is stored as the pattern.
+  kSplat,
+  // Splats plus LZ4 block compression of all other compressible rodata.
+  kLZ4,
+};
+
 // Options that can be provided to bytecode translation.
 struct BytecodeTargetOptions {
   // Format of the module written to the output stream.
@@ -50,6 +60,10 @@ struct BytecodeTargetOptions {
   // Strips vm ops with the VM_DebugOnly trait.
   bool stripDebugOps = false;
 
+  // Compression of rodata segments. Compressed segments are decompressed into
+  // memory when the module is loaded instead of being mapped from the file.
+  RodataCompression rodataCompression = RodataCompression::kNone;
+
   // Enables the output .vmfb to be inspected as a ZIP file.
   // This is only useful for debugging and should be disabled otherwise.
   bool emitPolyglotZip = false;
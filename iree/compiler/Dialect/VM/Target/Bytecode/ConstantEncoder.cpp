@@ -6,25 +6,194 @@
 
 #include "iree/compiler/Dialect/VM/Target/Bytecode/ConstantEncoder.h"
 
-#include "iree/compiler/Dialect/VM/Utils/ConstantEncoding.h"
+#include <algorithm>
+#include <cstring>
+#include <vector>
+
+#include "iree/compiler/Dialect/Util/IR/UtilTypes.h"
 #include "llvm/Support/CRC.h"
+#include "llvm/Support/Endian.h"
+#include "mlir/IR/BuiltinAttributes.h"
 #include "mlir/IR/BuiltinTypes.h"
+#include "mlir/IR/Diagnostics.h"
 
 namespace mlir {
 namespace iree_compiler {
 namespace IREE {
 namespace VM {
 
-SerializedConstantRef serializeConstant(Location loc, ElementsAttr elementsAttr,
-                                        size_t alignment, bool calculateCRC32,
-                                        FlatbufferBuilder &fbb) {
+namespace {
+
+// Must match IREE_VM_BYTECODE_RODATA_ALIGNMENT in the runtime; constants that
+// require more alignment than this are never compressed.
+static constexpr size_t kMaxCompressedAlignment = 64;
+
+// Constants smaller than this are not worth the decompression overhead.
+static constexpr size_t kMinCompressedSize = 256;
+
+// Uncompressed bytes per LZ4 block. Matches the LZ4 maximum match distance so
+// that blocks lose nothing by being independent.
+static constexpr size_t kLZ4BlockSize = 64 * 1024;
+
+// Compressed data must save at least 1/kMinSavingsDivisor of the size.
+static constexpr size_t kMinSavingsDivisor = 8;
+
+// Returns the length of the smallest power-of-two byte pattern up to 64 bytes
+// that repeats to fill |data| or 0 if there is none.
+static size_t findSplatPatternLength(ArrayRef<uint8_t> data) {
+  for (size_t length = 1; length <= 64 && length < data.size(); length *= 2) {
+    if (data.size() % length != 0) break;
+    if (std::memcmp(data.data(), data.data() + length,
+                    data.size() - length) == 0) {
+      return length;
+    }
+  }
+  return 0;
+}
+
+// Appends |length| encoded with the LZ4 variable-length extension bytes.
+static void appendLZ4Length(size_t length, std::vector<uint8_t> &output) {
+  while (length >= 255) {
+    output.push_back(255);
+    length -= 255;
+  }
+  output.push_back(static_cast<uint8_t>(length));
+}
+
+// Compresses |input| as a single LZ4 block and appends it to |output|.
+// This is a greedy single-probe encoder: it is much faster than the reference
+// high-compression modes and good enough for the large and highly redundant
+// constants we care about.
+static void compressLZ4Block(ArrayRef<uint8_t> input,
+                             std::vector<uint8_t> &output) {
+  // Parameters of the block format.
+  static constexpr size_t kMinMatch = 4;
+  static constexpr size_t kLastLiterals = 5;
+  static constexpr size_t kMatchStartLimit = 12;
+  static constexpr size_t kMaxOffset = 65535;
+  static constexpr unsigned kHashLog = 16;
+
+  auto read32 = [&](size_t offset) {
+    uint32_t value;
+    std::memcpy(&value, input.data() + offset, sizeof(value));
+    return value;
+  };
+  auto hash = [](uint32_t value) {
+    return (value * 2654435761u) >> (32 - kHashLog);
+  };
+
+  size_t anchor = 0;
+  auto appendSequence = [&](size_t literalEnd, size_t offset,
+                            size_t matchLength) {
+    size_t literalLength = literalEnd - anchor;
+    size_t tokenOffset = output.size();
+    output.push_back(0);
+    uint8_t token = static_cast<uint8_t>(std::min<size_t>(literalLength, 15))
+                    << 4;
+    if (literalLength >= 15) appendLZ4Length(literalLength - 15, output);
+    output.insert(output.end(), input.begin() + anchor,
+                  input.begin() + literalEnd);
+    if (matchLength) {
+      output.push_back(static_cast<uint8_t>(offset & 0xFF));
+      output.push_back(static_cast<uint8_t>(offset >> 8));
+      size_t encodedLength = matchLength - kMinMatch;
+      token |= static_cast<uint8_t>(std::min<size_t>(encodedLength, 15));
+      if (encodedLength >= 15) appendLZ4Length(encodedLength - 15, output);
+    }
+    output[tokenOffset] = token;
+  };
+
+  if (input.size() > kMatchStartLimit) {
+    std::vector<int64_t> table(1u << kHashLog, -1);
+    // Matches must start at least kMatchStartLimit bytes before the end of the
+    // block and the final kLastLiterals bytes must always be literals.
+    size_t matchStartEnd = input.size() - kMatchStartLimit;
+    size_t matchEnd = input.size() - kLastLiterals;
+    size_t ip = 0;
+    while (ip < matchStartEnd) {
+      uint32_t sequence = read32(ip);
+      uint32_t slot = hash(sequence);
+      int64_t candidate = table[slot];
+      table[slot] = static_cast<int64_t>(ip);
+      if (candidate < 0 || ip - candidate > kMaxOffset ||
+          read32(candidate) != sequence) {
+        ++ip;
+        continue;
+      }
+      size_t matchLength = kMinMatch;
+      while (ip + matchLength < matchEnd &&
+             input[candidate + matchLength] == input[ip + matchLength]) {
+        ++matchLength;
+      }
+      appendSequence(ip, ip - candidate, matchLength);
+      ip += matchLength;
+      anchor = ip;
+    }
+  }
+
+  // The block always ends with a literal-only sequence.
+  appendSequence(input.size(), 0, 0);
+}
+
+// Compresses |data| as independent LZ4 blocks of kLZ4BlockSize bytes.
+// When |deltaStride| is non-zero each block is delta encoded before
+// compression. Returns the concatenated blocks and populates |blockOffsets|
+// with the start of each block and a trailing total length.
+static std::vector<uint8_t> compressLZ4Blocks(
+    ArrayRef<uint8_t> data, unsigned deltaStride,
+    SmallVectorImpl<uint32_t> &blockOffsets) {
+  std::vector<uint8_t> output;
+  std::vector<uint8_t> scratch;
+  for (size_t offset = 0; offset < data.size(); offset += kLZ4BlockSize) {
+    blockOffsets.push_back(static_cast<uint32_t>(output.size()));
+    auto block =
+        data.slice(offset, std::min(kLZ4BlockSize, data.size() - offset));
+    if (deltaStride) {
+      scratch.assign(block.begin(), block.end());
+      for (size_t i = deltaStride; i < block.size(); ++i) {
+        scratch[i] = block[i] - block[i - deltaStride];
+      }
+      block = ArrayRef<uint8_t>(scratch);
+    }
+    compressLZ4Block(block, output);
+  }
+  blockOffsets.push_back(static_cast<uint32_t>(output.size()));
+  return output;
+}
+
+// Returns the delta stride worth trying for |valueAttr| or 0 if none.
+// Only integer element types benefit from delta encoding; it tends to hurt
+// floating-point data.
+static unsigned getDeltaStride(Attribute valueAttr) {
+  auto elementsAttr = valueAttr.dyn_cast<ElementsAttr>();
+  if (!elementsAttr) return 0;
+  auto elementType =
+      elementsAttr.getType().cast<ShapedType>().getElementType();
+  if (!elementType.isa<IntegerType>()) return 0;
+  unsigned bitWidth = elementType.getIntOrFloatBitWidth();
+  if (bitWidth % 8 != 0 || bitWidth > 64) return 0;
+  return bitWidth / 8;
+}
+
+// Serializes |value| directly into a new uint8 vector in |fbb|.
+static SerializedConstantRef serializeUncompressed(
+    IREE::Util::SerializableAttrInterface value, size_t size, size_t alignment,
+    bool calculateCRC32, FlatbufferBuilder &fbb) {
   flatcc_builder_start_vector(fbb, 1, alignment, FLATBUFFERS_COUNT_MAX(1));
 
-  int32_t bitwidth = elementsAttr.getType().getElementTypeBitWidth();
-  int64_t size = elementsAttr.getNumElements() * (bitwidth / 8);
+  // TODO(benvanik): use fbb.streamUint8Vec + value.serializeToStream.
+  // Right now this will allocate a single slab of the entire storage size and
+  // write the contents into it. streamUint8Vec also does the same thing but
+  // we could extend it with custom fbb storage such that we could reserve the
+  // size in the file and then fix it up after we write it. The complication is
+  // that we need the CRC below and thus have to have the bytes in memory at
+  // some point. An interface member for computeCRC() could be useful as even
+  // though slow it would avoid the need to malloc everything. We could also
+  // switch implementations based on calculateCRC32 - models with GB of params
+  // are probably fine not to have nice hackability :)
   uint8_t *bytePtr = flatbuffers_uint8_vec_extend(fbb, size);
-
-  if (failed(serializeConstantArray(loc, elementsAttr, alignment, bytePtr))) {
+  if (failed(value.serializeToBuffer(llvm::support::endianness::little,
+                                     ArrayRef<char>((char *)bytePtr, size)))) {
     return {};
   }
 
@@ -42,6 +211,94 @@ SerializedConstantRef serializeConstant(Location loc, ElementsAttr elementsAttr,
   };
 }
 
+}  // namespace
+
+SerializedConstantRef serializeConstant(Location loc, Attribute valueAttr,
+                                        size_t alignment, bool calculateCRC32,
+                                        RodataCompression compression,
+                                        FlatbufferBuilder &fbb) {
+  auto value = valueAttr.dyn_cast<IREE::Util::SerializableAttrInterface>();
+  assert(value && "expected a serializable rodata value");
+
+  uint64_t actualSize = value.getStorageSize();
+  if (actualSize > SIZE_MAX) {
+    mlir::emitError(loc) << "constant size " << actualSize
+                         << " exceeds native size_t; unable to serialize";
+    return {};
+  }
+  size_t size = static_cast<size_t>(actualSize);
+
+  if (compression == RodataCompression::kNone || calculateCRC32 ||
+      alignment > kMaxCompressedAlignment || size < kMinCompressedSize ||
+      size > UINT32_MAX) {
+    return serializeUncompressed(value, size, alignment, calculateCRC32, fbb);
+  }
+
+  // Compression needs the whole constant in memory to analyze it.
+  std::vector<uint8_t> data(size);
+  if (failed(value.serializeToBuffer(
+          llvm::support::endianness::little,
+          ArrayRef<char>(reinterpret_cast<char *>(data.data()), size)))) {
+    return {};
+  }
+
+  // Splats are always the best encoding when they apply.
+  if (size_t patternLength = findSplatPatternLength(data)) {
+    auto ref = flatbuffers_uint8_vec_create(fbb, data.data(), patternLength);
+    return SerializedConstantRef{
+        ref,
+        static_cast<int64_t>(patternLength),
+        0,
+        iree_vm_CompressionTypeDef_as_SplatDataDef(
+            iree_vm_SplatDataDef_create(fbb, size)),
+    };
+  }
+
+  if (compression == RodataCompression::kLZ4) {
+    // Try with and without delta encoding and keep the smaller.
+    SmallVector<uint32_t> blockOffsets;
+    unsigned deltaStride = 0;
+    auto compressedData = compressLZ4Blocks(data, deltaStride, blockOffsets);
+    if (unsigned candidateStride = getDeltaStride(valueAttr)) {
+      SmallVector<uint32_t> candidateOffsets;
+      auto candidateData =
+          compressLZ4Blocks(data, candidateStride, candidateOffsets);
+      if (candidateData.size() < compressedData.size()) {
+        compressedData = std::move(candidateData);
+        blockOffsets = std::move(candidateOffsets);
+        deltaStride = candidateStride;
+      }
+    }
+    if (compressedData.size() <= size - size / kMinSavingsDivisor) {
+      auto ref = flatbuffers_uint8_vec_create(fbb, compressedData.data(),
+                                              compressedData.size());
+      auto blockOffsetsRef = flatbuffers_uint32_vec_create(
+          fbb, blockOffsets.data(), blockOffsets.size());
+      iree_vm_LZ4BlockDataDef_start(fbb);
+      iree_vm_LZ4BlockDataDef_byte_length_add(fbb, size);
+      iree_vm_LZ4BlockDataDef_block_size_add(fbb, kLZ4BlockSize);
+      iree_vm_LZ4BlockDataDef_block_offsets_add(fbb, blockOffsetsRef);
+      iree_vm_LZ4BlockDataDef_delta_stride_add(fbb, deltaStride);
+      return SerializedConstantRef{
+          ref,
+          static_cast<int64_t>(compressedData.size()),
+          0,
+          iree_vm_CompressionTypeDef_as_LZ4BlockDataDef(
+              iree_vm_LZ4BlockDataDef_end(fbb)),
+      };
+    }
+  }
+
+  // Not compressible; store the bytes we already have.
+  flatcc_builder_start_vector(fbb, 1, alignment, FLATBUFFERS_COUNT_MAX(1));
+  std::memcpy(flatbuffers_uint8_vec_extend(fbb, size), data.data(), size);
+  return SerializedConstantRef{
+      flatbuffers_uint8_vec_end(fbb),
+      static_cast<int64_t>(size),
+      0,
+  };
+}
+
 }  // namespace VM
 }  // namespace IREE
 }  // namespace iree_compiler
@@ -7,6 +7,7 @@
 #ifndef IREE_COMPILER_DIALECT_VM_TARGET_BYTECODE_CONSTANTENCODER_H_
 #define IREE_COMPILER_DIALECT_VM_TARGET_BYTECODE_CONSTANTENCODER_H_
 
+#include "iree/compiler/Dialect/VM/Target/Bytecode/BytecodeModuleTarget.h"
 #include "iree/compiler/Utils/FlatbufferUtils.h"
 #include "iree/schemas/bytecode_module_def_builder.h"
 #include "mlir/IR/Attributes.h"
@@ -21,14 +22,24 @@ struct SerializedConstantRef {
   flatbuffers_uint8_vec_ref_t ref = 0;
   int64_t totalSize = 0;
   uint32_t crc32 = 0;
+  // Compression parameters of the data in |ref| or NONE if uncompressed.
+  iree_vm_CompressionTypeDef_union_ref_t compressionType =
+      iree_vm_CompressionTypeDef_as_NONE();
 };
 
 // Serializes a constant attribute to the FlatBuffer as a binary blob.
 // Returns the size in bytes of the serialized value and the flatbuffers offset
 // to the uint8 vec containing the data. If |calculateCRC32| is provided then a
 // CRC32 of the data will be computed and returned as well.
-SerializedConstantRef serializeConstant(Location loc, ElementsAttr elementsAttr,
+//
+// The data may be compressed with any of the encodings allowed by
+// |compression| when doing so makes it meaningfully smaller. Constants that
+// need a CRC32 (as they are referenced from the polyglot ZIP) or that require
+// more alignment than the runtime provides for decompressed data are always
+// stored uncompressed.
+SerializedConstantRef serializeConstant(Location loc, Attribute valueAttr,
                                         size_t alignment, bool calculateCRC32,
+                                        RodataCompression compression,
                                         FlatbufferBuilder &fbb);
 
 }  // namespace VM
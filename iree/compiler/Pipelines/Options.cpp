@@ -66,6 +66,13 @@ void HighLevelOptimizationOptions::bindOptions(OptionsBinder &binder) {
       llvm::cl::desc(
           "Reduces numeric precision to lower bit depths where possible."),
       llvm::cl::cat(category));
+  binder.opt<bool>(
+      "iree-opt-int8-quantization", int8Quantization,
+      llvm::cl::desc(
+          "Quantizes f32 matmuls and convolutions with constant weights to "
+          "int8 ops with int32 accumulation using per-tensor activation and "
+          "per-channel weight scales."),
+      llvm::cl::cat(category));
   binder.opt<bool>("iree-opt-strip-assertions", stripAssertions,
                    llvm::cl::desc("Strips debug assertions after any useful "
                                   "information has been extracted."),
@@ -93,6 +100,20 @@ void SchedulingOptions::bindOptions(OptionsBinder &binder) {
                           llvm::cl::desc("File path to write statistics to; or "
                                          "`` for stderr or `-` for stdout."),
                           llvm::cl::cat(category));
+  binder.opt<unsigned>(
+      "iree-scheduling-constant-page-alignment-threshold",
+      constantPageAlignmentThreshold,
+      llvm::cl::desc("Places constants of at least this many bytes at "
+                     "page-aligned offsets so they can be mapped zero-copy "
+                     "from memory-mapped modules; 0 disables."),
+      llvm::cl::cat(category));
+  binder.list<unsigned>(
+      "iree-scheduling-dispatch-shape-buckets", dispatchShapeBuckets,
+      llvm::cl::desc("Power-of-two alignments of dynamic dispatch dimensions "
+                     "to emit specialized dispatch variants for (e.g. 16,64). "
+                     "Dispatch sites select the most aligned variant at "
+                     "runtime and fall back to the generic one."),
+      llvm::cl::ZeroOrMore, llvm::cl::CommaSeparated, llvm::cl::cat(category));
 }
 
 }  // namespace iree_compiler
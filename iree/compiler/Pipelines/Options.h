@@ -7,6 +7,8 @@
 #ifndef IREE_COMPILER_PIPELINES_OPTIONS_H_
 #define IREE_COMPILER_PIPELINES_OPTIONS_H_
 
+#include <vector>
+
 #include "iree/compiler/Utils/OptionUtils.h"
 
 namespace mlir {
@@ -62,6 +64,10 @@ struct HighLevelOptimizationOptions {
   // Optimizations to reduce numeric precision where it is safe to do so.
   bool numericPrecisionReduction = false;
 
+  // Quantizes f32 matmuls and convolutions with constant weights to int8 ops
+  // accumulating in int32.
+  bool int8Quantization = false;
+
   // Strips debug assertions after any useful information has been extracted.
   bool stripAssertions = false;
 
@@ -92,6 +98,14 @@ struct SchedulingOptions {
   // File path to write statistics to; or `` for stderr or `-` for stdout.
   std::string dumpStatisticsFile = "";
 
+  // Constants of at least this many bytes are placed at page-aligned offsets
+  // so they can be mapped zero-copy from memory-mapped modules; 0 disables.
+  unsigned constantPageAlignmentThreshold = 0;
+
+  // Power-of-two alignments of dynamic dispatch dimensions to emit specialized
+  // dispatch variants for. Empty disables specialization.
+  std::vector<unsigned> dispatchShapeBuckets;
+
   // TODO(benvanik): favor size/speed/etc for partitioning.
   // TODO(benvanik): execution model to optimize for (unified/discrete memory,
   //                 single/multiple processors, etc).
@@ -66,6 +66,7 @@ void buildIREEVMTransformPassPipeline(
       highLevelOptimizationOptions.constExprHoisting;
   flowOptions.numericPrecisionReduction =
       highLevelOptimizationOptions.numericPrecisionReduction;
+  flowOptions.int8Quantization = highLevelOptimizationOptions.int8Quantization;
 
   // Enable const-eval via hook. For debug builds, we assert if enabled without
   // a hook. For release, we just silently skip enabling const-eval.
@@ -91,6 +92,9 @@ void buildIREEVMTransformPassPipeline(
   streamOptions.dumpStatisticsFormat =
       (IREE::Stream::DumpOutputFormat)schedulingOptions.dumpStatisticsFormat;
   streamOptions.dumpStatisticsFile = schedulingOptions.dumpStatisticsFile;
+  streamOptions.constantPageAlignmentThreshold =
+      schedulingOptions.constantPageAlignmentThreshold;
+  streamOptions.dispatchShapeBuckets = schedulingOptions.dispatchShapeBuckets;
 
   IREE::Flow::buildFlowTransformPassPipeline(passManager, flowOptions);
   IREE::Stream::buildStreamTransformPassPipeline(passManager, streamOptions);
@@ -32,6 +32,22 @@ LogicalResult ParseCustomKernelTargetFeaturesForAarch64(
   return success();
 }
 
+LogicalResult ParseCustomKernelTargetFeaturesForX86_64(
+    const llvm::SmallVector<llvm::StringRef> &features,
+    CustomKernelsTargetInfo &targetInfo) {
+  for (auto f : features) {
+    if (f.empty()) {
+      continue;
+    }
+    // x86_64 feature strings routinely list many features that are of no
+    // interest here (+avx2, +fma, ...) so unknown ones are ignored.
+    if (f == "+avx512vnni") {
+      targetInfo.add(CustomKernelTargetFeature::X86_64Avx512Vnni);
+    }
+  }
+  return success();
+}
+
 LogicalResult ParseCustomKernelsTargetInfo(
     llvm::StringRef archStr, llvm::StringRef featuresStr,
     CustomKernelsTargetInfo &targetInfo) {
@@ -50,6 +66,10 @@ LogicalResult ParseCustomKernelsTargetInfo(
     targetInfo.init(CustomKernelTargetArch::Aarch64);
     return ParseCustomKernelTargetFeaturesForAarch64(features, targetInfo);
   }
+  if (archStr == "x86_64") {
+    targetInfo.init(CustomKernelTargetArch::X86_64);
+    return ParseCustomKernelTargetFeaturesForX86_64(features, targetInfo);
+  }
 
   // Currently, on unknown arch, we return success as long as no features
   // were specified (we wouldn't know how to parse features for an unknown arch)
@@ -455,6 +455,59 @@ IREE_API_EXPORT iree_status_t iree_hal_command_buffer_dispatch_indirect(
   return status;
 }
 
+// Records |records| one at a time for implementations that don't natively
+// support batches. Validation has already been performed.
+static iree_status_t iree_hal_command_buffer_dispatch_batch_emulated(
+    iree_hal_command_buffer_t* command_buffer, iree_host_size_t record_count,
+    const iree_hal_dispatch_record_t* records) {
+  for (iree_host_size_t i = 0; i < record_count; ++i) {
+    const iree_hal_dispatch_record_t* record = &records[i];
+    if (record->constant_count > 0) {
+      IREE_RETURN_IF_ERROR(_VTABLE_DISPATCH(command_buffer, push_constants)(
+          command_buffer, record->executable_layout, /*offset=*/0,
+          record->constants, record->constant_count * sizeof(uint32_t)));
+    }
+    if (record->binding_count > 0) {
+      IREE_RETURN_IF_ERROR(
+          _VTABLE_DISPATCH(command_buffer, push_descriptor_set)(
+              command_buffer, record->executable_layout, record->set,
+              record->binding_count, record->bindings));
+    }
+    IREE_RETURN_IF_ERROR(_VTABLE_DISPATCH(command_buffer, dispatch)(
+        command_buffer, record->executable, record->entry_point,
+        record->workgroup_count[0], record->workgroup_count[1],
+        record->workgroup_count[2]));
+  }
+  return iree_ok_status();
+}
+
+IREE_API_EXPORT iree_status_t iree_hal_command_buffer_dispatch_batch(
+    iree_hal_command_buffer_t* command_buffer, iree_host_size_t record_count,
+    const iree_hal_dispatch_record_t* records) {
+  IREE_ASSERT_ARGUMENT(command_buffer);
+  IREE_ASSERT_ARGUMENT(!record_count || records);
+  if (IREE_UNLIKELY(record_count == 0)) {
+    return iree_ok_status();
+  }
+  IREE_TRACE_ZONE_BEGIN(z0);
+  IREE_TRACE_ZONE_APPEND_VALUE(z0, (int64_t)record_count);
+  IF_VALIDATING(command_buffer, {
+    IREE_RETURN_AND_END_ZONE_IF_ERROR(
+        z0, iree_hal_command_buffer_dispatch_batch_validation(
+                command_buffer, record_count, records));
+  });
+  iree_status_t status = iree_ok_status();
+  if (_VTABLE_DISPATCH(command_buffer, dispatch_batch)) {
+    status = _VTABLE_DISPATCH(command_buffer, dispatch_batch)(
+        command_buffer, record_count, records);
+  } else {
+    status = iree_hal_command_buffer_dispatch_batch_emulated(
+        command_buffer, record_count, records);
+  }
+  IREE_TRACE_ZONE_END(z0);
+  return status;
+}
+
 //===----------------------------------------------------------------------===//
 // Utilities for command buffer creation
 //===----------------------------------------------------------------------===//
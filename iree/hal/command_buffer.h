@@ -173,6 +173,35 @@ typedef struct iree_hal_buffer_barrier_t {
   iree_device_size_t length;
 } iree_hal_buffer_barrier_t;
 
+// A single dispatch recorded as part of iree_hal_command_buffer_dispatch_batch.
+// Equivalent to an optional iree_hal_command_buffer_push_constants of
+// |constants| at offset 0, an optional
+// iree_hal_command_buffer_push_descriptor_set of |bindings| to |set|, and an
+// iree_hal_command_buffer_dispatch of |executable| |entry_point|.
+typedef struct iree_hal_dispatch_record_t {
+  // Executable and entry point that will be dispatched.
+  iree_hal_executable_t* executable;
+  int32_t entry_point;
+  // XYZ workgroup count of the dispatch.
+  uint32_t workgroup_count[3];
+
+  // Layout used to push |constants| and |bindings|. May be NULL if both
+  // |constant_count| and |binding_count| are 0 in which case the dispatch uses
+  // whatever state was last pushed.
+  iree_hal_executable_layout_t* executable_layout;
+
+  // 4-byte push constant values replacing the range [0, constant_count).
+  // Constants beyond |constant_count| retain their previously pushed values.
+  iree_host_size_t constant_count;
+  const uint32_t* constants;
+
+  // Bindings pushed to descriptor set |set| prior to the dispatch.
+  // When |binding_count| is 0 the previously pushed bindings are used.
+  uint32_t set;
+  iree_host_size_t binding_count;
+  const iree_hal_descriptor_set_binding_t* bindings;
+} iree_hal_dispatch_record_t;
+
 // An RGBA color.
 typedef struct iree_hal_label_color_t {
   uint8_t r;
@@ -485,6 +514,17 @@ IREE_API_EXPORT iree_status_t iree_hal_command_buffer_dispatch_indirect(
     iree_hal_executable_t* executable, int32_t entry_point,
     iree_hal_buffer_t* workgroups_buffer, iree_device_size_t workgroups_offset);
 
+// Dispatches a batch of execution requests.
+// Each record is recorded as if by a sequence of push_constants,
+// push_descriptor_set, and dispatch calls and the push constant and descriptor
+// set state after the batch is that of the last record. Implementations can
+// record the batch significantly faster than the equivalent individual calls
+// as validation, state tracking, and resource retention is amortized across
+// the records.
+IREE_API_EXPORT iree_status_t iree_hal_command_buffer_dispatch_batch(
+    iree_hal_command_buffer_t* command_buffer, iree_host_size_t record_count,
+    const iree_hal_dispatch_record_t* records);
+
 //===----------------------------------------------------------------------===//
 // Utilities for command buffer creation
 //===----------------------------------------------------------------------===//
@@ -663,6 +703,12 @@ typedef struct iree_hal_command_buffer_vtable_t {
       iree_hal_executable_t* executable, int32_t entry_point,
       iree_hal_buffer_t* workgroups_buffer,
       iree_device_size_t workgroups_offset);
+
+  // Optional; when NULL batches are recorded by calling push_constants,
+  // push_descriptor_set, and dispatch for each record.
+  iree_status_t(IREE_API_PTR* dispatch_batch)(
+      iree_hal_command_buffer_t* command_buffer, iree_host_size_t record_count,
+      const iree_hal_dispatch_record_t* records);
 } iree_hal_command_buffer_vtable_t;
 IREE_HAL_ASSERT_VTABLE_LAYOUT(iree_hal_command_buffer_vtable_t);
 
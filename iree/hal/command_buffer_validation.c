@@ -439,3 +439,34 @@ iree_status_t iree_hal_command_buffer_dispatch_indirect_validation(
 
   return iree_ok_status();
 }
+
+iree_status_t iree_hal_command_buffer_dispatch_batch_validation(
+    iree_hal_command_buffer_t* command_buffer, iree_host_size_t record_count,
+    const iree_hal_dispatch_record_t* records) {
+  IREE_RETURN_IF_ERROR(iree_hal_command_buffer_validate_categories(
+      command_buffer, IREE_HAL_COMMAND_CATEGORY_DISPATCH));
+  for (iree_host_size_t i = 0; i < record_count; ++i) {
+    const iree_hal_dispatch_record_t* record = &records[i];
+    if (IREE_UNLIKELY(!record->executable)) {
+      return iree_make_status(IREE_STATUS_INVALID_ARGUMENT,
+                              "dispatch record %zu has no executable", i);
+    }
+    if (IREE_UNLIKELY((record->constant_count || record->binding_count) &&
+                      !record->executable_layout)) {
+      return iree_make_status(IREE_STATUS_INVALID_ARGUMENT,
+                              "dispatch record %zu pushes state but has no "
+                              "executable layout",
+                              i);
+    }
+    if (IREE_UNLIKELY(record->constant_count && !record->constants) ||
+        IREE_UNLIKELY(record->binding_count && !record->bindings)) {
+      return iree_make_status(IREE_STATUS_INVALID_ARGUMENT,
+                              "dispatch record %zu has NULL constants or "
+                              "bindings",
+                              i);
+    }
+    IREE_RETURN_IF_ERROR(iree_hal_command_buffer_validate_dispatch_bindings(
+        command_buffer, record->executable, record->entry_point));
+  }
+  return iree_ok_status();
+}
@@ -101,4 +101,8 @@ iree_status_t iree_hal_command_buffer_dispatch_indirect_validation(
     iree_hal_executable_t* executable, int32_t entry_point,
     iree_hal_buffer_t* workgroups_buffer, iree_device_size_t workgroups_offset);
 
+iree_status_t iree_hal_command_buffer_dispatch_batch_validation(
+    iree_hal_command_buffer_t* command_buffer, iree_host_size_t record_count,
+    const iree_hal_dispatch_record_t* records);
+
 #endif  // IREE_HAL_COMMAND_BUFFER_VALIDATION_H_
@@ -7,6 +7,8 @@
 #ifndef IREE_HAL_CTS_COMMAND_BUFFER_DISPATCH_TEST_H_
 #define IREE_HAL_CTS_COMMAND_BUFFER_DISPATCH_TEST_H_
 
+#include <cstring>
+
 #include "iree/base/api.h"
 #include "iree/base/string_view.h"
 #include "iree/hal/api.h"
@@ -18,6 +20,118 @@ namespace iree {
 namespace hal {
 namespace cts {
 
+// Command buffer forwarding to a target command buffer without implementing
+// dispatch_batch so that batches recorded into it take the emulation path
+// regardless of whether the target natively supports them. Only the methods
+// used by the tests are forwarded.
+typedef struct emulated_batch_command_buffer_t {
+  iree_hal_command_buffer_t base;
+  iree_hal_command_buffer_t* target;
+} emulated_batch_command_buffer_t;
+
+static iree_hal_command_buffer_t* emulated_batch_target(
+    iree_hal_command_buffer_t* base_command_buffer) {
+  return ((emulated_batch_command_buffer_t*)base_command_buffer)->target;
+}
+
+static void emulated_batch_destroy(
+    iree_hal_command_buffer_t* base_command_buffer) {
+  emulated_batch_command_buffer_t* command_buffer =
+      (emulated_batch_command_buffer_t*)base_command_buffer;
+  iree_hal_command_buffer_release(command_buffer->target);
+  iree_allocator_free(iree_allocator_system(), command_buffer);
+}
+
+static iree_status_t emulated_batch_begin(
+    iree_hal_command_buffer_t* base_command_buffer) {
+  return iree_hal_command_buffer_begin(
+      emulated_batch_target(base_command_buffer));
+}
+
+static iree_status_t emulated_batch_end(
+    iree_hal_command_buffer_t* base_command_buffer) {
+  return iree_hal_command_buffer_end(
+      emulated_batch_target(base_command_buffer));
+}
+
+static iree_status_t emulated_batch_execution_barrier(
+    iree_hal_command_buffer_t* base_command_buffer,
+    iree_hal_execution_stage_t source_stage_mask,
+    iree_hal_execution_stage_t target_stage_mask,
+    iree_hal_execution_barrier_flags_t flags,
+    iree_host_size_t memory_barrier_count,
+    const iree_hal_memory_barrier_t* memory_barriers,
+    iree_host_size_t buffer_barrier_count,
+    const iree_hal_buffer_barrier_t* buffer_barriers) {
+  return iree_hal_command_buffer_execution_barrier(
+      emulated_batch_target(base_command_buffer), source_stage_mask,
+      target_stage_mask, flags, memory_barrier_count, memory_barriers,
+      buffer_barrier_count, buffer_barriers);
+}
+
+static iree_status_t emulated_batch_push_constants(
+    iree_hal_command_buffer_t* base_command_buffer,
+    iree_hal_executable_layout_t* executable_layout, iree_host_size_t offset,
+    const void* values, iree_host_size_t values_length) {
+  return iree_hal_command_buffer_push_constants(
+      emulated_batch_target(base_command_buffer), executable_layout, offset,
+      values, values_length);
+}
+
+static iree_status_t emulated_batch_push_descriptor_set(
+    iree_hal_command_buffer_t* base_command_buffer,
+    iree_hal_executable_layout_t* executable_layout, uint32_t set,
+    iree_host_size_t binding_count,
+    const iree_hal_descriptor_set_binding_t* bindings) {
+  return iree_hal_command_buffer_push_descriptor_set(
+      emulated_batch_target(base_command_buffer), executable_layout, set,
+      binding_count, bindings);
+}
+
+static iree_status_t emulated_batch_dispatch(
+    iree_hal_command_buffer_t* base_command_buffer,
+    iree_hal_executable_t* executable, int32_t entry_point,
+    uint32_t workgroup_x, uint32_t workgroup_y, uint32_t workgroup_z) {
+  return iree_hal_command_buffer_dispatch(
+      emulated_batch_target(base_command_buffer), executable, entry_point,
+      workgroup_x, workgroup_y, workgroup_z);
+}
+
+static const iree_hal_command_buffer_vtable_t* emulated_batch_vtable() {
+  static iree_hal_command_buffer_vtable_t vtable = [] {
+    iree_hal_command_buffer_vtable_t vtable;
+    memset(&vtable, 0, sizeof(vtable));
+    vtable.destroy = emulated_batch_destroy;
+    vtable.begin = emulated_batch_begin;
+    vtable.end = emulated_batch_end;
+    vtable.execution_barrier = emulated_batch_execution_barrier;
+    vtable.push_constants = emulated_batch_push_constants;
+    vtable.push_descriptor_set = emulated_batch_push_descriptor_set;
+    vtable.dispatch = emulated_batch_dispatch;
+    return vtable;
+  }();
+  return &vtable;
+}
+
+// Wraps |target| (retained) in a command buffer recording batches through the
+// emulation path.
+static iree_status_t emulated_batch_command_buffer_create(
+    iree_hal_device_t* device, iree_hal_command_buffer_t* target,
+    iree_hal_command_buffer_t** out_command_buffer) {
+  emulated_batch_command_buffer_t* command_buffer = NULL;
+  IREE_RETURN_IF_ERROR(iree_allocator_malloc(iree_allocator_system(),
+                                             sizeof(*command_buffer),
+                                             (void**)&command_buffer));
+  iree_hal_command_buffer_initialize(
+      device, iree_hal_command_buffer_mode(target),
+      iree_hal_command_buffer_allowed_categories(target),
+      target->queue_affinity, emulated_batch_vtable(), &command_buffer->base);
+  command_buffer->target = target;
+  iree_hal_command_buffer_retain(target);
+  *out_command_buffer = &command_buffer->base;
+  return iree_ok_status();
+}
+
 class command_buffer_dispatch_test : public CtsTestBase {
  protected:
   void PrepareAbsExecutable() {
@@ -52,6 +166,106 @@ class command_buffer_dispatch_test : public CtsTestBase {
         executable_cache_, &executable_params, &executable_));
   }
 
+  // Records a batch of abs dispatches over separate buffers and checks each
+  // result. When |emulate| is true the batch is recorded through a command
+  // buffer without native batch support.
+  void RunDispatchBatchAbs(bool emulate) {
+    PrepareAbsExecutable();
+
+    iree_hal_command_buffer_t* command_buffer = NULL;
+    IREE_ASSERT_OK(iree_hal_command_buffer_create(
+        device_,
+        IREE_HAL_COMMAND_BUFFER_MODE_ONE_SHOT |
+            IREE_HAL_COMMAND_BUFFER_MODE_ALLOW_INLINE_EXECUTION,
+        IREE_HAL_COMMAND_CATEGORY_DISPATCH, IREE_HAL_QUEUE_AFFINITY_ANY,
+        &command_buffer));
+    iree_hal_command_buffer_t* recording_command_buffer = command_buffer;
+    if (emulate) {
+      IREE_ASSERT_OK(emulated_batch_command_buffer_create(
+          device_, command_buffer, &recording_command_buffer));
+    } else {
+      iree_hal_command_buffer_retain(recording_command_buffer);
+    }
+
+    IREE_ASSERT_OK(iree_hal_command_buffer_begin(recording_command_buffer));
+
+    const float input_data[3] = {-2.5f, 4.0f, -0.5f};
+    const float expected_data[3] = {2.5f, 4.0f, 0.5f};
+    iree_hal_buffer_params_t input_params = {0};
+    input_params.type = IREE_HAL_MEMORY_TYPE_DEVICE_LOCAL;
+    input_params.usage =
+        IREE_HAL_BUFFER_USAGE_DISPATCH | IREE_HAL_BUFFER_USAGE_TRANSFER;
+    iree_hal_buffer_params_t output_params = {0};
+    output_params.type =
+        IREE_HAL_MEMORY_TYPE_DEVICE_LOCAL | IREE_HAL_MEMORY_TYPE_HOST_VISIBLE;
+    output_params.usage = IREE_HAL_BUFFER_USAGE_DISPATCH |
+                          IREE_HAL_BUFFER_USAGE_TRANSFER |
+                          IREE_HAL_BUFFER_USAGE_MAPPING;
+
+    iree_hal_buffer_t* input_buffers[IREE_ARRAYSIZE(input_data)] = {NULL};
+    iree_hal_buffer_t* output_buffers[IREE_ARRAYSIZE(input_data)] = {NULL};
+    iree_hal_descriptor_set_binding_t
+        bindings[IREE_ARRAYSIZE(input_data)][2];
+    iree_hal_dispatch_record_t records[IREE_ARRAYSIZE(input_data)];
+    for (iree_host_size_t i = 0; i < IREE_ARRAYSIZE(input_data); ++i) {
+      IREE_ASSERT_OK(iree_hal_allocator_allocate_buffer(
+          device_allocator_, input_params, sizeof(float),
+          iree_make_const_byte_span(&input_data[i], sizeof(float)),
+          &input_buffers[i]));
+      IREE_ASSERT_OK(iree_hal_allocator_allocate_buffer(
+          device_allocator_, output_params, sizeof(float),
+          iree_const_byte_span_empty(), &output_buffers[i]));
+      bindings[i][0] = {/*binding=*/0, input_buffers[i], /*offset=*/0,
+                        sizeof(float)};
+      bindings[i][1] = {/*binding=*/1, output_buffers[i], /*offset=*/0,
+                        sizeof(float)};
+      memset(&records[i], 0, sizeof(records[i]));
+      records[i].executable = executable_;
+      records[i].entry_point = 0;
+      records[i].workgroup_count[0] = 1;
+      records[i].workgroup_count[1] = 1;
+      records[i].workgroup_count[2] = 1;
+      records[i].executable_layout = executable_layout_;
+      records[i].set = 0;
+      records[i].binding_count = IREE_ARRAYSIZE(bindings[i]);
+      records[i].bindings = bindings[i];
+    }
+
+    IREE_ASSERT_OK(iree_hal_command_buffer_dispatch_batch(
+        recording_command_buffer, IREE_ARRAYSIZE(records), records));
+    IREE_ASSERT_OK(iree_hal_command_buffer_execution_barrier(
+        recording_command_buffer,
+        /*source_stage_mask=*/IREE_HAL_EXECUTION_STAGE_DISPATCH |
+            IREE_HAL_EXECUTION_STAGE_TRANSFER |
+            IREE_HAL_EXECUTION_STAGE_COMMAND_RETIRE,
+        /*target_stage_mask=*/IREE_HAL_EXECUTION_STAGE_COMMAND_ISSUE |
+            IREE_HAL_EXECUTION_STAGE_DISPATCH |
+            IREE_HAL_EXECUTION_STAGE_TRANSFER,
+        IREE_HAL_EXECUTION_BARRIER_FLAG_NONE, /*memory_barrier_count=*/0,
+        /*memory_barriers=*/NULL,
+        /*buffer_barrier_count=*/0, /*buffer_barriers=*/NULL));
+
+    IREE_ASSERT_OK(iree_hal_command_buffer_end(recording_command_buffer));
+
+    IREE_ASSERT_OK(SubmitCommandBufferAndWait(
+        IREE_HAL_COMMAND_CATEGORY_DISPATCH, command_buffer));
+
+    for (iree_host_size_t i = 0; i < IREE_ARRAYSIZE(input_data); ++i) {
+      float output_value = 0.0f;
+      IREE_ASSERT_OK(iree_hal_device_transfer_d2h(
+          device_, output_buffers[i],
+          /*source_offset=*/0, &output_value, sizeof(output_value),
+          IREE_HAL_TRANSFER_BUFFER_FLAG_DEFAULT, iree_infinite_timeout()));
+      EXPECT_EQ(expected_data[i], output_value);
+      iree_hal_buffer_release(output_buffers[i]);
+      iree_hal_buffer_release(input_buffers[i]);
+    }
+
+    iree_hal_command_buffer_release(recording_command_buffer);
+    iree_hal_command_buffer_release(command_buffer);
+    CleanupExecutable();
+  }
+
   void CleanupExecutable() {
     iree_hal_executable_release(executable_);
     iree_hal_executable_layout_release(executable_layout_);
@@ -145,6 +359,18 @@ TEST_P(command_buffer_dispatch_test, DispatchAbs) {
   CleanupExecutable();
 }
 
+// Batches recorded with the native implementation (if any) match the
+// individual dispatches.
+TEST_P(command_buffer_dispatch_test, DispatchBatchAbs) {
+  RunDispatchBatchAbs(/*emulate=*/false);
+}
+
+// Batches recorded through the emulation fallback match the individual
+// dispatches.
+TEST_P(command_buffer_dispatch_test, DispatchBatchAbsEmulated) {
+  RunDispatchBatchAbs(/*emulate=*/true);
+}
+
 }  // namespace cts
 }  // namespace hal
 }  // namespace iree
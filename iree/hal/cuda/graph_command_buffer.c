@@ -440,13 +440,13 @@ static int compare_binding_index(const void* a, const void* b) {
   return buffer_a.binding < buffer_b.binding ? -1 : 1;
 }
 
-static iree_status_t iree_hal_cuda_graph_command_buffer_push_descriptor_set(
-    iree_hal_command_buffer_t* base_command_buffer,
+// Patches the kernel arguments for |set| with |bindings|.
+// The buffers must be retained in the resource set by the caller.
+static void iree_hal_cuda_graph_command_buffer_update_bindings(
+    iree_hal_cuda_graph_command_buffer_t* command_buffer,
     iree_hal_executable_layout_t* executable_layout, uint32_t set,
     iree_host_size_t binding_count,
     const iree_hal_descriptor_set_binding_t* bindings) {
-  iree_hal_cuda_graph_command_buffer_t* command_buffer =
-      iree_hal_cuda_graph_command_buffer_cast(base_command_buffer);
   iree_host_size_t base_binding =
       iree_hal_cuda_base_binding_index(executable_layout, set);
   // Convention with the compiler side. We map bindings to kernel argument.
@@ -472,9 +472,22 @@ static iree_status_t iree_hal_cuda_graph_command_buffer_push_descriptor_set(
         iree_hal_buffer_byte_offset(binding->buffer) + binding->offset;
     *((CUdeviceptr*)command_buffer->current_descriptor[i + base_binding]) =
         device_ptr;
+  }
+}
+
+static iree_status_t iree_hal_cuda_graph_command_buffer_push_descriptor_set(
+    iree_hal_command_buffer_t* base_command_buffer,
+    iree_hal_executable_layout_t* executable_layout, uint32_t set,
+    iree_host_size_t binding_count,
+    const iree_hal_descriptor_set_binding_t* bindings) {
+  iree_hal_cuda_graph_command_buffer_t* command_buffer =
+      iree_hal_cuda_graph_command_buffer_cast(base_command_buffer);
+  for (iree_host_size_t i = 0; i < binding_count; i++) {
     IREE_RETURN_IF_ERROR(iree_hal_resource_set_insert(
-        command_buffer->resource_set, 1, &binding->buffer));
+        command_buffer->resource_set, 1, &bindings[i].buffer));
   }
+  iree_hal_cuda_graph_command_buffer_update_bindings(
+      command_buffer, executable_layout, set, binding_count, bindings);
   return iree_ok_status();
 }
 
@@ -488,14 +501,12 @@ static iree_status_t iree_hal_cuda_graph_command_buffer_bind_descriptor_set(
                           "need cuda implementation");
 }
 
-static iree_status_t iree_hal_cuda_graph_command_buffer_dispatch(
-    iree_hal_command_buffer_t* base_command_buffer,
+// Adds a kernel node for |executable| |entry_point| using the current kernel
+// arguments. The executable must be retained in the resource set by the caller.
+static iree_status_t iree_hal_cuda_graph_command_buffer_add_kernel_node(
+    iree_hal_cuda_graph_command_buffer_t* command_buffer,
     iree_hal_executable_t* executable, int32_t entry_point,
     uint32_t workgroup_x, uint32_t workgroup_y, uint32_t workgroup_z) {
-  iree_hal_cuda_graph_command_buffer_t* command_buffer =
-      iree_hal_cuda_graph_command_buffer_cast(base_command_buffer);
-  IREE_RETURN_IF_ERROR(iree_hal_resource_set_insert(
-      command_buffer->resource_set, 1, &executable));
   iree_hal_executable_layout_t* layout =
       iree_hal_cuda_executable_get_layout(executable, entry_point);
   iree_host_size_t num_constants =
@@ -536,6 +547,19 @@ static iree_status_t iree_hal_cuda_graph_command_buffer_dispatch(
   return iree_ok_status();
 }
 
+static iree_status_t iree_hal_cuda_graph_command_buffer_dispatch(
+    iree_hal_command_buffer_t* base_command_buffer,
+    iree_hal_executable_t* executable, int32_t entry_point,
+    uint32_t workgroup_x, uint32_t workgroup_y, uint32_t workgroup_z) {
+  iree_hal_cuda_graph_command_buffer_t* command_buffer =
+      iree_hal_cuda_graph_command_buffer_cast(base_command_buffer);
+  IREE_RETURN_IF_ERROR(iree_hal_resource_set_insert(
+      command_buffer->resource_set, 1, &executable));
+  return iree_hal_cuda_graph_command_buffer_add_kernel_node(
+      command_buffer, executable, entry_point, workgroup_x, workgroup_y,
+      workgroup_z);
+}
+
 static iree_status_t iree_hal_cuda_graph_command_buffer_dispatch_indirect(
     iree_hal_command_buffer_t* base_command_buffer,
     iree_hal_executable_t* executable, int32_t entry_point,
@@ -545,6 +569,70 @@ static iree_status_t iree_hal_cuda_graph_command_buffer_dispatch_indirect(
                           "need cuda implementation");
 }
 
+// Capacity of the scratch list used to batch resource set insertions. Must be
+// able to hold an executable and a full descriptor set of bindings.
+#define IREE_HAL_CUDA_DISPATCH_BATCH_RESOURCE_CAPACITY \
+  (1 + IREE_HAL_CUDA_MAX_BINDING_COUNT)
+
+// Adds a kernel node per record. Resources are inserted into the resource set
+// in chunks instead of one at a time.
+static iree_status_t iree_hal_cuda_graph_command_buffer_dispatch_batch(
+    iree_hal_command_buffer_t* base_command_buffer,
+    iree_host_size_t record_count, const iree_hal_dispatch_record_t* records) {
+  iree_hal_cuda_graph_command_buffer_t* command_buffer =
+      iree_hal_cuda_graph_command_buffer_cast(base_command_buffer);
+
+  const void* resources[IREE_HAL_CUDA_DISPATCH_BATCH_RESOURCE_CAPACITY];
+  iree_host_size_t resource_count = 0;
+
+  iree_status_t status = iree_ok_status();
+  for (iree_host_size_t i = 0; i < record_count; ++i) {
+    const iree_hal_dispatch_record_t* record = &records[i];
+    if (IREE_UNLIKELY(record->constant_count >
+                      IREE_ARRAYSIZE(command_buffer->push_constant)) ||
+        IREE_UNLIKELY(record->binding_count >=
+                      IREE_HAL_CUDA_MAX_BINDING_COUNT)) {
+      status = iree_make_status(IREE_STATUS_INVALID_ARGUMENT,
+                                "dispatch record %zu has too many push "
+                                "constants (%zu) or bindings (%zu)",
+                                i, record->constant_count,
+                                record->binding_count);
+      break;
+    }
+
+    if (resource_count + 1 + record->binding_count >
+        IREE_ARRAYSIZE(resources)) {
+      status = iree_hal_resource_set_insert(command_buffer->resource_set,
+                                            resource_count, resources);
+      resource_count = 0;
+      if (!iree_status_is_ok(status)) break;
+    }
+    resources[resource_count++] = record->executable;
+    for (iree_host_size_t j = 0; j < record->binding_count; ++j) {
+      resources[resource_count++] = record->bindings[j].buffer;
+    }
+
+    memcpy(command_buffer->push_constant, record->constants,
+           record->constant_count * sizeof(uint32_t));
+    if (record->binding_count > 0) {
+      iree_hal_cuda_graph_command_buffer_update_bindings(
+          command_buffer, record->executable_layout, record->set,
+          record->binding_count, record->bindings);
+    }
+    status = iree_hal_cuda_graph_command_buffer_add_kernel_node(
+        command_buffer, record->executable, record->entry_point,
+        record->workgroup_count[0], record->workgroup_count[1],
+        record->workgroup_count[2]);
+    if (!iree_status_is_ok(status)) break;
+  }
+
+  if (iree_status_is_ok(status) && resource_count > 0) {
+    status = iree_hal_resource_set_insert(command_buffer->resource_set,
+                                          resource_count, resources);
+  }
+  return status;
+}
+
 CUgraphExec iree_hal_cuda_graph_command_buffer_exec(
     iree_hal_command_buffer_t* base_command_buffer) {
   iree_hal_cuda_graph_command_buffer_t* command_buffer =
@@ -580,4 +668,5 @@ static const iree_hal_command_buffer_vtable_t
         .dispatch = iree_hal_cuda_graph_command_buffer_dispatch,
         .dispatch_indirect =
             iree_hal_cuda_graph_command_buffer_dispatch_indirect,
+        .dispatch_batch = iree_hal_cuda_graph_command_buffer_dispatch_batch,
 };
@@ -385,6 +385,39 @@ static iree_status_t iree_hal_cuda_stream_command_buffer_dispatch_indirect(
                           "need cuda implementation of dispatch indirect");
 }
 
+// Records each dispatch directly against the stream. Kernel arguments are
+// patched in place and launched one record at a time, avoiding the per-call
+// validation and vtable overhead of the individual commands.
+static iree_status_t iree_hal_cuda_stream_command_buffer_dispatch_batch(
+    iree_hal_command_buffer_t* base_command_buffer,
+    iree_host_size_t record_count, const iree_hal_dispatch_record_t* records) {
+  iree_hal_cuda_stream_command_buffer_t* command_buffer =
+      iree_hal_cuda_stream_command_buffer_cast(base_command_buffer);
+  for (iree_host_size_t i = 0; i < record_count; ++i) {
+    const iree_hal_dispatch_record_t* record = &records[i];
+    if (IREE_UNLIKELY(record->constant_count >
+                      IREE_ARRAYSIZE(command_buffer->push_constant))) {
+      return iree_make_status(IREE_STATUS_INVALID_ARGUMENT,
+                              "dispatch record %zu has too many push "
+                              "constants (%zu)",
+                              i, record->constant_count);
+    }
+    memcpy(command_buffer->push_constant, record->constants,
+           record->constant_count * sizeof(uint32_t));
+    if (record->binding_count > 0) {
+      IREE_RETURN_IF_ERROR(
+          iree_hal_cuda_stream_command_buffer_push_descriptor_set(
+              base_command_buffer, record->executable_layout, record->set,
+              record->binding_count, record->bindings));
+    }
+    IREE_RETURN_IF_ERROR(iree_hal_cuda_stream_command_buffer_dispatch(
+        base_command_buffer, record->executable, record->entry_point,
+        record->workgroup_count[0], record->workgroup_count[1],
+        record->workgroup_count[2]));
+  }
+  return iree_ok_status();
+}
+
 static const iree_hal_command_buffer_vtable_t
     iree_hal_cuda_stream_command_buffer_vtable = {
         .destroy = iree_hal_cuda_stream_command_buffer_destroy,
@@ -408,4 +441,5 @@ static const iree_hal_command_buffer_vtable_t
         .dispatch = iree_hal_cuda_stream_command_buffer_dispatch,
         .dispatch_indirect =
             iree_hal_cuda_stream_command_buffer_dispatch_indirect,
+        .dispatch_batch = iree_hal_cuda_stream_command_buffer_dispatch_batch,
 };
@@ -12,8 +12,10 @@
 #include "iree/base/api.h"
 #include "iree/base/internal/flags.h"
 #include "iree/hal/local/executable_loader.h"
+#include "iree/hal/local/large_page_allocator.h"
 #include "iree/hal/local/loaders/embedded_library_loader.h"
 #include "iree/hal/local/loaders/system_library_loader.h"
+#include "iree/hal/local/microkernels/microkernels.h"
 #include "iree/hal/local/task_device.h"
 #include "iree/hal/local/task_driver.h"
 #include "iree/task/api.h"
@@ -27,6 +29,20 @@
 
 #define IREE_HAL_DYLIB_DRIVER_ID 0x58444C4Cu  // XDLL
 
+IREE_FLAG(string, dylib_large_pages, "none",
+          "Backs device buffers of at least one large page (usually 2MB) with "
+          "large pages to reduce TLB misses on large models: `none`, "
+          "`transparent` (madvise(MADV_HUGEPAGE)), or `hugetlb` (MAP_HUGETLB "
+          "with fallback to transparent huge pages). Linux/Android only.");
+
+IREE_FLAG(bool, dylib_share_executables, false,
+          "Shares loaded embedded ELF executables process-wide between all "
+          "devices loading identical executable data.");
+
+IREE_FLAG(bool, dylib_dispatch_statistics, false,
+          "Collects per-export dispatch statistics (invocation count, wall "
+          "time, and workgroups stolen from other workers) on the device.");
+
 static iree_status_t iree_hal_dylib_driver_factory_enumerate(
     void* self, const iree_hal_driver_info_t** out_driver_infos,
     iree_host_size_t* out_driver_info_count) {
@@ -55,6 +71,7 @@ static iree_status_t iree_hal_dylib_driver_factory_try_create(
 
   iree_hal_task_device_params_t default_params;
   iree_hal_task_device_params_initialize(&default_params);
+  default_params.dispatch_statistics = FLAG_dylib_dispatch_statistics;
 
   iree_status_t status = iree_ok_status();
 
@@ -62,12 +79,15 @@ static iree_status_t iree_hal_dylib_driver_factory_try_create(
   iree_host_size_t loader_count = 0;
   if (iree_status_is_ok(status)) {
     status = iree_hal_embedded_library_loader_create(
-        iree_hal_executable_import_provider_null(), host_allocator,
+        FLAG_dylib_share_executables
+            ? IREE_HAL_EMBEDDED_LIBRARY_LOADER_FLAG_SHARE_IMAGES
+            : IREE_HAL_EMBEDDED_LIBRARY_LOADER_FLAG_NONE,
+        iree_microkernel_import_provider(), host_allocator,
         &loaders[loader_count++]);
   }
   if (iree_status_is_ok(status)) {
     status = iree_hal_system_library_loader_create(
-        iree_hal_executable_import_provider_null(), host_allocator,
+        iree_microkernel_import_provider(), host_allocator,
         &loaders[loader_count++]);
   }
 
@@ -76,11 +96,18 @@ static iree_status_t iree_hal_dylib_driver_factory_try_create(
     status = iree_task_executor_create_from_flags(host_allocator, &executor);
   }
 
+  iree_hal_large_page_mode_t large_page_mode = IREE_HAL_LARGE_PAGE_MODE_NONE;
+  if (iree_status_is_ok(status)) {
+    status = iree_hal_large_page_mode_parse(
+        iree_make_cstring_view(FLAG_dylib_large_pages), &large_page_mode);
+  }
+
   iree_hal_allocator_t* device_allocator = NULL;
   if (iree_status_is_ok(status)) {
-    status = iree_hal_allocator_create_heap(iree_make_cstring_view("cpu"),
-                                            host_allocator, host_allocator,
-                                            &device_allocator);
+    status = iree_hal_allocator_create_heap(
+        iree_make_cstring_view("cpu"),
+        iree_hal_large_page_allocator(large_page_mode), host_allocator,
+        &device_allocator);
   }
 
   if (iree_status_is_ok(status)) {
@@ -12,6 +12,7 @@
 #include "iree/base/api.h"
 #include "iree/hal/local/executable_loader.h"
 #include "iree/hal/local/loaders/embedded_library_loader.h"
+#include "iree/hal/local/microkernels/microkernels.h"
 #include "iree/hal/local/sync_device.h"
 #include "iree/hal/local/sync_driver.h"
 
@@ -53,8 +54,8 @@ static iree_status_t iree_hal_dylib_sync_driver_factory_try_create(
   iree_hal_executable_loader_t* loaders[1] = {NULL};
   if (iree_status_is_ok(status)) {
     status = iree_hal_embedded_library_loader_create(
-        iree_hal_executable_import_provider_null(), host_allocator,
-        &loaders[0]);
+        IREE_HAL_EMBEDDED_LIBRARY_LOADER_FLAG_NONE,
+        iree_microkernel_import_provider(), host_allocator, &loaders[0]);
   }
 
   iree_hal_allocator_t* device_allocator = NULL;
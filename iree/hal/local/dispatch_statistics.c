@@ -0,0 +1,189 @@
+// Copyright 2022 The IREE Authors
+//
+// Licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+#include "iree/hal/local/dispatch_statistics.h"
+
+#include <inttypes.h>
+#include <string.h>
+
+#include "iree/base/internal/synchronization.h"
+#include "iree/base/tracing.h"
+
+struct iree_hal_dispatch_statistics_table_t {
+  iree_allocator_t host_allocator;
+
+  // Guards all fields below. Lookups happen while recording command buffers
+  // and records when dispatches retire; neither is frequent enough to warrant
+  // anything fancier.
+  iree_slim_mutex_t mutex;
+
+  // Dense list of entries in insertion order. Entry names are owned by the
+  // table and allocated separately such that they remain valid as the list
+  // grows.
+  iree_host_size_t entry_capacity;
+  iree_host_size_t entry_count;
+  iree_hal_dispatch_statistics_t* entries;
+};
+
+iree_status_t iree_hal_dispatch_statistics_table_create(
+    iree_allocator_t host_allocator,
+    iree_hal_dispatch_statistics_table_t** out_table) {
+  IREE_ASSERT_ARGUMENT(out_table);
+  *out_table = NULL;
+  IREE_TRACE_ZONE_BEGIN(z0);
+
+  iree_hal_dispatch_statistics_table_t* table = NULL;
+  iree_status_t status =
+      iree_allocator_malloc(host_allocator, sizeof(*table), (void**)&table);
+  if (iree_status_is_ok(status)) {
+    memset(table, 0, sizeof(*table));
+    table->host_allocator = host_allocator;
+    iree_slim_mutex_initialize(&table->mutex);
+    *out_table = table;
+  }
+
+  IREE_TRACE_ZONE_END(z0);
+  return status;
+}
+
+void iree_hal_dispatch_statistics_table_free(
+    iree_hal_dispatch_statistics_table_t* table) {
+  if (!table) return;
+  IREE_TRACE_ZONE_BEGIN(z0);
+  iree_allocator_t host_allocator = table->host_allocator;
+  for (iree_host_size_t i = 0; i < table->entry_count; ++i) {
+    iree_allocator_free(host_allocator,
+                        (void*)table->entries[i].export_name.data);
+  }
+  iree_allocator_free(host_allocator, table->entries);
+  iree_slim_mutex_deinitialize(&table->mutex);
+  iree_allocator_free(host_allocator, table);
+  IREE_TRACE_ZONE_END(z0);
+}
+
+// Appends a new zeroed entry for |export_name| to |table|.
+// Must be called with the table mutex held.
+static iree_status_t iree_hal_dispatch_statistics_table_append(
+    iree_hal_dispatch_statistics_table_t* table, iree_string_view_t export_name,
+    iree_host_size_t* out_index) {
+  if (table->entry_count == table->entry_capacity) {
+    iree_host_size_t new_capacity = iree_max(16, table->entry_capacity * 2);
+    IREE_RETURN_IF_ERROR(iree_allocator_realloc(
+        table->host_allocator, new_capacity * sizeof(table->entries[0]),
+        (void**)&table->entries));
+    table->entry_capacity = new_capacity;
+  }
+
+  char* name_storage = NULL;
+  IREE_RETURN_IF_ERROR(iree_allocator_malloc(
+      table->host_allocator, export_name.size + 1, (void**)&name_storage));
+  memcpy(name_storage, export_name.data, export_name.size);
+  name_storage[export_name.size] = 0;
+
+  iree_hal_dispatch_statistics_t* entry = &table->entries[table->entry_count];
+  memset(entry, 0, sizeof(*entry));
+  entry->export_name = iree_make_string_view(name_storage, export_name.size);
+  entry->min_wall_time_ns = INT64_MAX;
+  *out_index = table->entry_count++;
+  return iree_ok_status();
+}
+
+iree_status_t iree_hal_dispatch_statistics_table_lookup(
+    iree_hal_dispatch_statistics_table_t* table, iree_string_view_t export_name,
+    iree_host_size_t* out_index) {
+  IREE_ASSERT_ARGUMENT(table);
+  IREE_ASSERT_ARGUMENT(out_index);
+  *out_index = 0;
+  iree_slim_mutex_lock(&table->mutex);
+  iree_status_t status = iree_ok_status();
+  bool found = false;
+  for (iree_host_size_t i = 0; i < table->entry_count; ++i) {
+    if (iree_string_view_equal(table->entries[i].export_name, export_name)) {
+      *out_index = i;
+      found = true;
+      break;
+    }
+  }
+  if (!found) {
+    status =
+        iree_hal_dispatch_statistics_table_append(table, export_name, out_index);
+  }
+  iree_slim_mutex_unlock(&table->mutex);
+  return status;
+}
+
+void iree_hal_dispatch_statistics_table_record(
+    iree_hal_dispatch_statistics_table_t* table, iree_host_size_t index,
+    int64_t wall_time_ns, uint64_t tile_count, uint64_t stolen_tile_count) {
+  IREE_ASSERT_ARGUMENT(table);
+  iree_slim_mutex_lock(&table->mutex);
+  IREE_ASSERT_LT(index, table->entry_count);
+  iree_hal_dispatch_statistics_t* entry = &table->entries[index];
+  ++entry->invocation_count;
+  entry->total_wall_time_ns += wall_time_ns;
+  entry->min_wall_time_ns = iree_min(entry->min_wall_time_ns, wall_time_ns);
+  entry->max_wall_time_ns = iree_max(entry->max_wall_time_ns, wall_time_ns);
+  entry->tile_count += tile_count;
+  entry->stolen_tile_count += stolen_tile_count;
+  iree_slim_mutex_unlock(&table->mutex);
+}
+
+iree_status_t iree_hal_dispatch_statistics_table_query(
+    iree_hal_dispatch_statistics_table_t* table, iree_host_size_t capacity,
+    iree_hal_dispatch_statistics_t* out_statistics,
+    iree_host_size_t* out_count) {
+  IREE_ASSERT_ARGUMENT(table);
+  IREE_ASSERT_ARGUMENT(!capacity || out_statistics);
+  IREE_ASSERT_ARGUMENT(out_count);
+  iree_slim_mutex_lock(&table->mutex);
+  iree_host_size_t entry_count = table->entry_count;
+  *out_count = entry_count;
+  iree_status_t status = iree_ok_status();
+  if (capacity < entry_count) {
+    // NOTE: a capacity of 0 is a valid way to query the count and not an error
+    // worth annotating.
+    status = iree_status_from_code(IREE_STATUS_OUT_OF_RANGE);
+  } else {
+    for (iree_host_size_t i = 0; i < entry_count; ++i) {
+      out_statistics[i] = table->entries[i];
+      if (!out_statistics[i].invocation_count) {
+        out_statistics[i].min_wall_time_ns = 0;
+      }
+    }
+  }
+  iree_slim_mutex_unlock(&table->mutex);
+  return status;
+}
+
+iree_status_t iree_hal_dispatch_statistics_table_fprint(
+    FILE* file, iree_hal_dispatch_statistics_table_t* table) {
+  IREE_ASSERT_ARGUMENT(file);
+  IREE_ASSERT_ARGUMENT(table);
+  iree_slim_mutex_lock(&table->mutex);
+  fprintf(file,
+          "[[ iree_hal_dispatch_statistics ]]\n"
+          "%-48s %10s %12s %12s %12s %12s %12s\n",
+          "export", "count", "total(us)", "avg(us)", "min(us)", "max(us)",
+          "stolen(%)");
+  for (iree_host_size_t i = 0; i < table->entry_count; ++i) {
+    const iree_hal_dispatch_statistics_t* entry = &table->entries[i];
+    if (!entry->invocation_count) continue;
+    double stolen_percent =
+        entry->tile_count ? 100.0 * (double)entry->stolen_tile_count /
+                                (double)entry->tile_count
+                          : 0.0;
+    fprintf(file,
+            "%-48.*s %10" PRIu64 " %12.1f %12.1f %12.1f %12.1f %12.1f\n",
+            (int)entry->export_name.size, entry->export_name.data,
+            entry->invocation_count, entry->total_wall_time_ns / 1000.0,
+            entry->total_wall_time_ns / 1000.0 /
+                (double)entry->invocation_count,
+            entry->min_wall_time_ns / 1000.0, entry->max_wall_time_ns / 1000.0,
+            stolen_percent);
+  }
+  iree_slim_mutex_unlock(&table->mutex);
+  return iree_ok_status();
+}
@@ -0,0 +1,82 @@
+// Copyright 2022 The IREE Authors
+//
+// Licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+#ifndef IREE_HAL_LOCAL_DISPATCH_STATISTICS_H_
+#define IREE_HAL_LOCAL_DISPATCH_STATISTICS_H_
+
+#include <stdint.h>
+#include <stdio.h>
+
+#include "iree/base/api.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif  // __cplusplus
+
+// Aggregate statistics of all dispatches of a single executable export.
+typedef struct iree_hal_dispatch_statistics_t {
+  // Name of the executable export as declared in the executable library.
+  // Exports of libraries compiled without reflection names are reported as
+  // `<ordinal>` and merged across executables.
+  iree_string_view_t export_name;
+  // Total number of times the export was dispatched.
+  uint64_t invocation_count;
+  // Wall time from dispatch issue to completion, in nanoseconds.
+  int64_t total_wall_time_ns;
+  int64_t min_wall_time_ns;
+  int64_t max_wall_time_ns;
+  // Total number of workgroups executed across all invocations.
+  uint64_t tile_count;
+  // Total number of workgroups executed by a worker in excess of an even
+  // split of the grid; see iree_task_dispatch_statistics_t.
+  uint64_t stolen_tile_count;
+} iree_hal_dispatch_statistics_t;
+
+// A thread-safe table of dispatch statistics keyed by export name.
+// Entries are never removed and their indices are stable for the lifetime of
+// the table such that recorders can resolve them once up-front and then
+// record with just the index.
+typedef struct iree_hal_dispatch_statistics_table_t
+    iree_hal_dispatch_statistics_table_t;
+
+// Creates an empty statistics table.
+iree_status_t iree_hal_dispatch_statistics_table_create(
+    iree_allocator_t host_allocator,
+    iree_hal_dispatch_statistics_table_t** out_table);
+
+// Frees |table| and all entry names.
+void iree_hal_dispatch_statistics_table_free(
+    iree_hal_dispatch_statistics_table_t* table);
+
+// Returns the index of the entry for |export_name| in |out_index|, inserting
+// an empty entry if this is the first time the name has been seen.
+iree_status_t iree_hal_dispatch_statistics_table_lookup(
+    iree_hal_dispatch_statistics_table_t* table, iree_string_view_t export_name,
+    iree_host_size_t* out_index);
+
+// Records one invocation of the export at |index|.
+void iree_hal_dispatch_statistics_table_record(
+    iree_hal_dispatch_statistics_table_t* table, iree_host_size_t index,
+    int64_t wall_time_ns, uint64_t tile_count, uint64_t stolen_tile_count);
+
+// Copies up to |capacity| entries into |out_statistics| and returns the total
+// number of entries in |out_count|. Names reference storage owned by the table.
+// Returns IREE_STATUS_OUT_OF_RANGE if |capacity| is too small; callers can pass
+// 0 to query the required capacity.
+iree_status_t iree_hal_dispatch_statistics_table_query(
+    iree_hal_dispatch_statistics_table_t* table, iree_host_size_t capacity,
+    iree_hal_dispatch_statistics_t* out_statistics,
+    iree_host_size_t* out_count);
+
+// Prints all entries of |table| with at least one invocation to |file|.
+iree_status_t iree_hal_dispatch_statistics_table_fprint(
+    FILE* file, iree_hal_dispatch_statistics_table_t* table);
+
+#ifdef __cplusplus
+}  // extern "C"
+#endif  // __cplusplus
+
+#endif  // IREE_HAL_LOCAL_DISPATCH_STATISTICS_H_
@@ -0,0 +1,115 @@
+// Copyright 2022 The IREE Authors
+//
+// Licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+#include "iree/hal/local/dispatch_statistics.h"
+
+#include <cstdint>
+#include <string>
+
+#include "iree/base/api.h"
+#include "iree/testing/gtest.h"
+#include "iree/testing/status_matchers.h"
+
+namespace {
+
+using iree::testing::status::StatusIs;
+
+class DispatchStatisticsTest : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    IREE_ASSERT_OK(iree_hal_dispatch_statistics_table_create(
+        iree_allocator_system(), &table_));
+  }
+  void TearDown() override { iree_hal_dispatch_statistics_table_free(table_); }
+
+  iree_hal_dispatch_statistics_table_t* table_ = NULL;
+};
+
+TEST_F(DispatchStatisticsTest, Empty) {
+  iree_host_size_t count = 1;
+  IREE_EXPECT_OK(
+      iree_hal_dispatch_statistics_table_query(table_, 0, NULL, &count));
+  EXPECT_EQ(count, 0);
+}
+
+// Lookups of the same name resolve to the same entry even when the name
+// storage differs.
+TEST_F(DispatchStatisticsTest, LookupDedupes) {
+  iree_host_size_t index_a = 0, index_b = 0, index_a2 = 0;
+  IREE_ASSERT_OK(iree_hal_dispatch_statistics_table_lookup(
+      table_, IREE_SV("matmul_dispatch_0"), &index_a));
+  IREE_ASSERT_OK(iree_hal_dispatch_statistics_table_lookup(
+      table_, IREE_SV("conv_dispatch_1"), &index_b));
+  std::string name_copy = "matmul_dispatch_0";
+  IREE_ASSERT_OK(iree_hal_dispatch_statistics_table_lookup(
+      table_, iree_make_string_view(name_copy.data(), name_copy.size()),
+      &index_a2));
+  EXPECT_NE(index_a, index_b);
+  EXPECT_EQ(index_a, index_a2);
+
+  iree_host_size_t count = 0;
+  EXPECT_THAT(iree::Status(iree_hal_dispatch_statistics_table_query(
+                  table_, 0, NULL, &count)),
+              StatusIs(iree::StatusCode::kOutOfRange));
+  EXPECT_EQ(count, 2);
+}
+
+// Entries remain valid as the table grows.
+TEST_F(DispatchStatisticsTest, Grow) {
+  for (int i = 0; i < 100; ++i) {
+    std::string name = "dispatch_" + std::to_string(i);
+    iree_host_size_t index = 0;
+    IREE_ASSERT_OK(iree_hal_dispatch_statistics_table_lookup(
+        table_, iree_make_string_view(name.data(), name.size()), &index));
+    EXPECT_EQ(index, i);
+    iree_hal_dispatch_statistics_table_record(table_, index, i, i, 0);
+  }
+  iree_hal_dispatch_statistics_t statistics[100];
+  iree_host_size_t count = 0;
+  IREE_ASSERT_OK(iree_hal_dispatch_statistics_table_query(
+      table_, IREE_ARRAYSIZE(statistics), statistics, &count));
+  ASSERT_EQ(count, 100);
+  for (int i = 0; i < 100; ++i) {
+    std::string name = "dispatch_" + std::to_string(i);
+    EXPECT_TRUE(iree_string_view_equal(
+        statistics[i].export_name,
+        iree_make_string_view(name.data(), name.size())));
+    EXPECT_EQ(statistics[i].invocation_count, 1);
+    EXPECT_EQ(statistics[i].tile_count, i);
+  }
+}
+
+TEST_F(DispatchStatisticsTest, Record) {
+  iree_host_size_t index = 0, unused_index = 0;
+  IREE_ASSERT_OK(iree_hal_dispatch_statistics_table_lookup(
+      table_, IREE_SV("matmul_dispatch_0"), &index));
+  IREE_ASSERT_OK(iree_hal_dispatch_statistics_table_lookup(
+      table_, IREE_SV("unused_dispatch_1"), &unused_index));
+  iree_hal_dispatch_statistics_table_record(table_, index, 300, 64, 4);
+  iree_hal_dispatch_statistics_table_record(table_, index, 100, 64, 0);
+  iree_hal_dispatch_statistics_table_record(table_, index, 200, 64, 2);
+
+  iree_hal_dispatch_statistics_t statistics[2];
+  iree_host_size_t count = 0;
+  IREE_ASSERT_OK(iree_hal_dispatch_statistics_table_query(
+      table_, IREE_ARRAYSIZE(statistics), statistics, &count));
+  ASSERT_EQ(count, 2);
+
+  const iree_hal_dispatch_statistics_t& used = statistics[index];
+  EXPECT_EQ(used.invocation_count, 3);
+  EXPECT_EQ(used.total_wall_time_ns, 600);
+  EXPECT_EQ(used.min_wall_time_ns, 100);
+  EXPECT_EQ(used.max_wall_time_ns, 300);
+  EXPECT_EQ(used.tile_count, 192);
+  EXPECT_EQ(used.stolen_tile_count, 6);
+
+  const iree_hal_dispatch_statistics_t& unused = statistics[unused_index];
+  EXPECT_EQ(unused.invocation_count, 0);
+  EXPECT_EQ(unused.min_wall_time_ns, 0);
+  EXPECT_EQ(unused.max_wall_time_ns, 0);
+}
+
+}  // namespace
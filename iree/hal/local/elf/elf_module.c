@@ -9,6 +9,8 @@
 #include <inttypes.h>
 #include <string.h>
 
+#include "iree/base/internal/call_once.h"
+#include "iree/base/internal/synchronization.h"
 #include "iree/base/target_platform.h"
 #include "iree/base/tracing.h"
 #include "iree/hal/local/elf/arch.h"
@@ -230,6 +232,18 @@ static iree_byte_range_t iree_elf_module_calculate_vaddr_range(
   return byte_range;
 }
 
+// Returns true if |phdr| is an executable segment large enough to cover at
+// least one large page. Large executables (such as big models with many
+// dispatches) have their code backed by large pages to reduce iTLB misses while
+// small ones don't waste memory rounding up.
+static bool iree_elf_module_phdr_wants_large_pages(
+    iree_elf_module_load_state_t* load_state, const iree_elf_phdr_t* phdr) {
+  const iree_memory_info_t* memory_info = &load_state->memory_info;
+  return memory_info->large_page_granularity > memory_info->normal_page_size &&
+         phdr->p_type == IREE_ELF_PT_LOAD && (phdr->p_flags & IREE_ELF_PF_X) &&
+         phdr->p_memsz >= memory_info->large_page_granularity;
+}
+
 // Allocates space for and loads all DT_LOAD segments into the host virtual
 // address space.
 static iree_status_t iree_elf_module_load_segments(
@@ -239,13 +253,23 @@ static iree_status_t iree_elf_module_load_segments(
   iree_byte_range_t vaddr_range =
       iree_elf_module_calculate_vaddr_range(load_state);
 
+  // Align the reservation for large pages if any segment will use them.
+  iree_memory_view_flags_t view_flags = IREE_MEMORY_VIEW_FLAG_MAY_EXECUTE;
+  for (iree_elf_half_t i = 0; i < load_state->ehdr->e_phnum; ++i) {
+    if (iree_elf_module_phdr_wants_large_pages(load_state,
+                                               &load_state->phdr_table[i])) {
+      view_flags |= IREE_MEMORY_VIEW_FLAG_LARGE_PAGES;
+      break;
+    }
+  }
+
   // Reserve virtual address space in the host memory space. This memory is
   // uncommitted by default as the ELF may only sparsely use the address space.
   module->vaddr_size = iree_page_align_end(
       vaddr_range.length, load_state->memory_info.normal_page_size);
   IREE_RETURN_IF_ERROR(iree_memory_view_reserve(
-      IREE_MEMORY_VIEW_FLAG_MAY_EXECUTE, module->vaddr_size,
-      module->host_allocator, (void**)&module->vaddr_base));
+      view_flags, module->vaddr_size, module->host_allocator,
+      (void**)&module->vaddr_base));
   module->vaddr_bias = module->vaddr_base - vaddr_range.offset;
 
   // Commit and load all of the segments.
@@ -263,6 +287,12 @@ static iree_status_t iree_elf_module_load_segments(
         module->vaddr_bias, 1, &byte_range,
         IREE_MEMORY_ACCESS_READ | IREE_MEMORY_ACCESS_WRITE));
 
+    // Hint before the pages are first touched by the copy below so that they
+    // can be faulted in as large pages directly.
+    if (iree_elf_module_phdr_wants_large_pages(load_state, phdr)) {
+      iree_memory_view_advise_large_pages(module->vaddr_bias, 1, &byte_range);
+    }
+
     // Copy data present in the file.
     // TODO(benvanik): infra for being able to detect if the source model is in
     // a mapped file - if it is, we can remap the page and directly reference it
@@ -569,6 +599,9 @@ static const iree_elf_sym_t* iree_elf_module_lookup_global_symbol(
 // API
 //==============================================================================
 
+static void iree_elf_module_release_shared_image(
+    iree_elf_module_image_t* image);
+
 iree_status_t iree_elf_module_initialize_from_memory(
     iree_const_byte_span_t raw_data,
     const iree_elf_import_table_t* import_table,
@@ -633,8 +666,13 @@ iree_status_t iree_elf_module_initialize_from_memory(
 void iree_elf_module_deinitialize(iree_elf_module_t* module) {
   IREE_TRACE_ZONE_BEGIN(z0);
 
-  iree_elf_module_run_finalizers(module);
-  iree_elf_module_unload_segments(module);
+  if (module->shared_image) {
+    // The image owns the loaded pages and unloads them when unreferenced.
+    iree_elf_module_release_shared_image(module->shared_image);
+  } else {
+    iree_elf_module_run_finalizers(module);
+    iree_elf_module_unload_segments(module);
+  }
   memset(module, 0, sizeof(*module));
 
   IREE_TRACE_ZONE_END(z0);
@@ -658,3 +696,163 @@ iree_status_t iree_elf_module_lookup_export(iree_elf_module_t* module,
   *out_export = module->vaddr_bias + sym->st_value;
   return iree_ok_status();
 }
+
+//==============================================================================
+// Shared images
+//==============================================================================
+
+// A loaded ELF image referenced by one or more modules.
+struct iree_elf_module_image_t {
+  // Next image in the cache list.
+  iree_elf_module_image_t* next;
+  // Number of modules referencing the image. Guarded by the cache mutex.
+  iree_host_size_t ref_count;
+
+  // Key the image was loaded with. |data| is a copy of the source ELF retained
+  // so that hash matches can be verified and |data_ptr| is the address the
+  // source was loaded from (which may no longer be valid and is only compared).
+  const void* data_ptr;
+  uint64_t data_hash;
+  iree_const_byte_span_t data;
+  const iree_elf_import_table_t* import_table;
+
+  // Module owning the loaded pages.
+  iree_elf_module_t module;
+};
+
+// Process-wide list of loaded shared images.
+// There are generally only a handful of unique executables in a process so a
+// list is fine; if there were many we could key a hash table off data_hash.
+typedef struct iree_elf_module_image_cache_t {
+  iree_slim_mutex_t mutex;
+  // Singly-linked list of images. Guarded by |mutex|.
+  iree_elf_module_image_t* head;
+} iree_elf_module_image_cache_t;
+
+static iree_elf_module_image_cache_t iree_elf_module_image_cache_;
+static iree_once_flag iree_elf_module_image_cache_flag_ = IREE_ONCE_FLAG_INIT;
+static void iree_elf_module_image_cache_initialize(void) {
+  memset(&iree_elf_module_image_cache_, 0,
+         sizeof(iree_elf_module_image_cache_));
+  iree_slim_mutex_initialize(&iree_elf_module_image_cache_.mutex);
+}
+
+static iree_elf_module_image_cache_t* iree_elf_module_image_cache(void) {
+  iree_call_once(&iree_elf_module_image_cache_flag_,
+                 iree_elf_module_image_cache_initialize);
+  return &iree_elf_module_image_cache_;
+}
+
+// Returns the 64-bit FNV-1a hash of |data|.
+// Only used to quickly reject mismatches; matches are verified by comparing the
+// full contents.
+static uint64_t iree_elf_module_hash_data(iree_const_byte_span_t data) {
+  uint64_t hash = 0xCBF29CE484222325ull;
+  for (iree_host_size_t i = 0; i < data.data_length; ++i) {
+    hash ^= data.data[i];
+    hash *= 0x100000001B3ull;
+  }
+  return hash;
+}
+
+iree_status_t iree_elf_module_initialize_shared_from_memory(
+    iree_const_byte_span_t raw_data,
+    const iree_elf_import_table_t* import_table,
+    iree_allocator_t host_allocator, iree_elf_module_t* out_module) {
+  IREE_ASSERT_ARGUMENT(raw_data.data);
+  IREE_ASSERT_ARGUMENT(out_module);
+  IREE_TRACE_ZONE_BEGIN(z0);
+  memset(out_module, 0, sizeof(*out_module));
+
+  iree_elf_module_image_cache_t* cache = iree_elf_module_image_cache();
+
+  // NOTE: we hold the lock while loading so that concurrent loads of the same
+  // data don't both load the image. Loads are rare and usually happen during
+  // startup so the contention doesn't matter.
+  iree_slim_mutex_lock(&cache->mutex);
+
+  // Find an image loaded from identical data. Reloading from the same pointer
+  // is the common case and only requires a compare against the retained copy;
+  // otherwise we hash the data once to reject mismatches before comparing.
+  bool has_data_hash = false;
+  uint64_t data_hash = 0;
+  iree_elf_module_image_t* image = cache->head;
+  for (; image; image = image->next) {
+    if (image->data.data_length != raw_data.data_length ||
+        image->import_table != import_table) {
+      continue;
+    }
+    if (image->data_ptr != raw_data.data) {
+      if (!has_data_hash) {
+        data_hash = iree_elf_module_hash_data(raw_data);
+        has_data_hash = true;
+      }
+      if (image->data_hash != data_hash) continue;
+    }
+    if (memcmp(image->data.data, raw_data.data, raw_data.data_length) == 0) {
+      break;
+    }
+  }
+
+  iree_status_t status = iree_ok_status();
+  if (image) {
+    IREE_TRACE_ZONE_APPEND_TEXT(z0, "hit");
+  } else {
+    // Images outlive whichever module caused them to be loaded and are
+    // allocated from the system allocator. The source data is retained in the
+    // same allocation.
+    iree_allocator_t image_allocator = iree_allocator_system();
+    status = iree_allocator_malloc(image_allocator,
+                                   sizeof(*image) + raw_data.data_length,
+                                   (void**)&image);
+    if (iree_status_is_ok(status)) {
+      status = iree_elf_module_initialize_from_memory(
+          raw_data, import_table, image_allocator, &image->module);
+      if (!iree_status_is_ok(status)) {
+        iree_allocator_free(image_allocator, image);
+        image = NULL;
+      }
+    }
+    if (iree_status_is_ok(status)) {
+      uint8_t* data = (uint8_t*)image + sizeof(*image);
+      memcpy(data, raw_data.data, raw_data.data_length);
+      image->data_ptr = raw_data.data;
+      image->data_hash =
+          has_data_hash ? data_hash : iree_elf_module_hash_data(raw_data);
+      image->data = iree_make_const_byte_span(data, raw_data.data_length);
+      image->import_table = import_table;
+      image->next = cache->head;
+      cache->head = image;
+    }
+  }
+
+  if (iree_status_is_ok(status)) {
+    ++image->ref_count;
+    *out_module = image->module;
+    out_module->host_allocator = host_allocator;
+    out_module->shared_image = image;
+  }
+
+  iree_slim_mutex_unlock(&cache->mutex);
+  IREE_TRACE_ZONE_END(z0);
+  return status;
+}
+
+// Drops a reference to |image| and unloads it if it was the last one.
+static void iree_elf_module_release_shared_image(
+    iree_elf_module_image_t* image) {
+  iree_elf_module_image_cache_t* cache = iree_elf_module_image_cache();
+  iree_slim_mutex_lock(&cache->mutex);
+  if (--image->ref_count > 0) {
+    iree_slim_mutex_unlock(&cache->mutex);
+    return;
+  }
+  iree_elf_module_image_t** prev_next = &cache->head;
+  while (*prev_next != image) prev_next = &(*prev_next)->next;
+  *prev_next = image->next;
+  iree_slim_mutex_unlock(&cache->mutex);
+
+  iree_allocator_t image_allocator = image->module.host_allocator;
+  iree_elf_module_deinitialize(&image->module);
+  iree_allocator_free(image_allocator, image);
+}
@@ -34,6 +34,9 @@ typedef struct iree_elf_import_table_t {
 // Runtime ELF module loader/linker
 //==============================================================================
 
+// Loaded ELF image shared across modules initialized from identical data.
+typedef struct iree_elf_module_image_t iree_elf_module_image_t;
+
 // An ELF module mapped directly from memory.
 typedef struct iree_elf_module_t {
   // Allocator used for additional dynamic memory when needed.
@@ -56,6 +59,11 @@ typedef struct iree_elf_module_t {
   // Dynamic symbol table (.dynsym).
   const iree_elf_sym_t* dynsym;   // DT_SYMTAB
   iree_host_size_t dynsym_count;  // DT_SYMENT (bytes) / sizeof(iree_elf_sym_t)
+
+  // Process-wide image the module references if it was initialized with
+  // iree_elf_module_initialize_shared_from_memory. NULL if the module owns its
+  // loaded pages.
+  iree_elf_module_image_t* shared_image;
 } iree_elf_module_t;
 
 // Initializes an ELF module from the ELF |raw_data| in memory.
@@ -77,10 +85,30 @@ iree_status_t iree_elf_module_initialize_from_memory(
     const iree_elf_import_table_t* import_table,
     iree_allocator_t host_allocator, iree_elf_module_t* out_module);
 
+// Initializes an ELF module from the ELF |raw_data| in memory like
+// iree_elf_module_initialize_from_memory but shares the loaded image with all
+// other modules in the process initialized with this function from identical
+// |raw_data| and |import_table|. Only the first module to be initialized pays
+// the cost of loading, relocating, and running initializers and all share the
+// same code and data pages. The image is unloaded when the last module
+// referencing it is deinitialized.
+//
+// Modules sharing an image also share any writable data within it and callers
+// must only use this for ELFs that do not rely on per-load mutable state (such
+// as IREE HAL executables). Identical data is detected by comparing |raw_data|
+// against a copy retained by the shared image.
+iree_status_t iree_elf_module_initialize_shared_from_memory(
+    iree_const_byte_span_t raw_data,
+    const iree_elf_import_table_t* import_table,
+    iree_allocator_t host_allocator, iree_elf_module_t* out_module);
+
 // Deinitializes a |module|, releasing any allocated executable or data pages.
 // Invalidates all symbol pointers previous retrieved from the module and any
 // pointer to data that may have been in the module text or rwdata.
 //
+// If the module references a shared image the pages are only released once
+// no other modules reference it.
+//
 // NOTE: .fini finalizers will not be executed.
 void iree_elf_module_deinitialize(iree_elf_module_t* module);
 
@@ -51,23 +51,15 @@ static iree_status_t query_arch_test_file_data(
                           "the application for the current target platform");
 }
 
-static iree_status_t run_test() {
-  iree_const_byte_span_t file_data;
-  IREE_RETURN_IF_ERROR(query_arch_test_file_data(&file_data));
-
-  iree_elf_import_table_t import_table;
-  memset(&import_table, 0, sizeof(import_table));
-  iree_elf_module_t module;
-  IREE_RETURN_IF_ERROR(iree_elf_module_initialize_from_memory(
-      file_data, &import_table, iree_allocator_system(), &module));
-
+// Queries the library from |module| and runs its dispatch function.
+static iree_status_t run_module(iree_elf_module_t* module) {
   iree_hal_executable_environment_v0_t environment;
   iree_hal_executable_environment_initialize(iree_allocator_system(),
                                              &environment);
 
   void* query_fn_ptr = NULL;
   IREE_RETURN_IF_ERROR(iree_elf_module_lookup_export(
-      &module, IREE_HAL_EXECUTABLE_LIBRARY_EXPORT_NAME, &query_fn_ptr));
+      module, IREE_HAL_EXECUTABLE_LIBRARY_EXPORT_NAME, &query_fn_ptr));
 
   union {
     const iree_hal_executable_library_header_t** header;
@@ -148,13 +140,130 @@ static iree_status_t run_test() {
       break;
     }
   }
+  return status;
+}
+
+static iree_status_t run_test() {
+  iree_const_byte_span_t file_data;
+  IREE_RETURN_IF_ERROR(query_arch_test_file_data(&file_data));
+
+  iree_elf_import_table_t import_table;
+  memset(&import_table, 0, sizeof(import_table));
+  iree_elf_module_t module;
+  IREE_RETURN_IF_ERROR(iree_elf_module_initialize_from_memory(
+      file_data, &import_table, iree_allocator_system(), &module));
+
+  iree_status_t status = run_module(&module);
 
   iree_elf_module_deinitialize(&module);
   return status;
 }
 
+static iree_status_t run_shared_test() {
+  iree_const_byte_span_t file_data;
+  IREE_RETURN_IF_ERROR(query_arch_test_file_data(&file_data));
+
+  // Load the same data twice; both modules should reference the same pages.
+  iree_elf_import_table_t import_table;
+  memset(&import_table, 0, sizeof(import_table));
+  iree_elf_module_t module_a;
+  IREE_RETURN_IF_ERROR(iree_elf_module_initialize_shared_from_memory(
+      file_data, &import_table, iree_allocator_system(), &module_a));
+  iree_elf_module_t module_b;
+  iree_status_t status = iree_elf_module_initialize_shared_from_memory(
+      file_data, &import_table, iree_allocator_system(), &module_b);
+  if (!iree_status_is_ok(status)) {
+    iree_elf_module_deinitialize(&module_a);
+    return status;
+  }
+  if (module_a.vaddr_base != module_b.vaddr_base) {
+    status = iree_make_status(IREE_STATUS_INTERNAL,
+                              "shared modules did not share an image");
+  }
+
+  // The image must remain loaded while any module references it.
+  iree_elf_module_deinitialize(&module_a);
+  if (iree_status_is_ok(status)) {
+    status = run_module(&module_b);
+  }
+  iree_elf_module_deinitialize(&module_b);
+  return status;
+}
+
+// Loads |file_data| shared from copies at two different addresses: one with
+// identical contents and one of the same length with a single byte changed.
+static iree_status_t run_shared_distinct_test_with_copies(
+    iree_const_byte_span_t file_data, uint8_t* same_data,
+    uint8_t* different_data) {
+  memcpy(same_data, file_data.data, file_data.data_length);
+  memcpy(different_data, file_data.data, file_data.data_length);
+  // The e_ident padding is ignored by the loader and changing it still yields
+  // a valid ELF.
+  different_data[IREE_ELF_EI_PAD] ^= 0xFF;
+
+  iree_elf_import_table_t import_table;
+  memset(&import_table, 0, sizeof(import_table));
+  iree_elf_module_t module_a;
+  IREE_RETURN_IF_ERROR(iree_elf_module_initialize_shared_from_memory(
+      file_data, &import_table, iree_allocator_system(), &module_a));
+  iree_elf_module_t module_b;
+  iree_status_t status = iree_elf_module_initialize_shared_from_memory(
+      iree_make_const_byte_span(same_data, file_data.data_length),
+      &import_table, iree_allocator_system(), &module_b);
+  if (!iree_status_is_ok(status)) {
+    iree_elf_module_deinitialize(&module_a);
+    return status;
+  }
+  iree_elf_module_t module_c;
+  status = iree_elf_module_initialize_shared_from_memory(
+      iree_make_const_byte_span(different_data, file_data.data_length),
+      &import_table, iree_allocator_system(), &module_c);
+  if (!iree_status_is_ok(status)) {
+    iree_elf_module_deinitialize(&module_b);
+    iree_elf_module_deinitialize(&module_a);
+    return status;
+  }
+
+  if (module_a.vaddr_base != module_b.vaddr_base) {
+    status = iree_make_status(IREE_STATUS_INTERNAL,
+                              "identical data at a different address did not "
+                              "share an image");
+  } else if (module_a.vaddr_base == module_c.vaddr_base) {
+    status = iree_make_status(IREE_STATUS_INTERNAL,
+                              "different data of the same length shared an "
+                              "image");
+  }
+  if (iree_status_is_ok(status)) {
+    status = run_module(&module_c);
+  }
+
+  iree_elf_module_deinitialize(&module_c);
+  iree_elf_module_deinitialize(&module_b);
+  iree_elf_module_deinitialize(&module_a);
+  return status;
+}
+
+static iree_status_t run_shared_distinct_test() {
+  iree_const_byte_span_t file_data;
+  IREE_RETURN_IF_ERROR(query_arch_test_file_data(&file_data));
+
+  uint8_t* data = NULL;
+  IREE_RETURN_IF_ERROR(iree_allocator_malloc(
+      iree_allocator_system(), file_data.data_length * 2, (void**)&data));
+  iree_status_t status = run_shared_distinct_test_with_copies(
+      file_data, data, data + file_data.data_length);
+  iree_allocator_free(iree_allocator_system(), data);
+  return status;
+}
+
 int main() {
-  const iree_status_t result = run_test();
+  iree_status_t result = run_test();
+  if (iree_status_is_ok(result)) {
+    result = run_shared_test();
+  }
+  if (iree_status_is_ok(result)) {
+    result = run_shared_distinct_test();
+  }
   int ret = (int)iree_status_code(result);
   if (!iree_status_is_ok(result)) {
     iree_status_fprint(stderr, result);
@@ -169,6 +169,12 @@ iree_status_t iree_memory_view_protect_ranges(void* base_address,
   return status;
 }
 
+void iree_memory_view_advise_large_pages(void* base_address,
+                                         iree_host_size_t range_count,
+                                         const iree_byte_range_t* ranges) {
+  // No-op.
+}
+
 void sys_icache_invalidate(void* start, size_t len);
 
 void iree_memory_view_flush_icache(void* base_address,
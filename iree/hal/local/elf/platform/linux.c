@@ -4,6 +4,7 @@
 // See https://llvm.org/LICENSE.txt for license information.
 // SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
 
+#include "iree/base/internal/huge_pages.h"
 #include "iree/base/target_platform.h"
 #include "iree/base/tracing.h"
 #include "iree/hal/local/elf/platform.h"
@@ -25,14 +26,12 @@ void iree_memory_query_info(iree_memory_info_t* out_info) {
   out_info->normal_page_size = page_size;
   out_info->normal_page_granularity = page_size;
 
-  // Large pages arent't currently used so we aren't introducing the build goo
-  // to detect and use them yet.
-  // https://linux.die.net/man/3/gethugepagesizes
-  // http://manpages.ubuntu.com/manpages/bionic/man3/gethugepagesize.3.html
-  // Would be:
-  //   #include <hugetlbfs.h>
-  //   out_info->large_page_granularity = gethugepagesize();
-  out_info->large_page_granularity = page_size;
+  // Large pages are transparent huge pages (THP) of the PMD size (2MB on most
+  // configurations). If THP is unavailable we report the normal page size.
+  // https://www.kernel.org/doc/html/latest/admin-guide/mm/transhuge.html
+  iree_host_size_t huge_page_size = iree_huge_page_size();
+  out_info->large_page_granularity =
+      huge_page_size ? huge_page_size : (iree_host_size_t)page_size;
 
   out_info->can_allocate_executable_pages = true;
 }
@@ -60,12 +59,24 @@ iree_status_t iree_memory_view_reserve(iree_memory_view_flags_t flags,
   *out_base_address = NULL;
   IREE_TRACE_ZONE_BEGIN(z0);
 
-  int mmap_prot = PROT_NONE;
-  int mmap_flags = MAP_PRIVATE | MAP_ANON | MAP_NORESERVE;
+  // Large page reservations are aligned so that ranges within them can be
+  // backed by large pages with iree_memory_view_advise_large_pages.
+  iree_host_size_t alignment = 0;
+  if (flags & IREE_MEMORY_VIEW_FLAG_LARGE_PAGES) {
+    alignment = iree_huge_page_size();
+  }
 
   iree_status_t status = iree_ok_status();
-  void* base_address = mmap(NULL, total_length, mmap_prot, mmap_flags, -1, 0);
-  if (base_address == MAP_FAILED) {
+  void* base_address = NULL;
+  if (alignment) {
+    base_address = iree_huge_page_map(total_length, alignment,
+                                      IREE_HUGE_PAGE_MAP_FLAG_RESERVE_ONLY);
+  } else {
+    base_address = mmap(NULL, total_length, PROT_NONE,
+                        MAP_PRIVATE | MAP_ANON | MAP_NORESERVE, -1, 0);
+    if (base_address == MAP_FAILED) base_address = NULL;
+  }
+  if (!base_address) {
     status = iree_make_status(iree_status_code_from_errno(errno),
                               "mmap reservation failed");
   }
@@ -138,6 +149,20 @@ iree_status_t iree_memory_view_protect_ranges(void* base_address,
   return status;
 }
 
+void iree_memory_view_advise_large_pages(void* base_address,
+                                         iree_host_size_t range_count,
+                                         const iree_byte_range_t* ranges) {
+  IREE_TRACE_ZONE_BEGIN(z0);
+  for (iree_host_size_t i = 0; i < range_count; ++i) {
+    void* range_start = NULL;
+    iree_host_size_t aligned_length = 0;
+    iree_page_align_range(base_address, ranges[i], getpagesize(), &range_start,
+                          &aligned_length);
+    iree_huge_page_advise(range_start, aligned_length);
+  }
+  IREE_TRACE_ZONE_END(z0);
+}
+
 // IREE_ELF_CLEAR_CACHE can be defined externally to override this default
 // behavior.
 #if !defined(IREE_ELF_CLEAR_CACHE)
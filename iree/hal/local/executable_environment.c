@@ -12,15 +12,211 @@
 // iree_hal_processor_*_t
 //===----------------------------------------------------------------------===//
 
+#if defined(IREE_ARCH_X86_64)
+
+#if defined(IREE_COMPILER_MSVC)
+#include <intrin.h>
+#else
+#include <cpuid.h>
+#endif  // IREE_COMPILER_MSVC
+
+// Executes cpuid with the given |leaf| and |subleaf| and stores the resulting
+// eax, ebx, ecx, and edx registers in |out_regs|. Unsupported leaves produce 0.
+static void iree_hal_processor_cpuid(uint32_t leaf, uint32_t subleaf,
+                                     uint32_t out_regs[4]) {
+#if defined(IREE_COMPILER_MSVC)
+  int regs[4] = {0, 0, 0, 0};
+  __cpuidex(regs, (int)leaf, (int)subleaf);
+  for (int i = 0; i < 4; ++i) out_regs[i] = (uint32_t)regs[i];
+#else
+  unsigned int eax = 0, ebx = 0, ecx = 0, edx = 0;
+  if (!__get_cpuid_count(leaf, subleaf, &eax, &ebx, &ecx, &edx)) {
+    eax = ebx = ecx = edx = 0;
+  }
+  out_regs[0] = eax;
+  out_regs[1] = ebx;
+  out_regs[2] = ecx;
+  out_regs[3] = edx;
+#endif  // IREE_COMPILER_MSVC
+}
+
+// Returns the XCR0 register indicating which register state the OS preserves.
+// Must only be called when cpuid reports OSXSAVE.
+static uint64_t iree_hal_processor_xgetbv0(void) {
+#if defined(IREE_COMPILER_MSVC)
+  return _xgetbv(0);
+#else
+  uint32_t eax = 0, edx = 0;
+  __asm__ volatile("xgetbv" : "=a"(eax), "=d"(edx) : "c"(0));
+  return ((uint64_t)edx << 32) | eax;
+#endif  // IREE_COMPILER_MSVC
+}
+
+#define IREE_CPUID_BIT(reg, bit) (((reg) >> (bit)) & 1u)
+
+static void iree_hal_processor_query_arch(
+    iree_hal_processor_v0_t* out_processor) {
+  uint32_t leaf0[4];
+  iree_hal_processor_cpuid(0, 0, leaf0);
+  const uint32_t max_leaf = leaf0[0];
+  if (max_leaf < 1) return;
+
+  uint32_t leaf1[4];
+  iree_hal_processor_cpuid(1, 0, leaf1);
+  const uint32_t leaf1_ecx = leaf1[2];
+
+  // AVX and AVX-512 register state must be enabled by the OS in XCR0:
+  // bit 1 = SSE, bit 2 = AVX (YMM), bits 5-7 = AVX-512 (opmask/ZMM).
+  bool os_avx = false;
+  bool os_avx512 = false;
+  if (IREE_CPUID_BIT(leaf1_ecx, 27)) {  // OSXSAVE
+    const uint64_t xcr0 = iree_hal_processor_xgetbv0();
+    os_avx = (xcr0 & 0x06) == 0x06;
+    os_avx512 = os_avx && (xcr0 & 0xE0) == 0xE0;
+  }
+  if (!os_avx) return;
+
+  uint64_t data0 = 0;
+  if (IREE_CPUID_BIT(leaf1_ecx, 28)) {
+    data0 |= IREE_HAL_PROCESSOR_DATA0_X86_64_AVX;
+  }
+  if (IREE_CPUID_BIT(leaf1_ecx, 12)) {
+    data0 |= IREE_HAL_PROCESSOR_DATA0_X86_64_FMA;
+  }
+  if (IREE_CPUID_BIT(leaf1_ecx, 29)) {
+    data0 |= IREE_HAL_PROCESSOR_DATA0_X86_64_F16C;
+  }
+
+  if (max_leaf >= 7) {
+    uint32_t leaf7[4];
+    iree_hal_processor_cpuid(7, 0, leaf7);
+    const uint32_t leaf7_ebx = leaf7[1];
+    const uint32_t leaf7_ecx = leaf7[2];
+    if (IREE_CPUID_BIT(leaf7_ebx, 5)) {
+      data0 |= IREE_HAL_PROCESSOR_DATA0_X86_64_AVX2;
+    }
+    if (os_avx512 && IREE_CPUID_BIT(leaf7_ebx, 16)) {
+      data0 |= IREE_HAL_PROCESSOR_DATA0_X86_64_AVX512F;
+      if (IREE_CPUID_BIT(leaf7_ebx, 28)) {
+        data0 |= IREE_HAL_PROCESSOR_DATA0_X86_64_AVX512CD;
+      }
+      if (IREE_CPUID_BIT(leaf7_ebx, 31)) {
+        data0 |= IREE_HAL_PROCESSOR_DATA0_X86_64_AVX512VL;
+      }
+      if (IREE_CPUID_BIT(leaf7_ebx, 17)) {
+        data0 |= IREE_HAL_PROCESSOR_DATA0_X86_64_AVX512DQ;
+      }
+      if (IREE_CPUID_BIT(leaf7_ebx, 30)) {
+        data0 |= IREE_HAL_PROCESSOR_DATA0_X86_64_AVX512BW;
+      }
+      if (IREE_CPUID_BIT(leaf7_ecx, 11)) {
+        data0 |= IREE_HAL_PROCESSOR_DATA0_X86_64_AVX512VNNI;
+      }
+    }
+    if (leaf7[0] >= 1) {
+      uint32_t leaf7_1[4];
+      iree_hal_processor_cpuid(7, 1, leaf7_1);
+      const uint32_t leaf7_1_eax = leaf7_1[0];
+      if (IREE_CPUID_BIT(leaf7_1_eax, 4)) {
+        data0 |= IREE_HAL_PROCESSOR_DATA0_X86_64_AVXVNNI;
+      }
+      if ((data0 & IREE_HAL_PROCESSOR_DATA0_X86_64_AVX512F) &&
+          IREE_CPUID_BIT(leaf7_1_eax, 5)) {
+        data0 |= IREE_HAL_PROCESSOR_DATA0_X86_64_AVX512BF16;
+      }
+    }
+  }
+
+  out_processor->data[0] = data0;
+}
+
+#elif defined(IREE_ARCH_ARM_64) && \
+    (defined(IREE_PLATFORM_ANDROID) || defined(IREE_PLATFORM_LINUX))
+
+#include <sys/auxv.h>
+
+// Values from the kernel's arch/arm64/include/uapi/asm/hwcap.h; older libc
+// headers may not define them all.
+#define IREE_HWCAP_ASIMDHP (1ul << 10)
+#define IREE_HWCAP_ASIMDDP (1ul << 20)
+#define IREE_HWCAP_SVE (1ul << 22)
+#define IREE_HWCAP2_SVE2 (1ul << 1)
+#define IREE_HWCAP2_I8MM (1ul << 13)
+#define IREE_HWCAP2_BF16 (1ul << 14)
+
+static void iree_hal_processor_query_arch(
+    iree_hal_processor_v0_t* out_processor) {
+  const unsigned long hwcap = getauxval(AT_HWCAP);
+  const unsigned long hwcap2 = getauxval(AT_HWCAP2);
+  uint64_t data0 = 0;
+  if (hwcap & IREE_HWCAP_ASIMDHP) {
+    data0 |= IREE_HAL_PROCESSOR_DATA0_ARM_64_FP16;
+  }
+  if (hwcap & IREE_HWCAP_ASIMDDP) {
+    data0 |= IREE_HAL_PROCESSOR_DATA0_ARM_64_DOTPROD;
+  }
+  if (hwcap & IREE_HWCAP_SVE) {
+    data0 |= IREE_HAL_PROCESSOR_DATA0_ARM_64_SVE;
+  }
+  if (hwcap2 & IREE_HWCAP2_SVE2) {
+    data0 |= IREE_HAL_PROCESSOR_DATA0_ARM_64_SVE2;
+  }
+  if (hwcap2 & IREE_HWCAP2_I8MM) {
+    data0 |= IREE_HAL_PROCESSOR_DATA0_ARM_64_I8MM;
+  }
+  if (hwcap2 & IREE_HWCAP2_BF16) {
+    data0 |= IREE_HAL_PROCESSOR_DATA0_ARM_64_BF16;
+  }
+  out_processor->data[0] = data0;
+}
+
+#elif defined(IREE_ARCH_ARM_64) && defined(IREE_PLATFORM_APPLE)
+
+#include <sys/sysctl.h>
+
+// Returns true if the hw.optional.* sysctl |name| exists and is non-zero.
+static bool iree_hal_processor_sysctl_flag(const char* name) {
+  int value = 0;
+  size_t value_size = sizeof(value);
+  if (sysctlbyname(name, &value, &value_size, NULL, 0) != 0) return false;
+  return value != 0;
+}
+
+static void iree_hal_processor_query_arch(
+    iree_hal_processor_v0_t* out_processor) {
+  uint64_t data0 = 0;
+  if (iree_hal_processor_sysctl_flag("hw.optional.arm.FEAT_FP16")) {
+    data0 |= IREE_HAL_PROCESSOR_DATA0_ARM_64_FP16;
+  }
+  if (iree_hal_processor_sysctl_flag("hw.optional.arm.FEAT_DotProd")) {
+    data0 |= IREE_HAL_PROCESSOR_DATA0_ARM_64_DOTPROD;
+  }
+  if (iree_hal_processor_sysctl_flag("hw.optional.arm.FEAT_I8MM")) {
+    data0 |= IREE_HAL_PROCESSOR_DATA0_ARM_64_I8MM;
+  }
+  if (iree_hal_processor_sysctl_flag("hw.optional.arm.FEAT_BF16")) {
+    data0 |= IREE_HAL_PROCESSOR_DATA0_ARM_64_BF16;
+  }
+  out_processor->data[0] = data0;
+}
+
+#else
+
+// No query available; executables will only use their baseline versions.
+static void iree_hal_processor_query_arch(
+    iree_hal_processor_v0_t* out_processor) {}
+
+#endif  // IREE_ARCH_*
+
 void iree_hal_processor_query(iree_allocator_t temp_allocator,
                               iree_hal_processor_v0_t* out_processor) {
   IREE_ASSERT_ARGUMENT(out_processor);
   IREE_TRACE_ZONE_BEGIN(z0);
   memset(out_processor, 0, sizeof(*out_processor));
 
-  // TODO(benvanik): define processor features we want to query for each arch.
-  // This needs to be baked into the executable library API and made consistent
-  // with the compiler side producing the executables that access it.
+  // NOTE: the bit layout of the data fields is defined in executable_library.h
+  // and must match what the compiler emits checks against.
+  iree_hal_processor_query_arch(out_processor);
 
   IREE_TRACE_ZONE_END(z0);
 }
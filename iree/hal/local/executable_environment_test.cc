@@ -0,0 +1,83 @@
+// Copyright 2022 The IREE Authors
+//
+// Licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+#include "iree/hal/local/executable_environment.h"
+
+#include "iree/base/api.h"
+#include "iree/testing/gtest.h"
+
+namespace {
+
+TEST(ExecutableEnvironmentTest, QueryIsStable) {
+  iree_hal_processor_v0_t processor_a;
+  iree_hal_processor_query(iree_allocator_system(), &processor_a);
+  iree_hal_processor_v0_t processor_b;
+  iree_hal_processor_query(iree_allocator_system(), &processor_b);
+  for (int i = 0; i < IREE_HAL_PROCESSOR_DATA_CAPACITY_V0; ++i) {
+    EXPECT_EQ(processor_a.data[i], processor_b.data[i]);
+  }
+  // Only data[0] is defined today; the rest must be zero.
+  for (int i = 1; i < IREE_HAL_PROCESSOR_DATA_CAPACITY_V0; ++i) {
+    EXPECT_EQ(processor_a.data[i], 0);
+  }
+}
+
+TEST(ExecutableEnvironmentTest, InitializePopulatesProcessor) {
+  iree_hal_processor_v0_t processor;
+  iree_hal_processor_query(iree_allocator_system(), &processor);
+  iree_hal_executable_environment_v0_t environment;
+  iree_hal_executable_environment_initialize(iree_allocator_system(),
+                                             &environment);
+  EXPECT_EQ(environment.processor.data[0], processor.data[0]);
+  EXPECT_EQ(environment.constants, nullptr);
+  EXPECT_EQ(environment.imports, nullptr);
+}
+
+#if defined(IREE_ARCH_X86_64) && defined(IREE_COMPILER_GCC_COMPAT)
+
+// Cross-checks our cpuid/xgetbv decoding against the compiler runtime.
+TEST(ExecutableEnvironmentTest, MatchesCompilerX86_64) {
+  __builtin_cpu_init();
+  iree_hal_processor_v0_t processor;
+  iree_hal_processor_query(iree_allocator_system(), &processor);
+  const uint64_t data0 = processor.data[0];
+  EXPECT_EQ((data0 & IREE_HAL_PROCESSOR_DATA0_X86_64_AVX) != 0,
+            __builtin_cpu_supports("avx") != 0);
+  EXPECT_EQ((data0 & IREE_HAL_PROCESSOR_DATA0_X86_64_AVX2) != 0,
+            __builtin_cpu_supports("avx2") != 0);
+  EXPECT_EQ((data0 & IREE_HAL_PROCESSOR_DATA0_X86_64_FMA) != 0,
+            __builtin_cpu_supports("fma") != 0);
+  EXPECT_EQ((data0 & IREE_HAL_PROCESSOR_DATA0_X86_64_AVX512F) != 0,
+            __builtin_cpu_supports("avx512f") != 0);
+  EXPECT_EQ((data0 & IREE_HAL_PROCESSOR_DATA0_X86_64_AVX512BW) != 0,
+            __builtin_cpu_supports("avx512bw") != 0);
+  EXPECT_EQ((data0 & IREE_HAL_PROCESSOR_DATA0_X86_64_AVX512VNNI) != 0,
+            __builtin_cpu_supports("avx512vnni") != 0);
+}
+
+// AVX-512 subsets are only reported alongside the foundation instructions.
+TEST(ExecutableEnvironmentTest, ImpliedFeaturesX86_64) {
+  iree_hal_processor_v0_t processor;
+  iree_hal_processor_query(iree_allocator_system(), &processor);
+  const uint64_t data0 = processor.data[0];
+  const uint64_t avx512_subsets =
+      IREE_HAL_PROCESSOR_DATA0_X86_64_AVX512CD |
+      IREE_HAL_PROCESSOR_DATA0_X86_64_AVX512VL |
+      IREE_HAL_PROCESSOR_DATA0_X86_64_AVX512DQ |
+      IREE_HAL_PROCESSOR_DATA0_X86_64_AVX512BW |
+      IREE_HAL_PROCESSOR_DATA0_X86_64_AVX512VNNI |
+      IREE_HAL_PROCESSOR_DATA0_X86_64_AVX512BF16;
+  if (!(data0 & IREE_HAL_PROCESSOR_DATA0_X86_64_AVX512F)) {
+    EXPECT_EQ(data0 & avx512_subsets, 0);
+  }
+  if (data0 & IREE_HAL_PROCESSOR_DATA0_X86_64_AVX2) {
+    EXPECT_TRUE(data0 & IREE_HAL_PROCESSOR_DATA0_X86_64_AVX);
+  }
+}
+
+#endif  // IREE_ARCH_X86_64 && IREE_COMPILER_GCC_COMPAT
+
+}  // namespace
@@ -234,6 +234,37 @@ typedef struct iree_hal_processor_v0_t {
 static_assert(sizeof(iree_hal_processor_v0_t) % sizeof(uint64_t) == 0,
               "8-byte alignment required");
 
+// ISA feature bits stored in iree_hal_processor_v0_t::data[0].
+// A bit is only set when both the processor and the operating system support
+// the feature (for example AVX-512 also requires the OS to preserve the ZMM
+// register state across context switches). Executables may use these to select
+// between multiple versions of their exports at load time.
+//
+// NOTE: these values are part of the executable ABI and must only be appended
+// to; the compiler mirrors them in LibraryBuilder.h.
+
+// x86_64 data[0] bits:
+#define IREE_HAL_PROCESSOR_DATA0_X86_64_AVX (1ull << 0)
+#define IREE_HAL_PROCESSOR_DATA0_X86_64_AVX2 (1ull << 1)
+#define IREE_HAL_PROCESSOR_DATA0_X86_64_FMA (1ull << 2)
+#define IREE_HAL_PROCESSOR_DATA0_X86_64_F16C (1ull << 3)
+#define IREE_HAL_PROCESSOR_DATA0_X86_64_AVX512F (1ull << 4)
+#define IREE_HAL_PROCESSOR_DATA0_X86_64_AVX512CD (1ull << 5)
+#define IREE_HAL_PROCESSOR_DATA0_X86_64_AVX512VL (1ull << 6)
+#define IREE_HAL_PROCESSOR_DATA0_X86_64_AVX512DQ (1ull << 7)
+#define IREE_HAL_PROCESSOR_DATA0_X86_64_AVX512BW (1ull << 8)
+#define IREE_HAL_PROCESSOR_DATA0_X86_64_AVX512VNNI (1ull << 9)
+#define IREE_HAL_PROCESSOR_DATA0_X86_64_AVX512BF16 (1ull << 10)
+#define IREE_HAL_PROCESSOR_DATA0_X86_64_AVXVNNI (1ull << 11)
+
+// arm_64 data[0] bits:
+#define IREE_HAL_PROCESSOR_DATA0_ARM_64_FP16 (1ull << 0)
+#define IREE_HAL_PROCESSOR_DATA0_ARM_64_DOTPROD (1ull << 1)
+#define IREE_HAL_PROCESSOR_DATA0_ARM_64_I8MM (1ull << 2)
+#define IREE_HAL_PROCESSOR_DATA0_ARM_64_BF16 (1ull << 3)
+#define IREE_HAL_PROCESSOR_DATA0_ARM_64_SVE (1ull << 4)
+#define IREE_HAL_PROCESSOR_DATA0_ARM_64_SVE2 (1ull << 5)
+
 // Defines the environment in which the executable is being used.
 // Executables only have access to the information in this structure and must
 // make all decisions based on it; this ensures executables are portable across
@@ -364,6 +395,21 @@ typedef int (*iree_hal_executable_dispatch_v0_t)(
 // This is chosen to match the common page size of devices.
 #define IREE_HAL_WORKGROUP_LOCAL_MEMORY_PAGE_SIZE 4096
 
+// Preferred order in which the workgroups of a dispatch are executed.
+// This is a hint that runtimes executing workgroups concurrently may use to
+// improve cache reuse between workgroups running at around the same time; the
+// dispatch function must produce the same results regardless of order.
+// Values match iree_task_tile_order_t.
+enum iree_hal_executable_tile_order_e {
+  // Row-major: x changes fastest, then y, then z.
+  IREE_HAL_EXECUTABLE_TILE_ORDER_LINEAR = 0,
+  // Z-order (Morton) curve over square blocks of workgroups in x and y.
+  IREE_HAL_EXECUTABLE_TILE_ORDER_MORTON = 1,
+  // Bands of rows walked column-by-column with y changing fastest.
+  IREE_HAL_EXECUTABLE_TILE_ORDER_SUPER_TILE = 2,
+};
+typedef uint8_t iree_hal_executable_tile_order_t;
+
 // Attributes for exported dispatch functions defining how they are to be
 // executed. 0 defaults are well-specified and the entire attributes table may
 // be omitted if no dispatch functions require these fields.
@@ -372,9 +418,11 @@ typedef struct iree_hal_executable_dispatch_attrs_v0_t {
   // indicating how much workgroup local memory is required for the dispatch.
   // This is the size of the buffer referenced by the `local_memory` argument.
   uint16_t local_memory_pages;
+  // Preferred iree_hal_executable_tile_order_t workgroup execution order.
+  iree_hal_executable_tile_order_t tile_order;
   // Must be 0. May be used in the future for flags controlling the dispatch
   // behavior/synchronization requirements.
-  uint16_t reserved;
+  uint8_t reserved;
 } iree_hal_executable_dispatch_attrs_v0_t;
 static_assert(sizeof(iree_hal_executable_dispatch_attrs_v0_t) == 4, "uint32_t");
 
@@ -138,6 +138,7 @@ static iree_status_t iree_hal_executable_library_create_loader(
 #if defined(IREE_HAL_HAVE_EMBEDDED_LIBRARY_LOADER)
   if (strcmp(FLAG_executable_format, "EX_ELF") == 0) {
     return iree_hal_embedded_library_loader_create(
+        IREE_HAL_EMBEDDED_LIBRARY_LOADER_FLAG_NONE,
         iree_hal_executable_import_provider_null(), host_allocator,
         out_executable_loader);
   }
@@ -29,6 +29,10 @@ typedef struct iree_hal_inline_command_buffer_t {
   iree_hal_command_buffer_t base;
   iree_allocator_t host_allocator;
 
+  // Workgroup local memory shared by all dispatches recorded into the command
+  // buffer. Grown to the largest requirement seen and released on destroy.
+  iree_byte_span_t local_memory;
+
   struct {
     // A flattened list of all available descriptor set bindings.
     // As descriptor sets are pushed/bound the bindings will be updated to
@@ -115,6 +119,7 @@ iree_status_t iree_hal_inline_command_buffer_create(
         device, mode, command_categories, queue_affinity,
         &iree_hal_inline_command_buffer_vtable, &command_buffer->base);
     command_buffer->host_allocator = host_allocator;
+    command_buffer->local_memory = iree_make_byte_span(NULL, 0);
     iree_hal_inline_command_buffer_reset(command_buffer);
 
     *out_command_buffer = &command_buffer->base;
@@ -132,6 +137,7 @@ static void iree_hal_inline_command_buffer_destroy(
   IREE_TRACE_ZONE_BEGIN(z0);
 
   iree_hal_inline_command_buffer_reset(command_buffer);
+  iree_allocator_free(host_allocator, command_buffer->local_memory.data);
   iree_allocator_free(host_allocator, command_buffer);
 
   IREE_TRACE_ZONE_END(z0);
@@ -464,19 +470,23 @@ static iree_status_t iree_hal_inline_command_buffer_dispatch(
         command_buffer->state.full_binding_lengths[binding_ordinal];
   }
 
-  // TODO(benvanik): plumb through an arena or fixed-size reservation to use.
-  // For now when deploying to devices where you want something like the
-  // inline command buffer you probably don't want 256KB of transient memory
-  // getting allocated and retained implicitly - this should be a compiler
-  // option. For now we just malloc here to make things work and strongly
-  // encourage the kind of user who wants synchronous inline execution to not
-  // also want tons of scratch memory.
-  iree_byte_span_t local_memory = iree_make_byte_span(NULL, local_memory_size);
-  if (local_memory_size > 0) {
-    IREE_RETURN_IF_ERROR(iree_allocator_malloc(command_buffer->host_allocator,
-                                               local_memory_size,
-                                               (void**)&local_memory.data));
+  // Workgroup local memory is retained across dispatches so that only the
+  // first dispatch requiring a given amount of memory pays for the allocation.
+  // Users who want synchronous inline execution on constrained devices should
+  // still keep the requirements of their programs small as the memory is held
+  // until the command buffer is destroyed.
+  if (local_memory_size > command_buffer->local_memory.data_length) {
+    iree_allocator_free(command_buffer->host_allocator,
+                        command_buffer->local_memory.data);
+    command_buffer->local_memory = iree_make_byte_span(NULL, 0);
+    IREE_RETURN_IF_ERROR(iree_allocator_malloc(
+        command_buffer->host_allocator, local_memory_size,
+        (void**)&command_buffer->local_memory.data));
+    command_buffer->local_memory.data_length = local_memory_size;
   }
+  iree_byte_span_t local_memory = iree_make_byte_span(
+      local_memory_size ? command_buffer->local_memory.data : NULL,
+      local_memory_size);
 
   // Since we are running on a borrowed thread, we know nothing about the
   // floating point state. Reset it.
@@ -487,9 +497,6 @@ static iree_status_t iree_hal_inline_command_buffer_dispatch(
       command_buffer->state.processor_id, local_memory);
   iree_fpu_state_pop(fpu_state);
 
-  if (local_memory.data) {
-    iree_allocator_free(command_buffer->host_allocator, local_memory.data);
-  }
   return status;
 }
 
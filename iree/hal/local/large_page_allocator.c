@@ -0,0 +1,277 @@
+// Copyright 2022 The IREE Authors
+//
+// Licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+#include "iree/hal/local/large_page_allocator.h"
+
+#include <string.h>
+
+#include "iree/base/target_platform.h"
+#include "iree/base/tracing.h"
+
+iree_status_t iree_hal_large_page_mode_parse(
+    iree_string_view_t value, iree_hal_large_page_mode_t* out_mode) {
+  IREE_ASSERT_ARGUMENT(out_mode);
+  if (iree_string_view_is_empty(value) ||
+      iree_string_view_equal(value, IREE_SV("none"))) {
+    *out_mode = IREE_HAL_LARGE_PAGE_MODE_NONE;
+  } else if (iree_string_view_equal(value, IREE_SV("transparent"))) {
+    *out_mode = IREE_HAL_LARGE_PAGE_MODE_TRANSPARENT;
+  } else if (iree_string_view_equal(value, IREE_SV("hugetlb"))) {
+    *out_mode = IREE_HAL_LARGE_PAGE_MODE_HUGETLB;
+  } else {
+    return iree_make_status(IREE_STATUS_INVALID_ARGUMENT,
+                            "unknown large page mode '%.*s'; expected one of "
+                            "none, transparent, or hugetlb",
+                            (int)value.size, value.data);
+  }
+  return iree_ok_status();
+}
+
+#if defined(IREE_PLATFORM_ANDROID) || defined(IREE_PLATFORM_LINUX)
+
+#include <errno.h>
+#include <sys/mman.h>
+
+#include "iree/base/internal/call_once.h"
+#include "iree/base/internal/huge_pages.h"
+#include "iree/base/internal/synchronization.h"
+
+// Header stored in front of allocations made with the system allocator so that
+// reallocations know how much to copy. Mapped allocations are tracked out of
+// band so that allocations of exact large page multiples map exactly that many
+// pages.
+typedef struct iree_hal_large_page_header_t {
+  // Usable length of the allocation following the header.
+  iree_host_size_t byte_length;
+} iree_hal_large_page_header_t;
+
+// Header size padded to keep the user pointer maximally aligned.
+#define IREE_HAL_LARGE_PAGE_HEADER_SIZE \
+  iree_host_align(sizeof(iree_hal_large_page_header_t), iree_max_align_t)
+
+static iree_hal_large_page_header_t* iree_hal_large_page_header(void* ptr) {
+  return (iree_hal_large_page_header_t*)((uint8_t*)ptr -
+                                         IREE_HAL_LARGE_PAGE_HEADER_SIZE);
+}
+
+// A live large page mapping returned to the user.
+typedef struct iree_hal_large_page_mapping_t {
+  struct iree_hal_large_page_mapping_t* next;
+  // Base of the mapping and the pointer returned to the user.
+  void* ptr;
+  // Total length of the mapping in bytes.
+  iree_host_size_t mapping_length;
+  // Usable length requested by the user.
+  iree_host_size_t byte_length;
+} iree_hal_large_page_mapping_t;
+
+// Process-wide list of live mappings used to tell mapped allocations from
+// system ones on free. Mappings are at least one large page each so there are
+// only ever a handful and a list is fine.
+typedef struct iree_hal_large_page_mapping_list_t {
+  iree_slim_mutex_t mutex;
+  // Singly-linked list of mappings. Guarded by |mutex|.
+  iree_hal_large_page_mapping_t* head;
+} iree_hal_large_page_mapping_list_t;
+
+static iree_hal_large_page_mapping_list_t iree_hal_large_page_mappings_;
+static iree_once_flag iree_hal_large_page_mappings_flag_ = IREE_ONCE_FLAG_INIT;
+static void iree_hal_large_page_mappings_initialize(void) {
+  memset(&iree_hal_large_page_mappings_, 0,
+         sizeof(iree_hal_large_page_mappings_));
+  iree_slim_mutex_initialize(&iree_hal_large_page_mappings_.mutex);
+}
+
+static iree_hal_large_page_mapping_list_t* iree_hal_large_page_mappings(void) {
+  iree_call_once(&iree_hal_large_page_mappings_flag_,
+                 iree_hal_large_page_mappings_initialize);
+  return &iree_hal_large_page_mappings_;
+}
+
+// Removes and returns the mapping with base |ptr| or NULL if |ptr| was not
+// mapped by us. The caller owns the returned mapping record.
+static iree_hal_large_page_mapping_t* iree_hal_large_page_take_mapping(
+    void* ptr) {
+  iree_hal_large_page_mapping_list_t* list = iree_hal_large_page_mappings();
+  iree_slim_mutex_lock(&list->mutex);
+  iree_hal_large_page_mapping_t** prev_next = &list->head;
+  while (*prev_next && (*prev_next)->ptr != ptr) {
+    prev_next = &(*prev_next)->next;
+  }
+  iree_hal_large_page_mapping_t* mapping = *prev_next;
+  if (mapping) *prev_next = mapping->next;
+  iree_slim_mutex_unlock(&list->mutex);
+  return mapping;
+}
+
+// Maps |length| bytes (a multiple of the huge page size) from the hugetlbfs
+// pool. Returns NULL if the pool cannot service the request.
+static void* iree_hal_large_page_map_hugetlb(iree_host_size_t length) {
+#if defined(MAP_HUGETLB)
+  void* ptr = mmap(NULL, length, PROT_READ | PROT_WRITE,
+                   MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB, -1, 0);
+  return ptr == MAP_FAILED ? NULL : ptr;
+#else
+  return NULL;
+#endif  // MAP_HUGETLB
+}
+
+static iree_status_t iree_hal_large_page_allocate(
+    iree_hal_large_page_mode_t mode, iree_allocator_command_t command,
+    iree_host_size_t byte_length, void** out_ptr) {
+  if (IREE_UNLIKELY(byte_length == 0)) {
+    return iree_make_status(IREE_STATUS_INVALID_ARGUMENT,
+                            "allocations must be >0 bytes");
+  }
+  const iree_host_size_t large_page_size = iree_huge_page_size();
+
+  // Small allocations would waste most of a large page so they are routed to
+  // the system allocator. So is everything if the system has no huge pages.
+  if (!large_page_size || byte_length < large_page_size) {
+    const iree_host_size_t header_size = IREE_HAL_LARGE_PAGE_HEADER_SIZE;
+    iree_allocator_alloc_params_t params = {
+        .byte_length = header_size + byte_length,
+    };
+    iree_hal_large_page_header_t* header = NULL;
+    IREE_RETURN_IF_ERROR(iree_allocator_system_ctl(/*self=*/NULL, command,
+                                                   &params, (void**)&header));
+    header->byte_length = byte_length;
+    *out_ptr = (uint8_t*)header + header_size;
+    return iree_ok_status();
+  }
+
+  IREE_TRACE_ZONE_BEGIN(z0);
+  IREE_TRACE_ZONE_APPEND_VALUE(z0, (int64_t)byte_length);
+
+  iree_hal_large_page_mapping_t* mapping = NULL;
+  IREE_RETURN_AND_END_ZONE_IF_ERROR(
+      z0, iree_allocator_malloc(iree_allocator_system(), sizeof(*mapping),
+                                (void**)&mapping));
+
+  // Anonymous mappings are zero-filled so MALLOC and CALLOC are the same.
+  mapping->mapping_length = iree_host_align(byte_length, large_page_size);
+  mapping->byte_length = byte_length;
+  mapping->ptr = NULL;
+  if (mode == IREE_HAL_LARGE_PAGE_MODE_HUGETLB) {
+    mapping->ptr = iree_hal_large_page_map_hugetlb(mapping->mapping_length);
+  }
+  if (!mapping->ptr) {
+    mapping->ptr = iree_huge_page_map(mapping->mapping_length, large_page_size,
+                                      IREE_HUGE_PAGE_MAP_FLAG_ADVISE_HUGE);
+  }
+  if (!mapping->ptr) {
+    iree_status_t status = iree_make_status(
+        iree_status_code_from_errno(errno),
+        "failed to map %zu bytes of large pages", mapping->mapping_length);
+    iree_allocator_free(iree_allocator_system(), mapping);
+    IREE_TRACE_ZONE_END(z0);
+    return status;
+  }
+
+  iree_hal_large_page_mapping_list_t* list = iree_hal_large_page_mappings();
+  iree_slim_mutex_lock(&list->mutex);
+  mapping->next = list->head;
+  list->head = mapping;
+  iree_slim_mutex_unlock(&list->mutex);
+
+  *out_ptr = mapping->ptr;
+  IREE_TRACE_ALLOC(*out_ptr, byte_length);
+
+  IREE_TRACE_ZONE_END(z0);
+  return iree_ok_status();
+}
+
+static void iree_hal_large_page_free(void* ptr) {
+  if (!ptr) return;
+  iree_hal_large_page_mapping_t* mapping =
+      iree_hal_large_page_take_mapping(ptr);
+  if (mapping) {
+    IREE_TRACE_FREE(ptr);
+    iree_huge_page_unmap(mapping->ptr, mapping->mapping_length);
+    iree_allocator_free(iree_allocator_system(), mapping);
+  } else {
+    iree_allocator_free(iree_allocator_system(),
+                        iree_hal_large_page_header(ptr));
+  }
+}
+
+// Returns the usable length of the allocation at |ptr|.
+static iree_host_size_t iree_hal_large_page_byte_length(void* ptr) {
+  iree_hal_large_page_mapping_list_t* list = iree_hal_large_page_mappings();
+  iree_slim_mutex_lock(&list->mutex);
+  iree_hal_large_page_mapping_t* mapping = list->head;
+  while (mapping && mapping->ptr != ptr) mapping = mapping->next;
+  iree_host_size_t byte_length =
+      mapping ? mapping->byte_length
+              : iree_hal_large_page_header(ptr)->byte_length;
+  iree_slim_mutex_unlock(&list->mutex);
+  return byte_length;
+}
+
+static iree_status_t iree_hal_large_page_reallocate(
+    iree_hal_large_page_mode_t mode, iree_host_size_t byte_length,
+    void** inout_ptr) {
+  void* existing_ptr = *inout_ptr;
+  if (!existing_ptr) {
+    return iree_hal_large_page_allocate(mode, IREE_ALLOCATOR_COMMAND_MALLOC,
+                                        byte_length, inout_ptr);
+  }
+  // Reallocations of heap buffers don't happen in practice so we don't bother
+  // with mremap and always copy.
+  void* new_ptr = NULL;
+  IREE_RETURN_IF_ERROR(iree_hal_large_page_allocate(
+      mode, IREE_ALLOCATOR_COMMAND_MALLOC, byte_length, &new_ptr));
+  memcpy(new_ptr, existing_ptr,
+         iree_min(iree_hal_large_page_byte_length(existing_ptr), byte_length));
+  iree_hal_large_page_free(existing_ptr);
+  *inout_ptr = new_ptr;
+  return iree_ok_status();
+}
+
+static iree_status_t iree_hal_large_page_allocator_ctl(
+    void* self, iree_allocator_command_t command, const void* params,
+    void** inout_ptr) {
+  iree_hal_large_page_mode_t mode = (iree_hal_large_page_mode_t)(uintptr_t)self;
+  switch (command) {
+    case IREE_ALLOCATOR_COMMAND_MALLOC:
+    case IREE_ALLOCATOR_COMMAND_CALLOC:
+      return iree_hal_large_page_allocate(
+          mode, command,
+          ((const iree_allocator_alloc_params_t*)params)->byte_length,
+          inout_ptr);
+    case IREE_ALLOCATOR_COMMAND_REALLOC:
+      return iree_hal_large_page_reallocate(
+          mode, ((const iree_allocator_alloc_params_t*)params)->byte_length,
+          inout_ptr);
+    case IREE_ALLOCATOR_COMMAND_FREE:
+      iree_hal_large_page_free(*inout_ptr);
+      *inout_ptr = NULL;
+      return iree_ok_status();
+    default:
+      return iree_make_status(IREE_STATUS_UNIMPLEMENTED,
+                              "unsupported large page allocator command");
+  }
+}
+
+iree_allocator_t iree_hal_large_page_allocator(
+    iree_hal_large_page_mode_t mode) {
+  if (mode == IREE_HAL_LARGE_PAGE_MODE_NONE) return iree_allocator_system();
+  iree_allocator_t allocator = {
+      .self = (void*)(uintptr_t)mode,
+      .ctl = iree_hal_large_page_allocator_ctl,
+  };
+  return allocator;
+}
+
+#else
+
+iree_allocator_t iree_hal_large_page_allocator(
+    iree_hal_large_page_mode_t mode) {
+  // Large pages are not supported on this platform.
+  return iree_allocator_system();
+}
+
+#endif  // IREE_PLATFORM_*
@@ -0,0 +1,48 @@
+// Copyright 2022 The IREE Authors
+//
+// Licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+#ifndef IREE_HAL_LOCAL_LARGE_PAGE_ALLOCATOR_H_
+#define IREE_HAL_LOCAL_LARGE_PAGE_ALLOCATOR_H_
+
+#include "iree/base/api.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif  // __cplusplus
+
+// Controls how allocations from iree_hal_large_page_allocator are backed.
+typedef enum iree_hal_large_page_mode_e {
+  // Large pages are not used and all allocations are made with the system
+  // allocator.
+  IREE_HAL_LARGE_PAGE_MODE_NONE = 0,
+  // Allocations of at least one large page are made from large-page-aligned
+  // anonymous mappings hinted to be backed by transparent huge pages.
+  IREE_HAL_LARGE_PAGE_MODE_TRANSPARENT = 1,
+  // As with IREE_HAL_LARGE_PAGE_MODE_TRANSPARENT but first tries to allocate
+  // from the reserved hugetlbfs pool (MAP_HUGETLB). Falls back to transparent
+  // huge pages when the pool is exhausted or not configured.
+  IREE_HAL_LARGE_PAGE_MODE_HUGETLB = 2,
+} iree_hal_large_page_mode_t;
+
+// Parses a large page mode from one of `none`, `transparent`, or `hugetlb`.
+iree_status_t iree_hal_large_page_mode_parse(
+    iree_string_view_t value, iree_hal_large_page_mode_t* out_mode);
+
+// Returns an allocator that backs allocations of at least one large page
+// (usually 2MB) with large pages as specified by |mode|. Smaller allocations
+// are made from the system allocator.
+//
+// Intended for use as the data allocator of iree_hal_allocator_create_heap so
+// that large buffers such as model weights incur fewer TLB misses when
+// accessed by dispatches. Only supported on Linux/Android; on other platforms
+// or with IREE_HAL_LARGE_PAGE_MODE_NONE the system allocator is returned.
+iree_allocator_t iree_hal_large_page_allocator(iree_hal_large_page_mode_t mode);
+
+#ifdef __cplusplus
+}  // extern "C"
+#endif  // __cplusplus
+
+#endif  // IREE_HAL_LOCAL_LARGE_PAGE_ALLOCATOR_H_
@@ -0,0 +1,92 @@
+// Copyright 2022 The IREE Authors
+//
+// Licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+#include <stdint.h>
+#include <string.h>
+
+#include "iree/base/api.h"
+#include "iree/base/internal/prng.h"
+#include "iree/hal/local/large_page_allocator.h"
+#include "iree/testing/benchmark.h"
+
+// Size of the buffer walked by the benchmarks. Much larger than the reach of
+// the dTLB with 4KB pages (~6MB with 1536 entries) but within the reach of
+// 2MB pages.
+#define IREE_LARGE_PAGE_BENCHMARK_BUFFER_SIZE (512 * 1024 * 1024)
+
+// Number of reads performed per benchmark iteration.
+#define IREE_LARGE_PAGE_BENCHMARK_BATCH_SIZE 4096
+
+// Reads one value from a random 4KB page of a large buffer on each access.
+// Every access touches a different page so with normal pages nearly all of
+// them miss the dTLB and require a page walk while with large pages the whole
+// buffer fits in the TLB. Run under `perf stat -e dTLB-load-misses` to see the
+// miss counts directly.
+//
+// user_data is the iree_hal_large_page_mode_t used to allocate the buffer.
+static iree_status_t iree_hal_large_page_benchmark_random_page_reads(
+    const iree_benchmark_def_t* benchmark_def,
+    iree_benchmark_state_t* benchmark_state) {
+  iree_allocator_t allocator = iree_hal_large_page_allocator(
+      (iree_hal_large_page_mode_t)(uintptr_t)benchmark_def->user_data);
+
+  const iree_host_size_t buffer_size = IREE_LARGE_PAGE_BENCHMARK_BUFFER_SIZE;
+  uint8_t* buffer = NULL;
+  IREE_RETURN_IF_ERROR(
+      iree_allocator_malloc(allocator, buffer_size, (void**)&buffer));
+
+  // Fault in all pages so that we are measuring accesses and not page faults.
+  memset(buffer, 1, buffer_size);
+
+  const uint32_t page_count = (uint32_t)(buffer_size / 4096);
+  iree_prng_xoroshiro128_state_t prng = {0};
+  iree_prng_xoroshiro128_initialize(123ull, &prng);
+
+  uint32_t sum = 0;
+  while (iree_benchmark_keep_running(benchmark_state,
+                                     IREE_LARGE_PAGE_BENCHMARK_BATCH_SIZE)) {
+    for (uint32_t i = 0; i < IREE_LARGE_PAGE_BENCHMARK_BATCH_SIZE; ++i) {
+      uint32_t page =
+          iree_prng_xoroshiro128plus_next_uint32(&prng) % page_count;
+      sum += buffer[(iree_host_size_t)page * 4096 + (i & 4095)];
+    }
+  }
+
+  // Keep the reads live.
+  if (sum == 0) buffer[0] = 0;
+
+  iree_allocator_free(allocator, buffer);
+  return iree_ok_status();
+}
+
+int main(int argc, char** argv) {
+  iree_benchmark_initialize(&argc, argv);
+
+  // iree_hal_large_page_benchmark_random_page_reads
+  {
+    iree_benchmark_def_t benchmark_def = {
+        .flags = IREE_BENCHMARK_FLAG_MEASURE_PROCESS_CPU_TIME |
+                 IREE_BENCHMARK_FLAG_USE_REAL_TIME,
+        .time_unit = IREE_BENCHMARK_UNIT_NANOSECOND,
+        .minimum_duration_ns = 0,
+        .iteration_count = 0,
+        .run = iree_hal_large_page_benchmark_random_page_reads,
+    };
+    benchmark_def.user_data = (void*)IREE_HAL_LARGE_PAGE_MODE_NONE;
+    iree_benchmark_register(iree_make_cstring_view("random_page_reads_none"),
+                            &benchmark_def);
+    benchmark_def.user_data = (void*)IREE_HAL_LARGE_PAGE_MODE_TRANSPARENT;
+    iree_benchmark_register(
+        iree_make_cstring_view("random_page_reads_transparent"),
+        &benchmark_def);
+    benchmark_def.user_data = (void*)IREE_HAL_LARGE_PAGE_MODE_HUGETLB;
+    iree_benchmark_register(iree_make_cstring_view("random_page_reads_hugetlb"),
+                            &benchmark_def);
+  }
+
+  iree_benchmark_run_specified();
+  return 0;
+}
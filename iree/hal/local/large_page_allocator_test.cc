@@ -0,0 +1,91 @@
+// Copyright 2022 The IREE Authors
+//
+// Licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+#include "iree/hal/local/large_page_allocator.h"
+
+#include <cstdint>
+#include <cstring>
+
+#include "iree/base/api.h"
+#include "iree/base/internal/huge_pages.h"
+#include "iree/testing/gtest.h"
+#include "iree/testing/status_matchers.h"
+
+namespace {
+
+using iree::testing::status::StatusIs;
+
+TEST(LargePageAllocatorTest, ParseMode) {
+  iree_hal_large_page_mode_t mode = IREE_HAL_LARGE_PAGE_MODE_HUGETLB;
+  IREE_EXPECT_OK(iree_hal_large_page_mode_parse(IREE_SV(""), &mode));
+  EXPECT_EQ(mode, IREE_HAL_LARGE_PAGE_MODE_NONE);
+  IREE_EXPECT_OK(iree_hal_large_page_mode_parse(IREE_SV("transparent"), &mode));
+  EXPECT_EQ(mode, IREE_HAL_LARGE_PAGE_MODE_TRANSPARENT);
+  IREE_EXPECT_OK(iree_hal_large_page_mode_parse(IREE_SV("hugetlb"), &mode));
+  EXPECT_EQ(mode, IREE_HAL_LARGE_PAGE_MODE_HUGETLB);
+  IREE_EXPECT_OK(iree_hal_large_page_mode_parse(IREE_SV("none"), &mode));
+  EXPECT_EQ(mode, IREE_HAL_LARGE_PAGE_MODE_NONE);
+  EXPECT_THAT(iree::Status(
+                  iree_hal_large_page_mode_parse(IREE_SV("always"), &mode)),
+              StatusIs(iree::StatusCode::kInvalidArgument));
+}
+
+class LargePageAllocatorTest
+    : public ::testing::TestWithParam<iree_hal_large_page_mode_t> {};
+
+// Allocations are zeroed, writable, and aligned for small and large sizes.
+TEST_P(LargePageAllocatorTest, MallocFree) {
+  iree_allocator_t allocator = iree_hal_large_page_allocator(GetParam());
+  for (iree_host_size_t size :
+       {16, 4096, 2 * 1024 * 1024 - 1, 2 * 1024 * 1024, 9 * 1024 * 1024}) {
+    uint8_t* ptr = NULL;
+    IREE_ASSERT_OK(iree_allocator_malloc(allocator, size, (void**)&ptr));
+    EXPECT_EQ(reinterpret_cast<uintptr_t>(ptr) % iree_max_align_t, 0);
+    EXPECT_EQ(ptr[0], 0);
+    EXPECT_EQ(ptr[size - 1], 0);
+    memset(ptr, 0xCD, size);
+    iree_allocator_free(allocator, ptr);
+  }
+}
+
+// Allocations of whole large pages start on a large page boundary. Allocation
+// bookkeeping is kept out of band so exact multiples need no extra page.
+TEST_P(LargePageAllocatorTest, LargeAllocationsArePageAligned) {
+  iree_host_size_t large_page_size = iree_huge_page_size();
+  if (GetParam() == IREE_HAL_LARGE_PAGE_MODE_NONE || !large_page_size) {
+    GTEST_SKIP() << "large pages not in use";
+  }
+  iree_allocator_t allocator = iree_hal_large_page_allocator(GetParam());
+  for (iree_host_size_t size :
+       {large_page_size, 2 * large_page_size, 2 * large_page_size + 1}) {
+    uint8_t* ptr = NULL;
+    IREE_ASSERT_OK(iree_allocator_malloc(allocator, size, (void**)&ptr));
+    EXPECT_EQ(reinterpret_cast<uintptr_t>(ptr) % large_page_size, 0);
+    memset(ptr, 0xCD, size);
+    iree_allocator_free(allocator, ptr);
+  }
+}
+
+// Contents are preserved across reallocations between small and large sizes.
+TEST_P(LargePageAllocatorTest, Realloc) {
+  iree_allocator_t allocator = iree_hal_large_page_allocator(GetParam());
+  uint8_t* ptr = NULL;
+  IREE_ASSERT_OK(iree_allocator_malloc(allocator, 64, (void**)&ptr));
+  memset(ptr, 0xAB, 64);
+  IREE_ASSERT_OK(
+      iree_allocator_realloc(allocator, 4 * 1024 * 1024, (void**)&ptr));
+  for (int i = 0; i < 64; ++i) EXPECT_EQ(ptr[i], 0xAB);
+  IREE_ASSERT_OK(iree_allocator_realloc(allocator, 32, (void**)&ptr));
+  for (int i = 0; i < 32; ++i) EXPECT_EQ(ptr[i], 0xAB);
+  iree_allocator_free(allocator, ptr);
+}
+
+INSTANTIATE_TEST_SUITE_P(AllModes, LargePageAllocatorTest,
+                         ::testing::Values(IREE_HAL_LARGE_PAGE_MODE_NONE,
+                                           IREE_HAL_LARGE_PAGE_MODE_TRANSPARENT,
+                                           IREE_HAL_LARGE_PAGE_MODE_HUGETLB));
+
+}  // namespace
@@ -82,6 +82,7 @@ static iree_status_t iree_hal_elf_executable_query_library(
   executable->identifier = iree_make_cstring_view(header->name);
 
   executable->base.dispatch_attrs = executable->library.v0->exports.attrs;
+  executable->base.export_names = executable->library.v0->exports.names;
 
   return iree_ok_status();
 }
@@ -126,6 +127,7 @@ static iree_status_t iree_hal_elf_executable_resolve_imports(
 }
 
 static iree_status_t iree_hal_elf_executable_create(
+    iree_hal_embedded_library_loader_flags_t flags,
     const iree_hal_executable_params_t* executable_params,
     const iree_hal_executable_import_provider_t import_provider,
     iree_allocator_t host_allocator, iree_hal_executable_t** out_executable) {
@@ -171,10 +173,19 @@ static iree_status_t iree_hal_elf_executable_create(
     }
   }
   if (iree_status_is_ok(status)) {
-    // Attempt to load the ELF module.
-    status = iree_elf_module_initialize_from_memory(
-        executable_params->executable_data, /*import_table=*/NULL,
-        host_allocator, &executable->module);
+    // Attempt to load the ELF module. When requested identical executables
+    // loaded by multiple devices or sessions share a single loaded image (and
+    // its code pages) process-wide.
+    if (iree_all_bits_set(flags,
+                          IREE_HAL_EMBEDDED_LIBRARY_LOADER_FLAG_SHARE_IMAGES)) {
+      status = iree_elf_module_initialize_shared_from_memory(
+          executable_params->executable_data, /*import_table=*/NULL,
+          host_allocator, &executable->module);
+    } else {
+      status = iree_elf_module_initialize_from_memory(
+          executable_params->executable_data, /*import_table=*/NULL,
+          host_allocator, &executable->module);
+    }
   }
   if (iree_status_is_ok(status)) {
     // Query metadata and get the entry point function pointers.
@@ -304,12 +315,14 @@ static const iree_hal_local_executable_vtable_t iree_hal_elf_executable_vtable =
 typedef struct iree_hal_embedded_library_loader_t {
   iree_hal_executable_loader_t base;
   iree_allocator_t host_allocator;
+  iree_hal_embedded_library_loader_flags_t flags;
 } iree_hal_embedded_library_loader_t;
 
 static const iree_hal_executable_loader_vtable_t
     iree_hal_embedded_library_loader_vtable;
 
 iree_status_t iree_hal_embedded_library_loader_create(
+    iree_hal_embedded_library_loader_flags_t flags,
     iree_hal_executable_import_provider_t import_provider,
     iree_allocator_t host_allocator,
     iree_hal_executable_loader_t** out_executable_loader) {
@@ -325,6 +338,7 @@ iree_status_t iree_hal_embedded_library_loader_create(
         &iree_hal_embedded_library_loader_vtable, import_provider,
         &executable_loader->base);
     executable_loader->host_allocator = host_allocator;
+    executable_loader->flags = flags;
     *out_executable_loader = (iree_hal_executable_loader_t*)executable_loader;
   }
 
@@ -362,7 +376,8 @@ static iree_status_t iree_hal_embedded_library_loader_try_load(
 
   // Perform the load of the ELF and wrap it in an executable handle.
   iree_status_t status = iree_hal_elf_executable_create(
-      executable_params, base_executable_loader->import_provider,
+      executable_loader->flags, executable_params,
+      base_executable_loader->import_provider,
       executable_loader->host_allocator, out_executable);
 
   IREE_TRACE_ZONE_END(z0);
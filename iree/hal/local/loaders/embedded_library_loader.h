@@ -17,11 +17,23 @@
 extern "C" {
 #endif  // __cplusplus
 
+// Bitfield specifying embedded library loader behavior.
+enum iree_hal_embedded_library_loader_flag_bits_t {
+  IREE_HAL_EMBEDDED_LIBRARY_LOADER_FLAG_NONE = 0u,
+  // Shares loaded ELF images process-wide between all executables loaded from
+  // identical data (with any loader using this flag). Only the first load pays
+  // the cost of loading/relocating and all share the same code and data pages.
+  // Executables must not rely on per-load mutable state in their data segments.
+  IREE_HAL_EMBEDDED_LIBRARY_LOADER_FLAG_SHARE_IMAGES = 1u << 0,
+};
+typedef uint32_t iree_hal_embedded_library_loader_flags_t;
+
 // Creates an executable loader that can load minimally-featured ELF dynamic
 // libraries on any platform. This allows us to use a single file format across
 // all operating systems at the cost of some missing debugging/profiling
 // features.
 iree_status_t iree_hal_embedded_library_loader_create(
+    iree_hal_embedded_library_loader_flags_t flags,
     iree_hal_executable_import_provider_t import_provider,
     iree_allocator_t host_allocator,
     iree_hal_executable_loader_t** out_executable_loader);
@@ -0,0 +1,91 @@
+// Copyright 2022 The IREE Authors
+//
+// Licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+#include "iree/hal/local/microkernels/microkernels.h"
+
+#include "iree/base/internal/call_once.h"
+#include "iree/hal/local/executable_environment.h"
+#include "iree/hal/local/executable_library.h"
+
+typedef struct iree_microkernel_symbol_t {
+  const char* name;
+  // IREE_HAL_PROCESSOR_DATA0_* bits that must all be supported by the
+  // processor for this implementation to be used.
+  uint64_t required_features;
+  iree_hal_executable_import_v0_t fn_ptr;
+} iree_microkernel_symbol_t;
+
+// NOTE: sorted by name to match the order of executable import tables.
+// ISA-specific variants of a symbol are listed before its generic
+// implementation from the most to the least demanding.
+static const iree_microkernel_symbol_t iree_microkernel_symbols[] = {
+#if defined(IREE_ARCH_X86_64)
+    {"iree_microkernel_mmt4d_f32f32f32",
+     IREE_HAL_PROCESSOR_DATA0_X86_64_AVX2 |
+         IREE_HAL_PROCESSOR_DATA0_X86_64_FMA |
+         IREE_HAL_PROCESSOR_DATA0_X86_64_AVX512F,
+     iree_microkernel_mmt4d_f32f32f32_x86_64_avx512f},
+    {"iree_microkernel_mmt4d_f32f32f32",
+     IREE_HAL_PROCESSOR_DATA0_X86_64_AVX2 | IREE_HAL_PROCESSOR_DATA0_X86_64_FMA,
+     iree_microkernel_mmt4d_f32f32f32_x86_64_avx2_fma},
+#endif  // IREE_ARCH_X86_64
+    {"iree_microkernel_mmt4d_f32f32f32", 0, iree_microkernel_mmt4d_f32f32f32},
+#if defined(IREE_ARCH_X86_64)
+    {"iree_microkernel_mmt4d_i8i8i32",
+     IREE_HAL_PROCESSOR_DATA0_X86_64_AVX2 |
+         IREE_HAL_PROCESSOR_DATA0_X86_64_AVX512F |
+         IREE_HAL_PROCESSOR_DATA0_X86_64_AVX512VNNI,
+     iree_microkernel_mmt4d_i8i8i32_x86_64_avx512vnni},
+    {"iree_microkernel_mmt4d_i8i8i32", IREE_HAL_PROCESSOR_DATA0_X86_64_AVX2,
+     iree_microkernel_mmt4d_i8i8i32_x86_64_avx2},
+#endif  // IREE_ARCH_X86_64
+    {"iree_microkernel_mmt4d_i8i8i32", 0, iree_microkernel_mmt4d_i8i8i32},
+    {"iree_microkernel_pack_x32", 0, iree_microkernel_pack_x32},
+    {"iree_microkernel_pack_x8", 0, iree_microkernel_pack_x8},
+    {"iree_microkernel_unpack_x32", 0, iree_microkernel_unpack_x32},
+    {"iree_microkernel_unpack_x8", 0, iree_microkernel_unpack_x8},
+};
+
+// Processor the provider resolves variants for. Queried once on first use as
+// the query may be expensive (cpuid/getauxval/sysctl) and cannot change.
+static iree_hal_processor_v0_t iree_microkernel_processor_;
+static iree_once_flag iree_microkernel_processor_flag_ = IREE_ONCE_FLAG_INIT;
+static void iree_microkernel_processor_initialize(void) {
+  iree_hal_processor_query(iree_allocator_system(),
+                           &iree_microkernel_processor_);
+}
+
+static iree_status_t iree_microkernel_import_provider_resolve(
+    void* self, iree_string_view_t symbol_name, void** out_fn_ptr) {
+  const iree_hal_processor_v0_t* processor =
+      (const iree_hal_processor_v0_t*)self;
+  for (iree_host_size_t i = 0; i < IREE_ARRAYSIZE(iree_microkernel_symbols);
+       ++i) {
+    const iree_microkernel_symbol_t* symbol = &iree_microkernel_symbols[i];
+    if ((processor->data[0] & symbol->required_features) !=
+        symbol->required_features) {
+      continue;
+    }
+    if (iree_string_view_equal(symbol_name,
+                               iree_make_cstring_view(symbol->name))) {
+      *out_fn_ptr = (void*)symbol->fn_ptr;
+      return iree_ok_status();
+    }
+  }
+  return iree_make_status(IREE_STATUS_NOT_FOUND,
+                          "microkernel '%.*s' not available in this runtime",
+                          (int)symbol_name.size, symbol_name.data);
+}
+
+iree_hal_executable_import_provider_t iree_microkernel_import_provider(void) {
+  iree_call_once(&iree_microkernel_processor_flag_,
+                 iree_microkernel_processor_initialize);
+  iree_hal_executable_import_provider_t provider = {
+      .self = &iree_microkernel_processor_,
+      .resolve = iree_microkernel_import_provider_resolve,
+  };
+  return provider;
+}
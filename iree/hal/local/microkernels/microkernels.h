@@ -0,0 +1,134 @@
+// Copyright 2022 The IREE Authors
+//
+// Licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+#ifndef IREE_HAL_LOCAL_MICROKERNELS_MICROKERNELS_H_
+#define IREE_HAL_LOCAL_MICROKERNELS_MICROKERNELS_H_
+
+#include <stdint.h>
+
+#include "iree/base/api.h"
+#include "iree/hal/local/executable_loader.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif  // __cplusplus
+
+//===----------------------------------------------------------------------===//
+// Microkernel ABI
+//===----------------------------------------------------------------------===//
+// Microkernels are hand-written inner loops that executables call through the
+// iree_hal_executable_import_table_v0_t instead of generating the loops
+// themselves. Each microkernel is an iree_hal_executable_import_v0_t taking a
+// pointer to its parameter struct and returning 0 on success.
+//
+// The parameter structs are laid out to match what the compiler produces when
+// lowering calls to imports (see ConvertToLLVM.cpp): every buffer operand is
+// passed as a pointer to its first element followed by the stride (in
+// elements) of its outermost dimension and all scalar operands follow as
+// pointer-sized integers. Changing any of the structs below requires a
+// matching change in the compiler and a new symbol name.
+
+// Signed pointer-sized integer matching the compiler `index` type.
+typedef intptr_t iree_microkernel_ssize_t;
+
+// Parameters for the `iree_microkernel_mmt4d_*` microkernels.
+//
+// Computes out += lhs * transpose(rhs) on data that has been packed into
+// tiles of m0xk0 (lhs), n0xk0 (rhs) and m0xn0 (out) elements:
+//   lhs: [m][k][m0][k0] with stride |lhs_stride| between rows of m
+//   rhs: [n][k][n0][k0] with stride |rhs_stride| between rows of n
+//   out: [m][n][m0][n0] with stride |out_stride| between rows of m
+// Each row of tiles must be contiguous.
+typedef struct iree_microkernel_mmt4d_params_t {
+  const void* lhs_buffer;
+  iree_microkernel_ssize_t lhs_stride;
+  const void* rhs_buffer;
+  iree_microkernel_ssize_t rhs_stride;
+  void* out_buffer;
+  iree_microkernel_ssize_t out_stride;
+  iree_microkernel_ssize_t m;
+  iree_microkernel_ssize_t n;
+  iree_microkernel_ssize_t k;
+  iree_microkernel_ssize_t m0;
+  iree_microkernel_ssize_t n0;
+  iree_microkernel_ssize_t k0;
+} iree_microkernel_mmt4d_params_t;
+
+// Parameters for the `iree_microkernel_pack_*` microkernels.
+//
+// Packs the row-major |in_size0|x|in_size1| matrix |in_buffer| with stride
+// |in_stride| between rows into tiles of |tile_size0|x|tile_size1| elements:
+//   out: [ceil(in_size0 / tile_size0)][ceil(in_size1 / tile_size1)]
+//        [tile_size0][tile_size1]
+// with stride |out_stride| between rows of tiles. Elements of partial tiles
+// that fall outside of the input are filled with zeros.
+typedef struct iree_microkernel_pack_params_t {
+  const void* in_buffer;
+  iree_microkernel_ssize_t in_stride;
+  void* out_buffer;
+  iree_microkernel_ssize_t out_stride;
+  iree_microkernel_ssize_t in_size0;
+  iree_microkernel_ssize_t in_size1;
+  iree_microkernel_ssize_t tile_size0;
+  iree_microkernel_ssize_t tile_size1;
+} iree_microkernel_pack_params_t;
+
+// Parameters for the `iree_microkernel_unpack_*` microkernels.
+//
+// Inverse of pack: writes the |out_size0|x|out_size1| row-major matrix
+// |out_buffer| with stride |out_stride| between rows from the tiles in
+// |in_buffer| (laid out as produced by pack) and drops any padding.
+typedef struct iree_microkernel_unpack_params_t {
+  const void* in_buffer;
+  iree_microkernel_ssize_t in_stride;
+  void* out_buffer;
+  iree_microkernel_ssize_t out_stride;
+  iree_microkernel_ssize_t out_size0;
+  iree_microkernel_ssize_t out_size1;
+  iree_microkernel_ssize_t tile_size0;
+  iree_microkernel_ssize_t tile_size1;
+} iree_microkernel_unpack_params_t;
+
+// mmt4d with f32 lhs/rhs accumulating into f32.
+int iree_microkernel_mmt4d_f32f32f32(void* params);
+
+// mmt4d with i8 lhs/rhs accumulating into i32.
+int iree_microkernel_mmt4d_i8i8i32(void* params);
+
+#if defined(IREE_ARCH_X86_64)
+// Variants of the mmt4d microkernels using ISA extensions. The caller must
+// ensure the processor supports the extensions; the import provider resolves
+// the generic names above to the best variant the processor supports.
+int iree_microkernel_mmt4d_f32f32f32_x86_64_avx2_fma(void* params);
+int iree_microkernel_mmt4d_f32f32f32_x86_64_avx512f(void* params);
+int iree_microkernel_mmt4d_i8i8i32_x86_64_avx2(void* params);
+int iree_microkernel_mmt4d_i8i8i32_x86_64_avx512vnni(void* params);
+#endif  // IREE_ARCH_X86_64
+
+// pack/unpack of 8-bit elements.
+int iree_microkernel_pack_x8(void* params);
+int iree_microkernel_unpack_x8(void* params);
+
+// pack/unpack of 32-bit elements.
+int iree_microkernel_pack_x32(void* params);
+int iree_microkernel_unpack_x32(void* params);
+
+//===----------------------------------------------------------------------===//
+// Import provider
+//===----------------------------------------------------------------------===//
+
+// Returns an import provider that resolves the microkernels declared above
+// by their function name (`iree_microkernel_mmt4d_f32f32f32`, etc). Names with
+// ISA-specific variants resolve to the best variant supported by the current
+// processor. The processor is queried once when the first provider is created
+// and the provider may be used with any number of loaders.
+iree_hal_executable_import_provider_t iree_microkernel_import_provider(void);
+
+#ifdef __cplusplus
+}  // extern "C"
+#endif  // __cplusplus
+
+#endif  // IREE_HAL_LOCAL_MICROKERNELS_MICROKERNELS_H_
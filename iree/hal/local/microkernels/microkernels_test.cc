@@ -0,0 +1,263 @@
+// Copyright 2022 The IREE Authors
+//
+// Licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+#include "iree/hal/local/microkernels/microkernels.h"
+
+#include <cstdint>
+#include <vector>
+
+#include "iree/base/api.h"
+#include "iree/hal/local/executable_environment.h"
+#include "iree/hal/local/executable_library.h"
+#include "iree/testing/gtest.h"
+#include "iree/testing/status_matchers.h"
+
+namespace {
+
+// Reference mmt4d on the packed layout described in microkernels.h.
+template <typename LhsT, typename RhsT, typename OutT>
+void ReferenceMmt4d(const iree_microkernel_mmt4d_params_t& params) {
+  for (int64_t i = 0; i < params.m; ++i) {
+    for (int64_t j = 0; j < params.n; ++j) {
+      OutT* out = (OutT*)params.out_buffer + i * params.out_stride +
+                  j * params.m0 * params.n0;
+      for (int64_t kk = 0; kk < params.k; ++kk) {
+        const LhsT* lhs = (const LhsT*)params.lhs_buffer +
+                          i * params.lhs_stride + kk * params.m0 * params.k0;
+        const RhsT* rhs = (const RhsT*)params.rhs_buffer +
+                          j * params.rhs_stride + kk * params.n0 * params.k0;
+        for (int64_t ii = 0; ii < params.m0; ++ii) {
+          for (int64_t jj = 0; jj < params.n0; ++jj) {
+            for (int64_t l = 0; l < params.k0; ++l) {
+              out[ii * params.n0 + jj] +=
+                  (OutT)lhs[ii * params.k0 + l] * (OutT)rhs[jj * params.k0 + l];
+            }
+          }
+        }
+      }
+    }
+  }
+}
+
+// Checks |fn| against ReferenceMmt4d. Inputs are small values by default so
+// that f32 results are exact; |full_range| spans all 8-bit values instead.
+template <typename LhsT, typename RhsT, typename OutT>
+void CheckMmt4d(iree_hal_executable_import_v0_t fn, int64_t m, int64_t n,
+                int64_t k, int64_t m0, int64_t n0, int64_t k0,
+                bool full_range = false) {
+  // Pad the outer strides to ensure they are respected.
+  int64_t lhs_stride = k * m0 * k0 + 3;
+  int64_t rhs_stride = k * n0 * k0 + 5;
+  int64_t out_stride = n * m0 * n0 + 7;
+  std::vector<LhsT> lhs(m * lhs_stride);
+  std::vector<RhsT> rhs(n * rhs_stride);
+  for (size_t i = 0; i < lhs.size(); ++i) {
+    lhs[i] = full_range ? (LhsT)((int)((i * 37) % 256) - 128)
+                        : (LhsT)((i * 7) % 13 - 6);
+  }
+  for (size_t i = 0; i < rhs.size(); ++i) {
+    rhs[i] = full_range ? (RhsT)((int)((i * 91 + 5) % 256) - 128)
+                        : (RhsT)((i * 5) % 11 - 5);
+  }
+  std::vector<OutT> out(m * out_stride);
+  for (size_t i = 0; i < out.size(); ++i) out[i] = (OutT)(i % 3);
+  std::vector<OutT> expected = out;
+
+  iree_microkernel_mmt4d_params_t params = {
+      lhs.data(), lhs_stride, rhs.data(), rhs_stride, expected.data(),
+      out_stride, m,          n,          k,          m0,
+      n0,         k0,
+  };
+  ReferenceMmt4d<LhsT, RhsT, OutT>(params);
+  params.out_buffer = out.data();
+  EXPECT_EQ(0, fn(&params));
+  EXPECT_EQ(expected, out);
+}
+
+iree_hal_executable_import_v0_t Resolve(const char* symbol_name) {
+  void* fn_ptr = NULL;
+  IREE_CHECK_OK(iree_hal_executable_import_provider_resolve(
+      iree_microkernel_import_provider(), iree_make_cstring_view(symbol_name),
+      &fn_ptr));
+  return (iree_hal_executable_import_v0_t)fn_ptr;
+}
+
+// Returns the IREE_HAL_PROCESSOR_DATA0_* bits of the current processor.
+uint64_t QueryProcessorFeatures() {
+  iree_hal_processor_v0_t processor;
+  iree_hal_processor_query(iree_allocator_system(), &processor);
+  return processor.data[0];
+}
+
+bool HasProcessorFeatures(uint64_t required_features) {
+  return (QueryProcessorFeatures() & required_features) == required_features;
+}
+
+TEST(MicrokernelsTest, ResolvesKnownSymbols) {
+  EXPECT_EQ((void*)Resolve("iree_microkernel_unpack_x8"),
+            (void*)iree_microkernel_unpack_x8);
+  // Symbols with ISA-specific variants may resolve to any of them but must
+  // compute the same results.
+  CheckMmt4d<float, float, float>(Resolve("iree_microkernel_mmt4d_f32f32f32"),
+                                  2, 3, 17, 8, 8, 1);
+  CheckMmt4d<int8_t, int8_t, int32_t>(
+      Resolve("iree_microkernel_mmt4d_i8i8i32"), 2, 3, 17, 8, 16, 4,
+      /*full_range=*/true);
+}
+
+#if defined(IREE_ARCH_X86_64)
+TEST(MicrokernelsTest, ResolvesProcessorVariants) {
+  const uint64_t vnni_features = IREE_HAL_PROCESSOR_DATA0_X86_64_AVX2 |
+                                 IREE_HAL_PROCESSOR_DATA0_X86_64_AVX512F |
+                                 IREE_HAL_PROCESSOR_DATA0_X86_64_AVX512VNNI;
+  if (!HasProcessorFeatures(vnni_features)) {
+    GTEST_SKIP() << "processor does not support AVX-512 VNNI";
+  }
+  EXPECT_EQ((void*)Resolve("iree_microkernel_mmt4d_i8i8i32"),
+            (void*)iree_microkernel_mmt4d_i8i8i32_x86_64_avx512vnni);
+}
+#endif  // IREE_ARCH_X86_64
+
+TEST(MicrokernelsTest, UnknownSymbols) {
+  void* fn_ptr = NULL;
+  iree_status_t status = iree_hal_executable_import_provider_resolve(
+      iree_microkernel_import_provider(),
+      iree_make_cstring_view("iree_microkernel_mmt4d_f64f64f64"), &fn_ptr);
+  IREE_EXPECT_STATUS_IS(IREE_STATUS_NOT_FOUND, status);
+  iree_status_free(status);
+
+  // Weak imports resolve to NULL instead of failing.
+  IREE_EXPECT_OK(iree_hal_executable_import_provider_resolve(
+      iree_microkernel_import_provider(),
+      iree_make_cstring_view("iree_microkernel_mmt4d_f64f64f64?"), &fn_ptr));
+  EXPECT_EQ(fn_ptr, nullptr);
+}
+
+TEST(MicrokernelsTest, Mmt4dF32Generic) {
+  CheckMmt4d<float, float, float>(iree_microkernel_mmt4d_f32f32f32, 3, 2, 5,
+                                  3, 2, 4);
+}
+
+TEST(MicrokernelsTest, Mmt4dF32Tile8x8x1) {
+  CheckMmt4d<float, float, float>(iree_microkernel_mmt4d_f32f32f32, 2, 3, 17,
+                                  8, 8, 1);
+}
+
+TEST(MicrokernelsTest, Mmt4dI8Generic) {
+  CheckMmt4d<int8_t, int8_t, int32_t>(iree_microkernel_mmt4d_i8i8i32, 2, 3, 4,
+                                      4, 2, 3);
+}
+
+TEST(MicrokernelsTest, Mmt4dI8Tile8x8x1) {
+  CheckMmt4d<int8_t, int8_t, int32_t>(iree_microkernel_mmt4d_i8i8i32, 3, 2,
+                                      9, 8, 8, 1);
+}
+
+TEST(MicrokernelsTest, Mmt4dI8FullRange) {
+  CheckMmt4d<int8_t, int8_t, int32_t>(iree_microkernel_mmt4d_i8i8i32, 3, 2,
+                                      9, 8, 8, 1, /*full_range=*/true);
+}
+
+#if defined(IREE_ARCH_X86_64)
+
+TEST(MicrokernelsTest, Mmt4dF32Avx2Fma) {
+  if (!HasProcessorFeatures(IREE_HAL_PROCESSOR_DATA0_X86_64_AVX2 |
+                            IREE_HAL_PROCESSOR_DATA0_X86_64_FMA)) {
+    GTEST_SKIP() << "processor does not support AVX2+FMA";
+  }
+  CheckMmt4d<float, float, float>(
+      iree_microkernel_mmt4d_f32f32f32_x86_64_avx2_fma, 2, 3, 17, 8, 8, 1);
+  CheckMmt4d<float, float, float>(
+      iree_microkernel_mmt4d_f32f32f32_x86_64_avx2_fma, 3, 2, 5, 3, 2, 4);
+}
+
+TEST(MicrokernelsTest, Mmt4dF32Avx512f) {
+  if (!HasProcessorFeatures(IREE_HAL_PROCESSOR_DATA0_X86_64_AVX2 |
+                            IREE_HAL_PROCESSOR_DATA0_X86_64_FMA |
+                            IREE_HAL_PROCESSOR_DATA0_X86_64_AVX512F)) {
+    GTEST_SKIP() << "processor does not support AVX-512F";
+  }
+  CheckMmt4d<float, float, float>(
+      iree_microkernel_mmt4d_f32f32f32_x86_64_avx512f, 2, 3, 7, 16, 16, 1);
+  CheckMmt4d<float, float, float>(
+      iree_microkernel_mmt4d_f32f32f32_x86_64_avx512f, 2, 3, 17, 8, 8, 1);
+}
+
+TEST(MicrokernelsTest, Mmt4dI8Avx2) {
+  if (!HasProcessorFeatures(IREE_HAL_PROCESSOR_DATA0_X86_64_AVX2)) {
+    GTEST_SKIP() << "processor does not support AVX2";
+  }
+  CheckMmt4d<int8_t, int8_t, int32_t>(
+      iree_microkernel_mmt4d_i8i8i32_x86_64_avx2, 3, 2, 9, 8, 8, 1,
+      /*full_range=*/true);
+}
+
+// Exercises the signedness correction with the full range of i8 values.
+TEST(MicrokernelsTest, Mmt4dI8Avx512Vnni) {
+  if (!HasProcessorFeatures(IREE_HAL_PROCESSOR_DATA0_X86_64_AVX2 |
+                            IREE_HAL_PROCESSOR_DATA0_X86_64_AVX512F |
+                            IREE_HAL_PROCESSOR_DATA0_X86_64_AVX512VNNI)) {
+    GTEST_SKIP() << "processor does not support AVX-512 VNNI";
+  }
+  CheckMmt4d<int8_t, int8_t, int32_t>(
+      iree_microkernel_mmt4d_i8i8i32_x86_64_avx512vnni, 3, 2, 9, 8, 16, 4,
+      /*full_range=*/true);
+  CheckMmt4d<int8_t, int8_t, int32_t>(
+      iree_microkernel_mmt4d_i8i8i32_x86_64_avx512vnni, 3, 2, 9, 8, 8, 1,
+      /*full_range=*/true);
+}
+
+#endif  // IREE_ARCH_X86_64
+
+TEST(MicrokernelsTest, PackUnpackX32) {
+  const int64_t rows = 5, cols = 7, in_stride = 9;
+  const int64_t tile0 = 2, tile1 = 3;
+  const int64_t out_stride = 3 * tile0 * tile1;  // ceil(7 / 3) tiles per row
+  std::vector<uint32_t> in(rows * in_stride);
+  for (size_t i = 0; i < in.size(); ++i) in[i] = (uint32_t)i + 1;
+  std::vector<uint32_t> packed(3 * out_stride, 0xCDCDCDCDu);
+
+  iree_microkernel_pack_params_t pack_params = {
+      in.data(), in_stride, packed.data(), out_stride, rows, cols,
+      tile0,     tile1,
+  };
+  EXPECT_EQ(0, iree_microkernel_pack_x32(&pack_params));
+  for (int64_t r = 0; r < 3 * tile0; ++r) {
+    for (int64_t c = 0; c < 3 * tile1; ++c) {
+      uint32_t value = packed[(r / tile0) * out_stride +
+                              (c / tile1) * tile0 * tile1 +
+                              (r % tile0) * tile1 + (c % tile1)];
+      uint32_t expected = r < rows && c < cols ? in[r * in_stride + c] : 0;
+      EXPECT_EQ(expected, value) << "at " << r << "," << c;
+    }
+  }
+
+  std::vector<uint32_t> out(rows * in_stride, 0xCDCDCDCDu);
+  iree_microkernel_unpack_params_t unpack_params = {
+      packed.data(), out_stride, out.data(), in_stride, rows, cols,
+      tile0,         tile1,
+  };
+  EXPECT_EQ(0, iree_microkernel_unpack_x32(&unpack_params));
+  for (int64_t r = 0; r < rows; ++r) {
+    for (int64_t c = 0; c < in_stride; ++c) {
+      uint32_t expected = c < cols ? in[r * in_stride + c] : 0xCDCDCDCDu;
+      EXPECT_EQ(expected, out[r * in_stride + c]);
+    }
+  }
+}
+
+TEST(MicrokernelsTest, PackX8) {
+  const uint8_t in[2 * 3] = {1, 2, 3, 4, 5, 6};
+  uint8_t packed[1 * 2 * 4] = {0};
+  iree_microkernel_pack_params_t params = {
+      in, 3, packed, 8, 2, 3, 2, 4,
+  };
+  EXPECT_EQ(0, iree_microkernel_pack_x8(&params));
+  const uint8_t expected[8] = {1, 2, 3, 0, 4, 5, 6, 0};
+  for (int i = 0; i < 8; ++i) EXPECT_EQ(expected[i], packed[i]);
+}
+
+}  // namespace
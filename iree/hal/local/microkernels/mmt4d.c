@@ -0,0 +1,429 @@
+// Copyright 2022 The IREE Authors
+//
+// Licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+#include <string.h>
+
+#include "iree/base/api.h"
+#include "iree/hal/local/executable_library.h"
+#include "iree/hal/local/microkernels/microkernels.h"
+
+#if defined(IREE_ARCH_ARM_64)
+#include <arm_neon.h>
+#elif defined(IREE_ARCH_X86_64)
+#include <immintrin.h>
+#endif  // IREE_ARCH_*
+
+// Enables the ISA |features| (as a comma-separated string) for the attributed
+// function only. Callers must ensure the processor supports the features
+// before calling the function. MSVC allows intrinsics to be used anywhere.
+#if defined(IREE_COMPILER_GCC_COMPAT)
+#define IREE_MICROKERNEL_TARGET(features) __attribute__((target(features)))
+#else
+#define IREE_MICROKERNEL_TARGET(features)
+#endif  // IREE_COMPILER_GCC_COMPAT
+
+//===----------------------------------------------------------------------===//
+// f32f32f32
+//===----------------------------------------------------------------------===//
+
+// Accumulates one m0xn0 |out| tile from |k| m0xk0 |lhs| and n0xk0 |rhs| tiles.
+typedef void (*iree_microkernel_mmt4d_tile_f32_fn_t)(
+    const float* IREE_RESTRICT lhs, const float* IREE_RESTRICT rhs,
+    float* IREE_RESTRICT out, iree_microkernel_ssize_t k,
+    iree_microkernel_ssize_t m0, iree_microkernel_ssize_t n0,
+    iree_microkernel_ssize_t k0);
+
+static void iree_microkernel_mmt4d_tile_f32_generic(
+    const float* IREE_RESTRICT lhs, const float* IREE_RESTRICT rhs,
+    float* IREE_RESTRICT out, iree_microkernel_ssize_t k,
+    iree_microkernel_ssize_t m0, iree_microkernel_ssize_t n0,
+    iree_microkernel_ssize_t k0) {
+  for (iree_microkernel_ssize_t kk = 0; kk < k; ++kk) {
+    for (iree_microkernel_ssize_t i = 0; i < m0; ++i) {
+      for (iree_microkernel_ssize_t j = 0; j < n0; ++j) {
+        float acc = out[i * n0 + j];
+        for (iree_microkernel_ssize_t l = 0; l < k0; ++l) {
+          acc += lhs[i * k0 + l] * rhs[j * k0 + l];
+        }
+        out[i * n0 + j] = acc;
+      }
+    }
+    lhs += m0 * k0;
+    rhs += n0 * k0;
+  }
+}
+
+#if defined(IREE_ARCH_ARM_64)
+
+// 8x8x1 tile holding the whole accumulator in 16 NEON registers.
+static void iree_microkernel_mmt4d_tile_f32_8x8x1_neon(
+    const float* IREE_RESTRICT lhs, const float* IREE_RESTRICT rhs,
+    float* IREE_RESTRICT out, iree_microkernel_ssize_t k,
+    iree_microkernel_ssize_t m0, iree_microkernel_ssize_t n0,
+    iree_microkernel_ssize_t k0) {
+  float32x4_t acc[16];
+  for (int i = 0; i < 16; ++i) acc[i] = vld1q_f32(out + i * 4);
+  for (iree_microkernel_ssize_t kk = 0; kk < k; ++kk) {
+    float32x4_t a0 = vld1q_f32(lhs);
+    float32x4_t a1 = vld1q_f32(lhs + 4);
+    float32x4_t b0 = vld1q_f32(rhs);
+    float32x4_t b1 = vld1q_f32(rhs + 4);
+    lhs += 8;
+    rhs += 8;
+#define IREE_MMT4D_ROW(row, a, lane)                                     \
+  acc[2 * (row) + 0] = vfmaq_laneq_f32(acc[2 * (row) + 0], b0, a, lane); \
+  acc[2 * (row) + 1] = vfmaq_laneq_f32(acc[2 * (row) + 1], b1, a, lane);
+    IREE_MMT4D_ROW(0, a0, 0);
+    IREE_MMT4D_ROW(1, a0, 1);
+    IREE_MMT4D_ROW(2, a0, 2);
+    IREE_MMT4D_ROW(3, a0, 3);
+    IREE_MMT4D_ROW(4, a1, 0);
+    IREE_MMT4D_ROW(5, a1, 1);
+    IREE_MMT4D_ROW(6, a1, 2);
+    IREE_MMT4D_ROW(7, a1, 3);
+#undef IREE_MMT4D_ROW
+  }
+  for (int i = 0; i < 16; ++i) vst1q_f32(out + i * 4, acc[i]);
+}
+
+#elif defined(IREE_ARCH_X86_64)
+
+// 8x8x1 tile holding the whole accumulator in 16 SSE registers. SSE2 is part
+// of the x86-64 baseline so this needs no runtime feature check.
+static void iree_microkernel_mmt4d_tile_f32_8x8x1_sse(
+    const float* IREE_RESTRICT lhs, const float* IREE_RESTRICT rhs,
+    float* IREE_RESTRICT out, iree_microkernel_ssize_t k,
+    iree_microkernel_ssize_t m0, iree_microkernel_ssize_t n0,
+    iree_microkernel_ssize_t k0) {
+  __m128 acc[16];
+  for (int i = 0; i < 16; ++i) acc[i] = _mm_loadu_ps(out + i * 4);
+  for (iree_microkernel_ssize_t kk = 0; kk < k; ++kk) {
+    __m128 b0 = _mm_loadu_ps(rhs);
+    __m128 b1 = _mm_loadu_ps(rhs + 4);
+    for (int i = 0; i < 8; ++i) {
+      __m128 a = _mm_set1_ps(lhs[i]);
+      acc[2 * i + 0] = _mm_add_ps(acc[2 * i + 0], _mm_mul_ps(a, b0));
+      acc[2 * i + 1] = _mm_add_ps(acc[2 * i + 1], _mm_mul_ps(a, b1));
+    }
+    lhs += 8;
+    rhs += 8;
+  }
+  for (int i = 0; i < 16; ++i) _mm_storeu_ps(out + i * 4, acc[i]);
+}
+
+// 8x8x1 tile holding one accumulator row per AVX register.
+IREE_MICROKERNEL_TARGET("avx2,fma")
+static void iree_microkernel_mmt4d_tile_f32_8x8x1_avx2_fma(
+    const float* IREE_RESTRICT lhs, const float* IREE_RESTRICT rhs,
+    float* IREE_RESTRICT out, iree_microkernel_ssize_t k,
+    iree_microkernel_ssize_t m0, iree_microkernel_ssize_t n0,
+    iree_microkernel_ssize_t k0) {
+  __m256 acc[8];
+  for (int i = 0; i < 8; ++i) acc[i] = _mm256_loadu_ps(out + i * 8);
+  for (iree_microkernel_ssize_t kk = 0; kk < k; ++kk) {
+    __m256 b = _mm256_loadu_ps(rhs);
+    for (int i = 0; i < 8; ++i) {
+      acc[i] = _mm256_fmadd_ps(_mm256_broadcast_ss(lhs + i), b, acc[i]);
+    }
+    lhs += 8;
+    rhs += 8;
+  }
+  for (int i = 0; i < 8; ++i) _mm256_storeu_ps(out + i * 8, acc[i]);
+}
+
+// 16x16x1 tile holding one accumulator row per AVX-512 register.
+IREE_MICROKERNEL_TARGET("avx512f")
+static void iree_microkernel_mmt4d_tile_f32_16x16x1_avx512f(
+    const float* IREE_RESTRICT lhs, const float* IREE_RESTRICT rhs,
+    float* IREE_RESTRICT out, iree_microkernel_ssize_t k,
+    iree_microkernel_ssize_t m0, iree_microkernel_ssize_t n0,
+    iree_microkernel_ssize_t k0) {
+  __m512 acc[16];
+  for (int i = 0; i < 16; ++i) acc[i] = _mm512_loadu_ps(out + i * 16);
+  for (iree_microkernel_ssize_t kk = 0; kk < k; ++kk) {
+    __m512 b = _mm512_loadu_ps(rhs);
+    for (int i = 0; i < 16; ++i) {
+      acc[i] = _mm512_fmadd_ps(_mm512_set1_ps(lhs[i]), b, acc[i]);
+    }
+    lhs += 16;
+    rhs += 16;
+  }
+  for (int i = 0; i < 16; ++i) _mm512_storeu_ps(out + i * 16, acc[i]);
+}
+
+#endif  // IREE_ARCH_*
+
+// Returns the fastest tile function for the given tile shape that only uses
+// the processor |features| (IREE_HAL_PROCESSOR_DATA0_* bits).
+static iree_microkernel_mmt4d_tile_f32_fn_t
+iree_microkernel_mmt4d_select_tile_f32(iree_microkernel_ssize_t m0,
+                                       iree_microkernel_ssize_t n0,
+                                       iree_microkernel_ssize_t k0,
+                                       uint64_t features) {
+#if defined(IREE_ARCH_ARM_64)
+  if (m0 == 8 && n0 == 8 && k0 == 1) {
+    return iree_microkernel_mmt4d_tile_f32_8x8x1_neon;
+  }
+#elif defined(IREE_ARCH_X86_64)
+  const uint64_t avx2_fma_features = IREE_HAL_PROCESSOR_DATA0_X86_64_AVX2 |
+                                     IREE_HAL_PROCESSOR_DATA0_X86_64_FMA;
+  if (m0 == 16 && n0 == 16 && k0 == 1 &&
+      (features & IREE_HAL_PROCESSOR_DATA0_X86_64_AVX512F)) {
+    return iree_microkernel_mmt4d_tile_f32_16x16x1_avx512f;
+  }
+  if (m0 == 8 && n0 == 8 && k0 == 1) {
+    if ((features & avx2_fma_features) == avx2_fma_features) {
+      return iree_microkernel_mmt4d_tile_f32_8x8x1_avx2_fma;
+    }
+    return iree_microkernel_mmt4d_tile_f32_8x8x1_sse;
+  }
+#endif  // IREE_ARCH_*
+  return iree_microkernel_mmt4d_tile_f32_generic;
+}
+
+static int iree_microkernel_mmt4d_f32f32f32_impl(
+    const iree_microkernel_mmt4d_params_t* params, uint64_t features) {
+  iree_microkernel_mmt4d_tile_f32_fn_t tile_fn =
+      iree_microkernel_mmt4d_select_tile_f32(params->m0, params->n0,
+                                             params->k0, features);
+  const iree_microkernel_ssize_t out_tile_size = params->m0 * params->n0;
+  const float* lhs_row = (const float*)params->lhs_buffer;
+  float* out_row = (float*)params->out_buffer;
+  for (iree_microkernel_ssize_t i = 0; i < params->m; ++i) {
+    const float* rhs_row = (const float*)params->rhs_buffer;
+    for (iree_microkernel_ssize_t j = 0; j < params->n; ++j) {
+      tile_fn(lhs_row, rhs_row, out_row + j * out_tile_size, params->k,
+              params->m0, params->n0, params->k0);
+      rhs_row += params->rhs_stride;
+    }
+    lhs_row += params->lhs_stride;
+    out_row += params->out_stride;
+  }
+  return 0;
+}
+
+int iree_microkernel_mmt4d_f32f32f32(void* params) {
+  return iree_microkernel_mmt4d_f32f32f32_impl(
+      (const iree_microkernel_mmt4d_params_t*)params, /*features=*/0);
+}
+
+#if defined(IREE_ARCH_X86_64)
+
+int iree_microkernel_mmt4d_f32f32f32_x86_64_avx2_fma(void* params) {
+  return iree_microkernel_mmt4d_f32f32f32_impl(
+      (const iree_microkernel_mmt4d_params_t*)params,
+      IREE_HAL_PROCESSOR_DATA0_X86_64_AVX2 |
+          IREE_HAL_PROCESSOR_DATA0_X86_64_FMA);
+}
+
+int iree_microkernel_mmt4d_f32f32f32_x86_64_avx512f(void* params) {
+  return iree_microkernel_mmt4d_f32f32f32_impl(
+      (const iree_microkernel_mmt4d_params_t*)params,
+      IREE_HAL_PROCESSOR_DATA0_X86_64_AVX2 |
+          IREE_HAL_PROCESSOR_DATA0_X86_64_FMA |
+          IREE_HAL_PROCESSOR_DATA0_X86_64_AVX512F);
+}
+
+#endif  // IREE_ARCH_X86_64
+
+//===----------------------------------------------------------------------===//
+// i8i8i32
+//===----------------------------------------------------------------------===//
+
+typedef void (*iree_microkernel_mmt4d_tile_i8_fn_t)(
+    const int8_t* IREE_RESTRICT lhs, const int8_t* IREE_RESTRICT rhs,
+    int32_t* IREE_RESTRICT out, iree_microkernel_ssize_t k,
+    iree_microkernel_ssize_t m0, iree_microkernel_ssize_t n0,
+    iree_microkernel_ssize_t k0);
+
+static void iree_microkernel_mmt4d_tile_i8_generic(
+    const int8_t* IREE_RESTRICT lhs, const int8_t* IREE_RESTRICT rhs,
+    int32_t* IREE_RESTRICT out, iree_microkernel_ssize_t k,
+    iree_microkernel_ssize_t m0, iree_microkernel_ssize_t n0,
+    iree_microkernel_ssize_t k0) {
+  for (iree_microkernel_ssize_t kk = 0; kk < k; ++kk) {
+    for (iree_microkernel_ssize_t i = 0; i < m0; ++i) {
+      for (iree_microkernel_ssize_t j = 0; j < n0; ++j) {
+        int32_t acc = out[i * n0 + j];
+        for (iree_microkernel_ssize_t l = 0; l < k0; ++l) {
+          acc += (int32_t)lhs[i * k0 + l] * (int32_t)rhs[j * k0 + l];
+        }
+        out[i * n0 + j] = acc;
+      }
+    }
+    lhs += m0 * k0;
+    rhs += n0 * k0;
+  }
+}
+
+#if defined(IREE_ARCH_ARM_64)
+
+// 8x8x1 tile widening the i8 operands to i16 and accumulating with vmlal.
+static void iree_microkernel_mmt4d_tile_i8_8x8x1_neon(
+    const int8_t* IREE_RESTRICT lhs, const int8_t* IREE_RESTRICT rhs,
+    int32_t* IREE_RESTRICT out, iree_microkernel_ssize_t k,
+    iree_microkernel_ssize_t m0, iree_microkernel_ssize_t n0,
+    iree_microkernel_ssize_t k0) {
+  int32x4_t acc[16];
+  for (int i = 0; i < 16; ++i) acc[i] = vld1q_s32(out + i * 4);
+  for (iree_microkernel_ssize_t kk = 0; kk < k; ++kk) {
+    int16x8_t a = vmovl_s8(vld1_s8(lhs));
+    int16x8_t b = vmovl_s8(vld1_s8(rhs));
+    int16x4_t b_lo = vget_low_s16(b);
+    int16x4_t b_hi = vget_high_s16(b);
+    lhs += 8;
+    rhs += 8;
+#define IREE_MMT4D_ROW(row)                                               \
+  acc[2 * (row) + 0] = vmlal_laneq_s16(acc[2 * (row) + 0], b_lo, a, row); \
+  acc[2 * (row) + 1] = vmlal_laneq_s16(acc[2 * (row) + 1], b_hi, a, row);
+    IREE_MMT4D_ROW(0);
+    IREE_MMT4D_ROW(1);
+    IREE_MMT4D_ROW(2);
+    IREE_MMT4D_ROW(3);
+    IREE_MMT4D_ROW(4);
+    IREE_MMT4D_ROW(5);
+    IREE_MMT4D_ROW(6);
+    IREE_MMT4D_ROW(7);
+#undef IREE_MMT4D_ROW
+  }
+  for (int i = 0; i < 16; ++i) vst1q_s32(out + i * 4, acc[i]);
+}
+
+#elif defined(IREE_ARCH_X86_64)
+
+// 8x8x1 tile sign-extending the rhs to i32 lanes and multiplying by each
+// broadcast lhs element.
+IREE_MICROKERNEL_TARGET("avx2")
+static void iree_microkernel_mmt4d_tile_i8_8x8x1_avx2(
+    const int8_t* IREE_RESTRICT lhs, const int8_t* IREE_RESTRICT rhs,
+    int32_t* IREE_RESTRICT out, iree_microkernel_ssize_t k,
+    iree_microkernel_ssize_t m0, iree_microkernel_ssize_t n0,
+    iree_microkernel_ssize_t k0) {
+  __m256i acc[8];
+  for (int i = 0; i < 8; ++i) {
+    acc[i] = _mm256_loadu_si256((const __m256i*)(out + i * 8));
+  }
+  for (iree_microkernel_ssize_t kk = 0; kk < k; ++kk) {
+    __m256i b = _mm256_cvtepi8_epi32(_mm_loadl_epi64((const __m128i*)rhs));
+    for (int i = 0; i < 8; ++i) {
+      acc[i] = _mm256_add_epi32(
+          acc[i], _mm256_mullo_epi32(_mm256_set1_epi32(lhs[i]), b));
+    }
+    lhs += 8;
+    rhs += 8;
+  }
+  for (int i = 0; i < 8; ++i) {
+    _mm256_storeu_si256((__m256i*)(out + i * 8), acc[i]);
+  }
+}
+
+// 8x16x4 tile (the shape the compiler picks for AVX-512 VNNI) using vpdpbusd.
+//
+// vpdpbusd multiplies unsigned lhs bytes by signed rhs bytes so the signed
+// lhs is biased by flipping its sign bit (lhs + 128). The bias adds
+// 128 * sum(rhs) to each result which is tracked per column by a second
+// vpdpbusd against all-ones bytes and subtracted once at the end.
+IREE_MICROKERNEL_TARGET("avx512f,avx512vnni")
+static void iree_microkernel_mmt4d_tile_i8_8x16x4_avx512vnni(
+    const int8_t* IREE_RESTRICT lhs, const int8_t* IREE_RESTRICT rhs,
+    int32_t* IREE_RESTRICT out, iree_microkernel_ssize_t k,
+    iree_microkernel_ssize_t m0, iree_microkernel_ssize_t n0,
+    iree_microkernel_ssize_t k0) {
+  const __m512i sign_bits = _mm512_set1_epi32((int32_t)0x80808080u);
+  const __m512i ones = _mm512_set1_epi32(0x01010101);
+  __m512i acc[8];
+  for (int i = 0; i < 8; ++i) acc[i] = _mm512_loadu_si512(out + i * 16);
+  __m512i rhs_sum = _mm512_setzero_si512();
+  for (iree_microkernel_ssize_t kk = 0; kk < k; ++kk) {
+    __m512i b = _mm512_loadu_si512(rhs);
+    rhs_sum = _mm512_dpbusd_epi32(rhs_sum, ones, b);
+    for (int i = 0; i < 8; ++i) {
+      int32_t lhs_row;
+      memcpy(&lhs_row, lhs + i * 4, sizeof(lhs_row));
+      __m512i a = _mm512_xor_si512(_mm512_set1_epi32(lhs_row), sign_bits);
+      acc[i] = _mm512_dpbusd_epi32(acc[i], a, b);
+    }
+    lhs += 8 * 4;
+    rhs += 16 * 4;
+  }
+  __m512i correction = _mm512_slli_epi32(rhs_sum, 7);
+  for (int i = 0; i < 8; ++i) {
+    _mm512_storeu_si512(out + i * 16, _mm512_sub_epi32(acc[i], correction));
+  }
+}
+
+#endif  // IREE_ARCH_*
+
+// Returns the fastest tile function for the given tile shape that only uses
+// the processor |features| (IREE_HAL_PROCESSOR_DATA0_* bits).
+static iree_microkernel_mmt4d_tile_i8_fn_t
+iree_microkernel_mmt4d_select_tile_i8(iree_microkernel_ssize_t m0,
+                                      iree_microkernel_ssize_t n0,
+                                      iree_microkernel_ssize_t k0,
+                                      uint64_t features) {
+#if defined(IREE_ARCH_ARM_64)
+  if (m0 == 8 && n0 == 8 && k0 == 1) {
+    return iree_microkernel_mmt4d_tile_i8_8x8x1_neon;
+  }
+#elif defined(IREE_ARCH_X86_64)
+  const uint64_t avx512vnni_features =
+      IREE_HAL_PROCESSOR_DATA0_X86_64_AVX512F |
+      IREE_HAL_PROCESSOR_DATA0_X86_64_AVX512VNNI;
+  if (m0 == 8 && n0 == 16 && k0 == 4 &&
+      (features & avx512vnni_features) == avx512vnni_features) {
+    return iree_microkernel_mmt4d_tile_i8_8x16x4_avx512vnni;
+  }
+  if (m0 == 8 && n0 == 8 && k0 == 1 &&
+      (features & IREE_HAL_PROCESSOR_DATA0_X86_64_AVX2)) {
+    return iree_microkernel_mmt4d_tile_i8_8x8x1_avx2;
+  }
+#endif  // IREE_ARCH_*
+  return iree_microkernel_mmt4d_tile_i8_generic;
+}
+
+static int iree_microkernel_mmt4d_i8i8i32_impl(
+    const iree_microkernel_mmt4d_params_t* params, uint64_t features) {
+  iree_microkernel_mmt4d_tile_i8_fn_t tile_fn =
+      iree_microkernel_mmt4d_select_tile_i8(params->m0, params->n0,
+                                            params->k0, features);
+  const iree_microkernel_ssize_t out_tile_size = params->m0 * params->n0;
+  const int8_t* lhs_row = (const int8_t*)params->lhs_buffer;
+  int32_t* out_row = (int32_t*)params->out_buffer;
+  for (iree_microkernel_ssize_t i = 0; i < params->m; ++i) {
+    const int8_t* rhs_row = (const int8_t*)params->rhs_buffer;
+    for (iree_microkernel_ssize_t j = 0; j < params->n; ++j) {
+      tile_fn(lhs_row, rhs_row, out_row + j * out_tile_size, params->k,
+              params->m0, params->n0, params->k0);
+      rhs_row += params->rhs_stride;
+    }
+    lhs_row += params->lhs_stride;
+    out_row += params->out_stride;
+  }
+  return 0;
+}
+
+int iree_microkernel_mmt4d_i8i8i32(void* params) {
+  return iree_microkernel_mmt4d_i8i8i32_impl(
+      (const iree_microkernel_mmt4d_params_t*)params, /*features=*/0);
+}
+
+#if defined(IREE_ARCH_X86_64)
+
+int iree_microkernel_mmt4d_i8i8i32_x86_64_avx2(void* params) {
+  return iree_microkernel_mmt4d_i8i8i32_impl(
+      (const iree_microkernel_mmt4d_params_t*)params,
+      IREE_HAL_PROCESSOR_DATA0_X86_64_AVX2);
+}
+
+int iree_microkernel_mmt4d_i8i8i32_x86_64_avx512vnni(void* params) {
+  return iree_microkernel_mmt4d_i8i8i32_impl(
+      (const iree_microkernel_mmt4d_params_t*)params,
+      IREE_HAL_PROCESSOR_DATA0_X86_64_AVX2 |
+          IREE_HAL_PROCESSOR_DATA0_X86_64_AVX512F |
+          IREE_HAL_PROCESSOR_DATA0_X86_64_AVX512VNNI);
+}
+
+#endif  // IREE_ARCH_X86_64
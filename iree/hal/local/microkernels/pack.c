@@ -0,0 +1,102 @@
+// Copyright 2022 The IREE Authors
+//
+// Licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+#include <string.h>
+
+#include "iree/base/api.h"
+#include "iree/hal/local/microkernels/microkernels.h"
+
+// Packs with |elem_size| byte elements. Full tile rows are copied with memcpy
+// which the compiler turns into a handful of vector moves for the small tile
+// widths used by mmt4d; only the ragged edges pay for the zero fill.
+static void iree_microkernel_pack(const iree_microkernel_pack_params_t* params,
+                                  iree_host_size_t elem_size) {
+  const iree_microkernel_ssize_t tile_size0 = params->tile_size0;
+  const iree_microkernel_ssize_t tile_size1 = params->tile_size1;
+  const iree_microkernel_ssize_t tile_count0 =
+      (params->in_size0 + tile_size0 - 1) / tile_size0;
+  const iree_microkernel_ssize_t tile_count1 =
+      (params->in_size1 + tile_size1 - 1) / tile_size1;
+  const uint8_t* in_buffer = (const uint8_t*)params->in_buffer;
+  uint8_t* out_buffer = (uint8_t*)params->out_buffer;
+  for (iree_microkernel_ssize_t i = 0; i < tile_count0; ++i) {
+    uint8_t* out_tile = out_buffer + i * params->out_stride * elem_size;
+    for (iree_microkernel_ssize_t j = 0; j < tile_count1; ++j) {
+      iree_microkernel_ssize_t col = j * tile_size1;
+      iree_microkernel_ssize_t valid_cols =
+          iree_min(tile_size1, params->in_size1 - col);
+      for (iree_microkernel_ssize_t ii = 0; ii < tile_size0; ++ii) {
+        iree_microkernel_ssize_t row = i * tile_size0 + ii;
+        uint8_t* out_row = out_tile + ii * tile_size1 * elem_size;
+        if (row >= params->in_size0) {
+          memset(out_row, 0, tile_size1 * elem_size);
+          continue;
+        }
+        const uint8_t* in_row =
+            in_buffer + (row * params->in_stride + col) * elem_size;
+        memcpy(out_row, in_row, valid_cols * elem_size);
+        if (valid_cols < tile_size1) {
+          memset(out_row + valid_cols * elem_size, 0,
+                 (tile_size1 - valid_cols) * elem_size);
+        }
+      }
+      out_tile += tile_size0 * tile_size1 * elem_size;
+    }
+  }
+}
+
+static void iree_microkernel_unpack(
+    const iree_microkernel_unpack_params_t* params,
+    iree_host_size_t elem_size) {
+  const iree_microkernel_ssize_t tile_size0 = params->tile_size0;
+  const iree_microkernel_ssize_t tile_size1 = params->tile_size1;
+  const iree_microkernel_ssize_t tile_count0 =
+      (params->out_size0 + tile_size0 - 1) / tile_size0;
+  const iree_microkernel_ssize_t tile_count1 =
+      (params->out_size1 + tile_size1 - 1) / tile_size1;
+  const uint8_t* in_buffer = (const uint8_t*)params->in_buffer;
+  uint8_t* out_buffer = (uint8_t*)params->out_buffer;
+  for (iree_microkernel_ssize_t i = 0; i < tile_count0; ++i) {
+    const uint8_t* in_tile = in_buffer + i * params->in_stride * elem_size;
+    iree_microkernel_ssize_t valid_rows =
+        iree_min(tile_size0, params->out_size0 - i * tile_size0);
+    for (iree_microkernel_ssize_t j = 0; j < tile_count1; ++j) {
+      iree_microkernel_ssize_t col = j * tile_size1;
+      iree_microkernel_ssize_t valid_cols =
+          iree_min(tile_size1, params->out_size1 - col);
+      for (iree_microkernel_ssize_t ii = 0; ii < valid_rows; ++ii) {
+        iree_microkernel_ssize_t row = i * tile_size0 + ii;
+        memcpy(out_buffer + (row * params->out_stride + col) * elem_size,
+               in_tile + ii * tile_size1 * elem_size, valid_cols * elem_size);
+      }
+      in_tile += tile_size0 * tile_size1 * elem_size;
+    }
+  }
+}
+
+int iree_microkernel_pack_x8(void* params) {
+  iree_microkernel_pack((const iree_microkernel_pack_params_t*)params,
+                        sizeof(uint8_t));
+  return 0;
+}
+
+int iree_microkernel_unpack_x8(void* params) {
+  iree_microkernel_unpack((const iree_microkernel_unpack_params_t*)params,
+                          sizeof(uint8_t));
+  return 0;
+}
+
+int iree_microkernel_pack_x32(void* params) {
+  iree_microkernel_pack((const iree_microkernel_pack_params_t*)params,
+                        sizeof(uint32_t));
+  return 0;
+}
+
+int iree_microkernel_unpack_x32(void* params) {
+  iree_microkernel_unpack((const iree_microkernel_unpack_params_t*)params,
+                          sizeof(uint32_t));
+  return 0;
+}
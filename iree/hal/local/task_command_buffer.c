@@ -9,6 +9,7 @@
 #include <stdbool.h>
 #include <stddef.h>
 #include <stdint.h>
+#include <stdio.h>
 #include <string.h>
 
 #include "iree/base/api.h"
@@ -42,6 +43,9 @@ typedef struct iree_hal_task_command_buffer_t {
 
   iree_task_scope_t* scope;
 
+  // Optional table that dispatches record their statistics into on retire.
+  iree_hal_dispatch_statistics_table_t* statistics_table;
+
   // Arena used for all allocations; references the shared device block pool.
   iree_arena_allocator_t arena;
 
@@ -112,7 +116,9 @@ iree_status_t iree_hal_task_command_buffer_create(
     iree_hal_command_buffer_mode_t mode,
     iree_hal_command_category_t command_categories,
     iree_hal_queue_affinity_t queue_affinity,
-    iree_arena_block_pool_t* block_pool, iree_allocator_t host_allocator,
+    iree_arena_block_pool_t* block_pool,
+    iree_hal_dispatch_statistics_table_t* statistics_table,
+    iree_allocator_t host_allocator,
     iree_hal_command_buffer_t** out_command_buffer) {
   IREE_ASSERT_ARGUMENT(out_command_buffer);
   *out_command_buffer = NULL;
@@ -141,6 +147,7 @@ iree_status_t iree_hal_task_command_buffer_create(
         &iree_hal_task_command_buffer_vtable, &command_buffer->base);
     command_buffer->host_allocator = host_allocator;
     command_buffer->scope = scope;
+    command_buffer->statistics_table = statistics_table;
     iree_arena_initialize(block_pool, &command_buffer->arena);
     iree_task_list_initialize(&command_buffer->root_tasks);
     iree_task_list_initialize(&command_buffer->leaf_tasks);
@@ -733,14 +740,12 @@ static iree_status_t iree_hal_task_command_buffer_push_constants(
 //===----------------------------------------------------------------------===//
 // NOTE: command buffer state change only; enqueues no tasks.
 
-static iree_status_t iree_hal_task_command_buffer_push_descriptor_set(
-    iree_hal_command_buffer_t* base_command_buffer,
-    iree_hal_executable_layout_t* executable_layout, uint32_t set,
+// Updates the flattened binding table for |set| with |bindings|.
+// The buffers must be retained in the resource set by the caller.
+static iree_status_t iree_hal_task_command_buffer_update_bindings(
+    iree_hal_task_command_buffer_t* command_buffer, uint32_t set,
     iree_host_size_t binding_count,
     const iree_hal_descriptor_set_binding_t* bindings) {
-  iree_hal_task_command_buffer_t* command_buffer =
-      iree_hal_task_command_buffer_cast(base_command_buffer);
-
   if (IREE_UNLIKELY(set >= IREE_HAL_LOCAL_MAX_DESCRIPTOR_SET_COUNT)) {
     return iree_make_status(IREE_STATUS_INVALID_ARGUMENT,
                             "set %u out of bounds", set);
@@ -756,10 +761,6 @@ static iree_status_t iree_hal_task_command_buffer_push_descriptor_set(
     }
     iree_host_size_t binding_ordinal = binding_base + bindings[i].binding;
 
-    // TODO(benvanik): batch insert by getting the resources in their own list.
-    IREE_RETURN_IF_ERROR(iree_hal_resource_set_insert(
-        command_buffer->resource_set, 1, &bindings[i].buffer));
-
     // TODO(benvanik): track mapping so we can properly map/unmap/flush/etc.
     iree_hal_buffer_mapping_t buffer_mapping = {{0}};
     IREE_RETURN_IF_ERROR(iree_hal_buffer_map_range(
@@ -775,6 +776,24 @@ static iree_status_t iree_hal_task_command_buffer_push_descriptor_set(
   return iree_ok_status();
 }
 
+static iree_status_t iree_hal_task_command_buffer_push_descriptor_set(
+    iree_hal_command_buffer_t* base_command_buffer,
+    iree_hal_executable_layout_t* executable_layout, uint32_t set,
+    iree_host_size_t binding_count,
+    const iree_hal_descriptor_set_binding_t* bindings) {
+  iree_hal_task_command_buffer_t* command_buffer =
+      iree_hal_task_command_buffer_cast(base_command_buffer);
+
+  // TODO(benvanik): batch insert by getting the resources in their own list.
+  for (iree_host_size_t i = 0; i < binding_count; ++i) {
+    IREE_RETURN_IF_ERROR(iree_hal_resource_set_insert(
+        command_buffer->resource_set, 1, &bindings[i].buffer));
+  }
+
+  return iree_hal_task_command_buffer_update_bindings(command_buffer, set,
+                                                      binding_count, bindings);
+}
+
 //===----------------------------------------------------------------------===//
 // iree_hal_command_buffer_bind_descriptor_set
 //===----------------------------------------------------------------------===//
@@ -799,6 +818,11 @@ typedef struct iree_hal_cmd_dispatch_t {
   iree_hal_local_executable_t* executable;
   int32_t ordinal;
 
+  // Table and entry the dispatch statistics are recorded into on retire.
+  // NULL if statistics are not being collected.
+  iree_hal_dispatch_statistics_table_t* statistics_table;
+  iree_host_size_t statistics_index;
+
   // Total number of available 4 byte push constant values in |push_constants|.
   uint16_t push_constant_count;
 
@@ -813,6 +837,13 @@ typedef struct iree_hal_cmd_dispatch_t {
   // - const size_t binding_lengths[binding_count];
 } iree_hal_cmd_dispatch_t;
 
+static_assert((int)IREE_HAL_EXECUTABLE_TILE_ORDER_MORTON ==
+                  (int)IREE_TASK_TILE_ORDER_MORTON,
+              "tile order enums must match");
+static_assert((int)IREE_HAL_EXECUTABLE_TILE_ORDER_SUPER_TILE ==
+                  (int)IREE_TASK_TILE_ORDER_SUPER_TILE,
+              "tile order enums must match");
+
 static iree_status_t iree_hal_cmd_dispatch_tile(
     void* user_context, const iree_task_tile_context_t* tile_context,
     iree_task_submission_t* pending_submission) {
@@ -860,6 +891,49 @@ static iree_status_t iree_hal_cmd_dispatch_tile(
   return status;
 }
 
+// Records the statistics of a dispatch into the command buffer statistics
+// table. Only successful dispatches are recorded.
+static void iree_hal_cmd_dispatch_cleanup(iree_task_t* task,
+                                          iree_status_code_t status_code) {
+#if IREE_STATISTICS_ENABLE
+  if (status_code != IREE_STATUS_OK) return;
+  iree_hal_cmd_dispatch_t* cmd = (iree_hal_cmd_dispatch_t*)task;
+  iree_task_dispatch_statistics_t* statistics = &cmd->task.statistics;
+  iree_hal_dispatch_statistics_table_record(
+      cmd->statistics_table, cmd->statistics_index,
+      iree_atomic_load_int64(&statistics->wall_time_ns,
+                             iree_memory_order_relaxed),
+      (uint64_t)iree_atomic_load_int64(&statistics->tile_count,
+                                       iree_memory_order_relaxed),
+      (uint64_t)iree_atomic_load_int64(&statistics->stolen_tile_count,
+                                       iree_memory_order_relaxed));
+#endif  // IREE_STATISTICS_ENABLE
+}
+
+// Resolves the statistics table entry for |entry_point| of |executable| and
+// attaches the cleanup function that records into it to |cmd|.
+static iree_status_t iree_hal_task_command_buffer_attach_statistics(
+    iree_hal_task_command_buffer_t* command_buffer,
+    iree_hal_local_executable_t* executable, int32_t entry_point,
+    iree_hal_cmd_dispatch_t* cmd) {
+  // Executables without reflection information get a name derived from the
+  // ordinal; these will alias across executables but are better than nothing.
+  char ordinal_name[32];
+  iree_string_view_t export_name = iree_string_view_empty();
+  if (executable->export_names && executable->export_names[entry_point]) {
+    export_name = iree_make_cstring_view(executable->export_names[entry_point]);
+  } else {
+    int length =
+        snprintf(ordinal_name, sizeof(ordinal_name), "<%d>", entry_point);
+    export_name = iree_make_string_view(ordinal_name, length);
+  }
+  IREE_RETURN_IF_ERROR(iree_hal_dispatch_statistics_table_lookup(
+      command_buffer->statistics_table, export_name, &cmd->statistics_index));
+  cmd->statistics_table = command_buffer->statistics_table;
+  iree_task_set_cleanup_fn(&cmd->task.header, iree_hal_cmd_dispatch_cleanup);
+  return iree_ok_status();
+}
+
 static iree_status_t iree_hal_task_command_buffer_build_dispatch(
     iree_hal_command_buffer_t* base_command_buffer,
     iree_hal_executable_t* executable, int32_t entry_point,
@@ -894,6 +968,8 @@ static iree_status_t iree_hal_task_command_buffer_build_dispatch(
 
   cmd->executable = local_executable;
   cmd->ordinal = entry_point;
+  cmd->statistics_table = NULL;
+  cmd->statistics_index = 0;
   cmd->push_constant_count = push_constant_count;
   cmd->binding_count = used_binding_count;
 
@@ -914,6 +990,22 @@ static iree_status_t iree_hal_task_command_buffer_build_dispatch(
                 IREE_HAL_WORKGROUP_LOCAL_MEMORY_PAGE_SIZE
           : 0;
 
+  // Walk the workgroups in the order the compiler preferred for the export.
+  // The HAL and task enums share values; unknown values from newer compilers
+  // are treated as linear.
+  if (local_executable->dispatch_attrs) {
+    iree_hal_executable_tile_order_t tile_order =
+        local_executable->dispatch_attrs[entry_point].tile_order;
+    if (tile_order <= IREE_HAL_EXECUTABLE_TILE_ORDER_SUPER_TILE) {
+      cmd->task.tile_order = (iree_task_tile_order_t)tile_order;
+    }
+  }
+
+  if (command_buffer->statistics_table) {
+    IREE_RETURN_IF_ERROR(iree_hal_task_command_buffer_attach_statistics(
+        command_buffer, local_executable, entry_point, cmd));
+  }
+
   // Copy only the push constant range used by the executable.
   uint8_t* cmd_ptr = (uint8_t*)cmd + sizeof(*cmd);
   uint32_t* push_constants = (uint32_t*)cmd_ptr;
@@ -993,6 +1085,80 @@ static iree_status_t iree_hal_task_command_buffer_dispatch_indirect(
   return iree_ok_status();
 }
 
+//===----------------------------------------------------------------------===//
+// iree_hal_command_buffer_dispatch_batch
+//===----------------------------------------------------------------------===//
+
+// Capacity of the scratch list used to batch resource set insertions. Must be
+// able to hold an executable and a full descriptor set of bindings.
+#define IREE_HAL_TASK_DISPATCH_BATCH_RESOURCE_CAPACITY 64
+static_assert(IREE_HAL_TASK_DISPATCH_BATCH_RESOURCE_CAPACITY >=
+                  1 + IREE_HAL_LOCAL_MAX_DESCRIPTOR_BINDING_COUNT,
+              "must be able to hold all resources of a single dispatch");
+
+static iree_status_t iree_hal_task_command_buffer_dispatch_batch(
+    iree_hal_command_buffer_t* base_command_buffer,
+    iree_host_size_t record_count, const iree_hal_dispatch_record_t* records) {
+  iree_hal_task_command_buffer_t* command_buffer =
+      iree_hal_task_command_buffer_cast(base_command_buffer);
+
+  // Resources referenced by the records are gathered and inserted into the
+  // resource set in chunks instead of one at a time; the resource set has an
+  // MRU cache that makes repeated executables and buffers cheap to insert.
+  const void* resources[IREE_HAL_TASK_DISPATCH_BATCH_RESOURCE_CAPACITY];
+  iree_host_size_t resource_count = 0;
+
+  iree_status_t status = iree_ok_status();
+  for (iree_host_size_t i = 0; i < record_count; ++i) {
+    const iree_hal_dispatch_record_t* record = &records[i];
+    if (IREE_UNLIKELY(record->constant_count >
+                      IREE_HAL_LOCAL_MAX_PUSH_CONSTANT_COUNT) ||
+        IREE_UNLIKELY(record->binding_count >
+                      IREE_HAL_LOCAL_MAX_DESCRIPTOR_BINDING_COUNT)) {
+      status = iree_make_status(IREE_STATUS_INVALID_ARGUMENT,
+                                "dispatch record %zu has too many push "
+                                "constants (%zu) or bindings (%zu)",
+                                i, record->constant_count,
+                                record->binding_count);
+      break;
+    }
+
+    if (resource_count + 1 + record->binding_count >
+        IREE_ARRAYSIZE(resources)) {
+      status = iree_hal_resource_set_insert(command_buffer->resource_set,
+                                            resource_count, resources);
+      resource_count = 0;
+      if (!iree_status_is_ok(status)) break;
+    }
+    resources[resource_count++] = record->executable;
+    for (iree_host_size_t j = 0; j < record->binding_count; ++j) {
+      resources[resource_count++] = record->bindings[j].buffer;
+    }
+
+    memcpy(command_buffer->state.push_constants, record->constants,
+           record->constant_count * sizeof(uint32_t));
+    if (record->binding_count > 0) {
+      status = iree_hal_task_command_buffer_update_bindings(
+          command_buffer, record->set, record->binding_count,
+          record->bindings);
+      if (!iree_status_is_ok(status)) break;
+    }
+
+    iree_hal_cmd_dispatch_t* cmd = NULL;
+    status = iree_hal_task_command_buffer_build_dispatch(
+        base_command_buffer, record->executable, record->entry_point,
+        record->workgroup_count[0], record->workgroup_count[1],
+        record->workgroup_count[2], &cmd);
+    if (!iree_status_is_ok(status)) break;
+  }
+
+  if (iree_status_is_ok(status) && resource_count > 0) {
+    status = iree_hal_resource_set_insert(command_buffer->resource_set,
+                                          resource_count, resources);
+  }
+  return status;
+}
+
 //===----------------------------------------------------------------------===//
 // iree_hal_command_buffer_vtable_t
 //===----------------------------------------------------------------------===//
@@ -1018,4 +1184,5 @@ static const iree_hal_command_buffer_vtable_t
         .bind_descriptor_set = iree_hal_task_command_buffer_bind_descriptor_set,
         .dispatch = iree_hal_task_command_buffer_dispatch,
         .dispatch_indirect = iree_hal_task_command_buffer_dispatch_indirect,
+        .dispatch_batch = iree_hal_task_command_buffer_dispatch_batch,
 };
@@ -41,6 +41,9 @@ typedef struct iree_hal_task_device_t {
   iree_allocator_t host_allocator;
   iree_hal_allocator_t* device_allocator;
 
+  // Per-export dispatch statistics or NULL if not enabled.
+  iree_hal_dispatch_statistics_table_t* statistics_table;
+
   iree_host_size_t queue_count;
   iree_hal_task_queue_t queues[];
 } iree_hal_task_device_t;
@@ -57,6 +60,7 @@ void iree_hal_task_device_params_initialize(
     iree_hal_task_device_params_t* out_params) {
   out_params->arena_block_size = 32 * 1024;
   out_params->queue_count = 8;
+  out_params->dispatch_statistics = false;
 }
 
 static iree_status_t iree_hal_task_device_check_params(
@@ -132,6 +136,13 @@ iree_status_t iree_hal_task_device_create(
     }
   }
 
+#if IREE_STATISTICS_ENABLE
+  if (iree_status_is_ok(status) && params->dispatch_statistics) {
+    status = iree_hal_dispatch_statistics_table_create(
+        host_allocator, &device->statistics_table);
+  }
+#endif  // IREE_STATISTICS_ENABLE
+
   if (iree_status_is_ok(status)) {
     *out_device = (iree_hal_device_t*)device;
   } else {
@@ -149,6 +160,7 @@ static void iree_hal_task_device_destroy(iree_hal_device_t* base_device) {
   for (iree_host_size_t i = 0; i < device->queue_count; ++i) {
     iree_hal_task_queue_deinitialize(&device->queues[i]);
   }
+  iree_hal_dispatch_statistics_table_free(device->statistics_table);
   for (iree_host_size_t i = 0; i < device->loader_count; ++i) {
     iree_hal_executable_loader_release(device->loaders[i]);
   }
@@ -161,6 +173,33 @@ static void iree_hal_task_device_destroy(iree_hal_device_t* base_device) {
   IREE_TRACE_ZONE_END(z0);
 }
 
+iree_status_t iree_hal_task_device_query_dispatch_statistics(
+    iree_hal_device_t* base_device, iree_host_size_t capacity,
+    iree_hal_dispatch_statistics_t* out_statistics,
+    iree_host_size_t* out_count) {
+  iree_hal_task_device_t* device = iree_hal_task_device_cast(base_device);
+  IREE_ASSERT_ARGUMENT(out_count);
+  *out_count = 0;
+  if (!device->statistics_table) {
+    return iree_make_status(IREE_STATUS_FAILED_PRECONDITION,
+                            "device was not created with dispatch statistics "
+                            "enabled");
+  }
+  return iree_hal_dispatch_statistics_table_query(
+      device->statistics_table, capacity, out_statistics, out_count);
+}
+
+iree_status_t iree_hal_task_device_fprint_dispatch_statistics(
+    FILE* file, iree_hal_device_t* base_device) {
+  if (!iree_hal_resource_is(base_device, &iree_hal_task_device_vtable)) {
+    return iree_ok_status();
+  }
+  iree_hal_task_device_t* device = iree_hal_task_device_cast(base_device);
+  if (!device->statistics_table) return iree_ok_status();
+  return iree_hal_dispatch_statistics_table_fprint(file,
+                                                   device->statistics_table);
+}
+
 static iree_string_view_t iree_hal_task_device_id(
     iree_hal_device_t* base_device) {
   iree_hal_task_device_t* device = iree_hal_task_device_cast(base_device);
@@ -233,8 +272,8 @@ static iree_status_t iree_hal_task_device_create_command_buffer(
       device, command_categories, queue_affinity);
   return iree_hal_task_command_buffer_create(
       base_device, &device->queues[queue_index].scope, mode, command_categories,
-      queue_affinity, &device->large_block_pool, device->host_allocator,
-      out_command_buffer);
+      queue_affinity, &device->large_block_pool, device->statistics_table,
+      device->host_allocator, out_command_buffer);
 }
 
 static iree_status_t iree_hal_task_device_create_descriptor_set(
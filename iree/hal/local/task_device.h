@@ -7,8 +7,11 @@
 #ifndef IREE_HAL_LOCAL_TASK_DEVICE_H_
 #define IREE_HAL_LOCAL_TASK_DEVICE_H_
 
+#include <stdio.h>
+
 #include "iree/base/api.h"
 #include "iree/hal/api.h"
+#include "iree/hal/local/dispatch_statistics.h"
 #include "iree/hal/local/executable_loader.h"
 #include "iree/task/executor.h"
 
@@ -28,6 +31,12 @@ typedef struct iree_hal_task_device_params_t {
   // Larger sizes will lower overhead and ensure the heap isn't hit for
   // transient allocations while also increasing memory consumption.
   iree_host_size_t arena_block_size;
+
+  // Collects per-export dispatch statistics (invocation counts, wall time, and
+  // workgroup distribution) that can be queried with
+  // iree_hal_task_device_query_dispatch_statistics. Adds a small amount of
+  // overhead to each dispatch and requires IREE_STATISTICS_ENABLE.
+  bool dispatch_statistics;
 } iree_hal_task_device_params_t;
 
 // Initializes |out_params| to default values.
@@ -44,6 +53,23 @@ iree_status_t iree_hal_task_device_create(
     iree_hal_allocator_t* device_allocator, iree_allocator_t host_allocator,
     iree_hal_device_t** out_device);
 
+// Copies up to |capacity| per-export dispatch statistics entries from |device|
+// into |out_statistics| and returns the total entry count in |out_count|.
+// Returns IREE_STATUS_OUT_OF_RANGE if |capacity| is too small and
+// IREE_STATUS_FAILED_PRECONDITION if the device was not created with
+// dispatch statistics enabled. Entry names remain valid for the lifetime of the
+// device.
+iree_status_t iree_hal_task_device_query_dispatch_statistics(
+    iree_hal_device_t* device, iree_host_size_t capacity,
+    iree_hal_dispatch_statistics_t* out_statistics,
+    iree_host_size_t* out_count);
+
+// Prints the per-export dispatch statistics of |device| to |file|.
+// No-op if |device| is not a task device or was not created with dispatch
+// statistics enabled.
+iree_status_t iree_hal_task_device_fprint_dispatch_statistics(
+    FILE* file, iree_hal_device_t* device);
+
 #ifdef __cplusplus
 }  // extern "C"
 #endif  // __cplusplus
@@ -22,6 +22,10 @@
 // in the future but right now guards the stack from blowing up during calls.
 #define IREE_HAL_MODULE_MAX_DESCRIPTOR_BINDING_COUNT ((iree_host_size_t)32)
 
+// Size of the stack storage used to decode dispatch batches. Batches larger
+// than this are decoded into heap storage.
+#define IREE_HAL_MODULE_DISPATCH_BATCH_STACK_SIZE ((iree_host_size_t)4096)
+
 //===----------------------------------------------------------------------===//
 // Type registration
 //===----------------------------------------------------------------------===//
@@ -1065,6 +1069,225 @@ IREE_VM_ABI_EXPORT(iree_hal_module_command_buffer_dispatch,  //
                                           workgroup_z);
 }
 
+// Register-level implementations of the hot command buffer recording calls.
+// Bytecode callers invoke these with their register file directly such that
+// no argument buffers are marshaled per call. The flattened argument ordering
+// matches the calling convention of the corresponding IREE_VM_ABI_EXPORT.
+
+static iree_status_t iree_hal_module_check_register_call(
+    const iree_vm_register_call_t* call, iree_host_size_t argument_count) {
+  if (IREE_UNLIKELY(call->arguments->size != argument_count)) {
+    return iree_make_status(IREE_STATUS_INVALID_ARGUMENT,
+                            "argument/result signature mismatch");
+  }
+  return iree_ok_status();
+}
+
+// rriiii -> v
+static iree_status_t iree_hal_module_command_buffer_dispatch_registers(
+    iree_vm_stack_t* IREE_RESTRICT stack, void* IREE_RESTRICT module,
+    iree_hal_module_state_t* IREE_RESTRICT state,
+    const iree_vm_register_call_t* IREE_RESTRICT call,
+    iree_vm_execution_result_t* IREE_RESTRICT out_result) {
+  IREE_RETURN_IF_ERROR(iree_hal_module_check_register_call(call, 6));
+  iree_hal_command_buffer_t* command_buffer = NULL;
+  IREE_RETURN_IF_ERROR(iree_hal_command_buffer_check_deref(
+      *iree_vm_register_call_arg_ref(call, 0), &command_buffer));
+  iree_hal_executable_t* executable = NULL;
+  IREE_RETURN_IF_ERROR(iree_hal_executable_check_deref(
+      *iree_vm_register_call_arg_ref(call, 1), &executable));
+  return iree_hal_command_buffer_dispatch(
+      command_buffer, executable,
+      (uint32_t)iree_vm_register_call_arg_i32(call, 2),
+      (uint32_t)iree_vm_register_call_arg_i32(call, 3),
+      (uint32_t)iree_vm_register_call_arg_i32(call, 4),
+      (uint32_t)iree_vm_register_call_arg_i32(call, 5));
+}
+
+// rriCiD -> v
+static iree_status_t iree_hal_module_command_buffer_push_constants_registers(
+    iree_vm_stack_t* IREE_RESTRICT stack, void* IREE_RESTRICT module,
+    iree_hal_module_state_t* IREE_RESTRICT state,
+    const iree_vm_register_call_t* IREE_RESTRICT call,
+    iree_vm_execution_result_t* IREE_RESTRICT out_result) {
+  iree_host_size_t value_count = iree_vm_register_call_segment_size(call, 3);
+  IREE_RETURN_IF_ERROR(
+      iree_hal_module_check_register_call(call, 3 + value_count));
+  iree_hal_command_buffer_t* command_buffer = NULL;
+  IREE_RETURN_IF_ERROR(iree_hal_command_buffer_check_deref(
+      *iree_vm_register_call_arg_ref(call, 0), &command_buffer));
+  iree_hal_executable_layout_t* executable_layout = NULL;
+  IREE_RETURN_IF_ERROR(iree_hal_executable_layout_check_deref(
+      *iree_vm_register_call_arg_ref(call, 1), &executable_layout));
+  iree_vm_size_t offset =
+      (iree_vm_size_t)iree_vm_register_call_arg_i32(call, 2);
+
+  // Values are scattered across registers and must be gathered.
+  uint32_t* values = (uint32_t*)iree_alloca(value_count * sizeof(uint32_t));
+  for (iree_host_size_t i = 0; i < value_count; ++i) {
+    values[i] = (uint32_t)iree_vm_register_call_arg_i32(call, 3 + i);
+  }
+
+  return iree_hal_command_buffer_push_constants(
+      command_buffer, executable_layout, offset * sizeof(uint32_t), values,
+      value_count * sizeof(uint32_t));
+}
+
+// rriCiriiD -> v
+static iree_status_t
+iree_hal_module_command_buffer_push_descriptor_set_registers(
+    iree_vm_stack_t* IREE_RESTRICT stack, void* IREE_RESTRICT module,
+    iree_hal_module_state_t* IREE_RESTRICT state,
+    const iree_vm_register_call_t* IREE_RESTRICT call,
+    iree_vm_execution_result_t* IREE_RESTRICT out_result) {
+  iree_host_size_t binding_count = iree_vm_register_call_segment_size(call, 3);
+  if (IREE_UNLIKELY(binding_count >
+                    IREE_HAL_MODULE_MAX_DESCRIPTOR_BINDING_COUNT)) {
+    return iree_make_status(IREE_STATUS_OUT_OF_RANGE, "binding count %zu > %zu",
+                            binding_count,
+                            IREE_HAL_MODULE_MAX_DESCRIPTOR_BINDING_COUNT);
+  }
+  IREE_RETURN_IF_ERROR(
+      iree_hal_module_check_register_call(call, 3 + binding_count * 4));
+  iree_hal_command_buffer_t* command_buffer = NULL;
+  IREE_RETURN_IF_ERROR(iree_hal_command_buffer_check_deref(
+      *iree_vm_register_call_arg_ref(call, 0), &command_buffer));
+  iree_hal_executable_layout_t* executable_layout = NULL;
+  IREE_RETURN_IF_ERROR(iree_hal_executable_layout_check_deref(
+      *iree_vm_register_call_arg_ref(call, 1), &executable_layout));
+  iree_vm_size_t set = (iree_vm_size_t)iree_vm_register_call_arg_i32(call, 2);
+
+  iree_hal_descriptor_set_binding_t* bindings =
+      (iree_hal_descriptor_set_binding_t*)iree_alloca(
+          binding_count * sizeof(iree_hal_descriptor_set_binding_t));
+  for (iree_host_size_t i = 0, arg_i = 3; i < binding_count; ++i, arg_i += 4) {
+    IREE_RETURN_IF_ERROR(iree_hal_buffer_check_deref(
+        *iree_vm_register_call_arg_ref(call, arg_i + 1), &bindings[i].buffer));
+    bindings[i].binding = (uint32_t)iree_vm_register_call_arg_i32(call, arg_i);
+    bindings[i].offset =
+        (iree_device_size_t)iree_vm_register_call_arg_i32(call, arg_i + 2);
+    bindings[i].length =
+        (iree_device_size_t)iree_vm_register_call_arg_i32(call, arg_i + 3);
+  }
+
+  return iree_hal_command_buffer_push_descriptor_set(
+      command_buffer, executable_layout, set, binding_count, bindings);
+}
+
+// Dispatch records are encoded as a flat list of (r, i, i, i, i) tuples:
+//   <executable_layout or null, set, constant_count, binding_count,
+//    entry_point>
+//   <executable, workgroup_x, workgroup_y, workgroup_z, 0>
+//   ceil(constant_count / 4) x <null, c0, c1, c2, c3>
+//   binding_count x <buffer, binding, offset, length, 0>
+IREE_VM_ABI_EXPORT(iree_hal_module_command_buffer_dispatch_batch,  //
+                   iree_hal_module_state_t,                        //
+                   rCriiiiD, v) {
+  iree_hal_command_buffer_t* command_buffer = NULL;
+  IREE_RETURN_IF_ERROR(
+      iree_hal_command_buffer_check_deref(args->r0, &command_buffer));
+  iree_host_size_t tuple_count = args->a1_count;
+  const iree_vm_abi_riiii_t* tuples = args->a1;
+
+  // Walk the records once to size the storage for the decoded records.
+  iree_host_size_t record_count = 0;
+  iree_host_size_t total_constant_count = 0;
+  iree_host_size_t total_binding_count = 0;
+  for (iree_host_size_t i = 0; i < tuple_count;) {
+    if (IREE_UNLIKELY(tuples[i].i2 < 0 || tuples[i].i3 < 0)) {
+      return iree_make_status(IREE_STATUS_INVALID_ARGUMENT,
+                              "dispatch record %zu has negative counts",
+                              record_count);
+    }
+    iree_host_size_t constant_count = (iree_host_size_t)tuples[i].i2;
+    iree_host_size_t binding_count = (iree_host_size_t)tuples[i].i3;
+    iree_host_size_t record_tuple_count =
+        2 + (constant_count + 3) / 4 + binding_count;
+    if (IREE_UNLIKELY(record_tuple_count > tuple_count - i)) {
+      return iree_make_status(IREE_STATUS_INVALID_ARGUMENT,
+                              "dispatch record %zu is truncated", record_count);
+    }
+    ++record_count;
+    total_constant_count += constant_count;
+    total_binding_count += binding_count;
+    i += record_tuple_count;
+  }
+  if (record_count == 0) return iree_ok_status();
+
+  // Small batches (the common case) are decoded on the stack to keep the
+  // per-call overhead low.
+  uint64_t stack_storage[IREE_HAL_MODULE_DISPATCH_BATCH_STACK_SIZE /
+                         sizeof(uint64_t)];
+  iree_hal_dispatch_record_t* records = NULL;
+  iree_host_size_t total_size =
+      record_count * sizeof(*records) +
+      total_binding_count * sizeof(iree_hal_descriptor_set_binding_t) +
+      total_constant_count * sizeof(uint32_t);
+  if (total_size <= sizeof(stack_storage)) {
+    records = (iree_hal_dispatch_record_t*)stack_storage;
+  } else {
+    IREE_RETURN_IF_ERROR(iree_allocator_malloc(
+        state->host_allocator, total_size, (void**)&records));
+  }
+  iree_hal_descriptor_set_binding_t* bindings =
+      (iree_hal_descriptor_set_binding_t*)(records + record_count);
+  uint32_t* constants = (uint32_t*)(bindings + total_binding_count);
+
+  iree_status_t status = iree_ok_status();
+  iree_host_size_t t = 0;
+  for (iree_host_size_t r = 0; r < record_count && iree_status_is_ok(status);
+       ++r) {
+    iree_hal_dispatch_record_t* record = &records[r];
+    const iree_vm_abi_riiii_t* header = &tuples[t++];
+    const iree_vm_abi_riiii_t* dispatch = &tuples[t++];
+    record->executable_layout = NULL;
+    if (header->r0.ptr) {
+      status = iree_hal_executable_layout_check_deref(
+          header->r0, &record->executable_layout);
+      if (!iree_status_is_ok(status)) break;
+    }
+    record->set = (uint32_t)header->i1;
+    record->constant_count = (iree_host_size_t)header->i2;
+    record->binding_count = (iree_host_size_t)header->i3;
+    record->entry_point = header->i4;
+    status = iree_hal_executable_check_deref(dispatch->r0, &record->executable);
+    if (!iree_status_is_ok(status)) break;
+    record->workgroup_count[0] = (uint32_t)dispatch->i1;
+    record->workgroup_count[1] = (uint32_t)dispatch->i2;
+    record->workgroup_count[2] = (uint32_t)dispatch->i3;
+
+    record->constants = constants;
+    for (iree_host_size_t i = 0; i < record->constant_count; i += 4) {
+      const iree_vm_abi_riiii_t* chunk = &tuples[t++];
+      uint32_t values[4] = {(uint32_t)chunk->i1, (uint32_t)chunk->i2,
+                            (uint32_t)chunk->i3, (uint32_t)chunk->i4};
+      iree_host_size_t chunk_count = iree_min(4, record->constant_count - i);
+      memcpy(constants, values, chunk_count * sizeof(uint32_t));
+      constants += chunk_count;
+    }
+
+    record->bindings = bindings;
+    for (iree_host_size_t i = 0; i < record->binding_count; ++i) {
+      const iree_vm_abi_riiii_t* binding = &tuples[t++];
+      status = iree_hal_buffer_check_deref(binding->r0, &bindings->buffer);
+      if (!iree_status_is_ok(status)) break;
+      bindings->binding = (uint32_t)binding->i1;
+      bindings->offset = (iree_device_size_t)binding->i2;
+      bindings->length = (iree_device_size_t)binding->i3;
+      ++bindings;
+    }
+  }
+
+  if (iree_status_is_ok(status)) {
+    status = iree_hal_command_buffer_dispatch_batch(command_buffer,
+                                                    record_count, records);
+  }
+  if ((void*)records != (void*)stack_storage) {
+    iree_allocator_free(state->host_allocator, records);
+  }
+  return status;
+}
+
 IREE_VM_ABI_EXPORT(iree_hal_module_command_buffer_dispatch_indirect,  //
                    iree_hal_module_state_t,                           //
                    rriri, v) {
@@ -1333,23 +1556,92 @@ IREE_VM_ABI_EXPORT(iree_hal_module_semaphore_fail,  //
   return iree_ok_status();
 }
 
+// Wait source control function for a semaphore reaching a payload value.
+// |wait_source.self| is the semaphore and |wait_source.data| the value. The
+// semaphore is not retained and must remain live while the source is in use.
+static iree_status_t IREE_API_PTR iree_hal_module_semaphore_wait_source_ctl(
+    iree_wait_source_t wait_source, iree_wait_source_command_t command,
+    const void* params, void** inout_ptr) {
+  iree_hal_semaphore_t* semaphore = (iree_hal_semaphore_t*)wait_source.self;
+  uint64_t value = wait_source.data;
+  switch (command) {
+    case IREE_WAIT_SOURCE_COMMAND_QUERY: {
+      iree_status_code_t* out_wait_status_code = (iree_status_code_t*)inout_ptr;
+      uint64_t current_value = 0;
+      iree_status_t status =
+          iree_hal_semaphore_query(semaphore, &current_value);
+      if (!iree_status_is_ok(status)) {
+        *out_wait_status_code = iree_status_consume_code(status);
+      } else {
+        *out_wait_status_code = current_value >= value ? IREE_STATUS_OK
+                                                       : IREE_STATUS_DEFERRED;
+      }
+      return iree_ok_status();
+    }
+    case IREE_WAIT_SOURCE_COMMAND_WAIT_ONE:
+      return iree_hal_semaphore_wait(
+          semaphore, value,
+          ((const iree_wait_source_wait_params_t*)params)->timeout);
+    case IREE_WAIT_SOURCE_COMMAND_EXPORT:
+      return iree_make_status(IREE_STATUS_UNAVAILABLE,
+                              "semaphore wait sources cannot be exported");
+    default:
+      return iree_make_status(IREE_STATUS_UNIMPLEMENTED,
+                              "unhandled wait source command");
+  }
+}
+
+// Polls |semaphore| for |value| without blocking.
+// Returns IREE_STATUS_DEFERRED with a wait source for the value in
+// |out_wait_source| if it has not yet been reached.
+static iree_status_t iree_hal_module_semaphore_poll(
+    iree_hal_semaphore_t* semaphore, uint64_t value,
+    iree_wait_source_t* out_wait_source) {
+  iree_status_t status =
+      iree_hal_semaphore_wait(semaphore, value, iree_immediate_timeout());
+  if (iree_status_is_deadline_exceeded(status)) {
+    iree_status_ignore(status);
+    out_wait_source->self = semaphore;
+    out_wait_source->data = value;
+    out_wait_source->ctl = iree_hal_module_semaphore_wait_source_ctl;
+    return iree_status_from_code(IREE_STATUS_DEFERRED);
+  }
+  return status;
+}
+
+// The packed ABI has no execution result to carry the wait source and callers
+// resuming after a yield poll again. Bytecode callers use the register-level
+// variant below and block on the semaphore instead.
 IREE_VM_ABI_EXPORT(iree_hal_module_semaphore_await,  //
                    iree_hal_module_state_t,          //
                    ri, i) {
   iree_hal_semaphore_t* semaphore = NULL;
   IREE_RETURN_IF_ERROR(iree_hal_semaphore_check_deref(args->r0, &semaphore));
   uint64_t new_value = (uint32_t)args->i1;
+  iree_wait_source_t wait_source;
+  IREE_RETURN_IF_ERROR(
+      iree_hal_module_semaphore_poll(semaphore, new_value, &wait_source));
+  rets->i0 = 0;
+  return iree_ok_status();
+}
 
-  // TODO(benvanik): coroutine magic.
-  iree_status_t status =
-      iree_hal_semaphore_wait(semaphore, new_value, iree_infinite_timeout());
-  if (iree_status_is_ok(status)) {
-    rets->i0 = 0;
-  } else if (iree_status_is_deadline_exceeded(status)) {
-    // Propagate deadline exceeded back to the VM.
-    rets->i0 = (int32_t)iree_status_consume_code(status);
-  }
-  return status;
+// ri -> i
+static iree_status_t iree_hal_module_semaphore_await_registers(
+    iree_vm_stack_t* IREE_RESTRICT stack, void* IREE_RESTRICT module,
+    iree_hal_module_state_t* IREE_RESTRICT state,
+    const iree_vm_register_call_t* IREE_RESTRICT call,
+    iree_vm_execution_result_t* IREE_RESTRICT out_result) {
+  IREE_RETURN_IF_ERROR(iree_hal_module_check_register_call(call, 2));
+  iree_hal_semaphore_t* semaphore = NULL;
+  IREE_RETURN_IF_ERROR(iree_hal_semaphore_check_deref(
+      *iree_vm_register_call_arg_ref(call, 0), &semaphore));
+  uint64_t new_value = (uint32_t)iree_vm_register_call_arg_i32(call, 1);
+  // The semaphore stays live in the caller register while the call is pending
+  // as the import is reissued with the same operands when resumed.
+  IREE_RETURN_IF_ERROR(iree_hal_module_semaphore_poll(
+      semaphore, new_value, &out_result->wait_source));
+  iree_vm_register_call_set_i32(call, 0, 0);
+  return iree_ok_status();
 }
 
 //===----------------------------------------------------------------------===//
@@ -1368,6 +1660,26 @@ static const iree_vm_native_function_ptr_t iree_hal_module_funcs_[] = {
 #undef EXPORT_FN
 };
 
+// Export ordinals used to index the register function table.
+enum iree_hal_module_export_ordinal_e {
+#define EXPORT_FN(name, target_fn, arg_types, ret_types) target_fn##_ordinal,
+#include "iree/modules/hal/exports.inl"  // IWYU pragma: keep
+#undef EXPORT_FN
+};
+
+// Register-level implementations; exports without one use the shims above.
+static const iree_vm_native_register_function_t
+    iree_hal_module_register_funcs_[IREE_ARRAYSIZE(iree_hal_module_funcs_)] = {
+#define REGISTER_FN(target_fn) \
+  [target_fn##_ordinal] =  \
+      (iree_vm_native_register_function_t)target_fn##_registers,
+    REGISTER_FN(iree_hal_module_command_buffer_dispatch)
+    REGISTER_FN(iree_hal_module_command_buffer_push_constants)
+    REGISTER_FN(iree_hal_module_command_buffer_push_descriptor_set)
+    REGISTER_FN(iree_hal_module_semaphore_await)
+#undef REGISTER_FN
+};
+
 // NOTE: 0 length, but can't express that in C.
 static const iree_vm_native_import_descriptor_t iree_hal_module_imports_[1];
 
@@ -1397,6 +1709,7 @@ static const iree_vm_native_module_descriptor_t iree_hal_module_descriptor_ = {
     .functions = iree_hal_module_funcs_,
     .reflection_attr_count = 0,
     .reflection_attrs = NULL,
+    .register_functions = iree_hal_module_register_funcs_,
 };
 
 IREE_API_EXPORT iree_status_t
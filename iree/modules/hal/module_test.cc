@@ -0,0 +1,158 @@
+// Copyright 2022 The IREE Authors
+//
+// Licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+#include "iree/modules/hal/module.h"
+
+#include <cstring>
+
+#include "iree/base/api.h"
+#include "iree/hal/api.h"
+#include "iree/hal/local/sync_device.h"
+#include "iree/testing/gtest.h"
+#include "iree/testing/status_matchers.h"
+#include "iree/vm/api.h"
+
+namespace {
+
+using iree::Status;
+using iree::StatusCode;
+using iree::testing::status::StatusIs;
+
+class HALModuleTest : public ::testing::Test {
+ protected:
+  virtual void SetUp() {
+    IREE_CHECK_OK(iree_hal_module_register_types());
+    IREE_CHECK_OK(iree_vm_instance_create(iree_allocator_system(), &instance_));
+
+    iree_string_view_t identifier = iree_make_cstring_view("sync");
+    iree_hal_allocator_t* device_allocator = NULL;
+    IREE_CHECK_OK(iree_hal_allocator_create_heap(
+        identifier, iree_allocator_system(), iree_allocator_system(),
+        &device_allocator));
+    iree_hal_sync_device_params_t params;
+    iree_hal_sync_device_params_initialize(&params);
+    IREE_CHECK_OK(iree_hal_sync_device_create(
+        identifier, &params, /*loader_count=*/0, /*loaders=*/NULL,
+        device_allocator, iree_allocator_system(), &device_));
+    iree_hal_allocator_release(device_allocator);
+
+    iree_vm_module_t* module = NULL;
+    IREE_CHECK_OK(
+        iree_hal_module_create(device_, iree_allocator_system(), &module));
+    IREE_CHECK_OK(iree_vm_context_create_with_modules(
+        instance_, IREE_VM_CONTEXT_FLAG_NONE, &module, 1,
+        iree_allocator_system(), &context_));
+    iree_vm_module_release(module);
+
+    IREE_CHECK_OK(iree_hal_semaphore_create(device_, 0ull, &semaphore_));
+  }
+
+  virtual void TearDown() {
+    iree_hal_semaphore_release(semaphore_);
+    iree_vm_context_release(context_);
+    iree_hal_device_release(device_);
+    iree_vm_instance_release(instance_);
+  }
+
+  iree_vm_function_t ResolveFunction(const char* name) {
+    iree_vm_function_t function;
+    IREE_CHECK_OK(iree_vm_context_resolve_function(
+        context_, iree_make_cstring_view(name), &function));
+    return function;
+  }
+
+  iree_vm_instance_t* instance_ = NULL;
+  iree_hal_device_t* device_ = NULL;
+  iree_vm_context_t* context_ = NULL;
+  iree_hal_semaphore_t* semaphore_ = NULL;
+};
+
+// Awaiting an unsignaled semaphore yields instead of blocking and the
+// invocation completes once resumed after the semaphore is signaled.
+TEST_F(HALModuleTest, SemaphoreAwaitYields) {
+  iree_vm_list_t* inputs = NULL;
+  IREE_ASSERT_OK(iree_vm_list_create(/*element_type=*/NULL, 2,
+                                     iree_allocator_system(), &inputs));
+  iree_vm_ref_t semaphore_ref = iree_hal_semaphore_retain_ref(semaphore_);
+  IREE_ASSERT_OK(iree_vm_list_push_ref_move(inputs, &semaphore_ref));
+  iree_vm_value_t value = iree_vm_value_make_i32(1);
+  IREE_ASSERT_OK(iree_vm_list_push_value(inputs, &value));
+  iree_vm_invocation_t* invocation = NULL;
+  IREE_ASSERT_OK(iree_vm_invocation_create(
+      context_, ResolveFunction("hal.semaphore.await"),
+      IREE_VM_INVOCATION_FLAG_NONE, /*policy=*/NULL, inputs,
+      iree_allocator_system(), &invocation));
+  iree_vm_list_release(inputs);
+
+  IREE_ASSERT_OK(iree_vm_invocation_resume(invocation));
+  EXPECT_THAT(Status(iree_vm_invocation_query_status(invocation)),
+              StatusIs(StatusCode::kUnavailable));
+
+  IREE_ASSERT_OK(iree_hal_semaphore_signal(semaphore_, 1ull));
+  IREE_ASSERT_OK(iree_vm_invocation_resume(invocation));
+  IREE_ASSERT_OK(iree_vm_invocation_query_status(invocation));
+  const iree_vm_list_t* outputs = iree_vm_invocation_output(invocation);
+  ASSERT_NE(outputs, nullptr);
+  IREE_ASSERT_OK(iree_vm_list_get_value(outputs, 0, &value));
+  EXPECT_EQ(value.i32, 0);
+
+  iree_vm_invocation_release(invocation);
+}
+
+// Register-level awaits from bytecode yield with a wait source on the
+// semaphore that resolves once it is signaled.
+TEST_F(HALModuleTest, SemaphoreAwaitRegistersWaitSource) {
+  iree_vm_function_t function = ResolveFunction("hal.semaphore.await");
+  iree_vm_native_register_function_t register_function = NULL;
+  ASSERT_TRUE(iree_vm_native_module_resolve_register_export(
+      &function, &register_function));
+
+  int32_t i32_registers[2] = {0, 1};
+  iree_vm_ref_t ref_registers[1];
+  memset(ref_registers, 0, sizeof(ref_registers));
+  ref_registers[0] = iree_hal_semaphore_retain_ref(semaphore_);
+  struct {
+    uint16_t size;
+    uint16_t registers[2];
+  } src_reg_list = {2, {0, 1}};
+  struct {
+    uint16_t size;
+    uint16_t registers[1];
+  } dst_reg_list = {1, {0}};
+  iree_vm_register_call_t call;
+  memset(&call, 0, sizeof(call));
+  call.i32_mask = 1;
+  call.i32 = i32_registers;
+  call.ref_mask = 0;
+  call.ref = ref_registers;
+  call.arguments = (const iree_vm_register_list_t*)&src_reg_list;
+  call.results = (const iree_vm_register_list_t*)&dst_reg_list;
+  i32_registers[0] = -1;
+
+  IREE_VM_INLINE_STACK_INITIALIZE(stack, IREE_VM_INVOCATION_FLAG_NONE,
+                                  iree_vm_context_state_resolver(context_),
+                                  iree_allocator_system());
+  iree_vm_execution_result_t result;
+  EXPECT_THAT(Status(iree_vm_native_module_issue_register_call(
+                  &function, register_function, stack, &call, &result)),
+              StatusIs(StatusCode::kDeferred));
+  ASSERT_FALSE(iree_wait_source_is_immediate(result.wait_source));
+  iree_status_code_t wait_status_code = IREE_STATUS_OK;
+  IREE_ASSERT_OK(iree_wait_source_query(result.wait_source, &wait_status_code));
+  EXPECT_EQ(wait_status_code, IREE_STATUS_DEFERRED);
+
+  IREE_ASSERT_OK(iree_hal_semaphore_signal(semaphore_, 1ull));
+  IREE_ASSERT_OK(iree_wait_source_query(result.wait_source, &wait_status_code));
+  EXPECT_EQ(wait_status_code, IREE_STATUS_OK);
+  IREE_ASSERT_OK(iree_vm_native_module_issue_register_call(
+      &function, register_function, stack, &call, &result));
+  EXPECT_EQ(i32_registers[0], 0);
+
+  iree_vm_stack_deinitialize(stack);
+  iree_vm_ref_release(&ref_registers[0]);
+}
+
+}  // namespace
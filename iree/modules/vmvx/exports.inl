@@ -23,6 +23,38 @@
 
 // clang-format off
 
-EXPORT_FN("_placeholder", iree_vmvx_module_placeholder, v, v)
+EXPORT_FN("abs.2d.f32", iree_vmvx_module_abs_2d_f32, riiiriiiii, v)
+EXPORT_FN("add.2d.f32", iree_vmvx_module_add_2d_f32, riiiriiiriiiii, v)
+EXPORT_FN("add.2d.i32", iree_vmvx_module_add_2d_i32, riiiriiiriiiii, v)
+EXPORT_FN("and.2d.i32", iree_vmvx_module_and_2d_i32, riiiriiiriiiii, v)
+EXPORT_FN("ceil.2d.f32", iree_vmvx_module_ceil_2d_f32, riiiriiiii, v)
+EXPORT_FN("copy.2d.x16", iree_vmvx_module_copy_2d_x16, riiiriiiii, v)
+EXPORT_FN("copy.2d.x32", iree_vmvx_module_copy_2d_x32, riiiriiiii, v)
+EXPORT_FN("copy.2d.x64", iree_vmvx_module_copy_2d_x64, riiiriiiii, v)
+EXPORT_FN("copy.2d.x8", iree_vmvx_module_copy_2d_x8, riiiriiiii, v)
+EXPORT_FN("div.2d.f32", iree_vmvx_module_div_2d_f32, riiiriiiriiiii, v)
+EXPORT_FN("exp.2d.f32", iree_vmvx_module_exp_2d_f32, riiiriiiii, v)
+EXPORT_FN("fill.2d.x32", iree_vmvx_module_fill_2d_x32, iriiiii, v)
+EXPORT_FN("floor.2d.f32", iree_vmvx_module_floor_2d_f32, riiiriiiii, v)
+EXPORT_FN("log.2d.f32", iree_vmvx_module_log_2d_f32, riiiriiiii, v)
+EXPORT_FN("matmul.f32f32f32", iree_vmvx_module_matmul_f32f32f32, riiiriiiriiiiii, v)
+EXPORT_FN("matmul.i8i8i32", iree_vmvx_module_matmul_i8i8i32, riiiriiiriiiiii, v)
+EXPORT_FN("max.2d.f32", iree_vmvx_module_max_2d_f32, riiiriiiriiiii, v)
+EXPORT_FN("min.2d.f32", iree_vmvx_module_min_2d_f32, riiiriiiriiiii, v)
+EXPORT_FN("mmt4d.f32f32f32", iree_vmvx_module_mmt4d_f32f32f32, riiriiriiiiiiii, v)
+EXPORT_FN("mmt4d.i8i8i32", iree_vmvx_module_mmt4d_i8i8i32, riiriiriiiiiiii, v)
+EXPORT_FN("mul.2d.f32", iree_vmvx_module_mul_2d_f32, riiiriiiriiiii, v)
+EXPORT_FN("mul.2d.i32", iree_vmvx_module_mul_2d_i32, riiiriiiriiiii, v)
+EXPORT_FN("neg.2d.f32", iree_vmvx_module_neg_2d_f32, riiiriiiii, v)
+EXPORT_FN("or.2d.i32", iree_vmvx_module_or_2d_i32, riiiriiiriiiii, v)
+EXPORT_FN("reduce.max.2d.f32", iree_vmvx_module_reduce_max_2d_f32, riiiriiii, v)
+EXPORT_FN("reduce.sum.2d.f32", iree_vmvx_module_reduce_sum_2d_f32, riiiriiii, v)
+EXPORT_FN("reduce.sum.2d.i32", iree_vmvx_module_reduce_sum_2d_i32, riiiriiii, v)
+EXPORT_FN("rsqrt.2d.f32", iree_vmvx_module_rsqrt_2d_f32, riiiriiiii, v)
+EXPORT_FN("sqrt.2d.f32", iree_vmvx_module_sqrt_2d_f32, riiiriiiii, v)
+EXPORT_FN("sub.2d.f32", iree_vmvx_module_sub_2d_f32, riiiriiiriiiii, v)
+EXPORT_FN("sub.2d.i32", iree_vmvx_module_sub_2d_i32, riiiriiiriiiii, v)
+EXPORT_FN("tanh.2d.f32", iree_vmvx_module_tanh_2d_f32, riiiriiiii, v)
+EXPORT_FN("xor.2d.i32", iree_vmvx_module_xor_2d_i32, riiiriiiriiiii, v)
 
 // clang-format on
@@ -6,6 +6,8 @@
 
 #include "iree/modules/vmvx/module.h"
 
+#include <inttypes.h>
+#include <math.h>
 #include <stdbool.h>
 #include <stddef.h>
 #include <stdint.h>
@@ -91,16 +93,417 @@ iree_vmvx_module_free_state(void* self, iree_vm_module_state_t* module_state) {
 }
 
 //===----------------------------------------------------------------------===//
-// TODO
+// Strided buffer views
 //===----------------------------------------------------------------------===//
 
-// Placeholder to make the function pointer arrays happy (they can't be empty).
-IREE_VM_ABI_EXPORT(iree_vmvx_module_placeholder,  //
-                   iree_vmvx_module_state_t,      //
-                   v, v) {
+// Maps a strided 2-D view of |size0|x|size1| elements, each |element_size|
+// bytes, starting at element |offset| of |buffer_ref| to a host pointer.
+// Offsets and strides are in elements and strides may be 0 to broadcast.
+//
+// Every element reachable through the view is bounds checked against the
+// buffer: VMVX is used to run untrusted programs and the kernels below index
+// the returned pointer without any further checks.
+//
+// Empty views are valid and produce a NULL |out_ptr|.
+static iree_status_t iree_vmvx_map_view_2d(iree_vm_ref_t buffer_ref,
+                                           bool is_mutable, int32_t offset,
+                                           int32_t stride0, int32_t stride1,
+                                           int32_t size0, int32_t size1,
+                                           iree_host_size_t element_size,
+                                           void** out_ptr) {
+  *out_ptr = NULL;
+  iree_vm_buffer_t* buffer = NULL;
+  IREE_RETURN_IF_ERROR(iree_vm_buffer_check_deref(buffer_ref, &buffer));
+  if (IREE_UNLIKELY(offset < 0 || stride0 < 0 || stride1 < 0 || size0 < 0 ||
+                    size1 < 0)) {
+    return iree_make_status(IREE_STATUS_INVALID_ARGUMENT,
+                            "invalid view offset=%d strides=[%d, %d] "
+                            "sizes=[%d, %d]",
+                            offset, stride0, stride1, size0, size1);
+  }
+  if (IREE_UNLIKELY(is_mutable && !iree_all_bits_set(
+                                      buffer->access,
+                                      IREE_VM_BUFFER_ACCESS_MUTABLE))) {
+    return iree_make_status(IREE_STATUS_PERMISSION_DENIED,
+                            "buffer is read-only and cannot be written");
+  }
+  if (size0 == 0 || size1 == 0) return iree_ok_status();
+
+  // All terms are non-negative 32-bit values so this cannot overflow.
+  uint64_t last_element = (uint64_t)offset +
+                          (uint64_t)(size0 - 1) * (uint64_t)stride0 +
+                          (uint64_t)(size1 - 1) * (uint64_t)stride1;
+  iree_byte_span_t data = iree_vm_buffer_data(buffer);
+  if (IREE_UNLIKELY(last_element >= data.data_length / element_size)) {
+    return iree_make_status(
+        IREE_STATUS_OUT_OF_RANGE,
+        "view of element %" PRIu64 " out of range of a %" PRIhsz
+        " byte buffer",
+        last_element, data.data_length);
+  }
+  uint8_t* ptr = data.data + (iree_host_size_t)offset * element_size;
+  if (IREE_UNLIKELY((uintptr_t)ptr % element_size != 0)) {
+    return iree_make_status(IREE_STATUS_INVALID_ARGUMENT,
+                            "view base is not aligned to its %" PRIhsz
+                            " byte elements",
+                            element_size);
+  }
+  *out_ptr = ptr;
   return iree_ok_status();
 }
 
+//===----------------------------------------------------------------------===//
+// Elementwise ops
+//===----------------------------------------------------------------------===//
+
+// All elementwise ops operate on strided 2-D views; 1-D ops have a size0 of 1
+// and higher ranks are looped over by the compiler. Rows with unit inner
+// strides take a separate loop the C compiler can vectorize.
+
+static inline float iree_vmvx_maxf(float a, float b) {
+  // Matches arith.maxf: NaN in either operand propagates.
+  return (isnan(a) || a > b) ? a : b;
+}
+static inline float iree_vmvx_minf(float a, float b) {
+  return (isnan(a) || a < b) ? a : b;
+}
+
+#define IREE_VMVX_ADD(a, b) ((a) + (b))
+#define IREE_VMVX_AND(a, b) ((a) & (b))
+#define IREE_VMVX_DIV(a, b) ((a) / (b))
+#define IREE_VMVX_MUL(a, b) ((a) * (b))
+#define IREE_VMVX_OR(a, b) ((a) | (b))
+#define IREE_VMVX_SUB(a, b) ((a) - (b))
+#define IREE_VMVX_XOR(a, b) ((a) ^ (b))
+// Integer arithmetic wraps on overflow; do the math unsigned to avoid C UB.
+#define IREE_VMVX_ADD_I32(a, b) ((int32_t)((uint32_t)(a) + (uint32_t)(b)))
+#define IREE_VMVX_MUL_I32(a, b) ((int32_t)((uint32_t)(a) * (uint32_t)(b)))
+#define IREE_VMVX_SUB_I32(a, b) ((int32_t)((uint32_t)(a) - (uint32_t)(b)))
+
+#define IREE_VMVX_ABS(a) fabsf(a)
+#define IREE_VMVX_CEIL(a) ceilf(a)
+#define IREE_VMVX_EXP(a) expf(a)
+#define IREE_VMVX_FLOOR(a) floorf(a)
+#define IREE_VMVX_IDENTITY(a) (a)
+#define IREE_VMVX_LOG(a) logf(a)
+#define IREE_VMVX_NEG(a) (-(a))
+#define IREE_VMVX_RSQRT(a) (1.0f / sqrtf(a))
+#define IREE_VMVX_SQRT(a) sqrtf(a)
+#define IREE_VMVX_TANH(a) tanhf(a)
+
+// out[i, j] = op(lhs[i, j], rhs[i, j])
+#define IREE_VMVX_DEFINE_BINARY_2D(name, type, op)                            \
+  IREE_VM_ABI_EXPORT(iree_vmvx_module_##name, iree_vmvx_module_state_t,       \
+                     riiiriiiriiiii, v) {                                     \
+    const type* lhs = NULL;                                                   \
+    const type* rhs = NULL;                                                   \
+    type* out = NULL;                                                         \
+    IREE_RETURN_IF_ERROR(iree_vmvx_map_view_2d(                               \
+        args->r0, false, args->i1, args->i2, args->i3, args->i12, args->i13,  \
+        sizeof(type), (void**)&lhs));                                         \
+    IREE_RETURN_IF_ERROR(iree_vmvx_map_view_2d(                               \
+        args->r4, false, args->i5, args->i6, args->i7, args->i12, args->i13,  \
+        sizeof(type), (void**)&rhs));                                         \
+    IREE_RETURN_IF_ERROR(iree_vmvx_map_view_2d(                               \
+        args->r8, true, args->i9, args->i10, args->i11, args->i12, args->i13, \
+        sizeof(type), (void**)&out));                                         \
+    if (!out) return iree_ok_status();                                        \
+    const iree_host_size_t size0 = args->i12;                                 \
+    const iree_host_size_t size1 = args->i13;                                 \
+    const iree_host_size_t lhs_stride1 = args->i3;                            \
+    const iree_host_size_t rhs_stride1 = args->i7;                            \
+    const iree_host_size_t out_stride1 = args->i11;                           \
+    for (iree_host_size_t i = 0; i < size0; ++i) {                            \
+      const type* l = lhs + i * args->i2;                                     \
+      const type* r = rhs + i * args->i6;                                     \
+      type* o = out + i * args->i10;                                          \
+      if (lhs_stride1 == 1 && rhs_stride1 == 1 && out_stride1 == 1) {         \
+        for (iree_host_size_t j = 0; j < size1; ++j) {                        \
+          o[j] = op(l[j], r[j]);                                              \
+        }                                                                     \
+      } else {                                                                \
+        for (iree_host_size_t j = 0; j < size1; ++j) {                        \
+          o[j * out_stride1] = op(l[j * lhs_stride1], r[j * rhs_stride1]);    \
+        }                                                                     \
+      }                                                                       \
+    }                                                                         \
+    return iree_ok_status();                                                  \
+  }
+
+// out[i, j] = op(in[i, j])
+#define IREE_VMVX_DEFINE_UNARY_2D(name, type, op)                          \
+  IREE_VM_ABI_EXPORT(iree_vmvx_module_##name, iree_vmvx_module_state_t,    \
+                     riiiriiiii, v) {                                      \
+    const type* in = NULL;                                                 \
+    type* out = NULL;                                                      \
+    IREE_RETURN_IF_ERROR(iree_vmvx_map_view_2d(                            \
+        args->r0, false, args->i1, args->i2, args->i3, args->i8, args->i9, \
+        sizeof(type), (void**)&in));                                       \
+    IREE_RETURN_IF_ERROR(iree_vmvx_map_view_2d(                            \
+        args->r4, true, args->i5, args->i6, args->i7, args->i8, args->i9,  \
+        sizeof(type), (void**)&out));                                      \
+    if (!out) return iree_ok_status();                                     \
+    const iree_host_size_t size0 = args->i8;                               \
+    const iree_host_size_t size1 = args->i9;                               \
+    const iree_host_size_t in_stride1 = args->i3;                          \
+    const iree_host_size_t out_stride1 = args->i7;                         \
+    for (iree_host_size_t i = 0; i < size0; ++i) {                         \
+      const type* a = in + i * args->i2;                                   \
+      type* o = out + i * args->i6;                                        \
+      if (in_stride1 == 1 && out_stride1 == 1) {                           \
+        for (iree_host_size_t j = 0; j < size1; ++j) o[j] = op(a[j]);      \
+      } else {                                                             \
+        for (iree_host_size_t j = 0; j < size1; ++j) {                     \
+          o[j * out_stride1] = op(a[j * in_stride1]);                      \
+        }                                                                  \
+      }                                                                    \
+    }                                                                      \
+    return iree_ok_status();                                               \
+  }
+
+IREE_VMVX_DEFINE_UNARY_2D(abs_2d_f32, float, IREE_VMVX_ABS);
+IREE_VMVX_DEFINE_BINARY_2D(add_2d_f32, float, IREE_VMVX_ADD);
+IREE_VMVX_DEFINE_BINARY_2D(add_2d_i32, int32_t, IREE_VMVX_ADD_I32);
+IREE_VMVX_DEFINE_BINARY_2D(and_2d_i32, int32_t, IREE_VMVX_AND);
+IREE_VMVX_DEFINE_UNARY_2D(ceil_2d_f32, float, IREE_VMVX_CEIL);
+IREE_VMVX_DEFINE_BINARY_2D(div_2d_f32, float, IREE_VMVX_DIV);
+IREE_VMVX_DEFINE_UNARY_2D(exp_2d_f32, float, IREE_VMVX_EXP);
+IREE_VMVX_DEFINE_UNARY_2D(floor_2d_f32, float, IREE_VMVX_FLOOR);
+IREE_VMVX_DEFINE_UNARY_2D(log_2d_f32, float, IREE_VMVX_LOG);
+IREE_VMVX_DEFINE_BINARY_2D(max_2d_f32, float, iree_vmvx_maxf);
+IREE_VMVX_DEFINE_BINARY_2D(min_2d_f32, float, iree_vmvx_minf);
+IREE_VMVX_DEFINE_BINARY_2D(mul_2d_f32, float, IREE_VMVX_MUL);
+IREE_VMVX_DEFINE_BINARY_2D(mul_2d_i32, int32_t, IREE_VMVX_MUL_I32);
+IREE_VMVX_DEFINE_UNARY_2D(neg_2d_f32, float, IREE_VMVX_NEG);
+IREE_VMVX_DEFINE_BINARY_2D(or_2d_i32, int32_t, IREE_VMVX_OR);
+IREE_VMVX_DEFINE_UNARY_2D(rsqrt_2d_f32, float, IREE_VMVX_RSQRT);
+IREE_VMVX_DEFINE_UNARY_2D(sqrt_2d_f32, float, IREE_VMVX_SQRT);
+IREE_VMVX_DEFINE_BINARY_2D(sub_2d_f32, float, IREE_VMVX_SUB);
+IREE_VMVX_DEFINE_BINARY_2D(sub_2d_i32, int32_t, IREE_VMVX_SUB_I32);
+IREE_VMVX_DEFINE_UNARY_2D(tanh_2d_f32, float, IREE_VMVX_TANH);
+IREE_VMVX_DEFINE_BINARY_2D(xor_2d_i32, int32_t, IREE_VMVX_XOR);
+
+//===----------------------------------------------------------------------===//
+// Copy and fill
+//===----------------------------------------------------------------------===//
+
+// Copies only care about the bit depth and move elements as unsigned integers
+// of the same width.
+IREE_VMVX_DEFINE_UNARY_2D(copy_2d_x8, uint8_t, IREE_VMVX_IDENTITY);
+IREE_VMVX_DEFINE_UNARY_2D(copy_2d_x16, uint16_t, IREE_VMVX_IDENTITY);
+IREE_VMVX_DEFINE_UNARY_2D(copy_2d_x32, uint32_t, IREE_VMVX_IDENTITY);
+IREE_VMVX_DEFINE_UNARY_2D(copy_2d_x64, uint64_t, IREE_VMVX_IDENTITY);
+
+// out[i, j] = value
+IREE_VM_ABI_EXPORT(iree_vmvx_module_fill_2d_x32, iree_vmvx_module_state_t,
+                   iriiiii, v) {
+  uint32_t* out = NULL;
+  IREE_RETURN_IF_ERROR(iree_vmvx_map_view_2d(
+      args->r1, true, args->i2, args->i3, args->i4, args->i5, args->i6,
+      sizeof(uint32_t), (void**)&out));
+  if (!out) return iree_ok_status();
+  const uint32_t value = (uint32_t)args->i0;
+  const iree_host_size_t size0 = args->i5;
+  const iree_host_size_t size1 = args->i6;
+  const iree_host_size_t out_stride1 = args->i4;
+  for (iree_host_size_t i = 0; i < size0; ++i) {
+    uint32_t* o = out + i * args->i3;
+    if (out_stride1 == 1) {
+      for (iree_host_size_t j = 0; j < size1; ++j) o[j] = value;
+    } else {
+      for (iree_host_size_t j = 0; j < size1; ++j) o[j * out_stride1] = value;
+    }
+  }
+  return iree_ok_status();
+}
+
+//===----------------------------------------------------------------------===//
+// Reductions
+//===----------------------------------------------------------------------===//
+
+// Number of independent accumulators used when reducing contiguous rows.
+// Splitting the accumulation lets the C compiler keep them in vector registers.
+#define IREE_VMVX_REDUCE_LANES 8
+
+// out[i] = op(out[i], in[i, 0], ..., in[i, size1 - 1])
+// Floating-point reductions are reassociated across the lanes.
+#define IREE_VMVX_DEFINE_REDUCE_2D(name, type, op)                             \
+  IREE_VM_ABI_EXPORT(iree_vmvx_module_##name, iree_vmvx_module_state_t,        \
+                     riiiriiii, v) {                                           \
+    const type* in = NULL;                                                     \
+    type* out = NULL;                                                          \
+    IREE_RETURN_IF_ERROR(iree_vmvx_map_view_2d(                                \
+        args->r0, false, args->i1, args->i2, args->i3, args->i7, args->i8,     \
+        sizeof(type), (void**)&in));                                           \
+    IREE_RETURN_IF_ERROR(                                                      \
+        iree_vmvx_map_view_2d(args->r4, true, args->i5, args->i6, 0, args->i7, \
+                              1, sizeof(type), (void**)&out));                 \
+    if (!in || !out) return iree_ok_status();                                  \
+    const iree_host_size_t size0 = args->i7;                                   \
+    const iree_host_size_t size1 = args->i8;                                   \
+    const iree_host_size_t in_stride1 = args->i3;                              \
+    for (iree_host_size_t i = 0; i < size0; ++i) {                             \
+      const type* a = in + i * args->i2;                                       \
+      type* o = out + i * args->i6;                                            \
+      type acc = *o;                                                           \
+      iree_host_size_t j = 0;                                                  \
+      if (in_stride1 == 1 && size1 >= IREE_VMVX_REDUCE_LANES) {                \
+        type lanes[IREE_VMVX_REDUCE_LANES];                                    \
+        for (int l = 0; l < IREE_VMVX_REDUCE_LANES; ++l) lanes[l] = a[l];      \
+        for (j = IREE_VMVX_REDUCE_LANES; j + IREE_VMVX_REDUCE_LANES <= size1;  \
+             j += IREE_VMVX_REDUCE_LANES) {                                    \
+          for (int l = 0; l < IREE_VMVX_REDUCE_LANES; ++l) {                   \
+            lanes[l] = op(lanes[l], a[j + l]);                                 \
+          }                                                                    \
+        }                                                                      \
+        for (int l = 0; l < IREE_VMVX_REDUCE_LANES; ++l) {                     \
+          acc = op(acc, lanes[l]);                                             \
+        }                                                                      \
+      }                                                                        \
+      for (; j < size1; ++j) acc = op(acc, a[j * in_stride1]);                 \
+      *o = acc;                                                                \
+    }                                                                          \
+    return iree_ok_status();                                                   \
+  }
+
+IREE_VMVX_DEFINE_REDUCE_2D(reduce_max_2d_f32, float, iree_vmvx_maxf);
+IREE_VMVX_DEFINE_REDUCE_2D(reduce_sum_2d_f32, float, IREE_VMVX_ADD);
+IREE_VMVX_DEFINE_REDUCE_2D(reduce_sum_2d_i32, int32_t, IREE_VMVX_ADD_I32);
+
+//===----------------------------------------------------------------------===//
+// Matrix multiplication
+//===----------------------------------------------------------------------===//
+
+// out[i, j] += sum(lhs[i, p] * rhs[p, j])
+//
+// Operands are arbitrarily strided 2-D views so that the compiler can also
+// express the inner loops of convolutions as a sequence of matmuls over the
+// input window.
+#define IREE_VMVX_DEFINE_MATMUL(name, lhs_type, rhs_type, out_type)           \
+  IREE_VM_ABI_EXPORT(iree_vmvx_module_##name, iree_vmvx_module_state_t,       \
+                     riiiriiiriiiiii, v) {                                    \
+    const lhs_type* lhs = NULL;                                               \
+    const rhs_type* rhs = NULL;                                               \
+    out_type* out = NULL;                                                     \
+    IREE_RETURN_IF_ERROR(iree_vmvx_map_view_2d(                               \
+        args->r0, false, args->i1, args->i2, args->i3, args->i12, args->i14,  \
+        sizeof(lhs_type), (void**)&lhs));                                     \
+    IREE_RETURN_IF_ERROR(iree_vmvx_map_view_2d(                               \
+        args->r4, false, args->i5, args->i6, args->i7, args->i14, args->i13,  \
+        sizeof(rhs_type), (void**)&rhs));                                     \
+    IREE_RETURN_IF_ERROR(iree_vmvx_map_view_2d(                               \
+        args->r8, true, args->i9, args->i10, args->i11, args->i12, args->i13, \
+        sizeof(out_type), (void**)&out));                                     \
+    if (!lhs || !out) return iree_ok_status();                                \
+    const iree_host_size_t m = args->i12;                                     \
+    const iree_host_size_t n = args->i13;                                     \
+    const iree_host_size_t k = args->i14;                                     \
+    const iree_host_size_t lhs_stride1 = args->i3;                            \
+    const iree_host_size_t rhs_stride1 = args->i7;                            \
+    const iree_host_size_t out_stride1 = args->i11;                           \
+    for (iree_host_size_t i = 0; i < m; ++i) {                                \
+      const lhs_type* a = lhs + i * args->i2;                                 \
+      out_type* o = out + i * args->i10;                                      \
+      for (iree_host_size_t p = 0; p < k; ++p) {                              \
+        const out_type a_value = (out_type)a[p * lhs_stride1];                \
+        const rhs_type* b = rhs + p * args->i6;                               \
+        if (rhs_stride1 == 1 && out_stride1 == 1) {                           \
+          for (iree_host_size_t j = 0; j < n; ++j) {                          \
+            o[j] += a_value * (out_type)b[j];                                 \
+          }                                                                   \
+        } else {                                                              \
+          for (iree_host_size_t j = 0; j < n; ++j) {                          \
+            o[j * out_stride1] += a_value * (out_type)b[j * rhs_stride1];     \
+          }                                                                   \
+        }                                                                     \
+      }                                                                       \
+    }                                                                         \
+    return iree_ok_status();                                                  \
+  }
+
+IREE_VMVX_DEFINE_MATMUL(matmul_f32f32f32, float, float, float);
+IREE_VMVX_DEFINE_MATMUL(matmul_i8i8i32, int8_t, int8_t, int32_t);
+
+// Returns the number of elements in |a| * |b| * |c| contiguous elements or an
+// error if a view cannot address that many.
+static iree_status_t iree_vmvx_tile_span(int32_t a, int32_t b, int32_t c,
+                                         int32_t* out_span) {
+  *out_span = 0;
+  if (IREE_UNLIKELY(a < 0 || b < 0 || c < 0)) {
+    return iree_make_status(IREE_STATUS_INVALID_ARGUMENT,
+                            "negative tile dimensions");
+  }
+  uint64_t span = (uint64_t)a * (uint64_t)b;
+  if (span <= INT32_MAX) span *= (uint64_t)c;
+  if (IREE_UNLIKELY(span > INT32_MAX)) {
+    return iree_make_status(IREE_STATUS_OUT_OF_RANGE,
+                            "tile of %d x %d x %d elements is too large", a, b,
+                            c);
+  }
+  *out_span = (int32_t)span;
+  return iree_ok_status();
+}
+
+// Matmul in the 4-D tiled layout used by linalg.mmt4d:
+//   lhs[m, k, m0, k0], rhs[n, k, n0, k0], out[m, n, m0, n0]
+//   out[i, j, i0, j0] += sum(lhs[i, p, i0, p0] * rhs[j, p, j0, p0])
+// The outer dimension of each operand is strided and the inner dimensions are
+// contiguous.
+#define IREE_VMVX_DEFINE_MMT4D(name, lhs_type, rhs_type, out_type)            \
+  IREE_VM_ABI_EXPORT(iree_vmvx_module_##name, iree_vmvx_module_state_t,       \
+                     riiriiriiiiiiii, v) {                                    \
+    int32_t lhs_span = 0;                                                     \
+    int32_t rhs_span = 0;                                                     \
+    int32_t out_span = 0;                                                     \
+    IREE_RETURN_IF_ERROR(                                                     \
+        iree_vmvx_tile_span(args->i11, args->i12, args->i14, &lhs_span));     \
+    IREE_RETURN_IF_ERROR(                                                     \
+        iree_vmvx_tile_span(args->i11, args->i13, args->i14, &rhs_span));     \
+    IREE_RETURN_IF_ERROR(                                                     \
+        iree_vmvx_tile_span(args->i10, args->i12, args->i13, &out_span));     \
+    const lhs_type* lhs = NULL;                                               \
+    const rhs_type* rhs = NULL;                                               \
+    out_type* out = NULL;                                                     \
+    IREE_RETURN_IF_ERROR(iree_vmvx_map_view_2d(                               \
+        args->r0, false, args->i1, args->i2, 1, args->i9, lhs_span,           \
+        sizeof(lhs_type), (void**)&lhs));                                     \
+    IREE_RETURN_IF_ERROR(iree_vmvx_map_view_2d(                               \
+        args->r3, false, args->i4, args->i5, 1, args->i10, rhs_span,          \
+        sizeof(rhs_type), (void**)&rhs));                                     \
+    IREE_RETURN_IF_ERROR(iree_vmvx_map_view_2d(                               \
+        args->r6, true, args->i7, args->i8, 1, args->i9, out_span,            \
+        sizeof(out_type), (void**)&out));                                     \
+    if (!lhs || !rhs || !out) return iree_ok_status();                        \
+    const iree_host_size_t m = args->i9;                                      \
+    const iree_host_size_t n = args->i10;                                     \
+    const iree_host_size_t k = args->i11;                                     \
+    const iree_host_size_t m0 = args->i12;                                    \
+    const iree_host_size_t n0 = args->i13;                                    \
+    const iree_host_size_t k0 = args->i14;                                    \
+    for (iree_host_size_t i = 0; i < m; ++i) {                                \
+      for (iree_host_size_t j = 0; j < n; ++j) {                              \
+        out_type* o = out + i * args->i8 + j * m0 * n0;                       \
+        for (iree_host_size_t p = 0; p < k; ++p) {                            \
+          const lhs_type* a = lhs + i * args->i2 + p * m0 * k0;               \
+          const rhs_type* b = rhs + j * args->i5 + p * n0 * k0;               \
+          for (iree_host_size_t i0 = 0; i0 < m0; ++i0) {                      \
+            for (iree_host_size_t j0 = 0; j0 < n0; ++j0) {                    \
+              out_type acc = 0;                                               \
+              for (iree_host_size_t p0 = 0; p0 < k0; ++p0) {                  \
+                acc += (out_type)a[i0 * k0 + p0] * (out_type)b[j0 * k0 + p0]; \
+              }                                                               \
+              o[i0 * n0 + j0] += acc;                                         \
+            }                                                                 \
+          }                                                                   \
+        }                                                                     \
+      }                                                                       \
+    }                                                                         \
+    return iree_ok_status();                                                  \
+  }
+
+IREE_VMVX_DEFINE_MMT4D(mmt4d_f32f32f32, float, float, float);
+IREE_VMVX_DEFINE_MMT4D(mmt4d_i8i8i32, int8_t, int8_t, int32_t);
+
 //===----------------------------------------------------------------------===//
 // VM module interface implementation
 //===----------------------------------------------------------------------===//
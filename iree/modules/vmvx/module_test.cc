@@ -0,0 +1,308 @@
+// Copyright 2022 The IREE Authors
+//
+// Licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+#include "iree/modules/vmvx/module.h"
+
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <initializer_list>
+#include <vector>
+
+#include "iree/base/api.h"
+#include "iree/testing/gtest.h"
+#include "iree/testing/status_matchers.h"
+#include "iree/vm/api.h"
+
+namespace {
+
+// A single argument to a vmvx.* function: either a buffer or an i32.
+struct Arg {
+  Arg(iree_vm_buffer_t* buffer) : buffer(buffer) {}
+  Arg(int32_t value) : value(value) {}
+  iree_vm_buffer_t* buffer = nullptr;
+  int32_t value = 0;
+};
+
+class VMVXModuleTest : public ::testing::Test {
+ protected:
+  virtual void SetUp() {
+    IREE_CHECK_OK(iree_vm_instance_create(iree_allocator_system(), &instance_));
+    IREE_CHECK_OK(iree_vmvx_module_register_types());
+    iree_vm_module_t* module = nullptr;
+    IREE_CHECK_OK(iree_vmvx_module_create(iree_allocator_system(), &module));
+    IREE_CHECK_OK(iree_vm_context_create_with_modules(
+        instance_, IREE_VM_CONTEXT_FLAG_NONE, &module, 1,
+        iree_allocator_system(), &context_));
+    iree_vm_module_release(module);
+  }
+
+  virtual void TearDown() {
+    for (auto* buffer : buffers_) iree_vm_buffer_release(buffer);
+    iree_vm_context_release(context_);
+    iree_vm_instance_release(instance_);
+  }
+
+  // Returns a new buffer initialized with |values| that lives as long as the
+  // test.
+  template <typename T>
+  iree_vm_buffer_t* MakeBuffer(const std::vector<T>& values,
+                               bool is_mutable = true) {
+    iree_vm_buffer_t* buffer = nullptr;
+    IREE_CHECK_OK(iree_vm_buffer_create(
+        IREE_VM_BUFFER_ACCESS_ORIGIN_HOST |
+            (is_mutable ? IREE_VM_BUFFER_ACCESS_MUTABLE : 0),
+        values.size() * sizeof(T), iree_allocator_system(), &buffer));
+    memcpy(iree_vm_buffer_data(buffer).data, values.data(),
+           values.size() * sizeof(T));
+    buffers_.push_back(buffer);
+    return buffer;
+  }
+
+  template <typename T>
+  std::vector<T> ReadBuffer(iree_vm_buffer_t* buffer) {
+    iree_byte_span_t data = iree_vm_buffer_data(buffer);
+    std::vector<T> values(data.data_length / sizeof(T));
+    memcpy(values.data(), data.data, values.size() * sizeof(T));
+    return values;
+  }
+
+  // Calls vmvx.|name| with the given |args|.
+  iree_status_t Invoke(const char* name, std::initializer_list<Arg> args) {
+    iree_vm_function_t function;
+    IREE_RETURN_IF_ERROR(iree_vm_context_resolve_function(
+        context_,
+        iree_make_cstring_view((std::string("vmvx.") + name).c_str()),
+        &function));
+    iree_vm_list_t* inputs = nullptr;
+    IREE_RETURN_IF_ERROR(iree_vm_list_create(
+        /*element_type=*/nullptr, args.size(), iree_allocator_system(),
+        &inputs));
+    iree_status_t status = iree_ok_status();
+    for (const auto& arg : args) {
+      if (arg.buffer) {
+        iree_vm_ref_t ref = iree_vm_buffer_retain_ref(arg.buffer);
+        status = iree_vm_list_push_ref_move(inputs, &ref);
+      } else {
+        iree_vm_value_t value = iree_vm_value_make_i32(arg.value);
+        status = iree_vm_list_push_value(inputs, &value);
+      }
+      if (!iree_status_is_ok(status)) break;
+    }
+    if (iree_status_is_ok(status)) {
+      status = iree_vm_invoke(context_, function, IREE_VM_INVOCATION_FLAG_NONE,
+                              /*policy=*/nullptr, inputs, /*outputs=*/nullptr,
+                              iree_allocator_system());
+    }
+    iree_vm_list_release(inputs);
+    return status;
+  }
+
+  iree_vm_instance_t* instance_ = nullptr;
+  iree_vm_context_t* context_ = nullptr;
+  std::vector<iree_vm_buffer_t*> buffers_;
+};
+
+TEST_F(VMVXModuleTest, AddF32) {
+  auto* lhs = MakeBuffer<float>({1, 2, 3, 4, 5, 6});
+  auto* rhs = MakeBuffer<float>({10, 20, 30, 40, 50, 60});
+  auto* out = MakeBuffer<float>(std::vector<float>(6, 0.0f));
+  IREE_ASSERT_OK(Invoke("add.2d.f32", {lhs, 0, 3, 1,  //
+                                       rhs, 0, 3, 1,  //
+                                       out, 0, 3, 1,  //
+                                       2, 3}));
+  EXPECT_EQ(ReadBuffer<float>(out),
+            (std::vector<float>{11, 22, 33, 44, 55, 66}));
+}
+
+// Zero strides broadcast and non-unit strides take the strided path.
+TEST_F(VMVXModuleTest, BinaryBroadcastAndTranspose) {
+  auto* lhs = MakeBuffer<int32_t>({1, 2, 3, 4, 5, 6});
+  auto* rhs = MakeBuffer<int32_t>({100, 200});
+  auto* out = MakeBuffer<int32_t>(std::vector<int32_t>(8, 0));
+  // out[1 + i + j * 3] = lhs[i + j * 3] * rhs[j] over a 3x2 view.
+  IREE_ASSERT_OK(Invoke("mul.2d.i32", {lhs, 0, 1, 3,  //
+                                       rhs, 0, 0, 1,  //
+                                       out, 1, 1, 3,  //
+                                       3, 2}));
+  EXPECT_EQ(ReadBuffer<int32_t>(out),
+            (std::vector<int32_t>{0, 100, 200, 300, 800, 1000, 1200, 0}));
+}
+
+TEST_F(VMVXModuleTest, MaxF32PropagatesNaN) {
+  auto* lhs = MakeBuffer<float>({1, NAN, 3});
+  auto* rhs = MakeBuffer<float>({2, 0, NAN});
+  auto* out = MakeBuffer<float>(std::vector<float>(3, 0.0f));
+  IREE_ASSERT_OK(Invoke("max.2d.f32", {lhs, 0, 0, 1,  //
+                                       rhs, 0, 0, 1,  //
+                                       out, 0, 0, 1,  //
+                                       1, 3}));
+  auto result = ReadBuffer<float>(out);
+  EXPECT_EQ(result[0], 2.0f);
+  EXPECT_TRUE(std::isnan(result[1]));
+  EXPECT_TRUE(std::isnan(result[2]));
+}
+
+TEST_F(VMVXModuleTest, UnaryF32) {
+  auto* in = MakeBuffer<float>({0.0f, 1.0f, 4.0f, 9.0f});
+  auto* out = MakeBuffer<float>(std::vector<float>(4, 0.0f));
+  IREE_ASSERT_OK(Invoke("sqrt.2d.f32", {in, 0, 2, 1,  //
+                                        out, 0, 2, 1,  //
+                                        2, 2}));
+  EXPECT_EQ(ReadBuffer<float>(out), (std::vector<float>{0, 1, 2, 3}));
+  IREE_ASSERT_OK(Invoke("exp.2d.f32", {in, 0, 0, 1,  //
+                                       out, 0, 0, 1,  //
+                                       1, 1}));
+  EXPECT_EQ(ReadBuffer<float>(out)[0], 1.0f);
+}
+
+TEST_F(VMVXModuleTest, CopyStrided) {
+  auto* in = MakeBuffer<uint8_t>({0, 1, 2, 3, 4, 5, 6, 7, 8});
+  auto* out = MakeBuffer<uint8_t>(std::vector<uint8_t>(4, 0xFF));
+  // Copies the top-right 2x2 corner of a 3x3 matrix.
+  IREE_ASSERT_OK(Invoke("copy.2d.x8", {in, 1, 3, 1,  //
+                                       out, 0, 2, 1,  //
+                                       2, 2}));
+  EXPECT_EQ(ReadBuffer<uint8_t>(out), (std::vector<uint8_t>{1, 2, 4, 5}));
+}
+
+TEST_F(VMVXModuleTest, FillX32) {
+  auto* out = MakeBuffer<uint32_t>(std::vector<uint32_t>(6, 0));
+  IREE_ASSERT_OK(Invoke("fill.2d.x32", {7, out, 1, 3, 1, 2, 2}));
+  EXPECT_EQ(ReadBuffer<uint32_t>(out),
+            (std::vector<uint32_t>{0, 7, 7, 0, 7, 7}));
+}
+
+TEST_F(VMVXModuleTest, ReduceSumF32) {
+  // Long enough rows to use the split accumulators plus a tail.
+  const int32_t rows = 3;
+  const int32_t cols = 19;
+  std::vector<float> values(rows * cols);
+  for (size_t i = 0; i < values.size(); ++i) values[i] = (float)(i % 7);
+  auto* in = MakeBuffer<float>(values);
+  auto* out = MakeBuffer<float>({1.0f, -1.0f, 0.5f});
+  IREE_ASSERT_OK(Invoke("reduce.sum.2d.f32", {in, 0, cols, 1,  //
+                                              out, 0, 1,       //
+                                              rows, cols}));
+  auto result = ReadBuffer<float>(out);
+  const float initial[rows] = {1.0f, -1.0f, 0.5f};
+  for (int32_t i = 0; i < rows; ++i) {
+    float expected = initial[i];
+    for (int32_t j = 0; j < cols; ++j) expected += values[i * cols + j];
+    EXPECT_EQ(result[i], expected);
+  }
+}
+
+TEST_F(VMVXModuleTest, ReduceAcrossColumns) {
+  // Reduces over the outer dimension by swapping the strides.
+  auto* in = MakeBuffer<int32_t>({1, 2, 3, 4, 5, 6});
+  auto* out = MakeBuffer<int32_t>({0, 0, 0});
+  IREE_ASSERT_OK(Invoke("reduce.sum.2d.i32", {in, 0, 1, 3,  //
+                                              out, 0, 1,     //
+                                              3, 2}));
+  EXPECT_EQ(ReadBuffer<int32_t>(out), (std::vector<int32_t>{5, 7, 9}));
+}
+
+TEST_F(VMVXModuleTest, MatmulF32Accumulates) {
+  // [2x3] * [3x2] + [2x2]
+  auto* lhs = MakeBuffer<float>({1, 2, 3, 4, 5, 6});
+  auto* rhs = MakeBuffer<float>({7, 8, 9, 10, 11, 12});
+  auto* out = MakeBuffer<float>({1, 1, 1, 1});
+  IREE_ASSERT_OK(Invoke("matmul.f32f32f32", {lhs, 0, 3, 1,  //
+                                             rhs, 0, 2, 1,  //
+                                             out, 0, 2, 1,  //
+                                             2, 2, 3}));
+  EXPECT_EQ(ReadBuffer<float>(out), (std::vector<float>{59, 65, 140, 155}));
+}
+
+TEST_F(VMVXModuleTest, MatmulI8TransposedRHS) {
+  auto* lhs = MakeBuffer<int8_t>({1, -2, 3, 4});
+  // rhs is stored transposed: rhs[k, n] lives at n * 2 + k.
+  auto* rhs = MakeBuffer<int8_t>({-128, 127, 5, 6});
+  auto* out = MakeBuffer<int32_t>({0, 0, 0, 0});
+  IREE_ASSERT_OK(Invoke("matmul.i8i8i32", {lhs, 0, 2, 1,  //
+                                           rhs, 0, 1, 2,  //
+                                           out, 0, 2, 1,  //
+                                           2, 2, 2}));
+  EXPECT_EQ(ReadBuffer<int32_t>(out),
+            (std::vector<int32_t>{-128 - 254, 5 - 12, -384 + 508, 15 + 24}));
+}
+
+TEST_F(VMVXModuleTest, Mmt4dF32) {
+  // M=2 N=1 K=2 tiles of M0=2 N0=2 K0=1.
+  const int32_t m = 2, n = 1, k = 2, m0 = 2, n0 = 2, k0 = 1;
+  std::vector<float> lhs_values(m * k * m0 * k0);
+  std::vector<float> rhs_values(n * k * n0 * k0);
+  for (size_t i = 0; i < lhs_values.size(); ++i) lhs_values[i] = (float)i;
+  for (size_t i = 0; i < rhs_values.size(); ++i) rhs_values[i] = (float)i + 1;
+  auto* lhs = MakeBuffer<float>(lhs_values);
+  auto* rhs = MakeBuffer<float>(rhs_values);
+  auto* out = MakeBuffer<float>(std::vector<float>(m * n * m0 * n0, 0.0f));
+  IREE_ASSERT_OK(Invoke("mmt4d.f32f32f32", {lhs, 0, k * m0 * k0,  //
+                                            rhs, 0, k * n0 * k0,  //
+                                            out, 0, n * m0 * n0,  //
+                                            m, n, k, m0, n0, k0}));
+  std::vector<float> expected(m * n * m0 * n0, 0.0f);
+  for (int i = 0; i < m; ++i) {
+    for (int j = 0; j < n; ++j) {
+      for (int p = 0; p < k; ++p) {
+        for (int i0 = 0; i0 < m0; ++i0) {
+          for (int j0 = 0; j0 < n0; ++j0) {
+            for (int p0 = 0; p0 < k0; ++p0) {
+              expected[((i * n + j) * m0 + i0) * n0 + j0] +=
+                  lhs_values[((i * k + p) * m0 + i0) * k0 + p0] *
+                  rhs_values[((j * k + p) * n0 + j0) * k0 + p0];
+            }
+          }
+        }
+      }
+    }
+  }
+  EXPECT_EQ(ReadBuffer<float>(out), expected);
+}
+
+TEST_F(VMVXModuleTest, EmptyViewIsNoOp) {
+  auto* in = MakeBuffer<float>({1});
+  auto* out = MakeBuffer<float>({2});
+  IREE_ASSERT_OK(Invoke("copy.2d.x32", {in, 0, 1, 1,  //
+                                        out, 0, 1, 1,  //
+                                        0, 1}));
+  EXPECT_EQ(ReadBuffer<float>(out), (std::vector<float>{2}));
+}
+
+TEST_F(VMVXModuleTest, OutOfBoundsViewFails) {
+  auto* in = MakeBuffer<float>({1, 2, 3, 4});
+  auto* out = MakeBuffer<float>({0, 0, 0, 0});
+  // The second row starts at element 4.
+  iree_status_t status = Invoke("copy.2d.x32", {in, 0, 4, 1,  //
+                                                out, 0, 0, 1,  //
+                                                2, 1});
+  IREE_EXPECT_STATUS_IS(IREE_STATUS_OUT_OF_RANGE, status);
+  iree_status_free(status);
+  status = Invoke("copy.2d.x32", {in, 2, 1, 1,  //
+                                  out, 0, 1, 1,  //
+                                  1, 3});
+  IREE_EXPECT_STATUS_IS(IREE_STATUS_OUT_OF_RANGE, status);
+  iree_status_free(status);
+  status = Invoke("copy.2d.x32", {in, 0, -1, 1,  //
+                                  out, 0, 1, 1,   //
+                                  1, 1});
+  IREE_EXPECT_STATUS_IS(IREE_STATUS_INVALID_ARGUMENT, status);
+  iree_status_free(status);
+  EXPECT_EQ(ReadBuffer<float>(out), (std::vector<float>{0, 0, 0, 0}));
+}
+
+TEST_F(VMVXModuleTest, ReadOnlyOutputFails) {
+  auto* in = MakeBuffer<float>({1});
+  auto* out = MakeBuffer<float>({0}, /*is_mutable=*/false);
+  iree_status_t status = Invoke("copy.2d.x32", {in, 0, 1, 1,  //
+                                                out, 0, 1, 1,  //
+                                                1, 1});
+  IREE_EXPECT_STATUS_IS(IREE_STATUS_PERMISSION_DENIED, status);
+  iree_status_free(status);
+}
+
+}  // namespace
@@ -28,6 +28,7 @@ iree_status_t create_sample_device(iree_allocator_t host_allocator,
 
   iree_hal_executable_loader_t* loader = NULL;
   IREE_RETURN_IF_ERROR(iree_hal_embedded_library_loader_create(
+      IREE_HAL_EMBEDDED_LIBRARY_LOADER_FLAG_NONE,
       iree_hal_executable_import_provider_null(), host_allocator, &loader));
 
   iree_task_executor_t* executor = NULL;
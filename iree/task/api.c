@@ -25,15 +25,14 @@ IREE_FLAG(
     "threads for potential latency additions later on as threads take longer\n"
     "to wake on their first use.");
 
-// TODO(benvanik): enable this when we use it - though hopefully we don't!
 IREE_FLAG(
     int32_t, task_worker_local_memory, 0,  // 64 * 1024,
-    "Specifies the bytes of per-worker local memory allocated for use by\n"
-    "dispatched tiles. Tiles may use less than this but will fail to dispatch\n"
-    "if they require more. Conceptually it is like a stack reservation and\n"
-    "should be treated the same way: the source programs must be built to\n"
-    "only use a specific maximum amount of local memory and the runtime must\n"
-    "be configured to make at least that amount of local memory available.");
+    "Specifies the bytes of per-worker local memory allocated up-front for\n"
+    "use by dispatched tiles. Tiles requiring more will cause workers to grow\n"
+    "their local memory on demand (and retain it for future dispatches) up to\n"
+    "a compile-time limit. Conceptually it is like a stack reservation: if\n"
+    "the amount of local memory used by a program is known then reserving it\n"
+    "here avoids allocations during the first dispatches.");
 
 //===----------------------------------------------------------------------===//
 // Topology configuration
@@ -292,9 +292,11 @@ typedef struct iree_task_executor_t iree_task_executor_t;
 //
 // |worker_local_memory_size| defines the bytes to be allocated and reserved for
 // each worker to use for local memory operations. Will be rounded up to the
-// next power of two. Dispatches performed will be able to request up to this
-// amount of memory for their invocations and no more. May be 0 if no worker
-// local memory is required.
+// next power of two. Dispatches requesting more than this will cause the
+// executing workers to grow their local memory (up to
+// IREE_TASK_WORKER_MAX_LOCAL_MEMORY_SIZE), which is then retained for reuse by
+// subsequent dispatches. May be 0 if worker local memory should only be
+// allocated on demand.
 //
 // |topology| is only used during creation and need not live beyond this call.
 // |out_executor| must be released by the caller.
@@ -512,16 +512,87 @@ static uint32_t iree_task_tile_to_color(
 
 #endif  // IREE_TASK_TRACING_PER_TILE_COLORS
 
+#if IREE_STATISTICS_ENABLE
+static void iree_task_statistics_counter_merge(
+    const iree_atomic_int64_t* source, iree_atomic_int64_t* target) {
+  // NOTE: the atomic load builtins don't accept const pointers.
+  int64_t value = iree_atomic_load_int64((iree_atomic_int64_t*)source,
+                                         iree_memory_order_relaxed);
+  if (value) {
+    iree_atomic_fetch_add_int64(target, value, iree_memory_order_relaxed);
+  }
+}
+#endif  // IREE_STATISTICS_ENABLE
+
 void iree_task_dispatch_statistics_merge(
     const iree_task_dispatch_statistics_t* source,
     iree_task_dispatch_statistics_t* target) {
-  // TODO(benvanik): statistics.
+#if IREE_STATISTICS_ENABLE
+  iree_task_statistics_counter_merge(&source->tile_count, &target->tile_count);
+  iree_task_statistics_counter_merge(&source->stolen_tile_count,
+                                     &target->stolen_tile_count);
+  iree_task_statistics_counter_merge(&source->wall_time_ns,
+                                     &target->wall_time_ns);
+#endif  // IREE_STATISTICS_ENABLE
 }
 
 //==============================================================================
 // IREE_TASK_TYPE_DISPATCH
 //==============================================================================
 
+// Compacts the even bits of |value| into the low 16 bits.
+// Used to decode one coordinate of a Morton (Z-order) index.
+static inline uint32_t iree_task_morton_compact_u32(uint32_t value) {
+  value &= 0x55555555u;
+  value = (value | (value >> 1)) & 0x33333333u;
+  value = (value | (value >> 2)) & 0x0F0F0F0Fu;
+  value = (value | (value >> 4)) & 0x00FF00FFu;
+  value = (value | (value >> 8)) & 0x0000FFFFu;
+  return value;
+}
+
+void iree_task_tile_order_map(iree_task_tile_order_t tile_order,
+                              const uint32_t workgroup_count[3],
+                              uint32_t tile_index, uint32_t out_xyz[3]) {
+  const uint32_t count_x = workgroup_count[0];
+  const uint32_t count_y = workgroup_count[1];
+  const uint32_t plane_size = count_x * count_y;
+  out_xyz[2] = tile_index / plane_size;
+  uint32_t i = tile_index - out_xyz[2] * plane_size;
+  if (tile_order == IREE_TASK_TILE_ORDER_LINEAR) {
+    out_xyz[0] = i % count_x;
+    out_xyz[1] = i / count_x;
+    return;
+  }
+
+  // Both blocked orders split the plane into bands of up to block_size rows.
+  // The last band may be shorter if the grid height is not a multiple.
+  const uint32_t block_size = IREE_TASK_DISPATCH_TILE_ORDER_BLOCK_SIZE;
+  const uint32_t band_y = (i / (block_size * count_x)) * block_size;
+  const uint32_t band_height = iree_min(block_size, count_y - band_y);
+  i -= band_y * count_x;
+
+  if (tile_order == IREE_TASK_TILE_ORDER_SUPER_TILE) {
+    // Walk the band column-by-column.
+    out_xyz[0] = i / band_height;
+    out_xyz[1] = band_y + i % band_height;
+    return;
+  }
+
+  // IREE_TASK_TILE_ORDER_MORTON: split the band into blocks of up to
+  // block_size columns; all but the last block in the band are full width.
+  const uint32_t block_x = (i / (band_height * block_size)) * block_size;
+  const uint32_t block_width = iree_min(block_size, count_x - block_x);
+  i -= block_x * band_height;
+  if (band_height == block_size && block_width == block_size) {
+    out_xyz[0] = block_x + iree_task_morton_compact_u32(i);
+    out_xyz[1] = band_y + iree_task_morton_compact_u32(i >> 1);
+  } else {
+    out_xyz[0] = block_x + i % block_width;
+    out_xyz[1] = band_y + i / block_width;
+  }
+}
+
 static void iree_task_dispatch_initialize_base(
     iree_task_scope_t* scope, iree_task_dispatch_closure_t closure,
     const uint32_t workgroup_size[3], iree_task_dispatch_t* out_task) {
@@ -530,6 +601,7 @@ static void iree_task_dispatch_initialize_base(
   memcpy(out_task->workgroup_size, workgroup_size,
          sizeof(out_task->workgroup_size));
   out_task->local_memory_size = 0;
+  out_task->tile_order = IREE_TASK_TILE_ORDER_LINEAR;
   iree_atomic_store_intptr(&out_task->status, 0, iree_memory_order_release);
   memset(&out_task->statistics, 0, sizeof(out_task->statistics));
 
@@ -598,12 +670,19 @@ void iree_task_dispatch_issue(iree_task_dispatch_t* dispatch_task,
                           iree_memory_order_relaxed);
   dispatch_task->tile_count =
       workgroup_count[0] * workgroup_count[1] * workgroup_count[2];
+  IREE_STATISTICS(dispatch_task->issue_time_ns = iree_time_now());
 
   // Compute shard count - almost always worker_count unless we are a very small
   // dispatch (1x1x1, etc).
   iree_host_size_t worker_count = iree_task_post_batch_worker_count(post_batch);
   iree_host_size_t shard_count =
       iree_min(dispatch_task->tile_count, worker_count);
+  IREE_STATISTICS({
+    dispatch_task->tiles_per_shard =
+        shard_count ? (uint32_t)((dispatch_task->tile_count + shard_count - 1) /
+                                 shard_count)
+                    : 0;
+  });
 
   // Compute how many tiles we want each shard to reserve at a time from the
   // larger grid. A higher number reduces overhead and improves locality while
@@ -654,6 +733,12 @@ void iree_task_dispatch_retire(iree_task_dispatch_t* dispatch_task,
 
   // TODO(benvanik): attach statistics to the tracy zone.
 
+  IREE_STATISTICS({
+    iree_atomic_store_int64(&dispatch_task->statistics.wall_time_ns,
+                            iree_time_now() - dispatch_task->issue_time_ns,
+                            iree_memory_order_relaxed);
+  });
+
   // Merge the statistics from the dispatch into the scope so we can track all
   // of the work without tracking all the dispatches at a global level.
   iree_task_dispatch_statistics_merge(
@@ -680,11 +765,6 @@ void iree_task_dispatch_retire(iree_task_dispatch_t* dispatch_task,
 // IREE_TASK_TYPE_DISPATCH_SHARD
 //==============================================================================
 
-static inline iree_task_dispatch_t* iree_task_dispatch_shard_parent(
-    iree_task_dispatch_shard_t* task) {
-  return (iree_task_dispatch_t*)task->header.completion_task;
-}
-
 void iree_task_dispatch_shard_initialize(iree_task_dispatch_t* dispatch_task,
                                          iree_task_dispatch_shard_t* out_task) {
   iree_task_initialize(IREE_TASK_TYPE_DISPATCH_SHARD,
@@ -742,8 +822,7 @@ void iree_task_dispatch_shard_execute(
          sizeof(tile_context.workgroup_size));
   memcpy(&tile_context.workgroup_count, dispatch_task->workgroup_count.value,
          sizeof(tile_context.workgroup_count));
-  uint32_t workgroup_count_x = tile_context.workgroup_count[0];
-  uint32_t workgroup_count_y = tile_context.workgroup_count[1];
+  const iree_task_tile_order_t tile_order = dispatch_task->tile_order;
   tile_context.local_memory = local_memory;
 
   // We perform all our shard statistics work locally here and only push back to
@@ -759,6 +838,7 @@ void iree_task_dispatch_shard_execute(
   // Loop over all tiles until they are all processed.
   const uint32_t tile_count = dispatch_task->tile_count;
   const uint32_t tiles_per_reservation = dispatch_task->tiles_per_reservation;
+  IREE_STATISTICS(uint32_t shard_tile_count = 0);
   uint32_t tile_base = iree_atomic_fetch_add_int32(&dispatch_task->tile_index,
                                                    tiles_per_reservation,
                                                    iree_memory_order_relaxed);
@@ -769,12 +849,8 @@ void iree_task_dispatch_shard_execute(
          ++tile_index) {
       // TODO(benvanik): faster math here, especially knowing we pull off N
       // sequential indices per reservation.
-      uint32_t tile_i = tile_index;
-      tile_context.workgroup_xyz[0] = tile_i % workgroup_count_x;
-      tile_i /= workgroup_count_x;
-      tile_context.workgroup_xyz[1] = tile_i % workgroup_count_y;
-      tile_i /= workgroup_count_y;
-      tile_context.workgroup_xyz[2] = tile_i;
+      iree_task_tile_order_map(tile_order, tile_context.workgroup_count,
+                               tile_index, tile_context.workgroup_xyz);
 
       IREE_TRACE_ZONE_BEGIN_NAMED(z_tile,
                                   "iree_task_dispatch_shard_execute_tile");
@@ -805,6 +881,7 @@ void iree_task_dispatch_shard_execute(
         goto abort_shard;  // out of the while-for nest
       }
     }
+    IREE_STATISTICS(shard_tile_count += tile_range - tile_base);
 
     // Try to grab the next slice of tiles.
     tile_base = iree_atomic_fetch_add_int32(&dispatch_task->tile_index,
@@ -813,6 +890,17 @@ void iree_task_dispatch_shard_execute(
   }
 abort_shard:
 
+  IREE_STATISTICS({
+    iree_atomic_store_int64(&shard_statistics.tile_count, shard_tile_count,
+                            iree_memory_order_relaxed);
+    if (shard_tile_count > dispatch_task->tiles_per_shard) {
+      iree_atomic_store_int64(
+          &shard_statistics.stolen_tile_count,
+          shard_tile_count - dispatch_task->tiles_per_shard,
+          iree_memory_order_relaxed);
+    }
+  });
+
   // Push aggregate statistics up to the dispatch.
   // Note that we may have partial information here if we errored out of the
   // loop but that's still useful to know.
@@ -492,10 +492,22 @@ void iree_task_wait_set_wait_any(iree_task_wait_t* task,
 // generic ones like 'l2 cache misses' or 'ipc') then we can sprinkle in some
 // #ifdefs.
 typedef struct iree_task_dispatch_statistics_t {
-  // TODO(benvanik): statistics counters.
   // NOTE: each of these increases the command buffer storage requirements; we
   // should always guard these with IREE_STATISTICS_ENABLE.
+#if IREE_STATISTICS_ENABLE
+  // Total number of tiles executed.
+  iree_atomic_int64_t tile_count;
+  // Number of tiles executed by shards in excess of an even split of the grid
+  // across all shards. Shards that start late or run slow have their tiles
+  // taken by the others and a high count relative to tile_count indicates
+  // imbalance between workers (contention, preemption, migration, etc).
+  iree_atomic_int64_t stolen_tile_count;
+  // Total wall time in nanoseconds between dispatches being issued and all of
+  // their shards completing.
+  iree_atomic_int64_t wall_time_ns;
+#else
   iree_atomic_int32_t reserved;
+#endif  // IREE_STATISTICS_ENABLE
 } iree_task_dispatch_statistics_t;
 
 // Merges statistics from |source| to |target| atomically per-field.
@@ -581,6 +593,37 @@ static inline iree_task_dispatch_closure_t iree_task_make_dispatch_closure(
 // IREE_TASK_TYPE_DISPATCH
 //==============================================================================
 
+// Defines the order in which the tiles of a dispatch grid are handed out to
+// shards. Shards reserve contiguous ranges of tile indices and the order
+// controls how those indices map onto the xyz grid. Adjacent indices are
+// processed back-to-back by the same worker or concurrently by neighboring
+// workers so orders that keep adjacent indices close in 2D improve reuse of
+// operands shared across rows and columns (like the LHS/RHS panels of a matmul)
+// in the shared L2/L3 caches.
+//
+// All orders visit every tile exactly once and only differ in the xy plane;
+// z is always the outermost (slowest changing) dimension.
+typedef enum iree_task_tile_order_e {
+  // Row-major: x changes fastest, then y, then z.
+  IREE_TASK_TILE_ORDER_LINEAR = 0,
+  // Z-order (Morton) curve over square blocks of
+  // IREE_TASK_DISPATCH_TILE_ORDER_BLOCK_SIZE tiles in x and y. Blocks are
+  // visited in row-major order and partial blocks at the grid edges fall back
+  // to row-major order within the block.
+  IREE_TASK_TILE_ORDER_MORTON = 1,
+  // Cache-blocked super-tiles: the grid is split into bands of
+  // IREE_TASK_DISPATCH_TILE_ORDER_BLOCK_SIZE rows and each band is walked
+  // column-by-column with y changing fastest. Each x column of tiles reuses the
+  // same operand panel while each band reuses the same set of row panels.
+  IREE_TASK_TILE_ORDER_SUPER_TILE = 2,
+} iree_task_tile_order_t;
+
+// Maps |tile_index| within a |workgroup_count| grid to its xyz coordinates
+// when walked in the given |tile_order|.
+void iree_task_tile_order_map(iree_task_tile_order_t tile_order,
+                              const uint32_t workgroup_count[3],
+                              uint32_t tile_index, uint32_t out_xyz[3]);
+
 // An execution request across a tiled grid.
 // Dispatches are fork points where zero or more dispatch shard tasks are
 // spawned and processed prior to joining again on the dispatch completion task.
@@ -625,6 +668,10 @@ typedef iree_alignas(iree_max_align_t) struct iree_task_dispatch_t {
   // dispatch closure.
   uint32_t local_memory_size;
 
+  // Order in which tiles are walked by the shards of the dispatch.
+  // Defaults to IREE_TASK_TILE_ORDER_LINEAR.
+  iree_task_tile_order_t tile_order;
+
   // Resulting status from the dispatch available once all workgroups have
   // completed (or would have completed). If multiple shards processing the
   // workgroups hit an error the first will be taken and the result ignored. A
@@ -650,6 +697,11 @@ typedef iree_alignas(iree_max_align_t) struct iree_task_dispatch_t {
   // per shard instead of once per slice and are less of a concern.
   iree_atomic_int32_t tile_index;
 
+  // Number of tiles each shard would execute if the grid was evenly divided
+  // and the time the dispatch was issued. Used for statistics.
+  IREE_STATISTICS(uint32_t tiles_per_shard;)
+  IREE_STATISTICS(iree_time_t issue_time_ns;)
+
   // Incrementing process-lifetime dispatch identifier.
   IREE_TRACE(int64_t dispatch_id;)
 } iree_task_dispatch_t;
@@ -102,6 +102,12 @@ void iree_task_dispatch_retire(iree_task_dispatch_t* dispatch_task,
 // IREE_TASK_TYPE_DISPATCH_SHARD
 //==============================================================================
 
+// Returns the dispatch task that |task| is a shard of.
+static inline iree_task_dispatch_t* iree_task_dispatch_shard_parent(
+    iree_task_dispatch_shard_t* task) {
+  return (iree_task_dispatch_t*)task->header.completion_task;
+}
+
 // Allocates a dispatch shard task from the shared executor task pool.
 // The shard will be released back to the pool when it has completed execution.
 iree_task_dispatch_shard_t* iree_task_dispatch_shard_allocate(
@@ -117,6 +123,9 @@ iree_task_dispatch_shard_t* iree_task_dispatch_shard_allocate(
 //
 // |worker_local_memory| is a block of memory exclusively available to the shard
 // during execution. Contents are undefined both before and after execution.
+// Callers should reserve at least the local_memory_size of the parent dispatch
+// (see iree_task_worker_reserve_local_memory) and the shard will fail if less
+// is provided.
 //
 // Errors are propagated to the parent scope and the dispatch will fail once
 // all shards have completed.
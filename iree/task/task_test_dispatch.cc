@@ -6,12 +6,15 @@
 
 #include <cstdint>
 #include <cstdio>
+#include <cstring>
 #include <memory>
+#include <vector>
 
 #include "iree/base/api.h"
 #include "iree/task/submission.h"
 #include "iree/task/task.h"
 #include "iree/task/testing/task_test.h"
+#include "iree/task/tuning.h"
 #include "iree/testing/gtest.h"
 #include "iree/testing/status_matchers.h"
 
@@ -71,7 +74,9 @@ class TaskDispatchTest : public TaskTest {
  public:
   void DispatchAndVerifyGrid(const uint32_t workgroup_size[3],
                              const uint32_t workgroup_count[3],
-                             uint32_t dispatch_flags) {
+                             uint32_t dispatch_flags,
+                             iree_task_tile_order_t tile_order =
+                                 IREE_TASK_TILE_ORDER_LINEAR) {
     IREE_TRACE_SCOPE();
     GridCoverage coverage(workgroup_count);
     iree_task_dispatch_t task;
@@ -80,6 +85,7 @@ class TaskDispatchTest : public TaskTest {
         iree_task_make_dispatch_closure(GridCoverage::Tile, (void*)&coverage),
         workgroup_size, workgroup_count, &task);
     task.header.flags |= dispatch_flags;
+    task.tile_order = tile_order;
     IREE_ASSERT_OK(SubmitTasksAndWaitIdle(&task.header, &task.header));
     EXPECT_TRUE(coverage.Verify());
   }
@@ -113,6 +119,114 @@ TEST_F(TaskDispatchTest, Issue345) {
   DispatchAndVerifyGrid(kWorkgroupSize, kWorkgroupCount, IREE_TASK_FLAG_NONE);
 }
 
+// Tile orders must map the tile indices of any grid 1:1 onto its xyz
+// coordinates, including grids with partial blocks along the edges.
+TEST(TaskTileOrderTest, Bijective) {
+  const uint32_t kWorkgroupCounts[][3] = {
+      {1, 1, 1}, {8, 8, 1}, {16, 24, 2}, {20, 13, 3}, {3, 17, 1}, {33, 1, 2},
+  };
+  for (auto tile_order :
+       {IREE_TASK_TILE_ORDER_LINEAR, IREE_TASK_TILE_ORDER_MORTON,
+        IREE_TASK_TILE_ORDER_SUPER_TILE}) {
+    for (const auto& workgroup_count : kWorkgroupCounts) {
+      uint32_t tile_count =
+          workgroup_count[0] * workgroup_count[1] * workgroup_count[2];
+      std::vector<int> hits(tile_count, 0);
+      for (uint32_t tile_index = 0; tile_index < tile_count; ++tile_index) {
+        uint32_t xyz[3] = {0, 0, 0};
+        iree_task_tile_order_map(tile_order, workgroup_count, tile_index, xyz);
+        ASSERT_LT(xyz[0], workgroup_count[0]);
+        ASSERT_LT(xyz[1], workgroup_count[1]);
+        ASSERT_LT(xyz[2], workgroup_count[2]);
+        ++hits[(xyz[2] * workgroup_count[1] + xyz[1]) * workgroup_count[0] +
+               xyz[0]];
+      }
+      for (uint32_t i = 0; i < tile_count; ++i) {
+        EXPECT_EQ(hits[i], 1) << "tile_order " << tile_order << " slot " << i;
+      }
+    }
+  }
+}
+
+TEST(TaskTileOrderTest, Morton) {
+  const uint32_t kWorkgroupCount[3] = {16, 16, 1};
+  const uint32_t kExpected[][2] = {
+      {0, 0}, {1, 0}, {0, 1}, {1, 1}, {2, 0}, {3, 0}, {2, 1}, {3, 1}, {0, 2},
+  };
+  for (uint32_t i = 0; i < IREE_ARRAYSIZE(kExpected); ++i) {
+    uint32_t xyz[3] = {0, 0, 0};
+    iree_task_tile_order_map(IREE_TASK_TILE_ORDER_MORTON, kWorkgroupCount, i,
+                             xyz);
+    EXPECT_EQ(xyz[0], kExpected[i][0]);
+    EXPECT_EQ(xyz[1], kExpected[i][1]);
+  }
+  // The second block starts after the first 8x8 block is exhausted.
+  uint32_t xyz[3] = {0, 0, 0};
+  iree_task_tile_order_map(IREE_TASK_TILE_ORDER_MORTON, kWorkgroupCount, 64,
+                           xyz);
+  EXPECT_EQ(xyz[0], 8);
+  EXPECT_EQ(xyz[1], 0);
+}
+
+TEST(TaskTileOrderTest, SuperTile) {
+  const uint32_t kWorkgroupCount[3] = {4, 10, 1};
+  uint32_t xyz[3] = {0, 0, 0};
+  // First band of 8 rows is walked column-by-column.
+  iree_task_tile_order_map(IREE_TASK_TILE_ORDER_SUPER_TILE, kWorkgroupCount, 7,
+                           xyz);
+  EXPECT_EQ(xyz[0], 0);
+  EXPECT_EQ(xyz[1], 7);
+  iree_task_tile_order_map(IREE_TASK_TILE_ORDER_SUPER_TILE, kWorkgroupCount, 8,
+                           xyz);
+  EXPECT_EQ(xyz[0], 1);
+  EXPECT_EQ(xyz[1], 0);
+  // Last band only has 2 rows.
+  iree_task_tile_order_map(IREE_TASK_TILE_ORDER_SUPER_TILE, kWorkgroupCount, 33,
+                           xyz);
+  EXPECT_EQ(xyz[0], 0);
+  EXPECT_EQ(xyz[1], 9);
+  iree_task_tile_order_map(IREE_TASK_TILE_ORDER_SUPER_TILE, kWorkgroupCount, 34,
+                           xyz);
+  EXPECT_EQ(xyz[0], 1);
+  EXPECT_EQ(xyz[1], 8);
+}
+
+TEST_F(TaskDispatchTest, IssueMorton) {
+  IREE_TRACE_SCOPE();
+  const uint32_t kWorkgroupSize[3] = {1, 1, 1};
+  const uint32_t kWorkgroupCount[3] = {20, 13, 2};
+  DispatchAndVerifyGrid(kWorkgroupSize, kWorkgroupCount, IREE_TASK_FLAG_NONE,
+                        IREE_TASK_TILE_ORDER_MORTON);
+}
+
+TEST_F(TaskDispatchTest, IssueSuperTile) {
+  IREE_TRACE_SCOPE();
+  const uint32_t kWorkgroupSize[3] = {1, 1, 1};
+  const uint32_t kWorkgroupCount[3] = {20, 13, 2};
+  DispatchAndVerifyGrid(kWorkgroupSize, kWorkgroupCount, IREE_TASK_FLAG_NONE,
+                        IREE_TASK_TILE_ORDER_SUPER_TILE);
+}
+
+#if IREE_STATISTICS_ENABLE
+// Statistics from all shards are merged into the dispatch and then the scope.
+TEST_F(TaskDispatchTest, IssueStatistics) {
+  IREE_TRACE_SCOPE();
+  const uint32_t kWorkgroupSize[3] = {1, 1, 1};
+  const uint32_t kWorkgroupCount[3] = {3, 4, 5};
+  iree_task_scope_consume_statistics(&scope_);
+  DispatchAndVerifyGrid(kWorkgroupSize, kWorkgroupCount, IREE_TASK_FLAG_NONE);
+  iree_task_dispatch_statistics_t statistics =
+      iree_task_scope_consume_statistics(&scope_);
+  EXPECT_EQ(statistics.tile_count, 3 * 4 * 5);
+  EXPECT_LE(statistics.stolen_tile_count, 3 * 4 * 5);
+  EXPECT_GE(statistics.wall_time_ns, 0);
+
+  // Consuming resets the counters.
+  statistics = iree_task_scope_consume_statistics(&scope_);
+  EXPECT_EQ(statistics.tile_count, 0);
+}
+#endif  // IREE_STATISTICS_ENABLE
+
 TEST_F(TaskDispatchTest, IssueIndirect) {
   IREE_TRACE_SCOPE();
 
@@ -149,6 +263,59 @@ TEST_F(TaskDispatchTest, IssueIndirect) {
   EXPECT_TRUE(coverage.Verify());
 }
 
+// Tile that checks it was given exactly the requested amount of local memory
+// and touches all of it.
+static iree_status_t LocalMemoryTile(
+    void* user_context, const iree_task_tile_context_t* tile_context,
+    iree_task_submission_t* pending_submission) {
+  uint32_t expected_size = *reinterpret_cast<uint32_t*>(user_context);
+  if (tile_context->local_memory.data_length != expected_size) {
+    return iree_make_status(IREE_STATUS_INTERNAL,
+                            "expected %ub of local memory but got %zub",
+                            expected_size,
+                            tile_context->local_memory.data_length);
+  }
+  memset(tile_context->local_memory.data, 0xCD,
+         tile_context->local_memory.data_length);
+  return iree_ok_status();
+}
+
+TEST_F(TaskDispatchTest, IssueGrowingLocalMemory) {
+  IREE_TRACE_SCOPE();
+  const uint32_t kWorkgroupSize[3] = {1, 1, 1};
+  const uint32_t kWorkgroupCount[3] = {16, 4, 1};
+
+  // The test executor reserves 64KB per worker; each of these requires the
+  // workers to grow (or reuse what they have grown) their local memory.
+  for (uint32_t local_memory_size :
+       {256 * 1024u, 4 * 1024 * 1024u, 128 * 1024u, 64 * 1024u}) {
+    iree_task_dispatch_t task;
+    iree_task_dispatch_initialize(
+        &scope_,
+        iree_task_make_dispatch_closure(LocalMemoryTile, &local_memory_size),
+        kWorkgroupSize, kWorkgroupCount, &task);
+    task.local_memory_size = local_memory_size;
+    IREE_ASSERT_OK(SubmitTasksAndWaitIdle(&task.header, &task.header));
+    IREE_EXPECT_OK(iree_task_scope_consume_status(&scope_));
+  }
+}
+
+TEST_F(TaskDispatchTest, IssueLocalMemoryExhausted) {
+  IREE_TRACE_SCOPE();
+  const uint32_t kWorkgroupSize[3] = {1, 1, 1};
+  const uint32_t kWorkgroupCount[3] = {4, 1, 1};
+  uint32_t local_memory_size = IREE_TASK_WORKER_MAX_LOCAL_MEMORY_SIZE + 1;
+  iree_task_dispatch_t task;
+  iree_task_dispatch_initialize(
+      &scope_,
+      iree_task_make_dispatch_closure(LocalMemoryTile, &local_memory_size),
+      kWorkgroupSize, kWorkgroupCount, &task);
+  task.local_memory_size = local_memory_size;
+  IREE_ASSERT_OK(SubmitTasksAndWaitIdle(&task.header, &task.header));
+  EXPECT_THAT(Status(iree_task_scope_consume_status(&scope_)),
+              StatusIs(StatusCode::kResourceExhausted));
+}
+
 TEST_F(TaskDispatchTest, IssueFailure) {
   IREE_TRACE_SCOPE();
 
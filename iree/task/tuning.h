@@ -93,6 +93,28 @@ extern "C" {
 // memory).
 #define IREE_TASK_DISPATCH_MAX_TILES_PER_SHARD_RESERVATION (8)
 
+// Width and height in tiles of the blocks used by the Morton and super-tile
+// dispatch tile orders (see iree_task_tile_order_t). Must be a power of two.
+//
+// Larger blocks reuse each operand panel across more tiles but increase the
+// working set that must remain resident in the shared caches for that reuse to
+// happen.
+#define IREE_TASK_DISPATCH_TILE_ORDER_BLOCK_SIZE (8)
+
+// Maximum size that the local memory of each worker may grow to in order to
+// satisfy dispatches requiring more than the initial reservation made when the
+// executor is created. Grown memory is retained by the worker across
+// dispatches so this also bounds the steady-state memory consumption of each
+// worker. Dispatches requiring more than this will fail.
+#define IREE_TASK_WORKER_MAX_LOCAL_MEMORY_SIZE (64 * 1024 * 1024)
+
+// Whether grown worker local memory blocks of at least one transparent huge
+// page (as queried from the system) are mapped directly from the OS, aligned
+// to the huge page size, and hinted to be backed by huge pages. Packing
+// buffers tend to be walked in their entirety by every tile and TLB misses
+// quickly add up with 4KB pages.
+#define IREE_TASK_WORKER_LOCAL_MEMORY_USE_HUGE_PAGES 1
+
 // Whether to enable per-tile colors for each tile tracing zone based on the
 // tile grid xyz. Not cheap and can be disabled to reduce tracing overhead.
 // TODO(#4017): make per-tile color tracing fast enough to always have on.
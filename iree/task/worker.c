@@ -10,6 +10,7 @@
 #include <string.h>
 
 #include "iree/base/internal/fpu_state.h"
+#include "iree/base/internal/huge_pages.h"
 #include "iree/base/internal/math.h"
 #include "iree/base/tracing.h"
 #include "iree/task/executor_impl.h"
@@ -107,6 +108,83 @@ void iree_task_worker_request_exit(iree_task_worker_t* worker) {
   IREE_TRACE_ZONE_END(z0);
 }
 
+//===----------------------------------------------------------------------===//
+// Worker local memory
+//===----------------------------------------------------------------------===//
+
+// Releases the grown local memory block, if any, and resets the worker local
+// memory to an empty span.
+static void iree_task_worker_free_local_memory_heap(
+    iree_task_worker_t* worker) {
+  if (!worker->local_memory_heap) return;
+  if (worker->local_memory_heap_mapped) {
+    iree_huge_page_unmap(worker->local_memory_heap,
+                         worker->local_memory.data_length);
+  } else {
+    iree_allocator_free_aligned(worker->executor->allocator,
+                                worker->local_memory_heap);
+  }
+  worker->local_memory_heap = NULL;
+  worker->local_memory_heap_mapped = false;
+  worker->local_memory = iree_make_byte_span(NULL, 0);
+}
+
+iree_status_t iree_task_worker_reserve_local_memory(
+    iree_task_worker_t* worker, iree_host_size_t minimum_size) {
+  if (IREE_LIKELY(minimum_size <= worker->local_memory.data_length)) {
+    return iree_ok_status();
+  }
+  if (minimum_size > IREE_TASK_WORKER_MAX_LOCAL_MEMORY_SIZE) {
+    return iree_make_status(
+        IREE_STATUS_RESOURCE_EXHAUSTED,
+        "dispatch requires %zub of local memory but workers are limited to "
+        "%db (IREE_TASK_WORKER_MAX_LOCAL_MEMORY_SIZE)",
+        minimum_size, IREE_TASK_WORKER_MAX_LOCAL_MEMORY_SIZE);
+  }
+  IREE_TRACE_ZONE_BEGIN(z0);
+
+  // Grow geometrically so that a sequence of dispatches with slowly increasing
+  // requirements doesn't reallocate each time.
+  iree_host_size_t new_size = iree_max(
+      iree_math_round_up_to_pow2_u64(minimum_size),
+      2 * worker->local_memory.data_length);
+  new_size = iree_min(new_size, IREE_TASK_WORKER_MAX_LOCAL_MEMORY_SIZE);
+  IREE_TRACE_ZONE_APPEND_VALUE(z0, (int64_t)new_size);
+
+  // The old contents are scratch and don't need to be preserved so we drop the
+  // old block first to keep peak usage down.
+  iree_task_worker_free_local_memory_heap(worker);
+
+  void* new_heap = NULL;
+  bool new_heap_mapped = false;
+#if IREE_TASK_WORKER_LOCAL_MEMORY_USE_HUGE_PAGES
+  // Huge pages can be much larger than 2MB (512MB with 64KB base pages on
+  // arm64) in which case rounding up would exceed the local memory limit.
+  const iree_host_size_t huge_page_size = iree_huge_page_size();
+  if (huge_page_size && new_size >= huge_page_size &&
+      huge_page_size <= IREE_TASK_WORKER_MAX_LOCAL_MEMORY_SIZE) {
+    new_size = iree_host_align(new_size, huge_page_size);
+    new_heap = iree_huge_page_map(new_size, huge_page_size,
+                                  IREE_HUGE_PAGE_MAP_FLAG_ADVISE_HUGE);
+    new_heap_mapped = new_heap != NULL;
+  }
+#endif  // IREE_TASK_WORKER_LOCAL_MEMORY_USE_HUGE_PAGES
+  iree_status_t status = iree_ok_status();
+  if (!new_heap) {
+    status = iree_allocator_malloc_aligned(
+        worker->executor->allocator, new_size,
+        iree_hardware_destructive_interference_size, 0, &new_heap);
+  }
+  if (iree_status_is_ok(status)) {
+    worker->local_memory_heap = new_heap;
+    worker->local_memory_heap_mapped = new_heap_mapped;
+    worker->local_memory = iree_make_byte_span(new_heap, new_size);
+  }
+
+  IREE_TRACE_ZONE_END(z0);
+  return status;
+}
+
 // Returns true if the worker is in the zombie state (exited and awaiting
 // teardown).
 static bool iree_task_worker_is_zombie(iree_task_worker_t* worker) {
@@ -140,6 +218,8 @@ void iree_task_worker_deinitialize(iree_task_worker_t* worker) {
   iree_atomic_task_slist_deinitialize(&worker->mailbox_slist);
   iree_task_queue_deinitialize(&worker->local_task_queue);
 
+  iree_task_worker_free_local_memory_heap(worker);
+
   IREE_TRACE_ZONE_END(z0);
 }
 
@@ -188,9 +268,16 @@ static void iree_task_worker_execute(
       break;
     }
     case IREE_TASK_TYPE_DISPATCH_SHARD: {
-      iree_task_dispatch_shard_execute(
-          (iree_task_dispatch_shard_t*)task, worker->processor_id,
-          worker->local_memory, pending_submission);
+      // Grow the worker local memory if the dispatch requires more than we
+      // have. On failure we leave it as-is and let the shard report the error.
+      iree_task_dispatch_shard_t* shard_task =
+          (iree_task_dispatch_shard_t*)task;
+      iree_status_ignore(iree_task_worker_reserve_local_memory(
+          worker,
+          iree_task_dispatch_shard_parent(shard_task)->local_memory_size));
+      iree_task_dispatch_shard_execute(shard_task, worker->processor_id,
+                                       worker->local_memory,
+                                       pending_submission);
       break;
     }
     default:
@@ -7,6 +7,7 @@
 #ifndef IREE_TASK_WORKER_H_
 #define IREE_TASK_WORKER_H_
 
+#include <stdbool.h>
 #include <stddef.h>
 #include <stdint.h>
 
@@ -133,9 +134,18 @@ typedef struct iree_task_worker_t {
 
   // Pointer to local memory available for use exclusively by the worker.
   // The base address should be aligned to avoid false sharing with other
-  // workers.
+  // workers. This starts as the reservation made by the executor and is grown
+  // on demand by iree_task_worker_reserve_local_memory.
   iree_byte_span_t local_memory;
 
+  // Block backing |local_memory| once it has been grown beyond the initial
+  // reservation or NULL if the reservation is still in use. Retained across
+  // dispatches and only released when the worker is deinitialized.
+  void* local_memory_heap;
+  // True if |local_memory_heap| was mapped from the OS instead of allocated
+  // from the executor allocator.
+  bool local_memory_heap_mapped;
+
   // Worker-local FIFO queue containing the tasks that will be processed by the
   // worker. This queue supports work-stealing by other workers if they run out
   // of work of their own.
@@ -165,6 +175,15 @@ iree_status_t iree_task_worker_initialize(
 // the IREE_TASK_WORKER_STATE_ZOMBIE state.
 void iree_task_worker_deinitialize(iree_task_worker_t* worker);
 
+// Ensures that the worker has at least |minimum_size| bytes of local memory
+// available in |worker->local_memory|, growing it if required. Growth is
+// geometric and capped at IREE_TASK_WORKER_MAX_LOCAL_MEMORY_SIZE; the previous
+// contents are not preserved.
+//
+// Must only be called from the worker thread.
+iree_status_t iree_task_worker_reserve_local_memory(
+    iree_task_worker_t* worker, iree_host_size_t minimum_size);
+
 // Requests that the worker begin exiting (if it hasn't already).
 // If the worker is actively processing tasks it will wait until it has
 // completed all it can and is about to go idle prior to exiting.
@@ -0,0 +1,109 @@
+// This test compares f32 matmuls and convolutions quantized to int8 by
+// -iree-opt-int8-quantization against the same ops computed in f32.
+//
+// Only ops with constant weights are quantized so the reference ops read their
+// weights through util.unfoldable_constant to keep them in f32. Activations
+// are unfoldable as well, so the activation scale is computed at runtime.
+//
+// For values in [-1, 1] the symmetric int8 quantization error is well below
+// the tolerance used here, while a wrong scale or rounding would produce
+// errors on the order of the results themselves.
+
+// Returns 1 if max(|lhs - rhs|) <= %tolerance and 0 otherwise.
+func.func private @all_close(%lhs: tensor<?xf32>, %rhs: tensor<?xf32>, %tolerance: f32) -> i32 {
+  %zero = arith.constant 0.0 : f32
+  %init = linalg.init_tensor [] : tensor<f32>
+  %fill = linalg.fill ins(%zero : f32) outs(%init : tensor<f32>) -> tensor<f32>
+  %max_diff = linalg.generic {
+      indexing_maps = [affine_map<(d0) -> (d0)>,
+                       affine_map<(d0) -> (d0)>,
+                       affine_map<(d0) -> ()>],
+      iterator_types = ["reduction"]}
+      ins(%lhs, %rhs : tensor<?xf32>, tensor<?xf32>)
+      outs(%fill : tensor<f32>) {
+      ^bb0(%l: f32, %r: f32, %acc: f32):
+        %diff = arith.subf %l, %r : f32
+        %neg_diff = arith.negf %diff : f32
+        %abs_diff = arith.maxf %diff, %neg_diff : f32
+        %max = arith.maxf %acc, %abs_diff : f32
+        linalg.yield %max : f32
+      } -> tensor<f32>
+  %max_diff_scalar = tensor.extract %max_diff[] : tensor<f32>
+  %close = arith.cmpf ole, %max_diff_scalar, %tolerance : f32
+  %close_i32 = arith.extui %close : i1 to i32
+  return %close_i32 : i32
+}
+
+func.func @matmul_4x8x4() {
+  %lhs = util.unfoldable_constant dense<[
+      [-0.87, -0.17, -0.78, 0.50, 0.02, -0.90, -0.91, 0.47],
+      [-0.69, 0.47, 0.26, 0.01, 0.71, 0.21, 0.15, -0.20],
+      [-0.50, -0.72, -0.15, -0.25, 0.54, -0.46, -0.20, 0.89],
+      [0.24, 0.32, 0.38, 0.82, -0.59, 0.54, -0.87, -0.49]]> : tensor<4x8xf32>
+  %rhs = arith.constant dense<[
+      [0.19, -0.36, -0.02, -0.56],
+      [-0.49, -0.13, 0.22, 0.39],
+      [0.00, -0.24, 0.93, 0.55],
+      [0.10, 0.08, -0.70, -0.60],
+      [-0.83, 0.88, 0.66, -0.87],
+      [0.39, -0.25, 0.33, -0.13],
+      [-0.34, -0.85, -0.61, -0.15],
+      [0.43, -0.68, -0.12, 0.93]]> : tensor<8x4xf32>
+  %rhs_f32 = util.unfoldable_constant dense<[
+      [0.19, -0.36, -0.02, -0.56],
+      [-0.49, -0.13, 0.22, 0.39],
+      [0.00, -0.24, 0.93, 0.55],
+      [0.10, 0.08, -0.70, -0.60],
+      [-0.83, 0.88, 0.66, -0.87],
+      [0.39, -0.25, 0.33, -0.13],
+      [-0.34, -0.85, -0.61, -0.15],
+      [0.43, -0.68, -0.12, 0.93]]> : tensor<8x4xf32>
+  %zero = arith.constant 0.0 : f32
+  %init = linalg.init_tensor [4, 4] : tensor<4x4xf32>
+  %fill = linalg.fill ins(%zero : f32) outs(%init : tensor<4x4xf32>) -> tensor<4x4xf32>
+  %quantized = linalg.matmul ins(%lhs, %rhs : tensor<4x8xf32>, tensor<8x4xf32>) outs(%fill : tensor<4x4xf32>) -> tensor<4x4xf32>
+  %reference = linalg.matmul ins(%lhs, %rhs_f32 : tensor<4x8xf32>, tensor<8x4xf32>) outs(%fill : tensor<4x4xf32>) -> tensor<4x4xf32>
+  %quantized_1d = tensor.collapse_shape %quantized [[0, 1]] : tensor<4x4xf32> into tensor<16xf32>
+  %reference_1d = tensor.collapse_shape %reference [[0, 1]] : tensor<4x4xf32> into tensor<16xf32>
+  %quantized_dyn = tensor.cast %quantized_1d : tensor<16xf32> to tensor<?xf32>
+  %reference_dyn = tensor.cast %reference_1d : tensor<16xf32> to tensor<?xf32>
+  %tolerance = arith.constant 0.03 : f32
+  %close = call @all_close(%quantized_dyn, %reference_dyn, %tolerance) : (tensor<?xf32>, tensor<?xf32>, f32) -> i32
+  check.expect_true(%close) : i32
+  return
+}
+
+func.func @conv_2d_nhwc_hwcf_1x4x4x2_3x3x2x2() {
+  %input = util.unfoldable_constant dense<[[
+      [[-0.79, -0.19], [0.71, 0.30], [0.90, 0.21], [0.29, -0.54]],
+      [[-0.19, 0.05], [0.74, 0.34], [-0.26, 0.76], [0.23, 0.45]],
+      [[-0.65, -0.47], [0.19, -0.14], [-0.49, 0.84], [0.92, 0.35]],
+      [[0.95, 0.44], [-0.09, -0.76], [0.13, 0.81], [0.14, 0.48]]]]> : tensor<1x4x4x2xf32>
+  %filter = arith.constant dense<[
+      [[[-0.25, -0.95], [0.02, -0.31]], [[0.13, 0.95], [0.90, 0.83]], [[0.30, 0.05], [0.08, 0.84]]],
+      [[[-0.98, -0.93], [-0.84, -0.10]], [[0.98, 0.80], [0.12, 0.90]], [[0.45, 0.63], [-0.48, -0.77]]],
+      [[[-0.56, 0.71], [0.76, 0.18]], [[-0.69, -0.20], [-0.46, 0.17]], [[0.52, 0.72], [0.21, -0.38]]]]> : tensor<3x3x2x2xf32>
+  %filter_f32 = util.unfoldable_constant dense<[
+      [[[-0.25, -0.95], [0.02, -0.31]], [[0.13, 0.95], [0.90, 0.83]], [[0.30, 0.05], [0.08, 0.84]]],
+      [[[-0.98, -0.93], [-0.84, -0.10]], [[0.98, 0.80], [0.12, 0.90]], [[0.45, 0.63], [-0.48, -0.77]]],
+      [[[-0.56, 0.71], [0.76, 0.18]], [[-0.69, -0.20], [-0.46, 0.17]], [[0.52, 0.72], [0.21, -0.38]]]]> : tensor<3x3x2x2xf32>
+  %zero = arith.constant 0.0 : f32
+  %init = linalg.init_tensor [1, 2, 2, 2] : tensor<1x2x2x2xf32>
+  %fill = linalg.fill ins(%zero : f32) outs(%init : tensor<1x2x2x2xf32>) -> tensor<1x2x2x2xf32>
+  %quantized = linalg.conv_2d_nhwc_hwcf
+      {dilations = dense<1> : tensor<2xi64>, strides = dense<1> : tensor<2xi64>}
+      ins(%input, %filter : tensor<1x4x4x2xf32>, tensor<3x3x2x2xf32>)
+      outs(%fill : tensor<1x2x2x2xf32>) -> tensor<1x2x2x2xf32>
+  %reference = linalg.conv_2d_nhwc_hwcf
+      {dilations = dense<1> : tensor<2xi64>, strides = dense<1> : tensor<2xi64>}
+      ins(%input, %filter_f32 : tensor<1x4x4x2xf32>, tensor<3x3x2x2xf32>)
+      outs(%fill : tensor<1x2x2x2xf32>) -> tensor<1x2x2x2xf32>
+  %quantized_1d = tensor.collapse_shape %quantized [[0, 1, 2, 3]] : tensor<1x2x2x2xf32> into tensor<8xf32>
+  %reference_1d = tensor.collapse_shape %reference [[0, 1, 2, 3]] : tensor<1x2x2x2xf32> into tensor<8xf32>
+  %quantized_dyn = tensor.cast %quantized_1d : tensor<8xf32> to tensor<?xf32>
+  %reference_dyn = tensor.cast %reference_1d : tensor<8xf32> to tensor<?xf32>
+  %tolerance = arith.constant 0.03 : f32
+  %close = call @all_close(%quantized_dyn, %reference_dyn, %tolerance) : (tensor<?xf32>, tensor<?xf32>, f32) -> i32
+  check.expect_true(%close) : i32
+  return
+}
@@ -75,6 +75,12 @@
 #include "iree/vm/bytecode_module.h"
 #include "iree/vm/ref_cc.h"
 
+#if defined(IREE_HAL_HAVE_DYLIB_DRIVER_MODULE) || \
+    defined(IREE_HAL_HAVE_VMVX_DRIVER_MODULE)
+#include "iree/hal/local/task_device.h"
+#define IREE_BENCHMARK_HAVE_TASK_DEVICE 1
+#endif  // IREE_HAL_HAVE_DYLIB_DRIVER_MODULE || IREE_HAL_HAVE_VMVX_DRIVER_MODULE
+
 IREE_FLAG(string, module_file, "-",
           "File containing the module to load that contains the entry "
           "function. Defaults to stdin.");
@@ -94,7 +100,9 @@ IREE_FLAG(string, entry_function, "",
 IREE_FLAG(string, driver, "vmvx", "Backend driver to use.");
 
 IREE_FLAG(bool, print_statistics, false,
-          "Prints runtime statistics to stderr on exit.");
+          "Prints runtime statistics to stderr on exit. Per-dispatch "
+          "statistics are included for task system devices created with "
+          "dispatch statistics enabled (`--dylib_dispatch_statistics`).");
 
 static iree_status_t parse_function_input(iree_string_view_t flag_name,
                                           void* storage,
@@ -277,6 +285,10 @@ class IREEBenchmark {
     if (FLAG_print_statistics) {
       IREE_IGNORE_ERROR(iree_hal_allocator_statistics_fprint(
           stderr, iree_hal_device_allocator(device_)));
+#if defined(IREE_BENCHMARK_HAVE_TASK_DEVICE)
+      IREE_IGNORE_ERROR(
+          iree_hal_task_device_fprint_dispatch_statistics(stderr, device_));
+#endif  // IREE_BENCHMARK_HAVE_TASK_DEVICE
     }
     iree_hal_device_release(device_);
     iree_vm_instance_release(instance_);
@@ -0,0 +1,26 @@
+// Checks that splitting the LLVM library module into multiple code generation
+// partitions produces the same results as compiling it as a single object.
+
+// RUN: (iree-compile --iree-hal-target-backends=dylib-llvm-aot --iree-llvm-codegen-partitions=1 -iree-mlir-to-vm-bytecode-module %s | iree-run-module --driver=dylib --entry_function=matmul_sum --function_input="2x3xf32=[1 2 3][4 5 6]" --function_input="3x2xf32=[1 2][3 4][5 6]") | FileCheck %s
+// RUN: (iree-compile --iree-hal-target-backends=dylib-llvm-aot --iree-llvm-codegen-partitions=16 -iree-mlir-to-vm-bytecode-module %s | iree-run-module --driver=dylib --entry_function=matmul_sum --function_input="2x3xf32=[1 2 3][4 5 6]" --function_input="3x2xf32=[1 2][3 4][5 6]") | FileCheck %s
+
+// CHECK-LABEL: EXEC @matmul_sum
+func.func @matmul_sum(%lhs : tensor<2x3xf32>, %rhs : tensor<3x2xf32>) -> (tensor<2x2xf32>, tensor<2xf32>) {
+  %zero = arith.constant 0.0 : f32
+  %matmul_init = linalg.init_tensor [2, 2] : tensor<2x2xf32>
+  %matmul_fill = linalg.fill ins(%zero : f32) outs(%matmul_init : tensor<2x2xf32>) -> tensor<2x2xf32>
+  %matmul = linalg.matmul ins(%lhs, %rhs : tensor<2x3xf32>, tensor<3x2xf32>) outs(%matmul_fill : tensor<2x2xf32>) -> tensor<2x2xf32>
+  %sum_init = linalg.init_tensor [2] : tensor<2xf32>
+  %sum_fill = linalg.fill ins(%zero : f32) outs(%sum_init : tensor<2xf32>) -> tensor<2xf32>
+  %sum = linalg.generic {
+    indexing_maps = [affine_map<(d0, d1) -> (d0, d1)>, affine_map<(d0, d1) -> (d0)>],
+    iterator_types = ["parallel", "reduction"]
+  } ins(%matmul : tensor<2x2xf32>) outs(%sum_fill : tensor<2xf32>) {
+  ^bb0(%value : f32, %accum : f32):
+    %add = arith.addf %value, %accum : f32
+    linalg.yield %add : f32
+  } -> tensor<2xf32>
+  return %matmul, %sum : tensor<2x2xf32>, tensor<2xf32>
+}
+// CHECK: 2x2xf32=[22 28][49 64]
+// CHECK: 2xf32=50 113
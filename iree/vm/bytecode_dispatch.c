@@ -462,31 +462,71 @@ static void iree_vm_bytecode_populate_import_cconv_arguments(
 }
 
 // Issues a populated import call and marshals the results into |dst_reg_list|.
+// If the callee yields the caller frame is left on the stack such that resuming
+// it continues at the right place: |call_pc| when the callee unwound and the
+// import must be reissued or after the call when the callee frames remain.
 static iree_status_t iree_vm_bytecode_issue_import_call(
-    iree_vm_stack_t* stack, const iree_vm_function_call_t call,
-    iree_string_view_t cconv_results,
+    iree_vm_stack_t* stack, const iree_vm_bytecode_import_t* import,
+    const iree_vm_function_call_t call, iree_vm_source_offset_t call_pc,
     const iree_vm_register_list_t* IREE_RESTRICT dst_reg_list,
     iree_vm_stack_frame_t** out_caller_frame,
     iree_vm_registers_t* out_caller_registers,
     iree_vm_execution_result_t* out_result) {
-  // Call external function.
-  iree_status_t call_status = call.function.module->begin_call(
-      call.function.module->self, stack, &call, out_result);
-  if (IREE_UNLIKELY(!iree_status_is_ok(call_status))) {
+  // Stash the destination register list for result values on the caller in
+  // case a bytecode callee yields with its frames on the stack: when resumed
+  // its entry frame returns directly into our frame as with internal calls.
+  // Frame pointers are not stable across the call as the stack may grow so we
+  // track our frame by depth.
+  iree_vm_stack_frame_t* caller_frame = iree_vm_stack_current_frame(stack);
+  const int32_t caller_depth = caller_frame->depth;
+  iree_vm_bytecode_frame_storage_t* caller_storage =
+      (iree_vm_bytecode_frame_storage_t*)iree_vm_stack_frame_storage(
+          caller_frame);
+  caller_storage->return_registers = dst_reg_list;
+
+  // Call external function. Native functions resolved during import linking
+  // skip the module interface dispatch; arguments are still marshaled into
+  // the packed |call| buffers for the shim.
+  iree_status_t call_status;
+  if (import->resolved_function.shim) {
+    call_status = iree_vm_native_module_issue_resolved_call(
+        &import->resolved_function, stack, &call, out_result);
+  } else {
+    call_status = call.function.module->begin_call(
+        call.function.module->self, stack, &call, out_result);
+  }
+  if (IREE_UNLIKELY(iree_status_is_deferred(call_status))) {
+    *out_caller_frame = iree_vm_stack_current_frame(stack);
+    if ((*out_caller_frame)->depth == caller_depth) {
+      // The callee would have blocked and unwound its frames (such as a native
+      // import polling a wait). Our frame is still on the top of the stack but
+      // the stack storage may have moved. Rewind so that the import is reissued
+      // when resumed.
+      (*out_caller_frame)->pc = call_pc;
+      *out_caller_registers =
+          iree_vm_bytecode_get_register_storage(*out_caller_frame);
+    } else {
+      // The callee yielded with its frames on the stack (such as a bytecode
+      // function executing vm.yield). Resuming continues in the top frame and
+      // our frame will receive the results via |dst_reg_list| when the callee
+      // returns; our pc has already been advanced past the call.
+    }
+    return call_status;
+  } else if (IREE_UNLIKELY(!iree_status_is_ok(call_status))) {
     // TODO(benvanik): set execution result to failure/capture stack.
     return iree_status_annotate(call_status,
                                 iree_make_cstring_view("while calling import"));
   }
 
-  // NOTE: we don't support yielding within imported functions right now so it's
-  // safe to assume the stack is still valid here. If the called function can
-  // yield then we'll need to requery all pointers here.
+  // NOTE: the stack may have grown during the call and we need to requery all
+  // pointers here.
   *out_caller_frame = iree_vm_stack_current_frame(stack);
   *out_caller_registers =
       iree_vm_bytecode_get_register_storage(*out_caller_frame);
 
   // Marshal outputs from the ABI results buffer to registers.
   iree_vm_registers_t caller_registers = *out_caller_registers;
+  iree_string_view_t cconv_results = import->results;
   uint8_t* IREE_RESTRICT p = call.results.data;
   for (iree_host_size_t i = 0; i < cconv_results.size && i < dst_reg_list->size;
        ++i) {
@@ -519,12 +559,53 @@ static iree_status_t iree_vm_bytecode_issue_import_call(
   return iree_ok_status();
 }
 
+// Issues an import call through its register-level native implementation.
+// Arguments are read from |src_reg_list| and results written to |dst_reg_list|
+// directly by the callee without marshaling through ABI storage.
+static iree_status_t iree_vm_bytecode_issue_import_register_call(
+    iree_vm_stack_t* stack, const iree_vm_bytecode_import_t* import,
+    iree_vm_source_offset_t call_pc, const iree_vm_registers_t caller_registers,
+    const iree_vm_register_list_t* IREE_RESTRICT segment_size_list,
+    const iree_vm_register_list_t* IREE_RESTRICT src_reg_list,
+    const iree_vm_register_list_t* IREE_RESTRICT dst_reg_list,
+    iree_vm_stack_frame_t** out_caller_frame,
+    iree_vm_registers_t* out_caller_registers,
+    iree_vm_execution_result_t* out_result) {
+  const iree_vm_register_call_t call = {
+      .i32_mask = caller_registers.i32_mask,
+      .i32 = caller_registers.i32,
+      .ref_mask = caller_registers.ref_mask,
+      .ref = caller_registers.ref,
+      .segment_sizes = segment_size_list,
+      .arguments = src_reg_list,
+      .results = dst_reg_list,
+  };
+  iree_status_t call_status = iree_vm_native_module_issue_register_call(
+      &import->function, import->resolved_register_function, stack, &call,
+      out_result);
+
+  // Register calls never push frames so our frame remains on the top of the
+  // stack and the register storage has not moved.
+  *out_caller_frame = iree_vm_stack_current_frame(stack);
+  *out_caller_registers = caller_registers;
+  if (IREE_UNLIKELY(iree_status_is_deferred(call_status))) {
+    // Rewind so that the import is reissued when resumed.
+    (*out_caller_frame)->pc = call_pc;
+    return call_status;
+  } else if (IREE_UNLIKELY(!iree_status_is_ok(call_status))) {
+    return iree_status_annotate(call_status,
+                                iree_make_cstring_view("while calling import"));
+  }
+  return iree_ok_status();
+}
+
 // Calls an imported function from another module.
 // Marshals the |src_reg_list| registers into ABI storage and results into
 // |dst_reg_list|.
 static iree_status_t iree_vm_bytecode_call_import(
     iree_vm_stack_t* stack, const iree_vm_bytecode_module_state_t* module_state,
-    uint32_t import_ordinal, const iree_vm_registers_t caller_registers,
+    uint32_t import_ordinal, iree_vm_source_offset_t call_pc,
+    const iree_vm_registers_t caller_registers,
     const iree_vm_register_list_t* IREE_RESTRICT src_reg_list,
     const iree_vm_register_list_t* IREE_RESTRICT dst_reg_list,
     iree_vm_stack_frame_t** out_caller_frame,
@@ -538,25 +619,35 @@ static iree_status_t iree_vm_bytecode_call_import(
   }
   const iree_vm_bytecode_import_t* import =
       &module_state->import_table[import_ordinal];
+  if (import->resolved_register_function) {
+    return iree_vm_bytecode_issue_import_register_call(
+        stack, import, call_pc, caller_registers,
+        /*segment_size_list=*/NULL, src_reg_list, dst_reg_list,
+        out_caller_frame, out_caller_registers, out_result);
+  }
   iree_vm_function_call_t call;
   memset(&call, 0, sizeof(call));
   call.function = import->function;
 
+  // Fixed signatures have precomputed sizes so both the argument and result
+  // buffers can come from a single stack allocation.
+  iree_host_size_t storage_size =
+      import->argument_buffer_size + import->result_buffer_size;
+  uint8_t* storage = (uint8_t*)iree_alloca(storage_size);
+  memset(storage, 0, storage_size);
+  call.arguments = iree_make_byte_span(storage, import->argument_buffer_size);
+  call.results = iree_make_byte_span(storage + import->argument_buffer_size,
+                                     import->result_buffer_size);
+
   // Marshal inputs from registers to the ABI arguments buffer.
-  call.arguments.data_length = import->argument_buffer_size;
-  call.arguments.data = iree_alloca(call.arguments.data_length);
-  memset(call.arguments.data, 0, call.arguments.data_length);
   iree_vm_bytecode_populate_import_cconv_arguments(
       import->arguments, caller_registers,
       /*segment_size_list=*/NULL, src_reg_list, call.arguments);
 
   // Issue the call and handle results.
-  call.results.data_length = import->result_buffer_size;
-  call.results.data = iree_alloca(call.results.data_length);
-  memset(call.results.data, 0, call.results.data_length);
-  return iree_vm_bytecode_issue_import_call(stack, call, import->results,
-                                            dst_reg_list, out_caller_frame,
-                                            out_caller_registers, out_result);
+  return iree_vm_bytecode_issue_import_call(
+      stack, import, call, call_pc, dst_reg_list, out_caller_frame,
+      out_caller_registers, out_result);
 }
 
 // Calls a variadic imported function from another module.
@@ -564,7 +655,8 @@ static iree_status_t iree_vm_bytecode_call_import(
 // |dst_reg_list|. |segment_size_list| contains the counts within each segment.
 static iree_status_t iree_vm_bytecode_call_import_variadic(
     iree_vm_stack_t* stack, const iree_vm_bytecode_module_state_t* module_state,
-    uint32_t import_ordinal, const iree_vm_registers_t caller_registers,
+    uint32_t import_ordinal, iree_vm_source_offset_t call_pc,
+    const iree_vm_registers_t caller_registers,
     const iree_vm_register_list_t* IREE_RESTRICT segment_size_list,
     const iree_vm_register_list_t* IREE_RESTRICT src_reg_list,
     const iree_vm_register_list_t* IREE_RESTRICT dst_reg_list,
@@ -579,6 +671,12 @@ static iree_status_t iree_vm_bytecode_call_import_variadic(
   }
   const iree_vm_bytecode_import_t* import =
       &module_state->import_table[import_ordinal];
+  if (import->resolved_register_function) {
+    return iree_vm_bytecode_issue_import_register_call(
+        stack, import, call_pc, caller_registers, segment_size_list,
+        src_reg_list, dst_reg_list, out_caller_frame, out_caller_registers,
+        out_result);
+  }
   iree_vm_function_call_t call;
   memset(&call, 0, sizeof(call));
   call.function = import->function;
@@ -599,34 +697,26 @@ static iree_status_t iree_vm_bytecode_call_import_variadic(
   call.results.data_length = import->result_buffer_size;
   call.results.data = iree_alloca(call.results.data_length);
   memset(call.results.data, 0, call.results.data_length);
-  return iree_vm_bytecode_issue_import_call(stack, call, import->results,
-                                            dst_reg_list, out_caller_frame,
-                                            out_caller_registers, out_result);
+  return iree_vm_bytecode_issue_import_call(
+      stack, import, call, call_pc, dst_reg_list, out_caller_frame,
+      out_caller_registers, out_result);
 }
 
 //===----------------------------------------------------------------------===//
 // Main interpreter dispatch routine
 //===----------------------------------------------------------------------===//
 
-iree_status_t iree_vm_bytecode_dispatch(
+// Executes bytecode starting at the |current_frame| pc until either the frame
+// at |entry_frame_depth| returns or execution yields.
+static iree_status_t iree_vm_bytecode_dispatch(
     iree_vm_stack_t* stack, iree_vm_bytecode_module_t* module,
-    const iree_vm_function_call_t* call, iree_string_view_t cconv_arguments,
+    iree_vm_stack_frame_t* current_frame, iree_vm_registers_t regs,
+    const int32_t entry_frame_depth, const iree_vm_function_call_t* call,
     iree_string_view_t cconv_results, iree_vm_execution_result_t* out_result) {
-  memset(out_result, 0, sizeof(*out_result));
-
   // When required emit the dispatch tables here referencing the labels we are
   // defining below.
   DEFINE_DISPATCH_TABLES();
 
-  // Enter function (as this is the initial call).
-  // The callee's return will take care of storing the output registers when it
-  // actually does return, either immediately or in the future via a resume.
-  iree_vm_stack_frame_t* current_frame = NULL;
-  iree_vm_registers_t regs;
-  IREE_RETURN_IF_ERROR(
-      iree_vm_bytecode_external_enter(stack, call->function, cconv_arguments,
-                                      call->arguments, &current_frame, &regs));
-
   // Primary dispatch state. This is our 'native stack frame' and really
   // just enough to make dereferencing common addresses (like the current
   // offset) faster. You can think of this like CPU state (like PC).
@@ -641,7 +731,6 @@ iree_status_t iree_vm_bytecode_dispatch(
       module->function_descriptor_table[current_frame->function.ordinal]
           .bytecode_offset;
   iree_vm_source_offset_t pc = current_frame->pc;
-  const int32_t entry_frame_depth = current_frame->depth;
 
   BEGIN_DISPATCH_CORE() {
     //===------------------------------------------------------------------===//
@@ -1390,6 +1479,7 @@ iree_status_t iree_vm_bytecode_dispatch(
     });
 
     DISPATCH_OP(CORE, Call, {
+      const iree_vm_source_offset_t call_pc = pc - VM_PC_OFFSET_CORE;
       int32_t function_ordinal = VM_DecFuncAttr("callee");
       const iree_vm_register_list_t* src_reg_list =
           VM_DecVariadicOperands("operands");
@@ -1403,7 +1493,7 @@ iree_status_t iree_vm_bytecode_dispatch(
       if (is_import) {
         // Call import (and possible yield).
         IREE_RETURN_IF_ERROR(iree_vm_bytecode_call_import(
-            stack, module_state, function_ordinal, regs, src_reg_list,
+            stack, module_state, function_ordinal, call_pc, regs, src_reg_list,
             dst_reg_list, &current_frame, &regs, out_result));
       } else {
         // Switch execution to the target function and continue running in the
@@ -1421,6 +1511,7 @@ iree_status_t iree_vm_bytecode_dispatch(
     DISPATCH_OP(CORE, CallVariadic, {
       // TODO(benvanik): dedupe with above or merge and always have the seg size
       // list be present (but empty) for non-variadic calls.
+      const iree_vm_source_offset_t call_pc = pc - VM_PC_OFFSET_CORE;
       int32_t function_ordinal = VM_DecFuncAttr("callee");
       const iree_vm_register_list_t* segment_size_list =
           VM_DecVariadicOperands("segment_sizes");
@@ -1442,8 +1533,9 @@ iree_status_t iree_vm_bytecode_dispatch(
 
       // Call import (and possible yield).
       IREE_RETURN_IF_ERROR(iree_vm_bytecode_call_import_variadic(
-          stack, module_state, function_ordinal, regs, segment_size_list,
-          src_reg_list, dst_reg_list, &current_frame, &regs, out_result));
+          stack, module_state, function_ordinal, call_pc, regs,
+          segment_size_list, src_reg_list, dst_reg_list, &current_frame, &regs,
+          out_result));
     });
 
     DISPATCH_OP(CORE, Return, {
@@ -1462,6 +1554,15 @@ iree_status_t iree_vm_bytecode_dispatch(
       IREE_RETURN_IF_ERROR(iree_vm_bytecode_internal_leave(
           stack, current_frame, regs, src_reg_list, &current_frame, &regs));
 
+      // When resuming a bytecode import that had yielded the caller may be in
+      // another bytecode module and execution continues there.
+      if (IREE_UNLIKELY(current_frame->function.module != &module->interface)) {
+        module =
+            (iree_vm_bytecode_module_t*)current_frame->function.module->self;
+        module_state =
+            (iree_vm_bytecode_module_state_t*)current_frame->module_state;
+      }
+
       // Reset dispatch state so we can continue executing in the caller.
       bytecode_data =
           module->bytecode_data.data +
@@ -1492,7 +1593,7 @@ iree_status_t iree_vm_bytecode_dispatch(
       const iree_vm_register_remap_list_t* remap_list =
           VM_DecBranchOperands("operands");
       iree_vm_bytecode_dispatch_remap_branch_registers(regs, remap_list);
-      pc = block_pc;
+      current_frame->pc = block_pc;
 
       // Return magic status code indicating a yield.
       // This isn't an error, though callers not supporting coroutines will
@@ -2108,3 +2209,49 @@ iree_status_t iree_vm_bytecode_dispatch(
   }
   END_DISPATCH_CORE();
 }
+
+iree_status_t iree_vm_bytecode_dispatch_begin(
+    iree_vm_stack_t* stack, iree_vm_bytecode_module_t* module,
+    const iree_vm_function_call_t* call, iree_string_view_t cconv_arguments,
+    iree_string_view_t cconv_results, iree_vm_execution_result_t* out_result) {
+  memset(out_result, 0, sizeof(*out_result));
+
+  // Enter function (as this is the initial call).
+  // The callee's return will take care of storing the output registers when it
+  // actually does return, either immediately or in the future via a resume.
+  iree_vm_stack_frame_t* current_frame = NULL;
+  iree_vm_registers_t regs;
+  IREE_RETURN_IF_ERROR(
+      iree_vm_bytecode_external_enter(stack, call->function, cconv_arguments,
+                                      call->arguments, &current_frame, &regs));
+
+  return iree_vm_bytecode_dispatch(stack, module, current_frame, regs,
+                                   current_frame->depth, call, cconv_results,
+                                   out_result);
+}
+
+iree_status_t iree_vm_bytecode_dispatch_resume(
+    iree_vm_stack_t* stack, iree_vm_bytecode_module_t* module,
+    const iree_vm_function_call_t* call, iree_string_view_t cconv_results,
+    iree_vm_execution_result_t* out_result) {
+  memset(out_result, 0, sizeof(*out_result));
+
+  // The frame that yielded is still on the top of the stack with its pc set to
+  // where execution should continue. It may belong to another bytecode module
+  // if it was called as an import; its frames return into ours when done.
+  iree_vm_stack_frame_t* current_frame = iree_vm_stack_current_frame(stack);
+  if (IREE_UNLIKELY(!current_frame) ||
+      IREE_UNLIKELY(current_frame->function.module->resume_call !=
+                    module->interface.resume_call)) {
+    return iree_make_status(IREE_STATUS_FAILED_PRECONDITION,
+                            "no suspended bytecode frame to resume");
+  }
+  module = (iree_vm_bytecode_module_t*)current_frame->function.module->self;
+  iree_vm_registers_t regs =
+      iree_vm_bytecode_get_register_storage(current_frame);
+
+  // Resumable calls own their stack and as such the entry frame is the root.
+  return iree_vm_bytecode_dispatch(stack, module, current_frame, regs,
+                                   /*entry_frame_depth=*/0, call,
+                                   cconv_results, out_result);
+}
@@ -0,0 +1,131 @@
+// Copyright 2022 The IREE Authors
+//
+// Licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+// Tests covering yields from bytecode functions called as imports from other
+// bytecode modules. The callee frames remain on the stack across the yield and
+// must return into the caller frame when resumed.
+//
+// iree/vm/test/async_*.mlir contains the functions used here for testing.
+
+#include <cstring>
+
+#include "iree/base/logging.h"
+#include "iree/base/status_cc.h"
+#include "iree/testing/gtest.h"
+#include "iree/testing/status_matchers.h"
+#include "iree/vm/api.h"
+#include "iree/vm/bytecode_module.h"
+
+// Compiled modules embedded here to avoid file IO:
+#include "iree/vm/test/async_bytecode_modules.h"
+
+namespace {
+
+static iree_vm_module_t* LoadModule(const char* file_name) {
+  const struct iree_file_toc_t* module_file_toc =
+      async_bytecode_modules_c_create();
+  for (size_t i = 0; i < async_bytecode_modules_c_size(); ++i) {
+    const auto& module_file = module_file_toc[i];
+    if (strcmp(module_file.name, file_name) != 0) continue;
+    iree_vm_module_t* module = nullptr;
+    IREE_CHECK_OK(iree_vm_bytecode_module_create(
+        iree_const_byte_span_t{
+            reinterpret_cast<const uint8_t*>(module_file.data),
+            module_file.size},
+        iree_allocator_null(), iree_allocator_system(), &module));
+    return module;
+  }
+  return nullptr;
+}
+
+class VMBytecodeDispatchAsyncTest : public ::testing::Test {
+ protected:
+  virtual void SetUp() {
+    IREE_CHECK_OK(iree_vm_register_builtin_types());
+    IREE_CHECK_OK(iree_vm_instance_create(iree_allocator_system(), &instance_));
+
+    iree_vm_module_t* callee_module = LoadModule("async_callee.vmfb");
+    ASSERT_NE(callee_module, nullptr);
+    iree_vm_module_t* caller_module = LoadModule("async_ops.vmfb");
+    ASSERT_NE(caller_module, nullptr);
+    caller_module_ = caller_module;
+
+    iree_vm_module_t* modules[] = {callee_module, caller_module};
+    IREE_CHECK_OK(iree_vm_context_create_with_modules(
+        instance_, IREE_VM_CONTEXT_FLAG_NONE, modules, IREE_ARRAYSIZE(modules),
+        iree_allocator_system(), &context_));
+    iree_vm_module_release(callee_module);
+  }
+
+  virtual void TearDown() {
+    iree_vm_module_release(caller_module_);
+    iree_vm_context_release(context_);
+    iree_vm_instance_release(instance_);
+  }
+
+  iree_vm_function_t LookupFunction(const char* function_name) {
+    iree_vm_function_t function;
+    IREE_CHECK_OK(caller_module_->lookup_function(
+        caller_module_->self, IREE_VM_FUNCTION_LINKAGE_EXPORT,
+        iree_make_cstring_view(function_name), &function));
+    return function;
+  }
+
+  // Steps an invocation of |function_name| until it completes and returns the
+  // number of steps taken. Each yield adds one step.
+  int StepUntilComplete(const char* function_name) {
+    iree_vm_invocation_t* invocation = nullptr;
+    IREE_CHECK_OK(iree_vm_invocation_create(
+        context_, LookupFunction(function_name), IREE_VM_INVOCATION_FLAG_NONE,
+        /*policy=*/nullptr, /*inputs=*/nullptr, iree_allocator_system(),
+        &invocation));
+    int step_count = 0;
+    iree_status_t status = iree_ok_status();
+    do {
+      IREE_EXPECT_OK(iree_vm_invocation_resume(invocation));
+      ++step_count;
+      status = iree_vm_invocation_query_status(invocation);
+    } while (iree_status_code(status) == IREE_STATUS_UNAVAILABLE &&
+             step_count < 100);
+    IREE_EXPECT_OK(status);
+    iree_vm_invocation_release(invocation);
+    return step_count;
+  }
+
+  iree_vm_instance_t* instance_ = nullptr;
+  iree_vm_context_t* context_ = nullptr;
+  iree_vm_module_t* caller_module_ = nullptr;
+};
+
+// A single call into a yielding bytecode import resumes into the callee and
+// returns its results into the caller frame.
+TEST_F(VMBytecodeDispatchAsyncTest, CallYield) {
+  EXPECT_EQ(StepUntilComplete("test_call_yield"), 3 + 1);
+}
+
+// The caller continues after the first call returns and can issue another.
+TEST_F(VMBytecodeDispatchAsyncTest, CallYieldSequence) {
+  EXPECT_EQ(StepUntilComplete("test_call_yield_sequence"), 1 + 2 + 1);
+}
+
+// Variadic calls to yielding bytecode imports behave the same.
+TEST_F(VMBytecodeDispatchAsyncTest, CallVariadicYield) {
+  EXPECT_EQ(StepUntilComplete("test_call_variadic_yield"), 2 + 1);
+}
+
+// Synchronous invocations run through all of the yields.
+TEST_F(VMBytecodeDispatchAsyncTest, InvokeCallYield) {
+  IREE_EXPECT_OK(iree_vm_invoke(context_, LookupFunction("test_call_yield"),
+                                IREE_VM_INVOCATION_FLAG_NONE,
+                                /*policy=*/nullptr, /*inputs=*/nullptr,
+                                /*outputs=*/nullptr, iree_allocator_system()));
+  IREE_EXPECT_OK(iree_vm_invoke(
+      context_, LookupFunction("test_call_variadic_yield"),
+      IREE_VM_INVOCATION_FLAG_NONE, /*policy=*/nullptr, /*inputs=*/nullptr,
+      /*outputs=*/nullptr, iree_allocator_system()));
+}
+
+}  // namespace
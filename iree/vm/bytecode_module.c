@@ -6,11 +6,13 @@
 
 #include "iree/vm/bytecode_module.h"
 
+#include <inttypes.h>
 #include <stdbool.h>
 #include <stdint.h>
 #include <string.h>
 
 #include "iree/base/api.h"
+#include "iree/base/internal/lz4.h"
 #include "iree/base/tracing.h"
 #include "iree/vm/api.h"
 #include "iree/vm/bytecode_module_impl.h"
@@ -100,6 +102,252 @@ static iree_status_t iree_vm_bytecode_module_resolve_types(
   return status;
 }
 
+//===----------------------------------------------------------------------===//
+// Rodata segments
+//===----------------------------------------------------------------------===//
+
+// Returns true if the rodata segment contents must be decompressed before use.
+static bool iree_vm_bytecode_rodata_segment_is_compressed(
+    iree_vm_RodataSegmentDef_table_t segment_def) {
+  switch (iree_vm_RodataSegmentDef_compression_type_type(segment_def)) {
+    case iree_vm_CompressionTypeDef_NONE:
+    case iree_vm_CompressionTypeDef_UncompressedDataDef:
+      return false;
+    default:
+      return true;
+  }
+}
+
+// Returns the length in bytes of the rodata segment after decompression.
+// Only valid on segments that have been verified.
+static iree_host_size_t iree_vm_bytecode_rodata_segment_length(
+    iree_vm_RodataSegmentDef_table_t segment_def) {
+  switch (iree_vm_RodataSegmentDef_compression_type_type(segment_def)) {
+    case iree_vm_CompressionTypeDef_SplatDataDef:
+      return (iree_host_size_t)iree_vm_SplatDataDef_byte_length(
+          (iree_vm_SplatDataDef_table_t)
+              iree_vm_RodataSegmentDef_compression_type(segment_def));
+    case iree_vm_CompressionTypeDef_LZ4BlockDataDef:
+      return (iree_host_size_t)iree_vm_LZ4BlockDataDef_byte_length(
+          (iree_vm_LZ4BlockDataDef_table_t)
+              iree_vm_RodataSegmentDef_compression_type(segment_def));
+    default:
+      return flatbuffers_uint8_vec_len(
+          iree_vm_RodataSegmentDef_data(segment_def));
+  }
+}
+
+// Verifies that the compression parameters of rodata segment |i| are in bounds
+// so that decompression does not need to check them again.
+static iree_status_t iree_vm_bytecode_rodata_segment_verify(
+    iree_host_size_t i, iree_vm_RodataSegmentDef_table_t segment_def) {
+  if (!segment_def) {
+    return iree_make_status(IREE_STATUS_INVALID_ARGUMENT,
+                            "rodata_segments[%zu] missing body", i);
+  }
+  iree_host_size_t data_length =
+      flatbuffers_uint8_vec_len(iree_vm_RodataSegmentDef_data(segment_def));
+  switch (iree_vm_RodataSegmentDef_compression_type_type(segment_def)) {
+    case iree_vm_CompressionTypeDef_NONE:
+    case iree_vm_CompressionTypeDef_UncompressedDataDef:
+      return iree_ok_status();
+    case iree_vm_CompressionTypeDef_SplatDataDef: {
+      iree_vm_SplatDataDef_table_t splat_def =
+          (iree_vm_SplatDataDef_table_t)
+              iree_vm_RodataSegmentDef_compression_type(segment_def);
+      uint64_t byte_length = iree_vm_SplatDataDef_byte_length(splat_def);
+      if (byte_length > IREE_HOST_SIZE_MAX || data_length == 0 ||
+          byte_length % data_length != 0) {
+        return iree_make_status(IREE_STATUS_INVALID_ARGUMENT,
+                                "rodata_segments[%zu] splat of %zu byte "
+                                "pattern cannot fill %" PRIu64 " bytes",
+                                i, data_length, byte_length);
+      }
+      return iree_ok_status();
+    }
+    case iree_vm_CompressionTypeDef_LZ4BlockDataDef: {
+      iree_vm_LZ4BlockDataDef_table_t lz4_def =
+          (iree_vm_LZ4BlockDataDef_table_t)
+              iree_vm_RodataSegmentDef_compression_type(segment_def);
+      uint64_t byte_length = iree_vm_LZ4BlockDataDef_byte_length(lz4_def);
+      uint32_t block_size = iree_vm_LZ4BlockDataDef_block_size(lz4_def);
+      if (byte_length > IREE_HOST_SIZE_MAX || block_size == 0) {
+        return iree_make_status(IREE_STATUS_INVALID_ARGUMENT,
+                                "rodata_segments[%zu] LZ4 block size %u "
+                                "invalid for %" PRIu64 " bytes",
+                                i, block_size, byte_length);
+      }
+      uint64_t block_count =
+          byte_length / block_size + (byte_length % block_size ? 1 : 0);
+      flatbuffers_uint32_vec_t block_offsets =
+          iree_vm_LZ4BlockDataDef_block_offsets(lz4_def);
+      if (flatbuffers_uint32_vec_len(block_offsets) != block_count + 1) {
+        return iree_make_status(IREE_STATUS_INVALID_ARGUMENT,
+                                "rodata_segments[%zu] LZ4 block offsets "
+                                "table has %zu entries; expected %" PRIu64,
+                                i, flatbuffers_uint32_vec_len(block_offsets),
+                                block_count + 1);
+      }
+      for (iree_host_size_t j = 0; j < block_count; ++j) {
+        if (flatbuffers_uint32_vec_at(block_offsets, j) >
+            flatbuffers_uint32_vec_at(block_offsets, j + 1)) {
+          return iree_make_status(IREE_STATUS_INVALID_ARGUMENT,
+                                  "rodata_segments[%zu] LZ4 block %zu offsets "
+                                  "out of order",
+                                  i, j);
+        }
+      }
+      if (flatbuffers_uint32_vec_at(block_offsets, block_count) >
+          data_length) {
+        return iree_make_status(IREE_STATUS_INVALID_ARGUMENT,
+                                "rodata_segments[%zu] LZ4 blocks extend "
+                                "beyond the segment data",
+                                i);
+      }
+      return iree_ok_status();
+    }
+    default:
+      return iree_make_status(
+          IREE_STATUS_UNIMPLEMENTED,
+          "rodata_segments[%zu] compression type %d not supported", i,
+          (int)iree_vm_RodataSegmentDef_compression_type_type(segment_def));
+  }
+}
+
+// Fills |target| by repeating |pattern|. The target length must be an even
+// multiple of the pattern length.
+static void iree_vm_bytecode_rodata_splat(iree_const_byte_span_t pattern,
+                                          iree_byte_span_t target) {
+  if (target.data_length == 0) return;
+  memcpy(target.data, pattern.data, pattern.data_length);
+  // Double the filled prefix each step to keep the copies large.
+  iree_host_size_t filled_length = pattern.data_length;
+  while (filled_length < target.data_length) {
+    iree_host_size_t copy_length =
+        VMMIN(filled_length, target.data_length - filled_length);
+    memcpy(target.data + filled_length, target.data, copy_length);
+    filled_length += copy_length;
+  }
+}
+
+// Reverses the bytewise delta encoding applied to a decompressed block.
+static void iree_vm_bytecode_rodata_undelta(iree_host_size_t stride,
+                                            iree_byte_span_t block) {
+  for (iree_host_size_t i = stride; i < block.data_length; ++i) {
+    block.data[i] += block.data[i - stride];
+  }
+}
+
+// Decompresses a verified rodata segment into |target|, which must be exactly
+// the decompressed length of the segment.
+static iree_status_t iree_vm_bytecode_rodata_segment_decompress(
+    iree_vm_RodataSegmentDef_table_t segment_def, iree_byte_span_t target) {
+  flatbuffers_uint8_vec_t data = iree_vm_RodataSegmentDef_data(segment_def);
+  switch (iree_vm_RodataSegmentDef_compression_type_type(segment_def)) {
+    case iree_vm_CompressionTypeDef_SplatDataDef: {
+      iree_vm_bytecode_rodata_splat(
+          iree_make_const_byte_span(data, flatbuffers_uint8_vec_len(data)),
+          target);
+      return iree_ok_status();
+    }
+    case iree_vm_CompressionTypeDef_LZ4BlockDataDef: {
+      iree_vm_LZ4BlockDataDef_table_t lz4_def =
+          (iree_vm_LZ4BlockDataDef_table_t)
+              iree_vm_RodataSegmentDef_compression_type(segment_def);
+      iree_host_size_t block_size = iree_vm_LZ4BlockDataDef_block_size(lz4_def);
+      iree_host_size_t delta_stride =
+          iree_vm_LZ4BlockDataDef_delta_stride(lz4_def);
+      flatbuffers_uint32_vec_t block_offsets =
+          iree_vm_LZ4BlockDataDef_block_offsets(lz4_def);
+      // Blocks are independent and could be decompressed concurrently.
+      iree_host_size_t block_count =
+          flatbuffers_uint32_vec_len(block_offsets) - 1;
+      for (iree_host_size_t j = 0; j < block_count; ++j) {
+        iree_host_size_t block_offset = j * block_size;
+        iree_byte_span_t block = iree_make_byte_span(
+            target.data + block_offset,
+            VMMIN(block_size, target.data_length - block_offset));
+        iree_host_size_t source_offset =
+            flatbuffers_uint32_vec_at(block_offsets, j);
+        iree_host_size_t source_length =
+            flatbuffers_uint32_vec_at(block_offsets, j + 1) - source_offset;
+        IREE_RETURN_IF_ERROR(
+            iree_lz4_decompress_block(
+                iree_make_const_byte_span(data + source_offset, source_length),
+                block),
+            "decompressing LZ4 block %zu", j);
+        if (delta_stride) {
+          iree_vm_bytecode_rodata_undelta(delta_stride, block);
+        }
+      }
+      return iree_ok_status();
+    }
+    default:
+      return iree_make_status(IREE_STATUS_UNIMPLEMENTED,
+                              "unsupported rodata compression type");
+  }
+}
+
+// Populates the module rodata segment table. Uncompressed segments reference
+// the FlatBuffer directly and compressed segments are decompressed into a
+// single module-owned allocation.
+static iree_status_t iree_vm_bytecode_module_load_rodata(
+    iree_vm_bytecode_module_t* module) {
+  iree_vm_RodataSegmentDef_vec_t segment_defs =
+      iree_vm_BytecodeModuleDef_rodata_segments(module->def);
+  module->rodata_segment_count = iree_vm_RodataSegmentDef_vec_len(segment_defs);
+  if (!module->rodata_segment_count) return iree_ok_status();
+  IREE_TRACE_ZONE_BEGIN(z0);
+
+  // The segment table is placed in front of the storage so that both can be
+  // allocated at once.
+  iree_host_size_t table_size =
+      iree_host_align(module->rodata_segment_count * sizeof(iree_byte_span_t),
+                      IREE_VM_BYTECODE_RODATA_ALIGNMENT);
+  iree_host_size_t storage_size = 0;
+  for (iree_host_size_t i = 0; i < module->rodata_segment_count; ++i) {
+    iree_vm_RodataSegmentDef_table_t segment_def =
+        iree_vm_RodataSegmentDef_vec_at(segment_defs, i);
+    if (!iree_vm_bytecode_rodata_segment_is_compressed(segment_def)) continue;
+    storage_size +=
+        iree_host_align(iree_vm_bytecode_rodata_segment_length(segment_def),
+                        IREE_VM_BYTECODE_RODATA_ALIGNMENT);
+  }
+  IREE_TRACE_ZONE_APPEND_VALUE(z0, (int64_t)storage_size);
+  IREE_RETURN_AND_END_ZONE_IF_ERROR(
+      z0, iree_allocator_malloc_aligned(
+              module->allocator, table_size + storage_size,
+              IREE_VM_BYTECODE_RODATA_ALIGNMENT, table_size,
+              &module->rodata_storage));
+  module->rodata_segments = (iree_byte_span_t*)module->rodata_storage;
+
+  iree_status_t status = iree_ok_status();
+  uint8_t* storage_ptr = (uint8_t*)module->rodata_storage + table_size;
+  for (iree_host_size_t i = 0; i < module->rodata_segment_count; ++i) {
+    iree_vm_RodataSegmentDef_table_t segment_def =
+        iree_vm_RodataSegmentDef_vec_at(segment_defs, i);
+    if (!iree_vm_bytecode_rodata_segment_is_compressed(segment_def)) {
+      flatbuffers_uint8_vec_t data = iree_vm_RodataSegmentDef_data(segment_def);
+      module->rodata_segments[i] =
+          iree_make_byte_span((uint8_t*)data, flatbuffers_uint8_vec_len(data));
+      continue;
+    }
+    iree_host_size_t length =
+        iree_vm_bytecode_rodata_segment_length(segment_def);
+    module->rodata_segments[i] = iree_make_byte_span(storage_ptr, length);
+    storage_ptr += iree_host_align(length, IREE_VM_BYTECODE_RODATA_ALIGNMENT);
+    status = iree_vm_bytecode_rodata_segment_decompress(
+        segment_def, module->rodata_segments[i]);
+    if (!iree_status_is_ok(status)) {
+      status = iree_status_annotate_f(status, "rodata_segments[%zu]", i);
+      break;
+    }
+  }
+
+  IREE_TRACE_ZONE_END(z0);
+  return status;
+}
+
 // Verifies the structure of the flatbuffer so that we can avoid doing so during
 // runtime. There are still some conditions we must be aware of (such as omitted
 // names on functions with internal linkage), however we shouldn't need to
@@ -222,6 +470,14 @@ static iree_status_t iree_vm_bytecode_module_flatbuffer_verify(
     // TODO(benvanik): run bytecode verifier on contents.
   }
 
+  iree_vm_RodataSegmentDef_vec_t rodata_segments =
+      iree_vm_BytecodeModuleDef_rodata_segments(module_def);
+  for (size_t i = 0; i < iree_vm_RodataSegmentDef_vec_len(rodata_segments);
+       ++i) {
+    IREE_RETURN_IF_ERROR(iree_vm_bytecode_rodata_segment_verify(
+        i, iree_vm_RodataSegmentDef_vec_at(rodata_segments, i)));
+  }
+
   return iree_ok_status();
 }
 
@@ -270,6 +526,10 @@ static void iree_vm_bytecode_module_destroy(void* self) {
   iree_vm_bytecode_module_t* module = (iree_vm_bytecode_module_t*)self;
   IREE_TRACE_ZONE_BEGIN(z0);
 
+  iree_allocator_free_aligned(module->allocator, module->rodata_storage);
+  module->rodata_storage = NULL;
+  module->rodata_segments = NULL;
+
   iree_allocator_free(module->flatbuffer_allocator,
                       (void*)module->flatbuffer_data.data);
   module->flatbuffer_data = iree_make_const_byte_span(NULL, 0);
@@ -700,19 +960,13 @@ static iree_status_t iree_vm_bytecode_module_alloc_state(
   // Perform layout to get the pointers into the storage for each nested table.
   iree_vm_bytecode_module_layout_state(module_def, state);
 
-  // Setup rodata segments to point directly at the flatbuffer memory.
-  iree_vm_RodataSegmentDef_vec_t rodata_segments =
-      iree_vm_BytecodeModuleDef_rodata_segments(module_def);
+  // Setup rodata segments to point directly at the flatbuffer memory or the
+  // module-owned decompressed storage.
   for (int i = 0; i < state->rodata_ref_count; ++i) {
-    iree_vm_RodataSegmentDef_table_t segment =
-        iree_vm_RodataSegmentDef_vec_at(rodata_segments, i);
     iree_vm_buffer_t* ref = &state->rodata_ref_table[i];
-    iree_vm_buffer_initialize(
-        IREE_VM_BUFFER_ACCESS_ORIGIN_MODULE,
-        iree_make_byte_span(
-            (uint8_t*)iree_vm_RodataSegmentDef_data(segment),
-            flatbuffers_uint8_vec_len(iree_vm_RodataSegmentDef_data(segment))),
-        iree_allocator_null(), ref);
+    iree_vm_buffer_initialize(IREE_VM_BUFFER_ACCESS_ORIGIN_MODULE,
+                              module->rodata_segments[i],
+                              iree_allocator_null(), ref);
   }
 
   *out_module_state = (iree_vm_module_state_t*)state;
@@ -785,6 +1039,12 @@ static iree_status_t iree_vm_bytecode_module_resolve_import(
   import->argument_buffer_size = (uint16_t)argument_buffer_size;
   import->result_buffer_size = (uint16_t)result_buffer_size;
 
+  // Calls into native modules can skip the module interface and invoke the
+  // resolved native shim with our marshaled arguments.
+  iree_vm_native_module_resolve_export(function, &import->resolved_function);
+  iree_vm_native_module_resolve_register_export(
+      function, &import->resolved_register_function);
+
   return iree_ok_status();
 }
 
@@ -793,24 +1053,17 @@ static iree_status_t IREE_API_PTR iree_vm_bytecode_module_notify(
   return iree_ok_status();
 }
 
-static iree_status_t iree_vm_bytecode_module_begin_call(
-    void* self, iree_vm_stack_t* stack, const iree_vm_function_call_t* call,
-    iree_vm_execution_result_t* out_result) {
-  // NOTE: any work here adds directly to the invocation time. Avoid doing too
-  // much work or touching too many unlikely-to-be-cached structures (such as
-  // walking the FlatBuffer, which may cause page faults).
-  IREE_TRACE_ZONE_BEGIN(z0);
-  IREE_ASSERT_ARGUMENT(out_result);
-  memset(out_result, 0, sizeof(iree_vm_execution_result_t));
-
+// Returns the calling convention fragments of the function being called.
+static iree_status_t iree_vm_bytecode_module_query_call_cconv(
+    iree_vm_bytecode_module_t* module, const iree_vm_function_call_t* call,
+    iree_string_view_t* out_cconv_arguments,
+    iree_string_view_t* out_cconv_results) {
   // Map the (potentially) export ordinal into the internal function ordinal in
   // the function descriptor table.
-  iree_vm_bytecode_module_t* module = (iree_vm_bytecode_module_t*)self;
   uint16_t ordinal = 0;
   iree_vm_FunctionSignatureDef_table_t signature_def = NULL;
-  IREE_RETURN_AND_END_ZONE_IF_ERROR(
-      z0, iree_vm_bytecode_map_internal_ordinal(module, call->function,
-                                                &ordinal, &signature_def));
+  IREE_RETURN_IF_ERROR(iree_vm_bytecode_map_internal_ordinal(
+      module, call->function, &ordinal, &signature_def));
 
   // Grab calling convention string. This is not great as we are guaranteed to
   // have a bunch of cache misses, but without putting it on the descriptor
@@ -830,20 +1083,59 @@ static iree_status_t iree_vm_bytecode_module_begin_call(
   signature.calling_convention.data = calling_convention;
   signature.calling_convention.size =
       flatbuffers_string_len(calling_convention);
+  *out_cconv_arguments = iree_string_view_empty();
+  *out_cconv_results = iree_string_view_empty();
+  return iree_vm_function_call_get_cconv_fragments(
+      &signature, out_cconv_arguments, out_cconv_results);
+}
+
+static iree_status_t iree_vm_bytecode_module_begin_call(
+    void* self, iree_vm_stack_t* stack, const iree_vm_function_call_t* call,
+    iree_vm_execution_result_t* out_result) {
+  // NOTE: any work here adds directly to the invocation time. Avoid doing too
+  // much work or touching too many unlikely-to-be-cached structures (such as
+  // walking the FlatBuffer, which may cause page faults).
+  IREE_TRACE_ZONE_BEGIN(z0);
+  IREE_ASSERT_ARGUMENT(out_result);
+  memset(out_result, 0, sizeof(iree_vm_execution_result_t));
+
+  iree_vm_bytecode_module_t* module = (iree_vm_bytecode_module_t*)self;
   iree_string_view_t cconv_arguments = iree_string_view_empty();
   iree_string_view_t cconv_results = iree_string_view_empty();
   IREE_RETURN_AND_END_ZONE_IF_ERROR(
-      z0, iree_vm_function_call_get_cconv_fragments(
-              &signature, &cconv_arguments, &cconv_results));
+      z0, iree_vm_bytecode_module_query_call_cconv(
+              module, call, &cconv_arguments, &cconv_results));
 
   // Jump into the dispatch routine to execute bytecode until the function
   // either returns (synchronous) or yields (asynchronous).
-  iree_status_t status = iree_vm_bytecode_dispatch(
+  iree_status_t status = iree_vm_bytecode_dispatch_begin(
       stack, module, call, cconv_arguments, cconv_results, out_result);
   IREE_TRACE_ZONE_END(z0);
   return status;
 }
 
+static iree_status_t iree_vm_bytecode_module_resume_call(
+    void* self, iree_vm_stack_t* stack, const iree_vm_function_call_t* call,
+    iree_vm_execution_result_t* out_result) {
+  IREE_TRACE_ZONE_BEGIN(z0);
+  IREE_ASSERT_ARGUMENT(out_result);
+  memset(out_result, 0, sizeof(iree_vm_execution_result_t));
+
+  iree_vm_bytecode_module_t* module = (iree_vm_bytecode_module_t*)self;
+  iree_string_view_t cconv_arguments = iree_string_view_empty();
+  iree_string_view_t cconv_results = iree_string_view_empty();
+  IREE_RETURN_AND_END_ZONE_IF_ERROR(
+      z0, iree_vm_bytecode_module_query_call_cconv(
+              module, call, &cconv_arguments, &cconv_results));
+
+  // Continue executing from the frame that yielded until the function either
+  // returns or yields again.
+  iree_status_t status = iree_vm_bytecode_dispatch_resume(
+      stack, module, call, cconv_results, out_result);
+  IREE_TRACE_ZONE_END(z0);
+  return status;
+}
+
 IREE_API_EXPORT iree_status_t iree_vm_bytecode_module_create(
     iree_const_byte_span_t flatbuffer_data,
     iree_allocator_t flatbuffer_allocator, iree_allocator_t allocator,
@@ -906,6 +1198,14 @@ IREE_API_EXPORT iree_status_t iree_vm_bytecode_module_create(
     return resolve_status;
   }
 
+  iree_status_t rodata_status = iree_vm_bytecode_module_load_rodata(module);
+  if (!iree_status_is_ok(rodata_status)) {
+    iree_allocator_free_aligned(allocator, module->rodata_storage);
+    iree_allocator_free(allocator, module);
+    IREE_TRACE_ZONE_END(z0);
+    return rodata_status;
+  }
+
   iree_vm_module_initialize(&module->interface, module);
   module->interface.destroy = iree_vm_bytecode_module_destroy;
   module->interface.name = iree_vm_bytecode_module_name;
@@ -921,6 +1221,7 @@ IREE_API_EXPORT iree_status_t iree_vm_bytecode_module_create(
   module->interface.resolve_import = iree_vm_bytecode_module_resolve_import;
   module->interface.notify = iree_vm_bytecode_module_notify;
   module->interface.begin_call = iree_vm_bytecode_module_begin_call;
+  module->interface.resume_call = iree_vm_bytecode_module_resume_call;
   module->interface.get_function_reflection_attr =
       iree_vm_bytecode_module_get_function_reflection_attr;
 
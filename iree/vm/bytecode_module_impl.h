@@ -41,6 +41,10 @@ extern "C" {
 #define IREE_REF_REGISTER_MOVE_BIT 0x4000
 #define IREE_REF_REGISTER_MASK 0x3FFF
 
+// Minimum alignment of rodata segments that are decompressed on load.
+// Must match the alignment assumed by the compiler when choosing to compress.
+#define IREE_VM_BYTECODE_RODATA_ALIGNMENT 64
+
 // A loaded bytecode module.
 typedef struct iree_vm_bytecode_module_t {
   // Interface routing to the bytecode module functions.
@@ -65,6 +69,14 @@ typedef struct iree_vm_bytecode_module_t {
   iree_allocator_t flatbuffer_allocator;
   iree_vm_BytecodeModuleDef_table_t def;
 
+  // Contents of each rodata segment mapped 1:1 with the module rodata
+  // segments. Uncompressed segments point directly into the FlatBuffer while
+  // compressed segments point into |rodata_storage|, which is decompressed
+  // when the module is loaded and shared by all module states.
+  iree_host_size_t rodata_segment_count;
+  iree_byte_span_t* rodata_segments;
+  void* rodata_storage;
+
   // Type table mapping module type IDs to registered VM types.
   iree_host_size_t type_count;
   iree_vm_type_def_t type_table[];
@@ -90,6 +102,17 @@ typedef struct iree_vm_bytecode_import_t {
   // don't support variadic values (yet).
   uint16_t argument_buffer_size;
   uint16_t result_buffer_size;
+
+  // Native shim and target the import resolved to when the callee is a native
+  // module using the default call handling. Calls can then skip the callee
+  // module begin_call but still pass packed argument/result buffers. NULL shim
+  // if the import must be called through the module interface.
+  iree_vm_native_function_ptr_t resolved_function;
+
+  // Register-level implementation of the resolved native function, if any.
+  // Calls through it read arguments from and write results to our registers
+  // directly and skip argument/result marshaling entirely.
+  iree_vm_native_register_function_t resolved_register_function;
 } iree_vm_bytecode_import_t;
 
 // Per-instance module state.
@@ -120,15 +143,25 @@ typedef struct iree_vm_bytecode_module_state_t {
   iree_allocator_t allocator;
 } iree_vm_bytecode_module_state_t;
 
-// Begins (or resumes) execution of the current frame and continues until
+// Begins execution of |call| by entering a new frame and continues until
 // either a yield or return. |out_result| will contain the result status for
 // continuation, if needed.
-iree_status_t iree_vm_bytecode_dispatch(iree_vm_stack_t* stack,
-                                        iree_vm_bytecode_module_t* module,
-                                        const iree_vm_function_call_t* call,
-                                        iree_string_view_t cconv_arguments,
-                                        iree_string_view_t cconv_results,
-                                        iree_vm_execution_result_t* out_result);
+//
+// Returns IREE_STATUS_DEFERRED if execution yielded; the frames remain on
+// |stack| and execution can be continued with iree_vm_bytecode_dispatch_resume.
+iree_status_t iree_vm_bytecode_dispatch_begin(
+    iree_vm_stack_t* stack, iree_vm_bytecode_module_t* module,
+    const iree_vm_function_call_t* call, iree_string_view_t cconv_arguments,
+    iree_string_view_t cconv_results, iree_vm_execution_result_t* out_result);
+
+// Resumes execution of the current frame of |stack| after a yield and continues
+// until either another yield or the return from the |call| entry frame.
+// Only calls that own the root of |stack| (such as those issued by
+// iree_vm_invocation_t) can be resumed.
+iree_status_t iree_vm_bytecode_dispatch_resume(
+    iree_vm_stack_t* stack, iree_vm_bytecode_module_t* module,
+    const iree_vm_function_call_t* call, iree_string_view_t cconv_results,
+    iree_vm_execution_result_t* out_result);
 
 #ifdef __cplusplus
 }  // extern "C"
@@ -0,0 +1,108 @@
+// Copyright 2022 The IREE Authors
+//
+// Licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+// Compares module load time against artifact size for the same module compiled
+// with uncompressed and compressed rodata segments.
+
+#include "benchmark/benchmark.h"
+#include "iree/base/api.h"
+#include "iree/base/logging.h"
+#include "iree/vm/api.h"
+#include "iree/vm/bytecode_module.h"
+#include "iree/vm/bytecode_module_rodata_benchmark_lz4_module_c.h"
+#include "iree/vm/bytecode_module_rodata_benchmark_module_c.h"
+
+namespace {
+
+typedef const iree_file_toc_t* (*module_toc_fn_t)(void);
+
+// Total decompressed size of the rodata segments in the benchmark module.
+static const int64_t kRodataByteLength = 1024 * 1024 + 4 * 1024;
+
+static iree_const_byte_span_t ModuleData(module_toc_fn_t module_toc_fn) {
+  const iree_file_toc_t* module_file_toc = module_toc_fn();
+  return iree_make_const_byte_span(module_file_toc->data,
+                                   module_file_toc->size);
+}
+
+// Measures iree_vm_bytecode_module_create, which is where compressed rodata
+// is decompressed.
+static void LoadModule(benchmark::State& state, module_toc_fn_t module_toc_fn) {
+  iree_const_byte_span_t module_data = ModuleData(module_toc_fn);
+  for (auto _ : state) {
+    iree_vm_module_t* module = NULL;
+    IREE_CHECK_OK(iree_vm_bytecode_module_create(
+        module_data, iree_allocator_null(), iree_allocator_system(), &module));
+    benchmark::DoNotOptimize(module);
+    iree_vm_module_release(module);
+  }
+  state.SetBytesProcessed(state.iterations() * kRodataByteLength);
+  state.counters["artifact_bytes"] = (double)module_data.data_length;
+}
+
+// Measures loading the module, creating a context, and calling a function that
+// references all rodata segments.
+static void LoadAndCallModule(benchmark::State& state,
+                              module_toc_fn_t module_toc_fn) {
+  iree_const_byte_span_t module_data = ModuleData(module_toc_fn);
+  iree_vm_instance_t* instance = NULL;
+  IREE_CHECK_OK(iree_vm_instance_create(iree_allocator_system(), &instance));
+  iree_vm_list_t* outputs = NULL;
+  IREE_CHECK_OK(iree_vm_list_create(/*element_type=*/NULL, 2,
+                                    iree_allocator_system(), &outputs));
+  for (auto _ : state) {
+    iree_vm_module_t* module = NULL;
+    IREE_CHECK_OK(iree_vm_bytecode_module_create(
+        module_data, iree_allocator_null(), iree_allocator_system(), &module));
+    iree_vm_context_t* context = NULL;
+    IREE_CHECK_OK(iree_vm_context_create_with_modules(
+        instance, IREE_VM_CONTEXT_FLAG_NONE, &module, /*module_count=*/1,
+        iree_allocator_system(), &context));
+    iree_vm_function_t function;
+    IREE_CHECK_OK(iree_vm_module_lookup_function_by_name(
+        module, IREE_VM_FUNCTION_LINKAGE_EXPORT,
+        iree_make_cstring_view("rodata_sizes"), &function));
+    IREE_CHECK_OK(iree_vm_invoke(context, function,
+                                 IREE_VM_INVOCATION_FLAG_NONE,
+                                 /*policy=*/NULL, /*inputs=*/NULL, outputs,
+                                 iree_allocator_system()));
+    iree_vm_value_t splat_length, ramp_length;
+    IREE_CHECK_OK(iree_vm_list_get_value(outputs, 0, &splat_length));
+    IREE_CHECK_OK(iree_vm_list_get_value(outputs, 1, &ramp_length));
+    IREE_CHECK_EQ(splat_length.i32 + ramp_length.i32, kRodataByteLength);
+    IREE_CHECK_OK(iree_vm_list_resize(outputs, 0));
+    iree_vm_context_release(context);
+    iree_vm_module_release(module);
+  }
+  iree_vm_list_release(outputs);
+  iree_vm_instance_release(instance);
+  state.SetBytesProcessed(state.iterations() * kRodataByteLength);
+  state.counters["artifact_bytes"] = (double)module_data.data_length;
+}
+
+static void BM_LoadUncompressed(benchmark::State& state) {
+  LoadModule(state, iree_vm_bytecode_module_rodata_benchmark_module_create);
+}
+BENCHMARK(BM_LoadUncompressed);
+
+static void BM_LoadCompressed(benchmark::State& state) {
+  LoadModule(state, iree_vm_bytecode_module_rodata_benchmark_lz4_module_create);
+}
+BENCHMARK(BM_LoadCompressed);
+
+static void BM_LoadAndCallUncompressed(benchmark::State& state) {
+  LoadAndCallModule(state,
+                    iree_vm_bytecode_module_rodata_benchmark_module_create);
+}
+BENCHMARK(BM_LoadAndCallUncompressed);
+
+static void BM_LoadAndCallCompressed(benchmark::State& state) {
+  LoadAndCallModule(
+      state, iree_vm_bytecode_module_rodata_benchmark_lz4_module_create);
+}
+BENCHMARK(BM_LoadAndCallCompressed);
+
+}  // namespace
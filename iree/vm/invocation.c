@@ -11,6 +11,7 @@
 #include <string.h>
 
 #include "iree/base/api.h"
+#include "iree/base/internal/atomics.h"
 #include "iree/base/tracing.h"
 #include "iree/vm/ref.h"
 #include "iree/vm/stack.h"
@@ -18,7 +19,7 @@
 
 // Marshals caller arguments from the variant list to the ABI convention.
 static iree_status_t iree_vm_invoke_marshal_inputs(
-    iree_string_view_t cconv_arguments, iree_vm_list_t* inputs,
+    iree_string_view_t cconv_arguments, const iree_vm_list_t* inputs,
     iree_byte_span_t arguments) {
   // We are 1:1 right now with no variadic args, so do a quick verification on
   // the input list.
@@ -144,7 +145,6 @@ static iree_status_t iree_vm_invoke_marshal_outputs(
   return iree_ok_status();
 }
 
-// TODO(benvanik): implement this as an iree_vm_invocation_t sequence.
 static iree_status_t iree_vm_invoke_within(
     iree_vm_context_t* context, iree_vm_stack_t* stack,
     iree_vm_function_t function, const iree_vm_invocation_policy_t* policy,
@@ -177,26 +177,40 @@ static iree_status_t iree_vm_invoke_within(
   results.data = iree_alloca(results.data_length);
   memset(results.data, 0, results.data_length);
 
-  // Perform execution. Note that for synchronous execution we expect this to
-  // complete without yielding.
+  // Perform execution. Synchronous execution blocks on whatever the callee is
+  // waiting on whenever it yields and then resumes it; use
+  // iree_vm_invocation_t to interleave execution instead.
   iree_vm_function_call_t call;
   memset(&call, 0, sizeof(call));
   call.function = function;
   call.arguments = arguments;
   call.results = results;
   iree_vm_execution_result_t result;
+  memset(&result, 0, sizeof(result));
   iree_status_t status =
       function.module->begin_call(function.module->self, stack, &call, &result);
+  while (iree_status_is_deferred(status) && function.module->resume_call) {
+    // Block until the callee can make progress instead of spinning on it.
+    // Waits may wake early (returning deferred) and the callee will yield
+    // again if it is still blocked.
+    status = iree_wait_source_wait_one(result.wait_source,
+                                       iree_infinite_timeout());
+    if (!iree_status_is_ok(status) && !iree_status_is_deferred(status)) break;
+    status = function.module->resume_call(function.module->self, stack, &call,
+                                          &result);
+  }
   if (!iree_status_is_ok(status)) {
     iree_vm_function_call_release(&call, &signature);
     return status;
   }
 
   // Read back the outputs from the result buffer.
-  IREE_RETURN_IF_ERROR(
-      iree_vm_invoke_marshal_outputs(cconv_results, results, outputs));
+  status = iree_vm_invoke_marshal_outputs(cconv_results, results, outputs);
 
-  return iree_ok_status();
+  // Native callees borrow their arguments (bytecode callees move them out) so
+  // drop any references we retained while marshaling the inputs.
+  iree_vm_function_call_release(&call, &signature);
+  return status;
 }
 
 IREE_API_EXPORT iree_status_t iree_vm_invoke(
@@ -224,3 +238,343 @@ IREE_API_EXPORT iree_status_t iree_vm_invoke(
   IREE_TRACE_ZONE_END(z0);
   return status;
 }
+
+//===----------------------------------------------------------------------===//
+// iree_vm_invocation_t
+//===----------------------------------------------------------------------===//
+
+struct iree_vm_invocation_t {
+  iree_atomic_ref_count_t ref_count;
+  iree_allocator_t allocator;
+
+  // Context the function is executing within; retained.
+  iree_vm_context_t* context;
+
+  // Function being invoked and its calling convention.
+  iree_vm_function_t function;
+  iree_vm_function_signature_t signature;
+  iree_string_view_t cconv_results;
+
+  // Call with argument and result storage in the trailing allocation.
+  iree_vm_function_call_t call;
+
+  // Stack holding the frames of the call while it is suspended.
+  // Allocated on first execution and freed upon completion.
+  iree_vm_invocation_flags_t flags;
+  iree_vm_stack_t* stack;
+
+  // True once the call has begun and subsequent steps must resume it.
+  bool started;
+  // True once the call has completed (successfully or otherwise).
+  bool completed;
+  // True while a step is enqueued on |loop|.
+  bool scheduled;
+  iree_loop_t loop;
+  // Wait source the suspended call is blocked on; immediate if the call can be
+  // resumed right away.
+  iree_wait_source_t wait_source;
+
+  // Final status of the invocation; valid once |completed|.
+  iree_status_t status;
+  // Results of the invocation; valid once |completed| with an OK status.
+  iree_vm_list_t* outputs;
+};
+
+static void iree_vm_invocation_destroy(iree_vm_invocation_t* invocation) {
+  IREE_TRACE_ZONE_BEGIN(z0);
+  iree_allocator_t allocator = invocation->allocator;
+  if (invocation->stack) {
+    iree_vm_stack_free(invocation->stack);
+  }
+  iree_vm_function_call_release(&invocation->call, &invocation->signature);
+  iree_vm_list_release(invocation->outputs);
+  iree_status_ignore(invocation->status);
+  iree_vm_context_release(invocation->context);
+  iree_allocator_free(allocator, invocation);
+  IREE_TRACE_ZONE_END(z0);
+}
+
+IREE_API_EXPORT iree_status_t iree_vm_invocation_create(
+    iree_vm_context_t* context, iree_vm_function_t function,
+    iree_vm_invocation_flags_t flags, const iree_vm_invocation_policy_t* policy,
+    const iree_vm_list_t* inputs, iree_allocator_t allocator,
+    iree_vm_invocation_t** out_invocation) {
+  IREE_ASSERT_ARGUMENT(context);
+  IREE_ASSERT_ARGUMENT(out_invocation);
+  *out_invocation = NULL;
+  IREE_TRACE_ZONE_BEGIN(z0);
+
+  // Force tracing if specified on the context.
+  if (iree_vm_context_flags(context) & IREE_VM_CONTEXT_FLAG_TRACE_EXECUTION) {
+    flags |= IREE_VM_INVOCATION_FLAG_TRACE_EXECUTION;
+  }
+
+  iree_vm_function_signature_t signature =
+      iree_vm_function_signature(&function);
+  iree_string_view_t cconv_arguments = iree_string_view_empty();
+  iree_string_view_t cconv_results = iree_string_view_empty();
+  IREE_RETURN_AND_END_ZONE_IF_ERROR(
+      z0, iree_vm_function_call_get_cconv_fragments(
+              &signature, &cconv_arguments, &cconv_results));
+
+  // NOTE: today we don't support variadic arguments through this interface.
+  iree_host_size_t argument_size = 0;
+  IREE_RETURN_AND_END_ZONE_IF_ERROR(
+      z0, iree_vm_function_call_compute_cconv_fragment_size(
+              cconv_arguments, /*segment_size_list=*/NULL, &argument_size));
+  iree_host_size_t result_size = 0;
+  IREE_RETURN_AND_END_ZONE_IF_ERROR(
+      z0, iree_vm_function_call_compute_cconv_fragment_size(
+              cconv_results, /*segment_size_list=*/NULL, &result_size));
+
+  // Allocate the invocation with the ABI argument/result storage trailing so
+  // that it remains valid across yields.
+  iree_host_size_t storage_offset =
+      iree_host_align(sizeof(iree_vm_invocation_t), iree_max_align_t);
+  iree_host_size_t total_size =
+      storage_offset + iree_host_align(argument_size, iree_max_align_t) +
+      result_size;
+  iree_vm_invocation_t* invocation = NULL;
+  IREE_RETURN_AND_END_ZONE_IF_ERROR(
+      z0, iree_allocator_malloc(allocator, total_size, (void**)&invocation));
+  memset(invocation, 0, total_size);
+  iree_atomic_ref_count_init(&invocation->ref_count);
+  invocation->allocator = allocator;
+  invocation->context = context;
+  iree_vm_context_retain(context);
+  invocation->function = function;
+  invocation->signature = signature;
+  invocation->cconv_results = cconv_results;
+  invocation->flags = flags;
+  invocation->status = iree_ok_status();
+
+  uint8_t* storage = (uint8_t*)invocation + storage_offset;
+  invocation->call.function = function;
+  invocation->call.arguments = iree_make_byte_span(storage, argument_size);
+  invocation->call.results = iree_make_byte_span(
+      storage + iree_host_align(argument_size, iree_max_align_t), result_size);
+
+  // Marshal the input arguments into the VM ABI now so that the caller need
+  // not keep |inputs| live.
+  iree_status_t status = iree_vm_invoke_marshal_inputs(
+      cconv_arguments, inputs, invocation->call.arguments);
+
+  if (iree_status_is_ok(status)) {
+    *out_invocation = invocation;
+  } else {
+    iree_vm_invocation_destroy(invocation);
+  }
+  IREE_TRACE_ZONE_END(z0);
+  return status;
+}
+
+IREE_API_EXPORT iree_status_t
+iree_vm_invocation_retain(iree_vm_invocation_t* invocation) {
+  if (invocation) {
+    iree_atomic_ref_count_inc(&invocation->ref_count);
+  }
+  return iree_ok_status();
+}
+
+IREE_API_EXPORT iree_status_t
+iree_vm_invocation_release(iree_vm_invocation_t* invocation) {
+  if (invocation && iree_atomic_ref_count_dec(&invocation->ref_count) == 1) {
+    iree_vm_invocation_destroy(invocation);
+  }
+  return iree_ok_status();
+}
+
+// Completes |invocation| with the given |status| (taking ownership) and
+// releases all execution resources.
+static void iree_vm_invocation_complete(iree_vm_invocation_t* invocation,
+                                        iree_status_t status) {
+  if (!iree_status_is_ok(status) && invocation->stack) {
+    status = IREE_VM_STACK_ANNOTATE_BACKTRACE_IF_ENABLED(invocation->stack,
+                                                         status);
+  }
+  if (invocation->stack) {
+    // Frees any frames still suspended on the stack.
+    iree_vm_stack_free(invocation->stack);
+    invocation->stack = NULL;
+  }
+  iree_vm_function_call_release(&invocation->call, &invocation->signature);
+  invocation->call.arguments = iree_make_byte_span(NULL, 0);
+  invocation->call.results = iree_make_byte_span(NULL, 0);
+  invocation->status = status;
+  invocation->completed = true;
+}
+
+IREE_API_EXPORT iree_status_t
+iree_vm_invocation_resume(iree_vm_invocation_t* invocation) {
+  IREE_ASSERT_ARGUMENT(invocation);
+  if (invocation->completed) return iree_ok_status();
+  IREE_TRACE_ZONE_BEGIN(z0);
+
+  iree_vm_module_t* module = invocation->function.module;
+  iree_vm_execution_result_t result;
+  memset(&result, 0, sizeof(result));
+  iree_status_t status = iree_ok_status();
+  if (!invocation->started) {
+    status = iree_vm_stack_allocate(
+        invocation->flags, iree_vm_context_state_resolver(invocation->context),
+        invocation->allocator, &invocation->stack);
+    if (iree_status_is_ok(status)) {
+      invocation->started = true;
+      status = module->begin_call(module->self, invocation->stack,
+                                  &invocation->call, &result);
+    }
+  } else if (module->resume_call) {
+    status = module->resume_call(module->self, invocation->stack,
+                                 &invocation->call, &result);
+  } else {
+    status = iree_make_status(IREE_STATUS_UNIMPLEMENTED,
+                              "module does not support resuming calls");
+  }
+  if (iree_status_is_deferred(status)) {
+    // Yielded; the frames remain on the stack until resumed.
+    invocation->wait_source = result.wait_source;
+    IREE_TRACE_ZONE_END(z0);
+    return iree_ok_status();
+  }
+  invocation->wait_source = iree_wait_source_immediate();
+
+  // Read back the outputs from the result buffer.
+  if (iree_status_is_ok(status)) {
+    iree_host_size_t result_count = invocation->cconv_results.size;
+    status = iree_vm_list_create(/*element_type=*/NULL, result_count,
+                                 invocation->allocator, &invocation->outputs);
+    if (iree_status_is_ok(status)) {
+      status = iree_vm_invoke_marshal_outputs(invocation->cconv_results,
+                                              invocation->call.results,
+                                              invocation->outputs);
+    }
+  }
+
+  iree_vm_invocation_complete(invocation, status);
+  IREE_TRACE_ZONE_END(z0);
+  return iree_ok_status();
+}
+
+// Loop callback running one step of a scheduled invocation.
+static iree_status_t iree_vm_invocation_loop_step(void* user_data,
+                                                  iree_loop_t loop,
+                                                  iree_status_t status) {
+  iree_vm_invocation_t* invocation = (iree_vm_invocation_t*)user_data;
+  if (!iree_status_is_ok(status)) {
+    // Loop is aborting; fail the invocation if it was still in-flight.
+    if (!invocation->completed) {
+      iree_vm_invocation_complete(invocation, status);
+    } else {
+      iree_status_ignore(status);
+    }
+  } else if (!invocation->completed) {
+    iree_status_ignore(iree_vm_invocation_resume(invocation));
+    if (!invocation->completed) {
+      // Yielded; park on the loop until the call can make progress or requeue
+      // behind any other pending work if it isn't blocked so that other
+      // invocations get a chance to make progress.
+      if (iree_wait_source_is_immediate(invocation->wait_source)) {
+        status = iree_loop_call(loop, IREE_LOOP_PRIORITY_DEFAULT,
+                                iree_vm_invocation_loop_step, invocation);
+      } else if (iree_wait_source_is_delay(invocation->wait_source)) {
+        // Loops service sleeps with their own timers instead of wait handles.
+        status = iree_loop_wait_until(
+            loop, iree_make_deadline((iree_time_t)invocation->wait_source.data),
+            iree_vm_invocation_loop_step, invocation);
+      } else {
+        status = iree_loop_wait_one(loop, invocation->wait_source,
+                                    iree_infinite_timeout(),
+                                    iree_vm_invocation_loop_step, invocation);
+      }
+      if (iree_status_is_ok(status)) return iree_ok_status();
+      iree_vm_invocation_complete(invocation, status);
+    }
+  }
+  invocation->scheduled = false;
+  iree_vm_invocation_release(invocation);
+  return iree_ok_status();
+}
+
+IREE_API_EXPORT iree_status_t iree_vm_invocation_schedule(
+    iree_vm_invocation_t* invocation, iree_loop_t loop) {
+  IREE_ASSERT_ARGUMENT(invocation);
+  if (invocation->completed || invocation->scheduled) {
+    return iree_make_status(IREE_STATUS_FAILED_PRECONDITION,
+                            "invocation has already completed or is scheduled");
+  }
+  invocation->scheduled = true;
+  invocation->loop = loop;
+  iree_vm_invocation_retain(invocation);
+  iree_status_t status =
+      iree_loop_call(loop, IREE_LOOP_PRIORITY_DEFAULT,
+                     iree_vm_invocation_loop_step, invocation);
+  if (!iree_status_is_ok(status)) {
+    invocation->scheduled = false;
+    iree_vm_invocation_release(invocation);
+  }
+  return status;
+}
+
+IREE_API_EXPORT iree_status_t
+iree_vm_invocation_query_status(iree_vm_invocation_t* invocation) {
+  IREE_ASSERT_ARGUMENT(invocation);
+  if (!invocation->completed) {
+    return iree_status_from_code(IREE_STATUS_UNAVAILABLE);
+  }
+  return iree_status_clone(invocation->status);
+}
+
+IREE_API_EXPORT const iree_vm_list_t* iree_vm_invocation_output(
+    iree_vm_invocation_t* invocation) {
+  IREE_ASSERT_ARGUMENT(invocation);
+  if (!invocation->completed || !iree_status_is_ok(invocation->status)) {
+    return NULL;
+  }
+  return invocation->outputs;
+}
+
+IREE_API_EXPORT iree_status_t iree_vm_invocation_await(
+    iree_vm_invocation_t* invocation, iree_time_t deadline) {
+  IREE_ASSERT_ARGUMENT(invocation);
+  IREE_TRACE_ZONE_BEGIN(z0);
+  if (invocation->scheduled) {
+    // Let the loop drive execution; it may be running other work as well.
+    IREE_RETURN_AND_END_ZONE_IF_ERROR(
+        z0, iree_loop_drain(invocation->loop, iree_make_deadline(deadline)));
+  }
+  while (!invocation->completed && !invocation->scheduled) {
+    // Block until the call can make progress instead of spinning on it.
+    // Waits may wake early (returning deferred) and the call will yield again
+    // if it is still blocked.
+    iree_status_t wait_status = iree_wait_source_wait_one(
+        invocation->wait_source, iree_make_deadline(deadline));
+    if (iree_status_is_deadline_exceeded(wait_status)) {
+      iree_status_ignore(wait_status);
+      break;
+    } else if (iree_status_is_deferred(wait_status)) {
+      iree_status_ignore(wait_status);
+    } else if (!iree_status_is_ok(wait_status)) {
+      // The wait failed and the call will never be able to make progress.
+      iree_vm_invocation_complete(invocation, wait_status);
+      break;
+    }
+    IREE_RETURN_AND_END_ZONE_IF_ERROR(z0,
+                                      iree_vm_invocation_resume(invocation));
+    if (iree_time_now() >= deadline) break;
+  }
+  IREE_TRACE_ZONE_END(z0);
+  if (!invocation->completed) {
+    return iree_status_from_code(IREE_STATUS_DEADLINE_EXCEEDED);
+  }
+  return iree_vm_invocation_query_status(invocation);
+}
+
+IREE_API_EXPORT iree_status_t
+iree_vm_invocation_abort(iree_vm_invocation_t* invocation) {
+  IREE_ASSERT_ARGUMENT(invocation);
+  if (invocation->completed) return iree_ok_status();
+  // Any step still enqueued on a loop will observe the completion and retire.
+  iree_vm_invocation_complete(invocation,
+                              iree_status_from_code(IREE_STATUS_ABORTED));
+  return iree_ok_status();
+}
@@ -22,6 +22,9 @@ typedef struct iree_vm_invocation_t iree_vm_invocation_t;
 typedef struct iree_vm_invocation_policy_t iree_vm_invocation_policy_t;
 
 // Synchronously invokes a function in the VM.
+// If the function yields (such as when an import would block) execution is
+// resumed immediately on the calling thread until it completes. Use
+// iree_vm_invocation_t to interleave multiple yielding invocations.
 //
 // |policy| is used to schedule the invocation relative to other pending or
 // in-flight invocations. It may be omitted to leave the behavior up to the
@@ -40,7 +43,19 @@ IREE_API_EXPORT iree_status_t iree_vm_invoke(
     iree_vm_list_t* inputs, iree_vm_list_t* outputs,
     iree_allocator_t allocator);
 
-// TODO(benvanik): document and implement.
+// Creates a resumable invocation of |function| in the VM.
+// |inputs| are marshaled into the invocation and need not remain live after
+// this call returns. The invocation does not begin executing until it is
+// stepped with iree_vm_invocation_resume, scheduled on a loop with
+// iree_vm_invocation_schedule, or waited on with iree_vm_invocation_await.
+//
+// When the function yields (for example when a native import would block on a
+// wait) its frames are suspended on a stack owned by the invocation and are
+// resumed on the next step. This allows a single thread to multiplex many
+// in-flight invocations.
+//
+// Thread-compatible: an invocation must only be stepped by one thread at a
+// time.
 IREE_API_EXPORT iree_status_t iree_vm_invocation_create(
     iree_vm_context_t* context, iree_vm_function_t function,
     iree_vm_invocation_flags_t flags, const iree_vm_invocation_policy_t* policy,
@@ -55,6 +70,21 @@ iree_vm_invocation_retain(iree_vm_invocation_t* invocation);
 IREE_API_EXPORT iree_status_t
 iree_vm_invocation_release(iree_vm_invocation_t* invocation);
 
+// Runs |invocation| on the calling thread until it either completes or yields.
+// Returns OK if the step was performed; the result of the invocation itself is
+// available from iree_vm_invocation_query_status once it has completed.
+// A no-op if the invocation has already completed.
+IREE_API_EXPORT iree_status_t
+iree_vm_invocation_resume(iree_vm_invocation_t* invocation);
+
+// Schedules |invocation| to run on |loop|.
+// Each time the invocation yields it waits on the loop for the wait source it
+// is blocked on (if any) and is then requeued behind any other work pending on
+// the loop until it completes. The invocation is retained until it has
+// retired from the loop.
+IREE_API_EXPORT iree_status_t iree_vm_invocation_schedule(
+    iree_vm_invocation_t* invocation, iree_loop_t loop);
+
 // Queries the completion status of the invocation.
 // Returns one of the following:
 //   IREE_STATUS_OK: the invocation completed successfully.
@@ -75,6 +105,9 @@ IREE_API_EXPORT const iree_vm_list_t* iree_vm_invocation_output(
     iree_vm_invocation_t* invocation);
 
 // Blocks the caller until the invocation completes (successfully or otherwise).
+// Invocations scheduled on a loop are awaited by draining the loop and all
+// others are stepped on the calling thread, blocking on the wait source each
+// yield is blocked on.
 //
 // Returns IREE_STATUS_DEADLINE_EXCEEDED if |deadline| elapses before the
 // invocation completes and otherwise returns iree_vm_invocation_query_status.
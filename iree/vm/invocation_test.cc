@@ -0,0 +1,300 @@
+// Copyright 2022 The IREE Authors
+//
+// Licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+#include "iree/vm/invocation.h"
+
+#include <cstring>
+#include <vector>
+
+#include "iree/base/api.h"
+#include "iree/base/loop_sync.h"
+#include "iree/testing/gtest.h"
+#include "iree/testing/status_matchers.h"
+#include "iree/vm/api.h"
+
+namespace {
+
+using iree::Status;
+using iree::StatusCode;
+using iree::testing::status::StatusIs;
+
+// Number of times each slot will yield before completing.
+static int32_t poll_remaining_[4];
+// Order in which slots were polled.
+static std::vector<int32_t> poll_order_;
+// When set polls block until this time and yield with a wait source on it.
+static iree_time_t poll_ready_time_;
+
+// vm.import @poll_module.poll(%slot : i32) -> i32
+// Yields until the slot countdown reaches zero and then returns slot * 10.
+static iree_status_t poll_module_poll(
+    iree_vm_stack_t* stack, const iree_vm_function_call_t* call,
+    iree_vm_native_function_target_t target_fn, void* module,
+    void* module_state, iree_vm_execution_result_t* out_result) {
+  int32_t slot = 0;
+  memcpy(&slot, call->arguments.data, sizeof(slot));
+  poll_order_.push_back(slot);
+  if (poll_ready_time_ && iree_time_now() < poll_ready_time_) {
+    out_result->wait_source = iree_wait_source_delay(poll_ready_time_);
+    return iree_status_from_code(IREE_STATUS_DEFERRED);
+  }
+  if (poll_remaining_[slot] > 0) {
+    --poll_remaining_[slot];
+    return iree_status_from_code(IREE_STATUS_DEFERRED);
+  }
+  int32_t result = slot * 10;
+  memcpy(call->results.data, &result, sizeof(result));
+  return iree_ok_status();
+}
+
+static const iree_vm_native_export_descriptor_t poll_module_exports_[] = {
+    {iree_string_view_t{"poll", 4}, iree_string_view_t{"0i_i", 4}, 0, NULL},
+};
+static const iree_vm_native_function_ptr_t poll_module_funcs_[] = {
+    {(iree_vm_native_function_shim_t)poll_module_poll, NULL},
+};
+static const iree_vm_native_module_descriptor_t poll_module_descriptor_ = {
+    iree_string_view_t{"poll_module", 11},
+    0,
+    NULL,
+    IREE_ARRAYSIZE(poll_module_exports_),
+    poll_module_exports_,
+    IREE_ARRAYSIZE(poll_module_funcs_),
+    poll_module_funcs_,
+    0,
+    NULL,
+};
+
+class VMInvocationTest : public ::testing::Test {
+ protected:
+  virtual void SetUp() {
+    memset(poll_remaining_, 0, sizeof(poll_remaining_));
+    poll_order_.clear();
+    poll_ready_time_ = 0;
+
+    IREE_CHECK_OK(iree_vm_instance_create(iree_allocator_system(), &instance_));
+    iree_vm_module_t interface;
+    IREE_CHECK_OK(iree_vm_module_initialize(&interface, NULL));
+    iree_vm_module_t* module = NULL;
+    IREE_CHECK_OK(iree_vm_native_module_create(
+        &interface, &poll_module_descriptor_, iree_allocator_system(),
+        &module));
+    IREE_CHECK_OK(iree_vm_context_create_with_modules(
+        instance_, IREE_VM_CONTEXT_FLAG_NONE, &module, 1,
+        iree_allocator_system(), &context_));
+    iree_vm_module_release(module);
+    IREE_CHECK_OK(iree_vm_context_resolve_function(
+        context_, iree_make_cstring_view("poll_module.poll"), &function_));
+  }
+
+  virtual void TearDown() {
+    iree_vm_context_release(context_);
+    iree_vm_instance_release(instance_);
+  }
+
+  iree_vm_list_t* MakeInputs(int32_t slot) {
+    iree_vm_list_t* inputs = NULL;
+    IREE_CHECK_OK(iree_vm_list_create(/*element_type=*/NULL, 1,
+                                      iree_allocator_system(), &inputs));
+    iree_vm_value_t value = iree_vm_value_make_i32(slot);
+    IREE_CHECK_OK(iree_vm_list_push_value(inputs, &value));
+    return inputs;
+  }
+
+  iree_vm_invocation_t* CreateInvocation(int32_t slot) {
+    iree_vm_list_t* inputs = MakeInputs(slot);
+    iree_vm_invocation_t* invocation = NULL;
+    IREE_CHECK_OK(iree_vm_invocation_create(
+        context_, function_, IREE_VM_INVOCATION_FLAG_NONE, /*policy=*/NULL,
+        inputs, iree_allocator_system(), &invocation));
+    iree_vm_list_release(inputs);
+    return invocation;
+  }
+
+  static int32_t GetResult(iree_vm_invocation_t* invocation) {
+    const iree_vm_list_t* outputs = iree_vm_invocation_output(invocation);
+    EXPECT_NE(outputs, nullptr);
+    if (!outputs) return -1;
+    iree_vm_value_t value;
+    IREE_EXPECT_OK(iree_vm_list_get_value(outputs, 0, &value));
+    return value.i32;
+  }
+
+  iree_vm_instance_t* instance_ = NULL;
+  iree_vm_context_t* context_ = NULL;
+  iree_vm_function_t function_;
+};
+
+// Synchronous invocations resume yielded calls until they complete.
+TEST_F(VMInvocationTest, InvokeResumesYields) {
+  poll_remaining_[1] = 3;
+  iree_vm_list_t* inputs = MakeInputs(1);
+  iree_vm_list_t* outputs = NULL;
+  IREE_ASSERT_OK(iree_vm_list_create(/*element_type=*/NULL, 1,
+                                     iree_allocator_system(), &outputs));
+  IREE_ASSERT_OK(iree_vm_invoke(context_, function_,
+                                IREE_VM_INVOCATION_FLAG_NONE, /*policy=*/NULL,
+                                inputs, outputs, iree_allocator_system()));
+  iree_vm_value_t value;
+  IREE_ASSERT_OK(iree_vm_list_get_value(outputs, 0, &value));
+  EXPECT_EQ(value.i32, 10);
+  EXPECT_EQ(poll_order_.size(), 4);
+  iree_vm_list_release(outputs);
+  iree_vm_list_release(inputs);
+}
+
+// Each resume runs until the next yield.
+TEST_F(VMInvocationTest, ResumeSteps) {
+  poll_remaining_[2] = 2;
+  iree_vm_invocation_t* invocation = CreateInvocation(2);
+  EXPECT_THAT(Status(iree_vm_invocation_query_status(invocation)),
+              StatusIs(StatusCode::kUnavailable));
+  EXPECT_EQ(iree_vm_invocation_output(invocation), nullptr);
+
+  IREE_ASSERT_OK(iree_vm_invocation_resume(invocation));
+  EXPECT_THAT(Status(iree_vm_invocation_query_status(invocation)),
+              StatusIs(StatusCode::kUnavailable));
+  IREE_ASSERT_OK(iree_vm_invocation_resume(invocation));
+  EXPECT_THAT(Status(iree_vm_invocation_query_status(invocation)),
+              StatusIs(StatusCode::kUnavailable));
+  IREE_ASSERT_OK(iree_vm_invocation_resume(invocation));
+  IREE_EXPECT_OK(iree_vm_invocation_query_status(invocation));
+  EXPECT_EQ(GetResult(invocation), 20);
+  EXPECT_EQ(poll_order_.size(), 3);
+
+  iree_vm_invocation_release(invocation);
+}
+
+// Awaiting steps the invocation on the calling thread.
+TEST_F(VMInvocationTest, Await) {
+  poll_remaining_[3] = 5;
+  iree_vm_invocation_t* invocation = CreateInvocation(3);
+  IREE_ASSERT_OK(
+      iree_vm_invocation_await(invocation, IREE_TIME_INFINITE_FUTURE));
+  EXPECT_EQ(GetResult(invocation), 30);
+  iree_vm_invocation_release(invocation);
+}
+
+// Synchronous invocations block on the wait source of a yield instead of
+// repeatedly resuming the call.
+TEST_F(VMInvocationTest, InvokeWaitsOnYield) {
+  poll_ready_time_ = iree_time_now() + 5000000;  // 5ms
+  iree_vm_list_t* inputs = MakeInputs(1);
+  iree_vm_list_t* outputs = NULL;
+  IREE_ASSERT_OK(iree_vm_list_create(/*element_type=*/NULL, 1,
+                                     iree_allocator_system(), &outputs));
+  IREE_ASSERT_OK(iree_vm_invoke(context_, function_,
+                                IREE_VM_INVOCATION_FLAG_NONE, /*policy=*/NULL,
+                                inputs, outputs, iree_allocator_system()));
+  EXPECT_GE(iree_time_now(), poll_ready_time_);
+  iree_vm_value_t value;
+  IREE_ASSERT_OK(iree_vm_list_get_value(outputs, 0, &value));
+  EXPECT_EQ(value.i32, 10);
+  EXPECT_EQ(poll_order_.size(), 2);
+  iree_vm_list_release(outputs);
+  iree_vm_list_release(inputs);
+}
+
+// Awaiting blocks on the wait source of a yield.
+TEST_F(VMInvocationTest, AwaitWaitsOnYield) {
+  poll_ready_time_ = iree_time_now() + 5000000;  // 5ms
+  iree_vm_invocation_t* invocation = CreateInvocation(3);
+  IREE_ASSERT_OK(
+      iree_vm_invocation_await(invocation, IREE_TIME_INFINITE_FUTURE));
+  EXPECT_GE(iree_time_now(), poll_ready_time_);
+  EXPECT_EQ(GetResult(invocation), 30);
+  EXPECT_EQ(poll_order_.size(), 2);
+  iree_vm_invocation_release(invocation);
+}
+
+// Awaiting with a deadline earlier than the wait source times out.
+TEST_F(VMInvocationTest, AwaitDeadlineExceeded) {
+  poll_ready_time_ = iree_time_now() + 1000000000;  // 1s
+  iree_vm_invocation_t* invocation = CreateInvocation(3);
+  EXPECT_THAT(Status(iree_vm_invocation_await(invocation,
+                                              iree_time_now() + 1000000)),
+              StatusIs(StatusCode::kDeadlineExceeded));
+  EXPECT_EQ(poll_order_.size(), 1);
+  IREE_ASSERT_OK(iree_vm_invocation_abort(invocation));
+  iree_vm_invocation_release(invocation);
+}
+
+// Aborted invocations complete with IREE_STATUS_ABORTED.
+TEST_F(VMInvocationTest, Abort) {
+  poll_remaining_[0] = 100;
+  iree_vm_invocation_t* invocation = CreateInvocation(0);
+  IREE_ASSERT_OK(iree_vm_invocation_resume(invocation));
+  IREE_ASSERT_OK(iree_vm_invocation_abort(invocation));
+  EXPECT_THAT(Status(iree_vm_invocation_query_status(invocation)),
+              StatusIs(StatusCode::kAborted));
+  EXPECT_EQ(iree_vm_invocation_output(invocation), nullptr);
+  iree_vm_invocation_release(invocation);
+}
+
+// Multiple invocations scheduled on one loop interleave at yields.
+TEST_F(VMInvocationTest, ScheduleInterleaves) {
+  iree_loop_sync_options_t options = {0};
+  options.max_queue_depth = 16;
+  options.max_wait_count = 4;
+  iree_loop_sync_t* loop_sync = NULL;
+  IREE_ASSERT_OK(
+      iree_loop_sync_allocate(options, iree_allocator_system(), &loop_sync));
+  iree_loop_sync_scope_t scope;
+  iree_loop_sync_scope_initialize(loop_sync, /*error_fn=*/NULL,
+                                  /*error_user_data=*/NULL, &scope);
+  iree_loop_t loop = iree_loop_sync_scope(&scope);
+
+  poll_remaining_[1] = 2;
+  poll_remaining_[2] = 2;
+  iree_vm_invocation_t* invocation_1 = CreateInvocation(1);
+  iree_vm_invocation_t* invocation_2 = CreateInvocation(2);
+  IREE_ASSERT_OK(iree_vm_invocation_schedule(invocation_1, loop));
+  IREE_ASSERT_OK(iree_vm_invocation_schedule(invocation_2, loop));
+  IREE_ASSERT_OK(iree_loop_sync_wait_idle(loop_sync, iree_infinite_timeout()));
+
+  IREE_EXPECT_OK(iree_vm_invocation_query_status(invocation_1));
+  IREE_EXPECT_OK(iree_vm_invocation_query_status(invocation_2));
+  EXPECT_EQ(GetResult(invocation_1), 10);
+  EXPECT_EQ(GetResult(invocation_2), 20);
+  std::vector<int32_t> expected_order = {1, 2, 1, 2, 1, 2};
+  EXPECT_EQ(poll_order_, expected_order);
+
+  iree_vm_invocation_release(invocation_1);
+  iree_vm_invocation_release(invocation_2);
+  iree_loop_sync_scope_deinitialize(&scope);
+  iree_loop_sync_free(loop_sync);
+}
+
+// Scheduled invocations park on the loop until the wait source of a yield
+// resolves.
+TEST_F(VMInvocationTest, ScheduleWaitsOnYield) {
+  iree_loop_sync_options_t options = {0};
+  options.max_queue_depth = 16;
+  options.max_wait_count = 4;
+  iree_loop_sync_t* loop_sync = NULL;
+  IREE_ASSERT_OK(
+      iree_loop_sync_allocate(options, iree_allocator_system(), &loop_sync));
+  iree_loop_sync_scope_t scope;
+  iree_loop_sync_scope_initialize(loop_sync, /*error_fn=*/NULL,
+                                  /*error_user_data=*/NULL, &scope);
+  iree_loop_t loop = iree_loop_sync_scope(&scope);
+
+  poll_ready_time_ = iree_time_now() + 5000000;  // 5ms
+  iree_vm_invocation_t* invocation = CreateInvocation(2);
+  IREE_ASSERT_OK(iree_vm_invocation_schedule(invocation, loop));
+  IREE_ASSERT_OK(iree_loop_sync_wait_idle(loop_sync, iree_infinite_timeout()));
+
+  EXPECT_GE(iree_time_now(), poll_ready_time_);
+  IREE_EXPECT_OK(iree_vm_invocation_query_status(invocation));
+  EXPECT_EQ(GetResult(invocation), 20);
+  EXPECT_EQ(poll_order_.size(), 2);
+
+  iree_vm_invocation_release(invocation);
+  iree_loop_sync_scope_deinitialize(&scope);
+  iree_loop_sync_free(loop_sync);
+}
+
+}  // namespace
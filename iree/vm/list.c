@@ -345,6 +345,56 @@ static void iree_vm_list_convert_value_type(
   }
 }
 
+// Loads a primitive value of |element_size| bytes from |element_ptr| into the
+// storage of |out_value|. The remaining bytes of |out_value| are untouched and
+// the caller is expected to have zeroed them.
+static inline void iree_vm_list_load_value(uintptr_t element_ptr,
+                                           iree_host_size_t element_size,
+                                           iree_vm_value_t* out_value) {
+#if defined(IREE_ENDIANNESS_LITTLE)
+  memcpy(out_value->value_storage, (const void*)element_ptr, element_size);
+#else
+  switch (element_size) {
+    case 1:
+      out_value->i8 = *(int8_t*)element_ptr;
+      break;
+    case 2:
+      out_value->i16 = *(int16_t*)element_ptr;
+      break;
+    case 4:
+      out_value->i32 = *(int32_t*)element_ptr;
+      break;
+    case 8:
+      out_value->i64 = *(int64_t*)element_ptr;
+      break;
+  }
+#endif  // IREE_ENDIANNESS_LITTLE
+}
+
+// Stores the low |element_size| bytes of |value| to |element_ptr|.
+static inline void iree_vm_list_store_value(const iree_vm_value_t* value,
+                                            iree_host_size_t element_size,
+                                            uintptr_t element_ptr) {
+#if defined(IREE_ENDIANNESS_LITTLE)
+  memcpy((void*)element_ptr, value->value_storage, element_size);
+#else
+  switch (element_size) {
+    case 1:
+      *(int8_t*)element_ptr = value->i8;
+      break;
+    case 2:
+      *(int16_t*)element_ptr = value->i16;
+      break;
+    case 4:
+      *(int32_t*)element_ptr = value->i32;
+      break;
+    case 8:
+      *(int64_t*)element_ptr = value->i64;
+      break;
+  }
+#endif  // IREE_ENDIANNESS_LITTLE
+}
+
 IREE_API_EXPORT iree_status_t
 iree_vm_list_get_value(const iree_vm_list_t* list, iree_host_size_t i,
                        iree_vm_value_t* out_value) {
@@ -357,21 +407,7 @@ iree_vm_list_get_value(const iree_vm_list_t* list, iree_host_size_t i,
   switch (list->storage_mode) {
     case IREE_VM_LIST_STORAGE_MODE_VALUE: {
       out_value->type = list->element_type.value_type;
-      // TODO(benvanik): #ifdef on LITTLE/BIG_ENDIAN and just memcpy.
-      switch (list->element_size) {
-        case 1:
-          out_value->i8 = *(int8_t*)element_ptr;
-          break;
-        case 2:
-          out_value->i16 = *(int16_t*)element_ptr;
-          break;
-        case 4:
-          out_value->i32 = *(int32_t*)element_ptr;
-          break;
-        case 8:
-          out_value->i64 = *(int64_t*)element_ptr;
-          break;
-      }
+      iree_vm_list_load_value(element_ptr, list->element_size, out_value);
       break;
     }
     case IREE_VM_LIST_STORAGE_MODE_VARIANT: {
@@ -404,21 +440,7 @@ IREE_API_EXPORT iree_status_t iree_vm_list_get_value_as(
   switch (list->storage_mode) {
     case IREE_VM_LIST_STORAGE_MODE_VALUE: {
       value.type = list->element_type.value_type;
-      // TODO(benvanik): #ifdef on LITTLE/BIG_ENDIAN and just memcpy.
-      switch (list->element_size) {
-        case 1:
-          value.i8 = *(int8_t*)element_ptr;
-          break;
-        case 2:
-          value.i16 = *(int16_t*)element_ptr;
-          break;
-        case 4:
-          value.i32 = *(int32_t*)element_ptr;
-          break;
-        case 8:
-          value.i64 = *(int64_t*)element_ptr;
-          break;
-      }
+      iree_vm_list_load_value(element_ptr, list->element_size, &value);
       break;
     }
     case IREE_VM_LIST_STORAGE_MODE_VARIANT: {
@@ -465,21 +487,8 @@ IREE_API_EXPORT iree_status_t iree_vm_list_set_value(
   uintptr_t element_ptr = (uintptr_t)list->storage + i * list->element_size;
   switch (list->storage_mode) {
     case IREE_VM_LIST_STORAGE_MODE_VALUE: {
-      // TODO(benvanik): #ifdef on LITTLE/BIG_ENDIAN and just memcpy.
-      switch (list->element_size) {
-        case 1:
-          *(int8_t*)element_ptr = converted_value.i8;
-          break;
-        case 2:
-          *(int16_t*)element_ptr = converted_value.i16;
-          break;
-        case 4:
-          *(int32_t*)element_ptr = converted_value.i32;
-          break;
-        case 8:
-          *(int64_t*)element_ptr = converted_value.i64;
-          break;
-      }
+      iree_vm_list_store_value(&converted_value, list->element_size,
+                               element_ptr);
       break;
     }
     case IREE_VM_LIST_STORAGE_MODE_VARIANT: {
@@ -507,6 +516,206 @@ iree_vm_list_push_value(iree_vm_list_t* list, const iree_vm_value_t* value) {
   return iree_vm_list_set_value(list, i, value);
 }
 
+// Converts |count| dense primitive values of |source_type| at |source| into
+// dense primitive values of |target_type| at |target|. Integer types are
+// sign-extended or truncated and f32/f64 are widened or narrowed. Conversions
+// between integer and floating-point types fail with INVALID_ARGUMENT.
+//
+// NOTE: this is intentionally stricter than iree_vm_list_convert_value_type,
+// which silently yields zero for any conversion it does not support
+// (including f32 <-> f64); bulk callers get an error instead of zeros.
+//
+// Each specialization is a trivial loop over restrict-qualified pointers so
+// that the compiler can vectorize it; same-type copies are a plain memcpy.
+static iree_status_t iree_vm_list_convert_value_range(
+    iree_vm_value_type_t source_type, const void* source,
+    iree_vm_value_type_t target_type, void* target, iree_host_size_t count) {
+  if (source_type == target_type) {
+    memcpy(target, source, count * iree_vm_value_type_size(source_type));
+    return iree_ok_status();
+  }
+#define IREE_VM_LIST_CONVERT_RANGE(source_t, target_t)                    \
+  {                                                                       \
+    const source_t* IREE_RESTRICT source_ptr = (const source_t*)source;   \
+    target_t* IREE_RESTRICT target_ptr = (target_t*)target;               \
+    for (iree_host_size_t j = 0; j < count; ++j) {                        \
+      target_ptr[j] = (target_t)source_ptr[j];                            \
+    }                                                                     \
+    return iree_ok_status();                                              \
+  }
+#define IREE_VM_LIST_CONVERT_CASE(source_t, target_enum, target_t) \
+  case IREE_VM_VALUE_TYPE_##target_enum:                           \
+    IREE_VM_LIST_CONVERT_RANGE(source_t, target_t)
+#define IREE_VM_LIST_CONVERT_INTEGER_CASES(source_t) \
+  switch (target_type) {                             \
+    IREE_VM_LIST_CONVERT_CASE(source_t, I8, int8_t)   \
+    IREE_VM_LIST_CONVERT_CASE(source_t, I16, int16_t) \
+    IREE_VM_LIST_CONVERT_CASE(source_t, I32, int32_t) \
+    IREE_VM_LIST_CONVERT_CASE(source_t, I64, int64_t) \
+    default:                                         \
+      break;                                         \
+  }                                                  \
+  break;
+  switch (source_type) {
+    case IREE_VM_VALUE_TYPE_I8:
+      IREE_VM_LIST_CONVERT_INTEGER_CASES(int8_t);
+    case IREE_VM_VALUE_TYPE_I16:
+      IREE_VM_LIST_CONVERT_INTEGER_CASES(int16_t);
+    case IREE_VM_VALUE_TYPE_I32:
+      IREE_VM_LIST_CONVERT_INTEGER_CASES(int32_t);
+    case IREE_VM_VALUE_TYPE_I64:
+      IREE_VM_LIST_CONVERT_INTEGER_CASES(int64_t);
+    case IREE_VM_VALUE_TYPE_F32:
+      if (target_type == IREE_VM_VALUE_TYPE_F64) {
+        IREE_VM_LIST_CONVERT_RANGE(float, double);
+      }
+      break;
+    case IREE_VM_VALUE_TYPE_F64:
+      if (target_type == IREE_VM_VALUE_TYPE_F32) {
+        IREE_VM_LIST_CONVERT_RANGE(double, float);
+      }
+      break;
+    default:
+      break;
+  }
+#undef IREE_VM_LIST_CONVERT_INTEGER_CASES
+#undef IREE_VM_LIST_CONVERT_CASE
+#undef IREE_VM_LIST_CONVERT_RANGE
+  return iree_make_status(IREE_STATUS_INVALID_ARGUMENT,
+                          "unsupported value type conversion %d -> %d",
+                          (int)source_type, (int)target_type);
+}
+
+// Verifies that [i, i + count) is in bounds of |list| and that |span_length|
+// holds exactly |count| elements of |value_type|; returns the element count.
+static iree_status_t iree_vm_list_verify_value_range(
+    const iree_vm_list_t* list, iree_host_size_t i,
+    iree_vm_value_type_t value_type, iree_host_size_t span_length,
+    iree_host_size_t* out_count) {
+  iree_host_size_t value_size = iree_vm_value_type_size(value_type);
+  if (value_size == 0) {
+    return iree_make_status(IREE_STATUS_INVALID_ARGUMENT,
+                            "invalid value type %d", (int)value_type);
+  } else if (span_length % value_size != 0) {
+    return iree_make_status(
+        IREE_STATUS_INVALID_ARGUMENT,
+        "value span length %zu is not a multiple of the element size %zu",
+        span_length, value_size);
+  }
+  iree_host_size_t count = span_length / value_size;
+  if (i > list->count || count > list->count - i) {
+    return iree_make_status(IREE_STATUS_OUT_OF_RANGE,
+                            "range [%zu, %zu) out of bounds (%zu)", i,
+                            i + count, list->count);
+  }
+  *out_count = count;
+  return iree_ok_status();
+}
+
+IREE_API_EXPORT iree_status_t iree_vm_list_get_values_as(
+    const iree_vm_list_t* list, iree_host_size_t i,
+    iree_vm_value_type_t value_type, iree_byte_span_t out_values) {
+  iree_host_size_t count = 0;
+  IREE_RETURN_IF_ERROR(iree_vm_list_verify_value_range(
+      list, i, value_type, out_values.data_length, &count));
+  switch (list->storage_mode) {
+    case IREE_VM_LIST_STORAGE_MODE_VALUE: {
+      return iree_vm_list_convert_value_range(
+          list->element_type.value_type,
+          (const uint8_t*)list->storage + i * list->element_size, value_type,
+          out_values.data, count);
+    }
+    case IREE_VM_LIST_STORAGE_MODE_VARIANT: {
+      // Each element may have a different type so we have to go one by one.
+      // Conversion uses the same rules as value lists so that the result does
+      // not depend on the list storage mode.
+      iree_host_size_t value_size = iree_vm_value_type_size(value_type);
+      for (iree_host_size_t j = 0; j < count; ++j) {
+        const iree_vm_variant_t* variant =
+            (const iree_vm_variant_t*)((const uint8_t*)list->storage +
+                                       (i + j) * list->element_size);
+        if (!iree_vm_type_def_is_value(&variant->type)) {
+          return iree_make_status(IREE_STATUS_FAILED_PRECONDITION,
+                                  "variant at index %zu is not a value type",
+                                  i + j);
+        }
+        IREE_RETURN_IF_ERROR(iree_vm_list_convert_value_range(
+            variant->type.value_type, variant->value_storage, value_type,
+            out_values.data + j * value_size, 1));
+      }
+      return iree_ok_status();
+    }
+    default:
+      return iree_make_status(IREE_STATUS_FAILED_PRECONDITION,
+                              "list does not store values");
+  }
+}
+
+IREE_API_EXPORT iree_status_t iree_vm_list_set_values(
+    iree_vm_list_t* list, iree_host_size_t i, iree_vm_value_type_t value_type,
+    iree_const_byte_span_t values) {
+  iree_host_size_t count = 0;
+  IREE_RETURN_IF_ERROR(iree_vm_list_verify_value_range(
+      list, i, value_type, values.data_length, &count));
+  switch (list->storage_mode) {
+    case IREE_VM_LIST_STORAGE_MODE_VALUE: {
+      return iree_vm_list_convert_value_range(
+          value_type, values.data, list->element_type.value_type,
+          (uint8_t*)list->storage + i * list->element_size, count);
+    }
+    case IREE_VM_LIST_STORAGE_MODE_VARIANT: {
+      iree_host_size_t value_size = iree_vm_value_type_size(value_type);
+      for (iree_host_size_t j = 0; j < count; ++j) {
+        iree_vm_value_t value;
+        value.type = value_type;
+        value.i64 = 0;
+        memcpy(value.value_storage, values.data + j * value_size, value_size);
+        IREE_RETURN_IF_ERROR(iree_vm_list_set_value(list, i + j, &value));
+      }
+      return iree_ok_status();
+    }
+    default:
+      return iree_make_status(IREE_STATUS_FAILED_PRECONDITION,
+                              "list cannot store values");
+  }
+}
+
+IREE_API_EXPORT iree_status_t
+iree_vm_list_push_values(iree_vm_list_t* list, iree_vm_value_type_t value_type,
+                         iree_const_byte_span_t values) {
+  iree_host_size_t value_size = iree_vm_value_type_size(value_type);
+  if (value_size == 0) {
+    return iree_make_status(IREE_STATUS_INVALID_ARGUMENT,
+                            "invalid value type %d", (int)value_type);
+  }
+  iree_host_size_t i = iree_vm_list_size(list);
+  IREE_RETURN_IF_ERROR(
+      iree_vm_list_resize(list, i + values.data_length / value_size));
+  iree_status_t status = iree_vm_list_set_values(list, i, value_type, values);
+  if (!iree_status_is_ok(status)) {
+    // Drop the partially-initialized tail so the list is left unchanged.
+    iree_vm_list_reset_range(list, i, list->count - i);
+    list->count = i;
+  }
+  return status;
+}
+
+IREE_API_EXPORT iree_status_t iree_vm_list_map_values(
+    iree_vm_list_t* list, iree_vm_value_type_t* out_value_type,
+    iree_byte_span_t* out_storage) {
+  *out_value_type = IREE_VM_VALUE_TYPE_NONE;
+  *out_storage = iree_byte_span_empty();
+  if (list->storage_mode != IREE_VM_LIST_STORAGE_MODE_VALUE) {
+    return iree_make_status(IREE_STATUS_FAILED_PRECONDITION,
+                            "only lists of primitive values have contiguous "
+                            "typed storage");
+  }
+  *out_value_type = list->element_type.value_type;
+  *out_storage =
+      iree_make_byte_span(list->storage, list->count * list->element_size);
+  return iree_ok_status();
+}
+
 IREE_API_EXPORT void* iree_vm_list_get_ref_deref(
     const iree_vm_list_t* list, iree_host_size_t i,
     const iree_vm_ref_type_descriptor_t* type_descriptor) {
@@ -121,6 +121,50 @@ IREE_API_EXPORT iree_status_t iree_vm_list_set_value(
 IREE_API_EXPORT iree_status_t
 iree_vm_list_push_value(iree_vm_list_t* list, const iree_vm_value_t* value);
 
+// Copies the values of the elements in the range starting at index |i| into
+// |out_values| as a dense array of |value_type|. The number of elements copied
+// is derived from the length of |out_values|, which must be a multiple of the
+// size of |value_type|. If the list storage type differs from |value_type| the
+// values are converted: integers are sign-extended or truncated and f32/f64
+// are widened or narrowed. Unlike iree_vm_list_get_value_as, which yields zero
+// for conversions it does not support, integer <-> floating-point conversions
+// fail with IREE_STATUS_INVALID_ARGUMENT.
+//
+// Lists of primitive values are converted in bulk and are significantly faster
+// than calling iree_vm_list_get_value_as for each element.
+IREE_API_EXPORT iree_status_t iree_vm_list_get_values_as(
+    const iree_vm_list_t* list, iree_host_size_t i,
+    iree_vm_value_type_t value_type, iree_byte_span_t out_values);
+
+// Sets the values of the elements in the range starting at index |i| from
+// |values| as a dense array of |value_type|. The range must already be within
+// the list size. If |value_type| differs from the list storage type the values
+// are converted with the same rules as iree_vm_list_get_values_as (which differ
+// from iree_vm_list_set_value for unsupported conversions).
+IREE_API_EXPORT iree_status_t iree_vm_list_set_values(
+    iree_vm_list_t* list, iree_host_size_t i, iree_vm_value_type_t value_type,
+    iree_const_byte_span_t values);
+
+// Pushes the dense array of |value_type| |values| to the end of the list.
+// The list is grown at most once. If |value_type| differs from the list storage
+// type the values are converted with the same rules as
+// iree_vm_list_get_values_as. On failure the list is left unmodified.
+IREE_API_EXPORT iree_status_t
+iree_vm_list_push_values(iree_vm_list_t* list, iree_vm_value_type_t value_type,
+                         iree_const_byte_span_t values);
+
+// Returns a view of the contiguous typed storage of a list of primitive values
+// covering the current list size. The storage can be read and written directly
+// as a dense array of |out_value_type| and avoids any per-element overhead.
+// The view is invalidated by any operation that may change the list capacity
+// (reserve, resize, push, etc).
+//
+// Fails with IREE_STATUS_FAILED_PRECONDITION if the list stores refs or
+// variants as those do not have a dense primitive layout.
+IREE_API_EXPORT iree_status_t iree_vm_list_map_values(
+    iree_vm_list_t* list, iree_vm_value_type_t* out_value_type,
+    iree_byte_span_t* out_storage);
+
 // Returns a dereferenced pointer to the given type if the element at the given
 // index matches the type. Returns NULL on error.
 IREE_API_EXPORT void* iree_vm_list_get_ref_deref(
@@ -0,0 +1,151 @@
+// Copyright 2022 The IREE Authors
+//
+// Licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+#include <cstdint>
+#include <vector>
+
+#include "benchmark/benchmark.h"
+#include "iree/base/api.h"
+#include "iree/base/logging.h"
+#include "iree/vm/builtin_types.h"
+#include "iree/vm/list.h"
+
+namespace {
+
+static iree_vm_list_t* CreateValueList(iree_vm_value_type_t value_type,
+                                       iree_host_size_t count) {
+  IREE_CHECK_OK(iree_vm_register_builtin_types());
+  iree_vm_type_def_t element_type =
+      iree_vm_type_def_make_value_type(value_type);
+  iree_vm_list_t* list = nullptr;
+  IREE_CHECK_OK(iree_vm_list_create(&element_type, count,
+                                    iree_allocator_system(), &list));
+  IREE_CHECK_OK(iree_vm_list_resize(list, count));
+  return list;
+}
+
+// Pushes |count| i32 values one at a time with iree_vm_list_push_value.
+static void BM_PushValueI32(benchmark::State& state) {
+  iree_host_size_t count = (iree_host_size_t)state.range(0);
+  std::vector<int32_t> values(count, 1);
+  for (auto _ : state) {
+    iree_vm_list_t* list = CreateValueList(IREE_VM_VALUE_TYPE_I32, 0);
+    for (iree_host_size_t i = 0; i < count; ++i) {
+      iree_vm_value_t value = iree_vm_value_make_i32(values[i]);
+      IREE_CHECK_OK(iree_vm_list_push_value(list, &value));
+    }
+    benchmark::DoNotOptimize(list);
+    iree_vm_list_release(list);
+  }
+  state.SetItemsProcessed(state.iterations() * count);
+}
+BENCHMARK(BM_PushValueI32)->Arg(64)->Arg(4096)->Arg(65536);
+
+// Pushes |count| i32 values in a single iree_vm_list_push_values call.
+static void BM_PushValuesI32(benchmark::State& state) {
+  iree_host_size_t count = (iree_host_size_t)state.range(0);
+  std::vector<int32_t> values(count, 1);
+  for (auto _ : state) {
+    iree_vm_list_t* list = CreateValueList(IREE_VM_VALUE_TYPE_I32, 0);
+    IREE_CHECK_OK(iree_vm_list_push_values(
+        list, IREE_VM_VALUE_TYPE_I32,
+        iree_make_const_byte_span(values.data(), count * sizeof(int32_t))));
+    benchmark::DoNotOptimize(list);
+    iree_vm_list_release(list);
+  }
+  state.SetItemsProcessed(state.iterations() * count);
+}
+BENCHMARK(BM_PushValuesI32)->Arg(64)->Arg(4096)->Arg(65536);
+
+// Reads |count| i32 values as i64 one at a time with iree_vm_list_get_value_as.
+static void BM_GetValueAsI32ToI64(benchmark::State& state) {
+  iree_host_size_t count = (iree_host_size_t)state.range(0);
+  iree_vm_list_t* list = CreateValueList(IREE_VM_VALUE_TYPE_I32, count);
+  std::vector<int64_t> values(count);
+  for (auto _ : state) {
+    for (iree_host_size_t i = 0; i < count; ++i) {
+      iree_vm_value_t value;
+      IREE_CHECK_OK(
+          iree_vm_list_get_value_as(list, i, IREE_VM_VALUE_TYPE_I64, &value));
+      values[i] = value.i64;
+    }
+    benchmark::DoNotOptimize(values.data());
+  }
+  state.SetItemsProcessed(state.iterations() * count);
+  iree_vm_list_release(list);
+}
+BENCHMARK(BM_GetValueAsI32ToI64)->Arg(64)->Arg(4096)->Arg(65536);
+
+// Reads |count| i32 values as i64 in a single iree_vm_list_get_values_as call.
+static void BM_GetValuesAsI32ToI64(benchmark::State& state) {
+  iree_host_size_t count = (iree_host_size_t)state.range(0);
+  iree_vm_list_t* list = CreateValueList(IREE_VM_VALUE_TYPE_I32, count);
+  std::vector<int64_t> values(count);
+  for (auto _ : state) {
+    IREE_CHECK_OK(iree_vm_list_get_values_as(
+        list, 0, IREE_VM_VALUE_TYPE_I64,
+        iree_make_byte_span(values.data(), count * sizeof(int64_t))));
+    benchmark::DoNotOptimize(values.data());
+  }
+  state.SetItemsProcessed(state.iterations() * count);
+  iree_vm_list_release(list);
+}
+BENCHMARK(BM_GetValuesAsI32ToI64)->Arg(64)->Arg(4096)->Arg(65536);
+
+// Writes |count| f64 values into an f32 list one at a time.
+static void BM_SetValueF64ToF32(benchmark::State& state) {
+  iree_host_size_t count = (iree_host_size_t)state.range(0);
+  iree_vm_list_t* list = CreateValueList(IREE_VM_VALUE_TYPE_F32, count);
+  std::vector<double> values(count, 1.0);
+  for (auto _ : state) {
+    for (iree_host_size_t i = 0; i < count; ++i) {
+      iree_vm_value_t value = iree_vm_value_make_f64(values[i]);
+      IREE_CHECK_OK(iree_vm_list_set_value(list, i, &value));
+    }
+    benchmark::DoNotOptimize(list);
+  }
+  state.SetItemsProcessed(state.iterations() * count);
+  iree_vm_list_release(list);
+}
+BENCHMARK(BM_SetValueF64ToF32)->Arg(64)->Arg(4096)->Arg(65536);
+
+// Writes |count| f64 values into an f32 list with iree_vm_list_set_values.
+static void BM_SetValuesF64ToF32(benchmark::State& state) {
+  iree_host_size_t count = (iree_host_size_t)state.range(0);
+  iree_vm_list_t* list = CreateValueList(IREE_VM_VALUE_TYPE_F32, count);
+  std::vector<double> values(count, 1.0);
+  for (auto _ : state) {
+    IREE_CHECK_OK(iree_vm_list_set_values(
+        list, 0, IREE_VM_VALUE_TYPE_F64,
+        iree_make_const_byte_span(values.data(), count * sizeof(double))));
+    benchmark::DoNotOptimize(list);
+  }
+  state.SetItemsProcessed(state.iterations() * count);
+  iree_vm_list_release(list);
+}
+BENCHMARK(BM_SetValuesF64ToF32)->Arg(64)->Arg(4096)->Arg(65536);
+
+// Sums |count| f32 values directly through the mapped list storage.
+static void BM_MapValuesF32(benchmark::State& state) {
+  iree_host_size_t count = (iree_host_size_t)state.range(0);
+  iree_vm_list_t* list = CreateValueList(IREE_VM_VALUE_TYPE_F32, count);
+  for (auto _ : state) {
+    iree_vm_value_type_t value_type = IREE_VM_VALUE_TYPE_NONE;
+    iree_byte_span_t storage = iree_byte_span_empty();
+    IREE_CHECK_OK(iree_vm_list_map_values(list, &value_type, &storage));
+    const float* values = (const float*)storage.data;
+    float sum = 0.0f;
+    for (iree_host_size_t i = 0; i < count; ++i) {
+      sum += values[i];
+    }
+    benchmark::DoNotOptimize(sum);
+  }
+  state.SetItemsProcessed(state.iterations() * count);
+  iree_vm_list_release(list);
+}
+BENCHMARK(BM_MapValuesF32)->Arg(64)->Arg(4096)->Arg(65536);
+
+}  // namespace
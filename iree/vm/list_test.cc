@@ -387,6 +387,146 @@ TEST_F(VMListTest, ResizeVariant) {
 
 // TODO(benvanik): test value conversion.
 
+// Tests bulk get/set of values in their native storage type.
+TEST_F(VMListTest, BulkValuesI32) {
+  iree_vm_type_def_t element_type =
+      iree_vm_type_def_make_value_type(IREE_VM_VALUE_TYPE_I32);
+  iree_vm_list_t* list = nullptr;
+  IREE_ASSERT_OK(
+      iree_vm_list_create(&element_type, 0, iree_allocator_system(), &list));
+
+  int32_t values[5] = {0, -1, 2, -3, 4};
+  IREE_ASSERT_OK(iree_vm_list_push_values(
+      list, IREE_VM_VALUE_TYPE_I32,
+      iree_make_const_byte_span(values, sizeof(values))));
+  EXPECT_EQ(5, iree_vm_list_size(list));
+
+  // Bulk read back a subrange.
+  int32_t read_values[3] = {0};
+  IREE_ASSERT_OK(iree_vm_list_get_values_as(
+      list, 1, IREE_VM_VALUE_TYPE_I32,
+      iree_make_byte_span(read_values, sizeof(read_values))));
+  EXPECT_EQ(-1, read_values[0]);
+  EXPECT_EQ(2, read_values[1]);
+  EXPECT_EQ(-3, read_values[2]);
+
+  // Bulk overwrite a subrange and check with the scalar API.
+  int32_t new_values[2] = {100, 200};
+  IREE_ASSERT_OK(iree_vm_list_set_values(
+      list, 3, IREE_VM_VALUE_TYPE_I32,
+      iree_make_const_byte_span(new_values, sizeof(new_values))));
+  iree_vm_value_t value;
+  IREE_ASSERT_OK(
+      iree_vm_list_get_value_as(list, 4, IREE_VM_VALUE_TYPE_I32, &value));
+  EXPECT_EQ(200, value.i32);
+
+  // Ranges must be in bounds.
+  EXPECT_THAT(Status(iree_vm_list_get_values_as(
+                  list, 4, IREE_VM_VALUE_TYPE_I32,
+                  iree_make_byte_span(read_values, sizeof(read_values)))),
+              StatusIs(iree::StatusCode::kOutOfRange));
+
+  // The storage view aliases the list contents.
+  iree_vm_value_type_t storage_type = IREE_VM_VALUE_TYPE_NONE;
+  iree_byte_span_t storage = iree_byte_span_empty();
+  IREE_ASSERT_OK(iree_vm_list_map_values(list, &storage_type, &storage));
+  EXPECT_EQ(IREE_VM_VALUE_TYPE_I32, storage_type);
+  EXPECT_EQ(5 * sizeof(int32_t), storage.data_length);
+  ((int32_t*)storage.data)[0] = 42;
+  IREE_ASSERT_OK(
+      iree_vm_list_get_value_as(list, 0, IREE_VM_VALUE_TYPE_I32, &value));
+  EXPECT_EQ(42, value.i32);
+
+  iree_vm_list_release(list);
+}
+
+// Tests bulk value conversion between storage and caller types.
+TEST_F(VMListTest, BulkValuesConversion) {
+  iree_vm_type_def_t element_type =
+      iree_vm_type_def_make_value_type(IREE_VM_VALUE_TYPE_I64);
+  iree_vm_list_t* list = nullptr;
+  IREE_ASSERT_OK(
+      iree_vm_list_create(&element_type, 0, iree_allocator_system(), &list));
+
+  // i8 -> i64 sign extends.
+  int8_t i8_values[4] = {-128, -1, 0, 127};
+  IREE_ASSERT_OK(iree_vm_list_push_values(
+      list, IREE_VM_VALUE_TYPE_I8,
+      iree_make_const_byte_span(i8_values, sizeof(i8_values))));
+  int64_t i64_values[4] = {0};
+  IREE_ASSERT_OK(iree_vm_list_get_values_as(
+      list, 0, IREE_VM_VALUE_TYPE_I64,
+      iree_make_byte_span(i64_values, sizeof(i64_values))));
+  EXPECT_EQ(-128, i64_values[0]);
+  EXPECT_EQ(-1, i64_values[1]);
+  EXPECT_EQ(0, i64_values[2]);
+  EXPECT_EQ(127, i64_values[3]);
+
+  // i64 -> i32 truncates.
+  int64_t wide_value = 0x100000002ll;
+  IREE_ASSERT_OK(iree_vm_list_set_values(
+      list, 0, IREE_VM_VALUE_TYPE_I64,
+      iree_make_const_byte_span(&wide_value, sizeof(wide_value))));
+  int32_t i32_value = 0;
+  IREE_ASSERT_OK(iree_vm_list_get_values_as(
+      list, 0, IREE_VM_VALUE_TYPE_I32,
+      iree_make_byte_span(&i32_value, sizeof(i32_value))));
+  EXPECT_EQ(2, i32_value);
+
+  // Integer <-> float conversion is not supported and leaves the list as-is.
+  float f32_values[2] = {1.0f, 2.0f};
+  EXPECT_THAT(Status(iree_vm_list_push_values(
+                  list, IREE_VM_VALUE_TYPE_F32,
+                  iree_make_const_byte_span(f32_values, sizeof(f32_values)))),
+              StatusIs(iree::StatusCode::kInvalidArgument));
+  EXPECT_EQ(4, iree_vm_list_size(list));
+
+  iree_vm_list_release(list);
+}
+
+// Tests bulk get/set on variant lists, which fall back to per-element access.
+TEST_F(VMListTest, BulkValuesVariant) {
+  iree_vm_list_t* list = nullptr;
+  IREE_ASSERT_OK(iree_vm_list_create(/*element_type=*/nullptr, 0,
+                                     iree_allocator_system(), &list));
+
+  float f32_values[3] = {0.5f, 1.5f, 2.5f};
+  IREE_ASSERT_OK(iree_vm_list_push_values(
+      list, IREE_VM_VALUE_TYPE_F32,
+      iree_make_const_byte_span(f32_values, sizeof(f32_values))));
+  EXPECT_EQ(3, iree_vm_list_size(list));
+
+  float read_values[3] = {0.0f};
+  IREE_ASSERT_OK(iree_vm_list_get_values_as(
+      list, 0, IREE_VM_VALUE_TYPE_F32,
+      iree_make_byte_span(read_values, sizeof(read_values))));
+  EXPECT_EQ(0.5f, read_values[0]);
+  EXPECT_EQ(1.5f, read_values[1]);
+  EXPECT_EQ(2.5f, read_values[2]);
+
+  // Conversions follow the same rules as value lists: f32 -> f64 widens and
+  // float -> integer fails instead of producing zeros.
+  double f64_values[3] = {0.0};
+  IREE_ASSERT_OK(iree_vm_list_get_values_as(
+      list, 0, IREE_VM_VALUE_TYPE_F64,
+      iree_make_byte_span(f64_values, sizeof(f64_values))));
+  EXPECT_EQ(0.5, f64_values[0]);
+  EXPECT_EQ(2.5, f64_values[2]);
+  int32_t i32_values[3] = {0};
+  EXPECT_THAT(Status(iree_vm_list_get_values_as(
+                  list, 0, IREE_VM_VALUE_TYPE_I32,
+                  iree_make_byte_span(i32_values, sizeof(i32_values)))),
+              StatusIs(iree::StatusCode::kInvalidArgument));
+
+  // Variants have no dense storage to map.
+  iree_vm_value_type_t storage_type = IREE_VM_VALUE_TYPE_NONE;
+  iree_byte_span_t storage = iree_byte_span_empty();
+  EXPECT_THAT(Status(iree_vm_list_map_values(list, &storage_type, &storage)),
+              StatusIs(iree::StatusCode::kFailedPrecondition));
+
+  iree_vm_list_release(list);
+}
+
 // TODO(benvanik): test ref get/set.
 
 // Tests pushing and popping ref objects.
@@ -174,7 +174,7 @@ IREE_API_EXPORT iree_status_t iree_vm_function_call_compute_cconv_fragment_size(
 IREE_API_EXPORT void iree_vm_function_call_release(
     iree_vm_function_call_t* call,
     const iree_vm_function_signature_t* signature) {
-  if (!call->arguments.data_length || !call->results.data_length) {
+  if (!call->arguments.data_length && !call->results.data_length) {
     return;
   }
   iree_string_view_t cconv = signature->calling_convention;
@@ -255,12 +255,11 @@ IREE_API_EXPORT void iree_vm_function_call_release(
 
 // Results of an iree_vm_module_execute request.
 typedef struct iree_vm_execution_result_t {
-  // TODO(benvanik): yield information.
-  // Yield modes:
-  // - yield (yield instruction)
-  // - await (with 1+ wait handles)
-  // - break
-  int reserved;
+  // Wait source the call is blocked on when it yields with
+  // IREE_STATUS_DEFERRED. Callers should wait on it before resuming the call.
+  // Immediate when execution yielded without blocking (such as with vm.yield)
+  // and can be resumed right away.
+  iree_wait_source_t wait_source;
 } iree_vm_execution_result_t;
 
 //===----------------------------------------------------------------------===//
@@ -396,14 +395,20 @@ typedef struct iree_vm_module_t {
 
   // Begins a function call with the given |call| arguments.
   // Execution may yield in the case of asynchronous code and require one or
-  // more calls to the resume method to complete.
+  // more calls to the resume method to complete. Yields are indicated by
+  // returning IREE_STATUS_DEFERRED with any frames required to continue
+  // execution left on |stack| and the wait source that must resolve before
+  // resuming in |out_result|.
   iree_status_t(IREE_API_PTR* begin_call)(
       void* self, iree_vm_stack_t* stack, const iree_vm_function_call_t* call,
       iree_vm_execution_result_t* out_result);
 
-  // Resumes execution of a previously-yielded call.
+  // Resumes execution of a previously-yielded |call|.
+  // |call| must be the same call passed to begin_call and its results buffer
+  // will be populated if the call completes. Returns IREE_STATUS_DEFERRED if
+  // execution yielded again.
   iree_status_t(IREE_API_PTR* resume_call)(
-      void* self, iree_vm_stack_t* stack,
+      void* self, iree_vm_stack_t* stack, const iree_vm_function_call_t* call,
       iree_vm_execution_result_t* out_result);
 
   // TODO(benvanik): move this/refactor.
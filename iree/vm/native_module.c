@@ -279,6 +279,60 @@ static iree_status_t IREE_API_PTR iree_vm_native_module_notify(
   return iree_ok_status();
 }
 
+// Annotates a failed |status| from the export |ordinal| of |module|.
+static iree_status_t iree_vm_native_module_annotate_call_status(
+    iree_vm_native_module_t* module, uint16_t ordinal, iree_status_t status) {
+#if IREE_STATUS_FEATURES & IREE_STATUS_FEATURE_ANNOTATIONS
+  iree_string_view_t module_name IREE_ATTRIBUTE_UNUSED =
+      iree_vm_native_module_name(module);
+  iree_string_view_t function_name IREE_ATTRIBUTE_UNUSED =
+      iree_string_view_empty();
+  iree_status_ignore(iree_vm_native_module_get_export_function(
+      module, ordinal, NULL, &function_name, NULL));
+  return iree_status_annotate_f(status,
+                                "while invoking native function %.*s.%.*s",
+                                (int)module_name.size, module_name.data,
+                                (int)function_name.size, function_name.data);
+#else
+  return status;
+#endif  // IREE_STATUS_FEATURES & IREE_STATUS_FEATURE_ANNOTATIONS
+}
+
+// Issues a call to |function_ptr| on |module| using the default call handling.
+// Shared by begin_call and resolved calls from other modules.
+static iree_status_t iree_vm_native_module_issue_call(
+    iree_vm_native_module_t* module,
+    const iree_vm_native_function_ptr_t* function_ptr, iree_vm_stack_t* stack,
+    const iree_vm_function_call_t* call,
+    iree_vm_execution_result_t* out_result) {
+  // NOTE: VM stack is currently unused. We could stash things here for the
+  // debugger or use it for coroutine state.
+  iree_host_size_t frame_size = 0;
+
+  iree_vm_stack_frame_t* callee_frame = NULL;
+  IREE_RETURN_IF_ERROR(iree_vm_stack_function_enter(
+      stack, &call->function, IREE_VM_STACK_FRAME_NATIVE, frame_size,
+      /*frame_cleanup_fn=*/NULL, &callee_frame));
+
+  // Call the target function using the shim. Functions that would block may
+  // populate the wait source in |out_result| before returning deferred.
+  memset(out_result, 0, sizeof(*out_result));
+  iree_vm_module_state_t* module_state = callee_frame->module_state;
+  iree_status_t status = function_ptr->shim(stack, call, function_ptr->target,
+                                            module, module_state, out_result);
+  if (IREE_UNLIKELY(iree_status_is_deferred(status))) {
+    // The function would have blocked. Native frames hold no state across
+    // yields and the call will be reissued from the start when resumed.
+    IREE_RETURN_IF_ERROR(iree_vm_stack_function_leave(stack));
+    return status;
+  } else if (IREE_UNLIKELY(!iree_status_is_ok(status))) {
+    return iree_vm_native_module_annotate_call_status(
+        module, call->function.ordinal, status);
+  }
+
+  return iree_vm_stack_function_leave(stack);
+}
+
 static iree_status_t IREE_API_PTR iree_vm_native_module_begin_call(
     void* self, iree_vm_stack_t* stack, const iree_vm_function_call_t* call,
     iree_vm_execution_result_t* out_result) {
@@ -296,51 +350,103 @@ static iree_status_t IREE_API_PTR iree_vm_native_module_begin_call(
     return module->user_interface.begin_call(module->self, stack, call,
                                              out_result);
   }
+  return iree_vm_native_module_issue_call(
+      module, &module->descriptor->functions[call->function.ordinal], stack,
+      call, out_result);
+}
 
-  // NOTE: VM stack is currently unused. We could stash things here for the
-  // debugger or use it for coroutine state.
-  iree_host_size_t frame_size = 0;
-
-  iree_vm_stack_frame_t* callee_frame = NULL;
-  IREE_RETURN_IF_ERROR(iree_vm_stack_function_enter(
-      stack, &call->function, IREE_VM_STACK_FRAME_NATIVE, frame_size,
-      /*frame_cleanup_fn=*/NULL, &callee_frame));
+static iree_status_t IREE_API_PTR iree_vm_native_module_resume_call(
+    void* self, iree_vm_stack_t* stack, const iree_vm_function_call_t* call,
+    iree_vm_execution_result_t* out_result) {
+  iree_vm_native_module_t* module = (iree_vm_native_module_t*)self;
+  if (module->user_interface.resume_call) {
+    return module->user_interface.resume_call(module->self, stack, call,
+                                              out_result);
+  } else if (module->user_interface.begin_call) {
+    return iree_make_status(IREE_STATUS_UNIMPLEMENTED,
+                            "native module does not support resume");
+  }
+  // Functions using the default call handling keep no state across yields and
+  // are resumed by reissuing the call.
+  return iree_vm_native_module_begin_call(self, stack, call, out_result);
+}
 
-  // Call the target function using the shim.
-  const iree_vm_native_function_ptr_t* function_ptr =
-      &module->descriptor->functions[call->function.ordinal];
-  iree_vm_module_state_t* module_state = callee_frame->module_state;
-  iree_status_t status = function_ptr->shim(stack, call, function_ptr->target,
-                                            module, module_state, out_result);
-  if (IREE_UNLIKELY(!iree_status_is_ok(status))) {
-#if IREE_STATUS_FEATURES & IREE_STATUS_FEATURE_ANNOTATIONS
-    iree_string_view_t module_name IREE_ATTRIBUTE_UNUSED =
-        iree_vm_native_module_name(module);
-    iree_string_view_t function_name IREE_ATTRIBUTE_UNUSED =
-        iree_string_view_empty();
-    iree_status_ignore(iree_vm_native_module_get_export_function(
-        module, call->function.ordinal, NULL, &function_name, NULL));
-    return iree_status_annotate_f(status,
-                                  "while invoking native function %.*s.%.*s",
-                                  (int)module_name.size, module_name.data,
-                                  (int)function_name.size, function_name.data);
-#else
-    return status;
-#endif  // IREE_STATUS_FEATURES & IREE_STATUS_FEATURE_ANNOTATIONS
+IREE_API_EXPORT bool iree_vm_native_module_resolve_export(
+    const iree_vm_function_t* function,
+    iree_vm_native_function_ptr_t* out_function_ptr) {
+  IREE_ASSERT_ARGUMENT(function);
+  IREE_ASSERT_ARGUMENT(out_function_ptr);
+  memset(out_function_ptr, 0, sizeof(*out_function_ptr));
+
+  // Only modules routing through our default begin_call have a function
+  // pointer table we can call into. Modules providing their own begin_call
+  // may do arbitrary work per call and must go through the interface.
+  if (!function->module ||
+      function->module->begin_call != iree_vm_native_module_begin_call) {
+    return false;
+  }
+  iree_vm_native_module_t* module =
+      (iree_vm_native_module_t*)function->module->self;
+  if (module->user_interface.begin_call ||
+      function->linkage != IREE_VM_FUNCTION_LINKAGE_EXPORT ||
+      function->ordinal >= module->descriptor->function_count) {
+    return false;
   }
 
-  return iree_vm_stack_function_leave(stack);
+  *out_function_ptr = module->descriptor->functions[function->ordinal];
+  return true;
 }
 
-static iree_status_t IREE_API_PTR
-iree_vm_native_module_resume_call(void* self, iree_vm_stack_t* stack,
-                                  iree_vm_execution_result_t* out_result) {
-  iree_vm_native_module_t* module = (iree_vm_native_module_t*)self;
-  if (module->user_interface.resume_call) {
-    return module->user_interface.resume_call(module->self, stack, out_result);
+IREE_API_EXPORT iree_status_t iree_vm_native_module_issue_resolved_call(
+    const iree_vm_native_function_ptr_t* function_ptr, iree_vm_stack_t* stack,
+    const iree_vm_function_call_t* call,
+    iree_vm_execution_result_t* out_result) {
+  return iree_vm_native_module_issue_call(
+      (iree_vm_native_module_t*)call->function.module->self, function_ptr,
+      stack, call, out_result);
+}
+
+IREE_API_EXPORT bool iree_vm_native_module_resolve_register_export(
+    const iree_vm_function_t* function,
+    iree_vm_native_register_function_t* out_register_function) {
+  IREE_ASSERT_ARGUMENT(function);
+  IREE_ASSERT_ARGUMENT(out_register_function);
+  *out_register_function = NULL;
+  iree_vm_native_function_ptr_t function_ptr;
+  if (!iree_vm_native_module_resolve_export(function, &function_ptr)) {
+    return false;
   }
-  return iree_make_status(IREE_STATUS_UNIMPLEMENTED,
-                          "native module does not support resume");
+  iree_vm_native_module_t* module =
+      (iree_vm_native_module_t*)function->module->self;
+  if (!module->descriptor->register_functions) return false;
+  *out_register_function =
+      module->descriptor->register_functions[function->ordinal];
+  return *out_register_function != NULL;
+}
+
+IREE_API_EXPORT iree_status_t iree_vm_native_module_issue_register_call(
+    const iree_vm_function_t* function,
+    iree_vm_native_register_function_t register_function,
+    iree_vm_stack_t* stack, const iree_vm_register_call_t* call,
+    iree_vm_execution_result_t* out_result) {
+  iree_vm_native_module_t* module =
+      (iree_vm_native_module_t*)function->module->self;
+
+  // No native frame is entered: the register banks in |call| live in the
+  // caller frame storage and entering a frame may grow (and move) the stack.
+  iree_vm_module_state_t* module_state = NULL;
+  IREE_RETURN_IF_ERROR(iree_vm_stack_query_module_state(
+      stack, function->module, &module_state));
+
+  memset(out_result, 0, sizeof(*out_result));
+  iree_status_t status =
+      register_function(stack, module, module_state, call, out_result);
+  if (IREE_UNLIKELY(!iree_status_is_ok(status) &&
+                    !iree_status_is_deferred(status))) {
+    return iree_vm_native_module_annotate_call_status(
+        module, function->ordinal, status);
+  }
+  return status;
 }
 
 IREE_API_EXPORT iree_status_t iree_vm_native_module_create(
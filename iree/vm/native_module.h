@@ -58,6 +58,61 @@ typedef struct iree_vm_native_function_ptr_t {
   iree_vm_native_function_target_t target;
 } iree_vm_native_function_ptr_t;
 
+// A call that reads its arguments directly from the caller register file and
+// writes its results directly back into it. Unlike iree_vm_function_call_t no
+// argument or result buffers are populated: callers pass their register banks
+// and the register ordinals of each argument and result.
+//
+// |arguments| lists one register per flattened argument in calling convention
+// order with variadic spans expanded. |segment_sizes| has the element count of
+// each top-level argument when the call is variadic and is NULL otherwise.
+// Ref arguments are borrowed from the caller for the duration of the call.
+typedef struct iree_vm_register_call_t {
+  uint16_t i32_mask;
+  int32_t* i32;
+  uint16_t ref_mask;
+  iree_vm_ref_t* ref;
+  const iree_vm_register_list_t* segment_sizes;
+  const iree_vm_register_list_t* arguments;
+  const iree_vm_register_list_t* results;
+} iree_vm_register_call_t;
+
+// Returns the i32 value of flattened argument |i|.
+static inline int32_t iree_vm_register_call_arg_i32(
+    const iree_vm_register_call_t* call, iree_host_size_t i) {
+  return call->i32[call->arguments->registers[i] & call->i32_mask];
+}
+
+// Returns the ref of flattened argument |i| as borrowed from the caller.
+static inline iree_vm_ref_t* iree_vm_register_call_arg_ref(
+    const iree_vm_register_call_t* call, iree_host_size_t i) {
+  return &call->ref[call->arguments->registers[i] & call->ref_mask];
+}
+
+// Returns the element count of the variadic top-level argument |segment|.
+static inline iree_host_size_t iree_vm_register_call_segment_size(
+    const iree_vm_register_call_t* call, iree_host_size_t segment) {
+  return call->segment_sizes ? call->segment_sizes->registers[segment] : 0;
+}
+
+// Stores |value| into the register of result |i|.
+static inline void iree_vm_register_call_set_i32(
+    const iree_vm_register_call_t* call, iree_host_size_t i, int32_t value) {
+  call->i32[call->results->registers[i] & call->i32_mask] = value;
+}
+
+// Calls a native function with arguments and results in caller registers.
+// Implementations are written per signature and read their operands directly
+// instead of going through the packed ABI shims. Functions that would block
+// may populate the wait source in |out_result| and return deferred as with
+// regular native functions. No stack frame is entered for the call and the
+// implementation must not push frames onto |stack| as doing so may move the
+// caller registers.
+typedef iree_status_t(IREE_API_PTR* iree_vm_native_register_function_t)(
+    iree_vm_stack_t* stack, void* module, void* module_state,
+    const iree_vm_register_call_t* call,
+    iree_vm_execution_result_t* out_result);
+
 // Describes a native module implementation by way of descriptor tables.
 // All of this information is assumed read-only and will be referenced for the
 // lifetime of any module created with the descriptor.
@@ -93,6 +148,13 @@ typedef struct iree_vm_native_module_descriptor_t {
   // An optional list of module-level reflection attributes.
   iree_host_size_t reflection_attr_count;
   const iree_vm_reflection_attr_t* reflection_attrs;
+
+  // Optional register-level implementations of exported functions.
+  // When provided this must have function_count entries matching 1:1 with
+  // |functions|; NULL entries fall back to the packed ABI shims. Callers with
+  // register files (such as bytecode modules) can call these directly via
+  // iree_vm_native_module_resolve_register_export.
+  const iree_vm_native_register_function_t* register_functions;
 } iree_vm_native_module_descriptor_t;
 
 // Returns the size, in bytes, of the allocation required for native modules.
@@ -121,6 +183,43 @@ IREE_API_EXPORT iree_status_t iree_vm_native_module_initialize(
     const iree_vm_native_module_descriptor_t* module_descriptor,
     iree_allocator_t allocator, iree_vm_module_t* module);
 
+// Resolves |function| to the shim and target pointers that the default
+// begin_call implementation would invoke for it.
+// Returns true if |function| is an export of a native module that does not
+// override begin_call; the call can then be issued with
+// iree_vm_native_module_issue_resolved_call and bypass the module interface.
+// Returns false if calls must go through the module begin_call.
+IREE_API_EXPORT bool iree_vm_native_module_resolve_export(
+    const iree_vm_function_t* function,
+    iree_vm_native_function_ptr_t* out_function_ptr);
+
+// Issues |call| through a |function_ptr| previously resolved for
+// |call->function| with iree_vm_native_module_resolve_export.
+// This uses the same packed iree_vm_function_call_t argument/result ABI as
+// begin_call and only skips the module interface dispatch, the per-call
+// ordinal validation and the function table lookup.
+IREE_API_EXPORT iree_status_t iree_vm_native_module_issue_resolved_call(
+    const iree_vm_native_function_ptr_t* function_ptr, iree_vm_stack_t* stack,
+    const iree_vm_function_call_t* call,
+    iree_vm_execution_result_t* out_result);
+
+// Resolves |function| to the register-level implementation provided by its
+// native module, if any.
+// Returns false if |function| is not resolvable with
+// iree_vm_native_module_resolve_export or has no register implementation.
+IREE_API_EXPORT bool iree_vm_native_module_resolve_register_export(
+    const iree_vm_function_t* function,
+    iree_vm_native_register_function_t* out_register_function);
+
+// Issues |call| to |function| through a |register_function| previously
+// resolved with iree_vm_native_module_resolve_register_export.
+// Results are written to the caller registers in |call| on success.
+IREE_API_EXPORT iree_status_t iree_vm_native_module_issue_register_call(
+    const iree_vm_function_t* function,
+    iree_vm_native_register_function_t register_function,
+    iree_vm_stack_t* stack, const iree_vm_register_call_t* call,
+    iree_vm_execution_result_t* out_result);
+
 #ifdef __cplusplus
 }  // extern "C"
 #endif  // __cplusplus
@@ -6,6 +6,7 @@
 
 #include "iree/vm/native_module_test.h"
 
+#include <cstring>
 #include <vector>
 
 #include "iree/base/status_cc.h"
@@ -89,7 +90,7 @@ class VMNativeModuleTest : public ::testing::Test {
     return ret0_value.i32;
   }
 
- private:
+ protected:
   iree_vm_instance_t* instance_ = nullptr;
   iree_vm_context_t* context_ = nullptr;
 };
@@ -106,5 +107,81 @@ TEST_F(VMNativeModuleTest, Example) {
   ASSERT_EQ(v2, 8);
 }
 
+TEST_F(VMNativeModuleTest, ResolveExport) {
+  // module_a uses the default begin_call and can be resolved.
+  iree_vm_function_t function;
+  IREE_ASSERT_OK(iree_vm_context_resolve_function(
+      context_, iree_make_cstring_view("module_a.add_1"), &function));
+  iree_vm_native_function_ptr_t function_ptr;
+  ASSERT_TRUE(iree_vm_native_module_resolve_export(&function, &function_ptr));
+  EXPECT_EQ(function_ptr.shim, module_a_funcs_[0].shim);
+  EXPECT_EQ(function_ptr.target, module_a_funcs_[0].target);
+
+  // Calling through the resolved pointer must match begin_call.
+  iree_vm_function_call_t call;
+  memset(&call, 0, sizeof(call));
+  call.function = function;
+  int32_t arg0 = 41;
+  int32_t ret0 = 0;
+  call.arguments = iree_make_byte_span(&arg0, sizeof(arg0));
+  call.results = iree_make_byte_span(&ret0, sizeof(ret0));
+  IREE_VM_INLINE_STACK_INITIALIZE(stack, IREE_VM_INVOCATION_FLAG_NONE,
+                                  iree_vm_context_state_resolver(context_),
+                                  iree_allocator_system());
+  iree_vm_execution_result_t result;
+  IREE_ASSERT_OK(iree_vm_native_module_issue_resolved_call(
+      &function_ptr, stack, &call, &result));
+  iree_vm_stack_deinitialize(stack);
+  EXPECT_EQ(ret0, 42);
+}
+
+TEST_F(VMNativeModuleTest, ResolveRegisterExport) {
+  // add_1 provides a register-level implementation while sub_1 does not.
+  iree_vm_function_t sub_1;
+  IREE_ASSERT_OK(iree_vm_context_resolve_function(
+      context_, iree_make_cstring_view("module_a.sub_1"), &sub_1));
+  iree_vm_native_register_function_t register_function = NULL;
+  EXPECT_FALSE(iree_vm_native_module_resolve_register_export(
+      &sub_1, &register_function));
+  EXPECT_EQ(register_function, nullptr);
+  iree_vm_function_t add_1;
+  IREE_ASSERT_OK(iree_vm_context_resolve_function(
+      context_, iree_make_cstring_view("module_a.add_1"), &add_1));
+  ASSERT_TRUE(iree_vm_native_module_resolve_register_export(
+      &add_1, &register_function));
+
+  // Arguments are read from and results written to the register banks.
+  int32_t i32_registers[4] = {0, 0, 41, 0};
+  struct {
+    uint16_t size;
+    uint16_t registers[1];
+  } src_reg_list = {1, {2}}, dst_reg_list = {1, {1}};
+  iree_vm_register_call_t call;
+  memset(&call, 0, sizeof(call));
+  call.i32_mask = 3;
+  call.i32 = i32_registers;
+  call.arguments = (const iree_vm_register_list_t*)&src_reg_list;
+  call.results = (const iree_vm_register_list_t*)&dst_reg_list;
+  IREE_VM_INLINE_STACK_INITIALIZE(stack, IREE_VM_INVOCATION_FLAG_NONE,
+                                  iree_vm_context_state_resolver(context_),
+                                  iree_allocator_system());
+  iree_vm_execution_result_t result;
+  IREE_ASSERT_OK(iree_vm_native_module_issue_register_call(
+      &add_1, register_function, stack, &call, &result));
+  iree_vm_stack_deinitialize(stack);
+  EXPECT_EQ(i32_registers[1], 42);
+  EXPECT_EQ(i32_registers[2], 41);
+}
+
+TEST_F(VMNativeModuleTest, ResolveExportNonNative) {
+  // Functions without a native module (or from non-native modules) must be
+  // called through the module interface.
+  iree_vm_function_t function;
+  memset(&function, 0, sizeof(function));
+  iree_vm_native_function_ptr_t function_ptr;
+  EXPECT_FALSE(iree_vm_native_module_resolve_export(&function, &function_ptr));
+  EXPECT_EQ(function_ptr.shim, nullptr);
+}
+
 }  // namespace
 }  // namespace iree
@@ -97,6 +97,21 @@ static iree_status_t module_a_sub_1(iree_vm_stack_t* stack, module_a_t* module,
   return iree_ok_status();
 }
 
+// Register-level variant of add_1 that bytecode callers can invoke directly
+// with their register file, avoiding argument/result marshaling.
+static iree_status_t module_a_add_1_registers(
+    iree_vm_stack_t* stack, module_a_t* module, module_a_state_t* module_state,
+    const iree_vm_register_call_t* call,
+    iree_vm_execution_result_t* out_result) {
+  if (call->arguments->size != 1 || call->results->size != 1) {
+    return iree_make_status(IREE_STATUS_INVALID_ARGUMENT,
+                            "argument/result signature mismatch");
+  }
+  iree_vm_register_call_set_i32(call, 0,
+                                iree_vm_register_call_arg_i32(call, 0) + 1);
+  return iree_ok_status();
+}
+
 static const iree_vm_native_export_descriptor_t module_a_exports_[] = {
     {iree_make_cstring_view("add_1"), iree_make_cstring_view("0i_i"), 0, NULL},
     {iree_make_cstring_view("sub_1"), iree_make_cstring_view("0i_i"), 0, NULL},
@@ -110,6 +125,11 @@ static const iree_vm_native_function_ptr_t module_a_funcs_[] = {
 static_assert(IREE_ARRAYSIZE(module_a_funcs_) ==
                   IREE_ARRAYSIZE(module_a_exports_),
               "function pointer table must be 1:1 with exports");
+// sub_1 has no register-level variant and is called through its shim.
+static const iree_vm_native_register_function_t module_a_register_funcs_[] = {
+    (iree_vm_native_register_function_t)module_a_add_1_registers,
+    NULL,
+};
 static const iree_vm_native_module_descriptor_t module_a_descriptor_ = {
     iree_make_cstring_view("module_a"),
     0,
@@ -120,6 +140,7 @@ static const iree_vm_native_module_descriptor_t module_a_descriptor_ = {
     module_a_funcs_,
     0,
     NULL,
+    module_a_register_funcs_,
 };
 
 static iree_status_t module_a_create(iree_allocator_t allocator,
@@ -11,6 +11,7 @@
 #include <stdint.h>
 
 #include "iree/base/api.h"
+#include "iree/vm/buffer.h"
 #include "iree/vm/value.h"
 
 //===------------------------------------------------------------------===//
@@ -36,6 +37,20 @@ static inline int32_t vm_select_i32(int32_t condition, int32_t true_value,
                                     int32_t false_value) {
   return condition ? true_value : false_value;
 }
+static inline void vm_select_ref(int32_t condition, iree_vm_ref_t* true_value,
+                                 iree_vm_ref_t* false_value,
+                                 iree_vm_ref_t* out_result) {
+  iree_vm_ref_retain(condition ? true_value : false_value, out_result);
+}
+// Returns |value| if |index| selects |case_index| and |current| otherwise.
+// vm.switch.ref chains one call per case and retains the final ref once so
+// that a result aliasing one of the case values is never overwritten early.
+static inline iree_vm_ref_t* vm_switch_ref_case(int32_t index,
+                                                int32_t case_index,
+                                                iree_vm_ref_t* value,
+                                                iree_vm_ref_t* current) {
+  return index == case_index ? value : current;
+}
 
 //===------------------------------------------------------------------===//
 // Native integer arithmetic
@@ -135,6 +150,189 @@ static inline int32_t vm_cmp_nz_ref(iree_vm_ref_t* operand) {
   return (operand->ptr != NULL) ? 1 : 0;
 }
 
+//===------------------------------------------------------------------===//
+// Buffers
+//===------------------------------------------------------------------===//
+// These take the buffer operands as refs and match the semantics of the
+// handlers in bytecode_dispatch.c so that targets lowering ops to calls (such
+// as the C target) don't need to emit the deref/null-check/element access
+// sequences inline.
+
+static inline iree_status_t vm_buffer_deref_checked(
+    iree_vm_ref_t* buffer_ref, iree_vm_buffer_t** out_buffer) {
+  *out_buffer = iree_vm_buffer_deref(*buffer_ref);
+  if (IREE_UNLIKELY(!*out_buffer)) {
+    return iree_make_status(IREE_STATUS_INVALID_ARGUMENT, "buffer is null");
+  }
+  return iree_ok_status();
+}
+
+static inline iree_status_t vm_buffer_alloc(int32_t length,
+                                            iree_allocator_t allocator,
+                                            iree_vm_ref_t* out_result) {
+  iree_vm_buffer_t* buffer = NULL;
+  IREE_RETURN_IF_ERROR(iree_vm_buffer_create(
+      IREE_VM_BUFFER_ACCESS_MUTABLE | IREE_VM_BUFFER_ACCESS_ORIGIN_GUEST,
+      (uint32_t)length, allocator, &buffer));
+  return iree_vm_ref_wrap_assign(buffer, iree_vm_buffer_type_id(), out_result);
+}
+static inline iree_status_t vm_buffer_clone(iree_vm_ref_t* source_ref,
+                                            int32_t offset, int32_t length,
+                                            iree_allocator_t allocator,
+                                            iree_vm_ref_t* out_result) {
+  iree_vm_buffer_t* source = NULL;
+  IREE_RETURN_IF_ERROR(vm_buffer_deref_checked(source_ref, &source));
+  iree_vm_buffer_t* result = NULL;
+  IREE_RETURN_IF_ERROR(iree_vm_buffer_clone(
+      IREE_VM_BUFFER_ACCESS_MUTABLE | IREE_VM_BUFFER_ACCESS_ORIGIN_GUEST,
+      source, (uint32_t)offset, (uint32_t)length, allocator, &result));
+  return iree_vm_ref_wrap_assign(result, iree_vm_buffer_type_id(), out_result);
+}
+static inline iree_status_t vm_buffer_length(iree_vm_ref_t* buffer_ref,
+                                             int32_t* out_result) {
+  iree_vm_buffer_t* buffer = NULL;
+  IREE_RETURN_IF_ERROR(vm_buffer_deref_checked(buffer_ref, &buffer));
+  *out_result = (int32_t)iree_vm_buffer_length(buffer);
+  return iree_ok_status();
+}
+static inline iree_status_t vm_buffer_copy(iree_vm_ref_t* source_ref,
+                                           int32_t source_offset,
+                                           iree_vm_ref_t* target_ref,
+                                           int32_t target_offset,
+                                           int32_t length) {
+  iree_vm_buffer_t* source = NULL;
+  IREE_RETURN_IF_ERROR(vm_buffer_deref_checked(source_ref, &source));
+  iree_vm_buffer_t* target = NULL;
+  IREE_RETURN_IF_ERROR(vm_buffer_deref_checked(target_ref, &target));
+  return iree_vm_buffer_copy_bytes(source, (uint32_t)source_offset, target,
+                                   (uint32_t)target_offset, (uint32_t)length);
+}
+static inline iree_status_t vm_buffer_compare(iree_vm_ref_t* lhs_ref,
+                                              int32_t lhs_offset,
+                                              iree_vm_ref_t* rhs_ref,
+                                              int32_t rhs_offset,
+                                              int32_t length,
+                                              int32_t* out_result) {
+  iree_vm_buffer_t* lhs = NULL;
+  IREE_RETURN_IF_ERROR(vm_buffer_deref_checked(lhs_ref, &lhs));
+  iree_vm_buffer_t* rhs = NULL;
+  IREE_RETURN_IF_ERROR(vm_buffer_deref_checked(rhs_ref, &rhs));
+  bool result = false;
+  IREE_RETURN_IF_ERROR(iree_vm_buffer_compare_bytes(
+      lhs, (uint32_t)lhs_offset, rhs, (uint32_t)rhs_offset, (uint32_t)length,
+      &result));
+  *out_result = result ? 1 : 0;
+  return iree_ok_status();
+}
+
+static inline iree_status_t vm_buffer_fill_i8(iree_vm_ref_t* buffer_ref,
+                                              int32_t offset, int32_t length,
+                                              int32_t value) {
+  iree_vm_buffer_t* buffer = NULL;
+  IREE_RETURN_IF_ERROR(vm_buffer_deref_checked(buffer_ref, &buffer));
+  uint8_t element = (uint8_t)value;
+  return iree_vm_buffer_fill_elements(buffer, (uint32_t)offset,
+                                      (uint32_t)length / sizeof(uint8_t),
+                                      sizeof(uint8_t), &element);
+}
+static inline iree_status_t vm_buffer_fill_i16(iree_vm_ref_t* buffer_ref,
+                                               int32_t offset, int32_t length,
+                                               int32_t value) {
+  iree_vm_buffer_t* buffer = NULL;
+  IREE_RETURN_IF_ERROR(vm_buffer_deref_checked(buffer_ref, &buffer));
+  uint16_t element = (uint16_t)value;
+  return iree_vm_buffer_fill_elements(buffer, (uint32_t)offset,
+                                      (uint32_t)length / sizeof(uint16_t),
+                                      sizeof(uint16_t), &element);
+}
+static inline iree_status_t vm_buffer_fill_i32(iree_vm_ref_t* buffer_ref,
+                                               int32_t offset, int32_t length,
+                                               int32_t value) {
+  iree_vm_buffer_t* buffer = NULL;
+  IREE_RETURN_IF_ERROR(vm_buffer_deref_checked(buffer_ref, &buffer));
+  uint32_t element = (uint32_t)value;
+  return iree_vm_buffer_fill_elements(buffer, (uint32_t)offset,
+                                      (uint32_t)length / sizeof(uint32_t),
+                                      sizeof(uint32_t), &element);
+}
+
+static inline iree_status_t vm_buffer_load_i8u(iree_vm_ref_t* buffer_ref,
+                                               int32_t offset,
+                                               int32_t* out_result) {
+  iree_vm_buffer_t* buffer = NULL;
+  IREE_RETURN_IF_ERROR(vm_buffer_deref_checked(buffer_ref, &buffer));
+  uint8_t result = 0;
+  IREE_RETURN_IF_ERROR(iree_vm_buffer_read_elements(
+      buffer, (uint32_t)offset, &result, 1, sizeof(result)));
+  *out_result = vm_ext_i8i32u(result);
+  return iree_ok_status();
+}
+static inline iree_status_t vm_buffer_load_i8s(iree_vm_ref_t* buffer_ref,
+                                               int32_t offset,
+                                               int32_t* out_result) {
+  iree_vm_buffer_t* buffer = NULL;
+  IREE_RETURN_IF_ERROR(vm_buffer_deref_checked(buffer_ref, &buffer));
+  int8_t result = 0;
+  IREE_RETURN_IF_ERROR(iree_vm_buffer_read_elements(
+      buffer, (uint32_t)offset, &result, 1, sizeof(result)));
+  *out_result = vm_ext_i8i32s(result);
+  return iree_ok_status();
+}
+static inline iree_status_t vm_buffer_load_i16u(iree_vm_ref_t* buffer_ref,
+                                                int32_t offset,
+                                                int32_t* out_result) {
+  iree_vm_buffer_t* buffer = NULL;
+  IREE_RETURN_IF_ERROR(vm_buffer_deref_checked(buffer_ref, &buffer));
+  uint16_t result = 0;
+  IREE_RETURN_IF_ERROR(iree_vm_buffer_read_elements(
+      buffer, (uint32_t)offset, &result, 1, sizeof(result)));
+  *out_result = vm_ext_i16i32u(result);
+  return iree_ok_status();
+}
+static inline iree_status_t vm_buffer_load_i16s(iree_vm_ref_t* buffer_ref,
+                                                int32_t offset,
+                                                int32_t* out_result) {
+  iree_vm_buffer_t* buffer = NULL;
+  IREE_RETURN_IF_ERROR(vm_buffer_deref_checked(buffer_ref, &buffer));
+  int16_t result = 0;
+  IREE_RETURN_IF_ERROR(iree_vm_buffer_read_elements(
+      buffer, (uint32_t)offset, &result, 1, sizeof(result)));
+  *out_result = vm_ext_i16i32s(result);
+  return iree_ok_status();
+}
+static inline iree_status_t vm_buffer_load_i32(iree_vm_ref_t* buffer_ref,
+                                               int32_t offset,
+                                               int32_t* out_result) {
+  iree_vm_buffer_t* buffer = NULL;
+  IREE_RETURN_IF_ERROR(vm_buffer_deref_checked(buffer_ref, &buffer));
+  return iree_vm_buffer_read_elements(buffer, (uint32_t)offset, out_result, 1,
+                                      sizeof(*out_result));
+}
+
+static inline iree_status_t vm_buffer_store_i8(iree_vm_ref_t* buffer_ref,
+                                               int32_t offset, int32_t value) {
+  iree_vm_buffer_t* buffer = NULL;
+  IREE_RETURN_IF_ERROR(vm_buffer_deref_checked(buffer_ref, &buffer));
+  uint8_t element = (uint8_t)value;
+  return iree_vm_buffer_write_elements(&element, buffer, (uint32_t)offset, 1,
+                                       sizeof(element));
+}
+static inline iree_status_t vm_buffer_store_i16(iree_vm_ref_t* buffer_ref,
+                                                int32_t offset, int32_t value) {
+  iree_vm_buffer_t* buffer = NULL;
+  IREE_RETURN_IF_ERROR(vm_buffer_deref_checked(buffer_ref, &buffer));
+  uint16_t element = (uint16_t)value;
+  return iree_vm_buffer_write_elements(&element, buffer, (uint32_t)offset, 1,
+                                       sizeof(element));
+}
+static inline iree_status_t vm_buffer_store_i32(iree_vm_ref_t* buffer_ref,
+                                                int32_t offset, int32_t value) {
+  iree_vm_buffer_t* buffer = NULL;
+  IREE_RETURN_IF_ERROR(vm_buffer_deref_checked(buffer_ref, &buffer));
+  return iree_vm_buffer_write_elements(&value, buffer, (uint32_t)offset, 1,
+                                       sizeof(value));
+}
+
 //===------------------------------------------------------------------===//
 // ExtI64: Globals
 //===------------------------------------------------------------------===//
@@ -198,9 +396,27 @@ static inline int32_t vm_trunc_i64i32(int64_t operand) {
 static inline int64_t vm_ext_i32i64s(int32_t operand) {
   return (int64_t)((int32_t)operand);
 }
+static inline int32_t vm_trunc_i64i8(int64_t operand) {
+  return (uint8_t)((uint64_t)operand);
+}
+static inline int32_t vm_trunc_i64i16(int64_t operand) {
+  return (uint16_t)((uint64_t)operand);
+}
 static inline int64_t vm_ext_i32i64u(int32_t operand) {
   return (uint64_t)((uint32_t)operand);
 }
+static inline int64_t vm_ext_i8i64s(int32_t operand) {
+  return (int64_t)((int8_t)operand);
+}
+static inline int64_t vm_ext_i8i64u(int32_t operand) {
+  return (uint64_t)((uint8_t)operand);
+}
+static inline int64_t vm_ext_i16i64s(int32_t operand) {
+  return (int64_t)((int16_t)operand);
+}
+static inline int64_t vm_ext_i16i64u(int32_t operand) {
+  return (uint64_t)((uint16_t)operand);
+}
 
 //===------------------------------------------------------------------===//
 // ExtI64: Native bitwise shifts and rotates
@@ -239,6 +455,35 @@ static inline int32_t vm_cmp_nz_i64(int64_t operand) {
   return (operand != 0) ? 1 : 0;
 }
 
+//===------------------------------------------------------------------===//
+// ExtI64: Buffers
+//===------------------------------------------------------------------===//
+
+static inline iree_status_t vm_buffer_fill_i64(iree_vm_ref_t* buffer_ref,
+                                               int32_t offset, int32_t length,
+                                               int64_t value) {
+  iree_vm_buffer_t* buffer = NULL;
+  IREE_RETURN_IF_ERROR(vm_buffer_deref_checked(buffer_ref, &buffer));
+  return iree_vm_buffer_fill_elements(buffer, (uint32_t)offset,
+                                      (uint32_t)length / sizeof(int64_t),
+                                      sizeof(int64_t), &value);
+}
+static inline iree_status_t vm_buffer_load_i64(iree_vm_ref_t* buffer_ref,
+                                               int32_t offset,
+                                               int64_t* out_result) {
+  iree_vm_buffer_t* buffer = NULL;
+  IREE_RETURN_IF_ERROR(vm_buffer_deref_checked(buffer_ref, &buffer));
+  return iree_vm_buffer_read_elements(buffer, (uint32_t)offset, out_result, 1,
+                                      sizeof(*out_result));
+}
+static inline iree_status_t vm_buffer_store_i64(iree_vm_ref_t* buffer_ref,
+                                                int32_t offset, int64_t value) {
+  iree_vm_buffer_t* buffer = NULL;
+  IREE_RETURN_IF_ERROR(vm_buffer_deref_checked(buffer_ref, &buffer));
+  return iree_vm_buffer_write_elements(&value, buffer, (uint32_t)offset, 1,
+                                       sizeof(value));
+}
+
 //===------------------------------------------------------------------===//
 // ExtF32: Globals
 //===------------------------------------------------------------------===//
@@ -362,4 +607,177 @@ static inline int32_t vm_cmp_nan_f32(float operand) {
   return isnan(operand) ? 1 : 0;
 }
 
+//===------------------------------------------------------------------===//
+// ExtF32: Buffers
+//===------------------------------------------------------------------===//
+
+static inline iree_status_t vm_buffer_fill_f32(iree_vm_ref_t* buffer_ref,
+                                               int32_t offset, int32_t length,
+                                               float value) {
+  iree_vm_buffer_t* buffer = NULL;
+  IREE_RETURN_IF_ERROR(vm_buffer_deref_checked(buffer_ref, &buffer));
+  return iree_vm_buffer_fill_elements(buffer, (uint32_t)offset,
+                                      (uint32_t)length / sizeof(float),
+                                      sizeof(float), &value);
+}
+static inline iree_status_t vm_buffer_load_f32(iree_vm_ref_t* buffer_ref,
+                                               int32_t offset,
+                                               float* out_result) {
+  iree_vm_buffer_t* buffer = NULL;
+  IREE_RETURN_IF_ERROR(vm_buffer_deref_checked(buffer_ref, &buffer));
+  return iree_vm_buffer_read_elements(buffer, (uint32_t)offset, out_result, 1,
+                                      sizeof(*out_result));
+}
+static inline iree_status_t vm_buffer_store_f32(iree_vm_ref_t* buffer_ref,
+                                                int32_t offset, float value) {
+  iree_vm_buffer_t* buffer = NULL;
+  IREE_RETURN_IF_ERROR(vm_buffer_deref_checked(buffer_ref, &buffer));
+  return iree_vm_buffer_write_elements(&value, buffer, (uint32_t)offset, 1,
+                                       sizeof(value));
+}
+
+//===------------------------------------------------------------------===//
+// ExtF64: Globals
+//===------------------------------------------------------------------===//
+
+static inline double vm_global_load_f64(uint8_t* base, uint32_t byte_offset) {
+  const double* global_ptr = (const double*)(base + byte_offset);
+  return *global_ptr;
+}
+
+static inline void vm_global_store_f64(uint8_t* base, uint32_t byte_offset,
+                                       double value) {
+  double* global_ptr = (double*)(base + byte_offset);
+  *global_ptr = value;
+}
+
+//===------------------------------------------------------------------===//
+// ExtF64: Conditional assignment
+//===------------------------------------------------------------------===//
+
+static inline double vm_select_f64(int32_t condition, double true_value,
+                                   double false_value) {
+  return condition ? true_value : false_value;
+}
+
+//===------------------------------------------------------------------===//
+// ExtF64: Native floating-point arithmetic
+//===------------------------------------------------------------------===//
+
+static inline double vm_add_f64(double lhs, double rhs) { return lhs + rhs; }
+static inline double vm_sub_f64(double lhs, double rhs) { return lhs - rhs; }
+static inline double vm_mul_f64(double lhs, double rhs) { return lhs * rhs; }
+static inline double vm_div_f64(double lhs, double rhs) { return lhs / rhs; }
+static inline double vm_rem_f64(double lhs, double rhs) {
+  return remainder(lhs, rhs);
+}
+static inline double vm_fma_f64(double a, double b, double c) {
+#ifdef FP_FAST_FMA
+  return fma(a, b, c);
+#else
+  return a * b + c;
+#endif  // FP_FAST_FMA
+}
+static inline double vm_abs_f64(double operand) { return fabs(operand); }
+static inline double vm_neg_f64(double operand) { return -operand; }
+static inline double vm_ceil_f64(double operand) { return ceil(operand); }
+static inline double vm_floor_f64(double operand) { return floor(operand); }
+
+static inline double vm_atan_f64(double operand) { return atan(operand); }
+static inline double vm_atan2_f64(double y, double x) { return atan2(y, x); }
+static inline double vm_cos_f64(double operand) { return cos(operand); }
+static inline double vm_sin_f64(double operand) { return sin(operand); }
+static inline double vm_exp_f64(double operand) { return exp(operand); }
+static inline double vm_exp2_f64(double operand) { return exp2(operand); }
+static inline double vm_expm1_f64(double operand) { return expm1(operand); }
+static inline double vm_log_f64(double operand) { return log(operand); }
+static inline double vm_log10_f64(double operand) { return log10(operand); }
+static inline double vm_log1p_f64(double operand) { return log1p(operand); }
+static inline double vm_log2_f64(double operand) { return log2(operand); }
+static inline double vm_pow_f64(double b, double e) { return pow(b, e); }
+static inline double vm_rsqrt_f64(double operand) {
+  return 1.0 / sqrt(operand);
+}
+static inline double vm_sqrt_f64(double operand) { return sqrt(operand); }
+static inline double vm_tanh_f64(double operand) { return tanh(operand); }
+static inline double vm_erf_f64(double operand) { return erf(operand); }
+
+//===------------------------------------------------------------------===//
+// ExtF64: Casting and type conversion/emulation
+//===------------------------------------------------------------------===//
+
+static inline float vm_trunc_f64f32(double operand) { return (float)operand; }
+static inline double vm_ext_f32f64(float operand) { return (double)operand; }
+static inline double vm_bitcast_i64f64(int64_t operand) {
+  double result;
+  memcpy(&result, &operand, sizeof(result));
+  return result;
+}
+static inline int64_t vm_bitcast_f64i64(double operand) {
+  int64_t result;
+  memcpy(&result, &operand, sizeof(result));
+  return result;
+}
+
+//===------------------------------------------------------------------===//
+// ExtF64: Comparison ops
+//===------------------------------------------------------------------===//
+
+static inline int32_t vm_cmp_eq_f64o(double lhs, double rhs) {
+  return (lhs == rhs) ? 1 : 0;
+}
+static inline int32_t vm_cmp_eq_f64u(double lhs, double rhs) {
+  return (isunordered(lhs, rhs) || (lhs == rhs)) ? 1 : 0;
+}
+static inline int32_t vm_cmp_ne_f64o(double lhs, double rhs) {
+  return (lhs != rhs) ? 1 : 0;
+}
+static inline int32_t vm_cmp_ne_f64u(double lhs, double rhs) {
+  return (isunordered(lhs, rhs) || (lhs != rhs)) ? 1 : 0;
+}
+static inline int32_t vm_cmp_lt_f64o(double lhs, double rhs) {
+  return isless(lhs, rhs) ? 1 : 0;
+}
+static inline int32_t vm_cmp_lt_f64u(double lhs, double rhs) {
+  return (isunordered(lhs, rhs) || isless(lhs, rhs)) ? 1 : 0;
+}
+static inline int32_t vm_cmp_lte_f64o(double lhs, double rhs) {
+  return islessequal(lhs, rhs) ? 1 : 0;
+}
+static inline int32_t vm_cmp_lte_f64u(double lhs, double rhs) {
+  return (isunordered(lhs, rhs) || islessequal(lhs, rhs)) ? 1 : 0;
+}
+static inline int32_t vm_cmp_nan_f64(double operand) {
+  return isnan(operand) ? 1 : 0;
+}
+
+//===------------------------------------------------------------------===//
+// ExtF64: Buffers
+//===------------------------------------------------------------------===//
+
+static inline iree_status_t vm_buffer_fill_f64(iree_vm_ref_t* buffer_ref,
+                                               int32_t offset, int32_t length,
+                                               double value) {
+  iree_vm_buffer_t* buffer = NULL;
+  IREE_RETURN_IF_ERROR(vm_buffer_deref_checked(buffer_ref, &buffer));
+  return iree_vm_buffer_fill_elements(buffer, (uint32_t)offset,
+                                      (uint32_t)length / sizeof(double),
+                                      sizeof(double), &value);
+}
+static inline iree_status_t vm_buffer_load_f64(iree_vm_ref_t* buffer_ref,
+                                               int32_t offset,
+                                               double* out_result) {
+  iree_vm_buffer_t* buffer = NULL;
+  IREE_RETURN_IF_ERROR(vm_buffer_deref_checked(buffer_ref, &buffer));
+  return iree_vm_buffer_read_elements(buffer, (uint32_t)offset, out_result, 1,
+                                      sizeof(*out_result));
+}
+static inline iree_status_t vm_buffer_store_f64(iree_vm_ref_t* buffer_ref,
+                                                int32_t offset, double value) {
+  iree_vm_buffer_t* buffer = NULL;
+  IREE_RETURN_IF_ERROR(vm_buffer_deref_checked(buffer_ref, &buffer));
+  return iree_vm_buffer_write_elements(&value, buffer, (uint32_t)offset, 1,
+                                       sizeof(value));
+}
+
 #endif  // IREE_VM_OPS_H_
@@ -7,6 +7,7 @@
 #include "iree/vm/shims.h"
 
 IREE_VM_ABI_DEFINE_SHIM(irii, v);
+IREE_VM_ABI_DEFINE_SHIM(iriiiii, v);
 IREE_VM_ABI_DEFINE_SHIM(r, i);
 IREE_VM_ABI_DEFINE_SHIM(r, ii);
 IREE_VM_ABI_DEFINE_SHIM(r, iii);
@@ -14,6 +15,7 @@ IREE_VM_ABI_DEFINE_SHIM(r, iiii);
 IREE_VM_ABI_DEFINE_SHIM(r, r);
 IREE_VM_ABI_DEFINE_SHIM(r, v);
 IREE_VM_ABI_DEFINE_SHIM(rCiD, i);
+IREE_VM_ABI_DEFINE_SHIM(rCriiiiD, v);
 IREE_VM_ABI_DEFINE_SHIM(rCrD, v);
 IREE_VM_ABI_DEFINE_SHIM(ri, i);
 IREE_VM_ABI_DEFINE_SHIM(ri, f);
@@ -29,6 +31,11 @@ IREE_VM_ABI_DEFINE_SHIM(rii, v);
 IREE_VM_ABI_DEFINE_SHIM(rif, v);
 IREE_VM_ABI_DEFINE_SHIM(riii, r);
 IREE_VM_ABI_DEFINE_SHIM(riii, v);
+IREE_VM_ABI_DEFINE_SHIM(riiiriiii, v);
+IREE_VM_ABI_DEFINE_SHIM(riiiriiiii, v);
+IREE_VM_ABI_DEFINE_SHIM(riiiriiiriiiii, v);
+IREE_VM_ABI_DEFINE_SHIM(riiiriiiriiiiii, v);
+IREE_VM_ABI_DEFINE_SHIM(riiriiriiiiiiii, v);
 IREE_VM_ABI_DEFINE_SHIM(riirii, r);
 IREE_VM_ABI_DEFINE_SHIM(riiirii, r);
 IREE_VM_ABI_DEFINE_SHIM(rrrrCrD, r);
@@ -191,6 +191,16 @@ IREE_VM_ABI_FIXED_STRUCT(irii, {
   int32_t i3;
 });
 
+IREE_VM_ABI_FIXED_STRUCT(iriiiii, {
+  int32_t i0;
+  iree_vm_ref_t r1;
+  int32_t i2;
+  int32_t i3;
+  int32_t i4;
+  int32_t i5;
+  int32_t i6;
+});
+
 IREE_VM_ABI_FIXED_STRUCT(r, { iree_vm_ref_t r0; });
 
 IREE_VM_ABI_FIXED_STRUCT(rr, {
@@ -236,6 +246,14 @@ IREE_VM_ABI_FIXED_STRUCT(riii, {
   int32_t i3;
 });
 
+IREE_VM_ABI_FIXED_STRUCT(riiii, {
+  iree_vm_ref_t r0;
+  int32_t i1;
+  int32_t i2;
+  int32_t i3;
+  int32_t i4;
+});
+
 IREE_VM_ABI_FIXED_STRUCT(riirii, {
   iree_vm_ref_t r0;
   int32_t i1;
@@ -255,6 +273,84 @@ IREE_VM_ABI_FIXED_STRUCT(riiirii, {
   int32_t i6;
 });
 
+IREE_VM_ABI_FIXED_STRUCT(riiiriiii, {
+  iree_vm_ref_t r0;
+  int32_t i1;
+  int32_t i2;
+  int32_t i3;
+  iree_vm_ref_t r4;
+  int32_t i5;
+  int32_t i6;
+  int32_t i7;
+  int32_t i8;
+});
+
+IREE_VM_ABI_FIXED_STRUCT(riiiriiiii, {
+  iree_vm_ref_t r0;
+  int32_t i1;
+  int32_t i2;
+  int32_t i3;
+  iree_vm_ref_t r4;
+  int32_t i5;
+  int32_t i6;
+  int32_t i7;
+  int32_t i8;
+  int32_t i9;
+});
+
+IREE_VM_ABI_FIXED_STRUCT(riiiriiiriiiii, {
+  iree_vm_ref_t r0;
+  int32_t i1;
+  int32_t i2;
+  int32_t i3;
+  iree_vm_ref_t r4;
+  int32_t i5;
+  int32_t i6;
+  int32_t i7;
+  iree_vm_ref_t r8;
+  int32_t i9;
+  int32_t i10;
+  int32_t i11;
+  int32_t i12;
+  int32_t i13;
+});
+
+IREE_VM_ABI_FIXED_STRUCT(riiiriiiriiiiii, {
+  iree_vm_ref_t r0;
+  int32_t i1;
+  int32_t i2;
+  int32_t i3;
+  iree_vm_ref_t r4;
+  int32_t i5;
+  int32_t i6;
+  int32_t i7;
+  iree_vm_ref_t r8;
+  int32_t i9;
+  int32_t i10;
+  int32_t i11;
+  int32_t i12;
+  int32_t i13;
+  int32_t i14;
+});
+
+IREE_VM_ABI_FIXED_STRUCT(riiriiriiiiiiii, {
+  iree_vm_ref_t r0;
+  int32_t i1;
+  int32_t i2;
+  iree_vm_ref_t r3;
+  int32_t i4;
+  int32_t i5;
+  iree_vm_ref_t r6;
+  int32_t i7;
+  int32_t i8;
+  int32_t i9;
+  int32_t i10;
+  int32_t i11;
+  int32_t i12;
+  int32_t i13;
+  int32_t i14;
+});
+
 IREE_VM_ABI_FIXED_STRUCT(rriiii, {
   iree_vm_ref_t r0;
   iree_vm_ref_t r1;
@@ -296,6 +392,12 @@ IREE_VM_ABI_VLA_STRUCT(rCiD, a1_count, a1, {
   iree_vm_abi_i_t a1[0];
 });
 
+IREE_VM_ABI_VLA_STRUCT(rCriiiiD, a1_count, a1, {
+  iree_vm_ref_t r0;
+  iree_vm_size_t a1_count;
+  iree_vm_abi_riiii_t a1[0];
+});
+
 IREE_VM_ABI_VLA_STRUCT(rCrD, a1_count, a1, {
   iree_vm_ref_t r0;
   iree_vm_size_t a1_count;
@@ -406,6 +508,7 @@ IREE_VM_ABI_VLA_STRUCT(rriCiriiD, a3_count, a3, {
 //===----------------------------------------------------------------------===//
 
 IREE_VM_ABI_DECLARE_SHIM(irii, v);
+IREE_VM_ABI_DECLARE_SHIM(iriiiii, v);
 IREE_VM_ABI_DECLARE_SHIM(r, i);
 IREE_VM_ABI_DECLARE_SHIM(r, ii);
 IREE_VM_ABI_DECLARE_SHIM(r, iii);
@@ -413,6 +516,7 @@ IREE_VM_ABI_DECLARE_SHIM(r, iiii);
 IREE_VM_ABI_DECLARE_SHIM(r, r);
 IREE_VM_ABI_DECLARE_SHIM(r, v);
 IREE_VM_ABI_DECLARE_SHIM(rCiD, i);
+IREE_VM_ABI_DECLARE_SHIM(rCriiiiD, v);
 IREE_VM_ABI_DECLARE_SHIM(rCrD, v);
 IREE_VM_ABI_DECLARE_SHIM(ri, i);
 IREE_VM_ABI_DECLARE_SHIM(ri, f);
@@ -428,6 +532,11 @@ IREE_VM_ABI_DECLARE_SHIM(rii, v);
 IREE_VM_ABI_DECLARE_SHIM(rif, v);
 IREE_VM_ABI_DECLARE_SHIM(riii, r);
 IREE_VM_ABI_DECLARE_SHIM(riii, v);
+IREE_VM_ABI_DECLARE_SHIM(riiiriiii, v);
+IREE_VM_ABI_DECLARE_SHIM(riiiriiiii, v);
+IREE_VM_ABI_DECLARE_SHIM(riiiriiiriiiii, v);
+IREE_VM_ABI_DECLARE_SHIM(riiiriiiriiiiii, v);
+IREE_VM_ABI_DECLARE_SHIM(riiriiriiiiiiii, v);
 IREE_VM_ABI_DECLARE_SHIM(riirii, r);
 IREE_VM_ABI_DECLARE_SHIM(riiirii, r);
 IREE_VM_ABI_DECLARE_SHIM(rrrrCrD, r);
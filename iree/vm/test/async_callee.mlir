@@ -0,0 +1,19 @@
+vm.module @async_callee {
+
+  // Yields |count| times and returns |value| + |count|.
+  vm.export @yield_add
+  vm.func @yield_add(%value : i32, %count : i32) -> i32 {
+    %c1 = vm.const.i32 1
+    vm.br ^check(%value, %count : i32, i32)
+  ^check(%v : i32, %n : i32):
+    %pending = vm.cmp.nz.i32 %n : i32
+    vm.cond_br %pending, ^step(%v, %n : i32, i32), ^exit(%v : i32)
+  ^step(%v1 : i32, %n1 : i32):
+    %v2 = vm.add.i32 %v1, %c1 : i32
+    %n2 = vm.sub.i32 %n1, %c1 : i32
+    vm.yield ^check(%v2, %n2 : i32, i32)
+  ^exit(%result : i32):
+    vm.return %result : i32
+  }
+
+}
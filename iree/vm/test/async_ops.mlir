@@ -0,0 +1,50 @@
+vm.module @async_ops {
+
+  // Bytecode function in another module that yields with its frames left on
+  // the stack. Resuming must continue in the callee and return into the caller.
+  vm.import @async_callee.yield_add(%value : i32, %count : i32) -> i32
+
+  //===--------------------------------------------------------------------===//
+  // vm.call
+  //===--------------------------------------------------------------------===//
+
+  vm.export @test_call_yield
+  vm.func @test_call_yield() {
+    %c100 = vm.const.i32 100
+    %c3 = vm.const.i32 3
+    %c103 = vm.const.i32 103
+    %0 = vm.call @async_callee.yield_add(%c100, %c3) : (i32, i32) -> i32
+    vm.check.eq %0, %c103, "yield_add(100, 3)" : i32
+    vm.return
+  }
+
+  vm.export @test_call_yield_sequence
+  vm.func @test_call_yield_sequence() {
+    %c1 = vm.const.i32 1
+    %c2 = vm.const.i32 2
+    %c13 = vm.const.i32 13
+    %c10 = vm.const.i32 10
+    %0 = vm.call @async_callee.yield_add(%c10, %c1) : (i32, i32) -> i32
+    %1 = vm.call @async_callee.yield_add(%0, %c2) : (i32, i32) -> i32
+    vm.check.eq %1, %c13, "yield_add(yield_add(10, 1), 2)" : i32
+    vm.return
+  }
+
+  //===--------------------------------------------------------------------===//
+  // vm.call.variadic
+  //===--------------------------------------------------------------------===//
+
+  // NOTE: the module is compiled without canonicalization so that this remains
+  // a vm.call.variadic.
+  vm.export @test_call_variadic_yield
+  vm.func @test_call_variadic_yield() {
+    %c200 = vm.const.i32 200
+    %c2 = vm.const.i32 2
+    %c202 = vm.const.i32 202
+    %0 = vm.call.variadic @async_callee.yield_add(%c200, %c2)
+        : (i32, i32) -> i32
+    vm.check.eq %0, %c202, "yield_add(200, 2)" : i32
+    vm.return
+  }
+
+}
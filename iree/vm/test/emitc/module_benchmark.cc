@@ -0,0 +1,198 @@
+// Copyright 2022 The IREE Authors
+//
+// Licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+// Runs the functions in iree/vm/bytecode_module_benchmark.mlir through both the
+// bytecode interpreter and the module compiled to C so that the two execution
+// modes can be compared side by side on identical programs.
+
+// TODO: We should not be including C implementation-only headers in a C++
+// module like this. In order to make this work for the moment across
+// runtime libraries that are strict, do a global using of the std namespace.
+// See #7605
+#include <cmath>
+using namespace std;
+
+#include <array>
+#include <string>
+#include <vector>
+
+#include "benchmark/benchmark.h"
+#include "iree/base/api.h"
+#include "iree/base/logging.h"
+#include "iree/vm/api.h"
+#include "iree/vm/bytecode_module.h"
+#include "iree/vm/bytecode_module_benchmark_module_c.h"
+#define EMITC_IMPLEMENTATION
+#include "iree/vm/test/emitc/bytecode_module_benchmark.h"
+
+namespace {
+
+// vm.import @native_import_module.add_1(%arg0 : i32) -> i32
+static iree_status_t native_import_module_add_1(
+    iree_vm_stack_t* stack, const iree_vm_function_call_t* call,
+    iree_vm_native_function_target_t target_fn, void* module,
+    void* module_state, iree_vm_execution_result_t* out_result) {
+  int32_t arg0 = *reinterpret_cast<int32_t*>(call->arguments.data);
+  *reinterpret_cast<int32_t*>(call->results.data) = arg0 + 1;
+  return iree_ok_status();
+}
+
+static const iree_vm_native_export_descriptor_t
+    native_import_module_exports_[] = {
+        {iree_make_cstring_view("add_1"), iree_make_cstring_view("0i_i"), 0,
+         NULL},
+};
+static const iree_vm_native_function_ptr_t native_import_module_funcs_[] = {
+    {(iree_vm_native_function_shim_t)native_import_module_add_1, NULL},
+};
+static_assert(IREE_ARRAYSIZE(native_import_module_funcs_) ==
+                  IREE_ARRAYSIZE(native_import_module_exports_),
+              "function pointer table must be 1:1 with exports");
+static const iree_vm_native_module_descriptor_t
+    native_import_module_descriptor_ = {
+        iree_make_cstring_view("native_import_module"),
+        0,
+        NULL,
+        IREE_ARRAYSIZE(native_import_module_exports_),
+        native_import_module_exports_,
+        IREE_ARRAYSIZE(native_import_module_funcs_),
+        native_import_module_funcs_,
+        0,
+        NULL,
+};
+
+static iree_status_t native_import_module_create(
+    iree_allocator_t allocator, iree_vm_module_t** out_module) {
+  iree_vm_module_t interface;
+  IREE_RETURN_IF_ERROR(iree_vm_module_initialize(&interface, NULL));
+  return iree_vm_native_module_create(
+      &interface, &native_import_module_descriptor_, allocator, out_module);
+}
+
+static iree_status_t bytecode_module_create(iree_allocator_t allocator,
+                                            iree_vm_module_t** out_module) {
+  const auto* module_file_toc =
+      iree_vm_bytecode_module_benchmark_module_create();
+  return iree_vm_bytecode_module_create(
+      iree_const_byte_span_t{
+          reinterpret_cast<const uint8_t*>(module_file_toc->data),
+          module_file_toc->size},
+      iree_allocator_null(), allocator, out_module);
+}
+
+typedef iree_status_t (*module_create_fn_t)(iree_allocator_t allocator,
+                                            iree_vm_module_t** out_module);
+
+// Benchmarks the given exported function of the module produced by
+// |create_fn|, optionally passing in arguments.
+static iree_status_t RunFunction(benchmark::State& state,
+                                 module_create_fn_t create_fn,
+                                 const char* function_name,
+                                 std::vector<int32_t> i32_args,
+                                 int result_count, int64_t batch_size = 1) {
+  iree_vm_instance_t* instance = NULL;
+  IREE_CHECK_OK(iree_vm_instance_create(iree_allocator_system(), &instance));
+
+  iree_vm_module_t* import_module = NULL;
+  IREE_CHECK_OK(
+      native_import_module_create(iree_allocator_system(), &import_module));
+  iree_vm_module_t* module = NULL;
+  IREE_CHECK_OK(create_fn(iree_allocator_system(), &module));
+
+  std::array<iree_vm_module_t*, 2> modules = {import_module, module};
+  iree_vm_context_t* context = NULL;
+  IREE_CHECK_OK(iree_vm_context_create_with_modules(
+      instance, IREE_VM_CONTEXT_FLAG_NONE, modules.data(), modules.size(),
+      iree_allocator_system(), &context));
+
+  std::string qualified_name =
+      std::string("bytecode_module_benchmark.") + function_name;
+  iree_vm_function_t function;
+  IREE_CHECK_OK(iree_vm_context_resolve_function(
+      context,
+      iree_string_view_t{qualified_name.data(), qualified_name.size()},
+      &function));
+
+  iree_vm_function_call_t call;
+  memset(&call, 0, sizeof(call));
+  call.function = function;
+  call.arguments =
+      iree_make_byte_span(iree_alloca(i32_args.size() * sizeof(int32_t)),
+                          i32_args.size() * sizeof(int32_t));
+  call.results =
+      iree_make_byte_span(iree_alloca(result_count * sizeof(int32_t)),
+                          result_count * sizeof(int32_t));
+
+  IREE_VM_INLINE_STACK_INITIALIZE(stack, IREE_VM_INVOCATION_FLAG_NONE,
+                                  iree_vm_context_state_resolver(context),
+                                  iree_allocator_system());
+  while (state.KeepRunningBatch(batch_size)) {
+    for (iree_host_size_t i = 0; i < i32_args.size(); ++i) {
+      reinterpret_cast<int32_t*>(call.arguments.data)[i] = i32_args[i];
+    }
+
+    iree_vm_execution_result_t result;
+    IREE_CHECK_OK(module->begin_call(module->self, stack, &call, &result));
+  }
+  iree_vm_stack_deinitialize(stack);
+
+  iree_vm_module_release(import_module);
+  iree_vm_module_release(module);
+  iree_vm_context_release(context);
+  iree_vm_instance_release(instance);
+
+  return iree_ok_status();
+}
+
+// Registers a benchmark of |function_name| for both execution modes.
+#define IREE_VM_MODULE_BENCHMARK(name, function_name, args, result_count, \
+                                 batch_size)                              \
+  static void BM_##name##Bytecode(benchmark::State& state) {              \
+    IREE_CHECK_OK(RunFunction(state, bytecode_module_create,              \
+                              function_name, args, result_count,          \
+                              batch_size));                               \
+  }                                                                       \
+  static void BM_##name##EmitC(benchmark::State& state) {                 \
+    IREE_CHECK_OK(RunFunction(state, bytecode_module_benchmark_create,    \
+                              function_name, args, result_count,          \
+                              batch_size));                               \
+  }
+
+IREE_VM_MODULE_BENCHMARK(EmptyFunc, "empty_func", {}, /*result_count=*/0,
+                         /*batch_size=*/1)
+BENCHMARK(BM_EmptyFuncBytecode);
+BENCHMARK(BM_EmptyFuncEmitC);
+
+IREE_VM_MODULE_BENCHMARK(CallInternalFunc, "call_internal_func", {100},
+                         /*result_count=*/1, /*batch_size=*/20)
+BENCHMARK(BM_CallInternalFuncBytecode);
+BENCHMARK(BM_CallInternalFuncEmitC);
+
+IREE_VM_MODULE_BENCHMARK(CallImportedFunc, "call_imported_func", {100},
+                         /*result_count=*/1, /*batch_size=*/20)
+BENCHMARK(BM_CallImportedFuncBytecode);
+BENCHMARK(BM_CallImportedFuncEmitC);
+
+IREE_VM_MODULE_BENCHMARK(LoopSum, "loop_sum",
+                         {static_cast<int32_t>(state.range(0))},
+                         /*result_count=*/1, state.range(0))
+BENCHMARK(BM_LoopSumBytecode)->Arg(100000);
+BENCHMARK(BM_LoopSumEmitC)->Arg(100000);
+
+IREE_VM_MODULE_BENCHMARK(BufferReduce, "buffer_reduce",
+                         {static_cast<int32_t>(state.range(0))},
+                         /*result_count=*/1, state.range(0))
+BENCHMARK(BM_BufferReduceBytecode)->Arg(100000);
+BENCHMARK(BM_BufferReduceEmitC)->Arg(100000);
+
+// NOTE: unrolled 8x, requires %count to be % 8 = 0.
+IREE_VM_MODULE_BENCHMARK(BufferReduceUnrolled, "buffer_reduce_unrolled",
+                         {static_cast<int32_t>(state.range(0))},
+                         /*result_count=*/1, state.range(0))
+BENCHMARK(BM_BufferReduceUnrolledBytecode)->Arg(100000);
+BENCHMARK(BM_BufferReduceUnrolledEmitC)->Arg(100000);
+
+}  // namespace